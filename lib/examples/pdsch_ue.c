@@ -749,6 +749,9 @@ int main(int argc, char** argv)
               printf("Decoded MIB. SFN: %d, offset: %d\n", sfn, sfn_offset);
               sfn   = (sfn + sfn_offset) % 1024;
               state = DECODE_PDSCH;
+
+              // From now on the OFDM demodulator corrects the CFO of the subframes that are not used for tracking
+              srsran_ue_sync_set_cfo_correct_deferred(&ue_sync, true);
             }
           }
           break;
@@ -785,6 +788,13 @@ int main(int argc, char** argv)
               ue_dl_cfg.chest_cfg = chest_mbsfn_cfg;
             }
 
+            // Pass the CFO and timing corrections left by ue_sync to the OFDM demodulator
+            float cfo       = 0.0f;
+            float cfo_phase = 0.0f;
+            srsran_ue_sync_get_sf_cfo(&ue_sync, &cfo, &cfo_phase);
+            srsran_ue_dl_set_cfo(&ue_dl, cfo, cfo_phase);
+            srsran_ue_dl_set_time_offset(&ue_dl, srsran_ue_sync_get_sf_time_offset(&ue_sync));
+
             n = 0;
             for (uint32_t tm = 0; tm < 4 && !n; tm++) {
               dl_sf.tti                             = tti;
@@ -0,0 +1,255 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_EPOCH_DOMAIN_H
+#define SRSRAN_EPOCH_DOMAIN_H
+
+#include "srsran/adt/move_callback.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace srsran {
+
+/**
+ * Epoch based reclamation (RCU-like) domain.
+ *
+ * Readers enter a read section before dereferencing a shared pointer and leave it when they are done. Entering and
+ * leaving only writes to a cache line owned by the calling thread, so readers never contend with each other nor wait
+ * for writers. Writers unlink objects from the shared structure and hand them to retire(); each object is only
+ * destroyed once every read section that could have observed it has finished.
+ *
+ * Read sections can be nested. Threads beyond max_readers fall back to a shared counter that delays reclamation
+ * while any of them is inside a read section.
+ */
+class epoch_domain
+{
+public:
+  static const uint32_t max_readers = 64;
+
+  epoch_domain() : slots(std::make_shared<slot_array>()), domain_id(next_domain_id().fetch_add(1) + 1) {}
+  ~epoch_domain() { synchronize(); }
+
+  epoch_domain(const epoch_domain&) = delete;
+  epoch_domain& operator=(const epoch_domain&) = delete;
+
+  /// Enters a read section. Objects reachable from the shared structure stay alive until the matching exit().
+  void enter()
+  {
+    reader_slot* slot = get_reader_slot();
+    if (slot == nullptr) {
+      slots->nof_overflow_readers.fetch_add(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      return;
+    }
+    if (slot->depth++ == 0) {
+      slot->epoch.store(global_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+      // Publish the epoch before any shared pointer is read. Pairs with the fence in reclaim().
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+  }
+
+  /// Leaves the read section opened by the last call to enter().
+  void exit()
+  {
+    reader_slot* slot = get_reader_slot();
+    if (slot == nullptr) {
+      slots->nof_overflow_readers.fetch_sub(1, std::memory_order_release);
+      return;
+    }
+    if (--slot->depth == 0) {
+      slot->epoch.store(quiescent, std::memory_order_release);
+    }
+  }
+
+  /// Defers the call to deleter until all the read sections that are active at this point have finished. The object
+  /// must already be unreachable for new readers.
+  void retire(move_callback<void()> deleter)
+  {
+    std::lock_guard<std::mutex> lock(retired_mutex);
+    uint64_t                    epoch = global_epoch.fetch_add(1, std::memory_order_acq_rel);
+    retired.push_back(retired_object{epoch, std::move(deleter)});
+  }
+
+  template <typename T, typename Deleter>
+  void retire(std::unique_ptr<T, Deleter> obj)
+  {
+    if (obj != nullptr) {
+      retire(move_callback<void()>([p = std::move(obj)]() mutable { p.reset(); }));
+    }
+  }
+
+  /// Destroys the retired objects whose grace period has elapsed without blocking. Returns the number of objects
+  /// that were destroyed.
+  size_t reclaim()
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t min_epoch = oldest_active_epoch();
+
+    std::deque<retired_object> expired;
+    {
+      std::lock_guard<std::mutex> lock(retired_mutex);
+      while (not retired.empty() and retired.front().epoch < min_epoch) {
+        expired.push_back(std::move(retired.front()));
+        retired.pop_front();
+      }
+    }
+    // Run the deleters outside the lock, as they may retire other objects.
+    for (retired_object& obj : expired) {
+      obj.deleter();
+    }
+    return expired.size();
+  }
+
+  /// Blocks until every retired object has been destroyed.
+  /// NOTE: Must not be called from inside a read section.
+  void synchronize()
+  {
+    reclaim();
+    while (nof_retired() > 0) {
+      std::this_thread::yield();
+      reclaim();
+    }
+  }
+
+  /// Number of objects waiting for their grace period to elapse.
+  size_t nof_retired() const
+  {
+    std::lock_guard<std::mutex> lock(retired_mutex);
+    return retired.size();
+  }
+
+private:
+  static const uint64_t quiescent = 0;
+
+  struct alignas(64) reader_slot {
+    /// Epoch observed when the outermost read section was entered, or quiescent.
+    std::atomic<uint64_t> epoch{quiescent};
+    /// Set while a thread owns this slot.
+    std::atomic<bool> owned{false};
+    /// Read section nesting level, only accessed by the owner thread.
+    uint32_t depth = 0;
+  };
+
+  struct slot_array {
+    std::array<reader_slot, max_readers> readers;
+    alignas(64) std::atomic<uint32_t> nof_overflow_readers{0};
+  };
+
+  struct retired_object {
+    uint64_t              epoch;
+    move_callback<void()> deleter;
+  };
+
+  /// Per thread cache of the slots acquired in each domain. Slots are released when the thread exits, and the shared
+  /// ownership keeps them valid even if the domain is destroyed first.
+  struct thread_registry {
+    struct entry {
+      uint64_t                    domain_id;
+      std::shared_ptr<slot_array> slots;
+      reader_slot*                slot;
+    };
+    std::vector<entry> entries;
+
+    ~thread_registry()
+    {
+      for (entry& e : entries) {
+        if (e.slot != nullptr) {
+          e.slot->owned.store(false, std::memory_order_release);
+        }
+      }
+    }
+  };
+
+  static std::atomic<uint64_t>& next_domain_id()
+  {
+    static std::atomic<uint64_t> id{0};
+    return id;
+  }
+
+  reader_slot* get_reader_slot()
+  {
+    static thread_local thread_registry registry;
+    for (thread_registry::entry& e : registry.entries) {
+      if (e.domain_id == domain_id) {
+        return e.slot;
+      }
+    }
+
+    // First access of this thread to the domain. A null slot means the thread uses the overflow counter.
+    reader_slot* slot = nullptr;
+    for (reader_slot& s : slots->readers) {
+      bool expected = false;
+      if (not s.owned.load(std::memory_order_relaxed) and s.owned.compare_exchange_strong(expected, true)) {
+        slot = &s;
+        break;
+      }
+    }
+    registry.entries.push_back(thread_registry::entry{domain_id, slots, slot});
+    return slot;
+  }
+
+  uint64_t oldest_active_epoch() const
+  {
+    if (slots->nof_overflow_readers.load(std::memory_order_acquire) > 0) {
+      return quiescent;
+    }
+    uint64_t min_epoch = UINT64_MAX;
+    for (const reader_slot& s : slots->readers) {
+      uint64_t e = s.epoch.load(std::memory_order_acquire);
+      if (e != quiescent and e < min_epoch) {
+        min_epoch = e;
+      }
+    }
+    return min_epoch;
+  }
+
+  std::shared_ptr<slot_array> slots;
+  const uint64_t              domain_id;
+  std::atomic<uint64_t>       global_epoch{1};
+
+  mutable std::mutex         retired_mutex;
+  std::deque<retired_object> retired;
+};
+
+/// Scoped read section of an epoch_domain.
+class epoch_read_guard
+{
+public:
+  explicit epoch_read_guard(epoch_domain& domain_) : domain(&domain_) { domain->enter(); }
+  epoch_read_guard(const epoch_read_guard&) = delete;
+  epoch_read_guard(epoch_read_guard&&)      = delete;
+  epoch_read_guard& operator=(const epoch_read_guard&) = delete;
+  epoch_read_guard& operator=(epoch_read_guard&&) = delete;
+  ~epoch_read_guard() { domain->exit(); }
+
+private:
+  epoch_domain* domain;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_EPOCH_DOMAIN_H
@@ -34,6 +34,8 @@ struct phy_log_args_t {
   std::string phy_lib_level = "none";
   std::string id_preamble   = "";
   int         phy_hex_limit = -1;
+  uint32_t    max_rate      = 0; ///< Max info/debug entries per second and RNTI. 0 disables it
+  uint32_t    sample_period = 0; ///< Only one out of sample_period info/debug entries is logged. 0 disables it
 };
 
 struct rf_args_band_t {
@@ -24,6 +24,7 @@
 
 #include "srsran/common/common.h"
 #include "srsran/common/pcap.h"
+#include "srsran/common/pcap_writer.h"
 #include <string>
 
 namespace srsran {
@@ -35,13 +36,14 @@ public:
   ~nas_pcap();
   void     enable();
   uint32_t open(std::string filename_, uint32_t ue_id = 0, srsran_rat_t rat_type = srsran_rat_t::lte);
+  uint32_t open(const pcap_writer_args_t& writer_args, uint32_t ue_id = 0, srsran_rat_t rat_type = srsran_rat_t::lte);
   void     close();
   void     write_nas(uint8_t* pdu, uint32_t pdu_len_bytes);
 
 private:
   bool        enable_write = false;
   std::string filename;
-  FILE*       pcap_file            = nullptr;
+  pcap_writer writer;
   uint32_t    ue_id                = 0;
   int         emergency_handler_id = -1;
   void        pack_and_write(uint8_t* pdu, uint32_t pdu_len_bytes);
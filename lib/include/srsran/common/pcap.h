@@ -54,6 +54,44 @@ typedef struct pcaprec_hdr_s {
   unsigned int orig_len; /* actual length of packet */
 } pcaprec_hdr_t;
 
+/* pcapng block types and byte-order magic (see draft-ietf-opsawg-pcapng) */
+#define PCAPNG_SHB_TYPE 0x0A0D0D0A
+#define PCAPNG_IDB_TYPE 0x00000001
+#define PCAPNG_EPB_TYPE 0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+
+/* pcapng Section Header Block, written at the start of the file */
+typedef struct pcapng_shb_s {
+  uint32_t block_type;        /* PCAPNG_SHB_TYPE */
+  uint32_t block_total_len;   /* total block length */
+  uint32_t byte_order_magic;  /* PCAPNG_BYTE_ORDER_MAGIC */
+  uint16_t version_major;     /* major version number */
+  uint16_t version_minor;     /* minor version number */
+  int64_t  section_len;       /* -1 when the section length is not specified */
+  uint32_t block_total_len_2; /* repeated total block length */
+} __attribute__((packed)) pcapng_shb_t;
+
+/* pcapng Interface Description Block, one per file as all records share the same DLT */
+typedef struct pcapng_idb_s {
+  uint32_t block_type;        /* PCAPNG_IDB_TYPE */
+  uint32_t block_total_len;   /* total block length */
+  uint16_t link_type;         /* data link type */
+  uint16_t reserved;          /* unused, must be zero */
+  uint32_t snaplen;           /* max length of captured packets, in octets */
+  uint32_t block_total_len_2; /* repeated total block length */
+} __attribute__((packed)) pcapng_idb_t;
+
+/* pcapng Enhanced Packet Block header, followed by the padded packet data and the repeated block length */
+typedef struct pcapng_epb_hdr_s {
+  uint32_t block_type;      /* PCAPNG_EPB_TYPE */
+  uint32_t block_total_len; /* total block length */
+  uint32_t interface_id;    /* index of the IDB describing this packet */
+  uint32_t ts_high;         /* upper 32 bits of the timestamp in microseconds */
+  uint32_t ts_low;          /* lower 32 bits of the timestamp in microseconds */
+  uint32_t cap_len;         /* number of octets of packet saved in file */
+  uint32_t orig_len;        /* actual length of packet */
+} __attribute__((packed)) pcapng_epb_hdr_t;
+
 /* radioType */
 #define FDD_RADIO 1
 #define TDD_RADIO 2
@@ -206,17 +244,32 @@ FILE* DLT_PCAP_Open(uint32_t DLT, const char* fileName);
 /* Close the PCAP file */
 void DLT_PCAP_Close(FILE* fd);
 
+/* Fill the header written at the start of every PCAP file */
+void DLT_PCAP_PACK_FILE_HEADER(uint32_t DLT, pcap_hdr_t* file_header);
+
 /* Write an individual MAC PDU (PCAP packet header + mac-context + mac-pdu) */
 int LTE_PCAP_MAC_WritePDU(FILE* fd, MAC_Context_Info_t* context, const unsigned char* PDU, unsigned int length);
 int LTE_PCAP_MAC_UDP_WritePDU(FILE* fd, MAC_Context_Info_t* context, const unsigned char* PDU, unsigned int length);
 int LTE_PCAP_PACK_MAC_CONTEXT_TO_BUFFER(MAC_Context_Info_t* context, uint8_t* PDU, unsigned int length);
 
+/* Pack the dummy UDP header + mac-lte context that precede a MAC PDU of pdu_length bytes. Returns the header length */
+int LTE_PCAP_PACK_MAC_UDP_HEADER_TO_BUFFER(MAC_Context_Info_t* context,
+                                           uint8_t*            buffer,
+                                           unsigned int        length,
+                                           unsigned int        pdu_length);
+
 /* Write an individual NAS PDU (PCAP packet header + nas-context + nas-pdu) */
 int LTE_PCAP_NAS_WritePDU(FILE* fd, NAS_Context_Info_t* context, const unsigned char* PDU, unsigned int length);
 
 /* Write an individual RLC PDU (PCAP packet header + UDP header + rlc-context + rlc-pdu) */
 int LTE_PCAP_RLC_WritePDU(FILE* fd, RLC_Context_Info_t* context, const unsigned char* PDU, unsigned int length);
 
+/* Pack the dummy UDP header + rlc-context that precede an RLC PDU of pdu_length bytes. Returns the header length */
+int LTE_PCAP_PACK_RLC_UDP_HEADER_TO_BUFFER(RLC_Context_Info_t* context,
+                                           uint8_t*            buffer,
+                                           unsigned int        length,
+                                           unsigned int        pdu_length);
+
 /* Write an individual S1AP PDU (PCAP packet header + s1ap-context + s1ap-pdu) */
 int LTE_PCAP_S1AP_WritePDU(FILE* fd, S1AP_Context_Info_t* context, const unsigned char* PDU, unsigned int length);
 
@@ -227,6 +280,12 @@ int LTE_PCAP_NGAP_WritePDU(FILE* fd, NGAP_Context_Info_t* context, const unsigne
 int NR_PCAP_MAC_UDP_WritePDU(FILE* fd, mac_nr_context_info_t* context, const unsigned char* PDU, unsigned int length);
 int NR_PCAP_PACK_MAC_CONTEXT_TO_BUFFER(mac_nr_context_info_t* context, uint8_t* buffer, unsigned int length);
 
+/* Pack the dummy UDP header + nr-mac-context that precede a MAC PDU of pdu_length bytes. Returns the header length */
+int NR_PCAP_PACK_MAC_UDP_HEADER_TO_BUFFER(mac_nr_context_info_t* context,
+                                          uint8_t*               buffer,
+                                          unsigned int           length,
+                                          unsigned int           pdu_length);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,137 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_PCAP_WRITER_H
+#define SRSRAN_PCAP_WRITER_H
+
+#include "srsran/common/pcap.h"
+#include "srsran/common/threads.h"
+#include "srsran/srslog/srslog.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/uio.h>
+#include <vector>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif // HAVE_LIBURING
+
+namespace srsran {
+
+/// File container used by the pcap_writer.
+enum class pcap_file_format { pcap, pcapng };
+
+struct pcap_writer_args_t {
+  std::string      filename;
+  uint32_t         dlt    = UDP_DLT;
+  pcap_file_format format = pcap_file_format::pcap;
+  /// Once a file grows past this size (in bytes) the writer continues in a new one. Zero disables rotation.
+  uint64_t max_file_size = 0;
+  /// Number of rotated files kept on disk before the oldest is overwritten. Zero keeps all of them.
+  uint32_t max_nof_files = 0;
+  /// Size of each capture buffer. Must fit at least one record of maximum length.
+  uint32_t buffer_size = 1024 * 1024;
+  /// Number of preallocated capture buffers. Records are dropped when all of them are waiting for disk I/O.
+  uint32_t nof_buffers = 8;
+  /// Maximum time a partially filled buffer is kept in memory before being written to disk.
+  uint32_t flush_period_ms = 500;
+};
+
+/**
+ * Capture engine shared by all the PCAP classes.
+ *
+ * Producers append records (record header + optional context header + PDU) into one of a set of preallocated buffers,
+ * which only costs a memcpy under a short critical section. A dedicated thread hands full buffers to the kernel in
+ * batches, using io_uring when the library is available and writev() otherwise, so that no file I/O is ever done from
+ * the calling thread.
+ */
+class pcap_writer : protected srsran::thread
+{
+public:
+  pcap_writer();
+  ~pcap_writer();
+
+  pcap_writer(const pcap_writer& other) = delete;
+  pcap_writer& operator=(const pcap_writer& other) = delete;
+  pcap_writer(pcap_writer&& other)                 = delete;
+  pcap_writer& operator=(pcap_writer&& other) = delete;
+
+  int  open(const pcap_writer_args_t& args_);
+  int  close();
+  bool is_open() const { return running; }
+
+  /// Appends a record made of hdr (may be null) followed by pdu. Thread-safe and never blocks on disk I/O.
+  bool write(const uint8_t* hdr, uint32_t hdr_len, const uint8_t* pdu, uint32_t pdu_len);
+
+  /// Name of the file currently being written.
+  std::string get_filename() const;
+  /// Number of records that were dropped because all buffers were in flight.
+  uint64_t get_nof_dropped() const;
+
+private:
+  struct capture_buffer_t {
+    std::unique_ptr<uint8_t[]> data;
+    uint32_t                   len = 0;
+  };
+  static const uint32_t no_buffer = UINT32_MAX;
+
+  void run_thread() override;
+
+  uint32_t record_length(uint32_t data_len) const;
+  void     pack_record(capture_buffer_t& buffer, const uint8_t* hdr, uint32_t hdr_len, const uint8_t* pdu, uint32_t pdu_len);
+  bool     acquire_buffer();
+
+  int  open_file();
+  void close_file();
+  void write_buffers(const std::vector<uint32_t>& pending);
+  bool write_batch(const uint32_t* buffer_idxs, uint32_t nof_buffers);
+
+  srslog::basic_logger& logger;
+  pcap_writer_args_t    args;
+  std::atomic<bool>     running = {false};
+
+  // Buffer bookkeeping, protected by mutex.
+  mutable std::mutex            mutex;
+  std::condition_variable       cvar;
+  std::vector<capture_buffer_t> buffers;
+  std::vector<uint32_t>         free_buffers;
+  std::vector<uint32_t>         ready_buffers;
+  uint32_t                      current     = no_buffer;
+  uint64_t                      nof_dropped = 0;
+  std::string                   file_name;
+
+  // File state, only accessed by the writer thread once the file is open.
+  int                fd          = -1;
+  uint64_t           file_offset = 0;
+  uint32_t           file_idx    = 0;
+  std::vector<iovec> iov;
+#ifdef HAVE_LIBURING
+  struct io_uring ring;
+  bool            ring_ready = false;
+#endif // HAVE_LIBURING
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_PCAP_WRITER_H
@@ -23,6 +23,7 @@
 #define RLCPCAP_H
 
 #include "srsran/common/pcap.h"
+#include "srsran/common/pcap_writer.h"
 #include "srsran/interfaces/rlc_interface_types.h"
 #include <stdint.h>
 
@@ -33,7 +34,8 @@ class rlc_pcap
 public:
   rlc_pcap() {}
   void enable(bool en);
-  void open(const char* filename, const rlc_config_t& config);
+  uint32_t open(const char* filename, const rlc_config_t& config);
+  uint32_t open(const pcap_writer_args_t& writer_args, const rlc_config_t& config);
   void close();
 
   void set_ue_id(uint16_t ue_id);
@@ -42,12 +44,12 @@ public:
   void write_ul_ccch(uint8_t* pdu, uint32_t pdu_len_bytes);
 
 private:
-  bool     enable_write = false;
-  FILE*    pcap_file    = nullptr;
-  uint32_t ue_id        = 0;
-  uint8_t  mode         = 0;
-  uint8_t  sn_length    = 0;
-  void     pack_and_write(uint8_t* pdu,
+  bool        enable_write = false;
+  pcap_writer writer;
+  uint32_t    ue_id     = 0;
+  uint8_t     mode      = 0;
+  uint8_t     sn_length = 0;
+  void        pack_and_write(uint8_t* pdu,
                           uint32_t pdu_len_bytes,
                           uint8_t  mode,
                           uint8_t  direction,
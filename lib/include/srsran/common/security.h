@@ -323,6 +323,31 @@ security_milenage_f2345(uint8_t* k, uint8_t* op, uint8_t* rand, uint8_t* res, ui
 
 uint8_t security_milenage_f5_star(uint8_t* k, uint8_t* op, uint8_t* rand, uint8_t* ak);
 
+/// Input of the batched Milenage functions for one authentication vector.
+struct milenage_input_t {
+  const uint8_t* k;
+  const uint8_t* opc;
+  const uint8_t* rand;
+  const uint8_t* sqn;
+  const uint8_t* amf;
+};
+
+/// Output of the Milenage functions f1 to f5 for one authentication vector.
+struct milenage_output_t {
+  uint8_t mac_a[8];
+  uint8_t res[8];
+  uint8_t ck[16];
+  uint8_t ik[16];
+  uint8_t ak[6];
+};
+
+/**
+ * Computes Milenage f1, f2, f3, f4 and f5 for a batch of authentication vectors, which may belong to different
+ * subscribers. Each vector expands its key once and shares TEMP between the five functions. When the CPU supports
+ * AES-NI, the AES rounds of several vectors are interleaved to keep the AES units busy.
+ */
+void security_milenage_f12345_batch(const milenage_input_t* in, milenage_output_t* out, uint32_t nof_vectors);
+
 int security_xor_f2345(uint8_t* k, uint8_t* rand, uint8_t* res, uint8_t* ck, uint8_t* ik, uint8_t* ak);
 int security_xor_f1(uint8_t* k, uint8_t* rand, uint8_t* sqn, uint8_t* amf, uint8_t* mac_a);
 
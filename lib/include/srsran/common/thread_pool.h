@@ -32,6 +32,7 @@
 #include "srsran/adt/circular_buffer.h"
 #include "srsran/adt/move_callback.h"
 #include "srsran/srslog/srslog.h"
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <functional>
@@ -189,6 +190,40 @@ private:
 
 srsran::task_thread_pool& get_background_workers();
 
+/// Calls func(slot_idx, item_idx) for every item_idx in [0, nof_items) using up to nof_slots tasks of the pool. Each
+/// task has its own slot_idx, so that func can index per task objects that are not thread safe, and takes the next
+/// pending item until all of them have been processed. Blocks until then.
+template <typename Func>
+void parallel_for_each(task_thread_pool& pool, uint32_t nof_slots, uint32_t nof_items, const Func& func)
+{
+  struct run_state_t {
+    std::atomic<uint32_t>   next_item = {0};
+    std::mutex              mutex;
+    std::condition_variable cvar;
+    uint32_t                nof_running = 0;
+  } state;
+
+  state.nof_running  = std::min(nof_slots, nof_items);
+  uint32_t nof_tasks = state.nof_running;
+  for (uint32_t slot_idx = 0; slot_idx < nof_tasks; slot_idx++) {
+    run_state_t* st = &state;
+    const Func*  f  = &func;
+    pool.push_task([st, f, slot_idx, nof_items]() {
+      for (uint32_t idx = st->next_item++; idx < nof_items; idx = st->next_item++) {
+        (*f)(slot_idx, idx);
+      }
+      std::lock_guard<std::mutex> lock(st->mutex);
+      st->nof_running--;
+      st->cvar.notify_one();
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(state.mutex);
+  while (state.nof_running > 0) {
+    state.cvar.wait(lock);
+  }
+}
+
 } // namespace srsran
 
 #endif // SRSRAN_THREAD_POOL_H
@@ -32,6 +32,8 @@
 #include "srsran/adt/intrusive_list.h"
 #include "srsran/adt/move_callback.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <inttypes.h>
@@ -56,20 +58,32 @@ public:
  *   This deque will only grow in size. Erased timers are just tagged in the deque as empty, and can be reused for the
  *   creation of new timers. To avoid unnecessary runtime allocations, the user can set an initial capacity.
  * - free_list - intrusive forward linked list to keep track of the empty timers and speed up new timer creation.
- * - A large circular vector of size WHEEL_SIZE which works as a time wheel, storing and circularly indexing the
- *   currently running timers by their respective timeout value.
- *   For a number of running timers N, and uniform distribution of timeout values, the step_all() complexity
- *   should be O(N/WHEEL_SIZE). Thus, the performance should improve with a larger WHEEL_SIZE, at the expense of more
- *   used memory.
+ * - A hierarchical time wheel. Level 0 has one slot per tic and covers the next LVL0_SIZE tics. Each of the upper
+ *   levels has LVLN_SIZE slots, each one spanning a full revolution of the level below. Timers are stored in the
+ *   coarsest level that can represent their timeout, and are cascaded down to finer levels when the lower level
+ *   wraps around. Starting and stopping a timer is O(1), and step_all() only visits the timers that expire in the
+ *   current tic plus, once every LVL0_SIZE tics, the timers of one upper level slot. The whole wheel has
+ *   LVL0_SIZE + (NOF_LEVELS - 1) * LVLN_SIZE slots, which spans the full 32-bit tic range.
+ * - pending_head - lock-free stack of timers whose run/stop/set state changed since the last step_all(). The timer
+ *   state is an atomic word that is updated with CAS by run(), stop() and set(duration), so these calls never take
+ *   the timer_handler mutex and can be done from any thread. step_all() drains the stack and updates the position of
+ *   each pending timer in the wheel before processing the current tic.
  */
 class timer_handler
 {
   using tic_diff_t                      = uint32_t;
   using tic_t                           = uint32_t;
   constexpr static uint32_t INVALID_ID  = std::numeric_limits<uint32_t>::max();
-  constexpr static size_t   WHEEL_SHIFT = 16U;
-  constexpr static size_t   WHEEL_SIZE  = 1U << WHEEL_SHIFT;
-  constexpr static size_t   WHEEL_MASK  = WHEEL_SIZE - 1U;
+  constexpr static uint32_t LVL0_BITS   = 8U;
+  constexpr static uint32_t LVL0_SIZE   = 1U << LVL0_BITS;
+  constexpr static uint32_t LVL0_MASK   = LVL0_SIZE - 1U;
+  constexpr static uint32_t LVLN_BITS   = 6U;
+  constexpr static uint32_t LVLN_SIZE   = 1U << LVLN_BITS;
+  constexpr static uint32_t LVLN_MASK   = LVLN_SIZE - 1U;
+  constexpr static uint32_t NOF_LEVELS  = 5U;
+  constexpr static uint32_t WHEEL_SIZE  = LVL0_SIZE + (NOF_LEVELS - 1U) * LVLN_SIZE;
+  constexpr static uint32_t INVALID_POS = std::numeric_limits<uint32_t>::max();
+  static_assert(LVL0_BITS + (NOF_LEVELS - 1U) * LVLN_BITS == 32U, "The time wheel must span the whole tic range");
 
   constexpr static uint64_t   STOPPED_FLAG       = 0U;
   constexpr static uint64_t   RUNNING_FLAG       = static_cast<uint64_t>(1U) << 63U;
@@ -91,8 +105,12 @@ class timer_handler
     timer_handler& parent;
     // writes protected by backend lock
     bool                                  allocated = false;
+    uint32_t                              wheel_pos = INVALID_POS; ///< wheel slot the timer is linked to
     std::atomic<uint64_t>                 state{0}; ///< read can be without lock, thus writes must be atomic
     srsran::move_callback<void(uint32_t)> callback;
+    // lock-free pending stack
+    std::atomic<bool> pending{false};
+    timer_impl*       next_pending = nullptr;
 
     explicit timer_impl(timer_handler& parent_, uint32_t id_) : parent(parent_), id(id_) {}
     timer_impl(const timer_impl&) = delete;
@@ -119,7 +137,6 @@ class timer_handler
                     "Invalid timer duration=%" PRIu32 ">%" PRIu32,
                     duration_,
                     MAX_TIMER_DURATION);
-      std::lock_guard<std::mutex> lock(parent.mutex);
       set_(duration_);
     }
 
@@ -134,15 +151,10 @@ class timer_handler
       callback = std::move(callback_);
     }
 
-    void run()
-    {
-      std::lock_guard<std::mutex> lock(parent.mutex);
-      parent.start_run_(*this);
-    }
+    void run() { parent.start_run_(*this); }
 
     void stop()
     {
-      std::lock_guard<std::mutex> lock(parent.mutex);
       // does not call callback
       parent.stop_timer_(*this, false);
     }
@@ -157,13 +169,18 @@ class timer_handler
     void set_(uint32_t duration_)
     {
       duration_ = std::max(duration_, 1U); // the next step will be one place ahead of current one
-      // called in locked context
       uint64_t old_state = state.load(std::memory_order_relaxed);
-      if (decode_is_running(old_state)) {
-        // if already running, just extends timer lifetime
-        parent.start_run_(*this, duration_);
-      } else {
-        state.store(encode_state(STOPPED_FLAG, duration_, 0), std::memory_order_relaxed);
+      uint64_t new_state;
+      do {
+        if (decode_is_running(old_state)) {
+          // if already running, just extends timer lifetime
+          new_state = encode_state(RUNNING_FLAG, duration_, parent.cur_time.load(std::memory_order_relaxed) + duration_);
+        } else {
+          new_state = encode_state(STOPPED_FLAG, duration_, 0);
+        }
+      } while (not state.compare_exchange_weak(old_state, new_state));
+      if (decode_is_running(new_state)) {
+        parent.push_pending_(*this);
       }
     }
   };
@@ -234,7 +251,6 @@ public:
 
   explicit timer_handler(uint32_t capacity = 64)
   {
-    time_wheel.resize(WHEEL_SIZE);
     // Pre-reserve timers
     while (timer_list.size() < capacity) {
       timer_list.emplace_back(*this, timer_list.size());
@@ -250,25 +266,53 @@ public:
   {
     std::unique_lock<std::mutex> lock(mutex);
     uint32_t                     cur_time_local = cur_time.load(std::memory_order_relaxed) + 1;
-    auto&                        wheel_list     = time_wheel[cur_time_local & WHEEL_MASK];
 
-    for (auto it = wheel_list.begin(); it != wheel_list.end();) {
-      timer_impl& timer = timer_list[it->id];
-      ++it;
-      if (decode_timeout(timer.state.load(std::memory_order_relaxed)) == cur_time_local) {
-        // stop timer (callback has to see the timer has already expired)
-        stop_timer_(timer, true);
+    // Place timers that were started/stopped since the last tic in their new wheel position
+    apply_pending_(cur_time_local);
 
-        // Call callback if configured
-        if (not timer.callback.is_empty()) {
-          // unlock mutex. It can happen that the callback tries to run a timer too
-          lock.unlock();
+    // Once level 0 wraps around, move the timers of the next upper level slot(s) down to the finer levels
+    if ((cur_time_local & LVL0_MASK) == 0) {
+      for (uint32_t level = 1; level < NOF_LEVELS; ++level) {
+        uint32_t slot_idx = (cur_time_local >> (LVL0_BITS + (level - 1) * LVLN_BITS)) & LVLN_MASK;
+        cascade_(level_offset(level) + slot_idx, cur_time_local);
+        if (slot_idx != 0) {
+          break;
+        }
+      }
+    }
 
-          timer.callback(timer.id);
+    auto& wheel_list = time_wheel[cur_time_local & LVL0_MASK];
+    while (not wheel_list.empty()) {
+      timer_impl& timer = wheel_list.front();
+      unlink_timer_(timer);
 
-          // Lock again to keep protecting the wheel
-          lock.lock();
-        }
+      uint64_t timer_state = timer.state.load();
+      if (not decode_is_running(timer_state)) {
+        continue;
+      }
+      if (static_cast<int32_t>(decode_timeout(timer_state) - cur_time_local) > 0) {
+        // timeout changed since the timer was placed in the wheel
+        add_timer_(timer, decode_timeout(timer_state), cur_time_local);
+        continue;
+      }
+
+      // stop timer (callback has to see the timer has already expired). It fails if the timer got restarted/stopped
+      // from another thread in the meantime, in which case the timer is pending for the next tic
+      uint64_t new_state = encode_state(EXPIRED_FLAG, decode_duration(timer_state), decode_timeout(timer_state));
+      if (not timer.state.compare_exchange_strong(timer_state, new_state)) {
+        continue;
+      }
+      nof_timers_running_.fetch_sub(1, std::memory_order_relaxed);
+
+      // Call callback if configured
+      if (not timer.callback.is_empty()) {
+        // unlock mutex. It can happen that the callback tries to run a timer too
+        lock.unlock();
+
+        timer.callback(timer.id);
+
+        // Lock again to keep protecting the wheel
+        lock.lock();
       }
     }
 
@@ -281,6 +325,7 @@ public:
     // does not call callback
     for (timer_impl& timer : timer_list) {
       stop_timer_(timer, false);
+      unlink_timer_(timer);
     }
   }
 
@@ -292,11 +337,7 @@ public:
     return timer_list.size() - nof_free_timers;
   }
 
-  uint32_t nof_running_timers() const
-  {
-    std::lock_guard<std::mutex> lock(mutex);
-    return nof_timers_running_;
-  }
+  uint32_t nof_running_timers() const { return nof_timers_running_.load(std::memory_order_relaxed); }
 
   constexpr static uint32_t max_timer_duration() { return MAX_TIMER_DURATION; }
 
@@ -313,10 +354,12 @@ public:
     timer.run();
   }
 
-  // useful for testing
-  static size_t get_wheel_size() { return WHEEL_SIZE; }
+  // useful for testing. Number of tics covered by the finest level of the wheel
+  static size_t get_wheel_size() { return LVL0_SIZE; }
 
 private:
+  static uint32_t level_offset(uint32_t level) { return level == 0 ? 0 : LVL0_SIZE + (level - 1) * LVLN_SIZE; }
+
   timer_impl& alloc_timer()
   {
     std::lock_guard<std::mutex> lock(mutex);
@@ -342,65 +385,131 @@ private:
       return;
     }
     stop_timer_(timer, false);
+    unlink_timer_(timer);
     timer.allocated = false;
-    timer.state.store(encode_state(STOPPED_FLAG, 0, 0), std::memory_order_relaxed);
+    timer.state.store(encode_state(STOPPED_FLAG, 0, 0));
     timer.callback = srsran::move_callback<void(uint32_t)>();
     free_list.push_front(&timer);
     nof_free_timers++;
     // leave id unchanged.
   }
 
-  void start_run_(timer_impl& timer, uint32_t duration_ = 0)
+  void start_run_(timer_impl& timer)
+  {
+    uint64_t old_state = timer.state.load(std::memory_order_relaxed);
+    uint64_t new_state;
+    do {
+      uint32_t duration_ = decode_duration(old_state);
+      new_state = encode_state(RUNNING_FLAG, duration_, cur_time.load(std::memory_order_relaxed) + duration_);
+    } while (not timer.state.compare_exchange_weak(old_state, new_state));
+    if (not decode_is_running(old_state)) {
+      nof_timers_running_.fetch_add(1, std::memory_order_relaxed);
+    }
+    push_pending_(timer);
+  }
+
+  /// called when user manually stops timer (as an alternative to expiry)
+  void stop_timer_(timer_impl& timer, bool expiry)
   {
-    uint64_t timer_old_state = timer.state.load(std::memory_order_relaxed);
-    duration_                = duration_ == 0 ? decode_duration(timer_old_state) : duration_;
-    uint32_t new_timeout     = cur_time.load(std::memory_order_relaxed) + duration_;
-    size_t   new_wheel_pos   = new_timeout & WHEEL_MASK;
-
-    uint32_t old_timeout = decode_timeout(timer_old_state);
-    bool     was_running = decode_is_running(timer_old_state);
-    if (was_running and (old_timeout & WHEEL_MASK) == new_wheel_pos) {
-      // If no change in timer wheel position. Just update absolute timeout
-      timer.state.store(encode_state(RUNNING_FLAG, duration_, new_timeout), std::memory_order_relaxed);
+    uint64_t old_state = timer.state.load(std::memory_order_relaxed);
+    uint64_t new_state;
+    do {
+      if (not decode_is_running(old_state)) {
+        return;
+      }
+      new_state =
+          encode_state(expiry ? EXPIRED_FLAG : STOPPED_FLAG, decode_duration(old_state), decode_timeout(old_state));
+    } while (not timer.state.compare_exchange_weak(old_state, new_state));
+    nof_timers_running_.fetch_sub(1, std::memory_order_relaxed);
+    // The wheel entry is removed in the next step_all()
+    push_pending_(timer);
+  }
+
+  /// Lock-free push of a timer whose state changed. A timer is only pushed once until step_all() handles it
+  void push_pending_(timer_impl& timer)
+  {
+    if (timer.pending.exchange(true)) {
       return;
     }
+    timer_impl* head = pending_head.load(std::memory_order_relaxed);
+    do {
+      timer.next_pending = head;
+    } while (not pending_head.compare_exchange_weak(head, &timer, std::memory_order_release));
+  }
 
-    // Stop timer if it was running, removing it from wheel in the process
-    if (was_running) {
-      time_wheel[old_timeout & WHEEL_MASK].pop(&timer);
-      nof_timers_running_--;
+  /// called in locked context by the thread that steps the timers
+  void apply_pending_(tic_t base_time)
+  {
+    timer_impl* timer = pending_head.exchange(nullptr, std::memory_order_acquire);
+    while (timer != nullptr) {
+      timer_impl* next = timer->next_pending;
+      // clear flag before reading the state, so that any later change pushes the timer again
+      timer->pending.store(false);
+      unlink_timer_(*timer);
+      uint64_t timer_state = timer->state.load();
+      if (decode_is_running(timer_state)) {
+        add_timer_(*timer, decode_timeout(timer_state), base_time);
+      }
+      timer = next;
     }
+  }
 
-    // Insert timer in wheel
-    time_wheel[new_wheel_pos].push_front(&timer);
-    timer.state.store(encode_state(RUNNING_FLAG, duration_, new_timeout), std::memory_order_relaxed);
-    nof_timers_running_++;
+  /// Re-distributes the timers of an upper level slot in the finer levels
+  void cascade_(uint32_t wheel_pos, tic_t base_time)
+  {
+    auto& wheel_list = time_wheel[wheel_pos];
+    while (not wheel_list.empty()) {
+      timer_impl& timer = wheel_list.front();
+      unlink_timer_(timer);
+      uint64_t timer_state = timer.state.load();
+      if (decode_is_running(timer_state)) {
+        add_timer_(timer, decode_timeout(timer_state), base_time);
+      }
+    }
   }
 
-  /// called when user manually stops timer (as an alternative to expiry)
-  void stop_timer_(timer_impl& timer, bool expiry)
+  /// Inserts timer in the coarsest wheel level able to represent its timeout relative to base_time
+  void add_timer_(timer_impl& timer, tic_t timeout, tic_t base_time)
   {
-    uint64_t timer_old_state = timer.state.load(std::memory_order_relaxed);
-    if (not decode_is_running(timer_old_state)) {
-      return;
+    uint32_t pos;
+    if (static_cast<int32_t>(timeout - base_time) < 0) {
+      // late insertion, expire it in the next processed tic
+      pos = base_time & LVL0_MASK;
+    } else {
+      uint32_t delta = timeout - base_time;
+      if (delta < LVL0_SIZE) {
+        pos = timeout & LVL0_MASK;
+      } else {
+        uint32_t level = 1;
+        uint32_t shift = LVL0_BITS;
+        while (level < NOF_LEVELS - 1 and (delta >> (shift + LVLN_BITS)) != 0) {
+          level++;
+          shift += LVLN_BITS;
+        }
+        pos = level_offset(level) + ((timeout >> shift) & LVLN_MASK);
+      }
     }
+    time_wheel[pos].push_front(&timer);
+    timer.wheel_pos = pos;
+  }
 
-    // If already running, need to disconnect it from previous wheel
-    uint32_t old_timeout = decode_timeout(timer_old_state);
-    time_wheel[old_timeout & WHEEL_MASK].pop(&timer);
-    uint64_t new_state =
-        encode_state(expiry ? EXPIRED_FLAG : STOPPED_FLAG, decode_duration(timer_old_state), old_timeout);
-    timer.state.store(new_state, std::memory_order_relaxed);
-    nof_timers_running_--;
+  void unlink_timer_(timer_impl& timer)
+  {
+    if (timer.wheel_pos != INVALID_POS) {
+      time_wheel[timer.wheel_pos].pop(&timer);
+      timer.wheel_pos = INVALID_POS;
+    }
   }
 
-  std::atomic<tic_t> cur_time{0};
-  size_t             nof_timers_running_ = 0, nof_free_timers = 0;
+  std::atomic<tic_t>       cur_time{0};
+  std::atomic<uint32_t>    nof_timers_running_{0};
+  size_t                   nof_free_timers = 0;
+  std::atomic<timer_impl*> pending_head{nullptr};
   // using a deque to maintain reference validity on emplace_back. Also, this deque will only grow.
-  std::deque<timer_impl>                                         timer_list;
-  srsran::intrusive_forward_list<timer_impl>                     free_list;
-  std::vector<srsran::intrusive_double_linked_list<timer_impl> > time_wheel;
-  mutable std::mutex                                             mutex; // Protect priority queue
+  std::deque<timer_impl>                                                   timer_list;
+  srsran::intrusive_forward_list<timer_impl>                               free_list;
+  std::array<srsran::intrusive_double_linked_list<timer_impl>, WHEEL_SIZE> time_wheel;
+  mutable std::mutex                                                       mutex; // Protect wheel and free list
 };
 
 using unique_timer = timer_handler::unique_timer;
@@ -159,6 +159,26 @@ public:
    */
   virtual int snr_info(uint32_t tti, uint16_t rnti, uint32_t cc_idx, float snr_db, ul_channel_t ch) = 0;
 
+  /**
+   * PHY callback for giving MAC the per sub-band SNR in dB measured on the SRS of a given RNTI at a given carrier
+   *
+   * @param tti The measurement was made
+   * @param rnti The UE identifier in the eNb
+   * @param cc_idx The eNb Cell/Carrier where the SRS was received
+   * @param prb_start First PRB of the first sub-band
+   * @param sb_nof_prb Number of PRB of every sub-band
+   * @param sb_snr_db SNR of each sub-band in dB
+   * @param nof_sb Number of sub-bands
+   * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR* if an error occurs
+   */
+  virtual int sb_snr_info(uint32_t     tti,
+                          uint16_t     rnti,
+                          uint32_t     cc_idx,
+                          uint32_t     prb_start,
+                          uint32_t     sb_nof_prb,
+                          const float* sb_snr_db,
+                          uint32_t     nof_sb) = 0;
+
   /**
    * PHY callback for giving MAC the Time Aligment information in microseconds of a given RNTI during a TTI processing
    *
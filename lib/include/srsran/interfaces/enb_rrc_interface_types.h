@@ -73,6 +73,7 @@ struct cell_cfg_t {
   bool                                enable_phr_handling;
   int                                 min_phr_thres;
   asn1::rrc::mob_ctrl_info_s::t304_e_ t304;
+  std::string                         pusch_estimator;
   std::vector<scell_cfg_t>            scell_list;
   rrc_meas_cfg_t                      meas_cfg;
 };
@@ -81,6 +81,7 @@ struct phy_args_t {
   bool        correct_sync_error           = false;
   bool        cfo_is_doppler               = false;
   bool        cfo_integer_enabled          = false;
+  bool        cfo_correct_deferred         = false;
   float       cfo_correct_tol_hz           = 1.0f;
   float       cfo_pss_ema                  = DEFAULT_CFO_EMA_TRACK;
   float       cfo_loop_bw_pss              = DEFAULT_CFO_BW_PSS;
@@ -95,6 +96,9 @@ struct phy_args_t {
   bool        estimator_fil_auto           = false;
   float       estimator_fil_stddev         = 1.0f;
   uint32_t    estimator_fil_order          = 4;
+  bool        estimator_incremental        = false;
+  float       estimator_incr_alpha         = 0.5f;
+  uint32_t    estimator_incr_period        = 5;
   float       snr_to_cqi_offset            = 0.0f;
   std::string sss_algorithm                = "full";
   float       rx_gain_offset               = 62;
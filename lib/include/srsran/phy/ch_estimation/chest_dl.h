@@ -65,6 +65,7 @@ typedef struct SRSRAN_API {
   float    rssi_dbm;
   float    cfo;
   float    sync_error;
+  float    reuse_ratio;
 } srsran_chest_dl_res_t;
 
 // Noise estimation algorithm
@@ -81,6 +82,22 @@ typedef enum SRSRAN_API {
   SRSRAN_ESTIMATOR_ALG_WIENER,
 } srsran_chest_dl_estimator_alg_t;
 
+// Per receive antenna and port state kept between subframes
+typedef struct SRSRAN_API {
+  cf_t*    pilots;     // Time filtered least square estimates
+  uint32_t nof_pilots; // Number of filtered estimates, 0 if the state is not valid
+  uint32_t tti;        // Last subframe that updated the state
+  uint32_t nof_held;   // Subframes since the last noise and RSSI measurement
+
+  // Cached smoothing filter and the parameters it was computed with
+  bool                  filter_valid;
+  float                 filter[SRSRAN_CHEST_MAX_SMOOTH_FIL_LEN];
+  uint32_t              filter_len;
+  srsran_chest_filter_t filter_type;
+  float                 filter_coef[2];
+  float                 filter_noise;
+} srsran_chest_dl_state_t;
+
 typedef struct SRSRAN_API {
   srsran_cell_t cell;
   uint32_t      nof_rx_antennas;
@@ -113,6 +130,10 @@ typedef struct SRSRAN_API {
   float sync_err[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS];
   float cfo;
 
+  srsran_chest_dl_state_t state[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS];
+  uint32_t                nof_reused;
+  uint32_t                nof_reusable;
+
   /* Use PSS for noise estimation in LS linear interpolation mode */
   cf_t pss_signal[SRSRAN_PSS_LEN];
   cf_t tmp_pss[SRSRAN_PSS_LEN];
@@ -133,6 +154,11 @@ typedef struct SRSRAN_API {
   uint32_t cfo_estimate_sf_mask;
   bool     sync_error_enable;
 
+  // Incremental estimation: time filters the pilots of stationary channels and measures noise and RSSI periodically
+  bool     incremental_enable;
+  float    incremental_alpha;  // Weight of the newest subframe in the pilot time filter, 1 disables the filter
+  uint32_t incremental_period; // Subframes between noise and RSSI measurements
+
 } srsran_chest_dl_cfg_t;
 
 SRSRAN_API int srsran_chest_dl_init(srsran_chest_dl_t* q, uint32_t max_prb, uint32_t nof_rx_antennas);
@@ -40,11 +40,18 @@
 
 #include "srsran/phy/ch_estimation/chest_common.h"
 #include "srsran/phy/ch_estimation/refsignal_ul.h"
+#include "srsran/phy/ch_estimation/wiener_ul.h"
 #include "srsran/phy/common/phy_common.h"
 #include "srsran/phy/phch/pucch_cfg.h"
 #include "srsran/phy/phch/pusch_cfg.h"
 #include "srsran/phy/resampling/interp.h"
 
+// PUSCH channel estimator algorithm
+typedef enum SRSRAN_API {
+  SRSRAN_CHEST_UL_ESTIMATOR_ALG_AVERAGE = 0,
+  SRSRAN_CHEST_UL_ESTIMATOR_ALG_WIENER,
+} srsran_chest_ul_estimator_alg_t;
+
 typedef struct SRSRAN_API {
   cf_t*    ce;
   uint32_t nof_re;
@@ -60,8 +67,24 @@ typedef struct SRSRAN_API {
   float    ta_us;
 } srsran_chest_ul_res_t;
 
+// SRS channel state is reported in subbands of 4 PRB, the granularity of the SRS bandwidth
+#define SRSRAN_CHEST_UL_SRS_SB_PRB (4U)
+#define SRSRAN_CHEST_UL_SRS_MAX_SB (SRSRAN_MAX_PRB / SRSRAN_CHEST_UL_SRS_SB_PRB)
+
+typedef struct SRSRAN_API {
+  uint32_t prb_start; ///< First sounded PRB
+  uint32_t nof_sb;    ///< Number of sounded subbands, of SRSRAN_CHEST_UL_SRS_SB_PRB each
+  float    noise_estimate;
+  float    rsrp;
+  float    rsrp_dBfs;
+  float    snr;
+  float    snr_db;                              ///< Wideband SINR
+  float    sb_snr_db[SRSRAN_CHEST_UL_SRS_MAX_SB]; ///< SINR of every sounded subband
+} srsran_chest_ul_srs_res_t;
+
 typedef struct {
   srsran_cell_t cell;
+  uint32_t      max_prb;
 
   srsran_refsignal_ul_t             dmrs_signal;
   srsran_refsignal_ul_dmrs_pregen_t dmrs_pregen;
@@ -85,6 +108,14 @@ typedef struct {
 
   srsran_interp_linsrsran_vec_t srsran_interp_linvec;
 
+  srsran_chest_ul_estimator_alg_t estimator_alg;
+  srsran_wiener_ul_t*             wiener_ul;
+
+  // Hann window for the SRS noise measurement, kept for the last sounding bandwidth
+  float*   srs_window;
+  uint32_t srs_window_len;
+  float    srs_window_pwr;
+
 } srsran_chest_ul_t;
 
 SRSRAN_API int srsran_chest_ul_init(srsran_chest_ul_t* q, uint32_t max_prb);
@@ -99,6 +130,19 @@ SRSRAN_API void srsran_chest_ul_res_free(srsran_chest_ul_res_t* q);
 
 SRSRAN_API int srsran_chest_ul_set_cell(srsran_chest_ul_t* q, srsran_cell_t cell);
 
+/**
+ * @brief Selects the algorithm that filters the PUSCH DMRS estimates. The Wiener filter bank is computed the first time
+ * it is selected
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_chest_ul_set_estimator_alg(srsran_chest_ul_t* q, srsran_chest_ul_estimator_alg_t alg);
+
+/**
+ * @brief Converts the name of a PUSCH estimator algorithm ("average" or "wiener") into its enumerated value
+ * @return SRSRAN_SUCCESS if the name is valid, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_chest_ul_str2estimator_alg(const char* str, srsran_chest_ul_estimator_alg_t* alg);
+
 SRSRAN_API void srsran_chest_ul_pregen(srsran_chest_ul_t*                 q,
                                        srsran_refsignal_dmrs_pusch_cfg_t* cfg,
                                        srsran_refsignal_srs_cfg_t*        srs_cfg);
@@ -122,4 +166,24 @@ SRSRAN_API int srsran_chest_ul_estimate_srs(srsran_chest_ul_t*                 q
                                             cf_t*                              input,
                                             srsran_chest_ul_res_t*             res);
 
+/**
+ * @brief Estimates the SRS of several UEs in the same subframe. The UEs sounding the same comb and bandwidth share the
+ * extraction, the base sequence and the transform to delay domain, each UE only windows its cyclic shift out of it.
+ * @param q UL channel estimator object
+ * @param sf Uplink subframe configuration
+ * @param cfg SRS configuration of every UE, they must transmit SRS in the subframe
+ * @param pusch_cfg Cell DMRS configuration, it gives the base sequence
+ * @param input Received subframe resource grid
+ * @param res Wideband and subband SINR of every UE
+ * @param nof_cfg Number of UEs
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_chest_ul_estimate_srs_multi(srsran_chest_ul_t*                 q,
+                                                  srsran_ul_sf_cfg_t*                sf,
+                                                  srsran_refsignal_srs_cfg_t*        cfg,
+                                                  srsran_refsignal_dmrs_pusch_cfg_t* pusch_cfg,
+                                                  cf_t*                              input,
+                                                  srsran_chest_ul_srs_res_t*         res,
+                                                  uint32_t                           nof_cfg);
+
 #endif // SRSRAN_CHEST_UL_H
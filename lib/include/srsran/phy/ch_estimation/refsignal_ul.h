@@ -40,6 +40,8 @@
 #define SRSRAN_NOF_DELTA_SS 30
 #define SRSRAN_NOF_CSHIFT 8
 
+#define SRSRAN_REFSIGNAL_PUCCH_MAX_N_RS 3
+
 #define SRSRAN_REFSIGNAL_UL_L(ns_idx, cp) ((ns_idx + 1) * SRSRAN_CP_NSYMB(cp) - 4)
 
 /* PUSCH DMRS common configuration (received in SIB2) */
@@ -128,6 +130,18 @@ SRSRAN_API void srsran_refsignal_dmrs_pusch_get(srsran_refsignal_ul_t* q,
                                                 cf_t*                  sf_symbols,
                                                 cf_t*                  r_pusch);
 
+/**
+ * @brief Computes the cyclic shift and the complex factor of every PUCCH DMRS symbol. The DMRS of symbol m in slot s is
+ * z[s][m] r_u(n) exp(j 2 pi n_cs[s][m] n / 12), where r_u is the base sequence of the slot.
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_refsignal_dmrs_pucch_cs(srsran_cp_t         cp,
+                                              const uint32_t      n_cs_cell[SRSRAN_NSLOTS_X_FRAME][SRSRAN_CP_NORM_NSYMB],
+                                              srsran_ul_sf_cfg_t* sf,
+                                              srsran_pucch_cfg_t* cfg,
+                                              uint32_t n_cs[SRSRAN_NOF_SLOTS_PER_SF][SRSRAN_REFSIGNAL_PUCCH_MAX_N_RS],
+                                              cf_t     z[SRSRAN_NOF_SLOTS_PER_SF][SRSRAN_REFSIGNAL_PUCCH_MAX_N_RS]);
+
 SRSRAN_API int srsran_refsignal_dmrs_pucch_gen(srsran_refsignal_ul_t* q,
                                                srsran_ul_sf_cfg_t*    sf,
                                                srsran_pucch_cfg_t*    cfg,
@@ -190,4 +204,6 @@ SRSRAN_API uint32_t srsran_refsignal_srs_rb_L_cs(uint32_t bw_cfg, uint32_t nof_p
 
 SRSRAN_API uint32_t srsran_refsignal_srs_M_sc(srsran_refsignal_ul_t* q, srsran_refsignal_srs_cfg_t* cfg);
 
+SRSRAN_API uint32_t srsran_refsignal_srs_k0(srsran_refsignal_ul_t* q, srsran_refsignal_srs_cfg_t* cfg, uint32_t tti);
+
 #endif // SRSRAN_REFSIGNAL_UL_H
@@ -0,0 +1,77 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         wiener_ul.h
+ *
+ *  Description:  Frequency domain Wiener filter for the uplink DMRS. The filters
+ *                are precomputed for a set of SNR and delay spread buckets and
+ *                applied PRB by PRB over a window of up to three PRB.
+ *
+ *  Reference:
+ *****************************************************************************/
+
+#ifndef SRSRAN_WIENER_UL_H
+#define SRSRAN_WIENER_UL_H
+
+#include "srsran/config.h"
+#include "srsran/phy/common/phy_common.h"
+
+// Filter bank dimensions
+#define SRSRAN_WIENER_UL_NOF_SNR (8U)
+#define SRSRAN_WIENER_UL_NOF_DS (4U)
+#define SRSRAN_WIENER_UL_WIN_PRB (3U)
+#define SRSRAN_WIENER_UL_WIN_RE (SRSRAN_WIENER_UL_WIN_PRB * SRSRAN_NRE)
+
+// Filter position within the allocation: one PRB, first and second of two PRB, first, middle and last of three or more
+#define SRSRAN_WIENER_UL_NOF_POS (6U)
+
+typedef struct SRSRAN_API {
+  uint32_t max_re;
+
+  // Filters indexed by SNR bucket, delay spread bucket, position, window RE and output RE
+  float* bank;
+
+  // Derotated pilots
+  cf_t* tmp;
+
+  // Last measurement
+  float noise;
+  float snr_db;
+  float delay_spread_us;
+} srsran_wiener_ul_t;
+
+SRSRAN_API int srsran_wiener_ul_init(srsran_wiener_ul_t* q, uint32_t max_prb);
+
+SRSRAN_API void srsran_wiener_ul_free(srsran_wiener_ul_t* q);
+
+/**
+ * @brief Filters the least square estimates of one DMRS symbol. The noise, SNR and delay spread are measured from the
+ * estimates themselves and select the filter from the bank
+ * @param q Wiener filter object
+ * @param pilots Least square estimates, one per subcarrier
+ * @param estimated Filtered estimates, it can not overlap with pilots
+ * @param nof_re Number of subcarriers, a multiple of SRSRAN_NRE
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_wiener_ul_run(srsran_wiener_ul_t* q, const cf_t* pilots, cf_t* estimated, uint32_t nof_re);
+
+#endif // SRSRAN_WIENER_UL_H
@@ -29,8 +29,13 @@
 #include "rlf.h"
 #include "srsran/phy/common/phy_common.h"
 #include "srsran/srslog/srslog.h"
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace srsran {
 
@@ -39,7 +44,8 @@ class channel
 public:
   struct args_t {
     // General
-    bool enable = false;
+    bool     enable      = false;
+    uint32_t nof_threads = 1; ///< Number of threads processing the channels in parallel, 1 runs them sequentially
 
     // AWGN options
     bool  awgn_enable            = false;
@@ -76,18 +82,38 @@ public:
   void run(cf_t* in[SRSRAN_MAX_CHANNELS], cf_t* out[SRSRAN_MAX_CHANNELS], uint32_t len, const srsran_timestamp_t& t);
 
 private:
+  void run_channel(uint32_t i);
+  void run_pending_channels();
+  void worker_thread();
+
   srslog::basic_logger&    logger;
-  float                    hst_init_phase              = 0.0f;
-  srsran_channel_fading_t* fading[SRSRAN_MAX_CHANNELS] = {};
-  srsran_channel_delay_t*  delay[SRSRAN_MAX_CHANNELS]  = {};
-  srsran_channel_awgn_t*   awgn                        = nullptr;
-  srsran_channel_hst_t*    hst                         = nullptr;
-  srsran_channel_rlf_t*    rlf                         = nullptr;
-  cf_t*                    buffer_in                   = nullptr;
-  cf_t*                    buffer_out                  = nullptr;
-  uint32_t                 nof_channels                = 0;
-  uint32_t                 current_srate               = 0;
-  args_t                   args                        = {};
+  float                    hst_init_phase                  = 0.0f;
+  srsran_channel_fading_t* fading[SRSRAN_MAX_CHANNELS]     = {};
+  srsran_channel_delay_t*  delay[SRSRAN_MAX_CHANNELS]      = {};
+  srsran_channel_awgn_t*   awgn[SRSRAN_MAX_CHANNELS]       = {};
+  srsran_channel_hst_t*    hst[SRSRAN_MAX_CHANNELS]        = {};
+  srsran_channel_rlf_t*    rlf                             = nullptr;
+  cf_t*                    buffer_in[SRSRAN_MAX_CHANNELS]  = {};
+  cf_t*                    buffer_out[SRSRAN_MAX_CHANNELS] = {};
+  uint32_t                 nof_channels                    = 0;
+  uint32_t                 current_srate                   = 0;
+  args_t                   args                            = {};
+
+  // Current run, every channel uses its own buffers and emulator objects so they can be processed in parallel
+  cf_t* const*              run_in  = nullptr;
+  cf_t* const*              run_out = nullptr;
+  uint32_t                  run_len = 0;
+  const srsran_timestamp_t* run_ts  = nullptr;
+
+  // Helper threads, each of them takes the next pending channel until all of them are processed
+  std::vector<std::thread> workers;
+  std::mutex               workers_mutex;
+  std::condition_variable  workers_cvar;
+  std::condition_variable  done_cvar;
+  uint64_t                 run_count   = 0;
+  bool                     quit        = false;
+  std::atomic<uint32_t>    next_ch     = {0};
+  std::atomic<uint32_t>    nof_pending = {0};
 };
 
 typedef std::unique_ptr<channel> channel_ptr;
@@ -83,6 +83,65 @@ SRSRAN_API void srsran_sequence_apply_packed(const uint8_t* in, uint8_t* out, ui
 
 SRSRAN_API void srsran_sequence_apply_bit(const uint8_t* in, uint8_t* out, uint32_t length, uint32_t seed);
 
+/**
+ * @brief Generates the sequences of several seeds at once, packed MSB first as srsran_bit_pack_vector
+ * @param seeds Seed of every sequence
+ * @param out Output of every sequence, each of them with at least (length + 7) / 8 bytes
+ * @param nof_seeds Number of seeds
+ * @param length Number of bits of every sequence
+ */
+SRSRAN_API void
+srsran_sequence_gen_packed_multi(const uint32_t* seeds, uint8_t** out, uint32_t nof_seeds, uint32_t length);
+
+/* Apply a sequence previously generated by srsran_sequence_gen_packed_multi() */
+SRSRAN_API void srsran_sequence_packed_apply_f(const uint8_t* c, const float* in, float* out, uint32_t length);
+
+SRSRAN_API void srsran_sequence_packed_apply_s(const uint8_t* c, const int16_t* in, int16_t* out, uint32_t length);
+
+SRSRAN_API void srsran_sequence_packed_apply_c(const uint8_t* c, const int8_t* in, int8_t* out, uint32_t length);
+
+SRSRAN_API void srsran_sequence_packed_apply_packed(const uint8_t* c, const uint8_t* in, uint8_t* out, uint32_t length);
+
+typedef struct SRSRAN_API {
+  uint32_t seed;
+  uint32_t len; ///< Number of generated bits, 0 if the entry is empty
+  uint8_t* c;   ///< Packed sequence
+} srsran_sequence_cache_entry_t;
+
+/**
+ * @brief Cache of packed sequences indexed by seed, bounded to a memory budget. Every seed maps to a single entry and a
+ * miss replaces it. It is not thread safe, every thread shall use its own cache.
+ */
+typedef struct SRSRAN_API {
+  srsran_sequence_cache_entry_t* entries;
+  uint8_t*                       buffer;
+  uint32_t                       nof_entries;
+  uint32_t                       max_len; ///< Maximum sequence length in bits
+} srsran_sequence_cache_t;
+
+/**
+ * @brief Initialises a sequence cache
+ * @param q Sequence cache object
+ * @param max_len Maximum length in bits of the cached sequences, longer sequences are not cached
+ * @param max_bytes Memory budget of the cached sequences
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_sequence_cache_init(srsran_sequence_cache_t* q, uint32_t max_len, uint32_t max_bytes);
+
+SRSRAN_API void srsran_sequence_cache_free(srsran_sequence_cache_t* q);
+
+/**
+ * @brief Gets a packed sequence from the cache, it is generated if it is not present
+ * @return The packed sequence, or NULL if the cache is not initialised or the length exceeds its maximum
+ */
+SRSRAN_API const uint8_t* srsran_sequence_cache_get(srsran_sequence_cache_t* q, uint32_t seed, uint32_t len);
+
+/**
+ * @brief Generates the missing sequences of several seeds in parallel, for example all the RNTI scheduled in a subframe
+ */
+SRSRAN_API void
+srsran_sequence_cache_prefetch(srsran_sequence_cache_t* q, const uint32_t* seeds, uint32_t nof_seeds, uint32_t len);
+
 SRSRAN_API int srsran_sequence_pbch(srsran_sequence_t* seq, srsran_cp_t cp, uint32_t cell_id);
 
 SRSRAN_API int srsran_sequence_pcfich(srsran_sequence_t* seq, uint32_t nslot, uint32_t cell_id);
@@ -126,6 +185,55 @@ SRSRAN_API void srsran_sequence_pdsch_apply_c(const int8_t* in,
                                               uint32_t      cell_id,
                                               uint32_t      len);
 
+/* Same as above, the scrambling sequences are taken from the cache if it is initialised, otherwise they are generated
+ * on the fly */
+SRSRAN_API void srsran_sequence_pdsch_apply_pack_cached(srsran_sequence_cache_t* cache,
+                                                        const uint8_t*           in,
+                                                        uint8_t*                 out,
+                                                        uint16_t                 rnti,
+                                                        int                      q,
+                                                        uint32_t                 nslot,
+                                                        uint32_t                 cell_id,
+                                                        uint32_t                 len);
+
+SRSRAN_API void srsran_sequence_pdsch_apply_f_cached(srsran_sequence_cache_t* cache,
+                                                     const float*             in,
+                                                     float*                   out,
+                                                     uint16_t                 rnti,
+                                                     int                      q,
+                                                     uint32_t                 nslot,
+                                                     uint32_t                 cell_id,
+                                                     uint32_t                 len);
+
+SRSRAN_API void srsran_sequence_pdsch_apply_s_cached(srsran_sequence_cache_t* cache,
+                                                     const int16_t*           in,
+                                                     int16_t*                 out,
+                                                     uint16_t                 rnti,
+                                                     int                      q,
+                                                     uint32_t                 nslot,
+                                                     uint32_t                 cell_id,
+                                                     uint32_t                 len);
+
+SRSRAN_API void srsran_sequence_pdsch_apply_c_cached(srsran_sequence_cache_t* cache,
+                                                     const int8_t*            in,
+                                                     int8_t*                  out,
+                                                     uint16_t                 rnti,
+                                                     int                      q,
+                                                     uint32_t                 nslot,
+                                                     uint32_t                 cell_id,
+                                                     uint32_t                 len);
+
+/**
+ * @brief Generates into the cache the PDSCH scrambling sequences of several RNTI in the same slot and codeword
+ */
+SRSRAN_API void srsran_sequence_pdsch_prefetch(srsran_sequence_cache_t* cache,
+                                               const uint16_t*          rnti,
+                                               uint32_t                 nof_rnti,
+                                               int                      q,
+                                               uint32_t                 nslot,
+                                               uint32_t                 cell_id,
+                                               uint32_t                 len);
+
 SRSRAN_API int
 srsran_sequence_pusch(srsran_sequence_t* seq, uint16_t rnti, uint32_t nslot, uint32_t cell_id, uint32_t len);
 
@@ -0,0 +1,88 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**********************************************************************************************
+ *  File:         dft_mixed_radix.h
+ *
+ *  Description:  Mixed radix 2/3/4/5 DFT for the transform precoding sizes (2^a 3^b 5^c).
+ *                Plans only hold the factorisation and the twiddles, they are created on
+ *                first use and shared by the whole process.
+ *
+ *  Reference:    3GPP TS 36.211 version 10.0.0 Release 10 Sec. 5.3.3
+ *                3GPP TS 38.211 version 15.8.0 Release 15 Sec. 6.3.1.4
+ *********************************************************************************************/
+
+#ifndef SRSRAN_DFT_MIXED_RADIX_H
+#define SRSRAN_DFT_MIXED_RADIX_H
+
+#include "srsran/config.h"
+#include "srsran/phy/dft/dft.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Covers the NR transform precoding sizes, 275 PRB of 12 subcarriers */
+#define SRSRAN_DFT_MIXED_RADIX_MAX_SIZE 3300
+
+#define SRSRAN_DFT_MIXED_RADIX_MAX_STAGES 16
+
+typedef struct SRSRAN_API {
+  uint32_t size;
+  uint32_t nof_stages;
+  uint32_t radix[SRSRAN_DFT_MIXED_RADIX_MAX_STAGES];
+  cf_t*    twiddle[SRSRAN_DFT_MIXED_RADIX_MAX_STAGES]; ///< Forward twiddles of every stage, indexed [radix - 1][m]
+} srsran_dft_mixed_radix_plan_t;
+
+/**
+ * @brief Checks whether a DFT size can be factorised in radix 2, 3 and 5 and it does not exceed the maximum
+ */
+SRSRAN_API bool srsran_dft_mixed_radix_valid_size(uint32_t size);
+
+/**
+ * @brief Gets the shared plan of a DFT size, it is created in the first call. It is thread safe.
+ * @return The plan, or NULL if the size is not valid or the plan could not be created
+ */
+SRSRAN_API const srsran_dft_mixed_radix_plan_t* srsran_dft_mixed_radix_get_plan(uint32_t size);
+
+/**
+ * @brief Runs a DFT
+ * @param plan Plan given by srsran_dft_mixed_radix_get_plan()
+ * @param in Input of size samples
+ * @param out Output of size samples, it can be the same as the input
+ * @param scratch Temporal buffer of 2 * size samples
+ * @param dir Forward or backward transform
+ * @param scale Scaling applied to the output, for example 1/sqrt(size) for a normalised transform
+ */
+SRSRAN_API void srsran_dft_mixed_radix_run(const srsran_dft_mixed_radix_plan_t* plan,
+                                           const cf_t*                          in,
+                                           cf_t*                                out,
+                                           cf_t*                                scratch,
+                                           srsran_dft_dir_t                     dir,
+                                           float                                scale);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSRAN_DFT_MIXED_RADIX_H
@@ -34,12 +34,15 @@
 #include "srsran/config.h"
 #include "srsran/phy/common/phy_common.h"
 #include "srsran/phy/dft/dft.h"
+#include "srsran/phy/dft/dft_mixed_radix.h"
 
 /* DFT-based Transform Precoding object */
 typedef struct SRSRAN_API {
 
-  uint32_t          max_prb;
-  srsran_dft_plan_t dft_plan[SRSRAN_MAX_PRB + 1];
+  uint32_t                             max_prb;
+  srsran_dft_dir_t                     dir;
+  const srsran_dft_mixed_radix_plan_t* plan[SRSRAN_MAX_PRB + 1]; ///< Shared plans, they are not owned by the object
+  cf_t*                                scratch;
 
 } srsran_dft_precoding_t;
 
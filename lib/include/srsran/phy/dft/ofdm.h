@@ -87,7 +87,11 @@ typedef struct SRSRAN_API {
   cf_t*             shift_buffer;
   cf_t*             window_offset_buffer;
   cf_t              phase_compensation[SRSRAN_MAX_NSYMB * SRSRAN_NOF_SLOTS_PER_SF];
-  srsran_cfr_t      tx_cfr; ///< Tx CFR object
+  srsran_cfr_t      tx_cfr;      ///< Tx CFR object
+  float             cfo;         ///< Rx frequency offset correction, normalised by the subcarrier spacing
+  float             cfo_phase;   ///< Rx correction phase of the first sample of the subframe in radians
+  cf_t*             cfo_buffer;  ///< Rx DFT input of one symbol with the frequency offset corrected
+  float             time_offset; ///< Rx time offset correction in samples, folded into the window offset
 } srsran_ofdm_t;
 
 /**
@@ -146,6 +150,31 @@ SRSRAN_API void srsran_ofdm_set_normalize(srsran_ofdm_t* q, bool normalize_enabl
 
 SRSRAN_API int srsran_ofdm_set_phase_compensation(srsran_ofdm_t* q, double center_freq_hz);
 
+/**
+ * @brief Sets the carrier frequency offset the receiver corrects while it loads every DFT input, it saves correcting
+ * the whole subframe in a separate pass and leaves the input buffer untouched. The cyclic prefixes are not corrected.
+ *
+ * @note The phase of the first sample is given by the caller, so the correction keeps a continuous phase across
+ * consecutive subframes even if they are demodulated by different OFDM objects
+ *
+ * @param q OFDM object
+ * @param cfo Frequency offset to correct, normalised by the subcarrier spacing. Set to 0 to disable
+ * @param phase Phase of the correction applied to the first sample of the subframe in radians
+ */
+SRSRAN_API void srsran_ofdm_rx_set_cfo(srsran_ofdm_t* q, float cfo, float phase);
+
+/**
+ * @brief Sets the time offset the receiver corrects after the DFT, typically the fractional timing drift caused by a
+ * sampling frequency offset between two integer sample adjustments. It is applied as a per-subcarrier phase ramp, in
+ * the same product as the DFT window offset, so it does not take an extra pass.
+ *
+ * @note Only the Guru DFT path applies it, MBSFN subframes are not corrected
+ *
+ * @param q OFDM object
+ * @param time_offset Delay of the received signal with respect to the DFT window in samples. Set to 0 to disable
+ */
+SRSRAN_API void srsran_ofdm_rx_set_time_offset(srsran_ofdm_t* q, float time_offset);
+
 SRSRAN_API void srsran_ofdm_set_non_mbsfn_region(srsran_ofdm_t* q, uint8_t non_mbsfn_region);
 
 SRSRAN_API int srsran_ofdm_set_cfr(srsran_ofdm_t* q, srsran_cfr_cfg_t* cfr);
@@ -61,6 +61,10 @@ typedef struct SRSRAN_API {
   srsran_pusch_t    pusch;
   srsran_pucch_t    pucch;
 
+  srsran_pucch_bank_t* pucch_banks;
+  uint32_t             max_pucch_banks;
+  uint32_t             nof_pucch_banks;
+
 } srsran_enb_ul_t;
 
 /* This function shall be called just after the initial synchronization */
@@ -80,9 +84,44 @@ SRSRAN_API int srsran_enb_ul_get_pucch(srsran_enb_ul_t*    q,
                                        srsran_pucch_cfg_t* cfg,
                                        srsran_pucch_res_t* res);
 
+/**
+ * @brief Decodes the PUCCH of several UEs in the same subframe. The resources sharing a PRB pair are demodulated from a
+ * single correlation against all the cyclic shifts, the ones that can not (format 3) are decoded one by one.
+ * @param q eNb UL object
+ * @param ul_sf Uplink subframe configuration
+ * @param cfg PUCCH configuration of every UE
+ * @param res PUCCH result of every UE
+ * @param ue_ret Decoding status of every UE, SRSRAN_SUCCESS or the error code of the UEs whose result is not valid
+ * @param nof_cfg Number of UEs
+ * @return SRSRAN_SUCCESS if every UE is decoded, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_enb_ul_get_pucch_multi(srsran_enb_ul_t*    q,
+                                             srsran_ul_sf_cfg_t* ul_sf,
+                                             srsran_pucch_cfg_t* cfg,
+                                             srsran_pucch_res_t* res,
+                                             int*                ue_ret,
+                                             uint32_t            nof_cfg);
+
 SRSRAN_API int srsran_enb_ul_get_pusch(srsran_enb_ul_t*    q,
                                        srsran_ul_sf_cfg_t* ul_sf,
                                        srsran_pusch_cfg_t* cfg,
                                        srsran_pusch_res_t* res);
 
+/**
+ * @brief Measures the SRS of several UEs in the same subframe, giving their wideband and subband SINR
+ * @param q eNb UL object
+ * @param ul_sf Uplink subframe configuration
+ * @param pusch_cfg Cell DMRS configuration
+ * @param cfg SRS configuration of every UE
+ * @param res SRS measurements of every UE
+ * @param nof_cfg Number of UEs
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_enb_ul_get_srs_multi(srsran_enb_ul_t*                   q,
+                                           srsran_ul_sf_cfg_t*                ul_sf,
+                                           srsran_refsignal_dmrs_pusch_cfg_t* pusch_cfg,
+                                           srsran_refsignal_srs_cfg_t*        cfg,
+                                           srsran_chest_ul_srs_res_t*         res,
+                                           uint32_t                           nof_cfg);
+
 #endif // SRSRAN_ENB_UL_H
@@ -95,6 +95,26 @@ SRSRAN_API int srsran_predecoding_diversity_multi(cf_t*  y[SRSRAN_MAX_PORTS],
                                                   int    nof_symbols,
                                                   float  scaling);
 
+/**
+ * @brief Detects nof_layers spatially multiplexed layers from nof_rxant antennas with the configured ZF or MMSE decoder
+ * @param y Received signal of every antenna
+ * @param h Effective channel h[layer][rx], including the precoding
+ * @param x Detected symbols of every layer, they can overlap with y
+ * @param sinr Post-equalisation SINR of every layer and RE, for a unit noise variance if noise_estimate is zero. Set
+ * to NULL if not required
+ * @param noise_estimate Noise variance, the MMSE decoder falls back to ZF if it is not greater than zero
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_predecoding_mimo(cf_t*  y[SRSRAN_MAX_PORTS],
+                                       cf_t*  h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                                       cf_t*  x[SRSRAN_MAX_LAYERS],
+                                       float* sinr[SRSRAN_MAX_LAYERS],
+                                       int    nof_rxant,
+                                       int    nof_layers,
+                                       int    nof_symbols,
+                                       float  scaling,
+                                       float  noise_estimate);
+
 SRSRAN_API void srsran_predecoding_set_mimo_decoder(srsran_mimo_decoder_t _mimo_decoder);
 
 SRSRAN_API int srsran_predecoding_type(cf_t*              y[SRSRAN_MAX_PORTS],
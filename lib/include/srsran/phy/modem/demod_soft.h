@@ -23,7 +23,7 @@
  *  File:         demod_soft.h
  *
  *  Description:  Soft demodulator.
- *                Supports BPSK, QPSK, 16QAM and 64QAM.
+ *                Supports BPSK, QPSK, 16QAM, 64QAM and 256QAM.
  *
  *  Reference:    3GPP TS 36.211 version 10.0.0 Release 10 Sec. 7.1
  *****************************************************************************/
@@ -42,4 +42,35 @@ SRSRAN_API int srsran_demod_soft_demodulate_s(srsran_mod_t modulation, const cf_
 
 SRSRAN_API int srsran_demod_soft_demodulate_b(srsran_mod_t modulation, const cf_t* symbols, int8_t* llr, int nsymbols);
 
+/**
+ * @brief Soft demodulates the symbols and scales the LLR of every symbol by its weight in the same pass
+ *
+ * The weights are typically the post-equalization SNR or CSI of every resource element, they must not be negative. If
+ * weights is NULL, the result is the same as the unweighted demodulation.
+ *
+ * @param modulation Modulation of the symbols
+ * @param symbols Equalized symbols
+ * @param weights Weight of every symbol, NULL for no weighting
+ * @param llr Output LLR, nsymbols times the number of bits per symbol
+ * @param nsymbols Number of symbols
+ * @return 0 if the modulation is valid, -1 otherwise
+ */
+SRSRAN_API int srsran_demod_soft_demodulate_weighted(srsran_mod_t modulation,
+                                                     const cf_t*  symbols,
+                                                     const float* weights,
+                                                     float*       llr,
+                                                     int          nsymbols);
+
+SRSRAN_API int srsran_demod_soft_demodulate_weighted_s(srsran_mod_t modulation,
+                                                       const cf_t*  symbols,
+                                                       const float* weights,
+                                                       short*       llr,
+                                                       int          nsymbols);
+
+SRSRAN_API int srsran_demod_soft_demodulate_weighted_b(srsran_mod_t modulation,
+                                                       const cf_t*  symbols,
+                                                       const float* weights,
+                                                       int8_t*      llr,
+                                                       int          nsymbols);
+
 #endif // SRSRAN_DEMOD_SOFT_H
@@ -33,6 +33,7 @@
 #include "srsran/config.h"
 #include "srsran/phy/ch_estimation/chest_dl.h"
 #include "srsran/phy/common/phy_common.h"
+#include "srsran/phy/common/sequence.h"
 #include "srsran/phy/mimo/layermap.h"
 #include "srsran/phy/mimo/precoding.h"
 #include "srsran/phy/modem/demod_soft.h"
@@ -72,6 +73,9 @@ typedef struct SRSRAN_API {
   srsran_evm_buffer_t* evm_buffer[SRSRAN_MAX_CODEWORDS];
   float                avg_evm;
 
+  // Scrambling sequence caches, one for each codeword (avoid concurrency issue with coworker)
+  srsran_sequence_cache_t seq_cache[SRSRAN_MAX_CODEWORDS];
+
   srsran_sch_t dl_sch;
 
   void* coworker_ptr;
@@ -96,6 +100,21 @@ SRSRAN_API int srsran_pdsch_enable_coworker(srsran_pdsch_t* q);
 
 SRSRAN_API int srsran_pdsch_set_cell(srsran_pdsch_t* q, srsran_cell_t cell);
 
+/**
+ * @brief Enables caching the scrambling sequences of every RNTI and subframe, saving their generation in every radio
+ * frame. The memory budget applies to each codeword.
+ */
+SRSRAN_API int srsran_pdsch_set_sequence_cache(srsran_pdsch_t* q, uint32_t max_bytes);
+
+/**
+ * @brief Generates in parallel the scrambling sequences of the PDSCH transmissions of a subframe before encoding them,
+ * for example all the RNTI scheduled in it. It does nothing if the sequence cache is not enabled.
+ */
+SRSRAN_API void srsran_pdsch_prefetch_sequences(srsran_pdsch_t*            q,
+                                                srsran_dl_sf_cfg_t*        sf,
+                                                srsran_pdsch_cfg_t* const* cfg,
+                                                uint32_t                   nof_cfg);
+
 /* These functions do not modify the state and run in real-time */
 SRSRAN_API int srsran_pdsch_encode(srsran_pdsch_t*     q,
                                    srsran_dl_sf_cfg_t* sf,
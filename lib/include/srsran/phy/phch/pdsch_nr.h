@@ -48,6 +48,7 @@ typedef struct SRSRAN_API {
   bool                 measure_time;
   uint32_t             max_prb;
   uint32_t             max_layers;
+  uint32_t             nof_rx_ant; ///< Number of receive antennas, set to zero for as many as layers
 } srsran_pdsch_nr_args_t;
 
 /**
@@ -57,11 +58,14 @@ typedef struct SRSRAN_API {
   uint32_t             max_prb;                         ///< Maximum number of allocated prb
   uint32_t             max_layers;                      ///< Maximum number of allocated layers
   uint32_t             max_cw;                          ///< Maximum number of allocated code words
+  uint32_t             nof_rx_ant;                      ///< Number of receive antennas, zero for as many as layers
   srsran_carrier_nr_t  carrier;                         ///< NR carrier configuration
   srsran_sch_nr_t      sch;                             ///< SCH Encoder/Decoder Object
   uint8_t*             b[SRSRAN_MAX_CODEWORDS];         ///< SCH Encoded and scrambled data
   cf_t*                d[SRSRAN_MAX_CODEWORDS];         ///< PDSCH modulated bits
+  float*               csi[SRSRAN_MAX_CODEWORDS];       ///< Normalised SINR of every code word symbol
   cf_t*                x[SRSRAN_MAX_LAYERS_NR];         ///< PDSCH modulated bits
+  float*               sinr[SRSRAN_MAX_LAYERS_NR];      ///< Post-equalisation SINR of every layer
   srsran_modem_table_t modem_tables[SRSRAN_MOD_NITEMS]; ///< Modulator tables
   srsran_evm_buffer_t* evm_buffer;
   bool                 meas_time_en;
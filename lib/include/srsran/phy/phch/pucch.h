@@ -34,6 +34,7 @@
 #include "srsran/phy/ch_estimation/chest_ul.h"
 #include "srsran/phy/common/phy_common.h"
 #include "srsran/phy/common/sequence.h"
+#include "srsran/phy/dft/dft_mixed_radix.h"
 #include "srsran/phy/modem/mod.h"
 #include "srsran/phy/phch/cqi.h"
 #include "srsran/phy/phch/pucch_cfg.h"
@@ -57,6 +58,8 @@
 #define SRSRAN_PUCCH_DEFAULT_THRESHOLD_FORMAT2 (0.5f)
 #define SRSRAN_PUCCH_DEFAULT_THRESHOLD_FORMAT3 (0.5f)
 #define SRSRAN_PUCCH_DEFAULT_THRESHOLD_DMRS (0.4f)
+#define SRSRAN_PUCCH_DEFAULT_THRESHOLD_FORMAT1_BANK (0.5f)
+#define SRSRAN_PUCCH_DEFAULT_THRESHOLD_DMRS_BANK (0.25f)
 
 /* PUCCH object */
 typedef struct SRSRAN_API {
@@ -78,8 +81,22 @@ typedef struct SRSRAN_API {
   cf_t* z_tmp;
   cf_t* ce;
 
+  const srsran_dft_mixed_radix_plan_t* dft_cs; ///< 12 point DFT, correlates against all cyclic shifts at once
+
 } srsran_pucch_t;
 
+/**
+ * PUCCH format 1 and 2 resources in the same PRB pair share the base sequence and only differ in the cyclic shift and
+ * the orthogonal cover. The bank holds every received symbol of the PRB pair despread by the base sequence and its
+ * correlation against the 12 cyclic shifts, so any number of resources are decoded from it without touching the grid.
+ */
+typedef struct SRSRAN_API {
+  uint32_t m;                ///< PUCCH frequency resource index, it gives the PRB of every slot
+  bool     group_hopping_en; ///< Group hopping used for the base sequence
+  cf_t     z[SRSRAN_NOF_SLOTS_PER_SF][SRSRAN_CP_NORM_NSYMB][SRSRAN_NRE];    ///< Received times the conjugated base sequence
+  cf_t     corr[SRSRAN_NOF_SLOTS_PER_SF][SRSRAN_CP_NORM_NSYMB][SRSRAN_NRE]; ///< Correlation with every cyclic shift
+} srsran_pucch_bank_t;
+
 typedef struct SRSRAN_API {
   srsran_uci_value_t uci_data;
   float              dmrs_correlation;
@@ -119,6 +136,40 @@ SRSRAN_API int srsran_pucch_decode(srsran_pucch_t*        q,
                                    cf_t*                  sf_symbols,
                                    srsran_pucch_res_t*    data);
 
+/**
+ * @brief Correlates a PUCCH PRB pair against all the cyclic shifts of the base sequence
+ * @param q PUCCH object
+ * @param sf Uplink subframe configuration
+ * @param m PUCCH frequency resource index, as given by srsran_pucch_m()
+ * @param group_hopping_en Group hopping enabled in the cell
+ * @param sf_symbols Received resource grid
+ * @param bank Correlation bank of the PRB pair
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_pucch_bank_compute(srsran_pucch_t*      q,
+                                         srsran_ul_sf_cfg_t*  sf,
+                                         uint32_t             m,
+                                         bool                 group_hopping_en,
+                                         const cf_t*          sf_symbols,
+                                         srsran_pucch_bank_t* bank);
+
+/**
+ * @brief Estimates the channel and decodes a PUCCH format 1, 1a, 1b, 2, 2a or 2b resource from the correlation bank of
+ * its PRB pair. It replaces srsran_chest_ul_estimate_pucch() followed by srsran_pucch_decode() and fills the signal
+ * measurements of the result too.
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_pucch_decode_bank(srsran_pucch_t*            q,
+                                        srsran_ul_sf_cfg_t*        sf,
+                                        srsran_pucch_cfg_t*        cfg,
+                                        const srsran_pucch_bank_t* bank,
+                                        srsran_pucch_res_t*        data);
+
+/**
+ * @brief Checks whether a PUCCH configuration can be decoded from a correlation bank
+ */
+SRSRAN_API bool srsran_pucch_bank_supported(const srsran_pucch_cfg_t* cfg, srsran_cp_t cp);
+
 /* Other utilities. These functions do not modify the state and run in real-time */
 SRSRAN_API float srsran_pucch_alpha_format1(const uint32_t n_cs_cell[SRSRAN_NSLOTS_X_FRAME][SRSRAN_CP_NORM_NSYMB],
                                             const srsran_pucch_cfg_t* cfg,
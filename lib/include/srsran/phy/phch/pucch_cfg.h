@@ -77,6 +77,8 @@ typedef struct SRSRAN_API {
   float threshold_data_valid_format2;
   float threshold_data_valid_format3;
   float threshold_dmrs_detection;
+  float threshold_format1_bank;        // srsran_pucch_decode_bank() metrics follow their own statistics
+  float threshold_dmrs_detection_bank; // DMRS energy over DMRS plus noise energy, see srsran_pucch_decode_bank()
   bool  meas_ta_en;
 
   // PUCCH configuration generated during a call to encode/decode
@@ -0,0 +1,142 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         pss_sss_batch.h
+ *
+ *  Description:  Batched PSS/SSS detector for intra-frequency cell search.
+ *
+ *                Correlates a window of samples with the three PSS roots at
+ *                once. The window is transformed to the frequency domain a
+ *                single time and multiplied by each of the PSS sequences, so
+ *                a search over all N_id_2 costs one forward FFT and three
+ *                inverse FFTs instead of three convolutions. For every PSS
+ *                peak above the threshold, the SSS symbol is correlated
+ *                against all the N_id_1 candidates of that N_id_2.
+ *
+ *                Equivalent to three srsran_sync_t objects configured with
+ *                the same window and a different N_id_2, with CFO correction
+ *                disabled and normal CP.
+ *
+ *  Reference:    3GPP TS 36.211 version 10.0.0 Release 10 Sec. 6.11
+ *****************************************************************************/
+
+#ifndef SRSRAN_PSS_SSS_BATCH_H
+#define SRSRAN_PSS_SSS_BATCH_H
+
+#include "srsran/config.h"
+#include "srsran/phy/common/phy_common.h"
+#include "srsran/phy/sync/pss.h"
+#include "srsran/phy/sync/sss.h"
+
+/**
+ * @brief Detection result of one N_id_2 in a window
+ */
+typedef struct SRSRAN_API {
+  bool                pss_found;    ///< The PSS peak to side-lobe ratio exceeds the threshold
+  bool                sss_detected; ///< The SSS was detected in at least one of the frame type trials
+  uint32_t            peak_pos;     ///< PSS correlation peak position, relative to the window start
+  float               peak_value;   ///< PSS correlation peak to side-lobe ratio
+  uint32_t            N_id_1;       ///< Detected N_id_1, valid if sss_detected
+  uint32_t            sf_idx;       ///< Detected subframe index, valid if sss_detected
+  float               sss_corr;     ///< SSS correlation peak, valid if sss_detected
+  srsran_frame_type_t frame_type;   ///< Frame type of the strongest SSS trial, valid if sss_detected
+} srsran_pss_sss_batch_res_t;
+
+/**
+ * @brief Batched PSS/SSS detector object
+ */
+typedef struct SRSRAN_API {
+  srsran_pss_t pss; ///< Holds the PSS sequences and the correlation FFT plans shared by the three roots
+  srsran_sss_t sss;
+
+  uint32_t max_frame_size;
+  uint32_t max_fft_size;
+  uint32_t frame_size;
+  uint32_t fft_size;
+
+  float ema_alpha;
+  float threshold;
+  bool  detect_frame_type;
+
+  srsran_frame_type_t frame_type;
+
+  cf_t*  corr;
+  float* corr_abs;
+  float* corr_avg[SRSRAN_NOF_NID_2]; ///< Averaged correlation of every N_id_2
+} srsran_pss_sss_batch_t;
+
+/**
+ * @brief Initialises the detector for windows up to max_frame_size samples and FFT sizes up to max_fft_size
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_pss_sss_batch_init(srsran_pss_sss_batch_t* q, uint32_t max_frame_size, uint32_t max_fft_size);
+
+/**
+ * @brief Changes the window length and FFT size, the averaged correlations are reset
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_pss_sss_batch_resize(srsran_pss_sss_batch_t* q, uint32_t frame_size, uint32_t fft_size);
+
+SRSRAN_API void srsran_pss_sss_batch_free(srsran_pss_sss_batch_t* q);
+
+/**
+ * @brief Clears the averaged PSS correlations of every N_id_2
+ */
+SRSRAN_API void srsran_pss_sss_batch_reset(srsran_pss_sss_batch_t* q);
+
+/**
+ * @brief Sets the weight of the current window in the exponential moving average of the PSS correlation
+ */
+SRSRAN_API void srsran_pss_sss_batch_set_ema_alpha(srsran_pss_sss_batch_t* q, float alpha);
+
+/**
+ * @brief Sets the PSS peak to side-lobe ratio threshold. A threshold of 0 considers every peak found
+ */
+SRSRAN_API void srsran_pss_sss_batch_set_threshold(srsran_pss_sss_batch_t* q, float threshold);
+
+/**
+ * @brief Sets the SSS correlation threshold, see srsran_sss_set_threshold()
+ */
+SRSRAN_API void srsran_pss_sss_batch_set_sss_threshold(srsran_pss_sss_batch_t* q, float threshold);
+
+/**
+ * @brief Fixes the frame type used to locate the SSS. By default, both FDD and TDD positions are tried
+ */
+SRSRAN_API void srsran_pss_sss_batch_set_frame_type(srsran_pss_sss_batch_t* q, srsran_frame_type_t frame_type);
+
+/**
+ * @brief Searches the three PSS roots in the window of frame_size samples starting at input[find_offset], and the SSS
+ * of every PSS found. The SSS is looked for before the PSS, so it is only detected if the peak is at least two
+ * extended CP symbols after the start of input.
+ *
+ * @param q Object
+ * @param input Baseband samples
+ * @param find_offset Start of the window in input
+ * @param res Provides the result for every N_id_2
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_pss_sss_batch_run(srsran_pss_sss_batch_t*    q,
+                                        const cf_t*                input,
+                                        uint32_t                   find_offset,
+                                        srsran_pss_sss_batch_res_t res[SRSRAN_NOF_NID_2]);
+
+#endif // SRSRAN_PSS_SSS_BATCH_H
@@ -48,6 +48,11 @@
  */
 #define SRSRAN_SSB_NOF_CANDIDATES 64
 
+/**
+ * @brief Maximum number of PSS correlation peaks that srsran_ssb_search_all() tries to decode
+ */
+#define SRSRAN_SSB_SEARCH_MAX_CANDIDATES 16
+
 /**
  * @brief Describes SSB object initialization arguments
  */
@@ -163,6 +168,23 @@ SRSRAN_API int srsran_ssb_set_cfg(srsran_ssb_t* q, const srsran_ssb_cfg_t* cfg);
  */
 SRSRAN_API int srsran_ssb_search(srsran_ssb_t* q, const cf_t* in, uint32_t nof_samples, srsran_ssb_search_res_t* res);
 
+/**
+ * @brief Searches for all the SSB transmissions in the given signal, which can belong to different cells and beams.
+ * Every correlation window is transformed once and correlated with the three PSS sequences. The strongest PSS peaks
+ * are kept, up to SRSRAN_SSB_SEARCH_MAX_CANDIDATES, and the PBCH of each of them is decoded.
+ * @param q SSB object
+ * @param in Baseband time domain signal
+ * @param nof_samples Number of samples available in the buffer
+ * @param res Provides the decoded SSB, strongest PSS correlation first. Each N_id and SSB index appears once
+ * @param max_nof_res Maximum number of results
+ * @return The number of decoded SSB if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_ssb_search_all(srsran_ssb_t*           q,
+                                     const cf_t*             in,
+                                     uint32_t                nof_samples,
+                                     srsran_ssb_search_res_t res[],
+                                     uint32_t                max_nof_res);
+
 /**
  * @brief Decides if the SSB object is configured and a given subframe is configured for SSB transmission
  * @param q SSB object
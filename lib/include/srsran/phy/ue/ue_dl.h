@@ -172,6 +172,21 @@ SRSRAN_API void srsran_ue_dl_set_mi_manual(srsran_ue_dl_t* q, uint32_t mi_idx);
 
 SRSRAN_API void srsran_ue_dl_set_mi_auto(srsran_ue_dl_t* q);
 
+/**
+ * @brief Sets the CFO that the OFDM demodulators correct while loading each symbol, see srsran_ofdm_rx_set_cfo()
+ * @param q UE DL object
+ * @param cfo CFO normalised by the subcarrier spacing, set to 0 if the input buffers are already corrected
+ * @param phase Phase of the correction for the first sample of the subframe
+ */
+SRSRAN_API void srsran_ue_dl_set_cfo(srsran_ue_dl_t* q, float cfo, float phase);
+
+/**
+ * @brief Sets the time offset that the OFDM demodulators correct after the DFT, see srsran_ofdm_rx_set_time_offset()
+ * @param q UE DL object
+ * @param time_offset Delay of the subframe in samples, as given by srsran_ue_sync_get_sf_time_offset()
+ */
+SRSRAN_API void srsran_ue_dl_set_time_offset(srsran_ue_dl_t* q, float time_offset);
+
 /* Perform signal demodulation and channel estimation and store signals in the object */
 SRSRAN_API int srsran_ue_dl_decode_fft_estimate(srsran_ue_dl_t* q, srsran_dl_sf_cfg_t* sf, srsran_ue_dl_cfg_t* cfg);
 
@@ -132,6 +132,11 @@ typedef struct SRSRAN_API {
   float cfo_ref_min;
   float cfo_ref_max;
 
+  bool  cfo_correct_deferred; ///< Leave non-tracking subframes uncorrected for the OFDM demodulator
+  float cfo_phase;            ///< Phase of the CFO correction at the beginning of the next frame
+  float cfo_sf_value;         ///< CFO left in the last subframe, normalised by the subcarrier spacing
+  float cfo_sf_phase;         ///< Phase of the correction pending for the first sample of the last subframe
+
   uint32_t pss_stable_cnt;
   uint32_t pss_stable_timeout;
   bool     pss_is_stable;
@@ -140,6 +145,7 @@ typedef struct SRSRAN_API {
   int next_rf_sample_offset;
   int last_sample_offset; 
   float mean_sample_offset; 
+  float sf_time_offset; ///< Timing drift in samples left after the integer sample adjustments
   uint32_t sample_offset_correct_period;
   float sfo_ema; 
   
@@ -239,6 +245,22 @@ SRSRAN_API void srsran_ue_sync_set_cfo_ref(srsran_ue_sync_t* q, float res_cfo);
 
 SRSRAN_API void srsran_ue_sync_set_cfo_i_enable(srsran_ue_sync_t* q, bool enable);
 
+/**
+ * @brief Defers the CFO correction of the subframes that are not used for PSS tracking to the OFDM demodulator. The
+ * caller must then read the pending correction with srsran_ue_sync_get_sf_cfo() and pass it to the demodulator
+ * @param q UE sync object
+ * @param enable Enables the deferred correction if true, otherwise every subframe is corrected in place
+ */
+SRSRAN_API void srsran_ue_sync_set_cfo_correct_deferred(srsran_ue_sync_t* q, bool enable);
+
+/**
+ * @brief Gets the CFO correction pending for the last received subframe
+ * @param q UE sync object
+ * @param cfo CFO normalised by the subcarrier spacing, 0 if the subframe was already corrected
+ * @param phase Phase of the correction for the first sample of the subframe
+ */
+SRSRAN_API void srsran_ue_sync_get_sf_cfo(srsran_ue_sync_t* q, float* cfo, float* phase);
+
 SRSRAN_API void srsran_ue_sync_set_N_id_2(srsran_ue_sync_t* q, uint32_t N_id_2);
 
 SRSRAN_API uint32_t srsran_ue_sync_get_sfn(srsran_ue_sync_t* q);
@@ -253,6 +275,14 @@ SRSRAN_API float srsran_ue_sync_get_sfo(srsran_ue_sync_t* q);
 
 SRSRAN_API int srsran_ue_sync_get_last_sample_offset(srsran_ue_sync_t* q);
 
+/**
+ * @brief Gets the timing drift of the last received subframe that the integer sample adjustments leave uncorrected, it
+ * is meant to be corrected by the OFDM demodulator, see srsran_ofdm_rx_set_time_offset()
+ * @param q UE sync object
+ * @return Delay of the subframe with respect to the expected timing in samples
+ */
+SRSRAN_API float srsran_ue_sync_get_sf_time_offset(srsran_ue_sync_t* q);
+
 SRSRAN_API void srsran_ue_sync_set_sfo_correct_period(srsran_ue_sync_t* q, uint32_t nof_subframes);
 
 SRSRAN_API void srsran_ue_sync_set_sfo_ema(srsran_ue_sync_t* q, float ema_coefficient);
@@ -369,6 +369,16 @@ SRSRAN_API cf_t srsran_vec_gen_sine(cf_t amplitude, float freq, cf_t* z, int len
 
 SRSRAN_API void srsran_vec_apply_cfo(const cf_t* x, float cfo, cf_t* z, int len);
 
+/*!
+ * @brief Applies a frequency offset starting from a given phase, z[n] = x[n] * exp(j * (phase + 2 * pi * cfo * n))
+ * @param[in]  x     Input vector
+ * @param[in]  cfo   Frequency offset, normalised by the sampling rate
+ * @param[in]  phase Phase of the first sample in radians
+ * @param[out] z     Output vector, it can be the same as the input
+ * @param[in]  len   Length of the vectors
+ */
+SRSRAN_API void srsran_vec_apply_cfo_phase(const cf_t* x, float cfo, float phase, cf_t* z, int len);
+
 SRSRAN_API float srsran_vec_estimate_frequency(const cf_t* x, int len);
 
 /*!
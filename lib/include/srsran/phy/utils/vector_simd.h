@@ -92,6 +92,8 @@ SRSRAN_API void srsran_vec_prod_ccc_simd(const cf_t* x, const cf_t* y, cf_t* z,
 
 SRSRAN_API void srsran_vec_prod_conj_ccc_simd(const cf_t* x, const cf_t* y, cf_t* z, const int len);
 
+SRSRAN_API void srsran_vec_conj_cc_simd(const cf_t* x, cf_t* y, const int len);
+
 /* SIMD Division */
 SRSRAN_API void srsran_vec_div_ccc_simd(const cf_t* x, const cf_t* y, cf_t* z, const int len);
 
@@ -104,6 +106,10 @@ SRSRAN_API cf_t srsran_vec_dot_prod_conj_ccc_simd(const cf_t* x, const cf_t* y,
 
 SRSRAN_API cf_t srsran_vec_dot_prod_ccc_simd(const cf_t* x, const cf_t* y, const int len);
 
+SRSRAN_API cf_t srsran_vec_dot_prod_cfc_simd(const cf_t* x, const float* y, const int len);
+
+SRSRAN_API float srsran_vec_dot_prod_fff_simd(const float* x, const float* y, const int len);
+
 #ifdef ENABLE_C16
 SRSRAN_API c16_t srsran_vec_dot_prod_ccc_c16i_simd(const c16_t* x, const c16_t* y, const int len);
 #endif /* ENABLE_C16 */
@@ -136,6 +142,8 @@ SRSRAN_API cf_t srsran_vec_gen_sine_simd(cf_t amplitude, float freq, cf_t* z, in
 
 SRSRAN_API void srsran_vec_apply_cfo_simd(const cf_t* x, float cfo, cf_t* z, int len);
 
+SRSRAN_API void srsran_vec_apply_cfo_phase_simd(const cf_t* x, float cfo, float initial_phase, cf_t* z, int len);
+
 SRSRAN_API float srsran_vec_estimate_frequency_simd(const cf_t* x, int len);
 
 /* SIMD Find Max functions */
@@ -0,0 +1,193 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file radio_swarm.h
+ * @brief Radio shared by several UE instances running in the same process
+ */
+
+#ifndef SRSRAN_RADIO_SWARM_H
+#define SRSRAN_RADIO_SWARM_H
+
+#include "srsran/common/threads.h"
+#include "srsran/radio/radio.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace srsran {
+
+/**
+ * Shares one radio between several PHY instances. Each PHY sees its own radio through a port.
+ *
+ * A receive thread reads the radio in blocks of 1 ms at the fixed RF sampling rate and hands every block to all the
+ * ports without copying it. Each port takes samples from its queue at its own pace and decimates them to the sampling
+ * rate its PHY asked for. A port whose queue grows beyond max_rx_queue_ms loses the oldest blocks and its PHY is
+ * notified of an overflow.
+ *
+ * In the transmit direction, every port interpolates its samples to the fixed rate and adds them to a common mixing
+ * buffer indexed by the transmission timestamp. The mixed signal is sent to the radio once every port that is actively
+ * transmitting has provided its samples, or when the slowest of them falls more than max_tx_lag_ms behind the others.
+ * A port ending its burst stops being waited for, and the radio burst ends once every port has ended its own.
+ *
+ * All the ports share the radio frequencies, gains and fixed sampling rate, so the UE instances are expected to camp
+ * on the same carrier. Only the sample stream is shared: every PHY keeps its own synchronisation and OFDM demodulation,
+ * since each UE tracks its own timing, CFO and timing advance.
+ */
+class radio_swarm final : public phy_interface_radio, public srsran::thread
+{
+  /// Block of received samples at the fixed sampling rate, shared by all the ports
+  struct rx_block_t {
+    uint64_t                                           idx         = 0; ///< Index of the first sample
+    uint32_t                                           nof_samples = 0;
+    std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS> samples;
+  };
+
+public:
+  class port;
+
+  radio_swarm();
+  ~radio_swarm() final;
+
+  /// Shares the given radio instead of creating one, R shall implement both radio_base and radio_interface_phy
+  template <class R>
+  explicit radio_swarm(std::unique_ptr<R> rf_) : thread("RADIO_SWARM")
+  {
+    rf      = rf_.get();
+    rf_base = std::move(rf_);
+  }
+
+  /**
+   * Initialises the underlying radio and starts the receive thread. The RF sampling rate must be fixed.
+   * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+   */
+  int  init(const rf_args_t& args_);
+  void stop();
+
+  /// Creates a radio for one PHY instance, it shall be destroyed before the swarm
+  std::unique_ptr<port> create_port();
+
+  // phy_interface_radio, forwards the events of the shared radio to every PHY
+  void radio_overflow() override;
+  void radio_failure() override;
+
+  /// Radio interface seen by each PHY instance
+  class port final : public radio_interface_phy, public radio_base
+  {
+  public:
+    port(radio_swarm& parent_, uint32_t id_);
+    ~port() final;
+
+    // radio_base
+    std::string get_type() override { return "swarm"; }
+    int         init(const rf_args_t& args_, phy_interface_radio* phy_) override;
+    void        stop() override;
+    bool        get_metrics(rf_metrics_t* metrics) override;
+
+    // radio_interface_phy
+    void              tx_end() override;
+    bool              tx(rf_buffer_interface& buffer, const rf_timestamp_interface& tx_time) override;
+    bool              rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time) override;
+    void              set_tx_freq(const uint32_t& carrier_idx, const double& freq) override;
+    void              set_rx_freq(const uint32_t& carrier_idx, const double& freq) override;
+    void              release_freq(const uint32_t& carrier_idx) override;
+    void              set_tx_gain(const float& gain) override;
+    void              set_rx_gain_th(const float& gain) override;
+    void              set_rx_gain(const float& gain) override;
+    void              set_tx_srate(const double& srate) override;
+    void              set_rx_srate(const double& srate) override;
+    void              set_channel_rx_offset(uint32_t ch, int32_t offset_samples) override;
+    double            get_freq_offset() override;
+    float             get_rx_gain() override;
+    bool              is_continuous_tx() override;
+    bool              get_is_start_of_burst() override;
+    bool              is_init() override;
+    void              reset() override;
+    srsran_rf_info_t* get_info() override;
+
+  private:
+    friend class radio_swarm;
+
+    radio_swarm&          parent;
+    srslog::basic_logger& logger;
+    phy_interface_radio*  phy           = nullptr;
+    std::atomic<bool>     running       = {false};
+    bool                  continuous_tx = false;
+
+    // Receive side, filled by the swarm receive thread
+    std::mutex                              rx_mutex;
+    std::condition_variable                 rx_cvar;
+    std::deque<std::shared_ptr<rx_block_t>> rx_queue;
+    uint32_t                                rx_read_offset = 0; ///< Samples already consumed from the front block
+    std::atomic<uint32_t>                   rx_ratio       = {1};
+
+    // Transmit side, protected by the swarm tx_mutex except is_start_of_burst
+    uint64_t          tx_end_idx        = 0; ///< Fixed rate index following the last transmitted sample, 0 if idle
+    uint32_t          tx_ratio          = 1;
+    std::atomic<bool> is_start_of_burst = {true};
+
+    std::array<srsran_resampler_fft_t, SRSRAN_MAX_CHANNELS> interpolators = {};
+    std::array<srsran_resampler_fft_t, SRSRAN_MAX_CHANNELS> decimators    = {};
+    std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS>      tx_buffer;
+    std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS>      rx_buffer;
+  };
+
+private:
+  void run_thread() override;
+  void add_port(port* p);
+  void remove_port(port* p);
+  bool mix_nolock(port* p, cf_t* const ptr[SRSRAN_MAX_CHANNELS], uint32_t nof_samples, uint64_t idx);
+  bool end_burst(port* p);
+  bool flush_active_nolock();
+  bool flush_nolock(uint64_t end_idx);
+
+  std::unique_ptr<radio_base> rf_base;
+  radio_interface_phy*        rf           = nullptr;
+  rf_args_t                   args         = {};
+  srslog::basic_logger&       logger       = srslog::fetch_basic_logger("RF", false);
+  double                      srate_hz     = 0.0;
+  uint32_t                    nof_channels = 0;
+  uint32_t                    block_len    = 0; ///< Number of samples of 1 ms at the fixed sampling rate
+  std::atomic<bool>           running      = {false};
+
+  std::mutex         ports_mutex;
+  std::vector<port*> ports;
+  uint32_t           nof_created_ports = 0;
+
+  std::vector<std::shared_ptr<rx_block_t>> rx_block_pool;
+
+  std::mutex                                         tx_mutex;
+  std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS> mix_buffer;
+  uint64_t                                           mix_start_idx = 0; ///< Index of the first sample not yet sent
+  uint64_t                                           mix_end_idx   = 0; ///< Index after the latest mixed sample
+
+  constexpr static uint32_t max_rx_queue_ms = 20;
+  constexpr static uint32_t max_tx_lag_ms   = 2;
+  constexpr static uint32_t mix_buffer_ms   = 10;
+  constexpr static uint32_t max_resamp_ms   = 5; ///< Maximum buffer size in ms for the port resampling buffers
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_RADIO_SWARM_H
@@ -24,6 +24,7 @@
 
 #include "srsran/srslog/detail/log_entry_metadata.h"
 #include "srsran/srslog/detail/support/thread_utils.h"
+#include "srsran/srslog/detail/support/work_queue.h"
 
 namespace srslog {
 
@@ -48,6 +49,15 @@ struct log_entry {
   std::unique_ptr<flush_backend_cmd>                                             flush_cmd;
 };
 
+/// Log entries generated by different threads are merged in the backend following their timestamp.
+template <>
+struct work_queue_traits<log_entry> {
+  static uint64_t order_key(const log_entry& entry)
+  {
+    return static_cast<uint64_t>(entry.metadata.tp.time_since_epoch().count());
+  }
+};
+
 } // namespace detail
 
 } // namespace srslog
@@ -0,0 +1,260 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_DETAIL_SUPPORT_RATE_LIMITER_H
+#define SRSLOG_DETAIL_SUPPORT_RATE_LIMITER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace srslog {
+
+/// Rate limiting and sampling policy of a log channel.
+struct rate_limit_config {
+  /// Maximum sustained number of entries per second. Zero disables the token
+  /// bucket.
+  uint32_t max_rate = 0;
+  /// Number of entries that can be logged back to back before max_rate kicks
+  /// in.
+  uint32_t burst = 1;
+  /// Only one out of every sample_period entries is logged. Values below two
+  /// disable sampling.
+  uint32_t sample_period = 0;
+  /// When set to true, entries logged with a rate_key are limited
+  /// independently for each key value (e.g. one bucket per RNTI).
+  bool per_key = false;
+  /// Minimum time between two summaries of the suppressed entries.
+  uint32_t summary_period_ms = 1000;
+
+  /// Returns true when the policy suppresses any entry.
+  bool is_enabled() const { return max_rate > 0 || sample_period > 1; }
+};
+
+/// Identifies the source of a log entry for per key rate limiting, typically
+/// an RNTI or a TEID.
+struct rate_key {
+  explicit rate_key(uint32_t value) : value(value) {}
+  uint32_t value;
+};
+
+namespace detail {
+
+/// Outcome of a rate limiter check.
+struct rate_limit_result {
+  /// True when the entry should be logged.
+  bool allowed;
+  /// When non zero, a summary with this number of suppressed entries should be
+  /// emitted.
+  uint64_t nof_suppressed;
+  /// Time window covered by the summary.
+  uint64_t summary_window_ms;
+};
+
+/// Lock free implementation of a rate_limit_config policy.
+///
+/// The token bucket is implemented as a GCRA (generic cell rate algorithm) so
+/// that its state fits in a single atomic theoretical arrival time. Per key
+/// state lives in a fixed size open addressing table. When the probe window of
+/// a new key is full, the least recently hit slot is reused provided it has
+/// been idle for longer than the burst tolerance, so that its state is
+/// equivalent to a fresh one. Otherwise the key shares the channel wide state.
+/// NOTE: Thread safe class.
+class rate_limiter
+{
+  static constexpr uint32_t table_size  = 1024; // Must match the shift in find_state.
+  static constexpr uint32_t max_probing = 8;
+  static constexpr uint64_t empty_tag   = 0;
+
+  struct bucket_state {
+    std::atomic<uint64_t> tat{0};
+    std::atomic<uint64_t> counter{0};
+  };
+
+  struct key_slot {
+    std::atomic<uint64_t> tag{empty_tag};
+    std::atomic<uint64_t> last_hit_ns{0};
+    bucket_state          state;
+  };
+
+public:
+  explicit rate_limiter(const rate_limit_config& cfg) :
+    cfg(cfg),
+    interval_ns(cfg.max_rate ? 1000000000ULL / cfg.max_rate : 0),
+    tolerance_ns(interval_ns * (cfg.burst ? cfg.burst : 1)),
+    summary_period_ns(uint64_t(cfg.summary_period_ms) * 1000000ULL),
+    evict_age_ns(interval_ns ? tolerance_ns : summary_period_ns),
+    last_summary_ns(now_ns())
+  {
+    if (cfg.per_key) {
+      slots.reset(new std::array<key_slot, table_size>);
+    }
+  }
+
+  rate_limiter(const rate_limiter& other) = delete;
+  rate_limiter& operator=(const rate_limiter& other) = delete;
+
+  /// Returns the configuration of this limiter.
+  const rate_limit_config& config() const { return cfg; }
+
+  /// Checks an entry against the channel wide state.
+  rate_limit_result check() { return check(global, 0); }
+
+  /// Checks an entry against the state of the specified key.
+  rate_limit_result check(rate_key key)
+  {
+    if (!slots) {
+      return check(global, 0);
+    }
+    uint64_t now = now_ns();
+    return check(find_state(key.value, now), now);
+  }
+
+  /// Returns the number of entries suppressed since the last summary.
+  uint64_t get_nof_suppressed() const { return nof_suppressed.load(std::memory_order_relaxed); }
+
+private:
+  static uint64_t now_ns()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /// A zero value of now means that the clock has not been read yet.
+  rate_limit_result check(bucket_state& state, uint64_t now)
+  {
+    // Sampling only needs a counter, so suppressed entries of the channel wide
+    // state do not even read the clock.
+    if (cfg.sample_period > 1 &&
+        state.counter.fetch_add(1, std::memory_order_relaxed) % cfg.sample_period != 0) {
+      nof_suppressed.fetch_add(1, std::memory_order_relaxed);
+      return {false, 0, 0};
+    }
+
+    if (!now) {
+      now = now_ns();
+    }
+    bool allowed = !interval_ns || consume_token(state, now);
+    if (!allowed) {
+      nof_suppressed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    rate_limit_result result = {allowed, 0, 0};
+    poll_summary(now, result);
+    return result;
+  }
+
+  /// GCRA check: the entry conforms when the theoretical arrival time does not
+  /// run ahead of the current time by more than the burst tolerance.
+  bool consume_token(bucket_state& state, uint64_t now)
+  {
+    uint64_t tat = state.tat.load(std::memory_order_relaxed);
+    while (true) {
+      uint64_t new_tat = std::max(tat, now) + interval_ns;
+      if (new_tat - now > tolerance_ns) {
+        return false;
+      }
+      if (state.tat.compare_exchange_weak(tat, new_tat, std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+  }
+
+  /// Elects a single thread to report the suppressed entries once per summary
+  /// period.
+  void poll_summary(uint64_t now, rate_limit_result& result)
+  {
+    uint64_t last = last_summary_ns.load(std::memory_order_relaxed);
+    if (now < last + summary_period_ns || nof_suppressed.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    if (!last_summary_ns.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+      return;
+    }
+    result.nof_suppressed    = nof_suppressed.exchange(0, std::memory_order_relaxed);
+    result.summary_window_ms = (now - last) / 1000000ULL;
+  }
+
+  bucket_state& find_state(uint32_t key, uint64_t now)
+  {
+    // Tags are offset by one so that zero marks an empty slot.
+    uint64_t tag = uint64_t(key) + 1;
+    // Fibonacci hashing, keeping the top bits of the product.
+    uint32_t  idx    = (key * 2654435761U) >> 22;
+    key_slot* victim = nullptr;
+    uint64_t  oldest = now;
+    for (uint32_t i = 0; i != max_probing; ++i) {
+      key_slot& slot    = (*slots)[(idx + i) % table_size];
+      uint64_t  current = slot.tag.load(std::memory_order_relaxed);
+      if (current == tag) {
+        slot.last_hit_ns.store(now, std::memory_order_relaxed);
+        return slot.state;
+      }
+      if (current == empty_tag) {
+        if (slot.tag.compare_exchange_strong(current, tag, std::memory_order_relaxed) || current == tag) {
+          slot.last_hit_ns.store(now, std::memory_order_relaxed);
+          return slot.state;
+        }
+      }
+      uint64_t last_hit = slot.last_hit_ns.load(std::memory_order_relaxed);
+      if (last_hit < oldest) {
+        oldest = last_hit;
+        victim = &slot;
+      }
+    }
+
+    if (victim == nullptr || now - oldest <= evict_age_ns) {
+      return global;
+    }
+
+    // Only the thread that swaps the tag resets the state of the evicted key.
+    uint64_t victim_tag = victim->tag.load(std::memory_order_relaxed);
+    if (victim->last_hit_ns.load(std::memory_order_relaxed) != oldest ||
+        !victim->tag.compare_exchange_strong(victim_tag, tag, std::memory_order_relaxed)) {
+      return global;
+    }
+    victim->state.tat.store(0, std::memory_order_relaxed);
+    victim->state.counter.store(0, std::memory_order_relaxed);
+    victim->last_hit_ns.store(now, std::memory_order_relaxed);
+    return victim->state;
+  }
+
+private:
+  const rate_limit_config                            cfg;
+  const uint64_t                                     interval_ns;
+  const uint64_t                                     tolerance_ns;
+  const uint64_t                                     summary_period_ns;
+  const uint64_t                                     evict_age_ns;
+  bucket_state                                       global;
+  std::unique_ptr<std::array<key_slot, table_size> > slots;
+  std::atomic<uint64_t>                              nof_suppressed{0};
+  std::atomic<uint64_t>                              last_summary_ns;
+};
+
+} // namespace detail
+
+} // namespace srslog
+
+#endif // SRSLOG_DETAIL_SUPPORT_RATE_LIMITER_H
@@ -22,6 +22,7 @@
 #ifndef SRSLOG_DETAIL_SUPPORT_THREAD_UTILS_H
 #define SRSLOG_DETAIL_SUPPORT_THREAD_UTILS_H
 
+#include <cerrno>
 #include <pthread.h>
 
 namespace srslog {
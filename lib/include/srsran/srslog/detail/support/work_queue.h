@@ -22,92 +22,360 @@
 #ifndef SRSLOG_DETAIL_SUPPORT_WORK_QUEUE_H
 #define SRSLOG_DETAIL_SUPPORT_WORK_QUEUE_H
 
-#include "srsran/adt/circular_buffer.h"
 #include "srsran/srslog/detail/support/backend_capacity.h"
 #include "srsran/srslog/detail/support/thread_utils.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
 
 namespace srslog {
 
 namespace detail {
 
-//: TODO: this is a temp work queue.
+/// Customization point used by the work_queue to merge the entries coming from different producers. Entries with a
+/// lower key are popped first. Types without a specialization are popped in producer order.
+template <typename T>
+struct work_queue_traits {
+  static uint64_t order_key(const T& value) { return 0; }
+};
 
-/// Thread safe generic data type work queue.
-template <typename T, size_t capacity = SRSLOG_QUEUE_CAPACITY>
+/// Thread safe generic data type work queue, supporting multiple producers and a single consumer.
+/// Each producer thread is given its own lock-free SPSC queue on its first push, so producers never contend with each
+/// other nor with the consumer for every entry. The consumer merges the producer queues popping the front element with
+/// the lowest order key (see work_queue_traits). Queues of terminated threads are reused by new producers. When more
+/// than max_producers threads push concurrently, the extra threads share a mutex protected overflow queue.
+/// Producer queues are chains of fixed size blocks taken from a pool shared by all producers, which holds capacity
+/// elements plus one block for each other producer, as idle producers keep their last block. This way a single
+/// producer may use the whole capacity. The pool is only locked once every block_size elements.
+template <typename T, size_t capacity = SRSLOG_QUEUE_CAPACITY, size_t max_producers = 64>
 class work_queue
 {
-  srsran::dyn_circular_buffer<T> queue;
-  mutable mutex                  m;
-  static constexpr size_t        threshold = capacity * 0.98;
+  static constexpr size_t block_size          = (capacity < 32) ? capacity : 32;
+  static constexpr size_t nof_capacity_blocks = (capacity + block_size - 1) / block_size;
+  static constexpr size_t threshold           = capacity * 0.98;
+  // Number of queues a thread can push into without registering again.
+  static constexpr size_t nof_cached_queues = 4;
+
+  /// Chunk of a producer queue. A block whose next pointer points to itself has been drained by the consumer and handed
+  /// back to its producer.
+  struct block {
+    T                   elems[block_size];
+    std::atomic<size_t> nof_committed{0};
+    std::atomic<block*> next{nullptr};
+  };
+
+  /// Queue assigned to one producer thread.
+  struct producer_slot {
+    /// The fields written by the producer and by the consumer are kept in different cache lines. Plain new does not
+    /// honour this alignment before C++17.
+    static void* operator new(size_t size)
+    {
+      void* ptr = nullptr;
+      if (::posix_memalign(&ptr, alignof(producer_slot), size) != 0) {
+        throw std::bad_alloc();
+      }
+      return ptr;
+    }
+    static void operator delete(void* ptr) { ::free(ptr); }
+
+    // Consumer side.
+    alignas(64) std::atomic<block*> head{nullptr};
+    size_t                          head_idx = 0;
+    // Producer side.
+    alignas(64) block*    tail     = nullptr;
+    size_t                tail_idx = 0;
+    std::atomic<bool>     owned{true};
+    std::atomic<uint64_t> nof_dropped{0};
+  };
+
+  /// Per thread cache of a slot assigned to the calling thread. Releases the slot when the thread terminates.
+  struct producer_handle {
+    ~producer_handle() { release(); }
+    void release()
+    {
+      if (slot) {
+        slot->owned.store(false, std::memory_order_release);
+        slot.reset();
+      }
+    }
+    uint64_t                       queue_id = 0;
+    std::shared_ptr<producer_slot> slot;
+  };
+
+  /// Slots of the queues the calling thread has last pushed into.
+  struct producer_cache {
+    producer_handle handles[nof_cached_queues];
+    size_t          next_victim = 0;
+  };
 
 public:
-  work_queue() : queue(capacity) {}
+  work_queue() : id(next_queue_id()), overflow(new producer_slot)
+  {
+    block_storage.reserve(nof_capacity_blocks + max_producers);
+    free_blocks.reserve(nof_capacity_blocks + max_producers);
+  }
 
   work_queue(const work_queue&) = delete;
   work_queue& operator=(const work_queue&) = delete;
 
-  /// Inserts a new element into the back of the queue. Returns false when the
-  /// queue is full, otherwise true.
-  bool push(const T& value)
+  /// Inserts a new element into the back of the queue of the calling thread. Returns false when the queue is full,
+  /// otherwise true.
+  bool push(const T& value) { return push_impl(value); }
+
+  /// Inserts a new element into the back of the queue of the calling thread. Returns false when the queue is full,
+  /// otherwise true.
+  bool push(T&& value) { return push_impl(std::move(value)); }
+
+  /// Extracts the element with the lowest order key among the fronts of all producer queues, if it exists.
+  /// Returns a pair with a bool indicating if the pop has been successful.
+  /// NOTE: Only one thread may call this method.
+  std::pair<bool, T> try_pop()
   {
-    m.lock();
-    // Discard the new element if we reach the maximum capacity.
-    if (queue.full()) {
-      m.unlock();
-      return false;
+    producer_slot* selected = nullptr;
+    T*             item     = nullptr;
+    uint64_t       best_key = 0;
+
+    size_t n = nof_slots.load(std::memory_order_acquire);
+    for (size_t i = 0; i != n + 1; ++i) {
+      // Rotate the starting point so that producers with equal keys are served fairly.
+      size_t         idx  = (i + pop_start) % (n + 1);
+      producer_slot* slot = (idx == n) ? overflow.get() : slots[idx].load(std::memory_order_relaxed);
+      T*             elem = front(*slot);
+      if (!elem) {
+        continue;
+      }
+      uint64_t key = work_queue_traits<T>::order_key(*elem);
+      if (!selected || key < best_key) {
+        selected = slot;
+        item     = elem;
+        best_key = key;
+      }
     }
-    queue.push(value);
-    m.unlock();
+    pop_start = (pop_start + 1) % (n + 1);
 
-    return true;
+    if (!selected) {
+      return {false, T()};
+    }
+
+    T value = std::move(*item);
+    ++selected->head_idx;
+    return {true, std::move(value)};
   }
 
-  /// Inserts a new element into the back of the queue. Returns false when the
-  /// queue is full, otherwise true.
-  bool push(T&& value)
+  /// Capacity of the queue, shared by all the producers.
+  size_t get_capacity() const { return capacity; }
+
+  /// Returns true when the queue is almost full, otherwise returns false.
+  bool is_almost_full() const
   {
-    m.lock();
-    // Discard the new element if we reach the maximum capacity.
-    if (queue.full()) {
-      m.unlock();
-      return false;
+    size_t nof_free_blocks = get_max_blocks() - nof_used_blocks.load(std::memory_order_relaxed);
+    return nof_free_blocks * block_size < capacity - threshold;
+  }
+
+  /// Returns the total number of elements that have been discarded because the queue was full.
+  uint64_t get_nof_dropped() const
+  {
+    uint64_t total = overflow->nof_dropped.load(std::memory_order_relaxed);
+    size_t   n     = nof_slots.load(std::memory_order_acquire);
+    for (size_t i = 0; i != n; ++i) {
+      total += slots[i].load(std::memory_order_relaxed)->nof_dropped.load(std::memory_order_relaxed);
     }
-    queue.push(std::move(value));
-    m.unlock();
+    return total;
+  }
 
-    return true;
+  /// Returns the number of producer queues that have been created so far.
+  size_t get_nof_producers() const { return nof_slots.load(std::memory_order_acquire); }
+
+private:
+  static uint64_t next_queue_id()
+  {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
   }
 
-  /// Extracts the top most element from the queue if it exists.
-  /// Returns a pair with a bool indicating if the pop has been successful.
-  std::pair<bool, T> try_pop()
+  /// Number of blocks that can be in use: the capacity, plus the last block kept by each producer but one.
+  size_t get_max_blocks() const
   {
-    m.lock();
+    size_t nof_producers = nof_slots.load(std::memory_order_relaxed) + overflow_used.load(std::memory_order_relaxed);
+    return nof_capacity_blocks + ((nof_producers > 0) ? nof_producers - 1 : 0);
+  }
 
-    if (queue.empty()) {
-      m.unlock();
-      return {false, T()};
+  /// Takes a block from the pool, allocating it on its first use. Returns nullptr when all blocks are in use.
+  block* alloc_block()
+  {
+    scoped_lock lock(pool_mutex);
+    if (nof_used_blocks.load(std::memory_order_relaxed) >= get_max_blocks()) {
+      return nullptr;
+    }
+    block* b = nullptr;
+    if (!free_blocks.empty()) {
+      b = free_blocks.back();
+      free_blocks.pop_back();
+    } else {
+      block_storage.emplace_back(new block);
+      b = block_storage.back().get();
     }
+    b->nof_committed.store(0, std::memory_order_relaxed);
+    b->next.store(nullptr, std::memory_order_relaxed);
+    nof_used_blocks.store(nof_used_blocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return b;
+  }
 
-    // Here we have been woken up normally.
-    T Item = std::move(queue.top());
-    queue.pop();
+  /// Gives a block back to the pool.
+  void free_block(block* b)
+  {
+    scoped_lock lock(pool_mutex);
+    free_blocks.push_back(b);
+    nof_used_blocks.store(nof_used_blocks.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+  }
 
-    m.unlock();
+  /// Appends a new element to the queue of the given slot. Producer side only.
+  template <typename U>
+  bool push_slot(producer_slot& slot, U&& value)
+  {
+    if (!slot.tail || slot.tail_idx == block_size) {
+      if (slot.tail && slot.tail->next.load(std::memory_order_acquire) == slot.tail) {
+        free_block(slot.tail);
+        slot.tail = nullptr;
+      }
+      block* b = alloc_block();
+      if (!b) {
+        return false;
+      }
+      // New blocks are linked to the previous one, unless the consumer has drained it and waits for a new head.
+      block* expected = nullptr;
+      if (!slot.tail) {
+        slot.head.store(b, std::memory_order_release);
+      } else if (!slot.tail->next.compare_exchange_strong(expected, b, std::memory_order_acq_rel)) {
+        free_block(slot.tail);
+        slot.head.store(b, std::memory_order_release);
+      }
+      slot.tail     = b;
+      slot.tail_idx = 0;
+    }
+    slot.tail->elems[slot.tail_idx] = std::forward<U>(value);
+    slot.tail->nof_committed.store(++slot.tail_idx, std::memory_order_release);
+    return true;
+  }
 
-    return {true, std::move(Item)};
+  /// Returns a pointer to the front element of the queue of the given slot, or nullptr when it is empty. Blocks that
+  /// have been fully consumed are given back to the pool, or to the producer while it still points to them. Consumer
+  /// side only.
+  T* front(producer_slot& slot)
+  {
+    block* b = slot.head.load(std::memory_order_acquire);
+    if (!b) {
+      return nullptr;
+    }
+    if (slot.head_idx == block_size) {
+      block* next = b->next.load(std::memory_order_acquire);
+      if (!next) {
+        // Hand the block back, the producer will publish its next block as the new head.
+        slot.head.store(nullptr, std::memory_order_relaxed);
+        slot.head_idx = 0;
+        if (b->next.compare_exchange_strong(next, b, std::memory_order_acq_rel)) {
+          return nullptr;
+        }
+      }
+      free_block(b);
+      slot.head.store(next, std::memory_order_relaxed);
+      slot.head_idx = 0;
+      b             = next;
+    }
+    if (slot.head_idx == b->nof_committed.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &b->elems[slot.head_idx];
   }
 
-  /// Capacity of the queue.
-  size_t get_capacity() const { return capacity; }
+  template <typename U>
+  bool push_impl(U&& value)
+  {
+    producer_slot* slot = get_producer_slot();
 
-  /// Returns true when the queue is almost full, otherwise returns false.
-  bool is_almost_full() const
+    bool pushed;
+    if (slot == overflow.get()) {
+      scoped_lock lock(overflow_mutex);
+      pushed = push_slot(*slot, std::forward<U>(value));
+    } else {
+      pushed = push_slot(*slot, std::forward<U>(value));
+    }
+
+    // Discard the new element if we reach the maximum capacity.
+    if (!pushed) {
+      slot->nof_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    return pushed;
+  }
+
+  /// Returns the slot assigned to the calling thread, registering a new one if needed.
+  producer_slot* get_producer_slot()
   {
-    scoped_lock lock(m);
+    static thread_local producer_cache cache;
+    for (auto& handle : cache.handles) {
+      if (handle.queue_id == id && handle.slot) {
+        return handle.slot.get();
+      }
+    }
+
+    // Make room for this queue giving back the slot of the least recently registered one.
+    producer_handle& handle = cache.handles[cache.next_victim];
+    handle.release();
 
-    return queue.size() > threshold;
+    std::shared_ptr<producer_slot> slot = register_producer();
+    if (!slot) {
+      overflow_used.store(true, std::memory_order_relaxed);
+      return overflow.get();
+    }
+    handle.queue_id   = id;
+    handle.slot       = std::move(slot);
+    cache.next_victim = (cache.next_victim + 1) % nof_cached_queues;
+    return handle.slot.get();
   }
+
+  /// Assigns a free slot to the calling thread, creating it if needed. Returns nullptr when the maximum number of
+  /// producers has been reached.
+  std::shared_ptr<producer_slot> register_producer()
+  {
+    scoped_lock lock(registry_mutex);
+
+    // Try first to reuse the slot of a terminated thread.
+    size_t n = nof_slots.load(std::memory_order_relaxed);
+    for (size_t i = 0; i != n; ++i) {
+      bool expected = false;
+      if (slot_storage[i]->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        return slot_storage[i];
+      }
+    }
+
+    if (n == max_producers) {
+      return nullptr;
+    }
+
+    slot_storage[n] = std::shared_ptr<producer_slot>(new producer_slot);
+    slots[n].store(slot_storage[n].get(), std::memory_order_relaxed);
+    nof_slots.store(n + 1, std::memory_order_release);
+    return slot_storage[n];
+  }
+
+  const uint64_t                 id;
+  std::unique_ptr<producer_slot> overflow;
+  mutex                          overflow_mutex;
+  std::atomic<bool>              overflow_used{false};
+  // Producer registration, written under registry_mutex and read lock-free by the consumer.
+  mutex                          registry_mutex;
+  std::shared_ptr<producer_slot> slot_storage[max_producers];
+  std::atomic<producer_slot*>    slots[max_producers] = {};
+  std::atomic<size_t>            nof_slots{0};
+  size_t                         pop_start = 0;
+  // Block pool shared by all the producers.
+  mutex                               pool_mutex;
+  std::vector<std::unique_ptr<block>> block_storage;
+  std::vector<block*>                 free_blocks;
+  std::atomic<size_t>                 nof_used_blocks{0};
 };
 
 } // namespace detail
@@ -61,6 +61,9 @@ struct metric_value_formatter<metric<Ty, Name, Units> > {
 /// handle specific formatting rules.
 class log_formatter
 {
+  /// The binary log decoder replays the context callbacks stored in binary log files.
+  friend class binary_log_decoder;
+
 public:
   virtual ~log_formatter() = default;
 
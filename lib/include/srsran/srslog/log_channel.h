@@ -24,8 +24,12 @@
 
 #include "srsran/srslog/detail/log_backend.h"
 #include "srsran/srslog/detail/log_entry.h"
+#include "srsran/srslog/detail/support/rate_limiter.h"
+#include "srsran/srslog/detail/support/thread_utils.h"
 #include "srsran/srslog/sink.h"
 #include <atomic>
+#include <memory>
+#include <vector>
 
 namespace srslog {
 
@@ -68,7 +72,8 @@ public:
     should_print_context(config.should_print_context),
     ctx_value(0),
     hex_max_size(0),
-    is_enabled(true)
+    is_enabled(true),
+    active_limiter(nullptr)
   {}
 
   log_channel(const log_channel& other) = delete;
@@ -91,32 +96,89 @@ public:
   /// Set to -1 to indicate no hex dump limit.
   void set_hex_dump_max_size(int size) { hex_max_size = size; }
 
+  /// Installs the rate limiting and sampling policy of the channel, replacing
+  /// any previous one. Pass a default constructed config to disable it.
+  /// Suppressed entries are dropped before capturing their arguments and their
+  /// count is periodically reported through this same channel.
+  void set_rate_limit(const rate_limit_config& cfg)
+  {
+    if (!cfg.is_enabled()) {
+      active_limiter.store(nullptr, std::memory_order_release);
+      return;
+    }
+
+    // Producers may still be using the previous limiter, so limiters are only
+    // released together with the channel.
+    detail::scoped_lock lock(limiter_mutex);
+    limiter_storage.emplace_back(new detail::rate_limiter(cfg));
+    active_limiter.store(limiter_storage.back().get(), std::memory_order_release);
+  }
+
   /// Builds the provided log entry and passes it to the backend. When the
   /// channel is disabled the log entry will be discarded.
   template <typename... Args>
   void operator()(const char* fmtstr, Args&&... args)
   {
-    if (!enabled()) {
+    if (!enabled() || is_rate_limited(nullptr)) {
       return;
     }
+    push_fmt_entry(fmtstr, std::forward<Args>(args)...);
+  }
 
-    // Populate the store with all incoming arguments.
-    auto* store = backend.alloc_arg_store();
-    if (!store) {
+  /// Builds the provided log entry and passes it to the backend. When the
+  /// channel is disabled or the rate limiter rejects the entry for the given
+  /// key, the log entry will be discarded without capturing any argument.
+  template <typename... Args>
+  void operator()(rate_key key, const char* fmtstr, Args&&... args)
+  {
+    if (!enabled() || is_rate_limited(&key)) {
+      return;
+    }
+    push_fmt_entry(fmtstr, std::forward<Args>(args)...);
+  }
+
+  /// Builds the provided log entry and passes it to the backend. When the
+  /// channel is disabled the log entry will be discarded.
+  template <typename... Args>
+  void operator()(const uint8_t* buffer, size_t len, const char* fmtstr, Args&&... args)
+  {
+    if (!enabled() || is_rate_limited(nullptr)) {
+      return;
+    }
+    push_hex_entry(buffer, len, fmtstr, std::forward<Args>(args)...);
+  }
+
+  /// Builds the provided log entry and passes it to the backend. When the
+  /// channel is disabled or the rate limiter rejects the entry for the given
+  /// key, the log entry will be discarded without capturing any argument.
+  template <typename... Args>
+  void operator()(rate_key key, const uint8_t* buffer, size_t len, const char* fmtstr, Args&&... args)
+  {
+    if (!enabled() || is_rate_limited(&key)) {
+      return;
+    }
+    push_hex_entry(buffer, len, fmtstr, std::forward<Args>(args)...);
+  }
+
+  /// Builds the provided log entry and passes it to the backend. When the
+  /// channel is disabled the log entry will be discarded.
+  template <typename... Ts>
+  void operator()(const context<Ts...>& ctx)
+  {
+    if (!enabled() || is_rate_limited(nullptr)) {
       return;
     }
-    (void)std::initializer_list<int>{(store->push_back(std::forward<Args>(args)), 0)...};
 
     // Send the log entry to the backend.
     log_formatter&    formatter = log_sink.get_formatter();
     detail::log_entry entry     = {&log_sink,
-                               [&formatter](detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) {
-                                 formatter.format(std::move(metadata), buffer);
+                               [&formatter, ctx](detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) {
+                                 formatter.format_ctx(ctx, std::move(metadata), buffer);
                                },
                                {std::chrono::high_resolution_clock::now(),
                                 {ctx_value, should_print_context},
-                                fmtstr,
-                                store,
+                                nullptr,
+                                nullptr,
                                 log_name,
                                 log_tag}};
     backend.push(std::move(entry));
@@ -124,10 +186,10 @@ public:
 
   /// Builds the provided log entry and passes it to the backend. When the
   /// channel is disabled the log entry will be discarded.
-  template <typename... Args>
-  void operator()(const uint8_t* buffer, size_t len, const char* fmtstr, Args&&... args)
+  template <typename... Ts, typename... Args>
+  void operator()(const context<Ts...>& ctx, const char* fmtstr, Args&&... args)
   {
-    if (!enabled()) {
+    if (!enabled() || is_rate_limited(nullptr)) {
       return;
     }
 
@@ -138,60 +200,69 @@ public:
     }
     (void)std::initializer_list<int>{(store->push_back(std::forward<Args>(args)), 0)...};
 
-    // Calculate the length to capture in the buffer.
-    if (hex_max_size >= 0) {
-      len = std::min<size_t>(len, hex_max_size);
-    }
-
     // Send the log entry to the backend.
     log_formatter&    formatter = log_sink.get_formatter();
     detail::log_entry entry     = {&log_sink,
-                               [&formatter](detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) {
-                                 formatter.format(std::move(metadata), buffer);
+                               [&formatter, ctx](detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) {
+                                 formatter.format_ctx(ctx, std::move(metadata), buffer);
                                },
                                {std::chrono::high_resolution_clock::now(),
                                 {ctx_value, should_print_context},
                                 fmtstr,
                                 store,
                                 log_name,
-                                log_tag,
-                                std::vector<uint8_t>(buffer, buffer + len)}};
+                                log_tag}};
     backend.push(std::move(entry));
   }
 
-  /// Builds the provided log entry and passes it to the backend. When the
-  /// channel is disabled the log entry will be discarded.
-  template <typename... Ts>
-  void operator()(const context<Ts...>& ctx)
+private:
+  /// Runs the entry through the rate limiter, if any, emitting the periodic
+  /// summary of suppressed entries when it is due. Returns true when the entry
+  /// has to be dropped.
+  bool is_rate_limited(const rate_key* key)
   {
-    if (!enabled()) {
+    detail::rate_limiter* limiter = active_limiter.load(std::memory_order_acquire);
+    if (!limiter) {
+      return false;
+    }
+
+    detail::rate_limit_result result = key ? limiter->check(*key) : limiter->check();
+    if (result.nof_suppressed) {
+      push_fmt_entry("Suppressed %llu log entries in the last %llu ms",
+                     (unsigned long long)result.nof_suppressed,
+                     (unsigned long long)result.summary_window_ms);
+    }
+    return !result.allowed;
+  }
+
+  template <typename... Args>
+  void push_fmt_entry(const char* fmtstr, Args&&... args)
+  {
+    // Populate the store with all incoming arguments.
+    auto* store = backend.alloc_arg_store();
+    if (!store) {
       return;
     }
+    (void)std::initializer_list<int>{(store->push_back(std::forward<Args>(args)), 0)...};
 
     // Send the log entry to the backend.
     log_formatter&    formatter = log_sink.get_formatter();
     detail::log_entry entry     = {&log_sink,
-                               [&formatter, ctx](detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) {
-                                 formatter.format_ctx(ctx, std::move(metadata), buffer);
+                               [&formatter](detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) {
+                                 formatter.format(std::move(metadata), buffer);
                                },
                                {std::chrono::high_resolution_clock::now(),
                                 {ctx_value, should_print_context},
-                                nullptr,
-                                nullptr,
+                                fmtstr,
+                                store,
                                 log_name,
                                 log_tag}};
     backend.push(std::move(entry));
   }
 
-  /// Builds the provided log entry and passes it to the backend. When the
-  /// channel is disabled the log entry will be discarded.
-  template <typename... Ts, typename... Args>
-  void operator()(const context<Ts...>& ctx, const char* fmtstr, Args&&... args)
+  template <typename... Args>
+  void push_hex_entry(const uint8_t* buffer, size_t len, const char* fmtstr, Args&&... args)
   {
-    if (!enabled()) {
-      return;
-    }
-
     // Populate the store with all incoming arguments.
     auto* store = backend.alloc_arg_store();
     if (!store) {
@@ -199,31 +270,40 @@ public:
     }
     (void)std::initializer_list<int>{(store->push_back(std::forward<Args>(args)), 0)...};
 
+    // Calculate the length to capture in the buffer.
+    if (hex_max_size >= 0) {
+      len = std::min<size_t>(len, hex_max_size);
+    }
+
     // Send the log entry to the backend.
     log_formatter&    formatter = log_sink.get_formatter();
     detail::log_entry entry     = {&log_sink,
-                               [&formatter, ctx](detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) {
-                                 formatter.format_ctx(ctx, std::move(metadata), buffer);
+                               [&formatter](detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) {
+                                 formatter.format(std::move(metadata), buffer);
                                },
                                {std::chrono::high_resolution_clock::now(),
                                 {ctx_value, should_print_context},
                                 fmtstr,
                                 store,
                                 log_name,
-                                log_tag}};
+                                log_tag,
+                                std::vector<uint8_t>(buffer, buffer + len)}};
     backend.push(std::move(entry));
   }
 
 private:
-  const std::string     log_id;
-  sink&                 log_sink;
-  detail::log_backend&  backend;
-  const std::string     log_name;
-  const char            log_tag;
-  const bool            should_print_context;
-  std::atomic<uint32_t> ctx_value;
-  std::atomic<int>      hex_max_size;
-  std::atomic<bool>     is_enabled;
+  const std::string                                   log_id;
+  sink&                                               log_sink;
+  detail::log_backend&                                backend;
+  const std::string                                   log_name;
+  const char                                          log_tag;
+  const bool                                          should_print_context;
+  std::atomic<uint32_t>                               ctx_value;
+  std::atomic<int>                                    hex_max_size;
+  std::atomic<bool>                                   is_enabled;
+  std::atomic<detail::rate_limiter*>                  active_limiter;
+  std::vector<std::unique_ptr<detail::rate_limiter> > limiter_storage;
+  detail::mutex                                       limiter_mutex;
 };
 
 } // namespace srslog
@@ -92,6 +92,16 @@ public:
     }
   }
 
+  /// Set the rate limiting and sampling policy to all the channels of the
+  /// logger. Each channel keeps its own independent limiter state.
+  void set_rate_limit(const rate_limit_config& cfg)
+  {
+    detail::scoped_lock lock(m);
+    for (auto channel : channels) {
+      channel->set_rate_limit(cfg);
+    }
+  }
+
 private:
   /// Comparison operator for enum types, used by the set_level method.
   friend bool operator<=(Enum lhs, Enum rhs)
@@ -156,6 +156,10 @@ std::unique_ptr<log_formatter> create_text_formatter();
 /// Creates a new instance of a JSON formatter.
 std::unique_ptr<log_formatter> create_json_formatter();
 
+/// Creates a new instance of a binary formatter. Entries are stored with their
+/// raw arguments and rendered later with the srslog_decoder tool.
+std::unique_ptr<log_formatter> create_binary_formatter();
+
 ///
 /// Sink management functions.
 ///
@@ -195,6 +199,11 @@ sink& fetch_file_sink(const std::string&             path,
                       bool                           force_flush = false,
                       std::unique_ptr<log_formatter> f           = get_default_log_formatter());
 
+/// Returns an instance of a sink that writes log entries in binary form into
+/// a memory mapped file in the specified path. Formatting is deferred to the
+/// srslog_decoder tool, which renders the file into text or JSON.
+sink& fetch_binary_file_sink(const std::string& path);
+
 /// Returns an instance of a sink that writes into syslog
 /// preamble: The string  prepended to every message, If ident is "", the program name is used.
 /// log_local: custom unused facilities that syslog provides which can be used by the user
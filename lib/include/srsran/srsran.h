@@ -137,6 +137,7 @@ extern "C" {
 #include "srsran/phy/sync/cfo.h"
 #include "srsran/phy/sync/cp.h"
 #include "srsran/phy/sync/pss.h"
+#include "srsran/phy/sync/pss_sss_batch.h"
 #include "srsran/phy/sync/refsignal_dl_sync.h"
 #include "srsran/phy/sync/sfo.h"
 #include "srsran/phy/sync/ssb.h"
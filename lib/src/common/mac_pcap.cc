@@ -32,22 +32,30 @@ mac_pcap::~mac_pcap()
 }
 
 uint32_t mac_pcap::open(std::string filename_, uint32_t ue_id_)
+{
+  pcap_writer_args_t writer_args;
+  writer_args.filename = filename_;
+  return open(writer_args, ue_id_);
+}
+
+uint32_t mac_pcap::open(const pcap_writer_args_t& writer_args, uint32_t ue_id_)
 {
   std::lock_guard<std::mutex> lock(mutex);
-  if (pcap_file != nullptr) {
-    logger.error("PCAP writer for %s already running. Close first.", filename_.c_str());
+  if (writer.is_open()) {
+    logger.error("PCAP writer for %s already running. Close first.", writer_args.filename.c_str());
     return SRSRAN_ERROR;
   }
 
   // set UDP DLT
-  dlt       = UDP_DLT;
-  pcap_file = DLT_PCAP_Open(dlt, filename_.c_str());
-  if (pcap_file == nullptr) {
-    logger.error("Couldn't open %s to write PCAP", filename_.c_str());
+  pcap_writer_args_t args = writer_args;
+  dlt                     = UDP_DLT;
+  args.dlt                = dlt;
+  if (writer.open(args) != SRSRAN_SUCCESS) {
+    logger.error("Couldn't open %s to write PCAP", args.filename.c_str());
     return SRSRAN_ERROR;
   }
 
-  filename = filename_;
+  filename = args.filename;
   ue_id    = ue_id_;
   running  = true;
 
@@ -61,7 +69,7 @@ uint32_t mac_pcap::close()
 {
   {
     std::lock_guard<std::mutex> lock(mutex);
-    if (running == false || pcap_file == nullptr) {
+    if (running == false || not writer.is_open()) {
       return SRSRAN_ERROR;
     }
 
@@ -73,12 +81,11 @@ uint32_t mac_pcap::close()
 
   wait_thread_finish();
 
-  // close file handle
+  // flush remaining records and close file handle
   {
     std::lock_guard<std::mutex> lock(mutex);
     srsran::console("Saving MAC PCAP (DLT=%d) to %s\n", dlt, filename.c_str());
-    DLT_PCAP_Close(pcap_file);
-    pcap_file = nullptr;
+    writer.close();
   }
 
   return SRSRAN_SUCCESS;
@@ -87,15 +94,21 @@ uint32_t mac_pcap::close()
 void mac_pcap::write_pdu(srsran::mac_pcap_base::pcap_pdu_t& pdu)
 {
   if (pdu.pdu != nullptr) {
+    uint8_t header[PCAP_CONTEXT_HEADER_MAX] = {};
+    int     header_len                      = 0;
     switch (pdu.rat) {
       case srsran_rat_t::lte:
-        LTE_PCAP_MAC_UDP_WritePDU(pcap_file, &pdu.context, pdu.pdu->msg, pdu.pdu->N_bytes);
+        header_len = LTE_PCAP_PACK_MAC_UDP_HEADER_TO_BUFFER(&pdu.context, header, sizeof(header), pdu.pdu->N_bytes);
         break;
       case srsran_rat_t::nr:
-        NR_PCAP_MAC_UDP_WritePDU(pcap_file, &pdu.context_nr, pdu.pdu->msg, pdu.pdu->N_bytes);
+        header_len = NR_PCAP_PACK_MAC_UDP_HEADER_TO_BUFFER(&pdu.context_nr, header, sizeof(header), pdu.pdu->N_bytes);
         break;
       default:
         logger.error("Error writing PDU to PCAP. Unsupported RAT selected.");
+        return;
+    }
+    if (header_len > 0) {
+      writer.write(header, header_len, pdu.pdu->msg, pdu.pdu->N_bytes);
     }
   }
 }
@@ -0,0 +1,235 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/security.h"
+#include "srsran/common/ssl.h"
+#include <algorithm>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MILENAGE_AESNI_SUPPORTED
+#include <immintrin.h>
+#endif
+
+namespace srsran {
+
+namespace {
+
+/// Number of Milenage AES blocks computed after TEMP: OUT1 (f1), OUT2 (f2, f5), OUT3 (f3) and OUT4 (f4).
+const uint32_t MILENAGE_NOF_OUT_BLOCKS = 4;
+
+/// Builds the AES input of TEMP = E_K(RAND xor OPc).
+void milenage_temp_input(const milenage_input_t& in, uint8_t* input)
+{
+  for (uint32_t i = 0; i < 16; i++) {
+    input[i] = in.rand[i] ^ in.opc[i];
+  }
+}
+
+/// Builds the AES inputs of OUT1 to OUT4 from TEMP, as described in TS 35.206 section 4.1.
+void milenage_out_inputs(const milenage_input_t& in, const uint8_t* temp, uint8_t inputs[][16])
+{
+  // OUT1: rotate (IN1 xor OPc) by r1 = 64 bits and add TEMP
+  uint8_t in1[16];
+  for (uint32_t i = 0; i < 6; i++) {
+    in1[i]     = in.sqn[i];
+    in1[i + 8] = in.sqn[i];
+  }
+  for (uint32_t i = 0; i < 2; i++) {
+    in1[i + 6]  = in.amf[i];
+    in1[i + 14] = in.amf[i];
+  }
+  for (uint32_t i = 0; i < 16; i++) {
+    inputs[0][(i + 8) % 16] = in1[i] ^ in.opc[i];
+  }
+  for (uint32_t i = 0; i < 16; i++) {
+    inputs[0][i] ^= temp[i];
+  }
+
+  // OUT2 to OUT4: rotate (TEMP xor OPc) by r2 = 0, r3 = 32 and r4 = 64 bits and add c2 = 1, c3 = 2 and c4 = 4
+  for (uint32_t i = 0; i < 16; i++) {
+    uint8_t v                = temp[i] ^ in.opc[i];
+    inputs[1][i]             = v;
+    inputs[2][(i + 12) % 16] = v;
+    inputs[3][(i + 8) % 16]  = v;
+  }
+  inputs[1][15] ^= 1;
+  inputs[2][15] ^= 2;
+  inputs[3][15] ^= 4;
+}
+
+/// Adds OPc to OUT1 to OUT4 and extracts MAC-A, RES, CK, IK and AK.
+void milenage_outputs(const milenage_input_t& in, uint8_t outs[][16], milenage_output_t& out)
+{
+  for (uint32_t b = 0; b < MILENAGE_NOF_OUT_BLOCKS; b++) {
+    for (uint32_t i = 0; i < 16; i++) {
+      outs[b][i] ^= in.opc[i];
+    }
+  }
+  memcpy(out.mac_a, outs[0], 8);
+  memcpy(out.res, &outs[1][8], 8);
+  memcpy(out.ak, outs[1], 6);
+  memcpy(out.ck, outs[2], 16);
+  memcpy(out.ik, outs[3], 16);
+}
+
+void milenage_f12345_generic(const milenage_input_t& in, milenage_output_t& out)
+{
+  aes_context ctx;
+  uint8_t     input[16];
+  uint8_t     temp[16];
+  uint8_t     inputs[MILENAGE_NOF_OUT_BLOCKS][16];
+  uint8_t     outs[MILENAGE_NOF_OUT_BLOCKS][16];
+
+  aes_setkey_enc(&ctx, in.k, 128);
+  milenage_temp_input(in, input);
+  aes_crypt_ecb(&ctx, AES_ENCRYPT, input, temp);
+  milenage_out_inputs(in, temp, inputs);
+  for (uint32_t b = 0; b < MILENAGE_NOF_OUT_BLOCKS; b++) {
+    aes_crypt_ecb(&ctx, AES_ENCRYPT, inputs[b], outs[b]);
+  }
+  milenage_outputs(in, outs, out);
+}
+
+#ifdef MILENAGE_AESNI_SUPPORTED
+
+/// Number of vectors whose AES rounds are interleaved.
+const uint32_t MILENAGE_AESNI_LANES = 4;
+
+#define MILENAGE_AESNI __attribute__((target("aes,sse2")))
+
+MILENAGE_AESNI inline __m128i aes128_key_step(__m128i key, __m128i keygened)
+{
+  keygened = _mm_shuffle_epi32(keygened, _MM_SHUFFLE(3, 3, 3, 3));
+  key      = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key      = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key      = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, keygened);
+}
+
+MILENAGE_AESNI void aes128_expand_key(const uint8_t* key, __m128i* rk)
+{
+  rk[0]  = _mm_loadu_si128((const __m128i*)key);
+  rk[1]  = aes128_key_step(rk[0], _mm_aeskeygenassist_si128(rk[0], 0x01));
+  rk[2]  = aes128_key_step(rk[1], _mm_aeskeygenassist_si128(rk[1], 0x02));
+  rk[3]  = aes128_key_step(rk[2], _mm_aeskeygenassist_si128(rk[2], 0x04));
+  rk[4]  = aes128_key_step(rk[3], _mm_aeskeygenassist_si128(rk[3], 0x08));
+  rk[5]  = aes128_key_step(rk[4], _mm_aeskeygenassist_si128(rk[4], 0x10));
+  rk[6]  = aes128_key_step(rk[5], _mm_aeskeygenassist_si128(rk[5], 0x20));
+  rk[7]  = aes128_key_step(rk[6], _mm_aeskeygenassist_si128(rk[6], 0x40));
+  rk[8]  = aes128_key_step(rk[7], _mm_aeskeygenassist_si128(rk[7], 0x80));
+  rk[9]  = aes128_key_step(rk[8], _mm_aeskeygenassist_si128(rk[8], 0x1b));
+  rk[10] = aes128_key_step(rk[9], _mm_aeskeygenassist_si128(rk[9], 0x36));
+}
+
+/// Encrypts N blocks, block i with the round keys rk[key_idx[i]]. All blocks go through each round together,
+/// so the latency of one AESENC is hidden behind the others.
+template <uint32_t N>
+MILENAGE_AESNI void aes128_encrypt_interleaved(const __m128i (*rk)[11], const uint32_t* key_idx, __m128i* blocks)
+{
+  for (uint32_t i = 0; i < N; i++) {
+    blocks[i] = _mm_xor_si128(blocks[i], rk[key_idx[i]][0]);
+  }
+  for (uint32_t r = 1; r < 10; r++) {
+    for (uint32_t i = 0; i < N; i++) {
+      blocks[i] = _mm_aesenc_si128(blocks[i], rk[key_idx[i]][r]);
+    }
+  }
+  for (uint32_t i = 0; i < N; i++) {
+    blocks[i] = _mm_aesenclast_si128(blocks[i], rk[key_idx[i]][10]);
+  }
+}
+
+/// Computes MILENAGE_AESNI_LANES vectors. Lanes beyond nof_vectors repeat the last vector and are discarded.
+MILENAGE_AESNI void milenage_f12345_aesni(const milenage_input_t* in, milenage_output_t* out, uint32_t nof_vectors)
+{
+  const uint32_t L = MILENAGE_AESNI_LANES;
+  const uint32_t B = MILENAGE_NOF_OUT_BLOCKS;
+
+  __m128i  rk[L][11];
+  uint32_t lane_of[L];
+  for (uint32_t l = 0; l < L; l++) {
+    lane_of[l] = l < nof_vectors ? l : nof_vectors - 1;
+    aes128_expand_key(in[lane_of[l]].k, rk[l]);
+  }
+
+  // TEMP of every lane
+  uint32_t temp_key_idx[L];
+  __m128i  temp_blocks[L];
+  for (uint32_t l = 0; l < L; l++) {
+    uint8_t input[16];
+    milenage_temp_input(in[lane_of[l]], input);
+    temp_blocks[l]  = _mm_loadu_si128((const __m128i*)input);
+    temp_key_idx[l] = l;
+  }
+  aes128_encrypt_interleaved<L>(rk, temp_key_idx, temp_blocks);
+
+  // OUT1 to OUT4 of every lane
+  uint32_t out_key_idx[L * B];
+  __m128i  out_blocks[L * B];
+  for (uint32_t l = 0; l < L; l++) {
+    uint8_t temp[16];
+    uint8_t inputs[B][16];
+    _mm_storeu_si128((__m128i*)temp, temp_blocks[l]);
+    milenage_out_inputs(in[lane_of[l]], temp, inputs);
+    for (uint32_t b = 0; b < B; b++) {
+      out_blocks[l * B + b]  = _mm_loadu_si128((const __m128i*)inputs[b]);
+      out_key_idx[l * B + b] = l;
+    }
+  }
+  aes128_encrypt_interleaved<L * B>(rk, out_key_idx, out_blocks);
+
+  for (uint32_t l = 0; l < nof_vectors; l++) {
+    uint8_t outs[B][16];
+    for (uint32_t b = 0; b < B; b++) {
+      _mm_storeu_si128((__m128i*)outs[b], out_blocks[l * B + b]);
+    }
+    milenage_outputs(in[l], outs, out[l]);
+  }
+}
+
+bool milenage_aesni_available()
+{
+  static const bool available = __builtin_cpu_supports("aes");
+  return available;
+}
+
+#endif // MILENAGE_AESNI_SUPPORTED
+
+} // namespace
+
+void security_milenage_f12345_batch(const milenage_input_t* in, milenage_output_t* out, uint32_t nof_vectors)
+{
+#ifdef MILENAGE_AESNI_SUPPORTED
+  if (milenage_aesni_available()) {
+    for (uint32_t i = 0; i < nof_vectors; i += MILENAGE_AESNI_LANES) {
+      milenage_f12345_aesni(&in[i], &out[i], std::min(nof_vectors - i, MILENAGE_AESNI_LANES));
+    }
+    return;
+  }
+#endif // MILENAGE_AESNI_SUPPORTED
+
+  for (uint32_t i = 0; i < nof_vectors; i++) {
+    milenage_f12345_generic(in[i], out[i]);
+  }
+}
+
+} // namespace srsran
@@ -52,13 +52,17 @@ void nas_pcap::enable()
 
 uint32_t nas_pcap::open(std::string filename_, uint32_t ue_id_, srsran_rat_t rat_type)
 {
-  filename = filename_;
-  if (rat_type == srsran_rat_t::nr) {
-    pcap_file = DLT_PCAP_Open(NAS_5G_DLT, filename.c_str());
-  } else {
-    pcap_file = DLT_PCAP_Open(NAS_LTE_DLT, filename.c_str());
-  }
-  if (pcap_file == nullptr) {
+  pcap_writer_args_t writer_args;
+  writer_args.filename = filename_;
+  return open(writer_args, ue_id_, rat_type);
+}
+
+uint32_t nas_pcap::open(const pcap_writer_args_t& writer_args, uint32_t ue_id_, srsran_rat_t rat_type)
+{
+  pcap_writer_args_t args = writer_args;
+  args.dlt                = (rat_type == srsran_rat_t::nr) ? NAS_5G_DLT : NAS_LTE_DLT;
+  filename                = args.filename;
+  if (writer.open(args) != SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
   ue_id        = ue_id_;
@@ -69,16 +73,14 @@ uint32_t nas_pcap::open(std::string filename_, uint32_t ue_id_, srsran_rat_t rat
 void nas_pcap::close()
 {
   fprintf(stdout, "Saving NAS PCAP file (DLT=%d) to %s \n", NAS_LTE_DLT, filename.c_str());
-  DLT_PCAP_Close(pcap_file);
-  pcap_file = nullptr;
+  writer.close();
 }
 
 void nas_pcap::write_nas(uint8_t* pdu, uint32_t pdu_len_bytes)
 {
   if (enable_write) {
-    NAS_Context_Info_t context;
     if (pdu) {
-      LTE_PCAP_NAS_WritePDU(pcap_file, &context, pdu, pdu_len_bytes);
+      writer.write(nullptr, 0, pdu, pdu_len_bytes);
     }
   }
 }
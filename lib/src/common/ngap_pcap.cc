@@ -49,11 +49,22 @@ void ngap_pcap::enable()
 {
   enable_write = true;
 }
-void ngap_pcap::open(const char* filename_)
+uint32_t ngap_pcap::open(const char* filename_)
 {
-  filename     = filename_;
-  pcap_file    = DLT_PCAP_Open(NGAP_5G_DLT, filename.c_str());
+  pcap_writer_args_t writer_args;
+  writer_args.filename = filename_;
+  return open(writer_args);
+}
+uint32_t ngap_pcap::open(const pcap_writer_args_t& writer_args)
+{
+  pcap_writer_args_t args = writer_args;
+  args.dlt                = NGAP_5G_DLT;
+  filename                = args.filename;
+  if (writer.open(args) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
   enable_write = true;
+  return SRSRAN_SUCCESS;
 }
 void ngap_pcap::close()
 {
@@ -61,15 +72,14 @@ void ngap_pcap::close()
     return;
   }
   fprintf(stdout, "Saving NGAP PCAP file (DLT=%d) to %s\n", NGAP_5G_DLT, filename.c_str());
-  DLT_PCAP_Close(pcap_file);
+  writer.close();
 }
 
 void ngap_pcap::write_ngap(uint8_t* pdu, uint32_t pdu_len_bytes)
 {
   if (enable_write) {
-    NGAP_Context_Info_t context;
     if (pdu) {
-      LTE_PCAP_NGAP_WritePDU(pcap_file, &context, pdu, pdu_len_bytes);
+      writer.write(nullptr, 0, pdu, pdu_len_bytes);
     }
   }
 }
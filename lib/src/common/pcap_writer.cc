@@ -0,0 +1,504 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/pcap_writer.h"
+#include "srsran/config.h"
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace srsran {
+
+/// Largest record accepted by the writer, i.e. the snaplen advertised in the file header.
+static const uint32_t pcap_writer_snaplen = 65535;
+
+/// Bounds on the number of capture buffers, the upper one keeps a whole batch within a single writev().
+static const uint32_t pcap_writer_min_buffers = 2;
+static const uint32_t pcap_writer_max_buffers = 64;
+
+static uint32_t pad_to_32bit(uint32_t len)
+{
+  return (len + 3U) & ~3U;
+}
+
+/// Returns the name of the file with index file_idx, i.e. "name.pcap", "name.1.pcap", "name.2.pcap"...
+static std::string rotated_filename(const std::string& filename, uint32_t file_idx)
+{
+  if (file_idx == 0) {
+    return filename;
+  }
+  size_t dot   = filename.find_last_of('.');
+  size_t slash = filename.find_last_of('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return filename + "." + std::to_string(file_idx);
+  }
+  return filename.substr(0, dot) + "." + std::to_string(file_idx) + filename.substr(dot);
+}
+
+/// Writes the whole buffer to fd, retrying on partial writes and interrupts.
+static bool write_all(int fd, const void* data, size_t len)
+{
+  const uint8_t* ptr = static_cast<const uint8_t*>(data);
+  while (len > 0) {
+    ssize_t ret = ::write(fd, ptr, len);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    ptr += ret;
+    len -= ret;
+  }
+  return true;
+}
+
+pcap_writer::pcap_writer() : thread("PCAP_WRITER"), logger(srslog::fetch_basic_logger("PCAP")) {}
+
+pcap_writer::~pcap_writer()
+{
+  close();
+}
+
+int pcap_writer::open(const pcap_writer_args_t& args_)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (running) {
+    logger.error("PCAP writer for %s already running. Close first.", file_name.c_str());
+    return SRSRAN_ERROR;
+  }
+
+  args             = args_;
+  args.nof_buffers = std::min(std::max(args.nof_buffers, pcap_writer_min_buffers), pcap_writer_max_buffers);
+  // Every buffer must be able to hold at least one record of maximum size
+  args.buffer_size = std::max(args.buffer_size, record_length(pcap_writer_snaplen));
+
+  file_idx = 0;
+  if (open_file() != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  file_name = rotated_filename(args.filename, file_idx);
+
+  buffers.resize(args.nof_buffers);
+  free_buffers.clear();
+  free_buffers.reserve(args.nof_buffers);
+  ready_buffers.clear();
+  ready_buffers.reserve(args.nof_buffers);
+  for (uint32_t i = 0; i < args.nof_buffers; ++i) {
+    if (buffers[i].data == nullptr) {
+      buffers[i].data = std::unique_ptr<uint8_t[]>(new uint8_t[args.buffer_size]);
+    }
+    buffers[i].len = 0;
+    free_buffers.push_back(args.nof_buffers - 1 - i);
+  }
+  current     = no_buffer;
+  nof_dropped = 0;
+  iov.resize(args.nof_buffers);
+
+#ifdef HAVE_LIBURING
+  int ret = io_uring_queue_init(args.nof_buffers, &ring, 0);
+  if (ret < 0) {
+    logger.warning("Couldn't set up io_uring (%s). Falling back to writev()", strerror(-ret));
+  }
+  ring_ready = (ret == 0);
+#endif // HAVE_LIBURING
+
+  running = true;
+  start();
+
+  return SRSRAN_SUCCESS;
+}
+
+int pcap_writer::close()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (not running) {
+      return SRSRAN_ERROR;
+    }
+    // The writer thread flushes everything that is still buffered before exiting
+    running = false;
+    cvar.notify_one();
+  }
+
+  wait_thread_finish();
+  close_file();
+
+#ifdef HAVE_LIBURING
+  if (ring_ready) {
+    io_uring_queue_exit(&ring);
+    ring_ready = false;
+  }
+#endif // HAVE_LIBURING
+
+  if (nof_dropped > 0) {
+    logger.warning("PCAP writer for %s dropped %" PRIu64 " records", args.filename.c_str(), nof_dropped);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+std::string pcap_writer::get_filename() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return file_name;
+}
+
+uint64_t pcap_writer::get_nof_dropped() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return nof_dropped;
+}
+
+bool pcap_writer::write(const uint8_t* hdr, uint32_t hdr_len, const uint8_t* pdu, uint32_t pdu_len)
+{
+  if (not running) {
+    return false;
+  }
+  if (hdr == nullptr) {
+    hdr_len = 0;
+  }
+  if (hdr_len + pdu_len > pcap_writer_snaplen) {
+    logger.warning("Dropping record in PCAP. Length %d exceeds snaplen", hdr_len + pdu_len);
+    return false;
+  }
+  uint32_t rec_len = record_length(hdr_len + pdu_len);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (not running) {
+    return false;
+  }
+
+  // Hand the current buffer to the writer thread once the record no longer fits in it
+  if (current != no_buffer and buffers[current].len + rec_len > args.buffer_size) {
+    ready_buffers.push_back(current);
+    current = no_buffer;
+    cvar.notify_one();
+  }
+  if (current == no_buffer and not acquire_buffer()) {
+    nof_dropped++;
+    return false;
+  }
+
+  pack_record(buffers[current], hdr, hdr_len, pdu, pdu_len);
+  return true;
+}
+
+uint32_t pcap_writer::record_length(uint32_t data_len) const
+{
+  if (args.format == pcap_file_format::pcapng) {
+    return sizeof(pcapng_epb_hdr_t) + pad_to_32bit(data_len) + sizeof(uint32_t);
+  }
+  return sizeof(pcaprec_hdr_t) + data_len;
+}
+
+bool pcap_writer::acquire_buffer()
+{
+  if (free_buffers.empty()) {
+    return false;
+  }
+  current = free_buffers.back();
+  free_buffers.pop_back();
+  return true;
+}
+
+void pcap_writer::pack_record(capture_buffer_t& buffer,
+                              const uint8_t*    hdr,
+                              uint32_t          hdr_len,
+                              const uint8_t*    pdu,
+                              uint32_t          pdu_len)
+{
+  uint32_t data_len = hdr_len + pdu_len;
+  uint8_t* ptr      = buffer.data.get() + buffer.len;
+
+  // Timestamps are taken under the lock so that records are ordered in time within the file
+  struct timeval t;
+  gettimeofday(&t, nullptr);
+
+  if (args.format == pcap_file_format::pcapng) {
+    uint64_t         ts_us = (uint64_t)t.tv_sec * 1000000 + t.tv_usec;
+    pcapng_epb_hdr_t epb   = {};
+    epb.block_type         = PCAPNG_EPB_TYPE;
+    epb.block_total_len    = record_length(data_len);
+    epb.interface_id       = 0;
+    epb.ts_high            = (uint32_t)(ts_us >> 32U);
+    epb.ts_low             = (uint32_t)ts_us;
+    epb.cap_len            = data_len;
+    epb.orig_len           = data_len;
+    memcpy(ptr, &epb, sizeof(epb));
+    ptr += sizeof(epb);
+  } else {
+    pcaprec_hdr_t packet_header;
+    packet_header.ts_sec   = t.tv_sec;
+    packet_header.ts_usec  = t.tv_usec;
+    packet_header.incl_len = data_len;
+    packet_header.orig_len = data_len;
+    memcpy(ptr, &packet_header, sizeof(packet_header));
+    ptr += sizeof(packet_header);
+  }
+
+  if (hdr_len > 0) {
+    memcpy(ptr, hdr, hdr_len);
+    ptr += hdr_len;
+  }
+  if (pdu_len > 0) {
+    memcpy(ptr, pdu, pdu_len);
+    ptr += pdu_len;
+  }
+
+  if (args.format == pcap_file_format::pcapng) {
+    uint32_t padding = pad_to_32bit(data_len) - data_len;
+    memset(ptr, 0, padding);
+    ptr += padding;
+    uint32_t block_total_len = record_length(data_len);
+    memcpy(ptr, &block_total_len, sizeof(block_total_len));
+  }
+
+  buffer.len += record_length(data_len);
+}
+
+void pcap_writer::run_thread()
+{
+  std::vector<uint32_t> pending;
+  pending.reserve(args.nof_buffers);
+  uint64_t reported_drops = 0;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    if (ready_buffers.empty() and running) {
+      cvar.wait_for(lock, std::chrono::milliseconds(args.flush_period_ms));
+    }
+
+    // Flush a partially filled buffer when producers are idle or when closing
+    if (ready_buffers.empty() and current != no_buffer and buffers[current].len > 0) {
+      ready_buffers.push_back(current);
+      current = no_buffer;
+    }
+    if (nof_dropped != reported_drops) {
+      logger.warning("Dropped %" PRIu64 " PCAP records. All capture buffers in use.", nof_dropped - reported_drops);
+      reported_drops = nof_dropped;
+    }
+
+    bool stop = not running;
+    pending.swap(ready_buffers);
+
+    // Disk I/O is done without holding the lock
+    lock.unlock();
+    write_buffers(pending);
+    lock.lock();
+
+    for (uint32_t idx : pending) {
+      buffers[idx].len = 0;
+      free_buffers.push_back(idx);
+    }
+    pending.clear();
+
+    if (stop and ready_buffers.empty() and (current == no_buffer or buffers[current].len == 0)) {
+      break;
+    }
+  }
+}
+
+int pcap_writer::open_file()
+{
+  std::string name = rotated_filename(args.filename, file_idx);
+
+  fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    logger.error("Couldn't open %s to write PCAP (%s)", name.c_str(), strerror(errno));
+    return SRSRAN_ERROR;
+  }
+
+  bool success = true;
+  if (args.format == pcap_file_format::pcapng) {
+    pcapng_shb_t shb      = {};
+    shb.block_type        = PCAPNG_SHB_TYPE;
+    shb.block_total_len   = sizeof(shb);
+    shb.byte_order_magic  = PCAPNG_BYTE_ORDER_MAGIC;
+    shb.version_major     = 1;
+    shb.version_minor     = 0;
+    shb.section_len       = -1;
+    shb.block_total_len_2 = sizeof(shb);
+
+    pcapng_idb_t idb      = {};
+    idb.block_type        = PCAPNG_IDB_TYPE;
+    idb.block_total_len   = sizeof(idb);
+    idb.link_type         = (uint16_t)args.dlt;
+    idb.snaplen           = pcap_writer_snaplen;
+    idb.block_total_len_2 = sizeof(idb);
+
+    success     = write_all(fd, &shb, sizeof(shb)) and write_all(fd, &idb, sizeof(idb));
+    file_offset = sizeof(shb) + sizeof(idb);
+  } else {
+    pcap_hdr_t file_header;
+    DLT_PCAP_PACK_FILE_HEADER(args.dlt, &file_header);
+    success     = write_all(fd, &file_header, sizeof(file_header));
+    file_offset = sizeof(file_header);
+  }
+
+  if (not success) {
+    logger.error("Couldn't write PCAP file header to %s (%s)", name.c_str(), strerror(errno));
+    close_file();
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+void pcap_writer::close_file()
+{
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+void pcap_writer::write_buffers(const std::vector<uint32_t>& pending)
+{
+  uint32_t i = 0;
+  while (i < pending.size()) {
+    // Rotation happens on buffer boundaries, so records are never split across files
+    if (args.max_file_size > 0 and file_offset >= args.max_file_size) {
+      close_file();
+      file_idx = (args.max_nof_files > 0) ? (file_idx + 1) % args.max_nof_files : file_idx + 1;
+      if (open_file() == SRSRAN_SUCCESS) {
+        std::lock_guard<std::mutex> lock(mutex);
+        file_name = rotated_filename(args.filename, file_idx);
+      }
+    }
+    if (fd < 0) {
+      logger.error("Discarding %zd PCAP buffers. No file open.", pending.size() - i);
+      return;
+    }
+
+    // Batch as many buffers as fit in the current file
+    uint32_t nof_batch   = 0;
+    uint64_t batch_bytes = 0;
+    do {
+      batch_bytes += buffers[pending[i + nof_batch]].len;
+      nof_batch++;
+    } while (i + nof_batch < pending.size() and
+             (args.max_file_size == 0 or file_offset + batch_bytes < args.max_file_size));
+
+    if (not write_batch(&pending[i], nof_batch)) {
+      logger.error("Error writing %" PRIu64 " bytes to PCAP file (%s)", batch_bytes, strerror(errno));
+    }
+    i += nof_batch;
+  }
+}
+
+bool pcap_writer::write_batch(const uint32_t* buffer_idxs, uint32_t nof_buffers)
+{
+#ifdef HAVE_LIBURING
+  if (ring_ready) {
+    uint64_t offset        = file_offset;
+    uint32_t nof_submitted = 0;
+    for (uint32_t i = 0; i < nof_buffers; ++i) {
+      struct io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+      if (sqe == nullptr) {
+        break;
+      }
+      const capture_buffer_t& buffer = buffers[buffer_idxs[i]];
+      io_uring_prep_write(sqe, fd, buffer.data.get(), buffer.len, offset);
+      io_uring_sqe_set_data(sqe, (void*)(uintptr_t)i);
+      offset += buffer.len;
+      nof_submitted++;
+    }
+
+    int ret = io_uring_submit_and_wait(&ring, nof_submitted);
+    if (ret >= 0) {
+      bool success = true;
+      for (uint32_t n = 0; n < nof_submitted; ++n) {
+        struct io_uring_cqe* cqe = nullptr;
+        if (io_uring_wait_cqe(&ring, &cqe) < 0) {
+          success = false;
+          break;
+        }
+        uint32_t i   = (uint32_t)(uintptr_t)io_uring_cqe_get_data(cqe);
+        int      res = cqe->res;
+        io_uring_cqe_seen(&ring, cqe);
+
+        const capture_buffer_t& buffer = buffers[buffer_idxs[i]];
+        if (res < 0) {
+          errno   = -res;
+          success = false;
+        } else if ((uint32_t)res < buffer.len) {
+          // Complete short writes synchronously, they are rare for regular files
+          uint64_t buffer_offset = file_offset;
+          for (uint32_t k = 0; k < i; ++k) {
+            buffer_offset += buffers[buffer_idxs[k]].len;
+          }
+          size_t remaining = buffer.len - res;
+          if (pwrite(fd, buffer.data.get() + res, remaining, buffer_offset + res) != (ssize_t)remaining) {
+            success = false;
+          }
+        }
+      }
+      file_offset = offset;
+
+      // Anything that did not fit in the submission queue goes through the regular path
+      if (nof_submitted < nof_buffers) {
+        return write_batch(buffer_idxs + nof_submitted, nof_buffers - nof_submitted) and success;
+      }
+      return success;
+    }
+    logger.warning("io_uring submission failed (%s). Falling back to writev()", strerror(-ret));
+    io_uring_queue_exit(&ring);
+    ring_ready = false;
+  }
+#endif // HAVE_LIBURING
+
+  for (uint32_t i = 0; i < nof_buffers; ++i) {
+    iov[i].iov_base = buffers[buffer_idxs[i]].data.get();
+    iov[i].iov_len  = buffers[buffer_idxs[i]].len;
+  }
+
+  uint32_t iov_idx = 0;
+  while (iov_idx < nof_buffers) {
+    ssize_t ret = pwritev(fd, &iov[iov_idx], nof_buffers - iov_idx, file_offset);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    file_offset += ret;
+
+    // Skip whatever has been fully written and resume the partially written buffer
+    while (ret > 0 and iov_idx < nof_buffers) {
+      if ((size_t)ret >= iov[iov_idx].iov_len) {
+        ret -= iov[iov_idx].iov_len;
+        iov_idx++;
+      } else {
+        iov[iov_idx].iov_base = static_cast<uint8_t*>(iov[iov_idx].iov_base) + ret;
+        iov[iov_idx].iov_len -= ret;
+        ret = 0;
+      }
+    }
+  }
+
+  return true;
+}
+
+} // namespace srsran
@@ -31,10 +31,21 @@ void rlc_pcap::enable(bool en)
   enable_write = true;
 }
 
-void rlc_pcap::open(const char* filename, const rlc_config_t& config)
+uint32_t rlc_pcap::open(const char* filename, const rlc_config_t& config)
+{
+  pcap_writer_args_t writer_args;
+  writer_args.filename = filename;
+  return open(writer_args, config);
+}
+
+uint32_t rlc_pcap::open(const pcap_writer_args_t& writer_args, const rlc_config_t& config)
 {
   fprintf(stdout, "Opening RLC PCAP with DLT=%d\n", UDP_DLT);
-  pcap_file    = DLT_PCAP_Open(UDP_DLT, filename);
+  pcap_writer_args_t args = writer_args;
+  args.dlt                = UDP_DLT;
+  if (writer.open(args) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
   enable_write = true;
 
   if (config.rlc_mode == rlc_mode_t::am) {
@@ -50,11 +61,12 @@ void rlc_pcap::open(const char* filename, const rlc_config_t& config)
   } else {
     mode = RLC_TM_MODE;
   }
+  return SRSRAN_SUCCESS;
 }
 void rlc_pcap::close()
 {
   fprintf(stdout, "Saving RLC PCAP file\n");
-  DLT_PCAP_Close(pcap_file);
+  writer.close();
 }
 
 void rlc_pcap::set_ue_id(uint16_t ue_id_)
@@ -83,7 +95,11 @@ void rlc_pcap::pack_and_write(uint8_t* pdu,
     context.channelId            = channel_id;
     context.pduLength            = pdu_len_bytes;
     if (pdu) {
-      LTE_PCAP_RLC_WritePDU(pcap_file, &context, pdu, pdu_len_bytes);
+      uint8_t header[PCAP_CONTEXT_HEADER_MAX] = {};
+      int     header_len = LTE_PCAP_PACK_RLC_UDP_HEADER_TO_BUFFER(&context, header, sizeof(header), pdu_len_bytes);
+      if (header_len > 0) {
+        writer.write(header, header_len, pdu, pdu_len_bytes);
+      }
     }
   }
 }
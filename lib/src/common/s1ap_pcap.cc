@@ -49,11 +49,22 @@ void s1ap_pcap::enable()
 {
   enable_write = true;
 }
-void s1ap_pcap::open(const char* filename_)
+uint32_t s1ap_pcap::open(const char* filename_)
 {
-  filename     = filename_;
-  pcap_file    = DLT_PCAP_Open(S1AP_LTE_DLT, filename.c_str());
+  pcap_writer_args_t writer_args;
+  writer_args.filename = filename_;
+  return open(writer_args);
+}
+uint32_t s1ap_pcap::open(const pcap_writer_args_t& writer_args)
+{
+  pcap_writer_args_t args = writer_args;
+  args.dlt                = S1AP_LTE_DLT;
+  filename                = args.filename;
+  if (writer.open(args) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
   enable_write = true;
+  return SRSRAN_SUCCESS;
 }
 void s1ap_pcap::close()
 {
@@ -61,15 +72,14 @@ void s1ap_pcap::close()
     return;
   }
   fprintf(stdout, "Saving S1AP PCAP file (DLT=%d) to %s\n", S1AP_LTE_DLT, filename.c_str());
-  DLT_PCAP_Close(pcap_file);
+  writer.close();
 }
 
 void s1ap_pcap::write_s1ap(uint8_t* pdu, uint32_t pdu_len_bytes)
 {
   if (enable_write) {
-    S1AP_Context_Info_t context;
     if (pdu) {
-      LTE_PCAP_S1AP_WritePDU(pcap_file, &context, pdu, pdu_len_bytes);
+      writer.write(nullptr, 0, pdu, pdu_len_bytes);
     }
   }
 }
@@ -35,6 +35,12 @@
 
 //#define DEFAULT_FILTER_LEN 3
 
+// Maximum number of subframes between two incremental updates before the state is discarded
+#define CHEST_DL_STATE_MAX_GAP_SF 10
+
+// Ratio between the estimate innovation and the noise above which the channel is considered changed
+#define CHEST_DL_STATE_CHANGE_TH 4.0f
+
 #ifdef DEFAULT_FILTER_LEN
 static void set_default_filter(srsran_chest_dl_t* q, int filter_len)
 {
@@ -121,6 +127,16 @@ int srsran_chest_dl_init(srsran_chest_dl_t* q, uint32_t max_prb, uint32_t nof_rx
       goto clean_exit;
     }
 
+    for (uint32_t i = 0; i < SRSRAN_MIN(nof_rx_antennas, SRSRAN_MAX_PORTS); i++) {
+      for (uint32_t j = 0; j < SRSRAN_MAX_PORTS; j++) {
+        q->state[i][j].pilots = srsran_vec_cf_malloc(pilot_vec_size);
+        if (!q->state[i][j].pilots) {
+          perror("malloc");
+          goto clean_exit;
+        }
+      }
+    }
+
     if (srsran_interp_linear_vector_init(&q->srsran_interp_linvec, SRSRAN_NRE * max_prb)) {
       ERROR("Error initializing vector interpolator");
       goto clean_exit;
@@ -198,6 +214,13 @@ void srsran_chest_dl_free(srsran_chest_dl_t* q)
   if (q->pilot_recv_signal) {
     free(q->pilot_recv_signal);
   }
+  for (uint32_t i = 0; i < SRSRAN_MAX_PORTS; i++) {
+    for (uint32_t j = 0; j < SRSRAN_MAX_PORTS; j++) {
+      if (q->state[i][j].pilots) {
+        free(q->state[i][j].pilots);
+      }
+    }
+  }
   if (q->wiener_dl) {
     srsran_wiener_dl_free(q->wiener_dl);
     free(q->wiener_dl);
@@ -315,6 +338,13 @@ int srsran_chest_dl_set_cell(srsran_chest_dl_t* q, srsran_cell_t cell)
         fprintf(stderr, "Error initializing interpolator\n");
         return SRSRAN_ERROR;
       }
+
+      // The estimates of the previous cell can not be reused
+      for (uint32_t i = 0; i < SRSRAN_MAX_PORTS; i++) {
+        for (uint32_t j = 0; j < SRSRAN_MAX_PORTS; j++) {
+          q->state[i][j].nof_pilots = 0;
+        }
+      }
     }
     ret = SRSRAN_SUCCESS;
   }
@@ -432,6 +462,110 @@ static float estimate_noise_empty_sc(srsran_chest_dl_t* q, cf_t* input)
   return noise_power;
 }
 
+/* Decides whether the noise and RSSI are measured in this subframe or held from the previous ones */
+static bool chest_dl_state_refresh(srsran_chest_dl_t*     q,
+                                   srsran_dl_sf_cfg_t*    sf,
+                                   srsran_chest_dl_cfg_t* cfg,
+                                   uint32_t               port_id,
+                                   uint32_t               rxant_id)
+{
+  srsran_chest_dl_state_t* s = &q->state[rxant_id][port_id];
+
+  if (!cfg->incremental_enable || sf->sf_type == SRSRAN_SF_MBSFN) {
+    s->nof_pilots = 0;
+    return true;
+  }
+
+  // Discard the state if the last update is too old
+  if (srsran_tti_interval(sf->tti, s->tti) > CHEST_DL_STATE_MAX_GAP_SF) {
+    s->nof_pilots = 0;
+  }
+  s->tti = sf->tti;
+
+  if (s->nof_pilots == 0 || s->nof_held + 1 >= SRSRAN_MAX(cfg->incremental_period, 1)) {
+    s->nof_held = 0;
+    return true;
+  }
+
+  s->nof_held++;
+  return false;
+}
+
+/* Filters the least square estimates with the ones from previous subframes. The filter is restarted if the difference
+ * between them is well above the noise, which means the channel has changed */
+static void chest_dl_time_filter(srsran_chest_dl_t*     q,
+                                 srsran_dl_sf_cfg_t*    sf,
+                                 srsran_chest_dl_cfg_t* cfg,
+                                 uint32_t               port_id,
+                                 uint32_t               rxant_id)
+{
+  srsran_chest_dl_state_t* s       = &q->state[rxant_id][port_id];
+  uint32_t                 npilots = srsran_refsignal_cs_nof_re(&q->csr_refs, sf, port_id);
+  float                    alpha   = cfg->incremental_alpha;
+  float                    noise   = q->noise_estimate[rxant_id][port_id];
+
+  if (s->nof_pilots == npilots && isnormal(noise) && alpha > 0.0f && alpha < 1.0f) {
+    srsran_vec_sub_ccc(q->pilot_estimates, s->pilots, q->tmp_noise, npilots);
+    if (srsran_vec_avg_power_cf(q->tmp_noise, npilots) < CHEST_DL_STATE_CHANGE_TH * noise) {
+      srsran_vec_sc_prod_cfc(q->tmp_noise, alpha, q->tmp_noise, npilots);
+      srsran_vec_sum_ccc(s->pilots, q->tmp_noise, s->pilots, npilots);
+      srsran_vec_cf_copy(q->pilot_estimates, s->pilots, npilots);
+      return;
+    }
+  }
+
+  srsran_vec_cf_copy(s->pilots, q->pilot_estimates, npilots);
+  s->nof_pilots = npilots;
+}
+
+/* Returns the smoothing filter for the given configuration, it is only computed when its parameters change */
+static uint32_t chest_dl_smooth_filter(srsran_chest_dl_t*     q,
+                                       srsran_chest_dl_cfg_t* cfg,
+                                       uint32_t               port_id,
+                                       uint32_t               rxant_id,
+                                       float**                filter)
+{
+  srsran_chest_dl_state_t* s     = &q->state[rxant_id][port_id];
+  float                    noise = 0.0f;
+  if (cfg->filter_type == SRSRAN_CHEST_FILTER_GAUSS && cfg->filter_coef[0] <= 0) {
+    noise = q->noise_estimate[rxant_id][port_id];
+  }
+
+  *filter = s->filter;
+
+  q->nof_reusable++;
+  if (s->filter_valid && s->filter_type == cfg->filter_type && s->filter_coef[0] == cfg->filter_coef[0] &&
+      s->filter_coef[1] == cfg->filter_coef[1] && s->filter_noise == noise) {
+    q->nof_reused++;
+    return s->filter_len;
+  }
+
+  switch (cfg->filter_type) {
+    case SRSRAN_CHEST_FILTER_GAUSS:
+      if (cfg->filter_coef[0] <= 0) {
+        s->filter_len = srsran_chest_set_smooth_filter_gauss(s->filter, 4, noise * 200.0f);
+      } else {
+        s->filter_len =
+            srsran_chest_set_smooth_filter_gauss(s->filter, (uint32_t)cfg->filter_coef[0], cfg->filter_coef[1]);
+      }
+      break;
+    case SRSRAN_CHEST_FILTER_TRIANGLE:
+      s->filter_len = srsran_chest_set_smooth_filter3_coeff(s->filter, cfg->filter_coef[0]);
+      break;
+    default:
+      s->filter_len = 0;
+      break;
+  }
+
+  s->filter_valid   = true;
+  s->filter_type    = cfg->filter_type;
+  s->filter_coef[0] = cfg->filter_coef[0];
+  s->filter_coef[1] = cfg->filter_coef[1];
+  s->filter_noise   = noise;
+
+  return s->filter_len;
+}
+
 #define cesymb(i) ce[SRSRAN_RE_IDX(q->cell.nof_prb, i, 0)]
 
 static void interpolate_pilots(srsran_chest_dl_t*     q,
@@ -645,9 +779,10 @@ static void chest_interpolate_noise_est(srsran_chest_dl_t*     q,
                                         cf_t*                  input,
                                         cf_t*                  ce,
                                         uint32_t               port_id,
-                                        uint32_t               rxant_id)
+                                        uint32_t               rxant_id,
+                                        bool                   refresh)
 {
-  float       filter[SRSRAN_CHEST_MAX_SMOOTH_FIL_LEN];
+  float*      filter     = NULL;
   uint32_t    filter_len = 0;
   uint32_t    sf_idx     = sf->tti % 10;
   srsran_sf_t ch_mode    = sf->sf_type;
@@ -662,7 +797,20 @@ static void chest_interpolate_noise_est(srsran_chest_dl_t*     q,
       ERROR("Warning: REFS noise estimation algorithm not supported in MBSFN subframes");
     }
 
-    q->noise_estimate[rxant_id][port_id] = estimate_noise_pilots(q, sf, port_id);
+    q->nof_reusable++;
+    if (refresh) {
+      float noise = estimate_noise_pilots(q, sf, port_id);
+      if (cfg->incremental_enable && cfg->incremental_alpha > 0.0f) {
+        noise = SRSRAN_VEC_SAFE_EMA(noise, q->noise_estimate[rxant_id][port_id], cfg->incremental_alpha);
+      }
+      q->noise_estimate[rxant_id][port_id] = noise;
+    } else {
+      q->nof_reused++;
+    }
+  }
+
+  if (cfg->incremental_enable && ch_mode == SRSRAN_SF_NORM && cfg->estimator_alg != SRSRAN_ESTIMATOR_ALG_WIENER) {
+    chest_dl_time_filter(q, sf, cfg, port_id, rxant_id);
   }
 
   if (q->wiener_dl && ch_mode == SRSRAN_SF_NORM && cfg->estimator_alg == SRSRAN_ESTIMATOR_ALG_WIENER) {
@@ -698,22 +846,11 @@ static void chest_interpolate_noise_est(srsran_chest_dl_t*     q,
   }
 
   if (ce != NULL) {
-    switch (cfg->filter_type) {
-      case SRSRAN_CHEST_FILTER_GAUSS:
-        if (ch_mode == SRSRAN_SF_MBSFN) {
-          ERROR("Warning: Gauss filter not supported in MBSFN subframes");
-        }
-        if (cfg->filter_coef[0] <= 0) {
-          filter_len = srsran_chest_set_smooth_filter_gauss(filter, 4, q->noise_estimate[rxant_id][port_id] * 200.0f);
-        } else {
-          filter_len = srsran_chest_set_smooth_filter_gauss(filter, (uint32_t)cfg->filter_coef[0], cfg->filter_coef[1]);
-        }
-        break;
-      case SRSRAN_CHEST_FILTER_TRIANGLE:
-        filter_len = srsran_chest_set_smooth_filter3_coeff(filter, cfg->filter_coef[0]);
-        break;
-      default:
-        break;
+    if (cfg->filter_type == SRSRAN_CHEST_FILTER_GAUSS && ch_mode == SRSRAN_SF_MBSFN) {
+      ERROR("Warning: Gauss filter not supported in MBSFN subframes");
+    }
+    if (cfg->filter_type != SRSRAN_CHEST_FILTER_NONE) {
+      filter_len = chest_dl_smooth_filter(q, cfg, port_id, rxant_id, &filter);
     }
 
     if (cfg->estimator_alg != SRSRAN_ESTIMATOR_ALG_INTERPOLATE && ch_mode == SRSRAN_SF_MBSFN) {
@@ -826,9 +963,20 @@ static int estimate_port(srsran_chest_dl_t*     q,
     q->rsrp_corr[rxant_id][port_id] = energy * energy;
   }
   q->rsrp[rxant_id][port_id] = srsran_vec_avg_power_cf(q->pilot_recv_signal, npilots);
-  q->rssi[rxant_id][port_id] = chest_dl_rssi(q, sf, input, port_id);
 
-  chest_interpolate_noise_est(q, sf, cfg, input, ce, port_id, rxant_id);
+  /* Ports 1 and 3 share the reference symbols of ports 0 and 2, which were just measured */
+  bool refresh = chest_dl_state_refresh(q, sf, cfg, port_id, rxant_id);
+  q->nof_reusable++;
+  if (port_id % 2 == 1) {
+    q->rssi[rxant_id][port_id] = q->rssi[rxant_id][port_id - 1];
+    q->nof_reused++;
+  } else if (refresh) {
+    q->rssi[rxant_id][port_id] = chest_dl_rssi(q, sf, input, port_id);
+  } else {
+    q->nof_reused++;
+  }
+
+  chest_interpolate_noise_est(q, sf, cfg, input, ce, port_id, rxant_id, refresh);
 
   return 0;
 }
@@ -859,7 +1007,8 @@ static int estimate_port_mbsfn(srsran_chest_dl_t*     q,
                            &q->pilot_estimates[(2 * q->cell.nof_prb)],
                            SRSRAN_REFSIGNAL_NUM_SF_MBSFN(q->cell.nof_prb, port_id) - (2 * q->cell.nof_prb));
 
-  chest_interpolate_noise_est(q, sf, cfg, input, ce, port_id, rxant_id);
+  bool refresh = chest_dl_state_refresh(q, sf, cfg, port_id, rxant_id);
+  chest_interpolate_noise_est(q, sf, cfg, input, ce, port_id, rxant_id, refresh);
 
   return 0;
 }
@@ -972,6 +1121,7 @@ static void fill_res(srsran_chest_dl_t* q, srsran_chest_dl_res_t* res)
   res->snr_db             = srsran_convert_power_to_dB(get_snr(q));
   res->rssi_dbm           = srsran_convert_power_to_dBm(get_rssi(q));
   res->sync_error         = q->sync_err[0][0]; // Take only the channel used for synch
+  res->reuse_ratio        = q->nof_reusable ? (float)q->nof_reused / (float)q->nof_reusable : 0.0f;
 
   for (uint32_t port_id = 0; port_id < q->cell.nof_ports; port_id++) {
     res->rsrp_port_dbm[port_id] = srsran_convert_power_to_dBm(get_rsrp_port(q, port_id));
@@ -1002,6 +1152,9 @@ int srsran_chest_dl_estimate_cfg(srsran_chest_dl_t*     q,
                                  cf_t*                  input[SRSRAN_MAX_PORTS],
                                  srsran_chest_dl_res_t* res)
 {
+  q->nof_reused   = 0;
+  q->nof_reusable = 0;
+
   for (uint32_t rxant_id = 0; rxant_id < q->nof_rx_antennas; rxant_id++) {
     // Estimate and correct synchronization error if enabled
     if (cfg->sync_error_enable) {
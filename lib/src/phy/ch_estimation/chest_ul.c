@@ -29,6 +29,7 @@
 
 #include "srsran/config.h"
 #include "srsran/phy/ch_estimation/chest_ul.h"
+#include "srsran/phy/dft/dft_mixed_radix.h"
 #include "srsran/phy/dft/dft_precoding.h"
 #include "srsran/phy/utils/convolution.h"
 #include "srsran/phy/utils/vector.h"
@@ -54,6 +55,7 @@ int srsran_chest_ul_init(srsran_chest_ul_t* q, uint32_t max_prb)
   int ret = SRSRAN_ERROR_INVALID_INPUTS;
   if (q != NULL) {
     bzero(q, sizeof(srsran_chest_ul_t));
+    q->max_prb = max_prb;
 
     q->tmp_noise = srsran_vec_cf_malloc(MAX_REFS_SF);
     if (!q->tmp_noise) {
@@ -84,6 +86,12 @@ int srsran_chest_ul_init(srsran_chest_ul_t* q, uint32_t max_prb)
       goto clean_exit;
     }
 
+    q->srs_window = srsran_vec_f_malloc(MAX_REFS_SYM / 2);
+    if (!q->srs_window) {
+      perror("malloc");
+      goto clean_exit;
+    }
+
     if (srsran_interp_linear_vector_init(&q->srsran_interp_linvec, MAX_REFS_SYM)) {
       ERROR("Error initializing vector interpolator");
       goto clean_exit;
@@ -132,6 +140,13 @@ void srsran_chest_ul_free(srsran_chest_ul_t* q)
   if (q->pilot_known_signal) {
     free(q->pilot_known_signal);
   }
+  if (q->srs_window) {
+    free(q->srs_window);
+  }
+  if (q->wiener_ul) {
+    srsran_wiener_ul_free(q->wiener_ul);
+    free(q->wiener_ul);
+  }
   bzero(q, sizeof(srsran_chest_ul_t));
 }
 
@@ -183,6 +198,49 @@ int srsran_chest_ul_set_cell(srsran_chest_ul_t* q, srsran_cell_t cell)
   return ret;
 }
 
+int srsran_chest_ul_set_estimator_alg(srsran_chest_ul_t* q, srsran_chest_ul_estimator_alg_t alg)
+{
+  if (q == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  if (alg == SRSRAN_CHEST_UL_ESTIMATOR_ALG_WIENER && q->wiener_ul == NULL) {
+    q->wiener_ul = calloc(sizeof(srsran_wiener_ul_t), 1);
+    if (q->wiener_ul == NULL) {
+      ERROR("Error allocating wiener filter");
+      return SRSRAN_ERROR;
+    }
+    if (srsran_wiener_ul_init(q->wiener_ul, q->max_prb) < SRSRAN_SUCCESS) {
+      ERROR("Error initialising wiener filter");
+      free(q->wiener_ul);
+      q->wiener_ul = NULL;
+      return SRSRAN_ERROR;
+    }
+  }
+
+  q->estimator_alg = alg;
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_chest_ul_str2estimator_alg(const char* str, srsran_chest_ul_estimator_alg_t* alg)
+{
+  if (str == NULL || alg == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  if (strcmp(str, "average") == 0) {
+    *alg = SRSRAN_CHEST_UL_ESTIMATOR_ALG_AVERAGE;
+  } else if (strcmp(str, "wiener") == 0) {
+    *alg = SRSRAN_CHEST_UL_ESTIMATOR_ALG_WIENER;
+  } else {
+    ERROR("Invalid PUSCH estimator algorithm \"%s\"", str);
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 void srsran_chest_ul_pregen(srsran_chest_ul_t*                 q,
                             srsran_refsignal_dmrs_pusch_cfg_t* cfg,
                             srsran_refsignal_srs_cfg_t*        srs_cfg)
@@ -331,12 +389,19 @@ static void chest_ul_estimate(srsran_chest_ul_t*     q,
   }
 
   if (res->ce != NULL) {
-    if (q->smooth_filter_len > 0) {
-      average_pilots(q, q->pilot_estimates, res->ce, nslots, nrefs_sym, n_prb);
-
-      if (write_estimates) {
-        interpolate_pilots(q, res->ce, nslots, nrefs_sym, n_prb);
+    if (q->estimator_alg == SRSRAN_CHEST_UL_ESTIMATOR_ALG_WIENER && q->wiener_ul != NULL && write_estimates) {
+      // Wiener filter, it measures the noise from the correlation between adjacent estimates
+      res->noise_estimate = 0.0f;
+      for (int i = 0; i < nslots; i++) {
+        srsran_wiener_ul_run(
+            q->wiener_ul,
+            &q->pilot_estimates[i * nrefs_sym],
+            &res->ce[SRSRAN_REFSIGNAL_UL_L(i, q->cell.cp) * q->cell.nof_prb * SRSRAN_NRE + n_prb[i] * SRSRAN_NRE],
+            nrefs_sym);
+        res->noise_estimate += q->wiener_ul->noise / nslots;
       }
+    } else if (q->smooth_filter_len > 0) {
+      average_pilots(q, q->pilot_estimates, res->ce, nslots, nrefs_sym, n_prb);
 
       // If averaging, compute noise from difference between received and averaged estimates
       res->noise_estimate = estimate_noise_pilots(q, res->ce, nslots, nrefs_sym, n_prb);
@@ -348,11 +413,12 @@ static void chest_ul_estimate(srsran_chest_ul_t*     q,
             &q->pilot_estimates[i * nrefs_sym],
             nrefs_sym);
       }
-      if (write_estimates) {
-        interpolate_pilots(q, res->ce, nslots, nrefs_sym, n_prb);
-      }
       res->noise_estimate = 0;
     }
+
+    if (write_estimates) {
+      interpolate_pilots(q, res->ce, nslots, nrefs_sym, n_prb);
+    }
   }
 
   // Measure reference signal RE average power
@@ -624,3 +690,201 @@ int srsran_chest_ul_estimate_srs(srsran_chest_ul_t*                 q,
 
   return SRSRAN_SUCCESS;
 }
+
+// Every cyclic shift takes 1/8 of the delay domain, the channel of a UE is kept from a few samples before its shift
+// (timing error) to half of the window. The rest of the windows only carry noise.
+#define SRS_NOF_CS 8
+#define SRS_WINDOW_PRE(W) ((W) / 8)
+#define SRS_WINDOW_POST(W) (((W) + 1) / 2)
+#define SRS_MIN_SNR 1e-3f
+
+// The noise is measured on the Hann windowed comb, its main lobe spreads every path over this many samples aside
+#define SRS_NOISE_GUARD 2
+
+static bool srs_is_signal_bin(uint32_t m, uint32_t M, uint32_t cs_mask, uint32_t guard)
+{
+  uint32_t W   = M / SRS_NOF_CS;
+  uint32_t len = SRS_WINDOW_PRE(W) + SRS_WINDOW_POST(W) + 2 * guard;
+  uint32_t s   = (m + SRS_WINDOW_PRE(W) + guard) % M;
+
+  // Cyclic shift n_cs appears at delay bin (M - n_cs * W) mod M, the guard can reach the next shift window
+  uint32_t n_cs = (SRS_NOF_CS - s / W) % SRS_NOF_CS;
+  if (((cs_mask >> n_cs) & 1U) && s % W < len) {
+    return true;
+  }
+  n_cs = (n_cs + 1) % SRS_NOF_CS;
+  return ((cs_mask >> n_cs) & 1U) && s % W + W < len;
+}
+
+// Averages the power of the delay bins out of the UE windows and their guards, it returns zero if there are none
+static float srs_noise_bins_pwr(const cf_t* cir, uint32_t M, uint32_t cs_mask, uint32_t guard)
+{
+  float    pwr      = 0.0f;
+  uint32_t nof_bins = 0;
+  for (uint32_t m = 0; m < M; m++) {
+    if (!srs_is_signal_bin(m, M, cs_mask, guard)) {
+      pwr += __real__ cir[m] * __real__ cir[m] + __imag__ cir[m] * __imag__ cir[m];
+      nof_bins++;
+    }
+  }
+  return (nof_bins > 0) ? pwr / (float)nof_bins : 0.0f;
+}
+
+// The truncated delay response of paths between samples leaks far beyond the UE window, well above the noise of a wide
+// SRS. The Hann window sidelobes decay fast enough to measure the noise in between cyclic shifts. Narrow SRS with most
+// of the shifts in use do not leave room for its main lobe, they measure the leakage and noise of the plain response.
+static float chest_ul_srs_noise(srsran_chest_ul_t*                   q,
+                                const srsran_dft_mixed_radix_plan_t* plan,
+                                const cf_t*                          pilots,
+                                const cf_t*                          cir,
+                                uint32_t                             M,
+                                uint32_t                             cs_mask)
+{
+  cf_t* windowed     = q->pilot_estimates_tmp[1];
+  cf_t* windowed_cir = q->pilot_estimates_tmp[2];
+  cf_t* scratch      = q->pilot_estimates_tmp[3];
+
+  if (q->srs_window_len != M) {
+    q->srs_window_pwr = 0.0f;
+    for (uint32_t n = 0; n < M; n++) {
+      q->srs_window[n] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * ((float)n + 0.5f) / (float)M);
+      q->srs_window_pwr += q->srs_window[n] * q->srs_window[n];
+    }
+    q->srs_window_len = M;
+  }
+
+  srsran_vec_prod_cfc(pilots, q->srs_window, windowed, M);
+  srsran_dft_mixed_radix_run(plan, windowed, windowed_cir, scratch, SRSRAN_DFT_BACKWARD, 1.0f / (float)M);
+
+  // Every bin holds sum(w^2)/M^2 of the noise power per subcarrier
+  float noise = srs_noise_bins_pwr(windowed_cir, M, cs_mask, SRS_NOISE_GUARD) * (float)(M * M) / q->srs_window_pwr;
+
+  if (!isnormal(noise)) {
+    // Every bin holds 1/M of the noise power per subcarrier
+    noise = srs_noise_bins_pwr(cir, M, cs_mask, 0) * (float)M;
+  }
+
+  return isnormal(noise) ? noise : FLT_MIN;
+}
+
+// Estimates every UE sounding the same comb and bandwidth than cfg[first], the ones already estimated are skipped
+static int chest_ul_estimate_srs_group(srsran_chest_ul_t*                 q,
+                                       srsran_ul_sf_cfg_t*                sf,
+                                       srsran_refsignal_srs_cfg_t*        cfg,
+                                       srsran_refsignal_dmrs_pusch_cfg_t* pusch_cfg,
+                                       cf_t*                              input,
+                                       srsran_chest_ul_srs_res_t*         res,
+                                       uint32_t                           first,
+                                       uint32_t                           nof_cfg)
+{
+  uint32_t k0 = srsran_refsignal_srs_k0(&q->dmrs_signal, &cfg[first], sf->tti);
+  uint32_t M  = srsran_refsignal_srs_M_sc(&q->dmrs_signal, &cfg[first]);
+  uint32_t W  = M / SRS_NOF_CS;
+
+  const srsran_dft_mixed_radix_plan_t* plan = srsran_dft_mixed_radix_get_plan(M);
+  if (plan == NULL || M == 0 || k0 + 2 * (M - 1) >= NOF_REFS_SYM) {
+    ERROR("Invalid SRS allocation k0=%d; M_sc=%d", k0, M);
+    return SRSRAN_ERROR;
+  }
+
+  // Cyclic shifts used in the group
+  uint32_t cs_mask = 0;
+  for (uint32_t i = first; i < nof_cfg; i++) {
+    if (res[i].nof_sb == 0 && cfg[i].n_srs < SRS_NOF_CS &&
+        srsran_refsignal_srs_k0(&q->dmrs_signal, &cfg[i], sf->tti) == k0 &&
+        srsran_refsignal_srs_M_sc(&q->dmrs_signal, &cfg[i]) == M) {
+      cs_mask |= 1U << cfg[i].n_srs;
+    }
+  }
+
+  // Extract the comb and remove the base sequence, all cyclic shifts share it
+  srsran_refsignal_srs_cfg_t base_cfg = cfg[first];
+  base_cfg.n_srs                      = 0;
+  if (srsran_refsignal_srs_get(&q->dmrs_signal, &base_cfg, sf->tti, q->pilot_recv_signal, input) ||
+      srsran_refsignal_srs_gen(
+          &q->dmrs_signal, &base_cfg, pusch_cfg, sf->tti % SRSRAN_NOF_SF_X_FRAME, q->pilot_known_signal)) {
+    return SRSRAN_ERROR;
+  }
+  srsran_vec_prod_conj_ccc(q->pilot_recv_signal, q->pilot_known_signal, q->pilot_estimates, M);
+
+  // Transform to delay domain, every cyclic shift lands in its own window
+  cf_t* cir     = q->pilot_estimates_tmp[0];
+  cf_t* win     = q->pilot_estimates_tmp[1];
+  cf_t* ce      = q->pilot_estimates_tmp[2];
+  cf_t* scratch = q->pilot_estimates_tmp[3];
+  srsran_dft_mixed_radix_run(plan, q->pilot_estimates, cir, scratch, SRSRAN_DFT_BACKWARD, 1.0f / (float)M);
+
+  float noise = chest_ul_srs_noise(q, plan, q->pilot_estimates, cir, M, cs_mask);
+
+  // Noise power left in the estimates after windowing
+  uint32_t L        = SRS_WINDOW_PRE(W) + SRS_WINDOW_POST(W);
+  float    ce_noise = noise * (float)L / (float)M;
+
+  for (uint32_t i = first; i < nof_cfg; i++) {
+    if (res[i].nof_sb != 0 || cfg[i].n_srs >= SRS_NOF_CS ||
+        srsran_refsignal_srs_k0(&q->dmrs_signal, &cfg[i], sf->tti) != k0 ||
+        srsran_refsignal_srs_M_sc(&q->dmrs_signal, &cfg[i]) != M) {
+      continue;
+    }
+
+    // Window the cyclic shift and move it to zero delay
+    uint32_t c = (M - cfg[i].n_srs * W) % M;
+    srsran_vec_cf_zero(win, M);
+    for (uint32_t l = 0; l < L; l++) {
+      uint32_t t = (M + l - SRS_WINDOW_PRE(W)) % M;
+      win[t]     = cir[(c + t) % M];
+    }
+    srsran_dft_mixed_radix_run(plan, win, ce, scratch, SRSRAN_DFT_FORWARD, 1.0f);
+
+    // Subband and wideband SINR, a subband takes SRSRAN_CHEST_UL_SRS_SB_PRB * SRSRAN_NRE / 2 subcarriers of the comb
+    uint32_t sb_len = SRSRAN_CHEST_UL_SRS_SB_PRB * SRSRAN_NRE / 2;
+    float    rsrp   = 0.0f;
+    res[i].nof_sb   = M / sb_len;
+    for (uint32_t sb = 0; sb < res[i].nof_sb; sb++) {
+      float pwr = srsran_vec_avg_power_cf(&ce[sb * sb_len], sb_len) - ce_noise;
+      pwr       = SRSRAN_MAX(pwr, noise * SRS_MIN_SNR);
+      rsrp += pwr / (float)res[i].nof_sb;
+      res[i].sb_snr_db[sb] = srsran_convert_power_to_dB(pwr / noise);
+    }
+
+    res[i].prb_start      = (k0 - cfg[i].k_tc) / SRSRAN_NRE;
+    res[i].noise_estimate = noise;
+    res[i].rsrp           = rsrp;
+    res[i].rsrp_dBfs      = srsran_convert_power_to_dB(rsrp);
+    res[i].snr            = rsrp / noise;
+    res[i].snr_db         = srsran_convert_power_to_dB(res[i].snr);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_chest_ul_estimate_srs_multi(srsran_chest_ul_t*                 q,
+                                       srsran_ul_sf_cfg_t*                sf,
+                                       srsran_refsignal_srs_cfg_t*        cfg,
+                                       srsran_refsignal_dmrs_pusch_cfg_t* pusch_cfg,
+                                       cf_t*                              input,
+                                       srsran_chest_ul_srs_res_t*         res,
+                                       uint32_t                           nof_cfg)
+{
+  if (q == NULL || sf == NULL || pusch_cfg == NULL || input == NULL || (nof_cfg > 0 && (cfg == NULL || res == NULL))) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // A result with no subbands has not been estimated yet
+  for (uint32_t i = 0; i < nof_cfg; i++) {
+    bzero(&res[i], sizeof(srsran_chest_ul_srs_res_t));
+  }
+
+  int ret = SRSRAN_SUCCESS;
+  for (uint32_t i = 0; i < nof_cfg; i++) {
+    if (res[i].nof_sb != 0) {
+      continue;
+    }
+    if (cfg[i].n_srs >= SRS_NOF_CS ||
+        chest_ul_estimate_srs_group(q, sf, cfg, pusch_cfg, input, res, i, nof_cfg) < SRSRAN_SUCCESS) {
+      ret = SRSRAN_ERROR;
+    }
+  }
+
+  return ret;
+}
@@ -428,6 +428,83 @@ uint32_t srsran_refsignal_dmrs_pucch_symbol(uint32_t m, srsran_pucch_format_t fo
   return 0;
 }
 
+/* Computes the cyclic shift and orthogonal sequence of the PUCCH DMRS according to 5.5.2.2 in 36.211 */
+int srsran_refsignal_dmrs_pucch_cs(srsran_cp_t         cp,
+                                   const uint32_t      n_cs_cell[SRSRAN_NSLOTS_X_FRAME][SRSRAN_CP_NORM_NSYMB],
+                                   srsran_ul_sf_cfg_t* sf,
+                                   srsran_pucch_cfg_t* cfg,
+                                   uint32_t            n_cs[SRSRAN_NOF_SLOTS_PER_SF][SRSRAN_REFSIGNAL_PUCCH_MAX_N_RS],
+                                   cf_t                z[SRSRAN_NOF_SLOTS_PER_SF][SRSRAN_REFSIGNAL_PUCCH_MAX_N_RS])
+{
+  if (sf == NULL || cfg == NULL || n_cs == NULL || z == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t N_rs = srsran_refsignal_dmrs_N_rs(cfg->format, cp);
+  if (N_rs == 0 || N_rs > SRSRAN_REFSIGNAL_PUCCH_MAX_N_RS) {
+    return SRSRAN_ERROR;
+  }
+
+  uint32_t sf_idx = sf->tti % 10;
+
+  cf_t z_m_1 = 1.0;
+  if (cfg->format == SRSRAN_PUCCH_FORMAT_2A || cfg->format == SRSRAN_PUCCH_FORMAT_2B) {
+    srsran_pucch_format2ab_mod_bits(cfg->format, cfg->pucch2_drs_bits, &z_m_1);
+  }
+
+  for (uint32_t ns = 2 * sf_idx; ns < 2 * (sf_idx + 1); ns++) {
+    for (uint32_t m = 0; m < N_rs; m++) {
+      uint32_t n_oc = 0;
+
+      uint32_t l = srsran_refsignal_dmrs_pucch_symbol(m, cfg->format, cp);
+      // Add cyclic prefix alpha
+      float alpha = 0.0;
+      if (cfg->format < SRSRAN_PUCCH_FORMAT_2) {
+        alpha = srsran_pucch_alpha_format1(n_cs_cell, cfg, cp, true, ns, l, &n_oc, NULL);
+      } else {
+        alpha = srsran_pucch_alpha_format2(n_cs_cell, cfg, ns, l);
+      }
+
+      // Choose number of symbols and orthogonal sequence from Tables 5.5.2.2.1-1 to -3
+      const float* w = NULL;
+      switch (cfg->format) {
+        case SRSRAN_PUCCH_FORMAT_1:
+        case SRSRAN_PUCCH_FORMAT_1A:
+        case SRSRAN_PUCCH_FORMAT_1B:
+          if (SRSRAN_CP_ISNORM(cp)) {
+            w = w_arg_pucch_format1_cpnorm[n_oc];
+          } else {
+            w = w_arg_pucch_format1_cpext[n_oc];
+          }
+          break;
+        case SRSRAN_PUCCH_FORMAT_2:
+        case SRSRAN_PUCCH_FORMAT_3:
+          if (SRSRAN_CP_ISNORM(cp)) {
+            w = w_arg_pucch_format2_cpnorm;
+          } else {
+            w = w_arg_pucch_format2_cpext;
+          }
+          break;
+        case SRSRAN_PUCCH_FORMAT_2A:
+        case SRSRAN_PUCCH_FORMAT_2B:
+          w = w_arg_pucch_format2_cpnorm;
+          break;
+        default:
+          ERROR("DMRS Generator: Unsupported format %d", cfg->format);
+          return SRSRAN_ERROR;
+      }
+
+      n_cs[ns % 2][m] = (uint32_t)roundf(alpha * SRSRAN_NRE / (2.0f * (float)M_PI)) % SRSRAN_NRE;
+      z[ns % 2][m]    = cexpf(I * w[m]);
+      if (m == 1) {
+        z[ns % 2][m] *= z_m_1;
+      }
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 /* Generates DMRS for PUCCH according to 5.5.2.2 in 36.211 */
 int srsran_refsignal_dmrs_pucch_gen(srsran_refsignal_ul_t* q,
                                     srsran_ul_sf_cfg_t*    sf,
@@ -440,13 +517,14 @@ int srsran_refsignal_dmrs_pucch_gen(srsran_refsignal_ul_t* q,
 
     uint32_t N_rs = srsran_refsignal_dmrs_N_rs(cfg->format, q->cell.cp);
 
-    uint32_t sf_idx = sf->tti % 10;
-
-    cf_t z_m_1 = 1.0;
-    if (cfg->format == SRSRAN_PUCCH_FORMAT_2A || cfg->format == SRSRAN_PUCCH_FORMAT_2B) {
-      srsran_pucch_format2ab_mod_bits(cfg->format, cfg->pucch2_drs_bits, &z_m_1);
+    uint32_t n_cs[SRSRAN_NOF_SLOTS_PER_SF][SRSRAN_REFSIGNAL_PUCCH_MAX_N_RS] = {};
+    cf_t     z[SRSRAN_NOF_SLOTS_PER_SF][SRSRAN_REFSIGNAL_PUCCH_MAX_N_RS]    = {};
+    if (srsran_refsignal_dmrs_pucch_cs(q->cell.cp, q->n_cs_cell, sf, cfg, n_cs, z) < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
     }
 
+    uint32_t sf_idx = sf->tti % 10;
+
     for (uint32_t ns = 2 * sf_idx; ns < 2 * (sf_idx + 1); ns++) {
       // Get group hopping number u
       uint32_t f_gh = 0;
@@ -456,54 +534,10 @@ int srsran_refsignal_dmrs_pucch_gen(srsran_refsignal_ul_t* q,
       uint32_t u = (f_gh + (q->cell.id % 30)) % 30;
 
       for (uint32_t m = 0; m < N_rs; m++) {
-        uint32_t n_oc = 0;
-
-        uint32_t l = srsran_refsignal_dmrs_pucch_symbol(m, cfg->format, q->cell.cp);
-        // Add cyclic prefix alpha
-        float alpha = 0.0;
-        if (cfg->format < SRSRAN_PUCCH_FORMAT_2) {
-          alpha = srsran_pucch_alpha_format1(q->n_cs_cell, cfg, q->cell.cp, true, ns, l, &n_oc, NULL);
-        } else {
-          alpha = srsran_pucch_alpha_format2(q->n_cs_cell, cfg, ns, l);
-        }
-
-        // Choose number of symbols and orthogonal sequence from Tables 5.5.2.2.1-1 to -3
-        const float* w = NULL;
-        switch (cfg->format) {
-          case SRSRAN_PUCCH_FORMAT_1:
-          case SRSRAN_PUCCH_FORMAT_1A:
-          case SRSRAN_PUCCH_FORMAT_1B:
-            if (SRSRAN_CP_ISNORM(q->cell.cp)) {
-              w = w_arg_pucch_format1_cpnorm[n_oc];
-            } else {
-              w = w_arg_pucch_format1_cpext[n_oc];
-            }
-            break;
-          case SRSRAN_PUCCH_FORMAT_2:
-          case SRSRAN_PUCCH_FORMAT_3:
-            if (SRSRAN_CP_ISNORM(q->cell.cp)) {
-              w = w_arg_pucch_format2_cpnorm;
-            } else {
-              w = w_arg_pucch_format2_cpext;
-            }
-            break;
-          case SRSRAN_PUCCH_FORMAT_2A:
-          case SRSRAN_PUCCH_FORMAT_2B:
-            w = w_arg_pucch_format2_cpnorm;
-            break;
-          default:
-            ERROR("DMRS Generator: Unsupported format %d", cfg->format);
-            return SRSRAN_ERROR;
-        }
-
         cf_t* r_sequence = &r_pucch[(ns % 2) * SRSRAN_NRE * N_rs + m * SRSRAN_NRE];
+        float alpha      = 2 * M_PI * n_cs[ns % 2][m] / SRSRAN_NRE;
         srsran_zc_sequence_generate_lte(u, 0, alpha, 1, r_sequence);
-
-        cf_t z_m = cexpf(I * w[m]);
-        if (m == 1) {
-          z_m *= z_m_1;
-        }
-        srsran_vec_sc_prod_ccc(r_sequence, z_m, r_sequence, SRSRAN_NRE);
+        srsran_vec_sc_prod_ccc(r_sequence, z[ns % 2][m], r_sequence, SRSRAN_NRE);
       }
     }
     ret = SRSRAN_SUCCESS;
@@ -829,6 +863,12 @@ uint32_t srsran_refsignal_srs_M_sc(srsran_refsignal_ul_t* q, srsran_refsignal_sr
   return m_srs_b[srsbwtable_idx(q->cell.nof_prb)][cfg->B][cfg->bw_cfg] * SRSRAN_NRE / 2;
 }
 
+/* Returns the first subcarrier of the SRS, including the transmission comb */
+uint32_t srsran_refsignal_srs_k0(srsran_refsignal_ul_t* q, srsran_refsignal_srs_cfg_t* cfg, uint32_t tti)
+{
+  return srs_k0_ue(cfg, q->cell.nof_prb, tti);
+}
+
 int srsran_refsignal_srs_pregen(srsran_refsignal_ul_t*             q,
                                 srsran_refsignal_srs_pregen_t*     pregen,
                                 srsran_refsignal_srs_cfg_t*        cfg,
@@ -36,10 +36,11 @@ srsran_cell_t cell = {6,              // nof_prb
                       SRSRAN_FDD};
 
 char* output_matlab = NULL;
+bool  incremental   = false;
 
 void usage(char* prog)
 {
-  printf("Usage: %s [recov]\n", prog);
+  printf("Usage: %s [recoiv]\n", prog);
 
   printf("\t-r nof_prb [Default %d]\n", cell.nof_prb);
   printf("\t-e extended cyclic prefix [Default normal]\n");
@@ -47,13 +48,14 @@ void usage(char* prog)
   printf("\t-c cell_id (1000 tests all). [Default %d]\n", cell.id);
 
   printf("\t-o output matlab file [Default %s]\n", output_matlab ? output_matlab : "None");
+  printf("\t-i enable incremental estimation [Default %s]\n", incremental ? "enabled" : "disabled");
   printf("\t-v increase verbosity\n");
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "recov")) != -1) {
+  while ((opt = getopt(argc, argv, "recoiv")) != -1) {
     switch (opt) {
       case 'r':
         cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -67,6 +69,9 @@ void parse_args(int argc, char** argv)
       case 'o':
         output_matlab = argv[optind];
         break;
+      case 'i':
+        incremental = true;
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -77,6 +82,127 @@ void parse_args(int argc, char** argv)
   }
 }
 
+#define TIME_FILTER_NOF_SF 40
+#define TIME_FILTER_STEP_SF 20 // Subframe in which the channel phase jumps
+#define TIME_FILTER_GAP_SF 30  // Subframe received after a gap well beyond the incremental state lifetime
+
+static float chest_mse(const cf_t* ce, const cf_t* h, uint32_t nof_re)
+{
+  float mse = 0.0f;
+  for (uint32_t i = 0; i < nof_re; i++) {
+    float err = cabsf(ce[i] - h[i]);
+    mse += err * err;
+  }
+  return mse / nof_re;
+}
+
+/* Estimates a static noisy channel with and without the incremental time filter. The filtered estimate must have a
+ * lower MSE, and the filter must restart, giving the same estimate as the non-incremental mode, after a phase step
+ * and after a gap in the received subframes */
+static int test_time_filter()
+{
+  int                   ret    = SRSRAN_ERROR;
+  uint32_t              nof_re = SRSRAN_NOF_RE(cell);
+  srsran_chest_dl_t     est_incr, est_ref;
+  srsran_chest_dl_res_t res_incr, res_ref;
+  srsran_channel_awgn_t awgn;
+  srsran_chest_dl_cfg_t cfg_incr, cfg_ref;
+  cf_t*                 tx           = srsran_vec_cf_malloc(nof_re);
+  cf_t*                 rx           = srsran_vec_cf_malloc(nof_re);
+  cf_t*                 h            = srsran_vec_cf_malloc(nof_re);
+  float                 mse_incr_avg = 0.0f, mse_ref_avg = 0.0f;
+  uint32_t              tti          = 0;
+  ZERO_OBJECT(cfg_incr);
+  ZERO_OBJECT(cfg_ref);
+
+  if (!tx || !rx || !h || srsran_chest_dl_init(&est_incr, cell.nof_prb, 1) ||
+      srsran_chest_dl_init(&est_ref, cell.nof_prb, 1) || srsran_chest_dl_res_init(&res_incr, cell.nof_prb) ||
+      srsran_chest_dl_res_init(&res_ref, cell.nof_prb) || srsran_channel_awgn_init(&awgn, 1234) ||
+      srsran_chest_dl_set_cell(&est_incr, cell) || srsran_chest_dl_set_cell(&est_ref, cell)) {
+    ERROR("Error initializing time filter test");
+    return SRSRAN_ERROR;
+  }
+  srsran_channel_awgn_set_n0(&awgn, 0.0f);
+
+  // A fixed smoothing filter keeps the estimates independent of the tracked noise
+  cfg_ref.filter_type         = SRSRAN_CHEST_FILTER_TRIANGLE;
+  cfg_ref.filter_coef[0]      = 0.1f;
+  cfg_incr                    = cfg_ref;
+  cfg_incr.incremental_enable = true;
+  cfg_incr.incremental_alpha  = 0.5f;
+  cfg_incr.incremental_period = 5;
+
+  for (uint32_t sf = 0; sf < TIME_FILTER_NOF_SF; sf++, tti++) {
+    float phase = (sf < TIME_FILTER_STEP_SF) ? 0.0f : M_PI / 2;
+    if (sf == TIME_FILTER_GAP_SF) {
+      tti += 4 * SRSRAN_NOF_SF_X_FRAME;
+    }
+
+    srsran_dl_sf_cfg_t sf_cfg;
+    ZERO_OBJECT(sf_cfg);
+    sf_cfg.tti = tti % 10240;
+
+    for (uint32_t i = 0; i < nof_re; i++) {
+      tx[i] = ((rand() & 1) ? M_SQRT1_2 : -M_SQRT1_2) + I * ((rand() & 1) ? M_SQRT1_2 : -M_SQRT1_2);
+    }
+    srsran_refsignal_cs_put_sf(&est_ref.csr_refs, &sf_cfg, 0, tx);
+    for (uint32_t l = 0; l < 2 * SRSRAN_CP_NSYMB(cell.cp); l++) {
+      for (uint32_t k = 0; k < cell.nof_prb * SRSRAN_NRE; k++) {
+        float x = cosf(2 * M_PI * (float)k / cell.nof_prb / SRSRAN_NRE);
+        h[l * cell.nof_prb * SRSRAN_NRE + k] = (2 + x / 2) * cexpf(I * (x / 2 + phase));
+      }
+    }
+    srsran_vec_prod_ccc(tx, h, rx, nof_re);
+    srsran_channel_awgn_run_c(&awgn, rx, rx, nof_re);
+
+    cf_t* rx_m[SRSRAN_MAX_PORTS] = {rx};
+    if (srsran_chest_dl_estimate_cfg(&est_incr, &sf_cfg, &cfg_incr, rx_m, &res_incr) ||
+        srsran_chest_dl_estimate_cfg(&est_ref, &sf_cfg, &cfg_ref, rx_m, &res_ref)) {
+      ERROR("Error estimating channel");
+      goto clean_exit;
+    }
+
+    float mse_incr = chest_mse(res_incr.ce[0][0], h, nof_re);
+    float mse_ref  = chest_mse(res_ref.ce[0][0], h, nof_re);
+    float diff     = chest_mse(res_incr.ce[0][0], res_ref.ce[0][0], nof_re);
+    INFO("sf=%d; tti=%d; mse_incr=%f; mse_ref=%f; diff=%f", sf, sf_cfg.tti, mse_incr, mse_ref, diff);
+
+    // The first subframe and the ones after a phase step or a gap restart the filter
+    bool restart = (sf == 0 || sf == TIME_FILTER_STEP_SF || sf == TIME_FILTER_GAP_SF);
+    if (restart != (diff == 0.0f)) {
+      ERROR("Time filter %s in sf=%d", restart ? "did not restart" : "restarted", sf);
+      goto clean_exit;
+    }
+
+    // Average once the filter has converged
+    if (sf >= TIME_FILTER_STEP_SF / 2 && sf < TIME_FILTER_STEP_SF) {
+      mse_incr_avg += mse_incr;
+      mse_ref_avg += mse_ref;
+    }
+  }
+
+  printf("Time filter MSE: incremental=%f; reference=%f\n", mse_incr_avg, mse_ref_avg);
+
+  // The EMA with alpha 0.5 reduces the pilot noise power to a third, require at least 3 dB
+  if (mse_incr_avg > 0.5f * mse_ref_avg) {
+    ERROR("Time filter did not improve the MSE");
+    goto clean_exit;
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_chest_dl_free(&est_incr);
+  srsran_chest_dl_free(&est_ref);
+  srsran_chest_dl_res_free(&res_incr);
+  srsran_chest_dl_res_free(&res_ref);
+  srsran_channel_awgn_free(&awgn);
+  free(tx);
+  free(rx);
+  free(h);
+  return ret;
+}
+
 int main(int argc, char** argv)
 {
   srsran_chest_dl_t est;
@@ -167,17 +293,28 @@ int main(int argc, char** argv)
 
       res.ce[0][0] = ce;
 
+      srsran_chest_dl_cfg_t chest_cfg;
+      ZERO_OBJECT(chest_cfg);
+      chest_cfg.incremental_enable = incremental;
+      chest_cfg.incremental_alpha  = 0.5f;
+      chest_cfg.incremental_period = 5;
+
       cf_t* input_m[SRSRAN_MAX_PORTS];
       input_m[0] = input;
 
       struct timeval t[3];
       gettimeofday(&t[1], NULL);
       for (int k = 0; k < 100; k++) {
-        srsran_chest_dl_estimate(&est, &sf_cfg, input_m, &res);
+        srsran_chest_dl_estimate_cfg(&est, &sf_cfg, &chest_cfg, input_m, &res);
       }
       gettimeofday(&t[2], NULL);
       get_time_interval(t);
-      printf("CHEST: %f us\n", (float)t[0].tv_usec / 100);
+      printf("CHEST: %f us; reuse=%.0f%%\n", (float)t[0].tv_usec / 100, res.reuse_ratio * 100.0f);
+
+      // The incremental estimation measures the noise and RSSI only once every incremental period
+      if (incremental && res.reuse_ratio <= 0.0f) {
+        goto do_exit;
+      }
 
       gettimeofday(&t[1], NULL);
       for (int k = 0; k < 100; k++) {
@@ -229,6 +366,10 @@ int main(int argc, char** argv)
     INFO("cid=%d", cid);
   }
   srsran_chest_dl_free(&est);
+
+  if (incremental && test_time_filter() < SRSRAN_SUCCESS) {
+    goto do_exit;
+  }
   ret = 0;
 
 do_exit:
@@ -0,0 +1,256 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include "srsran/srsran.h"
+#include "srsran/support/srsran_test.h"
+#include <complex.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static srsran_cell_t cell = {50,             // nof_prb
+                             1,              // nof_ports
+                             1,              // cell_id
+                             SRSRAN_CP_NORM, // cyclic prefix
+                             SRSRAN_PHICH_NORM,
+                             SRSRAN_PHICH_R_1, // PHICH length
+                             SRSRAN_FDD};
+
+static uint32_t bw_cfg        = 0;
+static uint32_t nof_ue        = 8;
+static float    snr_db        = 15.0f;
+static uint32_t nof_subframes = 20;
+
+// RMS error tolerances of the estimated SINR, subbands are only checked above the minimum SINR
+#define SRS_MULTI_WB_TOLERANCE_DB 1.0f
+#define SRS_MULTI_SB_TOLERANCE_DB 1.5f
+#define SRS_MULTI_SB_MIN_SNR_DB 5.0f
+
+void usage(char* prog)
+{
+  printf("Usage: %s [rbusnv]\n", prog);
+  printf("\t-r cell nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-b SRS bandwidth configuration [Default %d]\n", bw_cfg);
+  printf("\t-u number of UEs, up to 16 [Default %d]\n", nof_ue);
+  printf("\t-s SNR in dB [Default %.1f]\n", snr_db);
+  printf("\t-n number of subframes [Default %d]\n", nof_subframes);
+  printf("\t-v increase verbosity\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "rbusnv")) != -1) {
+    switch (opt) {
+      case 'r':
+        cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'b':
+        bw_cfg = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'u':
+        nof_ue = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'n':
+        nof_subframes = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Two tap channel with a random timing offset, unit average power
+static void gen_channel(srsran_random_t random, cf_t* h, uint32_t nof_re)
+{
+  float delay_us[2] = {srsran_random_uniform_real_dist(random, -0.2f, 0.8f), 0.0f};
+  float amp[2]      = {sqrtf(2.0f / 3.0f), sqrtf(1.0f / 3.0f)};
+  delay_us[1]       = delay_us[0] + 1.0f;
+
+  srsran_vec_cf_zero(h, nof_re);
+  for (uint32_t l = 0; l < 2; l++) {
+    cf_t a = amp[l] * cexpf(I * srsran_random_uniform_real_dist(random, -M_PI, M_PI));
+    for (uint32_t k = 0; k < nof_re; k++) {
+      h[k] += a * cexpf(-I * 2.0f * (float)M_PI * (float)k * 15e3f * delay_us[l] * 1e-6f);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  if (nof_ue == 0 || nof_ue > 16) {
+    ERROR("Invalid number of UEs %d", nof_ue);
+    return SRSRAN_ERROR;
+  }
+
+  srsran_random_t           random   = srsran_random_init(0x1234);
+  srsran_chest_ul_t         chest    = {};
+  srsran_chest_ul_res_t     res_ue   = {};
+  srsran_refsignal_ul_t     refsig   = {};
+  srsran_ul_sf_cfg_t        ul_sf    = {};
+  srsran_refsignal_srs_cfg_t cfg[16] = {};
+  srsran_chest_ul_srs_res_t res[16]  = {};
+  uint32_t                  nof_re   = cell.nof_prb * SRSRAN_NRE;
+  uint32_t                  sf_len   = SRSRAN_SF_LEN_RE(cell.nof_prb, cell.cp);
+  cf_t*                     sf_symbols = srsran_vec_cf_malloc(sf_len);
+  cf_t*                     ue_symbols = srsran_vec_cf_malloc(sf_len);
+  cf_t*                     r_srs      = srsran_vec_cf_malloc(nof_re);
+  cf_t*                     h[16]      = {};
+  TESTASSERT(sf_symbols != NULL && ue_symbols != NULL && r_srs != NULL);
+
+  TESTASSERT(srsran_chest_ul_init(&chest, cell.nof_prb) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_chest_ul_set_cell(&chest, cell) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_chest_ul_res_init(&res_ue, cell.nof_prb) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_refsignal_ul_set_cell(&refsig, cell) == SRSRAN_SUCCESS);
+
+  srsran_refsignal_dmrs_pusch_cfg_t dmrs_cfg = {};
+
+  // UEs alternate the comb and take every other cyclic shift, every SRS opportunity of the cell
+  for (uint32_t i = 0; i < nof_ue; i++) {
+    cfg[i].configured      = true;
+    cfg[i].bw_cfg          = bw_cfg;
+    cfg[i].subframe_config = 0;
+    cfg[i].I_srs           = 0;
+    cfg[i].k_tc            = i % 2;
+    cfg[i].n_srs           = (i / 2) * 2 % 8 + (i / 8);
+    h[i]                   = srsran_vec_cf_malloc(nof_re);
+    TESTASSERT(h[i] != NULL);
+  }
+
+  float    n0       = srsran_convert_dB_to_power(-snr_db);
+  double   wb_err   = 0.0;
+  double   sb_err   = 0.0;
+  uint32_t sb_count = 0;
+  uint64_t us_multi = 0;
+  uint64_t us_ue    = 0;
+  for (uint32_t n = 0; n < nof_subframes; n++) {
+    ul_sf.tti = 2 * n;
+
+    // Every UE transmits through its own channel
+    srsran_vec_cf_zero(sf_symbols, sf_len);
+    for (uint32_t i = 0; i < nof_ue; i++) {
+      gen_channel(random, h[i], nof_re);
+      srsran_vec_cf_zero(ue_symbols, sf_len);
+      TESTASSERT(srsran_refsignal_srs_gen(&refsig, &cfg[i], &dmrs_cfg, ul_sf.tti % SRSRAN_NOF_SF_X_FRAME, r_srs) ==
+                 SRSRAN_SUCCESS);
+      TESTASSERT(srsran_refsignal_srs_put(&refsig, &cfg[i], ul_sf.tti, r_srs, ue_symbols) == SRSRAN_SUCCESS);
+      cf_t* srs_symbol = &ue_symbols[SRSRAN_RE_IDX(cell.nof_prb, 2 * SRSRAN_CP_NSYMB(cell.cp) - 1, 0)];
+      srsran_vec_prod_ccc(srs_symbol, h[i], srs_symbol, nof_re);
+      srsran_vec_sum_ccc(sf_symbols, ue_symbols, sf_symbols, sf_len);
+    }
+    srsran_ch_awgn_c(sf_symbols, sf_symbols, n0, sf_len);
+
+    struct timeval t[3];
+    gettimeofday(&t[1], NULL);
+    TESTASSERT(srsran_chest_ul_estimate_srs_multi(&chest, &ul_sf, cfg, &dmrs_cfg, sf_symbols, res, nof_ue) ==
+               SRSRAN_SUCCESS);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    us_multi += t[0].tv_sec * 1000000UL + t[0].tv_usec;
+
+    // Reference, the single UE estimator
+    gettimeofday(&t[1], NULL);
+    for (uint32_t i = 0; i < nof_ue; i++) {
+      srsran_chest_ul_estimate_srs(&chest, &ul_sf, &cfg[i], &dmrs_cfg, sf_symbols, &res_ue);
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    us_ue += t[0].tv_sec * 1000000UL + t[0].tv_usec;
+
+    // Compare with the actual channel in the sounded subcarriers
+    for (uint32_t i = 0; i < nof_ue; i++) {
+      uint32_t k0     = srsran_refsignal_srs_k0(&refsig, &cfg[i], ul_sf.tti);
+      uint32_t M      = srsran_refsignal_srs_M_sc(&refsig, &cfg[i]);
+      uint32_t sb_len = SRSRAN_CHEST_UL_SRS_SB_PRB * SRSRAN_NRE / 2;
+      TESTASSERT(res[i].nof_sb == M / sb_len);
+      TESTASSERT(res[i].prb_start == k0 / SRSRAN_NRE);
+
+      float wb_pwr = 0.0f;
+      for (uint32_t sb = 0; sb < res[i].nof_sb; sb++) {
+        float sb_pwr = 0.0f;
+        for (uint32_t k = 0; k < sb_len; k++) {
+          cf_t v = h[i][k0 + 2 * (sb * sb_len + k)];
+          sb_pwr += (__real__ v * __real__ v + __imag__ v * __imag__ v) / (float)sb_len;
+        }
+        wb_pwr += sb_pwr / (float)res[i].nof_sb;
+
+        float sb_snr_db = srsran_convert_power_to_dB(sb_pwr / n0);
+        if (sb_snr_db > SRS_MULTI_SB_MIN_SNR_DB) {
+          float e = res[i].sb_snr_db[sb] - sb_snr_db;
+          sb_err += e * e;
+          sb_count++;
+        }
+      }
+      float e = res[i].snr_db - srsran_convert_power_to_dB(wb_pwr / n0);
+      wb_err += e * e;
+
+      INFO("ue=%d; k_tc=%d; n_srs=%d; prb_start=%d; nof_sb=%d; snr=%+.1f/%+.1fdB",
+           i,
+           cfg[i].k_tc,
+           cfg[i].n_srs,
+           res[i].prb_start,
+           res[i].nof_sb,
+           res[i].snr_db,
+           srsran_convert_power_to_dB(wb_pwr / n0));
+    }
+  }
+
+  printf("-- SRS multi-UE estimator. nof_prb=%d; bw_cfg=%d; nof_ue=%d; snr=%+.1fdB; subframes=%d\n",
+         cell.nof_prb,
+         bw_cfg,
+         nof_ue,
+         snr_db,
+         nof_subframes);
+  wb_err = sqrt(wb_err / (nof_ue * nof_subframes));
+  sb_err = (sb_count > 0) ? sqrt(sb_err / sb_count) : 0.0;
+  printf("   rms error: wideband=%.2fdB; subband=%.2fdB (%d subbands)\n", wb_err, sb_err, sb_count);
+  printf("   batched: %.1f us/sf; one by one: %.1f us/sf\n",
+         (double)us_multi / nof_subframes,
+         (double)us_ue / nof_subframes);
+
+  TESTASSERT(wb_err < SRS_MULTI_WB_TOLERANCE_DB);
+  TESTASSERT(sb_err < SRS_MULTI_SB_TOLERANCE_DB);
+
+  for (uint32_t i = 0; i < nof_ue; i++) {
+    free(h[i]);
+  }
+  free(sf_symbols);
+  free(ue_symbols);
+  free(r_srs);
+  srsran_chest_ul_res_free(&res_ue);
+  srsran_chest_ul_free(&chest);
+  srsran_random_free(random);
+
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,243 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/srsran.h"
+#include "srsran/support/srsran_test.h"
+#include <complex.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static srsran_cell_t cell = {50,             // nof_prb
+                             1,              // nof_ports
+                             1,              // cell_id
+                             SRSRAN_CP_NORM, // cyclic prefix
+                             SRSRAN_PHICH_NORM,
+                             SRSRAN_PHICH_R_1, // PHICH length
+                             SRSRAN_FDD};
+
+static uint32_t nof_prb         = 25;
+static float    snr_db          = 0.0f;
+static float    delay_spread_us = 1.0f;
+static uint32_t nof_subframes   = 200;
+
+// Tapped delay line resolution and length, in delay spreads
+#define TAP_SPACING_US 0.05f
+#define MAX_DELAY_SPREADS 5
+
+void usage(char* prog)
+{
+  printf("Usage: %s [rpsdnv]\n", prog);
+  printf("\t-r cell nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-p PUSCH nof_prb [Default %d]\n", nof_prb);
+  printf("\t-s SNR in dB [Default %.1f]\n", snr_db);
+  printf("\t-d RMS delay spread in us [Default %.2f]\n", delay_spread_us);
+  printf("\t-n number of subframes [Default %d]\n", nof_subframes);
+  printf("\t-v increase verbosity\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "rpsdnv")) != -1) {
+    switch (opt) {
+      case 'r':
+        cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'p':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'd':
+        delay_spread_us = strtof(argv[optind], NULL);
+        break;
+      case 'n':
+        nof_subframes = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Random exponential power delay profile channel with a random timing offset, unit average power
+static void gen_channel(srsran_random_t random, cf_t* h, uint32_t nof_re)
+{
+  uint32_t nof_taps = (uint32_t)(MAX_DELAY_SPREADS * delay_spread_us / TAP_SPACING_US) + 1;
+  float    offset   = srsran_random_uniform_real_dist(random, -0.5f, 0.5f);
+  float    norm     = 0.0f;
+  for (uint32_t l = 0; l < nof_taps; l++) {
+    norm += expf(-(float)l * TAP_SPACING_US / delay_spread_us);
+  }
+
+  srsran_vec_cf_zero(h, nof_re);
+  for (uint32_t l = 0; l < nof_taps; l++) {
+    float tau = (float)l * TAP_SPACING_US;
+    float amp = sqrtf(expf(-tau / delay_spread_us) / norm / 2.0f);
+    cf_t  a   = srsran_random_gauss_dist(random, amp) + I * srsran_random_gauss_dist(random, amp);
+    for (uint32_t k = 0; k < nof_re; k++) {
+      h[k] += a * cexpf(-I * 2.0f * (float)M_PI * (float)k * 15e3f * (tau + offset) * 1e-6f);
+    }
+  }
+}
+
+// Estimates every subframe and returns the MSE in dB, the average time per PRB is written in ns_prb
+static float run_estimator(srsran_chest_ul_t*     est,
+                           srsran_pusch_cfg_t*    cfg,
+                           cf_t**                 sf_symbols,
+                           cf_t**                 h,
+                           srsran_chest_ul_res_t* res,
+                           double*                ns_prb)
+{
+  uint32_t nof_re = nof_prb * SRSRAN_NRE;
+  double   err    = 0.0;
+  double   pwr    = 0.0;
+  uint64_t us     = 0;
+
+  for (uint32_t n = 0; n < nof_subframes; n++) {
+    srsran_ul_sf_cfg_t ul_sf = {};
+    ul_sf.tti                = n;
+
+    struct timeval t[3];
+    gettimeofday(&t[1], NULL);
+    srsran_chest_ul_estimate_pusch(est, &ul_sf, cfg, sf_symbols[n], res);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    us += t[0].tv_sec * 1000000UL + t[0].tv_usec;
+
+    for (uint32_t l = 0; l < SRSRAN_CP_NORM_SF_NSYMB; l++) {
+      cf_t* ce = &res->ce[SRSRAN_RE_IDX(cell.nof_prb, l, cfg->grant.n_prb[0] * SRSRAN_NRE)];
+      for (uint32_t k = 0; k < nof_re; k++) {
+        cf_t e = ce[k] - h[n][k];
+        err += __real__ e * __real__ e + __imag__ e * __imag__ e;
+        pwr += __real__ h[n][k] * __real__ h[n][k] + __imag__ h[n][k] * __imag__ h[n][k];
+      }
+    }
+  }
+
+  *ns_prb = 1e3 * (double)us / (double)(nof_subframes * nof_prb);
+
+  return srsran_convert_power_to_dB((float)(err / pwr));
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  if (!srsran_dft_precoding_valid_prb(nof_prb) || nof_prb > cell.nof_prb) {
+    ERROR("Invalid PUSCH nof_prb=%d", nof_prb);
+    return SRSRAN_ERROR;
+  }
+
+  srsran_random_t       random      = srsran_random_init(0x1234);
+  srsran_chest_ul_t     est_average = {};
+  srsran_chest_ul_t     est_wiener  = {};
+  srsran_chest_ul_res_t res         = {};
+  cf_t*                 sf_symbols[nof_subframes];
+  cf_t*                 h[nof_subframes];
+
+  TESTASSERT(srsran_chest_ul_init(&est_average, cell.nof_prb) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_chest_ul_init(&est_wiener, cell.nof_prb) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_chest_ul_set_cell(&est_average, cell) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_chest_ul_set_cell(&est_wiener, cell) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_chest_ul_set_estimator_alg(&est_wiener, SRSRAN_CHEST_UL_ESTIMATOR_ALG_WIENER) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_chest_ul_res_init(&res, cell.nof_prb) == SRSRAN_SUCCESS);
+
+  srsran_refsignal_dmrs_pusch_cfg_t dmrs_cfg = {};
+  dmrs_cfg.cyclic_shift                      = 3;
+  dmrs_cfg.delta_ss                          = 0;
+  srsran_chest_ul_pregen(&est_average, &dmrs_cfg, NULL);
+  srsran_chest_ul_pregen(&est_wiener, &dmrs_cfg, NULL);
+
+  // Allocation in the centre of the cell
+  srsran_pusch_cfg_t cfg   = {};
+  cfg.grant.L_prb          = nof_prb;
+  cfg.grant.n_prb[0]       = (cell.nof_prb - nof_prb) / 2;
+  cfg.grant.n_prb[1]       = cfg.grant.n_prb[0];
+  cfg.grant.n_prb_tilde[0] = cfg.grant.n_prb[0];
+  cfg.grant.n_prb_tilde[1] = cfg.grant.n_prb[0];
+  cfg.grant.n_dmrs         = 0;
+
+  // Generate the received subframes, QPSK data and DMRS through a static channel and AWGN
+  uint32_t sf_nof_re = SRSRAN_SF_LEN_RE(cell.nof_prb, cell.cp);
+  uint32_t nof_re    = nof_prb * SRSRAN_NRE;
+  float    n0        = srsran_convert_dB_to_power(-snr_db);
+  for (uint32_t n = 0; n < nof_subframes; n++) {
+    sf_symbols[n] = srsran_vec_cf_malloc(sf_nof_re);
+    h[n]          = srsran_vec_cf_malloc(nof_re);
+    TESTASSERT(sf_symbols[n] != NULL && h[n] != NULL);
+
+    srsran_vec_cf_zero(sf_symbols[n], sf_nof_re);
+    gen_channel(random, h[n], nof_re);
+
+    for (uint32_t l = 0; l < SRSRAN_CP_NORM_SF_NSYMB; l++) {
+      cf_t* x = &sf_symbols[n][SRSRAN_RE_IDX(cell.nof_prb, l, cfg.grant.n_prb[0] * SRSRAN_NRE)];
+      for (uint32_t k = 0; k < nof_re; k++) {
+        x[k] = (srsran_random_bool(random, 0.5f) ? M_SQRT1_2 : -M_SQRT1_2) +
+               I * (srsran_random_bool(random, 0.5f) ? M_SQRT1_2 : -M_SQRT1_2);
+      }
+    }
+    srsran_refsignal_dmrs_pusch_put(
+        &est_average.dmrs_signal, &cfg, est_average.dmrs_pregen.r[0][n % SRSRAN_NOF_SF_X_FRAME][nof_prb], sf_symbols[n]);
+
+    for (uint32_t l = 0; l < SRSRAN_CP_NORM_SF_NSYMB; l++) {
+      cf_t* x = &sf_symbols[n][SRSRAN_RE_IDX(cell.nof_prb, l, cfg.grant.n_prb[0] * SRSRAN_NRE)];
+      srsran_vec_prod_ccc(x, h[n], x, nof_re);
+    }
+    srsran_ch_awgn_c(sf_symbols[n], sf_symbols[n], n0, sf_nof_re);
+  }
+
+  double ns_prb_average = 0.0;
+  double ns_prb_wiener  = 0.0;
+  float  mse_average    = run_estimator(&est_average, &cfg, sf_symbols, h, &res, &ns_prb_average);
+  float  mse_wiener     = run_estimator(&est_wiener, &cfg, sf_symbols, h, &res, &ns_prb_wiener);
+
+  printf("-- PUSCH channel estimator. nof_prb=%d; snr=%+.1fdB; delay_spread=%.2fus; subframes=%d\n",
+         nof_prb,
+         snr_db,
+         delay_spread_us,
+         nof_subframes);
+  printf("   average: mse=%+.2fdB; %.1f ns/PRB\n", mse_average, ns_prb_average);
+  printf("    wiener: mse=%+.2fdB; %.1f ns/PRB\n", mse_wiener, ns_prb_wiener);
+
+  // The Wiener filter shall not be worse than the averaging filter
+  TESTASSERT(mse_wiener <= mse_average);
+
+  for (uint32_t n = 0; n < nof_subframes; n++) {
+    free(sf_symbols[n]);
+    free(h[n]);
+  }
+  srsran_chest_ul_res_free(&res);
+  srsran_chest_ul_free(&est_average);
+  srsran_chest_ul_free(&est_wiener);
+  srsran_random_free(random);
+
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
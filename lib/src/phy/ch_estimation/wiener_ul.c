@@ -0,0 +1,262 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/ch_estimation/wiener_ul.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd.h"
+#include "srsran/phy/utils/vector.h"
+#include <complex.h>
+#include <math.h>
+#include <strings.h>
+
+// SNR buckets in dB, the closest is selected
+static const float wiener_ul_snr_db[SRSRAN_WIENER_UL_NOF_SNR] = {-5.0f, 0.0f, 5.0f, 10.0f, 15.0f, 20.0f, 25.0f, 30.0f};
+
+// RMS delay spread buckets in microseconds, the smallest not shorter than the measured is selected
+static const float wiener_ul_ds_us[SRSRAN_WIENER_UL_NOF_DS] = {0.1f, 0.5f, 1.0f, 2.5f};
+
+// Window length and position of the filtered PRB within the window for each filter position
+static const uint32_t wiener_ul_pos_win_prb[SRSRAN_WIENER_UL_NOF_POS] = {1, 2, 2, 3, 3, 3};
+static const uint32_t wiener_ul_pos_out_prb[SRSRAN_WIENER_UL_NOF_POS] = {0, 0, 1, 0, 1, 2};
+
+#define WIENER_UL_SC_SPACING_HZ 15e3f
+#define WIENER_UL_MIN_NOISE 1e-4f // Relative to the estimates power, the SNR measurement saturates at 40 dB
+#define WIENER_UL_OUT_LEN 16 // Output RE padded to a multiple of every SIMD width
+#define WIENER_UL_FILTER_LEN (WIENER_UL_OUT_LEN * SRSRAN_WIENER_UL_WIN_RE)
+#define WIENER_UL_BANK_LEN                                                                                             \
+  (SRSRAN_WIENER_UL_NOF_SNR * SRSRAN_WIENER_UL_NOF_DS * SRSRAN_WIENER_UL_NOF_POS * 2 * WIENER_UL_FILTER_LEN)
+
+// Every filter is stored as a real plane followed by an imaginary plane, so it loads without shuffling
+static inline float* wiener_ul_filter(srsran_wiener_ul_t* q, uint32_t snr_idx, uint32_t ds_idx, uint32_t pos)
+{
+  uint32_t idx = (snr_idx * SRSRAN_WIENER_UL_NOF_DS + ds_idx) * SRSRAN_WIENER_UL_NOF_POS + pos;
+  return &q->bank[idx * 2 * WIENER_UL_FILTER_LEN];
+}
+
+/* Frequency correlation of an exponential power delay profile centred on its mean delay, x is the product of the
+ * subcarrier distance and 2·pi·delay_spread·subcarrier_spacing */
+static inline double complex wiener_ul_corr(double x)
+{
+  return cexp(I * x) / (1.0 + I * x);
+}
+
+/* Filters one PRB from a window of win_len estimates. The filter is stored transposed, so every window estimate is
+ * scaled by a column and accumulated into all the outputs at once */
+static inline void wiener_ul_apply(const float* filter, const cf_t* win, uint32_t win_len, cf_t* out)
+{
+  const float* filter_re = filter;
+  const float* filter_im = filter + WIENER_UL_FILTER_LEN;
+
+#if SRSRAN_SIMD_CF_SIZE
+  srsran_simd_aligned float acc_re[WIENER_UL_OUT_LEN];
+  srsran_simd_aligned float acc_im[WIENER_UL_OUT_LEN];
+  for (uint32_t k = 0; k < WIENER_UL_OUT_LEN; k += SRSRAN_SIMD_CF_SIZE) {
+    simd_cf_t acc = srsran_simd_cf_zero();
+    for (uint32_t j = 0; j < win_len; j++) {
+      simd_cf_t w = srsran_simd_cf_load(&filter_re[j * WIENER_UL_OUT_LEN + k], &filter_im[j * WIENER_UL_OUT_LEN + k]);
+      acc         = srsran_simd_cf_add(srsran_simd_cf_prod(w, srsran_simd_cf_set1(win[j])), acc);
+    }
+    srsran_simd_cf_store(&acc_re[k], &acc_im[k], acc);
+  }
+  for (uint32_t k = 0; k < SRSRAN_NRE; k++) {
+    __real__ out[k] = acc_re[k];
+    __imag__ out[k] = acc_im[k];
+  }
+#else  /* SRSRAN_SIMD_CF_SIZE */
+  for (uint32_t k = 0; k < SRSRAN_NRE; k++) {
+    cf_t acc = 0.0f;
+    for (uint32_t j = 0; j < win_len; j++) {
+      acc += (filter_re[j * WIENER_UL_OUT_LEN + k] + I * filter_im[j * WIENER_UL_OUT_LEN + k]) * win[j];
+    }
+    out[k] = acc;
+  }
+#endif /* SRSRAN_SIMD_CF_SIZE */
+}
+
+/* Computes W = R_hp · (R_pp + I / SNR)^-1 for the estimates of the PRB at out_prb within a window of win_prb PRB. R_pp
+ * is Hermitian, so every row of W is solved with its Cholesky factor in double precision */
+static void wiener_ul_design(float snr_db, float ds_us, uint32_t win_prb, uint32_t out_prb, float* filter)
+{
+  uint32_t N     = win_prb * SRSRAN_NRE;
+  double   x     = 2.0 * M_PI * ds_us * 1e-6 * WIENER_UL_SC_SPACING_HZ;
+  double   noise = pow(10.0, -snr_db / 10.0);
+
+  // Cholesky factor of R_pp, lower triangular
+  double complex L[SRSRAN_WIENER_UL_WIN_RE][SRSRAN_WIENER_UL_WIN_RE] = {};
+  for (uint32_t i = 0; i < N; i++) {
+    for (uint32_t j = 0; j <= i; j++) {
+      double complex acc = wiener_ul_corr(x * ((double)i - (double)j)) + (i == j ? noise : 0.0);
+      for (uint32_t m = 0; m < j; m++) {
+        acc -= L[i][m] * conj(L[j][m]);
+      }
+      L[i][j] = (i == j) ? sqrt(creal(acc)) : acc / creal(L[j][j]);
+    }
+  }
+
+  bzero(filter, sizeof(float) * 2 * WIENER_UL_FILTER_LEN);
+  for (uint32_t k = 0; k < SRSRAN_NRE; k++) {
+    // Solve L · L^H · w = conj(R_hp[k]) by forward and backward substitution
+    double complex w[SRSRAN_WIENER_UL_WIN_RE];
+    uint32_t       k_win = out_prb * SRSRAN_NRE + k;
+    for (uint32_t i = 0; i < N; i++) {
+      double complex acc = conj(wiener_ul_corr(x * ((double)k_win - (double)i)));
+      for (uint32_t m = 0; m < i; m++) {
+        acc -= L[i][m] * w[m];
+      }
+      w[i] = acc / creal(L[i][i]);
+    }
+    for (int32_t i = (int32_t)N - 1; i >= 0; i--) {
+      double complex acc = w[i];
+      for (uint32_t m = i + 1; m < N; m++) {
+        acc -= conj(L[m][i]) * w[m];
+      }
+      w[i] = acc / creal(L[i][i]);
+    }
+
+    // W[k] = w^H
+    for (uint32_t j = 0; j < N; j++) {
+      filter[j * WIENER_UL_OUT_LEN + k]                        = (float)creal(w[j]);
+      filter[WIENER_UL_FILTER_LEN + j * WIENER_UL_OUT_LEN + k] = (float)-cimag(w[j]);
+    }
+  }
+}
+
+int srsran_wiener_ul_init(srsran_wiener_ul_t* q, uint32_t max_prb)
+{
+  if (q == NULL || max_prb == 0 || max_prb > SRSRAN_MAX_PRB) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  bzero(q, sizeof(srsran_wiener_ul_t));
+  q->max_re = max_prb * SRSRAN_NRE;
+
+  q->bank = srsran_vec_f_malloc(WIENER_UL_BANK_LEN);
+  q->tmp  = srsran_vec_cf_malloc(q->max_re);
+  if (!q->bank || !q->tmp) {
+    ERROR("Error allocating memory");
+    srsran_wiener_ul_free(q);
+    return SRSRAN_ERROR;
+  }
+
+  // Precompute the whole bank
+  for (uint32_t snr_idx = 0; snr_idx < SRSRAN_WIENER_UL_NOF_SNR; snr_idx++) {
+    for (uint32_t ds_idx = 0; ds_idx < SRSRAN_WIENER_UL_NOF_DS; ds_idx++) {
+      for (uint32_t pos = 0; pos < SRSRAN_WIENER_UL_NOF_POS; pos++) {
+        wiener_ul_design(wiener_ul_snr_db[snr_idx],
+                         wiener_ul_ds_us[ds_idx],
+                         wiener_ul_pos_win_prb[pos],
+                         wiener_ul_pos_out_prb[pos],
+                         wiener_ul_filter(q, snr_idx, ds_idx, pos));
+      }
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_wiener_ul_free(srsran_wiener_ul_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  if (q->bank) {
+    free(q->bank);
+  }
+  if (q->tmp) {
+    free(q->tmp);
+  }
+  bzero(q, sizeof(srsran_wiener_ul_t));
+}
+
+int srsran_wiener_ul_run(srsran_wiener_ul_t* q, const cf_t* pilots, cf_t* estimated, uint32_t nof_re)
+{
+  if (q == NULL || pilots == NULL || estimated == NULL || nof_re == 0 || nof_re % SRSRAN_NRE != 0 ||
+      nof_re > q->max_re) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t nof_prb = nof_re / SRSRAN_NRE;
+
+  // Correlation at one subcarrier and at up to one PRB distance, the noise only contributes to the zero lag
+  uint32_t D  = SRSRAN_MIN(SRSRAN_NRE, nof_re / 2);
+  float    P0 = srsran_vec_avg_power_cf(pilots, nof_re);
+  cf_t     R1 = srsran_vec_dot_prod_conj_ccc(&pilots[1], pilots, nof_re - 1) / (float)(nof_re - 1);
+  cf_t     RD = srsran_vec_dot_prod_conj_ccc(&pilots[D], pilots, nof_re - D) / (float)(nof_re - D);
+
+  // Solve the delay spread from |R(D)| / |R(1)| = sqrt((1 + x^2) / (1 + D^2 x^2))
+  float rho = cabsf(RD) / cabsf(R1);
+  float x2  = INFINITY;
+  if (isnormal(rho) && rho < 1.0f && D * D * rho * rho > 1.0f) {
+    x2 = (1.0f - rho * rho) / ((float)(D * D) * rho * rho - 1.0f);
+  } else if (rho >= 1.0f) {
+    x2 = 0.0f;
+  }
+  q->delay_spread_us = sqrtf(x2) / (2.0f * (float)M_PI * WIENER_UL_SC_SPACING_HZ) * 1e6f;
+
+  // Remove the correlation loss from the signal power, the rest is noise
+  float S = cabsf(R1) * sqrtf(1.0f + SRSRAN_MIN(x2, 1.0f));
+  q->noise  = SRSRAN_MAX(P0 - S, P0 * WIENER_UL_MIN_NOISE);
+  q->snr_db = srsran_convert_power_to_dB(S / q->noise);
+  if (!isnormal(q->noise)) {
+    q->snr_db = wiener_ul_snr_db[SRSRAN_WIENER_UL_NOF_SNR - 1];
+  }
+
+  // Select filters
+  float    snr_idx_f = roundf((q->snr_db - wiener_ul_snr_db[0]) / (wiener_ul_snr_db[1] - wiener_ul_snr_db[0]));
+  uint32_t snr_idx   = (uint32_t)SRSRAN_MIN(SRSRAN_MAX(snr_idx_f, 0.0f), (float)(SRSRAN_WIENER_UL_NOF_SNR - 1));
+  uint32_t ds_idx    = 0;
+  while (ds_idx < SRSRAN_WIENER_UL_NOF_DS - 1 && wiener_ul_ds_us[ds_idx] < q->delay_spread_us) {
+    ds_idx++;
+  }
+
+  // Remove the mean delay, the filters assume the delay profile is centred
+  float delay = cargf(R1) / (2.0f * (float)M_PI);
+  srsran_vec_apply_cfo(pilots, -delay, q->tmp, nof_re);
+
+  for (uint32_t prb = 0; prb < nof_prb; prb++) {
+    uint32_t pos       = 0;
+    uint32_t win_start = 0;
+    if (nof_prb == 2) {
+      pos = 1 + prb;
+    } else if (nof_prb > 2) {
+      if (prb == 0) {
+        pos = 3;
+      } else if (prb == nof_prb - 1) {
+        pos       = 5;
+        win_start = prb - 2;
+      } else {
+        pos       = 4;
+        win_start = prb - 1;
+      }
+    }
+
+    wiener_ul_apply(wiener_ul_filter(q, snr_idx, ds_idx, pos),
+                    &q->tmp[win_start * SRSRAN_NRE],
+                    wiener_ul_pos_win_prb[pos] * SRSRAN_NRE,
+                    &estimated[prb * SRSRAN_NRE]);
+  }
+
+  // Restore the mean delay
+  srsran_vec_apply_cfo(estimated, delay, estimated, nof_re);
+
+  return SRSRAN_SUCCESS;
+}
@@ -21,7 +21,9 @@
 
 #include "srsran/phy/channel/fading.h"
 #include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/simd.h"
 #include "srsran/phy/utils/vector.h"
+#include <complex.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -108,26 +110,24 @@ static inline __m128 _cosine(float* table, __m128 arg)
 #endif /*LV_HAVE_SSE*/
 
 static inline cf_t
-get_doppler_dispersion(srsran_channel_fading_t* q, float t, float F_d, float* alpha, float* a, float* b)
+get_doppler_dispersion(srsran_channel_fading_t* q, float t, const float* w, const float* a, const float* b)
 {
 #ifdef LV_HAVE_SSE
   const float recN   = 1.0f / sqrtf(SRSRAN_CHANNEL_FADING_NTERMS);
   cf_t        ret    = 0;
   __m128      _reacc = _mm_setzero_ps();
   __m128      _imacc = _mm_setzero_ps();
-  __m128      _arg   = _mm_set1_ps((float)M_PI * F_d);
   __m128      _t     = _mm_set1_ps(t);
-  __m128      _arg_  = (_mm_mul_ps(_arg, _t));
 
   for (int i = 0; i < SRSRAN_CHANNEL_FADING_NTERMS; i += 4) {
-    __m128 _alpha = _mm_loadu_ps(&alpha[i]);
-    __m128 _a     = _mm_loadu_ps(&a[i]);
-    __m128 _b     = _mm_loadu_ps(&b[i]);
-    __m128 _arg1  = _mm_mul_ps(_arg_, _cosine(q->sin_table, _alpha));
-    __m128 _re    = _cosine(q->sin_table, _mm_add_ps(_arg1, _a));
-    __m128 _im    = _sine(q->sin_table, _mm_add_ps(_arg1, _b));
-    _reacc        = _mm_add_ps(_reacc, _re);
-    _imacc        = _mm_add_ps(_imacc, _im);
+    __m128 _w    = _mm_loadu_ps(&w[i]);
+    __m128 _a    = _mm_loadu_ps(&a[i]);
+    __m128 _b    = _mm_loadu_ps(&b[i]);
+    __m128 _arg1 = _mm_mul_ps(_t, _w);
+    __m128 _re   = _cosine(q->sin_table, _mm_add_ps(_arg1, _a));
+    __m128 _im   = _sine(q->sin_table, _mm_add_ps(_arg1, _b));
+    _reacc       = _mm_add_ps(_reacc, _re);
+    _imacc       = _mm_add_ps(_imacc, _im);
   }
 
   __m128 _tmp = _mm_hadd_ps(_reacc, _imacc);
@@ -144,7 +144,7 @@ get_doppler_dispersion(srsran_channel_fading_t* q, float t, float F_d, float* al
   cf_t        r    = 0;
 
   for (uint32_t i = 0; i < SRSRAN_CHANNEL_FADING_NTERMS; i++) {
-    float arg = (float)M_PI * F_d * cosf(alpha[i]) * t;
+    float arg = w[i] * t;
     __real__ r += cosf(arg + a[i]);
     __imag__ r += sinf(arg + b[i]);
   }
@@ -159,28 +159,44 @@ static inline void generate_tap(float delay_ns, float power_db, float srate, cf_
   float O         = (delay_ns * 1e-9f * srate + path_delay) / (float)N;
   cf_t  a0        = amplitude / N;
 
-  srsran_vec_gen_sine(a0, -O, buf, N);
+  // Generate the response FFT-shifted, the first half starts at N/2 and the second half at 0
+  srsran_vec_gen_sine(a0 * cexpf(-_Complex_I * (float)M_PI * O * (float)N), -O, buf, N / 2);
+  srsran_vec_gen_sine(a0, -O, &buf[N / 2], N - N / 2);
 }
 
 static inline void generate_taps(srsran_channel_fading_t* q, float time)
 {
-  // Generate taps
-  for (int i = 0; i < nof_taps[q->model]; i++) {
-    // Compute phase for the doppler dispersion
-    cf_t a = get_doppler_dispersion(q, time, q->doppler, q->coeff_alpha[i], q->coeff_a[i], q->coeff_b[i]);
-
-    if (i) {
-      // Copy tap frequency response
-      srsran_vec_sc_prod_ccc(q->h_tap[i], a, q->temp, q->N);
-
-      // Add to frequency response, shifts FFT at same time
-      srsran_vec_sum_ccc(q->h_freq, &q->temp[q->N / 2], q->h_freq, q->N / 2);
-      srsran_vec_sum_ccc(&q->h_freq[q->N / 2], q->temp, &q->h_freq[q->N / 2], q->N / 2);
-    } else {
-      // Copy tap frequency response
-      srsran_vec_sc_prod_ccc(&q->h_tap[i][q->N / 2], a, q->h_freq, q->N / 2);
-      srsran_vec_sc_prod_ccc(&q->h_tap[i][0], a, &q->h_freq[q->N / 2], q->N / 2);
+  uint32_t ntaps = nof_taps[q->model];
+  cf_t     a[SRSRAN_CHANNEL_FADING_MAXTAPS];
+
+  // Compute the doppler dispersion of every tap
+  for (uint32_t i = 0; i < ntaps; i++) {
+    a[i] = get_doppler_dispersion(q, time, q->coeff_w[i], q->coeff_a[i], q->coeff_b[i]);
+  }
+
+  // Accumulate all the tap frequency responses in a single pass, they are already FFT-shifted
+  int i = 0;
+#if SRSRAN_SIMD_CF_SIZE
+  simd_cf_t _a[SRSRAN_CHANNEL_FADING_MAXTAPS];
+  for (uint32_t j = 0; j < ntaps; j++) {
+    _a[j] = srsran_simd_cf_set1(a[j]);
+  }
+
+  for (; i < (int)q->N - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+    simd_cf_t h = srsran_simd_cf_prod(srsran_simd_cfi_load(&q->h_tap[0][i]), _a[0]);
+    for (uint32_t j = 1; j < ntaps; j++) {
+      h = srsran_simd_cf_add(h, srsran_simd_cf_prod(srsran_simd_cfi_load(&q->h_tap[j][i]), _a[j]));
     }
+    srsran_simd_cfi_store(&q->h_freq[i], h);
+  }
+#endif /* SRSRAN_SIMD_CF_SIZE */
+
+  for (; i < (int)q->N; i++) {
+    cf_t h = q->h_tap[0][i] * a[0];
+    for (uint32_t j = 1; j < ntaps; j++) {
+      h += q->h_tap[j][i] * a[j];
+    }
+    q->h_freq[i] = h;
   }
   // at this stage, q->h_freq should contain the frequency response
 }
@@ -242,10 +258,16 @@ int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const c
         q->coeff_a[i][j]     = srsran_random_uniform_real_dist(random, 0, 2.0f * (float)M_PI);
         q->coeff_b[i][j]     = srsran_random_uniform_real_dist(random, 0, 2.0f * (float)M_PI);
         q->coeff_alpha[i][j] = ((float)M_PI * ((float)i - (float)0.5f)) / (2.0f * nof_taps[q->model]);
+        q->coeff_w[i][j]     = (float)M_PI * q->doppler * cosf(q->coeff_alpha[i][j]);
       }
 
       // Allocate tap frequency response
       q->h_tap[i] = srsran_vec_cf_malloc(q->N);
+      if (!q->h_tap[i]) {
+        fprintf(stderr, "Error: allocating h_tap\n");
+        srsran_random_free(random);
+        goto clean_exit;
+      }
 
       // Generate tap frequency response
       generate_tap(
@@ -0,0 +1,155 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsran/phy/channel/channel.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+#include <chrono>
+#include <getopt.h>
+#include <vector>
+
+static std::string model        = "eva70";
+static uint32_t    nof_channels = 4;
+static uint32_t    nof_threads  = 4;
+static uint32_t    duration_ms  = 100;
+static uint32_t    srate_hz     = 23040000;
+static std::string log_level    = "warning";
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [mnptsl]\n", prog);
+  printf("\t-m Fading model: epa5, eva70, etu300 [Default %s]\n", model.c_str());
+  printf("\t-n Number of channels [Default %d]\n", nof_channels);
+  printf("\t-p Number of threads of the parallel run [Default %d]\n", nof_threads);
+  printf("\t-t Simulation time in ms [Default %d]\n", duration_ms);
+  printf("\t-s Sampling rate in Hz [Default %d]\n", srate_hz);
+  printf("\t-l Channel log level [Default %s]\n", log_level.c_str());
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "mnptsl")) != -1) {
+    switch (opt) {
+      case 'm':
+        model = argv[optind];
+        break;
+      case 'n':
+        nof_channels = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'p':
+        nof_threads = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 't':
+        duration_ms = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 's':
+        srate_hz = (uint32_t)strtof(argv[optind], nullptr);
+        break;
+      case 'l':
+        log_level = argv[optind];
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Runs the channel emulator over the whole simulation and returns the throughput in Msps across all the channels
+static double run_channel(uint32_t                              threads,
+                          const std::vector<std::vector<cf_t>>& input,
+                          std::vector<std::vector<cf_t>>&       output)
+{
+  srsran::channel::args_t args = {};
+  args.enable                  = true;
+  args.nof_threads             = threads;
+  args.awgn_enable             = true;
+  args.awgn_snr_dB             = 20.0f;
+  args.fading_enable           = true;
+  args.fading_model            = model;
+  args.delay_enable            = true;
+  args.hst_enable              = true;
+
+  srsran::channel channel(args, nof_channels, srslog::fetch_basic_logger("CHAN"));
+  channel.set_srate(srate_hz);
+
+  uint32_t                 sf_len                       = srate_hz / 1000;
+  cf_t*                    buffers[SRSRAN_MAX_CHANNELS] = {};
+  std::chrono::nanoseconds elapsed(0);
+  for (uint32_t t = 0; t < duration_ms; t++) {
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      srsran_vec_cf_copy(&output[i][t * sf_len], &input[i][t * sf_len], sf_len);
+      buffers[i] = &output[i][t * sf_len];
+    }
+
+    srsran_timestamp_t ts = {};
+    srsran_timestamp_init(&ts, 0, t * 1e-3);
+
+    auto start = std::chrono::steady_clock::now();
+    channel.run(buffers, buffers, sf_len, ts);
+    elapsed += std::chrono::steady_clock::now() - start;
+  }
+
+  return (double)nof_channels * sf_len * duration_ms / (double)elapsed.count() * 1e3;
+}
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+  parse_args(argc, argv);
+
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("CHAN");
+  logger.set_level(srslog::str_to_basic_level(log_level));
+
+  TESTASSERT(nof_channels <= SRSRAN_MAX_CHANNELS);
+
+  // Random input, the same for both runs
+  uint32_t                       nof_samples = srate_hz / 1000 * duration_ms;
+  std::vector<std::vector<cf_t>> input(nof_channels, std::vector<cf_t>(nof_samples));
+  std::vector<std::vector<cf_t>> output_serial(nof_channels, std::vector<cf_t>(nof_samples));
+  std::vector<std::vector<cf_t>> output_parallel(nof_channels, std::vector<cf_t>(nof_samples));
+  srsran_random_t                random = srsran_random_init(0x1234);
+  for (std::vector<cf_t>& x : input) {
+    srsran_random_uniform_complex_dist_vector(random, x.data(), nof_samples, -1.0f, +1.0f);
+  }
+  srsran_random_free(random);
+
+  double msps_serial   = run_channel(1, input, output_serial);
+  double msps_parallel = run_channel(nof_threads, input, output_parallel);
+
+  printf("-- Channel emulator. model=%s; srate=%.2fMHz; channels=%d; duration=%dms\n",
+         model.c_str(),
+         srate_hz / 1e6,
+         nof_channels,
+         duration_ms);
+  printf("   1 thread: %.1f MSps; %d threads: %.1f MSps\n", msps_serial, nof_threads, msps_parallel);
+
+  // Every channel owns its emulator state, so the result does not depend on the number of threads
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    TESTASSERT(output_serial[i] == output_parallel[i]);
+  }
+
+  srslog::flush();
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
@@ -687,43 +687,46 @@ void srsran_sequence_apply_bit(const uint8_t* in, uint8_t* out, uint32_t length,
   srsran_sequence_state_apply_bit(&sequence_state, in, out, length);
 }
 
+/**
+ * Reverses the bit order of a byte, the sequence generates the LSB first whereas packed bytes start with the MSB
+ */
+static const uint8_t reverse_lut[256] = {
+    0b00000000, 0b10000000, 0b01000000, 0b11000000, 0b00100000, 0b10100000, 0b01100000, 0b11100000, 0b00010000,
+    0b10010000, 0b01010000, 0b11010000, 0b00110000, 0b10110000, 0b01110000, 0b11110000, 0b00001000, 0b10001000,
+    0b01001000, 0b11001000, 0b00101000, 0b10101000, 0b01101000, 0b11101000, 0b00011000, 0b10011000, 0b01011000,
+    0b11011000, 0b00111000, 0b10111000, 0b01111000, 0b11111000, 0b00000100, 0b10000100, 0b01000100, 0b11000100,
+    0b00100100, 0b10100100, 0b01100100, 0b11100100, 0b00010100, 0b10010100, 0b01010100, 0b11010100, 0b00110100,
+    0b10110100, 0b01110100, 0b11110100, 0b00001100, 0b10001100, 0b01001100, 0b11001100, 0b00101100, 0b10101100,
+    0b01101100, 0b11101100, 0b00011100, 0b10011100, 0b01011100, 0b11011100, 0b00111100, 0b10111100, 0b01111100,
+    0b11111100, 0b00000010, 0b10000010, 0b01000010, 0b11000010, 0b00100010, 0b10100010, 0b01100010, 0b11100010,
+    0b00010010, 0b10010010, 0b01010010, 0b11010010, 0b00110010, 0b10110010, 0b01110010, 0b11110010, 0b00001010,
+    0b10001010, 0b01001010, 0b11001010, 0b00101010, 0b10101010, 0b01101010, 0b11101010, 0b00011010, 0b10011010,
+    0b01011010, 0b11011010, 0b00111010, 0b10111010, 0b01111010, 0b11111010, 0b00000110, 0b10000110, 0b01000110,
+    0b11000110, 0b00100110, 0b10100110, 0b01100110, 0b11100110, 0b00010110, 0b10010110, 0b01010110, 0b11010110,
+    0b00110110, 0b10110110, 0b01110110, 0b11110110, 0b00001110, 0b10001110, 0b01001110, 0b11001110, 0b00101110,
+    0b10101110, 0b01101110, 0b11101110, 0b00011110, 0b10011110, 0b01011110, 0b11011110, 0b00111110, 0b10111110,
+    0b01111110, 0b11111110, 0b00000001, 0b10000001, 0b01000001, 0b11000001, 0b00100001, 0b10100001, 0b01100001,
+    0b11100001, 0b00010001, 0b10010001, 0b01010001, 0b11010001, 0b00110001, 0b10110001, 0b01110001, 0b11110001,
+    0b00001001, 0b10001001, 0b01001001, 0b11001001, 0b00101001, 0b10101001, 0b01101001, 0b11101001, 0b00011001,
+    0b10011001, 0b01011001, 0b11011001, 0b00111001, 0b10111001, 0b01111001, 0b11111001, 0b00000101, 0b10000101,
+    0b01000101, 0b11000101, 0b00100101, 0b10100101, 0b01100101, 0b11100101, 0b00010101, 0b10010101, 0b01010101,
+    0b11010101, 0b00110101, 0b10110101, 0b01110101, 0b11110101, 0b00001101, 0b10001101, 0b01001101, 0b11001101,
+    0b00101101, 0b10101101, 0b01101101, 0b11101101, 0b00011101, 0b10011101, 0b01011101, 0b11011101, 0b00111101,
+    0b10111101, 0b01111101, 0b11111101, 0b00000011, 0b10000011, 0b01000011, 0b11000011, 0b00100011, 0b10100011,
+    0b01100011, 0b11100011, 0b00010011, 0b10010011, 0b01010011, 0b11010011, 0b00110011, 0b10110011, 0b01110011,
+    0b11110011, 0b00001011, 0b10001011, 0b01001011, 0b11001011, 0b00101011, 0b10101011, 0b01101011, 0b11101011,
+    0b00011011, 0b10011011, 0b01011011, 0b11011011, 0b00111011, 0b10111011, 0b01111011, 0b11111011, 0b00000111,
+    0b10000111, 0b01000111, 0b11000111, 0b00100111, 0b10100111, 0b01100111, 0b11100111, 0b00010111, 0b10010111,
+    0b01010111, 0b11010111, 0b00110111, 0b10110111, 0b01110111, 0b11110111, 0b00001111, 0b10001111, 0b01001111,
+    0b11001111, 0b00101111, 0b10101111, 0b01101111, 0b11101111, 0b00011111, 0b10011111, 0b01011111, 0b11011111,
+    0b00111111, 0b10111111, 0b01111111, 0b11111111,
+};
+
 void srsran_sequence_apply_packed(const uint8_t* in, uint8_t* out, uint32_t length, uint32_t seed)
 {
   uint32_t x1 = sequence_x1_init;           // X1 initial state is fix
   uint32_t x2 = sequence_get_x2_init(seed); // loads x2 initial state
 
-  const uint8_t reverse_lut[256] = {
-      0b00000000, 0b10000000, 0b01000000, 0b11000000, 0b00100000, 0b10100000, 0b01100000, 0b11100000, 0b00010000,
-      0b10010000, 0b01010000, 0b11010000, 0b00110000, 0b10110000, 0b01110000, 0b11110000, 0b00001000, 0b10001000,
-      0b01001000, 0b11001000, 0b00101000, 0b10101000, 0b01101000, 0b11101000, 0b00011000, 0b10011000, 0b01011000,
-      0b11011000, 0b00111000, 0b10111000, 0b01111000, 0b11111000, 0b00000100, 0b10000100, 0b01000100, 0b11000100,
-      0b00100100, 0b10100100, 0b01100100, 0b11100100, 0b00010100, 0b10010100, 0b01010100, 0b11010100, 0b00110100,
-      0b10110100, 0b01110100, 0b11110100, 0b00001100, 0b10001100, 0b01001100, 0b11001100, 0b00101100, 0b10101100,
-      0b01101100, 0b11101100, 0b00011100, 0b10011100, 0b01011100, 0b11011100, 0b00111100, 0b10111100, 0b01111100,
-      0b11111100, 0b00000010, 0b10000010, 0b01000010, 0b11000010, 0b00100010, 0b10100010, 0b01100010, 0b11100010,
-      0b00010010, 0b10010010, 0b01010010, 0b11010010, 0b00110010, 0b10110010, 0b01110010, 0b11110010, 0b00001010,
-      0b10001010, 0b01001010, 0b11001010, 0b00101010, 0b10101010, 0b01101010, 0b11101010, 0b00011010, 0b10011010,
-      0b01011010, 0b11011010, 0b00111010, 0b10111010, 0b01111010, 0b11111010, 0b00000110, 0b10000110, 0b01000110,
-      0b11000110, 0b00100110, 0b10100110, 0b01100110, 0b11100110, 0b00010110, 0b10010110, 0b01010110, 0b11010110,
-      0b00110110, 0b10110110, 0b01110110, 0b11110110, 0b00001110, 0b10001110, 0b01001110, 0b11001110, 0b00101110,
-      0b10101110, 0b01101110, 0b11101110, 0b00011110, 0b10011110, 0b01011110, 0b11011110, 0b00111110, 0b10111110,
-      0b01111110, 0b11111110, 0b00000001, 0b10000001, 0b01000001, 0b11000001, 0b00100001, 0b10100001, 0b01100001,
-      0b11100001, 0b00010001, 0b10010001, 0b01010001, 0b11010001, 0b00110001, 0b10110001, 0b01110001, 0b11110001,
-      0b00001001, 0b10001001, 0b01001001, 0b11001001, 0b00101001, 0b10101001, 0b01101001, 0b11101001, 0b00011001,
-      0b10011001, 0b01011001, 0b11011001, 0b00111001, 0b10111001, 0b01111001, 0b11111001, 0b00000101, 0b10000101,
-      0b01000101, 0b11000101, 0b00100101, 0b10100101, 0b01100101, 0b11100101, 0b00010101, 0b10010101, 0b01010101,
-      0b11010101, 0b00110101, 0b10110101, 0b01110101, 0b11110101, 0b00001101, 0b10001101, 0b01001101, 0b11001101,
-      0b00101101, 0b10101101, 0b01101101, 0b11101101, 0b00011101, 0b10011101, 0b01011101, 0b11011101, 0b00111101,
-      0b10111101, 0b01111101, 0b11111101, 0b00000011, 0b10000011, 0b01000011, 0b11000011, 0b00100011, 0b10100011,
-      0b01100011, 0b11100011, 0b00010011, 0b10010011, 0b01010011, 0b11010011, 0b00110011, 0b10110011, 0b01110011,
-      0b11110011, 0b00001011, 0b10001011, 0b01001011, 0b11001011, 0b00101011, 0b10101011, 0b01101011, 0b11101011,
-      0b00011011, 0b10011011, 0b01011011, 0b11011011, 0b00111011, 0b10111011, 0b01111011, 0b11111011, 0b00000111,
-      0b10000111, 0b01000111, 0b11000111, 0b00100111, 0b10100111, 0b01100111, 0b11100111, 0b00010111, 0b10010111,
-      0b01010111, 0b11010111, 0b00110111, 0b10110111, 0b01110111, 0b11110111, 0b00001111, 0b10001111, 0b01001111,
-      0b11001111, 0b00101111, 0b10101111, 0b01101111, 0b11101111, 0b00011111, 0b10011111, 0b01011111, 0b11011111,
-      0b00111111, 0b10111111, 0b01111111, 0b11111111,
-  };
-
   uint32_t i = 0;
 #if SEQUENCE_PAR_BITS % 8 != 0
   uint64_t buffer = 0;
@@ -797,3 +800,360 @@ void srsran_sequence_apply_packed(const uint8_t* in, uint8_t* out, uint32_t leng
   }
 #endif // SEQUENCE_PAR_BITS % 8 == 0
 }
+
+/**
+ * Multi-seed packed sequence generation
+ * -------------------------------------
+ *
+ * The x1 sequence does not depend on the seed, so several seeds are generated in parallel by stepping one x2 state per
+ * SIMD lane against a common x1. Every step produces SEQUENCE_PAR_BITS (3 bytes) for each seed.
+ */
+#if SEQUENCE_PAR_BITS % 8 != 0
+#error "The multi-seed generator requires SEQUENCE_PAR_BITS to be a multiple of 8"
+#endif
+
+#define SEQUENCE_PAR_BYTES (SEQUENCE_PAR_BITS / 8)
+
+static void sequence_gen_packed(uint32_t seed, uint8_t* out, uint32_t nof_bytes)
+{
+  uint32_t x1 = sequence_x1_init;
+  uint32_t x2 = sequence_get_x2_init(seed);
+
+  for (uint32_t i = 0; i < nof_bytes; i += SEQUENCE_PAR_BYTES) {
+    uint32_t c = (uint32_t)(x1 ^ x2);
+
+    for (uint32_t j = 0; j < SEQUENCE_PAR_BYTES && i + j < nof_bytes; j++) {
+      out[i + j] = reverse_lut[c & 255U];
+      c          = c >> 8U;
+    }
+
+    // Step sequences
+    x1 = sequence_gen_LTE_pr_memless_step_par_x1(x1);
+    x2 = sequence_gen_LTE_pr_memless_step_par_x2(x2);
+  }
+}
+
+#ifdef LV_HAVE_AVX2
+#define SEQUENCE_AVX2_NOF_SEEDS 8
+
+static void sequence_gen_packed_avx2(const uint32_t* seeds, uint8_t** out, uint32_t nof_bytes)
+{
+  uint32_t x1 = sequence_x1_init;
+  uint32_t x2_init[SEQUENCE_AVX2_NOF_SEEDS];
+  for (uint32_t k = 0; k < SEQUENCE_AVX2_NOF_SEEDS; k++) {
+    x2_init[k] = sequence_get_x2_init(seeds[k]);
+  }
+  __m256i x2 = _mm256_loadu_si256((__m256i*)x2_init);
+
+  // Bit reversal of every nibble, used for reversing the bits of each byte
+  const __m256i lut  = _mm256_setr_epi8(0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe, 0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf,
+                                       0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe, 0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf);
+  const __m256i mask = _mm256_set1_epi32(SEQUENCE_MASK);
+  const __m256i low  = _mm256_set1_epi8(0x0f);
+
+  uint32_t c[SEQUENCE_AVX2_NOF_SEEDS] __attribute__((aligned(32)));
+  for (uint32_t i = 0; i < nof_bytes; i += SEQUENCE_PAR_BYTES) {
+    __m256i v = _mm256_xor_si256(x2, _mm256_set1_epi32((int)x1));
+
+    // Reverse the bits of every byte
+    __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, low));
+    __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+    v          = _mm256_or_si256(_mm256_slli_epi16(lo, 4), hi);
+    _mm256_store_si256((__m256i*)c, v);
+
+    uint32_t n = SRSRAN_MIN(SEQUENCE_PAR_BYTES, nof_bytes - i);
+    for (uint32_t k = 0; k < SEQUENCE_AVX2_NOF_SEEDS; k++) {
+      memcpy(&out[k][i], &c[k], n);
+    }
+
+    // Step sequences, the x2 step is the same as sequence_gen_LTE_pr_memless_step_par_x2 for every lane
+    x1        = sequence_gen_LTE_pr_memless_step_par_x1(x1);
+    __m256i f = _mm256_xor_si256(_mm256_xor_si256(x2, _mm256_srli_epi32(x2, 1)),
+                                 _mm256_xor_si256(_mm256_srli_epi32(x2, 2), _mm256_srli_epi32(x2, 3)));
+    f         = _mm256_slli_epi32(_mm256_and_si256(f, mask), SEQUENCE_SEED_LEN - SEQUENCE_PAR_BITS);
+    x2        = _mm256_xor_si256(_mm256_srli_epi32(x2, SEQUENCE_PAR_BITS), f);
+  }
+}
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_AVX512
+#define SEQUENCE_AVX512_NOF_SEEDS 16
+
+static void sequence_gen_packed_avx512(const uint32_t* seeds, uint8_t** out, uint32_t nof_bytes)
+{
+  uint32_t x1 = sequence_x1_init;
+  uint32_t x2_init[SEQUENCE_AVX512_NOF_SEEDS];
+  for (uint32_t k = 0; k < SEQUENCE_AVX512_NOF_SEEDS; k++) {
+    x2_init[k] = sequence_get_x2_init(seeds[k]);
+  }
+  __m512i x2 = _mm512_loadu_si512(x2_init);
+
+  // Bit reversal of every nibble, used for reversing the bits of each byte
+  const __m512i lut  = _mm512_broadcast_i32x4(
+      _mm_setr_epi8(0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe, 0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf));
+  const __m512i mask = _mm512_set1_epi32(SEQUENCE_MASK);
+  const __m512i low  = _mm512_set1_epi8(0x0f);
+
+  uint32_t c[SEQUENCE_AVX512_NOF_SEEDS] __attribute__((aligned(64)));
+  for (uint32_t i = 0; i < nof_bytes; i += SEQUENCE_PAR_BYTES) {
+    __m512i v = _mm512_xor_si512(x2, _mm512_set1_epi32((int)x1));
+
+    // Reverse the bits of every byte
+    __m512i lo = _mm512_shuffle_epi8(lut, _mm512_and_si512(v, low));
+    __m512i hi = _mm512_shuffle_epi8(lut, _mm512_and_si512(_mm512_srli_epi16(v, 4), low));
+    v          = _mm512_or_si512(_mm512_slli_epi16(lo, 4), hi);
+    _mm512_store_si512(c, v);
+
+    uint32_t n = SRSRAN_MIN(SEQUENCE_PAR_BYTES, nof_bytes - i);
+    for (uint32_t k = 0; k < SEQUENCE_AVX512_NOF_SEEDS; k++) {
+      memcpy(&out[k][i], &c[k], n);
+    }
+
+    // Step sequences, the x2 step is the same as sequence_gen_LTE_pr_memless_step_par_x2 for every lane
+    x1        = sequence_gen_LTE_pr_memless_step_par_x1(x1);
+    __m512i f = _mm512_ternarylogic_epi32(x2, _mm512_srli_epi32(x2, 1), _mm512_srli_epi32(x2, 2), 0x96);
+    f         = _mm512_xor_si512(f, _mm512_srli_epi32(x2, 3));
+    f         = _mm512_slli_epi32(_mm512_and_si512(f, mask), SEQUENCE_SEED_LEN - SEQUENCE_PAR_BITS);
+    x2        = _mm512_xor_si512(_mm512_srli_epi32(x2, SEQUENCE_PAR_BITS), f);
+  }
+}
+#endif /* LV_HAVE_AVX512 */
+
+void srsran_sequence_gen_packed_multi(const uint32_t* seeds, uint8_t** out, uint32_t nof_seeds, uint32_t length)
+{
+  uint32_t nof_bytes = SRSRAN_CEIL(length, 8);
+  uint32_t s         = 0;
+
+#ifdef LV_HAVE_AVX512
+  for (; s + SEQUENCE_AVX512_NOF_SEEDS <= nof_seeds; s += SEQUENCE_AVX512_NOF_SEEDS) {
+    sequence_gen_packed_avx512(&seeds[s], &out[s], nof_bytes);
+  }
+#endif /* LV_HAVE_AVX512 */
+
+#ifdef LV_HAVE_AVX2
+  for (; s + SEQUENCE_AVX2_NOF_SEEDS <= nof_seeds; s += SEQUENCE_AVX2_NOF_SEEDS) {
+    sequence_gen_packed_avx2(&seeds[s], &out[s], nof_bytes);
+  }
+#endif /* LV_HAVE_AVX2 */
+
+  for (; s < nof_seeds; s++) {
+    sequence_gen_packed(seeds[s], out[s], nof_bytes);
+  }
+
+  // Clear the bits past the end of the sequence, as srsran_bit_pack_vector does
+  if (length % 8 != 0) {
+    for (s = 0; s < nof_seeds; s++) {
+      out[s][nof_bytes - 1] &= (uint8_t)(0xffU << (8U - length % 8));
+    }
+  }
+}
+
+void srsran_sequence_packed_apply_f(const uint8_t* c, const float* in, float* out, uint32_t length)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_SSE
+  for (; i < length - length % 8; i += 8) {
+    // Expands the byte bits, MSB first
+    __m128i m  = _mm_set1_epi32(c[i / 8]);
+    __m128i m1 = _mm_cmpgt_epi32(_mm_and_si128(m, _mm_setr_epi32(0x80, 0x40, 0x20, 0x10)), _mm_setzero_si128());
+    __m128i m2 = _mm_cmpgt_epi32(_mm_and_si128(m, _mm_setr_epi32(0x08, 0x04, 0x02, 0x01)), _mm_setzero_si128());
+
+    // And with MSB and perform sign XOR
+    m1 = _mm_and_si128(m1, (__m128i)_mm_set1_ps(-0.0F));
+    m2 = _mm_and_si128(m2, (__m128i)_mm_set1_ps(-0.0F));
+    _mm_storeu_ps(out + i, _mm_xor_ps((__m128)m1, _mm_loadu_ps(in + i)));
+    _mm_storeu_ps(out + i + 4, _mm_xor_ps((__m128)m2, _mm_loadu_ps(in + i + 4)));
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < length; i++) {
+    FLOAT_U32_XOR(out[i], in[i], (uint32_t)((c[i / 8] >> (7U - i % 8)) & 1U) << 31U);
+  }
+}
+
+void srsran_sequence_packed_apply_s(const uint8_t* c, const int16_t* in, int16_t* out, uint32_t length)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_SSE
+  for (; i < length - length % 8; i += 8) {
+    // Expands the byte bits, MSB first
+    __m128i mask = _mm_set1_epi16(c[i / 8]);
+    mask         = _mm_and_si128(mask, _mm_setr_epi16(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01));
+    mask         = _mm_cmpgt_epi16(mask, _mm_setzero_si128());
+
+    // Negate
+    __m128i v = _mm_xor_si128(_mm_loadu_si128((__m128i*)(in + i)), mask);
+    v         = _mm_add_epi16(v, _mm_and_si128(mask, _mm_set1_epi16(1)));
+
+    _mm_storeu_si128((__m128i*)(out + i), v);
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < length; i++) {
+    out[i] = ((c[i / 8] >> (7U - i % 8)) & 1U) ? -in[i] : in[i];
+  }
+}
+
+void srsran_sequence_packed_apply_c(const uint8_t* c, const int8_t* in, int8_t* out, uint32_t length)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_SSE
+  for (; i < length - length % 16; i += 16) {
+    // Preloads the 16 bits of interest, MSB first
+    uint16_t w;
+    memcpy(&w, &c[i / 8], sizeof(w));
+    __m128i mask = _mm_set1_epi16((int16_t)w);
+    mask         = _mm_shuffle_epi8(mask, _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1));
+    mask         = _mm_and_si128(mask, _mm_set_epi64x(0x0102040810204080, 0x0102040810204080));
+    mask         = _mm_cmpeq_epi8(mask, _mm_set_epi64x(0x0102040810204080, 0x0102040810204080));
+
+    // Negate
+    __m128i v = _mm_xor_si128(_mm_loadu_si128((__m128i*)(in + i)), mask);
+    v         = _mm_add_epi8(v, _mm_and_si128(mask, _mm_set1_epi8(1)));
+
+    _mm_storeu_si128((__m128i*)(out + i), v);
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < length; i++) {
+    out[i] = ((c[i / 8] >> (7U - i % 8)) & 1U) ? -in[i] : in[i];
+  }
+}
+
+void srsran_sequence_packed_apply_packed(const uint8_t* c, const uint8_t* in, uint8_t* out, uint32_t length)
+{
+  srsran_vec_xor_bbb(in, c, out, length / 8);
+
+  // Process spare bits, the sequence may continue past the end
+  uint32_t rem8 = length % 8;
+  if (rem8 != 0) {
+    out[length / 8] = in[length / 8] ^ (c[length / 8] & (uint8_t)(0xffU << (8U - rem8)));
+  }
+}
+
+/**
+ * Scrambling sequence cache
+ * -------------------------
+ *
+ * Direct mapped, every seed can only be stored in the entry given by its hash and a miss evicts the previous sequence.
+ * Each entry keeps the longest length generated for its seed, so shorter requests hit the same sequence.
+ */
+#define SEQUENCE_CACHE_BATCH 16
+
+static inline srsran_sequence_cache_entry_t* sequence_cache_entry(srsran_sequence_cache_t* q, uint32_t seed)
+{
+  // Fibonacci hashing, spreads the RNTI and slot fields of the seed across the entries
+  return &q->entries[(uint32_t)(seed * 2654435761U) % q->nof_entries];
+}
+
+int srsran_sequence_cache_init(srsran_sequence_cache_t* q, uint32_t max_len, uint32_t max_bytes)
+{
+  if (q == NULL || max_len == 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  srsran_sequence_cache_free(q);
+
+  // Keep every entry aligned to a cache line
+  uint32_t entry_bytes = SRSRAN_CEIL(max_len, 8 * 64) * 64;
+  q->nof_entries       = max_bytes / entry_bytes;
+  if (q->nof_entries == 0) {
+    ERROR("Sequence cache budget (%d bytes) is smaller than one sequence (%d bytes)", max_bytes, entry_bytes);
+    return SRSRAN_ERROR;
+  }
+
+  q->buffer  = srsran_vec_u8_malloc(q->nof_entries * entry_bytes);
+  q->entries = calloc(q->nof_entries, sizeof(srsran_sequence_cache_entry_t));
+  if (q->buffer == NULL || q->entries == NULL) {
+    ERROR("Error allocating sequence cache");
+    srsran_sequence_cache_free(q);
+    return SRSRAN_ERROR;
+  }
+
+  for (uint32_t i = 0; i < q->nof_entries; i++) {
+    q->entries[i].c = &q->buffer[i * entry_bytes];
+  }
+  q->max_len = max_len;
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_sequence_cache_free(srsran_sequence_cache_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+  if (q->buffer) {
+    free(q->buffer);
+  }
+  if (q->entries) {
+    free(q->entries);
+  }
+  bzero(q, sizeof(srsran_sequence_cache_t));
+}
+
+const uint8_t* srsran_sequence_cache_get(srsran_sequence_cache_t* q, uint32_t seed, uint32_t len)
+{
+  if (q == NULL || q->nof_entries == 0 || len > q->max_len) {
+    return NULL;
+  }
+
+  srsran_sequence_cache_entry_t* e = sequence_cache_entry(q, seed);
+  if (e->len < len || e->seed != seed) {
+    srsran_sequence_gen_packed_multi(&seed, &e->c, 1, len);
+    e->seed = seed;
+    e->len  = len;
+  }
+
+  return e->c;
+}
+
+void srsran_sequence_cache_prefetch(srsran_sequence_cache_t* q, const uint32_t* seeds, uint32_t nof_seeds, uint32_t len)
+{
+  if (q == NULL || q->nof_entries == 0 || len > q->max_len) {
+    return;
+  }
+
+  uint32_t                       batch_seeds[SEQUENCE_CACHE_BATCH];
+  uint8_t*                       batch_out[SEQUENCE_CACHE_BATCH];
+  srsran_sequence_cache_entry_t* batch_entries[SEQUENCE_CACHE_BATCH];
+  uint32_t                       count = 0;
+
+  for (uint32_t i = 0; i <= nof_seeds; i++) {
+    srsran_sequence_cache_entry_t* e = NULL;
+    bool                           flush = (i == nof_seeds);
+
+    if (i < nof_seeds) {
+      e = sequence_cache_entry(q, seeds[i]);
+      if (e->len >= len && e->seed == seeds[i]) {
+        continue;
+      }
+
+      // Two seeds of the same batch must not write the same entry
+      for (uint32_t k = 0; k < count; k++) {
+        flush |= (batch_entries[k] == e);
+      }
+      flush |= (count == SEQUENCE_CACHE_BATCH);
+    }
+
+    if (flush && count > 0) {
+      srsran_sequence_gen_packed_multi(batch_seeds, batch_out, count, len);
+      for (uint32_t k = 0; k < count; k++) {
+        batch_entries[k]->seed = batch_seeds[k];
+        batch_entries[k]->len  = len;
+      }
+      count = 0;
+    }
+
+    // The flush may have generated the same seed already
+    if (e != NULL && (e->len < len || e->seed != seeds[i])) {
+      batch_seeds[count]   = seeds[i];
+      batch_out[count]     = e->c;
+      batch_entries[count] = e;
+      count++;
+    }
+  }
+}
@@ -43,6 +43,14 @@ static int8_t  ones_char[Nc + MAX_SEQ_LEN + 31];
 static uint8_t ones_packed[(MAX_SEQ_LEN * 7) / 8];
 static uint8_t ones_unpacked[MAX_SEQ_LEN];
 
+// Covers the widest SIMD batch and a remainder
+#define NOF_MULTI_SEEDS 19
+static uint8_t c_packed_multi[NOF_MULTI_SEEDS][MAX_SEQ_LEN / 8];
+static float   c_float_cached[MAX_SEQ_LEN];
+static int16_t c_short_cached[MAX_SEQ_LEN];
+static int8_t  c_char_cached[MAX_SEQ_LEN];
+static uint8_t c_packed_cached[MAX_SEQ_LEN / 8];
+
 static int test_sequence(srsran_sequence_t* sequence, uint32_t seed, uint32_t length, uint32_t repetitions)
 {
   int            ret                      = SRSRAN_SUCCESS;
@@ -53,6 +61,7 @@ static int test_sequence(srsran_sequence_t* sequence, uint32_t seed, uint32_t le
   uint64_t       interval_xor_char_us     = 0;
   uint64_t       interval_xor_unpacked_us = 0;
   uint64_t       interval_xor_packed_us   = 0;
+  uint64_t       interval_gen_multi_us    = 0;
 
   gettimeofday(&t[1], NULL);
 
@@ -178,10 +187,63 @@ static int test_sequence(srsran_sequence_t* sequence, uint32_t seed, uint32_t le
     ret = SRSRAN_ERROR;
   }
 
-  printf("%08x; %8d; %8.1f; %8.1f; %8.1f; %8.1f; %8.1f; %8.1f; %8c\n",
+  // Test multi-seed packed generation
+  uint32_t seeds[NOF_MULTI_SEEDS];
+  uint8_t* c_multi[NOF_MULTI_SEEDS];
+  for (uint32_t k = 0; k < NOF_MULTI_SEEDS; k++) {
+    seeds[k]   = SRSRAN_SEQUENCE_MOD(seed + k * 0x1234567);
+    c_multi[k] = c_packed_multi[k];
+  }
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < repetitions; r++) {
+    srsran_sequence_gen_packed_multi(seeds, c_multi, NOF_MULTI_SEEDS, length);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  interval_gen_multi_us = t->tv_sec * 1000000UL + t->tv_usec;
+
+  for (uint32_t k = 0; k < NOF_MULTI_SEEDS; k++) {
+    srsran_sequence_apply_packed(ones_packed, c_packed, length, seeds[k]);
+    if (memcmp(c_packed, c_multi[k], (length + 7) / 8) != 0) {
+      ERROR("Unmatched multi-seed c_packed %d", k);
+      ret = SRSRAN_ERROR;
+    }
+  }
+
+  // Test sequence cache, the second access hits the generated sequence
+  srsran_sequence_cache_t cache = {};
+  if (srsran_sequence_cache_init(&cache, length, 4 * length) < SRSRAN_SUCCESS) {
+    ERROR("Error initialising sequence cache");
+    return SRSRAN_ERROR;
+  }
+  srsran_sequence_cache_prefetch(&cache, seeds, NOF_MULTI_SEEDS, length);
+  for (uint32_t r = 0; r < 2; r++) {
+    const uint8_t* c_cached = srsran_sequence_cache_get(&cache, seed, length);
+    if (c_cached == NULL || memcmp(c_packed_gold, c_cached, (length + 7) / 8) != 0) {
+      ERROR("Unmatched cached sequence");
+      ret = SRSRAN_ERROR;
+      break;
+    }
+
+    srsran_sequence_packed_apply_f(c_cached, ones_float, c_float_cached, length);
+    srsran_sequence_packed_apply_s(c_cached, ones_short, c_short_cached, length);
+    srsran_sequence_packed_apply_c(c_cached, ones_char, c_char_cached, length);
+    srsran_sequence_packed_apply_packed(c_cached, ones_packed, c_packed_cached, length);
+    if (memcmp(c_float, c_float_cached, length * sizeof(float)) != 0 ||
+        memcmp(c_short, c_short_cached, length * sizeof(int16_t)) != 0 ||
+        memcmp(c_char, c_char_cached, length * sizeof(int8_t)) != 0 ||
+        memcmp(c_packed_gold, c_packed_cached, (length + 7) / 8) != 0) {
+      ERROR("Unmatched cached sequence apply");
+      ret = SRSRAN_ERROR;
+    }
+  }
+  srsran_sequence_cache_free(&cache);
+
+  printf("%08x; %8d; %8.1f; %8.1f; %8.1f; %8.1f; %8.1f; %8.1f; %8.1f; %8c\n",
          seed,
          length,
          (double)(length * repetitions) / (double)interval_gen_us,
+         (double)(length * repetitions * NOF_MULTI_SEEDS) / (double)interval_gen_multi_us,
          (double)(length * repetitions) / (double)interval_xor_float_us,
          (double)(length * repetitions) / (double)interval_xor_short_us,
          (double)(length * repetitions) / (double)interval_xor_char_us,
@@ -218,10 +280,11 @@ int main(int argc, char** argv)
     return SRSRAN_ERROR;
   }
 
-  printf("%8s; %8s; %8s; %8s; %8s; %8s; %8s; %8s; %8s;\n",
+  printf("%8s; %8s; %8s; %8s; %8s; %8s; %8s; %8s; %8s; %8s;\n",
          "seed",
          "length",
          "GEN",
+         "GEN Multi",
          "XOR PS",
          "XOR 16",
          "XOR 8",
@@ -0,0 +1,438 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <complex.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "srsran/phy/dft/dft_mixed_radix.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd.h"
+#include "srsran/phy/utils/vector.h"
+
+/*
+ * Self-sorting (Stockham) decimation in frequency. Every stage of radix p takes sub-transforms of n points with stride s
+ * and, for q = 0..m-1 with m = n/p and k = 0..s-1, computes:
+ *
+ *     b_t = sum_j x[k + s (q + j m)] e^(-2 pi i j t / p)
+ *     y[k + s (p q + t)] = b_t e^(-2 pi i t q / n)
+ *
+ * The next stage has n' = m and s' = p s. Stages are vectorised along k when the stride is as large as a SIMD register
+ * and along q in the first stage, where the stride is one.
+ */
+
+static const float dft_mr_c3  = -0.5f;                   // cos(2 pi / 3)
+static const float dft_mr_s3  = 0.86602540378443864676f; // sin(2 pi / 3)
+static const float dft_mr_c51 = 0.30901699437494742410f; // cos(2 pi / 5)
+static const float dft_mr_c52 = -0.80901699437494742410f; // cos(4 pi / 5)
+static const float dft_mr_s51 = 0.95105651629515357212f;  // sin(2 pi / 5)
+static const float dft_mr_s52 = 0.58778525229247312917f;  // sin(4 pi / 5)
+
+static inline cf_t dft_mr_mulj(cf_t a)
+{
+  cf_t r;
+  __real__ r = -__imag__ a;
+  __imag__ r = __real__ a;
+  return r;
+}
+
+static inline cf_t dft_mr_prod(cf_t a, cf_t b)
+{
+  cf_t r;
+  __real__ r = __real__ a * __real__ b - __imag__ a * __imag__ b;
+  __imag__ r = __real__ a * __imag__ b + __imag__ a * __real__ b;
+  return r;
+}
+
+#define DFT_MR_NEG_C(A) (-(A))
+#define DFT_MR_ADD_C(A, B) ((A) + (B))
+#define DFT_MR_SUB_C(A, B) ((A) - (B))
+#define DFT_MR_MULR_C(A, R) ((A) * (R))
+
+/* Rotation by -j for the forward transform and +j for the backward one */
+#define DFT_MR_ROT_C(A, FWD) ((FWD) ? dft_mr_mulj(DFT_MR_NEG_C(A)) : dft_mr_mulj(A))
+
+/*
+ * Radix p butterfly, b_t = sum_j a_j e^(-+2 pi i j t / p). It is written once with the scalar and SIMD operations as
+ * parameters.
+ */
+#define DFT_MR_BUTTERFLY(NAME, T, ADD, SUB, MULR, ROT)                                                                 \
+  static inline __attribute__((always_inline)) void NAME(T* a, const uint32_t p, const bool fwd)                      \
+  {                                                                                                                    \
+    switch (p) {                                                                                                       \
+      case 2: {                                                                                                        \
+        T t0 = ADD(a[0], a[1]);                                                                                        \
+        a[1] = SUB(a[0], a[1]);                                                                                        \
+        a[0] = t0;                                                                                                     \
+      } break;                                                                                                         \
+      case 3: {                                                                                                        \
+        T t1 = ADD(a[1], a[2]);                                                                                        \
+        T t2 = ADD(a[0], MULR(t1, dft_mr_c3));                                                                         \
+        T t3 = ROT(MULR(SUB(a[1], a[2]), dft_mr_s3), fwd);                                                             \
+        a[0] = ADD(a[0], t1);                                                                                          \
+        a[1] = ADD(t2, t3);                                                                                            \
+        a[2] = SUB(t2, t3);                                                                                            \
+      } break;                                                                                                         \
+      case 4: {                                                                                                        \
+        T t0 = ADD(a[0], a[2]);                                                                                        \
+        T t1 = SUB(a[0], a[2]);                                                                                        \
+        T t2 = ADD(a[1], a[3]);                                                                                        \
+        T t3 = ROT(SUB(a[1], a[3]), fwd);                                                                              \
+        a[0] = ADD(t0, t2);                                                                                            \
+        a[1] = ADD(t1, t3);                                                                                            \
+        a[2] = SUB(t0, t2);                                                                                            \
+        a[3] = SUB(t1, t3);                                                                                            \
+      } break;                                                                                                         \
+      default: {                                                                                                       \
+        T t1 = ADD(a[1], a[4]);                                                                                        \
+        T t2 = ADD(a[2], a[3]);                                                                                        \
+        T t3 = SUB(a[1], a[4]);                                                                                        \
+        T t4 = SUB(a[2], a[3]);                                                                                        \
+        T b1 = ADD(a[0], ADD(MULR(t1, dft_mr_c51), MULR(t2, dft_mr_c52)));                                             \
+        T b2 = ADD(a[0], ADD(MULR(t1, dft_mr_c52), MULR(t2, dft_mr_c51)));                                             \
+        T d1 = ROT(ADD(MULR(t3, dft_mr_s51), MULR(t4, dft_mr_s52)), fwd);                                              \
+        T d2 = ROT(SUB(MULR(t3, dft_mr_s52), MULR(t4, dft_mr_s51)), fwd);                                              \
+        a[0] = ADD(a[0], ADD(t1, t2));                                                                                 \
+        a[1] = ADD(b1, d1);                                                                                            \
+        a[4] = SUB(b1, d1);                                                                                            \
+        a[2] = ADD(b2, d2);                                                                                            \
+        a[3] = SUB(b2, d2);                                                                                            \
+      } break;                                                                                                         \
+    }                                                                                                                  \
+  }
+
+DFT_MR_BUTTERFLY(dft_mr_butterfly, cf_t, DFT_MR_ADD_C, DFT_MR_SUB_C, DFT_MR_MULR_C, DFT_MR_ROT_C)
+
+#if SRSRAN_SIMD_CF_SIZE != 0
+#define DFT_MR_MULR_SIMD(A, R) srsran_simd_cf_mul(A, srsran_simd_f_set1(R))
+#define DFT_MR_ROT_SIMD(A, FWD) ((FWD) ? srsran_simd_cf_mulj(srsran_simd_cf_neg(A)) : srsran_simd_cf_mulj(A))
+
+DFT_MR_BUTTERFLY(dft_mr_butterfly_simd,
+                 simd_cf_t,
+                 srsran_simd_cf_add,
+                 srsran_simd_cf_sub,
+                 DFT_MR_MULR_SIMD,
+                 DFT_MR_ROT_SIMD)
+#endif /* SRSRAN_SIMD_CF_SIZE != 0 */
+
+/* Scalar radix p step for a given q and k, the twiddles of the last stage are replaced by the output scaling */
+static inline __attribute__((always_inline)) void dft_mr_step(const cf_t*    x,
+                                                              cf_t*          y,
+                                                              const cf_t*    tw,
+                                                              uint32_t       m,
+                                                              uint32_t       s,
+                                                              uint32_t       q,
+                                                              uint32_t       k,
+                                                              const uint32_t p,
+                                                              const bool     fwd,
+                                                              float          scale)
+{
+  cf_t a[5];
+  for (uint32_t j = 0; j < p; j++) {
+    a[j] = x[k + s * (q + j * m)];
+  }
+  dft_mr_butterfly(a, p, fwd);
+
+  if (m == 1) {
+    for (uint32_t t = 0; t < p; t++) {
+      y[k + s * t] = a[t] * scale;
+    }
+  } else {
+    y[k + s * p * q] = a[0];
+    for (uint32_t t = 1; t < p; t++) {
+      cf_t w                   = tw[(t - 1) * m + q];
+      y[k + s * (p * q + t)] = dft_mr_prod(a[t], fwd ? w : conjf(w));
+    }
+  }
+}
+
+static inline __attribute__((always_inline)) void dft_mr_stage(const cf_t*    x,
+                                                               cf_t*          y,
+                                                               const cf_t*    tw,
+                                                               uint32_t       n,
+                                                               uint32_t       s,
+                                                               const uint32_t p,
+                                                               const bool     fwd,
+                                                               float          scale)
+{
+  uint32_t m = n / p;
+
+#if SRSRAN_SIMD_CF_SIZE != 0
+  if (s >= SRSRAN_SIMD_CF_SIZE) {
+    // Vectorised along k, the twiddles are the same for every k
+    simd_cf_t w[5];
+    for (uint32_t q = 0; q < m; q++) {
+      for (uint32_t t = 1; t < p; t++) {
+        cf_t wt = (m == 1) ? scale : tw[(t - 1) * m + q];
+        w[t]    = srsran_simd_cf_set1(fwd ? wt : conjf(wt));
+      }
+
+      uint32_t k = 0;
+      for (; k + SRSRAN_SIMD_CF_SIZE <= s; k += SRSRAN_SIMD_CF_SIZE) {
+        simd_cf_t a[5];
+        for (uint32_t j = 0; j < p; j++) {
+          a[j] = srsran_simd_cfi_loadu(&x[k + s * (q + j * m)]);
+        }
+        dft_mr_butterfly_simd(a, p, fwd);
+
+        if (m == 1) {
+          a[0] = srsran_simd_cf_mul(a[0], srsran_simd_f_set1(scale));
+        }
+        srsran_simd_cfi_storeu(&y[k + s * p * q], a[0]);
+        for (uint32_t t = 1; t < p; t++) {
+          srsran_simd_cfi_storeu(&y[k + s * (p * q + t)], srsran_simd_cf_prod(a[t], w[t]));
+        }
+      }
+
+      for (; k < s; k++) {
+        dft_mr_step(x, y, tw, m, s, q, k, p, fwd, scale);
+      }
+    }
+    return;
+  }
+
+  if (s == 1) {
+    // Vectorised along q, the outputs are interleaved through a temporal buffer
+    uint32_t q = 0;
+    for (; q + SRSRAN_SIMD_CF_SIZE <= m; q += SRSRAN_SIMD_CF_SIZE) {
+      simd_cf_t a[5];
+      for (uint32_t j = 0; j < p; j++) {
+        a[j] = srsran_simd_cfi_loadu(&x[q + j * m]);
+      }
+      dft_mr_butterfly_simd(a, p, fwd);
+
+      cf_t b[5][SRSRAN_SIMD_CF_SIZE] __attribute__((aligned(64)));
+      srsran_simd_cfi_store(b[0], a[0]);
+      for (uint32_t t = 1; t < p; t++) {
+        simd_cf_t w = srsran_simd_cfi_loadu(&tw[(t - 1) * m + q]);
+        srsran_simd_cfi_store(b[t], srsran_simd_cf_prod(a[t], fwd ? w : srsran_simd_cf_conj(w)));
+      }
+
+      for (uint32_t i = 0; i < SRSRAN_SIMD_CF_SIZE; i++) {
+        for (uint32_t t = 0; t < p; t++) {
+          y[p * (q + i) + t] = b[t][i];
+        }
+      }
+    }
+
+    for (; q < m; q++) {
+      dft_mr_step(x, y, tw, m, 1, q, 0, p, fwd, scale);
+    }
+    return;
+  }
+#endif /* SRSRAN_SIMD_CF_SIZE != 0 */
+
+  for (uint32_t q = 0; q < m; q++) {
+    for (uint32_t k = 0; k < s; k++) {
+      dft_mr_step(x, y, tw, m, s, q, k, p, fwd, scale);
+    }
+  }
+}
+
+static void dft_mr_stage_fwd(const cf_t* x, cf_t* y, const cf_t* tw, uint32_t n, uint32_t s, uint32_t p, float scale)
+{
+  switch (p) {
+    case 2:
+      dft_mr_stage(x, y, tw, n, s, 2, true, scale);
+      break;
+    case 3:
+      dft_mr_stage(x, y, tw, n, s, 3, true, scale);
+      break;
+    case 4:
+      dft_mr_stage(x, y, tw, n, s, 4, true, scale);
+      break;
+    default:
+      dft_mr_stage(x, y, tw, n, s, 5, true, scale);
+      break;
+  }
+}
+
+static void dft_mr_stage_bwd(const cf_t* x, cf_t* y, const cf_t* tw, uint32_t n, uint32_t s, uint32_t p, float scale)
+{
+  switch (p) {
+    case 2:
+      dft_mr_stage(x, y, tw, n, s, 2, false, scale);
+      break;
+    case 3:
+      dft_mr_stage(x, y, tw, n, s, 3, false, scale);
+      break;
+    case 4:
+      dft_mr_stage(x, y, tw, n, s, 4, false, scale);
+      break;
+    default:
+      dft_mr_stage(x, y, tw, n, s, 5, false, scale);
+      break;
+  }
+}
+
+void srsran_dft_mixed_radix_run(const srsran_dft_mixed_radix_plan_t* plan,
+                                const cf_t*                          in,
+                                cf_t*                                out,
+                                cf_t*                                scratch,
+                                srsran_dft_dir_t                     dir,
+                                float                                scale)
+{
+  if (plan == NULL || in == NULL || out == NULL || scratch == NULL) {
+    return;
+  }
+
+  // A single point transform has no stages
+  if (plan->nof_stages == 0) {
+    srsran_vec_sc_prod_cfc(in, scale, out, plan->size);
+    return;
+  }
+
+  // Ping-pong between the two scratch halves, the last stage writes the output
+  const cf_t* x = in;
+  uint32_t    n = plan->size;
+  uint32_t    s = 1;
+  for (uint32_t i = 0; i < plan->nof_stages; i++) {
+    cf_t*    y = (i == plan->nof_stages - 1) ? out : &scratch[(i % 2) * plan->size];
+    uint32_t p = plan->radix[i];
+
+    if (dir == SRSRAN_DFT_FORWARD) {
+      dft_mr_stage_fwd(x, y, plan->twiddle[i], n, s, p, scale);
+    } else {
+      dft_mr_stage_bwd(x, y, plan->twiddle[i], n, s, p, scale);
+    }
+
+    x = y;
+    n /= p;
+    s *= p;
+  }
+}
+
+/*
+ * Shared plans
+ * ------------
+ *
+ * Created on first use and protected by a mutex, the pointer is published once the plan is complete so the lookups of
+ * existing plans do not lock.
+ */
+static srsran_dft_mixed_radix_plan_t* dft_mr_plans[SRSRAN_DFT_MIXED_RADIX_MAX_SIZE + 1] = {};
+static pthread_mutex_t                dft_mr_mutex                                      = PTHREAD_MUTEX_INITIALIZER;
+
+bool srsran_dft_mixed_radix_valid_size(uint32_t size)
+{
+  if (size == 0 || size > SRSRAN_DFT_MIXED_RADIX_MAX_SIZE) {
+    return false;
+  }
+
+  const uint32_t factors[3] = {2, 3, 5};
+  for (uint32_t i = 0; i < 3; i++) {
+    while (size % factors[i] == 0) {
+      size /= factors[i];
+    }
+  }
+
+  return size == 1;
+}
+
+static void dft_mr_plan_free(srsran_dft_mixed_radix_plan_t* plan)
+{
+  for (uint32_t i = 0; i < plan->nof_stages; i++) {
+    if (plan->twiddle[i]) {
+      free(plan->twiddle[i]);
+    }
+  }
+  free(plan);
+}
+
+static srsran_dft_mixed_radix_plan_t* dft_mr_plan_create(uint32_t size)
+{
+  srsran_dft_mixed_radix_plan_t* plan = calloc(1, sizeof(srsran_dft_mixed_radix_plan_t));
+  if (plan == NULL) {
+    return NULL;
+  }
+  plan->size = size;
+
+  // Radix 5 and 3 first, the stride grows faster and more stages are vectorised along k
+  uint32_t n = size;
+  while (n > 1 && plan->nof_stages < SRSRAN_DFT_MIXED_RADIX_MAX_STAGES) {
+    uint32_t p = (n % 5 == 0) ? 5 : (n % 3 == 0) ? 3 : (n % 4 == 0) ? 4 : 2;
+    plan->radix[plan->nof_stages++] = p;
+    n /= p;
+  }
+
+  // Forward twiddles e^(-2 pi i t q / n) of every stage
+  n = size;
+  for (uint32_t i = 0; i < plan->nof_stages; i++) {
+    uint32_t p = plan->radix[i];
+    uint32_t m = n / p;
+
+    plan->twiddle[i] = srsran_vec_cf_malloc(SRSRAN_MAX((p - 1) * m, 1));
+    if (plan->twiddle[i] == NULL) {
+      dft_mr_plan_free(plan);
+      return NULL;
+    }
+
+    for (uint32_t t = 1; t < p; t++) {
+      for (uint32_t q = 0; q < m; q++) {
+        double arg                         = -2.0 * M_PI * (double)(t * q) / (double)n;
+        plan->twiddle[i][(t - 1) * m + q] = (float)cos(arg) + _Complex_I * (float)sin(arg);
+      }
+    }
+    n = m;
+  }
+
+  return plan;
+}
+
+const srsran_dft_mixed_radix_plan_t* srsran_dft_mixed_radix_get_plan(uint32_t size)
+{
+  if (!srsran_dft_mixed_radix_valid_size(size)) {
+    ERROR("Invalid mixed radix DFT size %d", size);
+    return NULL;
+  }
+
+  srsran_dft_mixed_radix_plan_t* plan = __atomic_load_n(&dft_mr_plans[size], __ATOMIC_ACQUIRE);
+  if (plan != NULL) {
+    return plan;
+  }
+
+  pthread_mutex_lock(&dft_mr_mutex);
+  plan = dft_mr_plans[size];
+  if (plan == NULL) {
+    plan = dft_mr_plan_create(size);
+    if (plan == NULL) {
+      ERROR("Error creating mixed radix DFT plan of size %d", size);
+    }
+    __atomic_store_n(&dft_mr_plans[size], plan, __ATOMIC_RELEASE);
+  }
+  pthread_mutex_unlock(&dft_mr_mutex);
+
+  return plan;
+}
+
+/**
+ * C destructor, frees the shared plans
+ */
+__attribute__((destructor)) __attribute__((unused)) static void dft_mr_plans_free()
+{
+  for (uint32_t i = 0; i <= SRSRAN_DFT_MIXED_RADIX_MAX_SIZE; i++) {
+    if (dft_mr_plans[i] != NULL) {
+      dft_mr_plan_free(dft_mr_plans[i]);
+      dft_mr_plans[i] = NULL;
+    }
+  }
+}
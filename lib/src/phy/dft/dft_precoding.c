@@ -34,7 +34,7 @@
 #include "srsran/phy/utils/debug.h"
 #include "srsran/phy/utils/vector.h"
 
-/* Create DFT plans for transform precoding */
+/* Get the shared DFT plans for transform precoding */
 
 int srsran_dft_precoding_init(srsran_dft_precoding_t* q, uint32_t max_prb, bool is_tx)
 {
@@ -46,14 +46,22 @@ int srsran_dft_precoding_init(srsran_dft_precoding_t* q, uint32_t max_prb, bool
     for (uint32_t i = 1; i <= max_prb; i++) {
       if (srsran_dft_precoding_valid_prb(i)) {
         DEBUG("Initiating DFT precoding plan for %d PRBs", i);
-        if (srsran_dft_plan_c(&q->dft_plan[i], i * SRSRAN_NRE, is_tx ? SRSRAN_DFT_FORWARD : SRSRAN_DFT_BACKWARD)) {
+        q->plan[i] = srsran_dft_mixed_radix_get_plan(i * SRSRAN_NRE);
+        if (q->plan[i] == NULL) {
           ERROR("Error: Creating DFT plan %d", i);
           goto clean_exit;
         }
-        srsran_dft_plan_set_norm(&q->dft_plan[i], true);
       }
     }
+
+    q->scratch = srsran_vec_cf_malloc(2 * SRSRAN_MAX(max_prb, 1) * SRSRAN_NRE);
+    if (q->scratch == NULL) {
+      ERROR("Error allocating memory");
+      goto clean_exit;
+    }
+
     q->max_prb = max_prb;
+    q->dir     = is_tx ? SRSRAN_DFT_FORWARD : SRSRAN_DFT_BACKWARD;
     ret        = SRSRAN_SUCCESS;
   }
 
@@ -74,13 +82,11 @@ int srsran_dft_precoding_init_tx(srsran_dft_precoding_t* q, uint32_t max_prb)
   return srsran_dft_precoding_init(q, max_prb, true);
 }
 
-/* Free DFT plans for transform precoding */
+/* Free transform precoding, the DFT plans are shared and remain */
 void srsran_dft_precoding_free(srsran_dft_precoding_t* q)
 {
-  for (uint32_t i = 1; i <= q->max_prb; i++) {
-    if (srsran_dft_precoding_valid_prb(i)) {
-      srsran_dft_plan_free(&q->dft_plan[i]);
-    }
+  if (q->scratch) {
+    free(q->scratch);
   }
   bzero(q, sizeof(srsran_dft_precoding_t));
 }
@@ -113,13 +119,16 @@ uint32_t srsran_dft_precoding_get_valid_prb(uint32_t nof_prb)
 
 int srsran_dft_precoding(srsran_dft_precoding_t* q, cf_t* input, cf_t* output, uint32_t nof_prb, uint32_t nof_symbols)
 {
-  if (!srsran_dft_precoding_valid_prb(nof_prb) && nof_prb <= q->max_prb) {
+  if (!srsran_dft_precoding_valid_prb(nof_prb) || nof_prb > q->max_prb) {
     ERROR("Error invalid number of PRB (%d)", nof_prb);
     return SRSRAN_ERROR;
   }
 
+  // Normalised transform, as the FFTW plans it replaces
+  uint32_t nof_re = SRSRAN_NRE * nof_prb;
+  float    scale  = 1.0f / sqrtf((float)nof_re);
   for (uint32_t i = 0; i < nof_symbols; i++) {
-    srsran_dft_run_c(&q->dft_plan[nof_prb], &input[i * SRSRAN_NRE * nof_prb], &output[i * SRSRAN_NRE * nof_prb]);
+    srsran_dft_mixed_radix_run(q->plan[nof_prb], &input[i * nof_re], &output[i * nof_re], q->scratch, q->dir, scale);
   }
 
   return SRSRAN_SUCCESS;
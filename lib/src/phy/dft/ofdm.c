@@ -35,6 +35,20 @@
 /* Uncomment next line for avoiding Guru DFT call */
 //#define AVOID_GURU
 
+/* Generates the phase ramp that compensates, after the DFT, the window offset and the Rx time offset. The ramp follows
+ * the signed subcarrier index, so a fractional time offset does not introduce a phase jump around DC.
+ */
+static void ofdm_rx_window_offset_gen(srsran_ofdm_t* q)
+{
+  uint32_t symbol_sz = q->cfg.symbol_sz;
+  float    offset    = (float)q->window_offset_n + q->time_offset;
+  float    freq      = offset / (float)symbol_sz;
+
+  srsran_vec_gen_sine(1.0f, freq, q->window_offset_buffer, symbol_sz / 2);
+  srsran_vec_gen_sine(
+      cexpf(-I * M_PI * offset), freq, &q->window_offset_buffer[symbol_sz / 2], symbol_sz - symbol_sz / 2);
+}
+
 static int ofdm_init_mbsfn_(srsran_ofdm_t* q, srsran_ofdm_cfg_t* cfg, srsran_dft_dir_t dir)
 {
   // If the symbol size is not given, calculate in function of the number of resource blocks
@@ -111,6 +125,7 @@ static int ofdm_init_mbsfn_(srsran_ofdm_t* q, srsran_ofdm_cfg_t* cfg, srsran_dft
     if (q->tmp) {
       free(q->tmp);
       free(q->shift_buffer);
+      free(q->cfo_buffer);
     }
 
 #ifdef AVOID_GURU
@@ -135,6 +150,12 @@ static int ofdm_init_mbsfn_(srsran_ofdm_t* q, srsran_ofdm_cfg_t* cfg, srsran_dft
       return SRSRAN_ERROR;
     }
 
+    q->cfo_buffer = srsran_vec_cf_malloc(symbol_sz);
+    if (!q->cfo_buffer) {
+      perror("malloc");
+      return SRSRAN_ERROR;
+    }
+
     q->max_prb = cfg->nof_prb;
   }
 
@@ -152,10 +173,6 @@ static int ofdm_init_mbsfn_(srsran_ofdm_t* q, srsran_ofdm_cfg_t* cfg, srsran_dft
     cfg->rx_window_offset = SRSRAN_MAX(0, cfg->rx_window_offset);   // Needs to be positive
     cfg->rx_window_offset = SRSRAN_MIN(100, cfg->rx_window_offset); // Needs to be below 100
     q->window_offset_n = (uint32_t)roundf((float)cp2 * cfg->rx_window_offset);
-
-    for (uint32_t i = 0; i < symbol_sz; i++) {
-      q->window_offset_buffer[i] = cexpf(I * M_PI * 2.0f * (float)q->window_offset_n * (float)i / (float)symbol_sz);
-    }
   }
 
   // Zero temporal and input buffers always
@@ -208,6 +225,11 @@ static int ofdm_init_mbsfn_(srsran_ofdm_t* q, srsran_ofdm_cfg_t* cfg, srsran_dft
 
   srsran_dft_plan_set_mirror(&q->fft_plan, true);
 
+  // Generate the frequency domain window offset for the current symbol size
+  if (dir == SRSRAN_DFT_FORWARD) {
+    ofdm_rx_window_offset_gen(q);
+  }
+
   DEBUG("Init %s symbol_sz=%d, nof_symbols=%d, cp=%s, nof_re=%d, nof_guards=%d",
         dir == SRSRAN_DFT_FORWARD ? "FFT" : "iFFT",
         q->cfg.symbol_sz,
@@ -264,6 +286,9 @@ void srsran_ofdm_free_(srsran_ofdm_t* q)
   if (q->window_offset_buffer) {
     free(q->window_offset_buffer);
   }
+  if (q->cfo_buffer) {
+    free(q->cfo_buffer);
+  }
   srsran_cfr_free(&q->tx_cfr);
   SRSRAN_MEM_ZERO(q, srsran_ofdm_t, 1);
 }
@@ -453,17 +478,55 @@ void srsran_ofdm_tx_free(srsran_ofdm_t* q)
   srsran_ofdm_free_(q);
 }
 
-void srsran_ofdm_rx_slot_ng(srsran_ofdm_t* q, cf_t* input, cf_t* output)
+void srsran_ofdm_rx_set_cfo(srsran_ofdm_t* q, float cfo, float phase)
+{
+  q->cfo       = cfo;
+  q->cfo_phase = phase;
+}
+
+void srsran_ofdm_rx_set_time_offset(srsran_ofdm_t* q, float time_offset)
+{
+  if (q->time_offset == time_offset) {
+    return;
+  }
+
+  q->time_offset = time_offset;
+  if (q->window_offset_buffer) {
+    ofdm_rx_window_offset_gen(q);
+  }
+}
+
+/* Returns the DFT input of the window starting "offset" samples after the beginning of the subframe. If there is a
+ * frequency offset, it is corrected while the window is loaded into the symbol buffer.
+ */
+static const cf_t* ofdm_rx_cfo(srsran_ofdm_t* q, const cf_t* sf_input, uint32_t offset)
+{
+  if (!isnormal(q->cfo)) {
+    return sf_input + offset;
+  }
+
+  uint32_t symbol_sz = q->cfg.symbol_sz;
+  float    cfo       = -q->cfo / (float)symbol_sz;
+
+  // The phase of the window is computed in double precision, so it does not drift along the subframe
+  double phase = fmod((double)q->cfo_phase + 2.0 * M_PI * (double)cfo * (double)offset, 2.0 * M_PI);
+
+  srsran_vec_apply_cfo_phase(sf_input + offset, cfo, (float)phase, q->cfo_buffer, symbol_sz);
+
+  return q->cfo_buffer;
+}
+
+static void ofdm_rx_slot_ng(srsran_ofdm_t* q, const cf_t* input, uint32_t slot_in_sf, cf_t* output)
 {
   uint32_t    symbol_sz = q->cfg.symbol_sz;
   srsran_cp_t cp        = q->cfg.cp;
+  uint32_t    offset    = slot_in_sf * q->slot_sz;
 
   for (uint32_t i = 0; i < q->nof_symbols; i++) {
-    input += SRSRAN_CP_ISNORM(cp) ? SRSRAN_CP_LEN_NORM(i, symbol_sz) : SRSRAN_CP_LEN_EXT(symbol_sz);
-    input -= q->window_offset_n;
-    srsran_dft_run_c(&q->fft_plan, input, q->tmp);
+    offset += SRSRAN_CP_ISNORM(cp) ? SRSRAN_CP_LEN_NORM(i, symbol_sz) : SRSRAN_CP_LEN_EXT(symbol_sz);
+    srsran_dft_run_c(&q->fft_plan, ofdm_rx_cfo(q, input, offset - q->window_offset_n), q->tmp);
     memcpy(output, &q->tmp[q->nof_guards], q->nof_re * sizeof(cf_t));
-    input += symbol_sz;
+    offset += symbol_sz;
     output += q->nof_re;
   }
 }
@@ -474,8 +537,7 @@ void srsran_ofdm_rx_slot_ng(srsran_ofdm_t* q, cf_t* input, cf_t* output)
 static void ofdm_rx_slot(srsran_ofdm_t* q, int slot_in_sf)
 {
 #ifdef AVOID_GURU
-  srsran_ofdm_rx_slot_ng(
-      q, q->cfg.in_buffer + slot_in_sf * q->slot_sz, q->cfg.out_buffer + slot_in_sf * q->nof_re * q->nof_symbols);
+  ofdm_rx_slot_ng(q, q->cfg.in_buffer, slot_in_sf, q->cfg.out_buffer + slot_in_sf * q->nof_re * q->nof_symbols);
 #else
   uint32_t nof_symbols = q->nof_symbols;
   uint32_t nof_re = q->nof_re;
@@ -485,11 +547,22 @@ static void ofdm_rx_slot(srsran_ofdm_t* q, int slot_in_sf)
   cf_t* tmp = q->tmp;
   uint32_t dc = (q->fft_plan.dc) ? 1 : 0;
 
-  srsran_dft_run_guru_c(&q->fft_plan_sf[slot_in_sf]);
+  if (isnormal(q->cfo)) {
+    // Correct the frequency offset symbol by symbol while loading the DFT input, the guru plan reads the subframe
+    uint32_t offset = slot_in_sf * q->slot_sz;
+    for (uint32_t i = 0; i < nof_symbols; i++) {
+      offset += SRSRAN_CP_ISNORM(q->cfg.cp) ? SRSRAN_CP_LEN_NORM(i, symbol_sz) : SRSRAN_CP_LEN_EXT(symbol_sz);
+      srsran_dft_run_c_zerocopy(
+          &q->fft_plan, ofdm_rx_cfo(q, q->cfg.in_buffer, offset - q->window_offset_n), &tmp[i * symbol_sz]);
+      offset += symbol_sz;
+    }
+  } else {
+    srsran_dft_run_guru_c(&q->fft_plan_sf[slot_in_sf]);
+  }
 
   for (int i = 0; i < q->nof_symbols; i++) {
-    // Apply frequency domain window offset
-    if (q->window_offset_n) {
+    // Apply frequency domain window offset, it includes the Rx time offset
+    if (q->window_offset_n || isnormal(q->time_offset)) {
       srsran_vec_prod_ccc(tmp, q->window_offset_buffer, tmp, symbol_sz);
     }
 
@@ -521,15 +594,15 @@ static void ofdm_rx_slot(srsran_ofdm_t* q, int slot_in_sf)
 
 static void ofdm_rx_slot_mbsfn(srsran_ofdm_t* q, cf_t* input, cf_t* output)
 {
-  uint32_t i;
-  for (i = 0; i < q->nof_symbols_mbsfn; i++) {
+  uint32_t offset = 0;
+  for (uint32_t i = 0; i < q->nof_symbols_mbsfn; i++) {
     if (i == q->non_mbsfn_region) {
-      input += SRSRAN_NON_MBSFN_REGION_GUARD_LENGTH(q->non_mbsfn_region, q->cfg.symbol_sz);
+      offset += SRSRAN_NON_MBSFN_REGION_GUARD_LENGTH(q->non_mbsfn_region, q->cfg.symbol_sz);
     }
-    input += (i >= q->non_mbsfn_region) ? SRSRAN_CP_LEN_EXT(q->cfg.symbol_sz) : SRSRAN_CP_LEN_NORM(i, q->cfg.symbol_sz);
-    srsran_dft_run_c(&q->fft_plan, input, q->tmp);
+    offset += (i >= q->non_mbsfn_region) ? SRSRAN_CP_LEN_EXT(q->cfg.symbol_sz) : SRSRAN_CP_LEN_NORM(i, q->cfg.symbol_sz);
+    srsran_dft_run_c(&q->fft_plan, ofdm_rx_cfo(q, input, offset), q->tmp);
     memcpy(output, &q->tmp[q->nof_guards], q->nof_re * sizeof(cf_t));
-    input += q->cfg.symbol_sz;
+    offset += q->cfg.symbol_sz;
     output += q->nof_re;
   }
 }
@@ -571,7 +644,7 @@ void srsran_ofdm_rx_sf_ng(srsran_ofdm_t* q, cf_t* input, cf_t* output)
   }
   if (!q->mbsfn_subframe) {
     for (n = 0; n < SRSRAN_NOF_SLOTS_PER_SF; n++) {
-      srsran_ofdm_rx_slot_ng(q, &input[n * q->slot_sz], &output[n * q->nof_re * q->nof_symbols]);
+      ofdm_rx_slot_ng(q, input, n, &output[n * q->nof_re * q->nof_symbols]);
     }
   } else {
     ofdm_rx_slot_mbsfn(q, q->cfg.in_buffer, q->cfg.out_buffer);
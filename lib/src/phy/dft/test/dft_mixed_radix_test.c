@@ -0,0 +1,227 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srsran/phy/common/phy_common.h"
+#include "srsran/phy/dft/dft.h"
+#include "srsran/phy/dft/dft_mixed_radix.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+
+static uint32_t max_size        = SRSRAN_DFT_MIXED_RADIX_MAX_SIZE;
+static uint32_t nof_repetitions = 1000;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s\n", prog);
+  printf("\t-N Maximum DFT size [Default %d]\n", max_size);
+  printf("\t-r Number of repetitions of the benchmark [Default %d]\n", nof_repetitions);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "Nr")) != -1) {
+    switch (opt) {
+      case 'N':
+        max_size = SRSRAN_MIN((uint32_t)strtol(argv[optind], NULL, 10), SRSRAN_DFT_MIXED_RADIX_MAX_SIZE);
+        break;
+      case 'r':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Reference DFT in double precision
+static void dft_reference(const cf_t* in, cf_t* out, uint32_t size, srsran_dft_dir_t dir, double* re, double* im)
+{
+  double sign = (dir == SRSRAN_DFT_FORWARD) ? -1.0 : +1.0;
+  for (uint32_t i = 0; i < size; i++) {
+    re[i] = cos(2.0 * M_PI * i / size);
+    im[i] = sign * sin(2.0 * M_PI * i / size);
+  }
+
+  for (uint32_t k = 0; k < size; k++) {
+    double   acc_re = 0.0;
+    double   acc_im = 0.0;
+    uint32_t idx    = 0;
+    for (uint32_t n = 0; n < size; n++) {
+      acc_re += __real__ in[n] * re[idx] - __imag__ in[n] * im[idx];
+      acc_im += __real__ in[n] * im[idx] + __imag__ in[n] * re[idx];
+      idx += k;
+      if (idx >= size) {
+        idx -= size;
+      }
+    }
+    out[k] = (float)acc_re + _Complex_I * (float)acc_im;
+  }
+}
+
+static int test_size(srsran_random_t random, uint32_t size, cf_t* in, cf_t* out, cf_t* gold, cf_t* scratch)
+{
+  const srsran_dft_mixed_radix_plan_t* plan = srsran_dft_mixed_radix_get_plan(size);
+  if (plan == NULL) {
+    ERROR("Error getting plan for size %d", size);
+    return SRSRAN_ERROR;
+  }
+
+  double* re = malloc(sizeof(double) * size);
+  double* im = malloc(sizeof(double) * size);
+  if (re == NULL || im == NULL) {
+    free(re);
+    free(im);
+    return SRSRAN_ERROR;
+  }
+
+  int   ret   = SRSRAN_SUCCESS;
+  float scale = 1.0f / sqrtf((float)size);
+  for (srsran_dft_dir_t dir = SRSRAN_DFT_FORWARD; dir <= SRSRAN_DFT_BACKWARD; dir++) {
+    srsran_random_uniform_complex_dist_vector(random, in, size, -1.0f, +1.0f);
+    dft_reference(in, gold, size, dir, re, im);
+    srsran_vec_sc_prod_cfc(gold, scale, gold, size);
+
+    // Out of place
+    srsran_dft_mixed_radix_run(plan, in, out, scratch, dir, scale);
+    srsran_vec_sub_ccc(out, gold, out, size);
+    float err = srsran_vec_avg_power_cf(out, size);
+
+    // In place
+    srsran_dft_mixed_radix_run(plan, in, in, scratch, dir, scale);
+    srsran_vec_sub_ccc(in, gold, in, size);
+    float err_inplace = srsran_vec_avg_power_cf(in, size);
+
+    if (!isnormal(1.0f + err) || err > 1e-9f || err_inplace > 1e-9f) {
+      ERROR("Size %d %s failed, error %e (in place %e)",
+            size,
+            dir == SRSRAN_DFT_FORWARD ? "forward" : "backward",
+            err,
+            err_inplace);
+      ret = SRSRAN_ERROR;
+    }
+  }
+
+  free(re);
+  free(im);
+  return ret;
+}
+
+static double elapsed_us(struct timeval* ts_start, struct timeval* ts_end)
+{
+  return ((double)ts_end->tv_sec - (double)ts_start->tv_sec) * 1e6 + (double)ts_end->tv_usec -
+         (double)ts_start->tv_usec;
+}
+
+// Compares the time taken by one transform against FFTW
+static int benchmark_size(uint32_t size, cf_t* in, cf_t* out, cf_t* scratch)
+{
+  srsran_dft_plan_t fftw = {};
+  if (srsran_dft_plan_c(&fftw, size, SRSRAN_DFT_FORWARD)) {
+    return SRSRAN_ERROR;
+  }
+  srsran_dft_plan_set_norm(&fftw, true);
+  const srsran_dft_mixed_radix_plan_t* plan = srsran_dft_mixed_radix_get_plan(size);
+
+  struct timeval t[3];
+  gettimeofday(&t[0], NULL);
+  for (uint32_t i = 0; i < nof_repetitions; i++) {
+    srsran_dft_mixed_radix_run(plan, in, out, scratch, SRSRAN_DFT_FORWARD, 1.0f / sqrtf((float)size));
+  }
+  gettimeofday(&t[1], NULL);
+  for (uint32_t i = 0; i < nof_repetitions; i++) {
+    srsran_dft_run_c(&fftw, in, out);
+  }
+  gettimeofday(&t[2], NULL);
+
+  printf("%6d; %8.3f; %8.3f;\n",
+         size,
+         elapsed_us(&t[0], &t[1]) / nof_repetitions,
+         elapsed_us(&t[1], &t[2]) / nof_repetitions);
+
+  srsran_dft_plan_free(&fftw);
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  int ret = SRSRAN_ERROR;
+  parse_args(argc, argv);
+
+  srsran_random_t random  = srsran_random_init(0x1234);
+  cf_t*           in      = srsran_vec_cf_malloc(max_size);
+  cf_t*           out     = srsran_vec_cf_malloc(max_size);
+  cf_t*           gold    = srsran_vec_cf_malloc(max_size);
+  cf_t*           scratch = srsran_vec_cf_malloc(2 * max_size);
+  if (random == NULL || in == NULL || out == NULL || gold == NULL || scratch == NULL) {
+    ERROR("Error allocating memory");
+    goto clean_exit;
+  }
+
+  uint32_t count = 0;
+  for (uint32_t size = 1; size <= max_size; size++) {
+    if (srsran_dft_mixed_radix_valid_size(size)) {
+      if (test_size(random, size, in, out, gold, scratch) < SRSRAN_SUCCESS) {
+        goto clean_exit;
+      }
+      count++;
+    }
+  }
+  printf("Tested %d DFT sizes up to %d\n", count, max_size);
+
+  // Transform precoding sizes
+  printf("  size; mixed radix (us); fftw (us);\n");
+  srsran_random_uniform_complex_dist_vector(random, in, max_size, -1.0f, +1.0f);
+  for (uint32_t nof_prb = 1; nof_prb * SRSRAN_NRE <= max_size; nof_prb *= 5) {
+    if (benchmark_size(nof_prb * SRSRAN_NRE, in, out, scratch) < SRSRAN_SUCCESS) {
+      goto clean_exit;
+    }
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_random_free(random);
+  if (in) {
+    free(in);
+  }
+  if (out) {
+    free(out);
+  }
+  if (gold) {
+    free(gold);
+  }
+  if (scratch) {
+    free(scratch);
+  }
+
+  printf("%s\n", ret == SRSRAN_SUCCESS ? "Ok" : "Failed");
+  return ret;
+}
@@ -36,6 +36,8 @@ static float       rx_window_offset      = 0.5f;
 static float       freq_shift_f          = 0.0f;
 static double      phase_compensation_hz = 0.0;
 static uint32_t    force_symbol_sz       = 0;
+static float       cfo                   = 0.0f;
+static float       time_offset           = 0.0f;
 static double      elapsed_us(struct timeval* ts_start, struct timeval* ts_end)
 {
   if (ts_end->tv_usec > ts_start->tv_usec) {
@@ -57,12 +59,14 @@ static void usage(char* prog)
   printf("\t-o rx window offset (portion of CP length) [Default %.1f]\n", rx_window_offset);
   printf("\t-s frequency shift (normalised with sampling rate) [Default %.1f]\n", freq_shift_f);
   printf("\t-p Phase compensation carrier frequency in Hz [Default %.1f]\n", phase_compensation_hz);
+  printf("\t-c CFO corrected by the receiver (normalised with subcarrier spacing) [Default %.1f]\n", cfo);
+  printf("\t-t Time offset corrected by the receiver (samples) [Default %.1f]\n", time_offset);
 }
 
 static void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "Nnerosp")) != -1) {
+  while ((opt = getopt(argc, argv, "Nnerosctp")) != -1) {
     switch (opt) {
       case 'n':
         nof_prb = (int)strtol(argv[optind], NULL, 10);
@@ -85,6 +89,12 @@ static void parse_args(int argc, char** argv)
       case 'p':
         phase_compensation_hz = strtod(argv[optind], NULL);
         break;
+      case 'c':
+        cfo = strtof(argv[optind], NULL);
+        break;
+      case 't':
+        time_offset = strtof(argv[optind], NULL);
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -92,6 +102,16 @@ static void parse_args(int argc, char** argv)
   }
 }
 
+// Delays the symbols in frequency domain by a fractional number of samples
+static void ofdm_test_delay(cf_t* re, uint32_t nof_re_symb, uint32_t nof_re, uint32_t symbol_sz, bool dc, float delay)
+{
+  for (uint32_t i = 0; i < nof_re; i++) {
+    int j = (int)(i % nof_re_symb) - (int)nof_re_symb / 2;
+    int k = (j < 0 || !dc) ? j : j + 1;
+    re[i] *= cexpf(-I * 2.0f * (float)M_PI * delay * (float)k / (float)symbol_sz);
+  }
+}
+
 int main(int argc, char** argv)
 {
   srsran_random_t random_gen = srsran_random_init(0);
@@ -157,6 +177,11 @@ int main(int argc, char** argv)
     // Generate Random data
     srsran_random_uniform_complex_dist_vector(random_gen, input, n_re, -1.0f, +1.0f);
 
+    // Delay every symbol by the time offset, the receiver corrects it after the DFT
+    if (isnormal(time_offset)) {
+      ofdm_test_delay(input, n_prb * SRSRAN_NRE, n_re, symbol_sz, ifft.fft_plan.dc, time_offset);
+    }
+
     // Execute Tx
     gettimeofday(&start, NULL);
     for (uint32_t i = 0; i < nof_repetitions; i++) {
@@ -165,6 +190,20 @@ int main(int argc, char** argv)
     gettimeofday(&end, NULL);
     printf(" Tx@%.1fMsps", (float)(sf_len * nof_repetitions) / elapsed_us(&start, &end));
 
+    // Add CFO with an arbitrary initial phase, the receiver corrects it while demodulating
+    if (isnormal(cfo)) {
+      float phase = srsran_random_uniform_real_dist(random_gen, -M_PI, M_PI);
+      for (uint32_t n = 0; n < sf_len; n++) {
+        outifft[n] *= cexpf(I * (float)fmod(phase + 2.0 * M_PI * cfo * n / symbol_sz, 2.0 * M_PI));
+      }
+      srsran_ofdm_rx_set_cfo(&fft, cfo, -phase);
+    }
+
+    if (isnormal(time_offset)) {
+      srsran_ofdm_rx_set_time_offset(&fft, time_offset);
+      ofdm_test_delay(input, n_prb * SRSRAN_NRE, n_re, symbol_sz, ifft.fft_plan.dc, -time_offset);
+    }
+
     // Execute Rx
     gettimeofday(&start, NULL);
     for (uint32_t i = 0; i < nof_repetitions; i++) {
@@ -48,6 +48,14 @@ int srsran_enb_ul_init(srsran_enb_ul_t* q, cf_t* in_buffer, uint32_t max_prb)
     }
     q->in_buffer = in_buffer;
 
+    // One PUCCH correlation bank per PRB pair at most
+    q->pucch_banks = SRSRAN_MEM_ALLOC(srsran_pucch_bank_t, max_prb);
+    if (!q->pucch_banks) {
+      perror("malloc");
+      goto clean_exit;
+    }
+    q->max_pucch_banks = max_prb;
+
     if (srsran_pucch_init_enb(&q->pucch)) {
       ERROR("Error creating PUCCH object");
       goto clean_exit;
@@ -90,6 +98,9 @@ void srsran_enb_ul_free(srsran_enb_ul_t* q)
     if (q->chest_res.ce) {
       free(q->chest_res.ce);
     }
+    if (q->pucch_banks) {
+      free(q->pucch_banks);
+    }
     bzero(q, sizeof(srsran_enb_ul_t));
   }
 }
@@ -153,7 +164,39 @@ void srsran_enb_ul_fft(srsran_enb_ul_t* q)
   srsran_ofdm_rx_sf(&q->fft);
 }
 
-static int get_pucch(srsran_enb_ul_t* q, srsran_ul_sf_cfg_t* ul_sf, srsran_pucch_cfg_t* cfg, srsran_pucch_res_t* res)
+// Returns the correlation bank of the PRB pair carrying the resource, computing it the first time it is used in the
+// subframe. It returns NULL if the resource has to be decoded on its own
+static const srsran_pucch_bank_t* get_pucch_bank(srsran_enb_ul_t* q, srsran_ul_sf_cfg_t* ul_sf, srsran_pucch_cfg_t* cfg)
+{
+  if (!srsran_pucch_bank_supported(cfg, q->cell.cp)) {
+    return NULL;
+  }
+
+  uint32_t m = srsran_pucch_m(cfg, q->cell.cp);
+  for (uint32_t i = 0; i < q->nof_pucch_banks; i++) {
+    if (q->pucch_banks[i].m == m && q->pucch_banks[i].group_hopping_en == cfg->group_hopping_en) {
+      return &q->pucch_banks[i];
+    }
+  }
+
+  if (q->nof_pucch_banks >= q->max_pucch_banks) {
+    return NULL;
+  }
+
+  srsran_pucch_bank_t* bank = &q->pucch_banks[q->nof_pucch_banks];
+  if (srsran_pucch_bank_compute(&q->pucch, ul_sf, m, cfg->group_hopping_en, q->sf_symbols, bank) < SRSRAN_SUCCESS) {
+    return NULL;
+  }
+  q->nof_pucch_banks++;
+
+  return bank;
+}
+
+static int get_pucch(srsran_enb_ul_t*    q,
+                     srsran_ul_sf_cfg_t* ul_sf,
+                     srsran_pucch_cfg_t* cfg,
+                     srsran_pucch_res_t* res,
+                     bool                batched)
 {
   int      ret                               = SRSRAN_SUCCESS;
   uint32_t n_pucch_i[SRSRAN_PUCCH_MAX_ALLOC] = {};
@@ -188,16 +231,26 @@ static int get_pucch(srsran_enb_ul_t* q, srsran_ul_sf_cfg_t* ul_sf, srsran_pucch
     // Configure resource
     cfg->n_pucch = n_pucch_i[i];
 
-    // Prepare configuration
-    if (srsran_chest_ul_estimate_pucch(&q->chest, ul_sf, cfg, q->sf_symbols, &q->chest_res)) {
-      ERROR("Error estimating PUCCH DMRS");
-      return SRSRAN_ERROR;
+    // Use the shared correlation bank of the PRB pair if possible, it also provides the measurements
+    const srsran_pucch_bank_t* bank = batched ? get_pucch_bank(q, ul_sf, cfg) : NULL;
+    if (bank != NULL) {
+      ret = srsran_pucch_decode_bank(&q->pucch, ul_sf, cfg, bank, &pucch_res);
+    } else {
+      // Prepare configuration
+      if (srsran_chest_ul_estimate_pucch(&q->chest, ul_sf, cfg, q->sf_symbols, &q->chest_res)) {
+        ERROR("Error estimating PUCCH DMRS");
+        return SRSRAN_ERROR;
+      }
+      pucch_res.snr_db    = q->chest_res.snr_db;
+      pucch_res.rssi_dbFs = q->chest_res.epre_dBfs;
+      pucch_res.ni_dbFs   = q->chest_res.noise_estimate_dbFs;
+
+      ret = srsran_pucch_decode(&q->pucch, ul_sf, cfg, &q->chest_res, q->sf_symbols, &pucch_res);
+      if (cfg->meas_ta_en) {
+        pucch_res.ta_valid = !(isnan(q->chest_res.ta_us) || isinf(q->chest_res.ta_us));
+        pucch_res.ta_us    = q->chest_res.ta_us;
+      }
     }
-    pucch_res.snr_db    = q->chest_res.snr_db;
-    pucch_res.rssi_dbFs = q->chest_res.epre_dBfs;
-    pucch_res.ni_dbFs   = q->chest_res.noise_estimate_dbFs;
-
-    ret = srsran_pucch_decode(&q->pucch, ul_sf, cfg, &q->chest_res, q->sf_symbols, &pucch_res);
     if (ret < SRSRAN_SUCCESS) {
       ERROR("Error decoding PUCCH");
     } else {
@@ -216,12 +269,6 @@ static int get_pucch(srsran_enb_ul_t* q, srsran_ul_sf_cfg_t* ul_sf, srsran_pucch
 
       // Compares correlation value, it stores the PUCCH result with the greatest correlation
       if (i == 0 || pucch_res.correlation > res->correlation) {
-        // Copy measurements only if PUCCH was decoded successfully
-        if (cfg->meas_ta_en) {
-          pucch_res.ta_valid = !(isnan(q->chest_res.ta_us) || isinf(q->chest_res.ta_us));
-          pucch_res.ta_us    = q->chest_res.ta_us;
-        }
-
         *res = pucch_res;
       }
     }
@@ -230,17 +277,18 @@ static int get_pucch(srsran_enb_ul_t* q, srsran_ul_sf_cfg_t* ul_sf, srsran_pucch
   return ret;
 }
 
-int srsran_enb_ul_get_pucch(srsran_enb_ul_t*    q,
-                            srsran_ul_sf_cfg_t* ul_sf,
-                            srsran_pucch_cfg_t* cfg,
-                            srsran_pucch_res_t* res)
+static int get_pucch_sr(srsran_enb_ul_t*    q,
+                        srsran_ul_sf_cfg_t* ul_sf,
+                        srsran_pucch_cfg_t* cfg,
+                        srsran_pucch_res_t* res,
+                        bool                batched)
 {
   if (!srsran_pucch_cfg_isvalid(cfg, q->cell.nof_prb)) {
     ERROR("Invalid PUCCH configuration");
     return SRSRAN_ERROR_INVALID_INPUTS;
   }
 
-  if (get_pucch(q, ul_sf, cfg, res)) {
+  if (get_pucch(q, ul_sf, cfg, res, batched)) {
     return SRSRAN_ERROR;
   }
 
@@ -254,7 +302,7 @@ int srsran_enb_ul_get_pucch(srsran_enb_ul_t*    q,
     srsran_pucch_res_t res_no_sr = {};
 
     // Actual decode without SR
-    if (get_pucch(q, ul_sf, cfg, &res_no_sr)) {
+    if (get_pucch(q, ul_sf, cfg, &res_no_sr, batched)) {
       return SRSRAN_ERROR;
     }
 
@@ -272,6 +320,41 @@ int srsran_enb_ul_get_pucch(srsran_enb_ul_t*    q,
   return SRSRAN_SUCCESS;
 }
 
+int srsran_enb_ul_get_pucch(srsran_enb_ul_t*    q,
+                            srsran_ul_sf_cfg_t* ul_sf,
+                            srsran_pucch_cfg_t* cfg,
+                            srsran_pucch_res_t* res)
+{
+  return get_pucch_sr(q, ul_sf, cfg, res, false);
+}
+
+int srsran_enb_ul_get_pucch_multi(srsran_enb_ul_t*    q,
+                                  srsran_ul_sf_cfg_t* ul_sf,
+                                  srsran_pucch_cfg_t* cfg,
+                                  srsran_pucch_res_t* res,
+                                  int*                ue_ret,
+                                  uint32_t            nof_cfg)
+{
+  if (q == NULL || ul_sf == NULL || (nof_cfg > 0 && (cfg == NULL || res == NULL || ue_ret == NULL))) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // The banks only hold the received subframe
+  q->nof_pucch_banks = 0;
+
+  int ret = SRSRAN_SUCCESS;
+  for (uint32_t i = 0; i < nof_cfg; i++) {
+    // A failing user is flagged and its result cleared, the rest are still decoded
+    ue_ret[i] = get_pucch_sr(q, ul_sf, &cfg[i], &res[i], true);
+    if (ue_ret[i] < SRSRAN_SUCCESS) {
+      bzero(&res[i], sizeof(srsran_pucch_res_t));
+      ret = SRSRAN_ERROR;
+    }
+  }
+
+  return ret;
+}
+
 int srsran_enb_ul_get_pusch(srsran_enb_ul_t*    q,
                             srsran_ul_sf_cfg_t* ul_sf,
                             srsran_pusch_cfg_t* cfg,
@@ -281,3 +364,17 @@ int srsran_enb_ul_get_pusch(srsran_enb_ul_t*    q,
 
   return srsran_pusch_decode(&q->pusch, ul_sf, cfg, &q->chest_res, q->sf_symbols, res);
 }
+
+int srsran_enb_ul_get_srs_multi(srsran_enb_ul_t*                   q,
+                                srsran_ul_sf_cfg_t*                ul_sf,
+                                srsran_refsignal_dmrs_pusch_cfg_t* pusch_cfg,
+                                srsran_refsignal_srs_cfg_t*        cfg,
+                                srsran_chest_ul_srs_res_t*         res,
+                                uint32_t                           nof_cfg)
+{
+  if (q == NULL || ul_sf == NULL || pusch_cfg == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  return srsran_chest_ul_estimate_srs_multi(&q->chest, ul_sf, cfg, pusch_cfg, q->sf_symbols, res, nof_cfg);
+}
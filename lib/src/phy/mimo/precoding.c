@@ -838,6 +838,577 @@ int srsran_precoding_mimo_2x2_gen(cf_t  W[2][2],
   return SRSRAN_SUCCESS;
 }
 
+/* Generic MIMO detector for any number of layers and receive antennas.
+ *
+ * For every RE it solves x = inv(H'H + No) H'y through the Cholesky decomposition H'H + No = G G' (No is zero for
+ * ZF). The diagonal of inv(H'H + No) gives the post-equalisation SINR of each layer, which is used for removing the
+ * MMSE bias and is reported as CSI. The SIMD implementation processes one RE per lane, so the small matrices of
+ * SRSRAN_SIMD_CF_SIZE RE are decomposed at once.
+ *
+ * The channel h[layer][rx] is the effective channel of every layer, it includes the precoding if any.
+ */
+
+/* Number of RE processed at once by the precoded detector, multiple of every CDD precoder period and SIMD size */
+#define PREDECODING_MIMO_BLOCK 48
+
+/* Period of the 36.211 Section 6.3.4.2.2 large delay CDD precoder */
+#define PREDECODING_CDD_PERIOD(NOF_PORTS, NOF_LAYERS) ((NOF_PORTS) == 4 ? 4 * (NOF_LAYERS) : (NOF_LAYERS))
+
+/* Householder vectors of the 4 antenna ports codebook (36.211 Table 6.3.4.2.3-2) */
+static const cf_t precoding_4tx_u[16][4] = {
+    {1.0f, -1.0f, -1.0f, -1.0f},
+    {1.0f, -_Complex_I, 1.0f, _Complex_I},
+    {1.0f, 1.0f, -1.0f, 1.0f},
+    {1.0f, _Complex_I, 1.0f, -_Complex_I},
+    {1.0f, (-1.0f - _Complex_I) * (float)M_SQRT1_2, -_Complex_I, (1.0f - _Complex_I) * (float)M_SQRT1_2},
+    {1.0f, (1.0f - _Complex_I) * (float)M_SQRT1_2, _Complex_I, (-1.0f - _Complex_I) * (float)M_SQRT1_2},
+    {1.0f, (1.0f + _Complex_I) * (float)M_SQRT1_2, -_Complex_I, (-1.0f + _Complex_I) * (float)M_SQRT1_2},
+    {1.0f, (-1.0f + _Complex_I) * (float)M_SQRT1_2, _Complex_I, (1.0f + _Complex_I) * (float)M_SQRT1_2},
+    {1.0f, -1.0f, 1.0f, 1.0f},
+    {1.0f, -_Complex_I, -1.0f, -_Complex_I},
+    {1.0f, 1.0f, 1.0f, -1.0f},
+    {1.0f, _Complex_I, -1.0f, _Complex_I},
+    {1.0f, -1.0f, -1.0f, 1.0f},
+    {1.0f, -1.0f, 1.0f, -1.0f},
+    {1.0f, 1.0f, -1.0f, -1.0f},
+    {1.0f, 1.0f, 1.0f, 1.0f},
+};
+
+/* Columns of the Householder matrix selected for each number of layers (36.211 Table 6.3.4.2.3-2) */
+static const uint8_t precoding_4tx_columns[16][SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS] = {
+    {{0}, {0, 3}, {0, 1, 3}, {0, 1, 2, 3}},
+    {{0}, {0, 1}, {0, 1, 2}, {0, 1, 2, 3}},
+    {{0}, {0, 1}, {0, 1, 2}, {2, 1, 0, 3}},
+    {{0}, {0, 1}, {0, 1, 2}, {2, 1, 0, 3}},
+    {{0}, {0, 3}, {0, 1, 3}, {0, 1, 2, 3}},
+    {{0}, {0, 3}, {0, 1, 3}, {0, 1, 2, 3}},
+    {{0}, {0, 2}, {0, 2, 3}, {0, 2, 1, 3}},
+    {{0}, {0, 2}, {0, 2, 3}, {0, 2, 1, 3}},
+    {{0}, {0, 1}, {0, 1, 3}, {0, 1, 2, 3}},
+    {{0}, {0, 3}, {0, 2, 3}, {0, 1, 2, 3}},
+    {{0}, {0, 2}, {0, 1, 2}, {0, 2, 1, 3}},
+    {{0}, {0, 2}, {0, 2, 3}, {0, 2, 1, 3}},
+    {{0}, {0, 1}, {0, 1, 2}, {0, 1, 2, 3}},
+    {{0}, {0, 2}, {0, 1, 2}, {0, 2, 1, 3}},
+    {{0}, {0, 2}, {0, 1, 2}, {2, 1, 0, 3}},
+    {{0}, {0, 1}, {0, 1, 2}, {0, 1, 2, 3}},
+};
+
+/* Closed loop spatial multiplexing precoding matrix W[port][layer] (36.211 Tables 6.3.4.2.3-1 and 6.3.4.2.3-2) */
+static int
+precoding_codebook(int nof_ports, int nof_layers, int codebook_idx, cf_t W[SRSRAN_MAX_PORTS][SRSRAN_MAX_LAYERS])
+{
+  if (nof_ports == 2 && nof_layers == 1 && codebook_idx >= 0 && codebook_idx < 4) {
+    const cf_t w1[4] = {1.0f, -1.0f, _Complex_I, -_Complex_I};
+    W[0][0]          = M_SQRT1_2;
+    W[1][0]          = w1[codebook_idx] * (float)M_SQRT1_2;
+    return SRSRAN_SUCCESS;
+  }
+
+  if (nof_ports == 2 && nof_layers == 2 && codebook_idx >= 0 && codebook_idx < 3) {
+    if (codebook_idx == 0) {
+      W[0][0] = M_SQRT1_2;
+      W[0][1] = 0.0f;
+      W[1][0] = 0.0f;
+      W[1][1] = M_SQRT1_2;
+    } else {
+      cf_t w1 = (codebook_idx == 1) ? 1.0f : _Complex_I;
+      W[0][0] = 0.5f;
+      W[0][1] = 0.5f;
+      W[1][0] = 0.5f * w1;
+      W[1][1] = -0.5f * w1;
+    }
+    return SRSRAN_SUCCESS;
+  }
+
+  if (nof_ports == 4 && nof_layers > 0 && nof_layers <= 4 && codebook_idx >= 0 && codebook_idx < 16) {
+    // W_n = I - 2 u_n u_n' / (u_n' u_n), every u_n has norm 2
+    const cf_t* u    = precoding_4tx_u[codebook_idx];
+    float       norm = 1.0f / sqrtf((float)nof_layers);
+    for (int p = 0; p < nof_ports; p++) {
+      for (int l = 0; l < nof_layers; l++) {
+        uint32_t c = precoding_4tx_columns[codebook_idx][nof_layers - 1][l];
+        W[p][l]    = ((p == c ? 1.0f : 0.0f) - 0.5f * u[p] * conjf(u[c])) * norm;
+      }
+    }
+    return SRSRAN_SUCCESS;
+  }
+
+  ERROR("Invalid multiplex combination: codebook_idx=%d, nof_layers=%d, nof_ports=%d",
+        codebook_idx,
+        nof_layers,
+        nof_ports);
+  return SRSRAN_ERROR;
+}
+
+/* Large delay CDD precoding matrix W(i) D(i) U for the symbol i (36.211 Section 6.3.4.2.2) */
+static int precoding_cdd_matrix(int nof_ports, int nof_layers, uint32_t i, cf_t P[SRSRAN_MAX_PORTS][SRSRAN_MAX_LAYERS])
+{
+  cf_t W[SRSRAN_MAX_PORTS][SRSRAN_MAX_LAYERS] = {};
+  if (nof_ports == 2 && nof_layers == 2) {
+    W[0][0] = M_SQRT1_2;
+    W[1][1] = M_SQRT1_2;
+  } else if (nof_ports == 4 && nof_layers > 1 && nof_layers <= 4) {
+    // Cycles through the codebook indexes 12 to 15 every nof_layers symbols
+    precoding_codebook(nof_ports, nof_layers, 12 + (int)((i / nof_layers) % 4), W);
+  } else {
+    ERROR("Invalid CDD combination: nof_layers=%d, nof_ports=%d", nof_layers, nof_ports);
+    return SRSRAN_ERROR;
+  }
+
+  // D(i) U is e^(-j 2 pi k (i + l) / v) / sqrt(v) for the row k and column l
+  float norm = 1.0f / sqrtf((float)nof_layers);
+  for (int p = 0; p < nof_ports; p++) {
+    for (int l = 0; l < nof_layers; l++) {
+      P[p][l] = 0.0f;
+      for (int k = 0; k < nof_layers; k++) {
+        P[p][l] += W[p][k] * cexpf(-_Complex_I * 2.0f * (float)M_PI * (float)((k * (i + l)) % nof_layers) / nof_layers);
+      }
+      P[p][l] *= norm;
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+/* Arguments of the generic MIMO detector, common to all the RE */
+typedef struct {
+  cf_t*    y[SRSRAN_MAX_PORTS];
+  cf_t*    h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS];
+  cf_t*    x[SRSRAN_MAX_LAYERS];
+  float*   csi[SRSRAN_MAX_LAYERS];
+  uint32_t csi_stride[SRSRAN_MAX_LAYERS];
+  int      nof_rxant;
+  int      nof_layers;
+  int      nof_ports;
+  float    scaling;
+  float    noise_estimate;
+  bool     mmse;
+
+  // Precoder coefficients w[port][layer][i % PREDECODING_MIMO_BLOCK], h is the channel of each port if present
+  cf_t (*w)[SRSRAN_MAX_LAYERS][PREDECODING_MIMO_BLOCK];
+} predecoding_mimo_args_t;
+
+static void predecoding_mimo_gen(const predecoding_mimo_args_t* q, int i)
+{
+  cf_t  hh[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS];
+  cf_t  z[SRSRAN_MAX_LAYERS];
+  cf_t  g[SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS];
+  float a_diag[SRSRAN_MAX_LAYERS];
+  float g_rcp[SRSRAN_MAX_LAYERS];
+
+  for (int j = 0; j < q->nof_layers; j++) {
+    for (int r = 0; r < q->nof_rxant; r++) {
+      if (q->w) {
+        hh[j][r] = 0.0f;
+        for (int p = 0; p < q->nof_ports; p++) {
+          hh[j][r] += q->h[p][r][i] * q->w[p][j][i % PREDECODING_MIMO_BLOCK];
+        }
+      } else {
+        hh[j][r] = q->h[j][r][i];
+      }
+    }
+  }
+
+  /* 1. z = H' y and A = H' H + No, lower triangle only */
+  for (int j = 0; j < q->nof_layers; j++) {
+    z[j]      = 0.0f;
+    a_diag[j] = q->mmse ? q->noise_estimate : 0.0f;
+    for (int r = 0; r < q->nof_rxant; r++) {
+      z[j] += conjf(hh[j][r]) * q->y[r][i];
+      a_diag[j] += __real__ hh[j][r] * __real__ hh[j][r] + __imag__ hh[j][r] * __imag__ hh[j][r];
+    }
+    for (int k = 0; k < j; k++) {
+      g[j][k] = 0.0f;
+      for (int r = 0; r < q->nof_rxant; r++) {
+        g[j][k] += conjf(hh[j][r]) * hh[k][r];
+      }
+    }
+  }
+
+  /* 2. A = G G', the diagonal of G is real and only its inverse is kept */
+  for (int j = 0; j < q->nof_layers; j++) {
+    float d = a_diag[j];
+    for (int k = 0; k < j; k++) {
+      d -= __real__ g[j][k] * __real__ g[j][k] + __imag__ g[j][k] * __imag__ g[j][k];
+    }
+    g_rcp[j] = 1.0f / sqrtf(d);
+    for (int m = j + 1; m < q->nof_layers; m++) {
+      for (int k = 0; k < j; k++) {
+        g[m][j] -= g[m][k] * conjf(g[j][k]);
+      }
+      g[m][j] *= g_rcp[j];
+    }
+  }
+
+  /* 3. Solve G u = z and G' x = u */
+  for (int j = 0; j < q->nof_layers; j++) {
+    for (int k = 0; k < j; k++) {
+      z[j] -= g[j][k] * z[k];
+    }
+    z[j] *= g_rcp[j];
+  }
+  for (int j = q->nof_layers - 1; j >= 0; j--) {
+    for (int k = j + 1; k < q->nof_layers; k++) {
+      z[j] -= conjf(g[k][j]) * z[k];
+    }
+    z[j] *= g_rcp[j];
+  }
+
+  /* 4. Diagonal of inv(A) from the columns of inv(G) and post-equalisation SINR */
+  float nv = q->noise_estimate > 0.0f ? q->noise_estimate : 1.0f;
+  for (int j = 0; j < q->nof_layers; j++) {
+    cf_t  m[SRSRAN_MAX_LAYERS];
+    float b = g_rcp[j] * g_rcp[j];
+    m[j]    = g_rcp[j];
+    for (int n = j + 1; n < q->nof_layers; n++) {
+      m[n] = 0.0f;
+      for (int k = j; k < n; k++) {
+        m[n] -= g[n][k] * m[k];
+      }
+      m[n] *= g_rcp[n];
+      b += __real__ m[n] * __real__ m[n] + __imag__ m[n] * __imag__ m[n];
+    }
+
+    float sinr = 1.0f / (nv * b);
+    float norm = 1.0f / q->scaling;
+    if (q->mmse) {
+      // The MMSE estimate is scaled by sinr / (1 + sinr)
+      sinr = SRSRAN_MAX(sinr - 1.0f, 0.0f);
+      norm *= (1.0f + sinr) / SRSRAN_MAX(sinr, 1e-6f);
+    }
+
+    q->x[j][i] = z[j] * norm;
+    if (q->csi[j]) {
+      q->csi[j][i * q->csi_stride[j]] = sinr;
+    }
+  }
+}
+
+#if SRSRAN_SIMD_CF_SIZE != 0
+
+/* Only lane wise operations are used, so the real and imaginary parts keep the srsran_simd_cfi_load lane order */
+#ifdef HAVE_NEON
+#define PREDECODING_MIMO_RE(A) ((A).val[0])
+#define PREDECODING_MIMO_IM(A) ((A).val[1])
+#else /* HAVE_NEON */
+#define PREDECODING_MIMO_RE(A) ((A).re)
+#define PREDECODING_MIMO_IM(A) ((A).im)
+#endif /* HAVE_NEON */
+
+static inline simd_f_t predecoding_mimo_abs2(simd_cf_t a)
+{
+  return srsran_simd_f_add(srsran_simd_f_mul(PREDECODING_MIMO_RE(a), PREDECODING_MIMO_RE(a)),
+                           srsran_simd_f_mul(PREDECODING_MIMO_IM(a), PREDECODING_MIMO_IM(a)));
+}
+
+static inline simd_cf_t predecoding_mimo_scale(simd_cf_t a, simd_f_t b)
+{
+  PREDECODING_MIMO_RE(a) = srsran_simd_f_mul(PREDECODING_MIMO_RE(a), b);
+  PREDECODING_MIMO_IM(a) = srsran_simd_f_mul(PREDECODING_MIMO_IM(a), b);
+  return a;
+}
+
+/* Reciprocal refined with one Newton-Raphson iteration, the estimate alone is not accurate enough for the inversion */
+static inline simd_f_t predecoding_mimo_rcp(simd_f_t a)
+{
+  simd_f_t r = srsran_simd_f_rcp(a);
+  return srsran_simd_f_mul(r, srsran_simd_f_sub(srsran_simd_f_set1(2.0f), srsran_simd_f_mul(a, r)));
+}
+
+/* Inlined with a constant number of layers, so the loops over the small matrices are unrolled */
+static inline __attribute__((always_inline)) void
+predecoding_mimo_simd(const predecoding_mimo_args_t* q, int i, const int nof_layers)
+{
+  simd_cf_t hh[SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS];
+  simd_cf_t yy[SRSRAN_MAX_PORTS];
+  simd_cf_t z[SRSRAN_MAX_LAYERS];
+  simd_cf_t g[SRSRAN_MAX_LAYERS][SRSRAN_MAX_LAYERS];
+  simd_f_t  a_diag[SRSRAN_MAX_LAYERS];
+  simd_f_t  g_rcp[SRSRAN_MAX_LAYERS];
+
+  for (int r = 0; r < q->nof_rxant; r++) {
+    yy[r] = srsran_simd_cfi_loadu(&q->y[r][i]);
+    if (q->w) {
+      simd_cf_t hp[SRSRAN_MAX_PORTS];
+      for (int p = 0; p < q->nof_ports; p++) {
+        hp[p] = srsran_simd_cfi_loadu(&q->h[p][r][i]);
+      }
+      for (int j = 0; j < nof_layers; j++) {
+        hh[j][r] = srsran_simd_cf_prod(hp[0], srsran_simd_cfi_load(&q->w[0][j][i % PREDECODING_MIMO_BLOCK]));
+        for (int p = 1; p < q->nof_ports; p++) {
+          hh[j][r] = srsran_simd_cf_add(
+              hh[j][r], srsran_simd_cf_prod(hp[p], srsran_simd_cfi_load(&q->w[p][j][i % PREDECODING_MIMO_BLOCK])));
+        }
+      }
+    } else {
+      for (int j = 0; j < nof_layers; j++) {
+        hh[j][r] = srsran_simd_cfi_loadu(&q->h[j][r][i]);
+      }
+    }
+  }
+
+  /* 1. z = H' y and A = H' H + No, lower triangle only */
+  for (int j = 0; j < nof_layers; j++) {
+    z[j]      = srsran_simd_cf_zero();
+    a_diag[j] = srsran_simd_f_set1(q->mmse ? q->noise_estimate : 0.0f);
+    for (int r = 0; r < q->nof_rxant; r++) {
+      z[j]      = srsran_simd_cf_add(z[j], srsran_simd_cf_conjprod(yy[r], hh[j][r]));
+      a_diag[j] = srsran_simd_f_add(a_diag[j], predecoding_mimo_abs2(hh[j][r]));
+    }
+    for (int k = 0; k < j; k++) {
+      g[j][k] = srsran_simd_cf_zero();
+      for (int r = 0; r < q->nof_rxant; r++) {
+        g[j][k] = srsran_simd_cf_add(g[j][k], srsran_simd_cf_conjprod(hh[k][r], hh[j][r]));
+      }
+    }
+  }
+
+  /* 2. A = G G', the diagonal of G is real and only its inverse is kept */
+  for (int j = 0; j < nof_layers; j++) {
+    simd_f_t d = a_diag[j];
+    for (int k = 0; k < j; k++) {
+      d = srsran_simd_f_sub(d, predecoding_mimo_abs2(g[j][k]));
+    }
+    g_rcp[j] = predecoding_mimo_rcp(srsran_simd_f_sqrt(d));
+    for (int m = j + 1; m < nof_layers; m++) {
+      for (int k = 0; k < j; k++) {
+        g[m][j] = srsran_simd_cf_sub(g[m][j], srsran_simd_cf_conjprod(g[m][k], g[j][k]));
+      }
+      g[m][j] = predecoding_mimo_scale(g[m][j], g_rcp[j]);
+    }
+  }
+
+  /* 3. Solve G u = z and G' x = u */
+  for (int j = 0; j < nof_layers; j++) {
+    for (int k = 0; k < j; k++) {
+      z[j] = srsran_simd_cf_sub(z[j], srsran_simd_cf_prod(g[j][k], z[k]));
+    }
+    z[j] = predecoding_mimo_scale(z[j], g_rcp[j]);
+  }
+  for (int j = nof_layers - 1; j >= 0; j--) {
+    for (int k = j + 1; k < nof_layers; k++) {
+      z[j] = srsran_simd_cf_sub(z[j], srsran_simd_cf_conjprod(z[k], g[k][j]));
+    }
+    z[j] = predecoding_mimo_scale(z[j], g_rcp[j]);
+  }
+
+  /* 4. Diagonal of inv(A) from the columns of inv(G) and post-equalisation SINR */
+  simd_f_t nv = srsran_simd_f_set1(q->noise_estimate > 0.0f ? q->noise_estimate : 1.0f);
+  for (int j = 0; j < nof_layers; j++) {
+    simd_cf_t m[SRSRAN_MAX_LAYERS];
+    simd_f_t  b = srsran_simd_f_mul(g_rcp[j], g_rcp[j]);
+    for (int n = j + 1; n < nof_layers; n++) {
+      // The column j of inv(G) starts with the real value g_rcp[j]
+      m[n] = predecoding_mimo_scale(g[n][j], g_rcp[j]);
+      for (int k = j + 1; k < n; k++) {
+        m[n] = srsran_simd_cf_add(m[n], srsran_simd_cf_prod(g[n][k], m[k]));
+      }
+      m[n] = predecoding_mimo_scale(m[n], srsran_simd_f_neg(g_rcp[n]));
+      b    = srsran_simd_f_add(b, predecoding_mimo_abs2(m[n]));
+    }
+
+    simd_f_t sinr = predecoding_mimo_rcp(srsran_simd_f_mul(nv, b));
+    simd_f_t norm = srsran_simd_f_set1(1.0f / q->scaling);
+    if (q->mmse) {
+      // The MMSE estimate is scaled by sinr / (1 + sinr)
+      simd_f_t one = srsran_simd_f_set1(1.0f);
+      simd_f_t eps = srsran_simd_f_set1(1e-6f);
+      sinr         = srsran_simd_f_sub(sinr, one);
+      sinr         = srsran_simd_f_select(srsran_simd_f_zero(), sinr, srsran_simd_f_max(sinr, srsran_simd_f_zero()));
+      simd_f_t den = srsran_simd_f_select(eps, sinr, srsran_simd_f_max(sinr, eps));
+      norm = srsran_simd_f_mul(norm, srsran_simd_f_mul(srsran_simd_f_add(sinr, one), predecoding_mimo_rcp(den)));
+    }
+
+    srsran_simd_cfi_storeu(&q->x[j][i], predecoding_mimo_scale(z[j], norm));
+    if (q->csi[j]) {
+      // Stores the SINR as a complex vector for restoring the natural lane order
+      simd_cf_t csi_v;
+      cf_t      csi_buf[SRSRAN_SIMD_CF_SIZE] __attribute__((aligned(64)));
+      PREDECODING_MIMO_RE(csi_v) = sinr;
+      PREDECODING_MIMO_IM(csi_v) = srsran_simd_f_zero();
+      srsran_simd_cfi_store(csi_buf, csi_v);
+      for (int k = 0; k < SRSRAN_SIMD_CF_SIZE; k++) {
+        q->csi[j][(i + k) * q->csi_stride[j]] = __real__ csi_buf[k];
+      }
+    }
+  }
+}
+
+#endif /* SRSRAN_SIMD_CF_SIZE != 0 */
+
+static void predecoding_mimo_run(const predecoding_mimo_args_t* q, int nof_symbols)
+{
+  int i = 0;
+
+#if SRSRAN_SIMD_CF_SIZE != 0
+  for (; i < nof_symbols - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+    switch (q->nof_layers) {
+      case 1:
+        predecoding_mimo_simd(q, i, 1);
+        break;
+      case 2:
+        predecoding_mimo_simd(q, i, 2);
+        break;
+      case 3:
+        predecoding_mimo_simd(q, i, 3);
+        break;
+      default:
+        predecoding_mimo_simd(q, i, 4);
+        break;
+    }
+  }
+#endif /* SRSRAN_SIMD_CF_SIZE != 0 */
+
+  for (; i < nof_symbols; i++) {
+    predecoding_mimo_gen(q, i);
+  }
+}
+
+int srsran_predecoding_mimo(cf_t*  y[SRSRAN_MAX_PORTS],
+                            cf_t*  h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                            cf_t*  x[SRSRAN_MAX_LAYERS],
+                            float* sinr[SRSRAN_MAX_LAYERS],
+                            int    nof_rxant,
+                            int    nof_layers,
+                            int    nof_symbols,
+                            float  scaling,
+                            float  noise_estimate)
+{
+  if (nof_rxant < 1 || nof_rxant > SRSRAN_MAX_PORTS || nof_layers < 1 || nof_layers > SRSRAN_MAX_LAYERS) {
+    ERROR("Invalid MIMO detector combination: nof_rxant=%d, nof_layers=%d", nof_rxant, nof_layers);
+    return SRSRAN_ERROR;
+  }
+
+  predecoding_mimo_args_t q = {};
+  q.nof_rxant               = nof_rxant;
+  q.nof_layers              = nof_layers;
+  q.scaling                 = scaling;
+  q.noise_estimate          = noise_estimate;
+  q.mmse                    = mimo_decoder == SRSRAN_MIMO_DECODER_MMSE && noise_estimate > 0.0f;
+  for (int r = 0; r < nof_rxant; r++) {
+    q.y[r] = y[r];
+  }
+  for (int j = 0; j < nof_layers; j++) {
+    for (int r = 0; r < nof_rxant; r++) {
+      q.h[j][r] = h[j][r];
+    }
+    q.x[j]          = x[j];
+    q.csi[j]        = sinr ? sinr[j] : NULL;
+    q.csi_stride[j] = 1;
+  }
+
+  predecoding_mimo_run(&q, nof_symbols);
+
+  return SRSRAN_SUCCESS;
+}
+
+/* Detects the layers precoded with P(i) = P[i % nof_precoders], the CSI is written per codeword after the layer
+ * demapping of 36.211 Section 6.3.3.2 */
+static int predecoding_mimo_precoded(cf_t*                 y[SRSRAN_MAX_PORTS],
+                                     cf_t*                 h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                                     cf_t*                 x[SRSRAN_MAX_LAYERS],
+                                     float*                csi[SRSRAN_MAX_CODEWORDS],
+                                     int                   nof_rxant,
+                                     int                   nof_ports,
+                                     int                   nof_layers,
+                                     cf_t                  P[][SRSRAN_MAX_PORTS][SRSRAN_MAX_LAYERS],
+                                     int                   nof_precoders,
+                                     int                   nof_symbols,
+                                     float                 scaling,
+                                     float                 noise_estimate,
+                                     srsran_mimo_decoder_t decoder)
+{
+  cf_t w[SRSRAN_MAX_PORTS][SRSRAN_MAX_LAYERS][PREDECODING_MIMO_BLOCK] __attribute__((aligned(64)));
+
+  if (nof_rxant < 1 || nof_rxant > SRSRAN_MAX_PORTS || PREDECODING_MIMO_BLOCK % nof_precoders != 0) {
+    ERROR("Invalid MIMO detector combination: nof_rxant=%d, nof_precoders=%d", nof_rxant, nof_precoders);
+    return SRSRAN_ERROR;
+  }
+
+  predecoding_mimo_args_t q = {};
+  q.nof_rxant               = nof_rxant;
+  q.nof_layers              = nof_layers;
+  q.nof_ports               = nof_ports;
+  q.scaling                 = scaling;
+  q.noise_estimate          = noise_estimate;
+  q.mmse                    = decoder == SRSRAN_MIMO_DECODER_MMSE && noise_estimate > 0.0f;
+  q.w                       = w;
+  for (int r = 0; r < nof_rxant; r++) {
+    q.y[r] = y[r];
+    for (int p = 0; p < nof_ports; p++) {
+      q.h[p][r] = h[p][r];
+    }
+  }
+
+  // Precoder coefficients of every RE in a block
+  for (int p = 0; p < nof_ports; p++) {
+    for (int l = 0; l < nof_layers; l++) {
+      for (int k = 0; k < PREDECODING_MIMO_BLOCK; k++) {
+        w[p][l][k] = P[k % nof_precoders][p][l];
+      }
+    }
+  }
+
+  // Codeword 0 takes the first half of the layers and codeword 1 the rest
+  int nof_cw          = SRSRAN_MIN(nof_layers, SRSRAN_MAX_CODEWORDS);
+  int nof_layers_cw[] = {nof_layers / nof_cw, nof_layers - nof_layers / nof_cw};
+  for (int l = 0; l < nof_layers; l++) {
+    int cw          = (l < nof_layers_cw[0]) ? 0 : 1;
+    q.x[l]          = x[l];
+    q.csi[l]        = (csi && csi[0] && csi[cw]) ? csi[cw] + l - cw * nof_layers_cw[0] : NULL;
+    q.csi_stride[l] = nof_layers_cw[cw];
+  }
+
+  predecoding_mimo_run(&q, nof_symbols);
+
+  return SRSRAN_SUCCESS;
+}
+
+static int predecoding_mimo_multiplex(cf_t*                 y[SRSRAN_MAX_PORTS],
+                                      cf_t*                 h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                                      cf_t*                 x[SRSRAN_MAX_LAYERS],
+                                      float*                csi[SRSRAN_MAX_CODEWORDS],
+                                      int                   nof_rxant,
+                                      int                   nof_ports,
+                                      int                   nof_layers,
+                                      int                   codebook_idx,
+                                      int                   nof_symbols,
+                                      float                 scaling,
+                                      float                 noise_estimate,
+                                      srsran_mimo_decoder_t decoder)
+{
+  cf_t P[1][SRSRAN_MAX_PORTS][SRSRAN_MAX_LAYERS] = {};
+  if (precoding_codebook(nof_ports, nof_layers, codebook_idx, P[0]) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  return predecoding_mimo_precoded(
+      y, h, x, csi, nof_rxant, nof_ports, nof_layers, P, 1, nof_symbols, scaling, noise_estimate, decoder);
+}
+
+static int predecoding_mimo_cdd(cf_t*                 y[SRSRAN_MAX_PORTS],
+                                cf_t*                 h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
+                                cf_t*                 x[SRSRAN_MAX_LAYERS],
+                                float*                csi[SRSRAN_MAX_CODEWORDS],
+                                int                   nof_rxant,
+                                int                   nof_ports,
+                                int                   nof_layers,
+                                int                   nof_symbols,
+                                float                 scaling,
+                                float                 noise_estimate,
+                                srsran_mimo_decoder_t decoder)
+{
+  cf_t P[4 * SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS][SRSRAN_MAX_LAYERS] = {};
+  int  nof_precoders = PREDECODING_CDD_PERIOD(nof_ports, nof_layers);
+  for (int i = 0; i < nof_precoders; i++) {
+    if (precoding_cdd_matrix(nof_ports, nof_layers, (uint32_t)i, P[i]) < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+  }
+  return predecoding_mimo_precoded(
+      y, h, x, csi, nof_rxant, nof_ports, nof_layers, P, nof_precoders, nof_symbols, scaling, noise_estimate, decoder);
+}
+
 static int srsran_predecoding_ccd_2x2_zf_csi(cf_t*  y[SRSRAN_MAX_PORTS],
                                              cf_t*  h[SRSRAN_MAX_PORTS][SRSRAN_MAX_PORTS],
                                              cf_t*  x[SRSRAN_MAX_LAYERS],
@@ -1032,12 +1603,9 @@ static int srsran_predecoding_ccd_zf(cf_t*  y[SRSRAN_MAX_PORTS],
       ERROR("Error predecoding CCD: Invalid number of layers %d", nof_layers);
       return -1;
     }
-  } else if (nof_ports == 4) {
-    ERROR("Error predecoding CCD: Only 2 ports supported");
-  } else {
-    ERROR("Error predecoding CCD: Invalid combination of ports %d and rx antennax %d", nof_ports, nof_rxant);
   }
-  return SRSRAN_ERROR;
+  return predecoding_mimo_cdd(
+      y, h, x, csi, nof_rxant, nof_ports, nof_layers, nof_symbols, scaling, 0.0f, SRSRAN_MIMO_DECODER_ZF);
 }
 
 static int srsran_predecoding_ccd_2x2_mmse_csi(cf_t*  y[SRSRAN_MAX_PORTS],
@@ -1215,12 +1783,9 @@ int srsran_predecoding_ccd_mmse(cf_t*  y[SRSRAN_MAX_PORTS],
       ERROR("Error predecoding CCD: Invalid number of layers %d", nof_layers);
       return -1;
     }
-  } else if (nof_ports == 4) {
-    ERROR("Error predecoding CCD: Only 2 ports supported");
-  } else {
-    ERROR("Error predecoding CCD: Invalid combination of ports %d and rx antennax %d", nof_ports, nof_rxant);
   }
-  return SRSRAN_ERROR;
+  return predecoding_mimo_cdd(
+      y, h, x, csi, nof_rxant, nof_ports, nof_layers, nof_symbols, scaling, noise_estimate, SRSRAN_MIMO_DECODER_MMSE);
 }
 
 static int srsran_predecoding_multiplex_2x2_zf_csi(cf_t*  y[SRSRAN_MAX_PORTS],
@@ -1849,12 +2414,9 @@ static int srsran_predecoding_multiplex(cf_t*  y[SRSRAN_MAX_PORTS],
         return srsran_predecoding_multiplex_2x1_mrc(y, h, x, codebook_idx, nof_symbols, scaling);
       }
     }
-  } else if (nof_ports == 4) {
-    ERROR("Error predecoding multiplex: not implemented for %d Tx ports", nof_ports);
-  } else {
-    ERROR("Error predecoding multiplex: Invalid combination of ports %d and rx antennas %d", nof_ports, nof_rxant);
   }
-  return SRSRAN_ERROR;
+  return predecoding_mimo_multiplex(
+      y, h, x, csi, nof_rxant, nof_ports, nof_layers, codebook_idx, nof_symbols, scaling, noise_estimate, mimo_decoder);
 }
 
 void srsran_predecoding_set_mimo_decoder(srsran_mimo_decoder_t _mimo_decoder)
@@ -1887,17 +2449,12 @@ int srsran_predecoding_type(cf_t*              y[SRSRAN_MAX_PORTS],
 
   switch (type) {
     case SRSRAN_TXSCHEME_CDD:
-      if (nof_layers == 2) {
-        switch (mimo_decoder) {
-          case SRSRAN_MIMO_DECODER_ZF:
-            return srsran_predecoding_ccd_zf(y, h, x, csi, nof_rxant, nof_ports, nof_layers, nof_symbols, scaling);
-          case SRSRAN_MIMO_DECODER_MMSE:
-            return srsran_predecoding_ccd_mmse(
-                y, h, x, csi, nof_rxant, nof_ports, nof_layers, nof_symbols, scaling, noise_estimate);
-        }
-      } else {
-        ERROR("Invalid number of layers %d", nof_layers);
-        return SRSRAN_ERROR;
+      switch (mimo_decoder) {
+        case SRSRAN_MIMO_DECODER_ZF:
+          return srsran_predecoding_ccd_zf(y, h, x, csi, nof_rxant, nof_ports, nof_layers, nof_symbols, scaling);
+        case SRSRAN_MIMO_DECODER_MMSE:
+          return srsran_predecoding_ccd_mmse(
+              y, h, x, csi, nof_rxant, nof_ports, nof_layers, nof_symbols, scaling, noise_estimate);
       }
       return SRSRAN_ERROR;
     case SRSRAN_TXSCHEME_PORT0:
@@ -2054,6 +2611,28 @@ int srsran_precoding_cdd_2x2_gen(cf_t* x[SRSRAN_MAX_LAYERS], cf_t* y[SRSRAN_MAX_
   return 2 * nof_symbols;
 }
 
+/* Precodes the layers with P(i) = P[i % nof_precoders] */
+static void precoding_mimo_gen(cf_t* x[SRSRAN_MAX_LAYERS],
+                               cf_t* y[SRSRAN_MAX_PORTS],
+                               int   nof_layers,
+                               int   nof_ports,
+                               cf_t  P[][SRSRAN_MAX_PORTS][SRSRAN_MAX_LAYERS],
+                               int   nof_precoders,
+                               int   nof_symbols,
+                               float scaling)
+{
+  for (int i = 0; i < nof_symbols; i++) {
+    cf_t(*W)[SRSRAN_MAX_LAYERS] = P[i % nof_precoders];
+    for (int p = 0; p < nof_ports; p++) {
+      cf_t acc = 0.0f;
+      for (int l = 0; l < nof_layers; l++) {
+        acc += W[p][l] * x[l][i];
+      }
+      y[p][i] = acc * scaling;
+    }
+  }
+}
+
 int srsran_precoding_cdd(cf_t* x[SRSRAN_MAX_LAYERS],
                          cf_t* y[SRSRAN_MAX_PORTS],
                          int   nof_layers,
@@ -2076,8 +2655,15 @@ int srsran_precoding_cdd(cf_t* x[SRSRAN_MAX_LAYERS],
 #endif /* LV_HAVE_SSE */
 #endif /* LV_HAVE_AVX */
   } else if (nof_ports == 4) {
-    ERROR("Not implemented");
-    return -1;
+    cf_t P[4 * SRSRAN_MAX_LAYERS][SRSRAN_MAX_PORTS][SRSRAN_MAX_LAYERS] = {};
+    int  nof_precoders = PREDECODING_CDD_PERIOD(nof_ports, nof_layers);
+    for (int i = 0; i < nof_precoders; i++) {
+      if (precoding_cdd_matrix(nof_ports, nof_layers, (uint32_t)i, P[i]) < SRSRAN_SUCCESS) {
+        return SRSRAN_ERROR;
+      }
+    }
+    precoding_mimo_gen(x, y, nof_layers, nof_ports, P, nof_precoders, nof_symbols, scaling);
+    return nof_ports * nof_symbols;
   } else {
     ERROR("Number of ports must be 2 or 4 for transmit diversity (nof_ports=%d)", nof_ports);
     return -1;
@@ -2204,6 +2790,12 @@ int srsran_precoding_multiplex(cf_t*    x[SRSRAN_MAX_LAYERS],
     } else {
       ERROR("Not implemented");
     }
+  } else if (nof_ports == 4) {
+    cf_t P[1][SRSRAN_MAX_PORTS][SRSRAN_MAX_LAYERS] = {};
+    if (precoding_codebook(nof_ports, nof_layers, codebook_idx, P[0]) < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+    precoding_mimo_gen(x, y, nof_layers, nof_ports, P, 1, (int)nof_symbols, scaling);
   } else {
     ERROR("Not implemented");
   }
@@ -201,8 +201,8 @@ int main(int argc, char** argv)
       nof_re = nof_symbols;
       break;
     case SRSRAN_TXSCHEME_CDD:
-      nof_re = nof_symbols * nof_tx_ports / nof_layers;
-      if (nof_rx_ports != 2 || nof_tx_ports != 2) {
+      nof_re = nof_symbols;
+      if (nof_rx_ports < nof_layers || (nof_tx_ports != 2 && nof_tx_ports != 4)) {
         ERROR("CDD nof_tx_ports=%d nof_rx_ports=%d is not currently supported", nof_tx_ports, nof_rx_ports);
         exit(-1);
       }
@@ -26,6 +26,7 @@
 #include "srsran/phy/modem/demod_soft.h"
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd.h"
 #include "srsran/phy/utils/vector.h"
 
 #ifdef HAVE_NEONv8
@@ -777,72 +778,173 @@ void demod_64qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 #endif
 }
 
-void demod_256qam_lte(const cf_t* symbols, float* llr, int nsymbols)
+/*
+ * Generic square QAM soft demodulator. Every symbol component y produces nof_levels LLR as:
+ *   LLR_0 = -gain * y
+ *   LLR_k = |LLR_k-1| - threshold_k
+ * The LLR of every symbol can be weighted, typically by its post-equalization SNR. The weight is applied to y and to
+ * the thresholds in the same pass, which is equivalent to scaling the LLR afterwards as long as it is not negative.
+ */
+#define DEMOD_SOFT_MAX_LEVELS 4
+#define DEMOD_SOFT_CHUNK 256
+
+typedef struct {
+  uint32_t nof_levels;
+  float    gain;
+  float    thresholds[DEMOD_SOFT_MAX_LEVELS - 1];
+} demod_qam_t;
+
+static const demod_qam_t demod_qam[SRSRAN_MOD_NITEMS] = {
+    /* BPSK   */ {0, 0.0f, {}},
+    /* QPSK   */ {1, M_SQRT2, {}},
+    /* 16QAM  */ {2, 1.0f, {0.632455532f}},
+    /* 64QAM  */ {3, 1.0f, {0.617213400f, 0.308606700f}},
+    /* 256QAM */ {4, 1.0f, {0.613571991f, 0.306785996f, 0.153392998f}},
+};
+
+#if SRSRAN_SIMD_F_SIZE
+// Loads SRSRAN_SIMD_F_SIZE / 2 weights repeating each of them twice, one for the real and one for the imaginary part
+static inline simd_f_t demod_simd_f_load_pairs(const float* w)
 {
-  for (int i = 0; i < nsymbols; i++) {
-    float real = -__real__ symbols[i];
-    float imag = -__imag__ symbols[i];
-    *(llr++)   = real;
-    *(llr++)   = imag;
-    real       = fabsf(real) - 8.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 8.0f / sqrtf(170.0f);
-    *(llr++)   = real;
-    *(llr++)   = imag;
-    real       = fabsf(real) - 4.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 4.0f / sqrtf(170.0f);
-    *(llr++)   = real;
-    *(llr++)   = imag;
-    real       = fabsf(real) - 2.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 2.0f / sqrtf(170.0f);
-    *(llr++)   = real;
-    *(llr++)   = imag;
+#ifdef LV_HAVE_AVX512
+  __m512i idx = _mm512_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+  return _mm512_permutexvar_ps(idx, _mm512_castps256_ps512(_mm256_loadu_ps(w)));
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  __m128 x = _mm_loadu_ps(w);
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(x, x)), _mm_unpackhi_ps(x, x), 1);
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  __m128 x = _mm_castpd_ps(_mm_load_sd((const double*)w));
+  return _mm_unpacklo_ps(x, x);
+#else /* LV_HAVE_SSE */
+#ifdef HAVE_NEON
+  float32x2_t   x = vld1_f32(w);
+  float32x2x2_t z = vzip_f32(x, x);
+  return vcombine_f32(z.val[0], z.val[1]);
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+#endif /* SRSRAN_SIMD_F_SIZE */
+
+static void
+demod_qam_weighted(srsran_mod_t mod, const cf_t* symbols, const float* weights, float scale, float* llr, int nsymbols)
+{
+  const demod_qam_t* qam = &demod_qam[mod];
+  uint32_t           L   = qam->nof_levels;
+  int                i   = 0;
+
+  if (mod == SRSRAN_MOD_BPSK) {
+    for (; i < nsymbols; i++) {
+      float w = (weights) ? weights[i] * scale : scale;
+      llr[i]  = -w * (crealf(symbols[i]) + cimagf(symbols[i])) * M_SQRT1_2;
+    }
+    return;
+  }
+
+#if SRSRAN_SIMD_F_SIZE
+  __attribute__((aligned(64))) float levels[DEMOD_SOFT_MAX_LEVELS][SRSRAN_SIMD_F_SIZE];
+  const float*                       y      = (const float*)symbols;
+  simd_f_t                           _scale = srsran_simd_f_set1(scale * qam->gain);
+
+  // Every register holds the real and imaginary parts of SRSRAN_SIMD_F_SIZE / 2 symbols, in their original order
+  for (; i < nsymbols - SRSRAN_SIMD_F_SIZE / 2 + 1; i += SRSRAN_SIMD_F_SIZE / 2) {
+    simd_f_t w = (weights) ? srsran_simd_f_mul(_scale, demod_simd_f_load_pairs(&weights[i])) : _scale;
+
+    simd_f_t x = srsran_simd_f_neg(srsran_simd_f_mul(w, srsran_simd_f_loadu(&y[2 * i])));
+
+    // QPSK LLR are already in order
+    if (L == 1) {
+      srsran_simd_f_storeu(&llr[2 * i], x);
+      continue;
+    }
+
+    srsran_simd_f_store(levels[0], x);
+    for (uint32_t k = 1; k < L; k++) {
+      x = srsran_simd_f_sub(srsran_simd_f_abs(x), srsran_simd_f_mul(w, srsran_simd_f_set1(qam->thresholds[k - 1])));
+      srsran_simd_f_store(levels[k], x);
+    }
+
+    // Interleave the levels of every symbol, each level keeps its real and imaginary LLR together
+    float* out = &llr[2 * L * i];
+    for (uint32_t j = 0; j < SRSRAN_SIMD_F_SIZE / 2; j++) {
+      for (uint32_t k = 0; k < L; k++) {
+        out[2 * (L * j + k)]     = levels[k][2 * j];
+        out[2 * (L * j + k) + 1] = levels[k][2 * j + 1];
+      }
+    }
+  }
+#endif /* SRSRAN_SIMD_F_SIZE */
+
+  for (; i < nsymbols; i++) {
+    float w    = ((weights) ? weights[i] * scale : scale) * qam->gain;
+    float re   = -w * crealf(symbols[i]);
+    float im   = -w * cimagf(symbols[i]);
+    float* out = &llr[2 * L * i];
+    out[0]     = re;
+    out[1]     = im;
+    for (uint32_t k = 1; k < L; k++) {
+      float t        = w * qam->thresholds[k - 1];
+      re             = fabsf(re) - t;
+      im             = fabsf(im) - t;
+      out[2 * k]     = re;
+      out[2 * k + 1] = im;
+    }
   }
 }
 
-void demod_256qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
+// Fixed point outputs are computed in floating point over small blocks that stay in cache, and then converted
+static void demod_qam_weighted_s(srsran_mod_t mod,
+                                 const cf_t*  symbols,
+                                 const float* weights,
+                                 float        scale,
+                                 short*       llr,
+                                 int          nsymbols)
 {
-  for (int i = 0; i < nsymbols; i++) {
-    float real = -__real__ symbols[i];
-    float imag = -__imag__ symbols[i];
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * real;
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * imag;
-    real       = fabsf(real) - 8.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 8.0f / sqrtf(170.0f);
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * real;
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * imag;
-    real       = fabsf(real) - 4.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 4.0f / sqrtf(170.0f);
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * real;
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * imag;
-    real       = fabsf(real) - 2.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 2.0f / sqrtf(170.0f);
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * real;
-    *(llr++)   = SCALE_BYTE_CONV_QAM256 * imag;
+  __attribute__((aligned(64))) float llr_f[DEMOD_SOFT_CHUNK * 2 * DEMOD_SOFT_MAX_LEVELS];
+  uint32_t                           Qm = (mod == SRSRAN_MOD_BPSK) ? 1 : 2 * demod_qam[mod].nof_levels;
+
+  for (int i = 0; i < nsymbols; i += DEMOD_SOFT_CHUNK) {
+    int n = SRSRAN_MIN(DEMOD_SOFT_CHUNK, nsymbols - i);
+    demod_qam_weighted(mod, &symbols[i], (weights) ? &weights[i] : NULL, 1.0f, llr_f, n);
+    srsran_vec_convert_fi(llr_f, scale, &llr[Qm * i], Qm * n);
   }
 }
 
-void demod_256qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
+static void demod_qam_weighted_b(srsran_mod_t mod,
+                                 const cf_t*  symbols,
+                                 const float* weights,
+                                 float        scale,
+                                 int8_t*      llr,
+                                 int          nsymbols)
 {
-  for (int i = 0; i < nsymbols; i++) {
-    float real = -__real__ symbols[i];
-    float imag = -__imag__ symbols[i];
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * real;
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * imag;
-    real       = fabsf(real) - 8.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 8.0f / sqrtf(170.0f);
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * real;
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * imag;
-    real       = fabsf(real) - 4.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 4.0f / sqrtf(170.0f);
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * real;
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * imag;
-    real       = fabsf(real) - 2.0f / sqrtf(170.0f);
-    imag       = fabsf(imag) - 2.0f / sqrtf(170.0f);
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * real;
-    *(llr++)   = SCALE_SHORT_CONV_QAM256 * imag;
+  __attribute__((aligned(64))) float llr_f[DEMOD_SOFT_CHUNK * 2 * DEMOD_SOFT_MAX_LEVELS];
+  uint32_t                           Qm = (mod == SRSRAN_MOD_BPSK) ? 1 : 2 * demod_qam[mod].nof_levels;
+
+  for (int i = 0; i < nsymbols; i += DEMOD_SOFT_CHUNK) {
+    int n = SRSRAN_MIN(DEMOD_SOFT_CHUNK, nsymbols - i);
+    demod_qam_weighted(mod, &symbols[i], (weights) ? &weights[i] : NULL, 1.0f, llr_f, n);
+    srsran_vec_convert_fb(llr_f, scale, &llr[Qm * i], Qm * n);
   }
 }
 
+void demod_256qam_lte(const cf_t* symbols, float* llr, int nsymbols)
+{
+  demod_qam_weighted(SRSRAN_MOD_256QAM, symbols, NULL, 1.0f, llr, nsymbols);
+}
+
+void demod_256qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+  demod_qam_weighted_b(SRSRAN_MOD_256QAM, symbols, NULL, SCALE_BYTE_CONV_QAM256, llr, nsymbols);
+}
+
+void demod_256qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
+{
+  demod_qam_weighted_s(SRSRAN_MOD_256QAM, symbols, NULL, SCALE_SHORT_CONV_QAM256, llr, nsymbols);
+}
+
 int srsran_demod_soft_demodulate(srsran_mod_t modulation, const cf_t* symbols, float* llr, int nsymbols)
 {
   switch (modulation) {
@@ -917,3 +1019,66 @@ int srsran_demod_soft_demodulate_b(srsran_mod_t modulation, const cf_t* symbols,
   }
   return 0;
 }
+
+static const float demod_soft_scale_s[SRSRAN_MOD_NITEMS] = {SCALE_SHORT_CONV_QPSK,
+                                                           SCALE_SHORT_CONV_QPSK,
+                                                           SCALE_SHORT_CONV_QAM16,
+                                                           SCALE_SHORT_CONV_QAM64,
+                                                           SCALE_SHORT_CONV_QAM256};
+
+static const float demod_soft_scale_b[SRSRAN_MOD_NITEMS] = {SCALE_BYTE_CONV_QPSK,
+                                                           SCALE_BYTE_CONV_QPSK,
+                                                           SCALE_BYTE_CONV_QAM16,
+                                                           SCALE_BYTE_CONV_QAM64,
+                                                           SCALE_BYTE_CONV_QAM256};
+
+int srsran_demod_soft_demodulate_weighted(srsran_mod_t modulation,
+                                          const cf_t*  symbols,
+                                          const float* weights,
+                                          float*       llr,
+                                          int          nsymbols)
+{
+  if (modulation >= SRSRAN_MOD_NITEMS) {
+    ERROR("Invalid modulation %d", modulation);
+    return -1;
+  }
+  if (weights == NULL) {
+    return srsran_demod_soft_demodulate(modulation, symbols, llr, nsymbols);
+  }
+  demod_qam_weighted(modulation, symbols, weights, 1.0f, llr, nsymbols);
+  return 0;
+}
+
+int srsran_demod_soft_demodulate_weighted_s(srsran_mod_t modulation,
+                                            const cf_t*  symbols,
+                                            const float* weights,
+                                            short*       llr,
+                                            int          nsymbols)
+{
+  if (modulation >= SRSRAN_MOD_NITEMS) {
+    ERROR("Invalid modulation %d", modulation);
+    return -1;
+  }
+  if (weights == NULL) {
+    return srsran_demod_soft_demodulate_s(modulation, symbols, llr, nsymbols);
+  }
+  demod_qam_weighted_s(modulation, symbols, weights, demod_soft_scale_s[modulation], llr, nsymbols);
+  return 0;
+}
+
+int srsran_demod_soft_demodulate_weighted_b(srsran_mod_t modulation,
+                                            const cf_t*  symbols,
+                                            const float* weights,
+                                            int8_t*      llr,
+                                            int          nsymbols)
+{
+  if (modulation >= SRSRAN_MOD_NITEMS) {
+    ERROR("Invalid modulation %d", modulation);
+    return -1;
+  }
+  if (weights == NULL) {
+    return srsran_demod_soft_demodulate_b(modulation, symbols, llr, nsymbols);
+  }
+  demod_qam_weighted_b(modulation, symbols, weights, demod_soft_scale_b[modulation], llr, nsymbols);
+  return 0;
+}
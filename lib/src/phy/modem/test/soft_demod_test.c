@@ -36,7 +36,7 @@ static srsran_mod_t modulation = SRSRAN_MOD_NITEMS;
 
 void usage(char* prog)
 {
-  printf("Usage: %s [nfv] -m modulation (1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64)\n", prog);
+  printf("Usage: %s [nfv] -m modulation (1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64, 8: QAM256)\n", prog);
   printf("\t-n num_bits [Default %d]\n", num_bits);
   printf("\t-f nof_frames [Default %d]\n", nof_frames);
   printf("\t-v srsran_verbose [Default None]\n");
@@ -75,7 +75,7 @@ void parse_args(int argc, char** argv)
             break;
           default:
             ERROR("Invalid modulation %d. Possible values: "
-                  "(1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64)",
+                  "(1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64, 8: QAM256)",
                   (int)strtol(argv[optind], NULL, 10));
             break;
         }
@@ -118,6 +118,8 @@ int main(int argc, char** argv)
   float*               llr;
   short*               llr_s;
   int8_t*              llr_b;
+  float*               weights;
+  float*               llr_w;
 
   parse_args(argc, argv);
 
@@ -128,7 +130,8 @@ int main(int argc, char** argv)
   }
 
   /* check that num_bits is multiple of num_bits x symbol */
-  num_bits = mod.nbits_x_symbol * (num_bits / mod.nbits_x_symbol);
+  num_bits             = mod.nbits_x_symbol * (num_bits / mod.nbits_x_symbol);
+  uint32_t nof_symbols = num_bits / mod.nbits_x_symbol;
 
   /* allocate buffers */
   input = srsran_vec_u8_malloc(num_bits);
@@ -165,6 +168,18 @@ int main(int argc, char** argv)
     exit(-1);
   }
 
+  weights = srsran_vec_f_malloc(num_bits / mod.nbits_x_symbol);
+  if (!weights) {
+    perror("malloc");
+    exit(-1);
+  }
+
+  llr_w = srsran_vec_f_malloc(num_bits);
+  if (!llr_w) {
+    perror("malloc");
+    exit(-1);
+  }
+
   /* generate random data */
   srand(0);
 
@@ -173,11 +188,16 @@ int main(int argc, char** argv)
   float          mean_texec   = 0.0;
   float          mean_texec_s = 0.0;
   float          mean_texec_b = 0.0;
+  float          mean_texec_w = 0.0;
   for (int n = 0; n < nof_frames; n++) {
     for (i = 0; i < num_bits; i++) {
       input[i] = rand() % 2;
     }
 
+    for (i = 0; i < num_bits / mod.nbits_x_symbol; i++) {
+      weights[i] = (float)rand() / (float)RAND_MAX * 10.0f;
+    }
+
     /* modulate */
     srsran_mod_modulate(&mod, input, symbols, num_bits);
 
@@ -209,6 +229,15 @@ int main(int argc, char** argv)
       mean_texec_b = SRSRAN_VEC_CMA((float)t[0].tv_usec, mean_texec_b, n - 1);
     }
 
+    gettimeofday(&t[1], NULL);
+    srsran_demod_soft_demodulate_weighted(modulation, symbols, weights, llr_w, num_bits / mod.nbits_x_symbol);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+
+    if (n > 0) {
+      mean_texec_w = SRSRAN_VEC_CMA((float)t[0].tv_usec, mean_texec_w, n - 1);
+    }
+
     if (SRSRAN_VERBOSE_ISDEBUG()) {
       printf("bits=");
       srsran_vec_fprint_b(stdout, input, num_bits);
@@ -233,10 +262,21 @@ int main(int argc, char** argv)
         goto clean_exit;
       }
     }
+
+    // Check weighted demodulation is the same as weighting the LLR afterwards
+    for (int i = 0; i < num_bits; i++) {
+      float expected = llr[i] * weights[i / mod.nbits_x_symbol];
+      if (fabsf(llr_w[i] - expected) > 1e-4f * (1.0f + fabsf(expected))) {
+        printf("Error in weighted bit %d: %f != %f\n", i, llr_w[i], expected);
+        goto clean_exit;
+      }
+    }
   }
   ret = 0;
 
 clean_exit:
+  free(llr_w);
+  free(weights);
   free(llr_b);
   free(llr_s);
   free(llr);
@@ -246,12 +286,19 @@ clean_exit:
 
   srsran_modem_table_free(&mod);
 
-  printf("Mean Throughput: %.2f/%.2f/%.2f. Mbps ExTime: %.2f/%.2f/%.2f us\n",
+  printf("Mean Throughput (float/short/byte/weighted): %.2f/%.2f/%.2f/%.2f Mbps; %.2f/%.2f/%.2f/%.2f Msym/s; ExTime: "
+         "%.2f/%.2f/%.2f/%.2f us\n",
          num_bits / mean_texec,
          num_bits / mean_texec_s,
          num_bits / mean_texec_b,
+         num_bits / mean_texec_w,
+         nof_symbols / mean_texec,
+         nof_symbols / mean_texec_s,
+         nof_symbols / mean_texec_b,
+         nof_symbols / mean_texec_w,
          mean_texec,
          mean_texec_s,
-         mean_texec_b);
+         mean_texec_b,
+         mean_texec_w);
   exit(ret);
 }
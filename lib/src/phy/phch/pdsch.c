@@ -40,6 +40,9 @@
 
 #define MAX_PDSCH_RE(cp) (2 * SRSRAN_CP_NSYMB(cp) * 12)
 
+// Maximum number of transmissions whose scrambling sequences are prefetched in a subframe
+#define PDSCH_PREFETCH_MAX_RNTI 64
+
 /* 3GPP 36.213 Table 5.2-1: The cell-specific ratio rho_B / rho_A for 1, 2, or 4 cell specific antenna ports */
 const static float pdsch_cfg_cell_specific_ratio_table[2][4] = {
     /* One antenna port         */ {1.0f / 1.0f, 4.0f / 5.0f, 3.0f / 5.0f, 2.0f / 5.0f},
@@ -429,6 +432,8 @@ void srsran_pdsch_free(srsran_pdsch_t* q)
     if (q->evm_buffer[i]) {
       srsran_evm_free(q->evm_buffer[i]);
     }
+
+    srsran_sequence_cache_free(&q->seq_cache[i]);
   }
 
   /* Free sch objects */
@@ -483,6 +488,58 @@ int srsran_pdsch_set_cell(srsran_pdsch_t* q, srsran_cell_t cell)
   return ret;
 }
 
+int srsran_pdsch_set_sequence_cache(srsran_pdsch_t* q, uint32_t max_bytes)
+{
+  if (q == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // The longest codeword carries 8 bits per RE
+  for (int i = 0; i < SRSRAN_MAX_CODEWORDS; i++) {
+    if (srsran_sequence_cache_init(&q->seq_cache[i], q->max_re * 8, max_bytes) < SRSRAN_SUCCESS) {
+      ERROR("Error initialising scrambling sequence cache");
+      return SRSRAN_ERROR;
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_pdsch_prefetch_sequences(srsran_pdsch_t*            q,
+                                     srsran_dl_sf_cfg_t*        sf,
+                                     srsran_pdsch_cfg_t* const* cfg,
+                                     uint32_t                   nof_cfg)
+{
+  if (q == NULL || sf == NULL || cfg == NULL) {
+    return;
+  }
+
+  uint16_t rnti[PDSCH_PREFETCH_MAX_RNTI];
+
+  for (uint32_t cw = 0; cw < SRSRAN_MAX_CODEWORDS; cw++) {
+    // Skip the codewords without cache, the encoder generates their sequences on the fly anyway
+    if (q->seq_cache[cw].nof_entries == 0) {
+      continue;
+    }
+
+    // The batch is generated with the length of the longest codeword, shorter ones are still found in the cache
+    uint32_t nof_rnti = 0;
+    uint32_t len      = 0;
+    for (uint32_t i = 0; i < nof_cfg && nof_rnti < PDSCH_PREFETCH_MAX_RNTI; i++) {
+      for (uint32_t tb = 0; tb < SRSRAN_MAX_TB; tb++) {
+        srsran_ra_tb_t* t = &cfg[i]->grant.tb[tb];
+        if (t->enabled && t->cw_idx == cw) {
+          rnti[nof_rnti++] = cfg[i]->rnti;
+          len              = SRSRAN_MAX(len, t->nof_bits);
+        }
+      }
+    }
+
+    srsran_sequence_pdsch_prefetch(
+        &q->seq_cache[cw], rnti, nof_rnti, cw, 2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME), q->cell.id, len);
+  }
+}
+
 static float apply_power_allocation(srsran_pdsch_t* q, srsran_pdsch_cfg_t* cfg, cf_t* sf_symbols_m[SRSRAN_MAX_PORTS])
 {
   uint32_t nof_symbols_slot = cfg->grant.nof_symb_slot[0];
@@ -520,103 +577,6 @@ static float apply_power_allocation(srsran_pdsch_t* q, srsran_pdsch_cfg_t* cfg,
   return rho_a;
 }
 
-static void csi_correction(srsran_pdsch_t* q, srsran_pdsch_cfg_t* cfg, uint32_t codeword_idx, uint32_t tb_idx, void* e)
-{
-  uint32_t qm = srsran_mod_bits_x_symbol(cfg->grant.tb[tb_idx].mod);
-  if (qm == 0) {
-    return;
-  }
-
-  const uint32_t csi_max_idx = srsran_vec_max_fi(q->csi[codeword_idx], cfg->grant.tb[tb_idx].nof_bits / qm);
-  float          csi_max     = 1.0f;
-  if (csi_max_idx < cfg->grant.tb[tb_idx].nof_bits / qm) {
-    csi_max = q->csi[codeword_idx][csi_max_idx];
-  }
-  int8_t*  e_b   = e;
-  int16_t* e_s   = e;
-  float*   csi_v = q->csi[codeword_idx];
-  if (q->llr_is_8bit) {
-    for (int i = 0; i < cfg->grant.tb[tb_idx].nof_bits / qm; i++) {
-      const float csi = *(csi_v++) / csi_max;
-      for (int k = 0; k < qm; k++) {
-        *e_b = (int8_t)((float)*e_b * csi);
-        e_b++;
-      }
-    }
-  } else {
-    int i = 0;
-
-#ifdef LV_HAVE_SSE
-    __m128 _csi_scale = _mm_set1_ps(INT16_MAX / csi_max);
-    __m64* _e         = (__m64*)e;
-
-    switch (cfg->grant.tb[tb_idx].mod) {
-      case SRSRAN_MOD_QPSK:
-        for (; i < cfg->grant.tb[tb_idx].nof_bits - 3; i += 4) {
-          __m128 _csi1 = _mm_set1_ps(*(csi_v++));
-          __m128 _csi2 = _mm_set1_ps(*(csi_v++));
-          _csi1        = _mm_blend_ps(_csi1, _csi2, 3);
-
-          _csi1 = _mm_mul_ps(_csi1, _csi_scale);
-
-          _e[0] = _mm_mulhi_pi16(_e[0], _mm_cvtps_pi16(_csi1));
-          _e += 1;
-        }
-        break;
-      case SRSRAN_MOD_16QAM:
-        for (; i < cfg->grant.tb[tb_idx].nof_bits - 3; i += 4) {
-          __m128 _csi = _mm_set1_ps(*(csi_v++));
-
-          _csi = _mm_mul_ps(_csi, _csi_scale);
-
-          _e[0] = _mm_mulhi_pi16(_e[0], _mm_cvtps_pi16(_csi));
-          _e += 1;
-        }
-        break;
-      case SRSRAN_MOD_64QAM:
-        for (; i < cfg->grant.tb[tb_idx].nof_bits - 11; i += 12) {
-          __m128 _csi1 = _mm_set1_ps(*(csi_v++));
-          __m128 _csi3 = _mm_set1_ps(*(csi_v++));
-
-          _csi1        = _mm_mul_ps(_csi1, _csi_scale);
-          _csi3        = _mm_mul_ps(_csi3, _csi_scale);
-          __m128 _csi2 = _mm_blend_ps(_csi1, _csi3, 3);
-
-          _e[0] = _mm_mulhi_pi16(_e[0], _mm_cvtps_pi16(_csi1));
-          _e[1] = _mm_mulhi_pi16(_e[1], _mm_cvtps_pi16(_csi2));
-          _e[2] = _mm_mulhi_pi16(_e[2], _mm_cvtps_pi16(_csi3));
-          _e += 3;
-        }
-        break;
-      case SRSRAN_MOD_BPSK:
-        break;
-      case SRSRAN_MOD_256QAM:
-        for (; i < cfg->grant.tb[tb_idx].nof_bits - 7; i += 8) {
-          __m128 _csi = _mm_set1_ps(*(csi_v++));
-
-          _csi = _mm_mul_ps(_csi, _csi_scale);
-
-          _e[0] = _mm_mulhi_pi16(_e[0], _mm_cvtps_pi16(_csi));
-          _e[1] = _mm_mulhi_pi16(_e[1], _mm_cvtps_pi16(_csi));
-          _e += 2;
-        }
-        break;
-      case SRSRAN_MOD_NITEMS:
-      default:; // Do nothing
-    }
-
-    i /= qm;
-#endif /* LV_HAVE_SSE */
-
-    for (; i < cfg->grant.tb[tb_idx].nof_bits / qm; i++) {
-      const float csi = q->csi[codeword_idx][i] / csi_max;
-      for (int k = 0; k < qm; k++) {
-        e_s[qm * i + k] = (int16_t)((float)e_s[qm * i + k] * csi);
-      }
-    }
-  }
-}
-
 static void pdsch_decode_debug(srsran_pdsch_t*     q,
                                srsran_pdsch_cfg_t* cfg,
                                cf_t*               sf_symbols[SRSRAN_MAX_PORTS],
@@ -688,12 +648,24 @@ static int srsran_pdsch_codeword_decode(srsran_pdsch_t*     q,
 
     /* demodulate symbols
      * The MAX-log-MAP algorithm used in turbo decoding is unsensitive to SNR estimation,
-     * thus we don't need tot set it in the LLRs normalization
+     * thus we don't need tot set it in the LLRs normalization. If CSI is enabled, every symbol LLR is weighted by its
+     * CSI, normalised to the maximum so the LLR do not saturate, in the same pass.
      */
+    const float* weights = NULL;
+    if (cfg->csi_enable) {
+      float*         csi         = q->csi[codeword_idx];
+      const uint32_t csi_max_idx = srsran_vec_max_fi(csi, cfg->grant.nof_re);
+      if (csi_max_idx < cfg->grant.nof_re && isnormal(csi[csi_max_idx])) {
+        srsran_vec_sc_prod_fff(csi, 1.0f / csi[csi_max_idx], csi, cfg->grant.nof_re);
+      }
+      weights = csi;
+    }
     if (q->llr_is_8bit) {
-      srsran_demod_soft_demodulate_b(mcs->mod, q->d[codeword_idx], q->e[codeword_idx], cfg->grant.nof_re);
+      srsran_demod_soft_demodulate_weighted_b(
+          mcs->mod, q->d[codeword_idx], weights, q->e[codeword_idx], cfg->grant.nof_re);
     } else {
-      srsran_demod_soft_demodulate_s(mcs->mod, q->d[codeword_idx], q->e[codeword_idx], cfg->grant.nof_re);
+      srsran_demod_soft_demodulate_weighted_s(
+          mcs->mod, q->d[codeword_idx], weights, q->e[codeword_idx], cfg->grant.nof_re);
     }
     if (cfg->meas_evm_en && q->evm_buffer[codeword_idx]) {
       if (q->llr_is_8bit) {
@@ -715,25 +687,23 @@ static int srsran_pdsch_codeword_decode(srsran_pdsch_t*     q,
 
     /* Bit scrambling */
     if (q->llr_is_8bit) {
-      srsran_sequence_pdsch_apply_c(q->e[codeword_idx],
-                                    q->e[codeword_idx],
-                                    cfg->rnti,
-                                    codeword_idx,
-                                    2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME),
-                                    q->cell.id,
-                                    cfg->grant.tb[tb_idx].nof_bits);
+      srsran_sequence_pdsch_apply_c_cached(&q->seq_cache[codeword_idx],
+                                           q->e[codeword_idx],
+                                           q->e[codeword_idx],
+                                           cfg->rnti,
+                                           codeword_idx,
+                                           2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME),
+                                           q->cell.id,
+                                           cfg->grant.tb[tb_idx].nof_bits);
     } else {
-      srsran_sequence_pdsch_apply_s(q->e[codeword_idx],
-                                    q->e[codeword_idx],
-                                    cfg->rnti,
-                                    codeword_idx,
-                                    2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME),
-                                    q->cell.id,
-                                    cfg->grant.tb[tb_idx].nof_bits);
-    }
-
-    if (cfg->csi_enable) {
-      csi_correction(q, cfg, codeword_idx, tb_idx, q->e[codeword_idx]);
+      srsran_sequence_pdsch_apply_s_cached(&q->seq_cache[codeword_idx],
+                                           q->e[codeword_idx],
+                                           q->e[codeword_idx],
+                                           cfg->rnti,
+                                           codeword_idx,
+                                           2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME),
+                                           q->cell.id,
+                                           cfg->grant.tb[tb_idx].nof_bits);
     }
 
     /* Return  */
@@ -995,13 +965,14 @@ static int srsran_pdsch_codeword_encode(srsran_pdsch_t*         q,
     }
 
     /* Bit scrambling */
-    srsran_sequence_pdsch_apply_pack((uint8_t*)q->e[codeword_idx],
-                                     (uint8_t*)q->e[codeword_idx],
-                                     cfg->rnti,
-                                     codeword_idx,
-                                     2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME),
-                                     q->cell.id,
-                                     cfg->grant.tb[tb_idx].nof_bits);
+    srsran_sequence_pdsch_apply_pack_cached(&q->seq_cache[codeword_idx],
+                                            (uint8_t*)q->e[codeword_idx],
+                                            (uint8_t*)q->e[codeword_idx],
+                                            cfg->rnti,
+                                            codeword_idx,
+                                            2 * (sf->tti % SRSRAN_NOF_SF_X_FRAME),
+                                            q->cell.id,
+                                            cfg->grant.tb[tb_idx].nof_bits);
 
     /* Bit mapping */
     srsran_mod_modulate_bytes(
@@ -37,17 +37,34 @@ static int pdsch_nr_alloc(srsran_pdsch_nr_t* q, uint32_t max_mimo_layers, uint32
     for (uint32_t i = 0; i < SRSRAN_MAX_LAYERS_NR; i++) {
       if (q->x[i] != NULL) {
         free(q->x[i]);
+        q->x[i] = NULL;
+      }
+      if (q->sinr[i] != NULL) {
+        free(q->sinr[i]);
+        q->sinr[i] = NULL;
       }
     }
 
-    // Allocate for new sizes
-    for (uint32_t i = 0; i < q->max_layers; i++) {
+    // Allocate for new sizes, the layer buffers also hold the symbols of every receive antenna
+    uint32_t nof_x = SRSRAN_MAX(q->max_layers, q->nof_rx_ant);
+    for (uint32_t i = 0; i < nof_x; i++) {
       q->x[i] = srsran_vec_cf_malloc(SRSRAN_SLOT_LEN_RE_NR(q->max_prb));
       if (q->x[i] == NULL) {
         ERROR("Malloc");
         return SRSRAN_ERROR;
       }
     }
+
+    // The SINR is only produced by the MIMO detector
+    if (q->max_layers > 1) {
+      for (uint32_t i = 0; i < q->max_layers; i++) {
+        q->sinr[i] = srsran_vec_f_malloc(SRSRAN_SLOT_LEN_RE_NR(q->max_prb));
+        if (q->sinr[i] == NULL) {
+          ERROR("Malloc");
+          return SRSRAN_ERROR;
+        }
+      }
+    }
   }
 
   return SRSRAN_SUCCESS;
@@ -57,6 +74,12 @@ int pdsch_nr_init_common(srsran_pdsch_nr_t* q, const srsran_pdsch_nr_args_t* arg
 {
   SRSRAN_MEM_ZERO(q, srsran_pdsch_nr_t, 1);
 
+  if (args->nof_rx_ant > SRSRAN_MAX_PORTS) {
+    ERROR("Invalid number of receive antennas (%d)", args->nof_rx_ant);
+    return SRSRAN_ERROR;
+  }
+  q->nof_rx_ant = args->nof_rx_ant;
+
   for (srsran_mod_t mod = SRSRAN_MOD_BPSK; mod < SRSRAN_MOD_NITEMS; mod++) {
     if (srsran_modem_table_lte(&q->modem_tables[mod], mod) < SRSRAN_SUCCESS) {
       ERROR("Error initialising modem table for %s", srsran_mod_string(mod));
@@ -150,6 +173,14 @@ int srsran_pdsch_nr_set_carrier(srsran_pdsch_nr_t* q, const srsran_carrier_nr_t*
           return SRSRAN_ERROR;
         }
       }
+
+      if (q->csi[i] == NULL) {
+        q->csi[i] = srsran_vec_f_malloc(SRSRAN_SLOT_MAX_LEN_RE_NR);
+        if (q->csi[i] == NULL) {
+          ERROR("Malloc");
+          return SRSRAN_ERROR;
+        }
+      }
     }
   }
 
@@ -179,6 +210,10 @@ void srsran_pdsch_nr_free(srsran_pdsch_nr_t* q)
     if (q->d[cw]) {
       free(q->d[cw]);
     }
+
+    if (q->csi[cw]) {
+      free(q->csi[cw]);
+    }
   }
 
   srsran_sch_nr_free(&q->sch);
@@ -187,6 +222,9 @@ void srsran_pdsch_nr_free(srsran_pdsch_nr_t* q)
     if (q->x[i]) {
       free(q->x[i]);
     }
+    if (q->sinr[i]) {
+      free(q->sinr[i]);
+    }
   }
 
   for (srsran_mod_t mod = SRSRAN_MOD_BPSK; mod < SRSRAN_MOD_NITEMS; mod++) {
@@ -367,7 +405,7 @@ int srsran_pdsch_nr_encode(srsran_pdsch_nr_t*           q,
   }
 
   // Check number of layers
-  if (q->max_layers < grant->nof_layers) {
+  if (grant->nof_layers == 0 || q->max_layers < grant->nof_layers) {
     ERROR("Error number of layers (%d) exceeds configured maximum (%d)", grant->nof_layers, q->max_layers);
     return SRSRAN_ERROR;
   }
@@ -393,25 +431,28 @@ int srsran_pdsch_nr_encode(srsran_pdsch_nr_t*           q,
   cf_t** x = q->d;
   if (grant->nof_layers > 1) {
     x = q->x;
-    srsran_layermap_nr(q->d, nof_cw, x, grant->nof_layers, grant->nof_layers);
+    srsran_layermap_nr(q->d, nof_cw, x, grant->nof_layers, grant->tb[0].nof_re);
   }
 
   // 7.3.1.4 Antenna port mapping
-  // ... Not implemented
+  // ... Not implemented, every layer is transmitted on the port with the same index
 
   // 7.3.1.5 Mapping to virtual resource blocks
   // ... Not implemented
 
   // 7.3.1.6 Mapping from virtual to physical resource blocks
-  int n = srsran_pdsch_nr_put(q, cfg, grant, x[0], sf_symbols[0]);
-  if (n < SRSRAN_SUCCESS) {
-    ERROR("Putting NR PDSCH resources");
-    return SRSRAN_ERROR;
-  }
+  uint32_t nof_re = grant->tb[0].nof_re / grant->nof_layers;
+  for (uint32_t i = 0; i < grant->nof_layers; i++) {
+    int n = srsran_pdsch_nr_put(q, cfg, grant, x[i], sf_symbols[i]);
+    if (n < SRSRAN_SUCCESS) {
+      ERROR("Putting NR PDSCH resources");
+      return SRSRAN_ERROR;
+    }
 
-  if (n != grant->tb[0].nof_re) {
-    ERROR("Unmatched number of RE (%d != %d)", n, grant->tb[0].nof_re);
-    return SRSRAN_ERROR;
+    if (n != nof_re) {
+      ERROR("Unmatched number of RE (%d != %d)", n, nof_re);
+      return SRSRAN_ERROR;
+    }
   }
 
   if (q->meas_time_en) {
@@ -423,9 +464,30 @@ int srsran_pdsch_nr_encode(srsran_pdsch_nr_t*           q,
   return SRSRAN_SUCCESS;
 }
 
+// Normalises the SINR of the MIMO detector and interleaves its layers like the symbols of a single code word
+static void pdsch_nr_csi_layerdemap(srsran_pdsch_nr_t* q, uint32_t nof_layers, uint32_t nof_re)
+{
+  float sinr_max = 0.0f;
+  for (uint32_t j = 0; j < nof_layers; j++) {
+    uint32_t idx = srsran_vec_max_fi(q->sinr[j], nof_re);
+    if (idx < nof_re) {
+      sinr_max = SRSRAN_MAX(sinr_max, q->sinr[j][idx]);
+    }
+  }
+  float norm = isnormal(sinr_max) ? 1.0f / sinr_max : 1.0f;
+
+  float* csi = q->csi[0];
+  for (uint32_t i = 0; i < nof_re; i++) {
+    for (uint32_t j = 0; j < nof_layers; j++) {
+      *(csi++) = q->sinr[j][i] * norm;
+    }
+  }
+}
+
 static inline int pdsch_nr_decode_codeword(srsran_pdsch_nr_t*         q,
                                            const srsran_sch_cfg_nr_t* cfg,
                                            const srsran_sch_tb_t*     tb,
+                                           const float*               weights,
                                            srsran_pdsch_res_nr_t*     res,
                                            uint16_t                   rnti)
 {
@@ -451,9 +513,9 @@ static inline int pdsch_nr_decode_codeword(srsran_pdsch_nr_t*         q,
     srsran_vec_fprint_c(stdout, q->d[tb->cw_idx], tb->nof_re);
   }
 
-  // Demodulation
+  // Demodulation, weighting every symbol LLR with its normalised SINR if available
   int8_t* llr = (int8_t*)q->b[tb->cw_idx];
-  if (srsran_demod_soft_demodulate_b(tb->mod, q->d[tb->cw_idx], llr, tb->nof_re)) {
+  if (srsran_demod_soft_demodulate_weighted_b(tb->mod, q->d[tb->cw_idx], weights, llr, tb->nof_re)) {
     return SRSRAN_ERROR;
   }
 
@@ -511,20 +573,42 @@ int srsran_pdsch_nr_decode(srsran_pdsch_nr_t*           q,
     nof_cw += grant->tb[tb].enabled ? 1 : 0;
   }
 
-  uint32_t nof_re = grant->tb[0].nof_re;
+  // Check number of layers
+  uint32_t nof_layers = grant->nof_layers;
+  if (nof_layers == 0 || q->max_layers < nof_layers) {
+    ERROR("Error number of layers (%d) exceeds configured maximum (%d)", nof_layers, q->max_layers);
+    return SRSRAN_ERROR;
+  }
+
+  // Number of RE of each layer
+  uint32_t nof_re = grant->tb[0].nof_re / nof_layers;
 
   if (channel->nof_re != nof_re) {
     ERROR("Inconsistent number of RE (%d!=%d)", channel->nof_re, nof_re);
     return SRSRAN_ERROR;
   }
 
-  // Demapping from virtual to physical resource blocks
-  uint32_t nof_re_get = srsran_pdsch_nr_get(q, cfg, grant, q->x[0], sf_symbols[0]);
-  if (nof_re_get != nof_re) {
-    ERROR("Inconsistent number of RE (%d!=%d)", nof_re_get, nof_re);
+  // Check number of receive antennas
+  uint32_t nof_rx_ant = (q->nof_rx_ant > 0) ? q->nof_rx_ant : nof_layers;
+  if (nof_rx_ant < nof_layers) {
+    ERROR("Error number of layers (%d) exceeds the number of receive antennas (%d)", nof_layers, nof_rx_ant);
     return SRSRAN_ERROR;
   }
 
+  // A single layer is received on the first antenna, every antenna is used for detecting multiple layers
+  if (nof_layers == 1) {
+    nof_rx_ant = 1;
+  }
+
+  // Demapping from virtual to physical resource blocks
+  for (uint32_t i = 0; i < nof_rx_ant; i++) {
+    uint32_t nof_re_get = srsran_pdsch_nr_get(q, cfg, grant, q->x[i], sf_symbols[i]);
+    if (nof_re_get != nof_re) {
+      ERROR("Inconsistent number of RE (%d!=%d)", nof_re_get, nof_re);
+      return SRSRAN_ERROR;
+    }
+  }
+
   if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
     DEBUG("ce=");
     srsran_vec_fprint_c(stdout, channel->ce[0][0], nof_re);
@@ -536,17 +620,27 @@ int srsran_pdsch_nr_decode(srsran_pdsch_nr_t*           q,
   // ... Not implemented
 
   // Antenna port demapping
-  // ... Not implemented
-  srsran_predecoding_single(q->x[0], channel->ce[0][0], q->d[0], NULL, nof_re, 1.0f, channel->noise_estimate);
+  // ... Not implemented, every layer is transmitted on the port with the same index
+  const float* weights = NULL;
+  if (nof_layers > 1) {
+    if (srsran_predecoding_mimo(
+            q->x, channel->ce, q->x, q->sinr, nof_rx_ant, nof_layers, nof_re, 1.0f, channel->noise_estimate) <
+        SRSRAN_SUCCESS) {
+      ERROR("Error detecting %d layers", nof_layers);
+      return SRSRAN_ERROR;
+    }
 
-  // Layer demapping
-  if (grant->nof_layers > 1) {
-    srsran_layerdemap_nr(q->d, nof_cw, q->x, grant->nof_layers, nof_re);
+    // Layer demapping
+    srsran_layerdemap_nr(q->d, nof_cw, q->x, nof_layers, grant->tb[0].nof_re);
+    pdsch_nr_csi_layerdemap(q, nof_layers, nof_re);
+    weights = q->csi[0];
+  } else {
+    srsran_predecoding_single(q->x[0], channel->ce[0][0], q->d[0], NULL, nof_re, 1.0f, channel->noise_estimate);
   }
 
   // SCH decode
   for (uint32_t tb = 0; tb < SRSRAN_MAX_TB; tb++) {
-    if (pdsch_nr_decode_codeword(q, cfg, &grant->tb[tb], data, grant->rnti) < SRSRAN_SUCCESS) {
+    if (pdsch_nr_decode_codeword(q, cfg, &grant->tb[tb], weights, data, grant->rnti) < SRSRAN_SUCCESS) {
       ERROR("Error encoding TB %d", tb);
       return SRSRAN_ERROR;
     }
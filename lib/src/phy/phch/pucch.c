@@ -23,6 +23,7 @@
 #include "srsran/srsran.h"
 #include <assert.h>
 #include <complex.h>
+#include <float.h>
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -69,6 +70,11 @@ int srsran_pucch_init_(srsran_pucch_t* q, bool is_ue)
 
     if (!q->is_ue) {
       q->ce = srsran_vec_cf_malloc(SRSRAN_PUCCH_MAX_SYMBOLS);
+
+      q->dft_cs = srsran_dft_mixed_radix_get_plan(SRSRAN_NRE);
+      if (q->dft_cs == NULL) {
+        goto clean_exit;
+      }
     }
 
     ret = SRSRAN_SUCCESS;
@@ -622,6 +628,36 @@ static int encode_bits(srsran_pucch_cfg_t*   cfg,
   return SRSRAN_SUCCESS;
 }
 
+/* Demodulates and decodes the 10 equalised format 2 symbols in q->z */
+static int decode_symbols_format2(srsran_pucch_t*     q,
+                                  srsran_ul_sf_cfg_t* sf,
+                                  srsran_pucch_cfg_t* cfg,
+                                  uint8_t             pucch_bits[SRSRAN_CQI_MAX_BITS],
+                                  uint32_t            nof_uci_bits,
+                                  float*              corr)
+{
+  int16_t llr_pucch2[SRSRAN_CQI_MAX_BITS];
+
+  if (srsran_sequence_pucch(&q->seq_f2, cfg->rnti, 2 * (sf->tti % 10), q->cell.id)) {
+    ERROR("Error computing PUCCH Format 2 scrambling sequence\n");
+    return SRSRAN_ERROR;
+  }
+  srsran_demod_soft_demodulate_s(SRSRAN_MOD_QPSK, q->z, llr_pucch2, SRSRAN_PUCCH2_NOF_BITS / 2);
+  srsran_scrambling_s_offset(&q->seq_f2, llr_pucch2, 0, SRSRAN_PUCCH2_NOF_BITS);
+
+  // Calculate the LLR RMS for normalising
+  float llr_pow = srsran_vec_avg_power_sf(llr_pucch2, SRSRAN_PUCCH2_NOF_BITS);
+
+  if (isnormal(llr_pow)) {
+    float llr_rms = sqrtf(llr_pow) * SRSRAN_PUCCH2_NOF_BITS;
+    *corr         = ((float)srsran_uci_decode_cqi_pucch(&q->cqi, llr_pucch2, pucch_bits, nof_uci_bits)) / (llr_rms);
+  } else {
+    *corr = 0;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 static bool decode_signal(srsran_pucch_t*     q,
                           srsran_ul_sf_cfg_t* sf,
                           srsran_pucch_cfg_t* cfg,
@@ -630,7 +666,6 @@ static bool decode_signal(srsran_pucch_t*     q,
                           uint32_t            nof_uci_bits,
                           float*              correlation)
 {
-  int16_t llr_pucch2[SRSRAN_CQI_MAX_BITS];
   bool    detected = false;
   float   corr = 0, corr_max = -1e9;
   uint8_t b_max = 0, b2_max = 0; // default bit value, eg. HI is NACK
@@ -690,26 +725,13 @@ static bool decode_signal(srsran_pucch_t*     q,
     case SRSRAN_PUCCH_FORMAT_2:
     case SRSRAN_PUCCH_FORMAT_2A:
     case SRSRAN_PUCCH_FORMAT_2B:
-      if (srsran_sequence_pucch(&q->seq_f2, cfg->rnti, 2 * (sf->tti % 10), q->cell.id)) {
-        ERROR("Error computing PUCCH Format 2 scrambling sequence\n");
-        return SRSRAN_ERROR;
-      }
       encode_signal_format12(q, sf, cfg, NULL, ref, true);
       srsran_vec_prod_conj_ccc(q->z, ref, q->z_tmp, SRSRAN_PUCCH_MAX_SYMBOLS);
       for (int i = 0; i < (SRSRAN_PUCCH2_N_SF * SRSRAN_NOF_SLOTS_PER_SF); i++) {
         q->z[i] = srsran_vec_acc_cc(&q->z_tmp[i * SRSRAN_NRE], SRSRAN_NRE) / SRSRAN_NRE;
       }
-      srsran_demod_soft_demodulate_s(SRSRAN_MOD_QPSK, q->z, llr_pucch2, SRSRAN_PUCCH2_NOF_BITS / 2);
-      srsran_scrambling_s_offset(&q->seq_f2, llr_pucch2, 0, SRSRAN_PUCCH2_NOF_BITS);
-
-      // Calculate the LLR RMS for normalising
-      float llr_pow = srsran_vec_avg_power_sf(llr_pucch2, SRSRAN_PUCCH2_NOF_BITS);
-
-      if (isnormal(llr_pow)) {
-        float llr_rms = sqrtf(llr_pow) * SRSRAN_PUCCH2_NOF_BITS;
-        corr          = ((float)srsran_uci_decode_cqi_pucch(&q->cqi, llr_pucch2, pucch_bits, nof_uci_bits)) / (llr_rms);
-      } else {
-        corr = 0;
+      if (decode_symbols_format2(q, sf, cfg, pucch_bits, nof_uci_bits, &corr) < SRSRAN_SUCCESS) {
+        return SRSRAN_ERROR;
       }
       detected = true;
       break;
@@ -764,6 +786,36 @@ static void decode_bits(srsran_pucch_cfg_t* cfg,
   }
 }
 
+/* Converts the decoded bits to UCI data and applies the data validity thresholds */
+static void decode_result(srsran_pucch_cfg_t* cfg,
+                          bool                pucch_found,
+                          uint8_t             pucch_bits[SRSRAN_PUCCH_MAX_BITS],
+                          srsran_pucch_res_t* data)
+{
+  // Convert bits to UCI data
+  decode_bits(cfg, pucch_found, pucch_bits, cfg->pucch2_drs_bits, &data->uci_data);
+
+  data->detected = pucch_found;
+
+  // Accept ACK and CQI only if correlation above threshold
+  switch (cfg->format) {
+    case SRSRAN_PUCCH_FORMAT_1A:
+    case SRSRAN_PUCCH_FORMAT_1B:
+      data->uci_data.ack.valid = data->correlation > cfg->threshold_data_valid_format1a;
+      break;
+    case SRSRAN_PUCCH_FORMAT_2:
+    case SRSRAN_PUCCH_FORMAT_2A:
+    case SRSRAN_PUCCH_FORMAT_2B:
+      data->detected              = data->correlation > cfg->threshold_data_valid_format2;
+      data->uci_data.ack.valid    = data->detected;
+      data->uci_data.cqi.data_crc = data->detected;
+      break;
+    case SRSRAN_PUCCH_FORMAT_1:
+    case SRSRAN_PUCCH_FORMAT_3:
+    default:; // Not considered, do nothing
+  }
+}
+
 /* Encode, modulate and resource mapping of UCI data over PUCCH */
 int srsran_pucch_encode(srsran_pucch_t*     q,
                         srsran_ul_sf_cfg_t* sf,
@@ -842,33 +894,428 @@ int srsran_pucch_decode(srsran_pucch_t*        q,
     // Perform ML-decoding
     bool pucch_found = decode_signal(q, sf, cfg, pucch_bits, nof_re, nof_uci_bits, &data->correlation);
 
-    // Convert bits to UCI data
-    decode_bits(cfg, pucch_found, pucch_bits, cfg->pucch2_drs_bits, &data->uci_data);
+    decode_result(cfg, pucch_found, pucch_bits, data);
+
+    ret = SRSRAN_SUCCESS;
+  }
+
+  return ret;
+}
+
+static uint32_t pucch_n_prb_m(const srsran_cell_t* cell, uint32_t m, uint32_t ns)
+{
+  // Determine n_prb
+  uint32_t n_prb = m / 2;
+  if ((m + ns) % 2) {
+    n_prb = cell->nof_prb - 1 - m / 2;
+  }
+  return n_prb;
+}
+
+bool srsran_pucch_bank_supported(const srsran_pucch_cfg_t* cfg, srsran_cp_t cp)
+{
+  switch (cfg->format) {
+    case SRSRAN_PUCCH_FORMAT_1:
+    case SRSRAN_PUCCH_FORMAT_1A:
+    case SRSRAN_PUCCH_FORMAT_1B:
+    case SRSRAN_PUCCH_FORMAT_2:
+      return true;
+    case SRSRAN_PUCCH_FORMAT_2A:
+    case SRSRAN_PUCCH_FORMAT_2B:
+      return SRSRAN_CP_ISNORM(cp);
+    default:
+      return false;
+  }
+}
+
+int srsran_pucch_bank_compute(srsran_pucch_t*      q,
+                              srsran_ul_sf_cfg_t*  sf,
+                              uint32_t             m,
+                              bool                 group_hopping_en,
+                              const cf_t*          sf_symbols,
+                              srsran_pucch_bank_t* bank)
+{
+  if (q == NULL || sf == NULL || sf_symbols == NULL || bank == NULL || q->dft_cs == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t nsymbols = SRSRAN_CP_NSYMB(q->cell.cp);
+  uint32_t sf_idx   = sf->tti % SRSRAN_NOF_SF_X_FRAME;
+  cf_t     r_u[SRSRAN_NRE];
+  cf_t     scratch[2 * SRSRAN_NRE];
+
+  for (uint32_t ns = SRSRAN_NOF_SLOTS_PER_SF * sf_idx; ns < SRSRAN_NOF_SLOTS_PER_SF * (sf_idx + 1); ns++) {
+    uint32_t n_prb = pucch_n_prb_m(&q->cell, m, ns);
+    if (n_prb >= q->cell.nof_prb) {
+      ERROR("Invalid PUCCH n_prb=%d", n_prb);
+      return SRSRAN_ERROR;
+    }
+
+    // Base sequence of the slot
+    uint32_t f_gh = 0;
+    if (group_hopping_en) {
+      f_gh = q->f_gh[ns];
+    }
+    uint32_t u = (f_gh + (q->cell.id % 30)) % 30;
+    if (srsran_zc_sequence_generate_lte(u, 0, 0.0f, 1, r_u) < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+
+    for (uint32_t l = 0; l < nsymbols; l++) {
+      cf_t* z = bank->z[ns % 2][l];
+      srsran_vec_prod_conj_ccc(
+          &sf_symbols[SRSRAN_RE_IDX(q->cell.nof_prb, l + (ns % 2) * nsymbols, n_prb * SRSRAN_NRE)], r_u, z, SRSRAN_NRE);
+
+      // Bin k holds the correlation with the cyclic shift alpha = 2 pi k / 12
+      srsran_dft_mixed_radix_run(q->dft_cs, z, bank->corr[ns % 2][l], scratch, SRSRAN_DFT_FORWARD, 1.0f / SRSRAN_NRE);
+    }
+  }
+
+  bank->m                = m;
+  bank->group_hopping_en = group_hopping_en;
+
+  return SRSRAN_SUCCESS;
+}
+
+static uint32_t pucch_alpha_n_cs(float alpha)
+{
+  return (uint32_t)roundf(alpha * SRSRAN_NRE / (2.0f * (float)M_PI)) % SRSRAN_NRE;
+}
+
+/* Noise power per RE from the format 1 data symbols projected onto the length 4 cover no resource uses. The cell
+ * specific cyclic shift hopping is undone so every bin follows the same resource through the slot */
+static float decode_bank_format1_noise(srsran_pucch_t*            q,
+                                       srsran_ul_sf_cfg_t*        sf,
+                                       srsran_pucch_cfg_t*        cfg,
+                                       const srsran_pucch_bank_t* bank)
+{
+  static const float w_spare[4] = {1.0f, 1.0f, -1.0f, -1.0f};
+
+  float    power = 0.0f;
+  uint32_t count = 0;
+
+  uint32_t sf_idx = sf->tti % SRSRAN_NOF_SF_X_FRAME;
+  for (uint32_t ns = SRSRAN_NOF_SLOTS_PER_SF * sf_idx; ns < SRSRAN_NOF_SLOTS_PER_SF * (sf_idx + 1); ns++) {
+    if (get_N_sf(cfg->format, ns % 2, sf->shortened) != 4) {
+      continue;
+    }
+    for (uint32_t k = 0; k < SRSRAN_NRE; k++) {
+      cf_t x = 0.0f;
+      for (uint32_t m = 0; m < 4; m++) {
+        uint32_t l = get_pucch_symbol(m, cfg->format, q->cell.cp);
+        x += bank->corr[ns % 2][l][(k + q->n_cs_cell[ns][l]) % SRSRAN_NRE] * w_spare[m];
+      }
+      power += __real__ x * __real__ x + __imag__ x * __imag__ x;
+    }
+    count += 4 * SRSRAN_NRE;
+  }
+
+  // Every bin carries 1/12 of the noise power of a RE
+  return count ? power * SRSRAN_NRE / count : NAN;
+}
+
+/* Noise power per RE from the difference between the two format 2 DMRS symbols of every slot, the cell specific cyclic
+ * shift hopping is undone so the DMRS of every resource cancel out. The own resource is compensated with its DMRS
+ * weights, only the ACK carried by the second DMRS of other format 2a/2b resources remains. Returns NAN if the slots do
+ * not carry two DMRS symbols */
+static float decode_bank_format2_noise(srsran_pucch_t*            q,
+                                       srsran_ul_sf_cfg_t*        sf,
+                                       srsran_pucch_cfg_t*        cfg,
+                                       const srsran_pucch_bank_t* bank,
+                                       uint32_t n_cs[SRSRAN_NOF_SLOTS_PER_SF][SRSRAN_REFSIGNAL_PUCCH_MAX_N_RS],
+                                       cf_t     w[SRSRAN_NOF_SLOTS_PER_SF][SRSRAN_REFSIGNAL_PUCCH_MAX_N_RS])
+{
+  if (srsran_refsignal_dmrs_N_rs(cfg->format, q->cell.cp) != 2) {
+    return NAN;
+  }
+
+  uint32_t l0    = srsran_refsignal_dmrs_pucch_symbol(0, cfg->format, q->cell.cp);
+  uint32_t l1    = srsran_refsignal_dmrs_pucch_symbol(1, cfg->format, q->cell.cp);
+  float    power = 0.0f;
+
+  uint32_t sf_idx = sf->tti % SRSRAN_NOF_SF_X_FRAME;
+  for (uint32_t ns = SRSRAN_NOF_SLOTS_PER_SF * sf_idx; ns < SRSRAN_NOF_SLOTS_PER_SF * (sf_idx + 1); ns++) {
+    for (uint32_t k = 0; k < SRSRAN_NRE; k++) {
+      uint32_t k0 = (k + q->n_cs_cell[ns][l0]) % SRSRAN_NRE;
+      uint32_t k1 = (k + q->n_cs_cell[ns][l1]) % SRSRAN_NRE;
+      cf_t     x  = bank->corr[ns % 2][l0][k0] - bank->corr[ns % 2][l1][k1];
+      if (k0 == n_cs[ns % 2][0]) {
+        x = bank->corr[ns % 2][l0][k0] * conjf(w[ns % 2][0]) - bank->corr[ns % 2][l1][k1] * conjf(w[ns % 2][1]);
+      }
+      power += __real__ x * __real__ x + __imag__ x * __imag__ x;
+    }
+  }
+
+  // Every bin carries 1/12 of the noise power of a RE, and the difference doubles it
+  return power / (2.0f * SRSRAN_NOF_SLOTS_PER_SF);
+}
+
+/* Correlation of the format 1 data symbols with the expected sequence, all the hypotheses are evaluated from it. The
+ * normalisation accounts for the noise of the other cyclic shifts, as if the RE were correlated one by one */
+static cf_t decode_bank_format1(srsran_pucch_t*            q,
+                                srsran_ul_sf_cfg_t*        sf,
+                                srsran_pucch_cfg_t*        cfg,
+                                const srsran_pucch_bank_t* bank,
+                                const cf_t                 h[SRSRAN_NOF_SLOTS_PER_SF],
+                                float                      noise,
+                                float*                     norm)
+{
+  cf_t  acc     = 0.0f;
+  float sig_pow = 0.0f;
+  float rx_pow  = 0.0f;
+
+  uint32_t sf_idx = sf->tti % SRSRAN_NOF_SF_X_FRAME;
+  for (uint32_t ns = SRSRAN_NOF_SLOTS_PER_SF * sf_idx; ns < SRSRAN_NOF_SLOTS_PER_SF * (sf_idx + 1); ns++) {
+    uint32_t N_sf      = get_N_sf(cfg->format, ns % 2, sf->shortened);
+    uint32_t N_sf_widx = N_sf == 3 ? 1 : 0;
+
+    // Despread the orthogonal cover
+    cf_t d = 0.0f;
+    for (uint32_t m = 0; m < N_sf; m++) {
+      uint32_t l          = get_pucch_symbol(m, cfg->format, q->cell.cp);
+      uint32_t n_prime_ns = 0;
+      uint32_t n_oc       = 0;
+      float    alpha = srsran_pucch_alpha_format1(q->n_cs_cell, cfg, q->cell.cp, true, ns, l, &n_oc, &n_prime_ns);
+      float    S_ns  = (n_prime_ns % 2) ? M_PI / 2 : 0;
+
+      cf_t w = cexpf(I * (w_n_oc[N_sf_widx][n_oc % 3][m] + S_ns));
+      cf_t c = bank->corr[ns % 2][l][pucch_alpha_n_cs(alpha)];
+      d += c * conjf(w);
+      rx_pow += __real__ c * __real__ c + __imag__ c * __imag__ c;
+    }
+    rx_pow += N_sf * noise * (SRSRAN_NRE - 1) / SRSRAN_NRE;
+
+    acc += conjf(h[ns % 2]) * d;
+    sig_pow += N_sf * (__real__ h[ns % 2] * __real__ h[ns % 2] + __imag__ h[ns % 2] * __imag__ h[ns % 2]);
+  }
+
+  *norm = sqrtf(sig_pow * rx_pow);
+  return acc;
+}
+
+/* Normalised correlation between the received format 1 symbols and the ones carrying d */
+static float decode_bank_format1_corr(cf_t acc, float norm, cf_t d)
+{
+  if (!isnormal(norm)) {
+    return 0.0f;
+  }
+  return __real__(conjf(d) * acc) / norm;
+}
+
+int srsran_pucch_decode_bank(srsran_pucch_t*            q,
+                             srsran_ul_sf_cfg_t*        sf,
+                             srsran_pucch_cfg_t*        cfg,
+                             const srsran_pucch_bank_t* bank,
+                             srsran_pucch_res_t*        data)
+{
+  if (q == NULL || sf == NULL || cfg == NULL || bank == NULL || data == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
 
-    data->detected = pucch_found;
+  if (!srsran_pucch_bank_supported(cfg, q->cell.cp) || bank->m != srsran_pucch_m(cfg, q->cell.cp) ||
+      bank->group_hopping_en != cfg->group_hopping_en) {
+    ERROR("PUCCH %s resource %d does not match the correlation bank",
+          srsran_pucch_format_text(cfg->format),
+          cfg->n_pucch);
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
 
-    // Accept ACK and CQI only if correlation above threshold
+  uint8_t  pucch_bits[SRSRAN_CQI_MAX_BITS] = {};
+  uint32_t N_rs                            = srsran_refsignal_dmrs_N_rs(cfg->format, q->cell.cp);
+  uint32_t n_cs[SRSRAN_NOF_SLOTS_PER_SF][SRSRAN_REFSIGNAL_PUCCH_MAX_N_RS] = {};
+  cf_t     w[SRSRAN_NOF_SLOTS_PER_SF][SRSRAN_REFSIGNAL_PUCCH_MAX_N_RS]    = {};
+  cf_t     h[SRSRAN_NOF_SLOTS_PER_SF]                                     = {};
+
+  // Estimate the channel of every slot, formats 2a and 2b carry the ACK in the second DMRS symbol
+  uint32_t nof_drs_hyp = 1;
+  if (cfg->format == SRSRAN_PUCCH_FORMAT_2A) {
+    nof_drs_hyp = 2;
+  } else if (cfg->format == SRSRAN_PUCCH_FORMAT_2B) {
+    nof_drs_hyp = 4;
+  }
+
+  float    max   = -1e9;
+  uint32_t i_max = 0;
+  for (uint32_t i = 0; i < nof_drs_hyp; i++) {
+    if (nof_drs_hyp > 1) {
+      cfg->pucch2_drs_bits[0] = i % 2;
+      cfg->pucch2_drs_bits[1] = i / 2;
+    }
+    if (srsran_refsignal_dmrs_pucch_cs(q->cell.cp, q->n_cs_cell, sf, cfg, n_cs, w) < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+
+    cf_t acc[SRSRAN_NOF_SLOTS_PER_SF] = {};
+    for (uint32_t s = 0; s < SRSRAN_NOF_SLOTS_PER_SF; s++) {
+      for (uint32_t m = 0; m < N_rs; m++) {
+        uint32_t l = srsran_refsignal_dmrs_pucch_symbol(m, cfg->format, q->cell.cp);
+        acc[s] += bank->corr[s][l][n_cs[s][m]] * conjf(w[s][m]);
+      }
+    }
+
+    float x = cabsf(acc[0] + acc[1]);
+    if (x >= max) {
+      max   = x;
+      i_max = i;
+      for (uint32_t s = 0; s < SRSRAN_NOF_SLOTS_PER_SF; s++) {
+        h[s] = acc[s] / N_rs;
+      }
+    }
+  }
+  if (nof_drs_hyp > 1) {
+    cfg->pucch2_drs_bits[0] = i_max % 2;
+    cfg->pucch2_drs_bits[1] = i_max / 2;
+    srsran_refsignal_dmrs_pucch_cs(q->cell.cp, q->n_cs_cell, sf, cfg, n_cs, w);
+  }
+
+  // Measure EPRE, and noise from the DMRS energy out of the resource cyclic shift. Format 1 has a cover free of other
+  // resources and format 2 a second DMRS symbol, so the noise does not include them
+  float epre  = 0.0f;
+  float noise = 0.0f;
+  for (uint32_t s = 0; s < SRSRAN_NOF_SLOTS_PER_SF; s++) {
+    for (uint32_t m = 0; m < N_rs; m++) {
+      uint32_t l = srsran_refsignal_dmrs_pucch_symbol(m, cfg->format, q->cell.cp);
+      cf_t     c = bank->corr[s][l][n_cs[s][m]];
+      float    e = srsran_vec_avg_power_cf(bank->corr[s][l], SRSRAN_NRE) * SRSRAN_NRE;
+      epre += e;
+      noise += e - (__real__ c * __real__ c + __imag__ c * __imag__ c);
+    }
+  }
+  epre /= SRSRAN_NOF_SLOTS_PER_SF * N_rs;
+  noise *= (float)SRSRAN_NRE / (float)((SRSRAN_NRE - 1) * SRSRAN_NOF_SLOTS_PER_SF * N_rs);
+  if (cfg->format < SRSRAN_PUCCH_FORMAT_2) {
+    noise = decode_bank_format1_noise(q, sf, cfg, bank);
+  } else {
+    float noise_dmrs = decode_bank_format2_noise(q, sf, cfg, bank, n_cs, w);
+    if (!isnan(noise_dmrs)) {
+      noise = noise_dmrs;
+    }
+  }
+  if (fpclassify(noise) == FP_ZERO) {
+    noise = FLT_MIN;
+  }
+
+  data->rssi_dbFs = srsran_convert_power_to_dB(epre);
+  data->ni_dbFs   = srsran_convert_power_to_dBm(noise);
+  data->snr_db    = isnormal(noise) ? srsran_convert_power_to_dB(epre / noise) : NAN;
+
+  // Estimate time alignment, the cyclic shift is a constant phase step between subcarriers
+  if (cfg->meas_ta_en) {
+    float ta_err = 0.0f;
+    for (uint32_t s = 0; s < SRSRAN_NOF_SLOTS_PER_SF; s++) {
+      for (uint32_t m = 0; m < N_rs; m++) {
+        uint32_t l   = srsran_refsignal_dmrs_pucch_symbol(m, cfg->format, q->cell.cp);
+        cf_t     acc = srsran_vec_dot_prod_conj_ccc(&bank->z[s][l][1], &bank->z[s][l][0], SRSRAN_NRE - 1);
+        acc *= cexpf(-I * 2.0f * (float)M_PI * n_cs[s][m] / SRSRAN_NRE);
+        ta_err += -cargf(acc) * M_1_PI * 0.5f / (float)(SRSRAN_NOF_SLOTS_PER_SF * N_rs);
+      }
+    }
+
+    // Calculate actual time alignment error in micro-seconds
+    if (isnormal(ta_err)) {
+      ta_err /= 15e3f;                           // Convert from normalized frequency to seconds
+      ta_err *= 1e6f;                            // Convert to micro-seconds
+      ta_err       = roundf(ta_err * 10.0f) / 10.0f; // Round to one tenth of micro-second
+      data->ta_us = ta_err;
+    } else {
+      data->ta_us = 0.0f;
+    }
+    data->ta_valid = true;
+  }
+
+  // Perform DMRS Detection, if enabled. The ratio is the energy of the resource cyclic shift over the energy it would
+  // have in every cyclic shift if the rest only carried noise, so the resources sharing the PRB pair do not lower it
+  if (isnormal(cfg->threshold_dmrs_detection_bank)) {
+    float rms = 0.0f;
+    for (uint32_t s = 0; s < SRSRAN_NOF_SLOTS_PER_SF; s++) {
+      cf_t b = 0.0f;
+      for (uint32_t m = 0; m < N_rs; m++) {
+        uint32_t l = srsran_refsignal_dmrs_pucch_symbol(m, cfg->format, q->cell.cp);
+        b += bank->corr[s][l][n_cs[s][m]] * conjf(w[s][m]);
+      }
+      rms += __real__ b * __real__ b + __imag__ b * __imag__ b;
+    }
+    float noise_bins       = (float)(SRSRAN_NOF_SLOTS_PER_SF * (SRSRAN_NRE - 1) * N_rs) * noise / SRSRAN_NRE;
+    data->dmrs_correlation = rms / (rms + noise_bins);
+
+    // Return not detected if the ratio is 0, NAN, +/- Infinity or below threshold
+    if (!isnormal(data->dmrs_correlation) || data->dmrs_correlation < cfg->threshold_dmrs_detection_bank) {
+      data->correlation = 0.0f;
+      data->detected    = false;
+      return SRSRAN_SUCCESS;
+    }
+  }
+
+  // Perform ML-decoding
+  bool  detected = false;
+  float corr     = 0.0f;
+  if (cfg->format < SRSRAN_PUCCH_FORMAT_2) {
+    float norm = 0.0f;
+    cf_t  acc  = decode_bank_format1(q, sf, cfg, bank, h, noise, &norm);
+
+    float   corr_max = -1e9;
+    uint8_t b_max = 0, b2_max = 0; // default bit value, eg. HI is NACK
     switch (cfg->format) {
+      case SRSRAN_PUCCH_FORMAT_1:
+        corr     = decode_bank_format1_corr(acc, norm, uci_encode_format1());
+        detected = corr >= cfg->threshold_format1_bank;
+        break;
       case SRSRAN_PUCCH_FORMAT_1A:
-      case SRSRAN_PUCCH_FORMAT_1B:
-        data->uci_data.ack.valid = data->correlation > cfg->threshold_data_valid_format1a;
+        for (uint8_t b = 0; b < 2; b++) {
+          corr = decode_bank_format1_corr(acc, norm, uci_encode_format1a(b));
+          if (corr > corr_max) {
+            corr_max = corr;
+            b_max    = b;
+          }
+        }
+        detected      = corr_max > cfg->threshold_format1_bank;
+        corr          = corr_max;
+        pucch_bits[0] = b_max;
         break;
-      case SRSRAN_PUCCH_FORMAT_2:
-      case SRSRAN_PUCCH_FORMAT_2A:
-      case SRSRAN_PUCCH_FORMAT_2B:
-        data->detected              = data->correlation > cfg->threshold_data_valid_format2;
-        data->uci_data.ack.valid    = data->detected;
-        data->uci_data.cqi.data_crc = data->detected;
+      default:
+        for (uint8_t b = 0; b < 2; b++) {
+          for (uint8_t b2 = 0; b2 < 2; b2++) {
+            uint8_t bits[2] = {b, b2};
+            corr            = decode_bank_format1_corr(acc, norm, uci_encode_format1b(bits));
+            if (corr > corr_max) {
+              corr_max = corr;
+              b_max    = b;
+              b2_max   = b2;
+            }
+          }
+        }
+        detected      = corr_max > cfg->threshold_format1_bank;
+        corr          = corr_max;
+        pucch_bits[0] = b_max;
+        pucch_bits[1] = b2_max;
         break;
-      case SRSRAN_PUCCH_FORMAT_1:
-      case SRSRAN_PUCCH_FORMAT_3:
-      default:; // Not considered, do nothing
+    }
+  } else {
+    // Equalise the despread symbols
+    uint32_t sf_idx = sf->tti % SRSRAN_NOF_SF_X_FRAME;
+    for (uint32_t ns = SRSRAN_NOF_SLOTS_PER_SF * sf_idx; ns < SRSRAN_NOF_SLOTS_PER_SF * (sf_idx + 1); ns++) {
+      cf_t  h_s = h[ns % 2];
+      float den = __real__ h_s * __real__ h_s + __imag__ h_s * __imag__ h_s + noise / SRSRAN_NRE;
+      for (uint32_t m = 0; m < SRSRAN_PUCCH2_N_SF; m++) {
+        uint32_t l     = get_pucch_symbol(m, cfg->format, q->cell.cp);
+        float    alpha = srsran_pucch_alpha_format2(q->n_cs_cell, cfg, ns, l);
+        cf_t     c     = bank->corr[ns % 2][l][pucch_alpha_n_cs(alpha)];
+
+        q->z[(ns % 2) * SRSRAN_PUCCH2_N_SF + m] = isnormal(den) ? c * conjf(h_s) / den : 0.0f;
+      }
     }
 
-    ret = SRSRAN_SUCCESS;
+    uint32_t nof_uci_bits = cfg->uci_cfg.cqi.ri_len ? cfg->uci_cfg.cqi.ri_len : srsran_cqi_size(&cfg->uci_cfg.cqi);
+    if (decode_symbols_format2(q, sf, cfg, pucch_bits, nof_uci_bits, &corr) < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+    detected = true;
   }
 
-  return ret;
+  data->correlation = corr;
+  decode_result(cfg, detected, pucch_bits, data);
+
+  return SRSRAN_SUCCESS;
 }
 
 char* srsran_pucch_format_text(srsran_pucch_format_t format)
@@ -974,13 +1421,7 @@ bool srsran_pucch_cfg_isvalid(srsran_pucch_cfg_t* cfg, uint32_t nof_prb)
 
 uint32_t srsran_pucch_n_prb(const srsran_cell_t* cell, const srsran_pucch_cfg_t* cfg, uint32_t ns)
 {
-  uint32_t m = srsran_pucch_m(cfg, cell->cp);
-  // Determine n_prb
-  uint32_t n_prb = m / 2;
-  if ((m + ns) % 2) {
-    n_prb = cell->nof_prb - 1 - m / 2;
-  }
-  return n_prb;
+  return pucch_n_prb_m(cell, srsran_pucch_m(cfg, cell->cp), ns);
 }
 
 // Compute m according to Section 5.4.3 of 36.211
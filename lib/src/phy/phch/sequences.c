@@ -113,6 +113,99 @@ void srsran_sequence_pdsch_apply_c(const int8_t* in,
   srsran_sequence_apply_c(in, out, len, sequence_pdsch_seed(rnti, q, nslot, cell_id));
 }
 
+void srsran_sequence_pdsch_apply_pack_cached(srsran_sequence_cache_t* cache,
+                                             const uint8_t*           in,
+                                             uint8_t*                 out,
+                                             uint16_t                 rnti,
+                                             int                      q,
+                                             uint32_t                 nslot,
+                                             uint32_t                 cell_id,
+                                             uint32_t                 len)
+{
+  uint32_t       seed = sequence_pdsch_seed(rnti, q, nslot, cell_id);
+  const uint8_t* c    = srsran_sequence_cache_get(cache, seed, len);
+  if (c != NULL) {
+    srsran_sequence_packed_apply_packed(c, in, out, len);
+  } else {
+    srsran_sequence_apply_packed(in, out, len, seed);
+  }
+}
+
+void srsran_sequence_pdsch_apply_f_cached(srsran_sequence_cache_t* cache,
+                                          const float*             in,
+                                          float*                   out,
+                                          uint16_t                 rnti,
+                                          int                      q,
+                                          uint32_t                 nslot,
+                                          uint32_t                 cell_id,
+                                          uint32_t                 len)
+{
+  uint32_t       seed = sequence_pdsch_seed(rnti, q, nslot, cell_id);
+  const uint8_t* c    = srsran_sequence_cache_get(cache, seed, len);
+  if (c != NULL) {
+    srsran_sequence_packed_apply_f(c, in, out, len);
+  } else {
+    srsran_sequence_apply_f(in, out, len, seed);
+  }
+}
+
+void srsran_sequence_pdsch_apply_s_cached(srsran_sequence_cache_t* cache,
+                                          const int16_t*           in,
+                                          int16_t*                 out,
+                                          uint16_t                 rnti,
+                                          int                      q,
+                                          uint32_t                 nslot,
+                                          uint32_t                 cell_id,
+                                          uint32_t                 len)
+{
+  uint32_t       seed = sequence_pdsch_seed(rnti, q, nslot, cell_id);
+  const uint8_t* c    = srsran_sequence_cache_get(cache, seed, len);
+  if (c != NULL) {
+    srsran_sequence_packed_apply_s(c, in, out, len);
+  } else {
+    srsran_sequence_apply_s(in, out, len, seed);
+  }
+}
+
+void srsran_sequence_pdsch_apply_c_cached(srsran_sequence_cache_t* cache,
+                                          const int8_t*            in,
+                                          int8_t*                  out,
+                                          uint16_t                 rnti,
+                                          int                      q,
+                                          uint32_t                 nslot,
+                                          uint32_t                 cell_id,
+                                          uint32_t                 len)
+{
+  uint32_t       seed = sequence_pdsch_seed(rnti, q, nslot, cell_id);
+  const uint8_t* c    = srsran_sequence_cache_get(cache, seed, len);
+  if (c != NULL) {
+    srsran_sequence_packed_apply_c(c, in, out, len);
+  } else {
+    srsran_sequence_apply_c(in, out, len, seed);
+  }
+}
+
+#define SEQUENCE_PDSCH_PREFETCH_BATCH 32
+
+void srsran_sequence_pdsch_prefetch(srsran_sequence_cache_t* cache,
+                                    const uint16_t*          rnti,
+                                    uint32_t                 nof_rnti,
+                                    int                      q,
+                                    uint32_t                 nslot,
+                                    uint32_t                 cell_id,
+                                    uint32_t                 len)
+{
+  uint32_t seeds[SEQUENCE_PDSCH_PREFETCH_BATCH];
+
+  for (uint32_t i = 0; i < nof_rnti; i += SEQUENCE_PDSCH_PREFETCH_BATCH) {
+    uint32_t count = SRSRAN_MIN(nof_rnti - i, SEQUENCE_PDSCH_PREFETCH_BATCH);
+    for (uint32_t j = 0; j < count; j++) {
+      seeds[j] = sequence_pdsch_seed(rnti[i + j], q, nslot, cell_id);
+    }
+    srsran_sequence_cache_prefetch(cache, seeds, count, len);
+  }
+}
+
 /**
  * 36.211 5.3.1
  */
@@ -218,10 +218,9 @@ int main(int argc, char** argv)
         srsran_softbuffer_rx_reset(pdsch_cfg.grant.tb[tb].softbuffer.rx);
       }
 
-      for (uint32_t i = 0; i < pdsch_cfg.grant.tb->nof_re; i++) {
-        chest.ce[0][0][i] = 1.0f;
-      }
-      chest.nof_re = pdsch_cfg.grant.tb->nof_re;
+      // Every layer is received through an ideal channel on the antenna with the same index
+      chest.nof_re = pdsch_cfg.grant.tb->nof_re / pdsch_cfg.grant.nof_layers;
+      srsran_chest_dl_res_set_identity(&chest);
 
       if (srsran_pdsch_nr_decode(&pdsch_rx, &pdsch_cfg, &pdsch_cfg.grant, &chest, sf_symbols, &pdsch_res) <
           SRSRAN_SUCCESS) {
@@ -235,23 +234,19 @@ int main(int argc, char** argv)
       }
 
       float    mse    = 0.0f;
-      uint32_t nof_re = srsran_ra_dl_nr_slot_nof_re(&pdsch_cfg, &pdsch_cfg.grant);
-      for (uint32_t i = 0; i < pdsch_cfg.grant.nof_layers; i++) {
-        for (uint32_t j = 0; j < nof_re; j++) {
-          mse += cabsf(pdsch_tx.d[i][j] - pdsch_rx.d[i][j]);
-        }
+      uint32_t nof_re = pdsch_cfg.grant.tb[0].nof_re;
+      for (uint32_t j = 0; j < nof_re; j++) {
+        mse += cabsf(pdsch_tx.d[0][j] - pdsch_rx.d[0][j]);
       }
-      if (nof_re * pdsch_cfg.grant.nof_layers > 0) {
-        mse = mse / (nof_re * pdsch_cfg.grant.nof_layers);
+      if (nof_re > 0) {
+        mse = mse / nof_re;
       }
       if (mse > 0.001) {
         ERROR("MSE error (%f) is too high", mse);
-        for (uint32_t i = 0; i < pdsch_cfg.grant.nof_layers; i++) {
-          printf("d_tx[%d]=", i);
-          srsran_vec_fprint_c(stdout, pdsch_tx.d[i], nof_re);
-          printf("d_rx[%d]=", i);
-          srsran_vec_fprint_c(stdout, pdsch_rx.d[i], nof_re);
-        }
+        printf("d_tx=");
+        srsran_vec_fprint_c(stdout, pdsch_tx.d[0], nof_re);
+        printf("d_rx=");
+        srsran_vec_fprint_c(stdout, pdsch_rx.d[0], nof_re);
         goto clean_exit;
       }
 
@@ -273,6 +268,16 @@ int main(int argc, char** argv)
     }
   }
 
+  // Detecting more layers than receive antennas must fail
+  if (pdsch_cfg.grant.nof_layers > 1) {
+    pdsch_rx.nof_rx_ant = pdsch_cfg.grant.nof_layers - 1;
+    if (srsran_pdsch_nr_decode(&pdsch_rx, &pdsch_cfg, &pdsch_cfg.grant, &chest, sf_symbols, &pdsch_res) >=
+        SRSRAN_SUCCESS) {
+      ERROR("Decoded %d layers with %d receive antennas", pdsch_cfg.grant.nof_layers, pdsch_rx.nof_rx_ant);
+      goto clean_exit;
+    }
+  }
+
   ret = SRSRAN_SUCCESS;
 
 clean_exit:
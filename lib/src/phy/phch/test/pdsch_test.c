@@ -30,6 +30,9 @@
 // Enable to measure execution time
 #define NOF_CE_SYMBOLS SRSRAN_NOF_RE(cell)
 
+// Room for the sequences of one RNTI in every subframe of a 100 PRB cell
+#define SEQ_CACHE_BYTES (SRSRAN_NOF_SF_X_FRAME * 20 * 1024)
+
 static srsran_cell_t cell = {
     6,                  // nof_prb
     1,                  // nof_ports
@@ -50,6 +53,8 @@ static uint16_t    rnti                         = 1234;
 static uint32_t    nof_rx_antennas              = 1;
 static bool        tb_cw_swap                   = false;
 static bool        enable_coworker              = false;
+static bool        enable_seq_cache             = false;
+static bool        enable_csi                   = false;
 static uint32_t    pmi                          = 0;
 static char*       input_file                   = NULL;
 static int         M                            = 1;
@@ -76,6 +81,8 @@ void usage(char* prog)
   printf("\t-p pmi (multiplex only)  [Default %d]\n", pmi);
   printf("\t-w Swap Transport Blocks\n");
   printf("\t-j Enable PDSCH decoder coworker\n");
+  printf("\t-C Enable the scrambling sequence cache\n");
+  printf("\t-S Enable the CSI weighting of the LLR\n");
   printf("\t-v [set srsran_verbose to debug, default none]\n");
   printf("\t-q Enable/Disable 256QAM modulation (default %s)\n", enable_256qam ? "enabled" : "disabled");
 }
@@ -83,7 +90,7 @@ void usage(char* prog)
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "fmMcsbrtRFpnqawvXxj")) != -1) {
+  while ((opt = getopt(argc, argv, "fmMcsbrtRFpnqawvXxjCS")) != -1) {
     switch (opt) {
       case 'f':
         input_file = argv[optind];
@@ -136,6 +143,12 @@ void parse_args(int argc, char** argv)
       case 'j':
         enable_coworker = true;
         break;
+      case 'C':
+        enable_seq_cache = true;
+        break;
+      case 'S':
+        enable_csi = true;
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -281,6 +294,7 @@ int main(int argc, char** argv)
   pdsch_cfg.power_scale = true;
   pdsch_cfg.p_a         = 0.0f;                      // 0 dB
   pdsch_cfg.p_b         = (tm > SRSRAN_TM1) ? 1 : 0; // 0 dB
+  pdsch_cfg.csi_enable  = enable_csi;
 
   /* Generate dci from DCI */
   if (srsran_ra_dl_dci_to_grant(&cell, &dl_sf, tm, enable_256qam, &dci, &pdsch_cfg.grant)) {
@@ -339,6 +353,11 @@ int main(int argc, char** argv)
     goto quit;
   }
 
+  if (enable_seq_cache && srsran_pdsch_set_sequence_cache(&pdsch_rx, SEQ_CACHE_BYTES)) {
+    ERROR("Error enabling scrambling sequence cache");
+    goto quit;
+  }
+
   pdsch_rx.llr_is_8bit        = use_8_bit;
   pdsch_rx.dl_sch.llr_is_8bit = use_8_bit;
 
@@ -386,6 +405,10 @@ int main(int argc, char** argv)
       ERROR("Error creating PDSCH object");
       goto quit;
     }
+    if (enable_seq_cache && srsran_pdsch_set_sequence_cache(&pdsch_tx, SEQ_CACHE_BYTES)) {
+      ERROR("Error enabling scrambling sequence cache");
+      goto quit;
+    }
 
     for (uint32_t i = 0; i < SRSRAN_MAX_CODEWORDS; i++) {
       softbuffers_tx[i] = calloc(sizeof(srsran_softbuffer_tx_t), 1);
@@ -436,6 +459,8 @@ int main(int argc, char** argv)
     for (int i = 0; i < SRSRAN_MAX_CODEWORDS; i++) {
       pdsch_cfg.grant.tb[i].rv = rv_idx[i];
     }
+    srsran_pdsch_cfg_t* prefetch_cfg = &pdsch_cfg;
+    srsran_pdsch_prefetch_sequences(&pdsch_tx, &dl_sf, &prefetch_cfg, 1);
     for (uint32_t k = 0; k < M; k++) {
       if (srsran_pdsch_encode(&pdsch_tx, &dl_sf, &pdsch_cfg, data_tx, tx_slot_symbols)) {
         ERROR("Error encoding PDSCH");
@@ -0,0 +1,284 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/sync/pss_sss_batch.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include <string.h>
+
+#define PSS_SSS_BATCH_DEFAULT_EMA_ALPHA 0.2f
+
+int srsran_pss_sss_batch_init(srsran_pss_sss_batch_t* q, uint32_t max_frame_size, uint32_t max_fft_size)
+{
+  if (q == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_pss_sss_batch_t, 1);
+
+  if (srsran_pss_init_fft(&q->pss, max_frame_size, max_fft_size) < SRSRAN_SUCCESS) {
+    ERROR("Error initiating PSS");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_sss_init(&q->sss, max_fft_size) < SRSRAN_SUCCESS) {
+    ERROR("Error initiating SSS");
+    return SRSRAN_ERROR;
+  }
+
+  q->max_frame_size    = max_frame_size;
+  q->max_fft_size      = max_fft_size;
+  q->ema_alpha         = PSS_SSS_BATCH_DEFAULT_EMA_ALPHA;
+  q->detect_frame_type = true;
+  q->frame_type        = SRSRAN_FDD;
+
+  uint32_t buffer_size = max_frame_size + max_fft_size + 1;
+  q->corr              = srsran_vec_cf_malloc(buffer_size);
+  q->corr_abs          = srsran_vec_f_malloc(buffer_size);
+  if (q->corr == NULL || q->corr_abs == NULL) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+
+  for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2; N_id_2++) {
+    q->corr_avg[N_id_2] = srsran_vec_f_malloc(buffer_size);
+    if (q->corr_avg[N_id_2] == NULL) {
+      ERROR("Error allocating memory");
+      return SRSRAN_ERROR;
+    }
+  }
+
+  return srsran_pss_sss_batch_resize(q, max_frame_size, max_fft_size);
+}
+
+int srsran_pss_sss_batch_resize(srsran_pss_sss_batch_t* q, uint32_t frame_size, uint32_t fft_size)
+{
+  if (q == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  if (frame_size > q->max_frame_size || fft_size > q->max_fft_size || frame_size < fft_size) {
+    ERROR("Invalid frame_size=%d or fft_size=%d", frame_size, fft_size);
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_pss_resize(&q->pss, frame_size, fft_size, 0) < SRSRAN_SUCCESS) {
+    ERROR("Error resizing PSS");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_sss_resize(&q->sss, fft_size) < SRSRAN_SUCCESS) {
+    ERROR("Error resizing SSS");
+    return SRSRAN_ERROR;
+  }
+
+  q->frame_size = frame_size;
+  q->fft_size   = fft_size;
+
+  srsran_pss_sss_batch_reset(q);
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_pss_sss_batch_free(srsran_pss_sss_batch_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  srsran_pss_free(&q->pss);
+  srsran_sss_free(&q->sss);
+
+  if (q->corr) {
+    free(q->corr);
+  }
+  if (q->corr_abs) {
+    free(q->corr_abs);
+  }
+  for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2; N_id_2++) {
+    if (q->corr_avg[N_id_2]) {
+      free(q->corr_avg[N_id_2]);
+    }
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_pss_sss_batch_t, 1);
+}
+
+void srsran_pss_sss_batch_reset(srsran_pss_sss_batch_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2; N_id_2++) {
+    srsran_vec_f_zero(q->corr_avg[N_id_2], q->max_frame_size + q->max_fft_size + 1);
+  }
+}
+
+void srsran_pss_sss_batch_set_ema_alpha(srsran_pss_sss_batch_t* q, float alpha)
+{
+  if (q != NULL) {
+    q->ema_alpha = alpha;
+  }
+}
+
+void srsran_pss_sss_batch_set_threshold(srsran_pss_sss_batch_t* q, float threshold)
+{
+  if (q != NULL) {
+    q->threshold = threshold;
+  }
+}
+
+void srsran_pss_sss_batch_set_sss_threshold(srsran_pss_sss_batch_t* q, float threshold)
+{
+  if (q != NULL) {
+    srsran_sss_set_threshold(&q->sss, threshold);
+  }
+}
+
+void srsran_pss_sss_batch_set_frame_type(srsran_pss_sss_batch_t* q, srsran_frame_type_t frame_type)
+{
+  if (q != NULL) {
+    q->frame_type        = frame_type;
+    q->detect_frame_type = false;
+  }
+}
+
+// Same peak to side-lobe ratio as the one returned by srsran_pss_find_pss()
+static float peak_sidelobe_ratio(const float* corr, uint32_t peak_pos, uint32_t len)
+{
+  // Find end of peak lobe to the right
+  int pl_ub = peak_pos + 1;
+  while (corr[pl_ub + 1] <= corr[pl_ub] && pl_ub < len) {
+    pl_ub++;
+  }
+  // Find end of peak lobe to the left
+  int pl_lb = 0;
+  if (peak_pos > 2) {
+    pl_lb = peak_pos - 1;
+    while (corr[pl_lb - 1] <= corr[pl_lb] && pl_lb > 1) {
+      pl_lb--;
+    }
+  }
+
+  int sl_distance_right = SRSRAN_MAX((int)len - 1 - pl_ub, 0);
+  int sl_distance_left  = pl_lb;
+
+  int   sl_right        = pl_ub + srsran_vec_max_fi(&corr[pl_ub], sl_distance_right);
+  int   sl_left         = srsran_vec_max_fi(corr, sl_distance_left);
+  float side_lobe_value = SRSRAN_MAX(corr[sl_right], corr[sl_left]);
+
+  return corr[peak_pos] / side_lobe_value;
+}
+
+// Correlates the SSS preceding the PSS peak with every N_id_1 candidate, for each frame type trial
+static void sss_detect(srsran_pss_sss_batch_t*     q,
+                       const cf_t*                 input,
+                       uint32_t                    find_offset,
+                       uint32_t                    N_id_2,
+                       srsran_pss_sss_batch_res_t* res)
+{
+  srsran_frame_type_t trials[2]    = {SRSRAN_FDD, SRSRAN_TDD};
+  uint32_t            nof_trials   = 2;
+  uint32_t            symbol_sz    = SRSRAN_SYMBOL_SZ(q->fft_size, SRSRAN_CP_NORM);
+  uint32_t            cp_sz        = SRSRAN_CP_SZ(q->fft_size, SRSRAN_CP_NORM);
+  uint32_t            pss_position = find_offset + res->peak_pos;
+
+  if (!q->detect_frame_type) {
+    trials[0]  = q->frame_type;
+    nof_trials = 1;
+  }
+
+  srsran_sss_set_N_id_2(&q->sss, N_id_2);
+
+  for (uint32_t f = 0; f < nof_trials; f++) {
+    uint32_t nof_symbols = (trials[f] == SRSRAN_FDD) ? 2 : 4;
+    if (pss_position + cp_sz < nof_symbols * symbol_sz) {
+      continue;
+    }
+    const cf_t* sss_ptr = &input[pss_position - nof_symbols * symbol_sz + cp_sz];
+
+    uint32_t m0 = 0, m1 = 0;
+    float    m0_value = 0.0f, m1_value = 0.0f;
+    srsran_sss_m0m1_partial(&q->sss, sss_ptr, 1, NULL, &m0, &m0_value, &m1, &m1_value);
+
+    float corr   = m0_value + m1_value;
+    int   N_id_1 = srsran_sss_N_id_1(&q->sss, m0, m1, corr);
+    if (N_id_1 >= 0 && (!res->sss_detected || corr > res->sss_corr)) {
+      res->sss_detected = true;
+      res->N_id_1       = (uint32_t)N_id_1;
+      res->sss_corr     = corr;
+      res->frame_type   = trials[f];
+      res->sf_idx       = srsran_sss_subframe(m0, m1) + ((trials[f] == SRSRAN_TDD) ? 1 : 0);
+    }
+  }
+}
+
+int srsran_pss_sss_batch_run(srsran_pss_sss_batch_t*    q,
+                             const cf_t*                input,
+                             uint32_t                   find_offset,
+                             srsran_pss_sss_batch_res_t res[SRSRAN_NOF_NID_2])
+{
+  if (q == NULL || input == NULL || res == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  srsran_conv_fft_cc_t* conv = &q->pss.conv_fft;
+
+  // Transform the window once, the tail of tmp_input is kept zero for the linear convolution
+  srsran_vec_cf_copy(q->pss.tmp_input, &input[find_offset], q->frame_size);
+  srsran_dft_run_c(&conv->input_plan, q->pss.tmp_input, conv->input_fft);
+
+  uint32_t corr_len = conv->output_len - 1;
+
+  for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2; N_id_2++) {
+    srsran_pss_sss_batch_res_t* r = &res[N_id_2];
+    SRSRAN_MEM_ZERO(r, srsran_pss_sss_batch_res_t, 1);
+
+    // Correlate with the PSS of this N_id_2, whose conjugate is symmetric
+    srsran_vec_prod_ccc(conv->input_fft, q->pss.pss_signal_freq_full[N_id_2], conv->output_fft, conv->output_len);
+    srsran_dft_run_c(&conv->output_plan, conv->output_fft, q->corr);
+
+    // Average the modulus square with the previous windows
+    float* avg = q->corr_avg[N_id_2];
+    srsran_vec_abs_square_cf(q->corr, q->corr_abs, corr_len - 1);
+    if (q->ema_alpha < 1.0f && q->ema_alpha > 0.0f) {
+      srsran_vec_sc_prod_fff(q->corr_abs, q->ema_alpha, q->corr_abs, corr_len - 1);
+      srsran_vec_sc_prod_fff(avg, 1 - q->ema_alpha, avg, corr_len - 1);
+      srsran_vec_sum_fff(q->corr_abs, avg, avg, corr_len - 1);
+    } else {
+      srsran_vec_f_copy(avg, q->corr_abs, corr_len - 1);
+    }
+
+    r->peak_pos   = srsran_vec_max_fi(avg, corr_len - 1);
+    r->peak_value = peak_sidelobe_ratio(avg, r->peak_pos, corr_len);
+    r->pss_found  = (r->peak_value >= q->threshold || q->threshold == 0);
+
+    DEBUG("PSS-SSS batch: N_id_2=%d, peak_pos=%d, peak_value=%f", N_id_2, r->peak_pos, r->peak_value);
+
+    // The SSS is only searched if there is enough space for it before the PSS
+    if (r->pss_found && find_offset + r->peak_pos >= 2 * (q->fft_size + SRSRAN_CP_LEN_EXT(q->fft_size))) {
+      sss_detect(q, input, find_offset, N_id_2, r);
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
@@ -48,6 +48,16 @@
  */
 #define SSB_PBCH_DMRS_DEFAULT_CORR_THR 0.5f
 
+/*
+ * Maximum number of PSS correlation peaks taken per window, sequence and frequency shift in the multiple SSB search
+ */
+#define SSB_SEARCH_MAX_PEAKS_WINDOW 4
+
+/*
+ * Minimum PSS correlation of a secondary peak, relative to the strongest peak of the window, in the multiple SSB search
+ */
+#define SSB_SEARCH_PEAK_REL_THR 0.25f
+
 static int ssb_init_corr(srsran_ssb_t* q)
 {
   // Initialise correlation only if it is enabled
@@ -850,6 +860,56 @@ static void ssb_vec_prod_conj_circ_shift(const cf_t* a, const cf_t* b, cf_t* c,
   srsran_vec_prod_conj_ccc(a, b, c, n);
 }
 
+/*
+ * Correlates in frequency domain the given PSS sequence, assuming it starts at the given delay, for every integer
+ * frequency shift within the range. Returns the shift providing the highest correlation.
+ */
+static int ssb_pss_fine_shift(srsran_ssb_t* q,
+                              const cf_t*   in,
+                              uint32_t      nof_samples,
+                              uint32_t      N_id_2,
+                              uint32_t      delay,
+                              int           shift_range)
+{
+  float best_corr  = 0.0f;
+  int   best_shift = 0;
+
+  // Number of samples taken in this iteration
+  uint32_t n = q->corr_sz;
+
+  // Detect if the correlation input exceeds the input length, take the maximum amount of samples
+  if (delay + q->corr_sz > nof_samples) {
+    n = nof_samples - delay;
+  }
+
+  // Copy the amount of samples
+  srsran_vec_cf_copy(q->tmp_time, &in[delay], n);
+
+  // Append zeros if there is space left
+  if (n < q->corr_sz) {
+    srsran_vec_cf_zero(&q->tmp_time[n], q->corr_sz - n);
+  }
+
+  // Convert to frequency domain
+  srsran_dft_run_guru_c(&q->fft_corr);
+
+  for (int shift = -shift_range; shift <= shift_range; shift++) {
+    // Actual correlation in frequency domain
+    ssb_vec_prod_conj_circ_shift(q->tmp_freq, q->pss_seq[N_id_2], q->tmp_corr, q->corr_sz, shift);
+
+    // Calculate correlation assuming the peak is in the first sample
+    float corr = SRSRAN_CSQABS(srsran_vec_acc_cc(q->tmp_corr, q->corr_sz));
+
+    // Update if the correlation is better than the current best
+    if (best_corr < corr) {
+      best_corr  = corr;
+      best_shift = shift;
+    }
+  }
+
+  return best_shift;
+}
+
 static int ssb_pss_search(srsran_ssb_t* q,
                           const cf_t*   in,
                           uint32_t      nof_samples,
@@ -937,43 +997,7 @@ static int ssb_pss_search(srsran_ssb_t* q,
   }
 
   // From the best sequence correlate in frequency domain
-  {
-    // Reset best correlation
-    best_corr = 0.0f;
-
-    // Number of samples taken in this iteration
-    uint32_t n = q->corr_sz;
-
-    // Detect if the correlation input exceeds the input length, take the maximum amount of samples
-    if (best_delay + q->corr_sz > nof_samples) {
-      n = nof_samples - best_delay;
-    }
-
-    // Copy the amount of samples
-    srsran_vec_cf_copy(q->tmp_time, &in[best_delay], n);
-
-    // Append zeros if there is space left
-    if (n < q->corr_sz) {
-      srsran_vec_cf_zero(&q->tmp_time[n], q->corr_sz - n);
-    }
-
-    // Convert to frequency domain
-    srsran_dft_run_guru_c(&q->fft_corr);
-
-    for (int shift = -shift_range; shift <= shift_range; shift++) {
-      // Actual correlation in frequency domain
-      ssb_vec_prod_conj_circ_shift(q->tmp_freq, q->pss_seq[best_N_id_2], q->tmp_corr, q->corr_sz, shift);
-
-      // Calculate correlation assuming the peak is in the first sample
-      float corr = SRSRAN_CSQABS(srsran_vec_acc_cc(q->tmp_corr, q->corr_sz));
-
-      // Update if the correlation is better than the current best
-      if (best_corr < corr) {
-        best_corr  = corr;
-        best_shift = shift;
-      }
-    }
-  }
+  best_shift = ssb_pss_fine_shift(q, in, nof_samples, best_N_id_2, best_delay, shift_range);
 
   // Save findings
   *found_delay   = best_delay;
@@ -1267,32 +1291,18 @@ int srsran_ssb_decode_pbch(srsran_ssb_t*         q,
   return SRSRAN_SUCCESS;
 }
 
-int srsran_ssb_search(srsran_ssb_t* q, const cf_t* in, uint32_t nof_samples, srsran_ssb_search_res_t* res)
+/*
+ * Demodulates the SSB whose PSS was found at t_offset, finds its N_id_1, selects the most suitable SSB candidate and
+ * decodes its PBCH. The result is only written if the PBCH is decoded.
+ */
+static int ssb_search_decode(srsran_ssb_t*            q,
+                             const cf_t*              in,
+                             uint32_t                 nof_samples,
+                             uint32_t                 N_id_2,
+                             uint32_t                 t_offset,
+                             float                    coarse_cfo_hz,
+                             srsran_ssb_search_res_t* res)
 {
-  // Verify inputs
-  if (q == NULL || in == NULL || res == NULL || !isnormal(q->scs_hz)) {
-    return SRSRAN_ERROR_INVALID_INPUTS;
-  }
-
-  if (!q->args.enable_search || !q->args.enable_decode) {
-    ERROR("SSB is not configured to search (%c) and decode (%c)",
-          q->args.enable_search ? 'y' : 'n',
-          q->args.enable_decode ? 'y' : 'n');
-    return SRSRAN_ERROR;
-  }
-
-  // Set the SSB search result with default value with PBCH CRC unmatched, meaning no cell is found
-  SRSRAN_MEM_ZERO(res, srsran_ssb_search_res_t, 1);
-
-  // Search for PSS in time domain
-  uint32_t N_id_2        = 0;
-  uint32_t t_offset      = 0;
-  float    coarse_cfo_hz = 0.0f;
-  if (ssb_pss_search(q, in, nof_samples, &N_id_2, &t_offset, &coarse_cfo_hz) < SRSRAN_SUCCESS) {
-    ERROR("Error searching for N_id_2");
-    return SRSRAN_ERROR;
-  }
-
   // Remove CP offset prior demodulation
   if (t_offset >= q->cp_sz) {
     t_offset -= q->cp_sz;
@@ -1366,6 +1376,227 @@ int srsran_ssb_search(srsran_ssb_t* q, const cf_t* in, uint32_t nof_samples, srs
   return SRSRAN_SUCCESS;
 }
 
+int srsran_ssb_search(srsran_ssb_t* q, const cf_t* in, uint32_t nof_samples, srsran_ssb_search_res_t* res)
+{
+  // Verify inputs
+  if (q == NULL || in == NULL || res == NULL || !isnormal(q->scs_hz)) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  if (!q->args.enable_search || !q->args.enable_decode) {
+    ERROR("SSB is not configured to search (%c) and decode (%c)",
+          q->args.enable_search ? 'y' : 'n',
+          q->args.enable_decode ? 'y' : 'n');
+    return SRSRAN_ERROR;
+  }
+
+  // Set the SSB search result with default value with PBCH CRC unmatched, meaning no cell is found
+  SRSRAN_MEM_ZERO(res, srsran_ssb_search_res_t, 1);
+
+  // Search for PSS in time domain
+  uint32_t N_id_2        = 0;
+  uint32_t t_offset      = 0;
+  float    coarse_cfo_hz = 0.0f;
+  if (ssb_pss_search(q, in, nof_samples, &N_id_2, &t_offset, &coarse_cfo_hz) < SRSRAN_SUCCESS) {
+    ERROR("Error searching for N_id_2");
+    return SRSRAN_ERROR;
+  }
+
+  return ssb_search_decode(q, in, nof_samples, N_id_2, t_offset, coarse_cfo_hz, res);
+}
+
+/*
+ * PSS correlation peak kept as candidate by the multiple SSB search
+ */
+typedef struct {
+  uint32_t N_id_2;
+  uint32_t delay;
+  int      shift;
+  float    corr;
+} ssb_pss_candidate_t;
+
+/*
+ * Adds a PSS candidate to the list. A candidate of the same sequence closer than a symbol to an existing one is the
+ * same SSB seen by a different window or frequency shift, only the strongest of them is kept. If the list is full,
+ * the weakest candidate is replaced.
+ */
+static void ssb_pss_candidate_add(srsran_ssb_t*              q,
+                                  ssb_pss_candidate_t*       list,
+                                  uint32_t*                  nof_candidates,
+                                  const ssb_pss_candidate_t* c)
+{
+  for (uint32_t i = 0; i < *nof_candidates; i++) {
+    uint32_t distance = (list[i].delay > c->delay) ? (list[i].delay - c->delay) : (c->delay - list[i].delay);
+    if (list[i].N_id_2 == c->N_id_2 && distance < q->symbol_sz) {
+      if (c->corr > list[i].corr) {
+        list[i] = *c;
+      }
+      return;
+    }
+  }
+
+  if (*nof_candidates < SRSRAN_SSB_SEARCH_MAX_CANDIDATES) {
+    list[(*nof_candidates)++] = *c;
+    return;
+  }
+
+  uint32_t weakest = 0;
+  for (uint32_t i = 1; i < *nof_candidates; i++) {
+    if (list[i].corr < list[weakest].corr) {
+      weakest = i;
+    }
+  }
+  if (c->corr > list[weakest].corr) {
+    list[weakest] = *c;
+  }
+}
+
+static int ssb_pss_candidate_cmp(const void* a, const void* b)
+{
+  float corr_a = ((const ssb_pss_candidate_t*)a)->corr;
+  float corr_b = ((const ssb_pss_candidate_t*)b)->corr;
+  return (corr_a < corr_b) - (corr_a > corr_b);
+}
+
+/*
+ * Same correlation as ssb_pss_search() but, instead of the best peak, it keeps up to SSB_SEARCH_MAX_PEAKS_WINDOW peaks
+ * per window, sequence and frequency shift. Every window is transformed once and correlated with the three PSS.
+ */
+static int ssb_pss_search_multiple(srsran_ssb_t*       q,
+                                   const cf_t*         in,
+                                   uint32_t            nof_samples,
+                                   ssb_pss_candidate_t list[SRSRAN_SSB_SEARCH_MAX_CANDIDATES],
+                                   uint32_t*           nof_candidates)
+{
+  // verify it is initialised
+  if (q->corr_sz == 0) {
+    return SRSRAN_ERROR;
+  }
+
+  // Same coarse CFO steering than ssb_pss_search()
+  double coarse_cfo_ref_hz = (q->cfg.srate_hz / q->corr_sz);
+  int    shift_range       = (int)ceil(SRSRAN_SUBC_SPACING_NR(q->cfg.scs) / coarse_cfo_ref_hz);
+  int    shift_coarse_inc  = SRSRAN_MAX(shift_range / 2, 1);
+
+  *nof_candidates = 0;
+
+  // Delay in correlation window
+  uint32_t t_offset = 0;
+  while ((t_offset + q->symbol_sz) < nof_samples) {
+    // Number of samples taken in this iteration
+    uint32_t n = SRSRAN_MIN(q->corr_sz, nof_samples - t_offset);
+
+    // Copy the amount of samples and append zeros if there is space left
+    srsran_vec_cf_copy(q->tmp_time, &in[t_offset], n);
+    if (n < q->corr_sz) {
+      srsran_vec_cf_zero(&q->tmp_time[n], q->corr_sz - n);
+    }
+
+    // Convert to frequency domain once for all the sequences and shifts
+    srsran_dft_run_guru_c(&q->fft_corr);
+
+    for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2_NR; N_id_2++) {
+      for (int shift = -shift_range; shift <= shift_range; shift += shift_coarse_inc) {
+        ssb_vec_prod_conj_circ_shift(q->tmp_freq, q->pss_seq[N_id_2], q->tmp_corr, q->corr_sz, shift);
+        srsran_dft_run_guru_c(&q->ifft_corr);
+
+        float avg_pwr_corr = srsran_vec_avg_power_cf(q->tmp_corr, q->corr_sz);
+        if (!isnormal(avg_pwr_corr)) {
+          continue;
+        }
+
+        // Take the strongest peaks, blanking a symbol around each of them
+        float best_corr = 0.0f;
+        for (uint32_t p = 0; p < SSB_SEARCH_MAX_PEAKS_WINDOW; p++) {
+          uint32_t peak_idx = srsran_vec_max_abs_ci(q->tmp_time, q->corr_window);
+          float    corr     = SRSRAN_CSQABS(q->tmp_time[peak_idx]) / avg_pwr_corr / sqrtf(SRSRAN_PSS_NR_LEN);
+          if (p == 0) {
+            best_corr = corr;
+          } else if (corr < best_corr * SSB_SEARCH_PEAK_REL_THR) {
+            break;
+          }
+
+          ssb_pss_candidate_t c = {N_id_2, peak_idx + t_offset, shift, corr};
+          ssb_pss_candidate_add(q, list, nof_candidates, &c);
+
+          uint32_t blank_start = (peak_idx > q->symbol_sz) ? (peak_idx - q->symbol_sz) : 0;
+          uint32_t blank_end   = SRSRAN_MIN(peak_idx + q->symbol_sz, q->corr_window);
+          srsran_vec_cf_zero(&q->tmp_time[blank_start], blank_end - blank_start);
+        }
+      }
+    }
+
+    // Advance time
+    t_offset += q->corr_window;
+  }
+
+  // Strongest candidates first
+  qsort(list, *nof_candidates, sizeof(ssb_pss_candidate_t), ssb_pss_candidate_cmp);
+
+  // Refine the frequency shift of every candidate
+  for (uint32_t i = 0; i < *nof_candidates; i++) {
+    list[i].shift = ssb_pss_fine_shift(q, in, nof_samples, list[i].N_id_2, list[i].delay, shift_range);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_ssb_search_all(srsran_ssb_t*           q,
+                          const cf_t*             in,
+                          uint32_t                nof_samples,
+                          srsran_ssb_search_res_t res[],
+                          uint32_t                max_nof_res)
+{
+  // Verify inputs
+  if (q == NULL || in == NULL || res == NULL || !isnormal(q->scs_hz)) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  if (!q->args.enable_search || !q->args.enable_decode) {
+    ERROR("SSB is not configured to search (%c) and decode (%c)",
+          q->args.enable_search ? 'y' : 'n',
+          q->args.enable_decode ? 'y' : 'n');
+    return SRSRAN_ERROR;
+  }
+
+  // Find the PSS candidates
+  ssb_pss_candidate_t candidates[SRSRAN_SSB_SEARCH_MAX_CANDIDATES] = {};
+  uint32_t            nof_candidates                               = 0;
+  if (ssb_pss_search_multiple(q, in, nof_samples, candidates, &nof_candidates) < SRSRAN_SUCCESS) {
+    ERROR("Error searching for PSS");
+    return SRSRAN_ERROR;
+  }
+
+  // Decode the PBCH of every candidate, strongest first
+  double   coarse_cfo_ref_hz = (q->cfg.srate_hz / q->corr_sz);
+  uint32_t nof_res           = 0;
+  for (uint32_t i = 0; i < nof_candidates && nof_res < max_nof_res; i++) {
+    srsran_ssb_search_res_t r             = {};
+    float                   coarse_cfo_hz = -(float)candidates[i].shift * coarse_cfo_ref_hz;
+    if (ssb_search_decode(q, in, nof_samples, candidates[i].N_id_2, candidates[i].delay, coarse_cfo_hz, &r) <
+        SRSRAN_SUCCESS) {
+      ERROR("Error decoding SSB candidate");
+      return SRSRAN_ERROR;
+    }
+
+    if (!r.pbch_msg.crc) {
+      continue;
+    }
+
+    // Skip the SSB if it was already decoded from another candidate
+    bool duplicated = false;
+    for (uint32_t j = 0; j < nof_res && !duplicated; j++) {
+      duplicated = (res[j].N_id == r.N_id && res[j].pbch_msg.ssb_idx == r.pbch_msg.ssb_idx &&
+                    res[j].pbch_msg.hrf == r.pbch_msg.hrf);
+    }
+    if (!duplicated) {
+      res[nof_res++] = r;
+    }
+  }
+
+  return (int)nof_res;
+}
+
 static int ssb_pss_find(srsran_ssb_t* q, const cf_t* in, uint32_t nof_samples, uint32_t N_id_2, uint32_t* found_delay)
 {
   // verify it is initialised
@@ -0,0 +1,191 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/channel/ch_awgn.h"
+#include "srsran/phy/dft/ofdm.h"
+#include "srsran/phy/sync/pss_sss_batch.h"
+#include "srsran/phy/sync/sync.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include "srsran/support/srsran_test.h"
+#include <getopt.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#define NOF_FRAMES 2
+#define NOF_REPETITIONS 100
+
+static uint32_t nof_prb = 6;
+static float    snr_dB  = 20.0f;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [ps]\n", prog);
+  printf("\t-p nof_prb [Default %d]\n", nof_prb);
+  printf("\t-s SNR in dB [Default %.1f]\n", snr_dB);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "ps")) != -1) {
+    switch (opt) {
+      case 'p':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        snr_dB = strtof(argv[optind], NULL);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Adds the PSS/SSS of the given cell, delayed by delay samples, to NOF_FRAMES frames of signal
+static int add_cell(cf_t* signal, uint32_t pci, uint32_t delay)
+{
+  uint32_t fft_size = srsran_symbol_sz(nof_prb);
+  uint32_t sf_len   = SRSRAN_SF_LEN(fft_size);
+
+  cf_t* grid = srsran_vec_cf_malloc(sf_len);
+  cf_t* sf   = srsran_vec_cf_malloc(sf_len);
+  TESTASSERT(grid != NULL && sf != NULL);
+
+  srsran_ofdm_t ifft = {};
+  TESTASSERT(srsran_ofdm_tx_init(&ifft, SRSRAN_CP_NORM, grid, sf, nof_prb) == SRSRAN_SUCCESS);
+
+  cf_t  pss_signal[SRSRAN_PSS_LEN];
+  float sss_signal0[SRSRAN_SSS_LEN];
+  float sss_signal5[SRSRAN_SSS_LEN];
+  srsran_pss_generate(pss_signal, pci % SRSRAN_NOF_NID_2);
+  srsran_sss_generate(sss_signal0, sss_signal5, pci);
+
+  for (uint32_t sf_idx = 0; sf_idx < 2; sf_idx++) {
+    srsran_vec_cf_zero(grid, sf_len);
+    srsran_pss_put_slot(pss_signal, grid, nof_prb, SRSRAN_CP_NORM);
+    srsran_sss_put_slot(sf_idx ? sss_signal5 : sss_signal0, grid, nof_prb, SRSRAN_CP_NORM);
+    srsran_ofdm_tx_sf(&ifft);
+
+    for (uint32_t n = sf_idx; n < 2 * NOF_FRAMES; n += 2) {
+      uint32_t start = n * 5 * sf_len + delay;
+      uint32_t len   = SRSRAN_MIN(sf_len, NOF_FRAMES * 10 * sf_len - start);
+      srsran_vec_sum_ccc(&signal[start], sf, &signal[start], len);
+    }
+  }
+
+  srsran_ofdm_tx_free(&ifft);
+  free(grid);
+  free(sf);
+  return SRSRAN_SUCCESS;
+}
+
+static double elapsed_us(struct timeval t[3])
+{
+  get_time_interval(t);
+  return t[0].tv_sec * 1e6 + t[0].tv_usec;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  uint32_t fft_size   = srsran_symbol_sz(nof_prb);
+  uint32_t sf_len     = SRSRAN_SF_LEN(fft_size);
+  uint32_t frame_size = 5 * sf_len;
+  uint32_t nof_win    = 2 * NOF_FRAMES;
+  uint32_t pci[3]     = {150, 301, 452};
+  uint32_t delay[3]   = {100, 37 * sf_len / 128, 1500 * sf_len / 1920};
+
+  cf_t* signal = srsran_vec_cf_malloc(nof_win * frame_size);
+  TESTASSERT(signal != NULL);
+  srsran_vec_cf_zero(signal, nof_win * frame_size);
+  for (uint32_t i = 0; i < 3; i++) {
+    TESTASSERT(add_cell(signal, pci[i], delay[i]) == SRSRAN_SUCCESS);
+  }
+  float signal_power = srsran_vec_avg_power_cf(signal, nof_win * frame_size);
+  srsran_ch_awgn_c(signal, signal, signal_power * srsran_convert_dB_to_power(-snr_dB), nof_win * frame_size);
+
+  srsran_pss_sss_batch_t batch = {};
+  TESTASSERT(srsran_pss_sss_batch_init(&batch, frame_size, fft_size) == SRSRAN_SUCCESS);
+  srsran_pss_sss_batch_set_ema_alpha(&batch, 1.0f);
+  srsran_pss_sss_batch_set_threshold(&batch, 2.0f);
+
+  // Every cell is found in every window
+  srsran_pss_sss_batch_res_t res[SRSRAN_NOF_NID_2] = {};
+  for (uint32_t w = 0; w < nof_win; w++) {
+    TESTASSERT(srsran_pss_sss_batch_run(&batch, signal, w * frame_size, res) == SRSRAN_SUCCESS);
+    for (uint32_t i = 0; i < 3; i++) {
+      srsran_pss_sss_batch_res_t* r = &res[pci[i] % SRSRAN_NOF_NID_2];
+      printf("win=%d, pci=%d, peak_pos=%d, psr=%.1f, sss=%s, N_id_1=%d, sf_idx=%d\n",
+             w,
+             pci[i],
+             r->peak_pos,
+             r->peak_value,
+             r->sss_detected ? "yes" : "no",
+             r->N_id_1,
+             r->sf_idx);
+      TESTASSERT(r->pss_found);
+      TESTASSERT(r->peak_pos == delay[i] + sf_len / 2);
+      TESTASSERT(r->sss_detected);
+      TESTASSERT(r->N_id_1 == pci[i] / SRSRAN_NOF_NID_2);
+      TESTASSERT(r->sf_idx == 5 * (w % 2));
+      TESTASSERT(r->frame_type == SRSRAN_FDD);
+    }
+  }
+
+  // Compare the cost of one window against three sequential srsran_sync_find() calls
+  srsran_sync_t sync = {};
+  TESTASSERT(srsran_sync_init(&sync, nof_win * frame_size, frame_size, fft_size) == SRSRAN_SUCCESS);
+  srsran_sync_set_sss_algorithm(&sync, SSS_FULL);
+  srsran_sync_set_cfo_cp_enable(&sync, false, 0);
+  srsran_sync_cp_en(&sync, false);
+  srsran_sync_set_threshold(&sync, 2.0f);
+
+  struct timeval t[3];
+  gettimeofday(&t[1], NULL);
+  for (uint32_t n = 0; n < NOF_REPETITIONS; n++) {
+    srsran_pss_sss_batch_run(&batch, signal, frame_size, res);
+  }
+  gettimeofday(&t[2], NULL);
+  double batch_us = elapsed_us(t) / NOF_REPETITIONS;
+
+  uint32_t peak_pos = 0;
+  gettimeofday(&t[1], NULL);
+  for (uint32_t n = 0; n < NOF_REPETITIONS; n++) {
+    for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2; N_id_2++) {
+      srsran_sync_set_N_id_2(&sync, N_id_2);
+      srsran_sync_find(&sync, signal, frame_size, &peak_pos);
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  double sequential_us = elapsed_us(t) / NOF_REPETITIONS;
+
+  printf("nof_prb=%d; batch=%.1f us; sequential=%.1f us\n", nof_prb, batch_us, sequential_us);
+
+  srsran_sync_free(&sync);
+  srsran_pss_sss_batch_free(&batch);
+  free(signal);
+
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
@@ -295,6 +295,64 @@ static int test_case_false(srsran_ssb_t* ssb)
   return SRSRAN_SUCCESS;
 }
 
+static int test_case_multiple(srsran_ssb_t* ssb)
+{
+  // SSB configuration
+  srsran_ssb_cfg_t ssb_cfg = {};
+  ssb_cfg.srate_hz         = srate_hz;
+  ssb_cfg.center_freq_hz   = carrier_freq_hz;
+  ssb_cfg.ssb_freq_hz      = ssb_freq_hz;
+  ssb_cfg.scs              = ssb_scs;
+  ssb_cfg.pattern          = ssb_pattern;
+
+  TESTASSERT(srsran_ssb_set_cfg(ssb, &ssb_cfg) == SRSRAN_SUCCESS);
+
+  // Two beams of a cell and one beam of another cell with a different N_id_2
+  const uint32_t       nof_tx          = 3;
+  uint32_t             pci[3]          = {1, 1, 500};
+  uint32_t             ssb_idx[3]      = {0, 2, 1};
+  srsran_pbch_msg_nr_t pbch_msg_tx[3]  = {};
+  struct timeval       t[3]            = {};
+  uint64_t             t_search_usec   = 0;
+  uint32_t             nof_found_tx[3] = {};
+
+  srsran_vec_cf_zero(buffer, hf_len);
+  for (uint32_t i = 0; i < nof_tx; i++) {
+    gen_pbch_msg(&pbch_msg_tx[i], ssb_idx[i]);
+    TESTASSERT(srsran_ssb_add(ssb, pci[i], &pbch_msg_tx[i], buffer, buffer) == SRSRAN_SUCCESS);
+  }
+
+  run_channel();
+
+  srsran_ssb_search_res_t res[SRSRAN_SSB_SEARCH_MAX_CANDIDATES] = {};
+  gettimeofday(&t[1], NULL);
+  int nof_res = srsran_ssb_search_all(ssb, buffer, hf_len, res, SRSRAN_SSB_SEARCH_MAX_CANDIDATES);
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  t_search_usec += t[0].tv_usec + t[0].tv_sec * 1000000UL;
+  TESTASSERT(nof_res == (int)nof_tx);
+
+  // Every transmitted SSB is found once
+  for (int r = 0; r < nof_res; r++) {
+    char str[512] = {};
+    srsran_pbch_msg_info(&res[r].pbch_msg, str, sizeof(str));
+    INFO("test_case_multiple - found pci=%d %s crc=%s", res[r].N_id, str, res[r].pbch_msg.crc ? "OK" : "KO");
+
+    for (uint32_t i = 0; i < nof_tx; i++) {
+      if (res[r].N_id == pci[i] && memcmp(&res[r].pbch_msg, &pbch_msg_tx[i], sizeof(srsran_pbch_msg_nr_t)) == 0) {
+        nof_found_tx[i]++;
+      }
+    }
+  }
+  for (uint32_t i = 0; i < nof_tx; i++) {
+    TESTASSERT(nof_found_tx[i] == 1);
+  }
+
+  INFO("test_case_multiple - %.1f usec/search;", (double)t_search_usec);
+
+  return SRSRAN_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
   int ret = SRSRAN_ERROR;
@@ -341,6 +399,11 @@ int main(int argc, char** argv)
     goto clean_exit;
   }
 
+  if (test_case_multiple(&ssb) != SRSRAN_SUCCESS) {
+    ERROR("test case failed");
+    goto clean_exit;
+  }
+
   ret = SRSRAN_SUCCESS;
 
 clean_exit:
@@ -265,6 +265,21 @@ void srsran_ue_dl_set_mi_auto(srsran_ue_dl_t* q)
   q->mi_auto = true;
 }
 
+void srsran_ue_dl_set_cfo(srsran_ue_dl_t* q, float cfo, float phase)
+{
+  for (uint32_t i = 0; i < q->nof_rx_antennas; i++) {
+    srsran_ofdm_rx_set_cfo(&q->fft[i], cfo, phase);
+  }
+  srsran_ofdm_rx_set_cfo(&q->fft_mbsfn, cfo, phase);
+}
+
+void srsran_ue_dl_set_time_offset(srsran_ue_dl_t* q, float time_offset)
+{
+  for (uint32_t i = 0; i < q->nof_rx_antennas; i++) {
+    srsran_ofdm_rx_set_time_offset(&q->fft[i], time_offset);
+  }
+}
+
 void srsran_ue_dl_set_mi_manual(srsran_ue_dl_t* q, uint32_t mi_idx)
 {
   q->mi_auto         = false;
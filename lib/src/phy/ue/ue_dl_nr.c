@@ -81,7 +81,12 @@ int srsran_ue_dl_nr_init(srsran_ue_dl_nr_t* q, cf_t* input[SRSRAN_MAX_PORTS], co
     q->pdcch_dmrs_epre_thr = UE_DL_NR_PDCCH_EPRE_DEFAULT_THR;
   }
 
-  if (srsran_pdsch_nr_init_ue(&q->pdsch, &args->pdsch) < SRSRAN_SUCCESS) {
+  srsran_pdsch_nr_args_t pdsch_args = args->pdsch;
+  if (pdsch_args.nof_rx_ant == 0) {
+    pdsch_args.nof_rx_ant = q->nof_rx_antennas;
+  }
+
+  if (srsran_pdsch_nr_init_ue(&q->pdsch, &pdsch_args) < SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
 
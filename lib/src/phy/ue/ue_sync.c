@@ -119,6 +119,7 @@ void srsran_ue_sync_cfo_reset(srsran_ue_sync_t* q, float init_cfo_hz)
 {
   q->cfo_is_copied     = false;
   q->cfo_current_value = init_cfo_hz / 15e3f;
+  q->cfo_phase         = 0.0f;
   srsran_sync_cfo_reset(&q->strack, init_cfo_hz);
   srsran_sync_cfo_reset(&q->sfind, init_cfo_hz);
 }
@@ -137,6 +138,7 @@ void srsran_ue_sync_reset(srsran_ue_sync_t* q)
   q->frame_no_cnt          = 0;
   q->frame_total_cnt       = 0;
   q->mean_sample_offset    = 0.0;
+  q->sf_time_offset        = 0.0f;
   q->next_rf_sample_offset = 0;
   q->frame_find_cnt        = 0;
 }
@@ -504,6 +506,21 @@ void srsran_ue_sync_set_cfo_i_enable(srsran_ue_sync_t* q, bool enable)
   srsran_sync_set_cfo_i_enable(&q->sfind, enable);
 }
 
+void srsran_ue_sync_set_cfo_correct_deferred(srsran_ue_sync_t* q, bool enable)
+{
+  q->cfo_correct_deferred = enable;
+}
+
+void srsran_ue_sync_get_sf_cfo(srsran_ue_sync_t* q, float* cfo, float* phase)
+{
+  if (cfo) {
+    *cfo = q->cfo_sf_value;
+  }
+  if (phase) {
+    *phase = q->cfo_sf_phase;
+  }
+}
+
 float srsran_ue_sync_get_cfo(srsran_ue_sync_t* q)
 {
   return 15000 * q->cfo_current_value;
@@ -540,6 +557,11 @@ int srsran_ue_sync_get_last_sample_offset(srsran_ue_sync_t* q)
   return q->last_sample_offset;
 }
 
+float srsran_ue_sync_get_sf_time_offset(srsran_ue_sync_t* q)
+{
+  return q->sf_time_offset;
+}
+
 void srsran_ue_sync_set_sfo_correct_period(srsran_ue_sync_t* q, uint32_t nof_subframes)
 {
   q->sample_offset_correct_period = nof_subframes;
@@ -602,6 +624,7 @@ static int find_peak_ok(srsran_ue_sync_t* q, cf_t* input_buffer[SRSRAN_MAX_CHANN
     q->frame_total_cnt    = 0;
     q->frame_find_cnt     = 0;
     q->mean_sample_offset = 0;
+    q->sf_time_offset     = 0.0f;
 
     /* Goto Tracking state if cell ID is known already */
     if (q->cell.id < 1000) {
@@ -635,6 +658,7 @@ static int track_peak_ok(srsran_ue_sync_t* q, uint32_t track_idx)
   } else {
     q->mean_sample_offset = q->last_sample_offset;
   }
+  q->sf_time_offset = q->mean_sample_offset;
 
   /* Adjust current CFO estimation with PSS
    * Since sync track has enabled only PSS-based correlation, get_cfo() returns that value only, already filtered.
@@ -657,6 +681,7 @@ static int track_peak_ok(srsran_ue_sync_t* q, uint32_t track_idx)
   if (!frame_idx) {
     // Adjust RF sampling time based on the mean sampling offset
     q->next_rf_sample_offset = (int)round(q->mean_sample_offset);
+    q->sf_time_offset        = q->mean_sample_offset - (float)q->next_rf_sample_offset;
 
     if (q->next_rf_sample_offset) {
       INFO("Time offset adjustment: %d samples (%.2f), mean SFO: %.2f Hz, ema=%f, length=%d",
@@ -729,6 +754,31 @@ static int receive_samples(srsran_ue_sync_t* q, cf_t* input_buffer[SRSRAN_MAX_CH
   return SRSRAN_SUCCESS;
 }
 
+/* Corrects the CFO of the frame in place. If the correction is deferred, only the subframes used for PSS tracking are
+ * corrected and the correction of the rest is left to the OFDM demodulator. In both cases the phase of the correction
+ * is carried over to the next frame.
+ */
+static void ue_sync_track_cfo_correct(srsran_ue_sync_t* q, cf_t* input_buffer[SRSRAN_MAX_CHANNELS])
+{
+  float cfo = -q->cfo_current_value / q->fft_size;
+
+  bool track_sf = (q->sfind.frame_type == SRSRAN_FDD && (q->sf_idx == 0 || q->sf_idx == 5)) ||
+                  (q->sfind.frame_type == SRSRAN_TDD && (q->sf_idx == 1 || q->sf_idx == 6));
+
+  if (!q->cfo_correct_deferred || q->nof_recv_sf != 1 || track_sf) {
+    for (int i = 0; i < q->nof_rx_antennas; i++) {
+      if (input_buffer[i]) {
+        srsran_vec_apply_cfo_phase(input_buffer[i], cfo, q->cfo_phase, input_buffer[i], q->frame_len);
+      }
+    }
+  } else {
+    q->cfo_sf_value = q->cfo_current_value;
+    q->cfo_sf_phase = q->cfo_phase;
+  }
+
+  q->cfo_phase = (float)fmod((double)q->cfo_phase + 2.0 * M_PI * (double)cfo * (double)q->frame_len, 2.0 * M_PI);
+}
+
 /* Returns 1 if the subframe is synchronized in time, 0 otherwise */
 int srsran_ue_sync_zerocopy(srsran_ue_sync_t* q,
                             cf_t*             input_buffer[SRSRAN_MAX_CHANNELS],
@@ -737,6 +787,8 @@ int srsran_ue_sync_zerocopy(srsran_ue_sync_t* q,
   int ret = SRSRAN_ERROR_INVALID_INPUTS;
 
   if (q != NULL && input_buffer != NULL) {
+    q->cfo_sf_value = 0.0f;
+
     if (q->file_mode) {
       int n = srsran_filesource_read_multi(&q->file_source, (void**)input_buffer, q->sf_len, q->nof_rx_antennas);
       if (n < 0) {
@@ -807,14 +859,9 @@ int srsran_ue_sync_zerocopy(srsran_ue_sync_t* q,
             q->frame_number = (q->frame_number + 1) % 1024;
           }
 
-          // Correct CFO before PSS/SSS tracking using the sync object corrector (initialized for 1 ms)
+          // Correct CFO before PSS/SSS tracking, keeping the phase continuous between frames
           if (q->cfo_correct_enable_track) {
-            for (int i = 0; i < q->nof_rx_antennas; i++) {
-              if (input_buffer[i]) {
-                srsran_cfo_correct(
-                    &q->strack.cfo_corr_frame, input_buffer[i], input_buffer[i], -q->cfo_current_value / q->fft_size);
-              }
-            }
+            ue_sync_track_cfo_correct(q, input_buffer);
           }
 
           if (q->mode == SYNC_MODE_PSS) {
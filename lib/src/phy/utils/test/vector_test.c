@@ -28,6 +28,25 @@ bool verbose     = false;
 
 static uint32_t nof_repetitions = 1;
 
+// Instruction set the kernels are compiled for, it tags the benchmark results
+#ifdef LV_HAVE_AVX512
+#define SIMD_ISA "avx512"
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+#define SIMD_ISA "avx2"
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+#define SIMD_ISA "sse"
+#else /* LV_HAVE_SSE */
+#ifdef HAVE_NEON
+#define SIMD_ISA "neon"
+#else /* HAVE_NEON */
+#define SIMD_ISA "generic"
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+
 #define MAX_MSE (1e-3)
 #define MAX_FUNCTIONS (64)
 #define MAX_BLOCKS (16)
@@ -338,6 +357,42 @@ TEST(
     free(x);
     free(y);)
 
+TEST(
+    srsran_vec_dot_prod_cfc, MALLOC(cf_t, x); MALLOC(float, y); cf_t z = 0.0f;
+
+    cf_t gold = 0.0f;
+    for (int i = 0; i < block_size; i++) {
+      x[i] = RANDOM_CF();
+      y[i] = RANDOM_F();
+    }
+
+    TEST_CALL(z = srsran_vec_dot_prod_cfc(x, y, block_size))
+
+        for (int i = 0; i < block_size; i++) { gold += x[i] * y[i]; }
+
+    mse = cabsf(gold - z) / cabsf(gold);
+
+    free(x);
+    free(y);)
+
+TEST(
+    srsran_vec_dot_prod_fff, MALLOC(float, x); MALLOC(float, y); float z = 0.0f;
+
+    float gold = 0.0f;
+    for (int i = 0; i < block_size; i++) {
+      x[i] = RANDOM_F();
+      y[i] = RANDOM_F();
+    }
+
+    TEST_CALL(z = srsran_vec_dot_prod_fff(x, y, block_size))
+
+        for (int i = 0; i < block_size; i++) { gold += x[i] * y[i]; }
+
+    mse = fabsf(gold - z) / fabsf(gold);
+
+    free(x);
+    free(y);)
+
 TEST(
     srsran_vec_dot_prod_conj_ccc, MALLOC(cf_t, x); MALLOC(cf_t, y); cf_t z = 0.0f;
 
@@ -684,6 +739,41 @@ TEST(
     free(y);
     free(z);)
 
+TEST(
+    srsran_vec_convert_fb, MALLOC(float, x); MALLOC(int8_t, z); float scale = 100.0f;
+
+    int8_t gold;
+    for (int i = 0; i < block_size; i++) { x[i] = RANDOM_F(); }
+
+    TEST_CALL(srsran_vec_convert_fb(x, scale, z, block_size))
+
+        for (int i = 0; i < block_size; i++) {
+          gold = (int8_t)(x[i] * scale);
+          mse += abs(gold - z[i]);
+        }
+
+    free(x);
+    free(z);)
+
+TEST(
+    srsran_vec_interleave, MALLOC(cf_t, x); MALLOC(cf_t, y); cf_t* z = srsran_vec_cf_malloc(2 * block_size);
+
+    for (int i = 0; i < block_size; i++) {
+      x[i] = RANDOM_CF();
+      y[i] = RANDOM_CF();
+    }
+
+    TEST_CALL(srsran_vec_interleave(x, y, z, block_size))
+
+        for (int i = 0; i < block_size; i++) {
+          mse += cabsf(x[i] - z[2 * i]);
+          mse += cabsf(y[i] - z[2 * i + 1]);
+        }
+
+    free(x);
+    free(y);
+    free(z);)
+
 TEST(
     srsran_vec_conj_cc, MALLOC(cf_t, x); MALLOC(cf_t, z);
 
@@ -776,6 +866,24 @@ TEST(
     free(x);
     free(z);)
 
+TEST(
+    srsran_vec_apply_cfo_phase, MALLOC(cf_t, x); MALLOC(cf_t, z);
+
+    const float cfo   = 0.1f;
+    const float phase = 1.0f;
+    cf_t        gold;
+    for (int i = 0; i < block_size; i++) { x[i] = RANDOM_CF(); }
+
+    TEST_CALL(srsran_vec_apply_cfo_phase(x, cfo, phase, z, block_size))
+
+        for (int i = 0; i < block_size; i++) {
+          gold = x[i] * cexpf(_Complex_I * (phase + 2.0f * (float)M_PI * i * cfo));
+          mse += cabsf(gold - z[i]) / cabsf(gold);
+        } mse /= block_size;
+
+    free(x);
+    free(z);)
+
 TEST(
     srsran_vec_gen_sine, MALLOC(cf_t, z);
 
@@ -947,6 +1055,14 @@ int main(int argc, char** argv)
         test_srsran_vec_dot_prod_ccc(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
 
+    passed[func_count][size_count] =
+        test_srsran_vec_dot_prod_cfc(func_names[func_count], &timmings[func_count][size_count], block_size);
+    func_count++;
+
+    passed[func_count][size_count] =
+        test_srsran_vec_dot_prod_fff(func_names[func_count], &timmings[func_count][size_count], block_size);
+    func_count++;
+
     passed[func_count][size_count] =
         test_srsran_vec_dot_prod_conj_ccc(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
@@ -1019,6 +1135,14 @@ int main(int argc, char** argv)
         test_srsran_vec_div_fff(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
 
+    passed[func_count][size_count] =
+        test_srsran_vec_convert_fb(func_names[func_count], &timmings[func_count][size_count], block_size);
+    func_count++;
+
+    passed[func_count][size_count] =
+        test_srsran_vec_interleave(func_names[func_count], &timmings[func_count][size_count], block_size);
+    func_count++;
+
     passed[func_count][size_count] =
         test_srsran_vec_conj_cc(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
@@ -1039,6 +1163,10 @@ int main(int argc, char** argv)
         test_srsran_vec_apply_cfo(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
 
+    passed[func_count][size_count] =
+        test_srsran_vec_apply_cfo_phase(func_names[func_count], &timmings[func_count][size_count], block_size);
+    func_count++;
+
     passed[func_count][size_count] =
         test_srsran_vec_gen_sine(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
@@ -1063,12 +1191,12 @@ int main(int argc, char** argv)
     size_count++;
   }
 
-  char  fname[69];
+  char  fname[80];
   FILE* f = NULL;
   void* p = popen("(date +%g%m%d && hostname) | tr '\\r\\n' '__'", "r");
   if (p) {
     fgets(fname, 64, p);
-    strncpy(fname + strnlen(fname, 64) - 1, ".tsv", 5);
+    strncpy(fname + strnlen(fname, 64), SIMD_ISA ".tsv", 12);
     f = fopen(fname, "w");
     if (f) {
       printf("Saving benchmark results in '%s'\n", fname);
@@ -1077,9 +1205,9 @@ int main(int argc, char** argv)
   }
 
   printf("\n");
-  printf("%32s |", "Subroutine/MSps");
+  printf("%32s |", "Subroutine/MSps (" SIMD_ISA ")");
   if (f)
-    fprintf(f, "Subroutine/MSps Vs Vector size\t");
+    fprintf(f, "Subroutine/MSps (" SIMD_ISA ") Vs Vector size\t");
   for (int i = 0; i < size_count; i++) {
     printf(" %7d", sizes[i]);
     if (f)
@@ -464,11 +464,7 @@ void srsran_vec_load_file(char* filename, void* buffer, const uint32_t len)
 // Used in PSS
 void srsran_vec_conj_cc(const cf_t* x, cf_t* y, const uint32_t len)
 {
-  /* This function is used in initialisation only, then no optimisation is required */
-  int i;
-  for (i = 0; i < len; i++) {
-    y[i] = conjf(x[i]);
-  }
+  srsran_vec_conj_cc_simd(x, y, len);
 }
 
 // Used in scrambling complex
@@ -557,12 +553,7 @@ cf_t srsran_vec_dot_prod_ccc(const cf_t* x, const cf_t* y, const uint32_t len)
 // Convolution filter and in SSS search
 cf_t srsran_vec_dot_prod_cfc(const cf_t* x, const float* y, const uint32_t len)
 {
-  uint32_t i;
-  cf_t     res = 0;
-  for (i = 0; i < len; i++) {
-    res += x[i] * y[i];
-  }
-  return res;
+  return srsran_vec_dot_prod_cfc_simd(x, y, len);
 }
 
 // SYNC
@@ -574,12 +565,7 @@ cf_t srsran_vec_dot_prod_conj_ccc(const cf_t* x, const cf_t* y, const uint32_t l
 // PHICH
 float srsran_vec_dot_prod_fff(const float* x, const float* y, const uint32_t len)
 {
-  uint32_t i;
-  float    res = 0;
-  for (i = 0; i < len; i++) {
-    res += x[i] * y[i];
-  }
-  return res;
+  return srsran_vec_dot_prod_fff_simd(x, y, len);
 }
 
 int32_t srsran_vec_dot_prod_sss(const int16_t* x, const int16_t* y, const uint32_t len)
@@ -857,6 +843,11 @@ void srsran_vec_apply_cfo(const cf_t* x, float cfo, cf_t* z, int len)
   srsran_vec_apply_cfo_simd(x, cfo, z, len);
 }
 
+void srsran_vec_apply_cfo_phase(const cf_t* x, float cfo, float phase, cf_t* z, int len)
+{
+  srsran_vec_apply_cfo_phase_simd(x, cfo, phase, z, len);
+}
+
 float srsran_vec_estimate_frequency(const cf_t* x, int len)
 {
   return srsran_vec_estimate_frequency_simd(x, len);
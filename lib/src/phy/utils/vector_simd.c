@@ -29,6 +29,38 @@
 
 #include "srsran/phy/utils/simd.h"
 #include "srsran/phy/utils/vector_simd.h"
+#include "vector_simd_kernels.h"
+
+#ifdef SRSRAN_SIMD_DISPATCH
+
+static const srsran_vec_simd_table_t  vec_simd_table_baseline = SRSRAN_VEC_SIMD_TABLE_INIT;
+static const srsran_vec_simd_table_t* vec_simd_table          = &vec_simd_table_baseline;
+
+__attribute__((constructor)) static void srsran_vec_simd_dispatch_init()
+{
+  __builtin_cpu_init();
+#ifdef SRSRAN_SIMD_DISPATCH_AVX512
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512dq")) {
+    vec_simd_table = &srsran_vec_simd_table_avx512;
+    return;
+  }
+#endif /* SRSRAN_SIMD_DISPATCH_AVX512 */
+#ifdef SRSRAN_SIMD_DISPATCH_AVX2
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    vec_simd_table = &srsran_vec_simd_table_avx2;
+    return;
+  }
+#endif /* SRSRAN_SIMD_DISPATCH_AVX2 */
+}
+
+#define SRSRAN_VEC_SIMD_DISPATCH(NAME) vec_simd_table->NAME
+
+#else /* SRSRAN_SIMD_DISPATCH */
+
+#define SRSRAN_VEC_SIMD_DISPATCH(NAME) srsran_vec_##NAME##_simd_kernel
+
+#endif /* SRSRAN_SIMD_DISPATCH */
 
 void srsran_vec_xor_bbb_simd(const uint8_t* x, const uint8_t* y, uint8_t* z, const int len)
 {
@@ -407,26 +439,30 @@ void srsran_vec_convert_if_simd(const int16_t* x, float* z, const float scale, c
   int         i    = 0;
   const float gain = 1.0f / scale;
 
-#ifdef LV_HAVE_SSE
-  __m128 s = _mm_set1_ps(gain);
-  if (SRSRAN_IS_ALIGNED(z)) {
-    for (; i < len - 3; i += 4) {
-      __m64* ptr = (__m64*)&x[i];
-      __m128 fl  = _mm_cvtpi16_ps(*ptr);
-      __m128 v   = _mm_mul_ps(fl, s);
+#if SRSRAN_SIMD_F_SIZE && SRSRAN_SIMD_S_SIZE
+  simd_f_t s = srsran_simd_f_set1(gain);
+  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(z)) {
+    for (; i < len - SRSRAN_SIMD_S_SIZE + 1; i += SRSRAN_SIMD_S_SIZE) {
+      simd_s_t a = srsran_simd_s_load(&x[i]);
 
-      _mm_store_ps(&z[i], v);
+      simd_f_t fa, fb;
+      srsran_simd_convert_s_2f(a, &fa, &fb);
+
+      srsran_simd_f_store(&z[i], srsran_simd_f_mul(fa, s));
+      srsran_simd_f_store(&z[i + SRSRAN_SIMD_F_SIZE], srsran_simd_f_mul(fb, s));
     }
   } else {
-    for (; i < len - 3; i += 4) {
-      __m64* ptr = (__m64*)&x[i];
-      __m128 fl  = _mm_cvtpi16_ps(*ptr);
-      __m128 v   = _mm_mul_ps(fl, s);
+    for (; i < len - SRSRAN_SIMD_S_SIZE + 1; i += SRSRAN_SIMD_S_SIZE) {
+      simd_s_t a = srsran_simd_s_loadu(&x[i]);
+
+      simd_f_t fa, fb;
+      srsran_simd_convert_s_2f(a, &fa, &fb);
 
-      _mm_storeu_ps(&z[i], v);
+      srsran_simd_f_storeu(&z[i], srsran_simd_f_mul(fa, s));
+      srsran_simd_f_storeu(&z[i + SRSRAN_SIMD_F_SIZE], srsran_simd_f_mul(fb, s));
     }
   }
-#endif /* LV_HAVE_SSE */
+#endif /* SRSRAN_SIMD_F_SIZE && SRSRAN_SIMD_S_SIZE */
 
   for (; i < len; i++) {
     z[i] = ((float)x[i]) * gain;
@@ -555,10 +591,10 @@ void srsran_vec_convert_fb_simd(const float* x, int8_t* z, const float scale, co
     }
   } else {
     for (; i < len - 16 + 1; i += 16) {
-      __m128 a = _mm_load_ps(&x[i]);
-      __m128 b = _mm_load_ps(&x[i + 1 * 4]);
-      __m128 c = _mm_load_ps(&x[i + 2 * 4]);
-      __m128 d = _mm_load_ps(&x[i + 3 * 4]);
+      __m128 a = _mm_loadu_ps(&x[i]);
+      __m128 b = _mm_loadu_ps(&x[i + 1 * 4]);
+      __m128 c = _mm_loadu_ps(&x[i + 2 * 4]);
+      __m128 d = _mm_loadu_ps(&x[i + 3 * 4]);
 
       __m128 sa = _mm_mul_ps(a, s);
       __m128 sb = _mm_mul_ps(b, s);
@@ -580,7 +616,18 @@ void srsran_vec_convert_fb_simd(const float* x, int8_t* z, const float scale, co
 #endif
 
 #ifdef HAVE_NEON
-#pragma message "srsran_vec_convert_fb_simd not implemented in neon"
+  float32x4_t s = vdupq_n_f32(scale);
+  for (; i < len - 16 + 1; i += 16) {
+    int32x4_t ai = vcvtq_s32_f32(vmulq_f32(vld1q_f32(&x[i]), s));
+    int32x4_t bi = vcvtq_s32_f32(vmulq_f32(vld1q_f32(&x[i + 1 * 4]), s));
+    int32x4_t ci = vcvtq_s32_f32(vmulq_f32(vld1q_f32(&x[i + 2 * 4]), s));
+    int32x4_t di = vcvtq_s32_f32(vmulq_f32(vld1q_f32(&x[i + 3 * 4]), s));
+
+    int16x8_t ab = vcombine_s16(vqmovn_s32(ai), vqmovn_s32(bi));
+    int16x8_t cd = vcombine_s16(vqmovn_s32(ci), vqmovn_s32(di));
+
+    vst1q_s8(&z[i], vcombine_s8(vqmovn_s16(ab), vqmovn_s16(cd)));
+  }
 #endif /* HAVE_NEON */
 
   for (; i < len; i++) {
@@ -661,33 +708,7 @@ cf_t srsran_vec_acc_cc_simd(const cf_t* x, const int len)
 
 void srsran_vec_add_fff_simd(const float* x, const float* y, float* z, const int len)
 {
-  int i = 0;
-
-#if SRSRAN_SIMD_F_SIZE
-  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y) && SRSRAN_IS_ALIGNED(z)) {
-    for (; i < len - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
-      simd_f_t a = srsran_simd_f_load(&x[i]);
-      simd_f_t b = srsran_simd_f_load(&y[i]);
-
-      simd_f_t r = srsran_simd_f_add(a, b);
-
-      srsran_simd_f_store(&z[i], r);
-    }
-  } else {
-    for (; i < len - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
-      simd_f_t a = srsran_simd_f_loadu(&x[i]);
-      simd_f_t b = srsran_simd_f_loadu(&y[i]);
-
-      simd_f_t r = srsran_simd_f_add(a, b);
-
-      srsran_simd_f_storeu(&z[i], r);
-    }
-  }
-#endif
-
-  for (; i < len; i++) {
-    z[i] = x[i] + y[i];
-  }
+  SRSRAN_VEC_SIMD_DISPATCH(add_fff)(x, y, z, len);
 }
 
 void srsran_vec_sub_fff_simd(const float* x, const float* y, float* z, const int len)
@@ -753,47 +774,7 @@ void srsran_vec_sc_sum_fff_simd(const float* x, float h, float* z, int len)
 
 cf_t srsran_vec_dot_prod_ccc_simd(const cf_t* x, const cf_t* y, const int len)
 {
-  int  i      = 0;
-  cf_t result = 0;
-
-#if SRSRAN_SIMD_CF_SIZE
-  if (len >= SRSRAN_SIMD_CF_SIZE) {
-    simd_cf_t avx_result = srsran_simd_cf_zero();
-    if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y)) {
-      for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
-        simd_cf_t xVal = srsran_simd_cfi_load(&x[i]);
-        simd_cf_t yVal = srsran_simd_cfi_load(&y[i]);
-
-        avx_result = srsran_simd_cf_add(srsran_simd_cf_prod(xVal, yVal), avx_result);
-      }
-    } else {
-      for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
-        simd_cf_t xVal = srsran_simd_cfi_loadu(&x[i]);
-        simd_cf_t yVal = srsran_simd_cfi_loadu(&y[i]);
-
-        avx_result = srsran_simd_cf_add(srsran_simd_cf_prod(xVal, yVal), avx_result);
-      }
-    }
-
-    __attribute__((aligned(64))) float simd_dotProdVector[SRSRAN_SIMD_CF_SIZE];
-    simd_f_t                           acc_re = srsran_simd_cf_re(avx_result);
-    simd_f_t                           acc_im = srsran_simd_cf_im(avx_result);
-
-    simd_f_t acc = srsran_simd_f_hadd(acc_re, acc_im);
-    for (int j = 2; j < SRSRAN_SIMD_F_SIZE; j *= 2) {
-      acc = srsran_simd_f_hadd(acc, acc);
-    }
-    srsran_simd_f_store(simd_dotProdVector, acc);
-    __real__ result = simd_dotProdVector[0];
-    __imag__ result = simd_dotProdVector[1];
-  }
-#endif
-
-  for (; i < len; i++) {
-    result += (x[i] * y[i]);
-  }
-
-  return result;
+  return SRSRAN_VEC_SIMD_DISPATCH(dot_prod_ccc)(x, y, len);
 }
 
 #ifdef ENABLE_C16
@@ -828,45 +809,88 @@ c16_t srsran_vec_dot_prod_ccc_c16i_simd(const c16_t* x, const c16_t* y, const in
 #endif /* ENABLE_C16 */
 
 cf_t srsran_vec_dot_prod_conj_ccc_simd(const cf_t* x, const cf_t* y, const int len)
+{
+  return SRSRAN_VEC_SIMD_DISPATCH(dot_prod_conj_ccc)(x, y, len);
+}
+
+cf_t srsran_vec_dot_prod_cfc_simd(const cf_t* x, const float* y, const int len)
 {
   int  i      = 0;
   cf_t result = 0;
 
 #if SRSRAN_SIMD_CF_SIZE
   if (len >= SRSRAN_SIMD_CF_SIZE) {
-    simd_cf_t avx_result = srsran_simd_cf_zero();
+    simd_f_t acc_re = srsran_simd_f_zero();
+    simd_f_t acc_im = srsran_simd_f_zero();
     if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y)) {
       for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
         simd_cf_t xVal = srsran_simd_cfi_load(&x[i]);
-        simd_cf_t yVal = srsran_simd_cfi_load(&y[i]);
+        simd_f_t  yVal = srsran_simd_f_load(&y[i]);
 
-        avx_result = srsran_simd_cf_add(srsran_simd_cf_conjprod(xVal, yVal), avx_result);
+        acc_re = srsran_simd_f_add(srsran_simd_f_mul(srsran_simd_cf_re(xVal), yVal), acc_re);
+        acc_im = srsran_simd_f_add(srsran_simd_f_mul(srsran_simd_cf_im(xVal), yVal), acc_im);
       }
     } else {
       for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
         simd_cf_t xVal = srsran_simd_cfi_loadu(&x[i]);
-        simd_cf_t yVal = srsran_simd_cfi_loadu(&y[i]);
+        simd_f_t  yVal = srsran_simd_f_loadu(&y[i]);
 
-        avx_result = srsran_simd_cf_add(srsran_simd_cf_conjprod(xVal, yVal), avx_result);
+        acc_re = srsran_simd_f_add(srsran_simd_f_mul(srsran_simd_cf_re(xVal), yVal), acc_re);
+        acc_im = srsran_simd_f_add(srsran_simd_f_mul(srsran_simd_cf_im(xVal), yVal), acc_im);
       }
     }
 
-    __attribute__((aligned(64))) float simd_dotProdVector[SRSRAN_SIMD_CF_SIZE];
-    simd_f_t                           acc_re = srsran_simd_cf_re(avx_result);
-    simd_f_t                           acc_im = srsran_simd_cf_im(avx_result);
+    srsran_simd_aligned float re[SRSRAN_SIMD_F_SIZE];
+    srsran_simd_aligned float im[SRSRAN_SIMD_F_SIZE];
+    srsran_simd_f_store(re, acc_re);
+    srsran_simd_f_store(im, acc_im);
+    for (int k = 0; k < SRSRAN_SIMD_F_SIZE; k++) {
+      __real__ result += re[k];
+      __imag__ result += im[k];
+    }
+  }
+#endif
 
-    simd_f_t acc = srsran_simd_f_hadd(acc_re, acc_im);
-    for (int j = 2; j < SRSRAN_SIMD_F_SIZE; j *= 2) {
-      acc = srsran_simd_f_hadd(acc, acc);
+  for (; i < len; i++) {
+    result += x[i] * y[i];
+  }
+
+  return result;
+}
+
+float srsran_vec_dot_prod_fff_simd(const float* x, const float* y, const int len)
+{
+  int   i      = 0;
+  float result = 0.0f;
+
+#if SRSRAN_SIMD_F_SIZE
+  simd_f_t acc = srsran_simd_f_zero();
+
+  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y)) {
+    for (; i < len - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
+      simd_f_t a = srsran_simd_f_load(&x[i]);
+      simd_f_t b = srsran_simd_f_load(&y[i]);
+
+      acc = srsran_simd_f_add(srsran_simd_f_mul(a, b), acc);
+    }
+  } else {
+    for (; i < len - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
+      simd_f_t a = srsran_simd_f_loadu(&x[i]);
+      simd_f_t b = srsran_simd_f_loadu(&y[i]);
+
+      acc = srsran_simd_f_add(srsran_simd_f_mul(a, b), acc);
     }
-    srsran_simd_f_store(simd_dotProdVector, acc);
-    __real__ result = simd_dotProdVector[0];
-    __imag__ result = simd_dotProdVector[1];
+  }
+
+  srsran_simd_aligned float sum[SRSRAN_SIMD_F_SIZE];
+  srsran_simd_f_store(sum, acc);
+  for (int k = 0; k < SRSRAN_SIMD_F_SIZE; k++) {
+    result += sum[k];
   }
 #endif
 
   for (; i < len; i++) {
-    result += x[i] * conjf(y[i]);
+    result += x[i] * y[i];
   }
 
   return result;
@@ -934,33 +958,7 @@ void srsran_vec_prod_fff_simd(const float* x, const float* y, float* z, const in
 
 void srsran_vec_prod_ccc_simd(const cf_t* x, const cf_t* y, cf_t* z, const int len)
 {
-  int i = 0;
-
-#if SRSRAN_SIMD_CF_SIZE
-  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y) && SRSRAN_IS_ALIGNED(z)) {
-    for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
-      simd_cf_t a = srsran_simd_cfi_load(&x[i]);
-      simd_cf_t b = srsran_simd_cfi_load(&y[i]);
-
-      simd_cf_t r = srsran_simd_cf_prod(a, b);
-
-      srsran_simd_cfi_store(&z[i], r);
-    }
-  } else {
-    for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
-      simd_cf_t a = srsran_simd_cfi_loadu(&x[i]);
-      simd_cf_t b = srsran_simd_cfi_loadu(&y[i]);
-
-      simd_cf_t r = srsran_simd_cf_prod(a, b);
-
-      srsran_simd_cfi_storeu(&z[i], r);
-    }
-  }
-#endif
-
-  for (; i < len; i++) {
-    z[i] = x[i] * y[i];
-  }
+  SRSRAN_VEC_SIMD_DISPATCH(prod_ccc)(x, y, z, len);
 }
 
 void srsran_vec_prod_ccc_split_simd(const float* a_re,
@@ -1044,33 +1042,39 @@ void srsran_vec_prod_ccc_c16_simd(const int16_t* a_re,
 #endif /* ENABLE_C16 */
 
 void srsran_vec_prod_conj_ccc_simd(const cf_t* x, const cf_t* y, cf_t* z, const int len)
+{
+  SRSRAN_VEC_SIMD_DISPATCH(prod_conj_ccc)(x, y, z, len);
+}
+
+void srsran_vec_conj_cc_simd(const cf_t* x, cf_t* y, const int len)
 {
   int i = 0;
 
-#if SRSRAN_SIMD_CF_SIZE
-  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y) && SRSRAN_IS_ALIGNED(z)) {
-    for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
-      simd_cf_t a = srsran_simd_cfi_load(&x[i]);
-      simd_cf_t b = srsran_simd_cfi_load(&y[i]);
+#if SRSRAN_SIMD_F_SIZE
+  // Conjugate the interleaved samples in place by flipping the sign of the imaginary parts
+  srsran_simd_aligned float sign_v[SRSRAN_SIMD_F_SIZE];
+  for (uint32_t j = 0; j < SRSRAN_SIMD_F_SIZE; j++) {
+    sign_v[j] = (j % 2 == 0) ? +1.0f : -1.0f;
+  }
+  simd_f_t sign = srsran_simd_f_load(sign_v);
 
-      simd_cf_t r = srsran_simd_cf_conjprod(a, b);
+  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y)) {
+    for (; i < len - SRSRAN_SIMD_F_SIZE / 2 + 1; i += SRSRAN_SIMD_F_SIZE / 2) {
+      simd_f_t a = srsran_simd_f_load((float*)&x[i]);
 
-      srsran_simd_cfi_store(&z[i], r);
+      srsran_simd_f_store((float*)&y[i], srsran_simd_f_mul(a, sign));
     }
   } else {
-    for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
-      simd_cf_t a = srsran_simd_cfi_loadu(&x[i]);
-      simd_cf_t b = srsran_simd_cfi_loadu(&y[i]);
-
-      simd_cf_t r = srsran_simd_cf_conjprod(a, b);
+    for (; i < len - SRSRAN_SIMD_F_SIZE / 2 + 1; i += SRSRAN_SIMD_F_SIZE / 2) {
+      simd_f_t a = srsran_simd_f_loadu((float*)&x[i]);
 
-      srsran_simd_cfi_storeu(&z[i], r);
+      srsran_simd_f_storeu((float*)&y[i], srsran_simd_f_mul(a, sign));
     }
   }
 #endif
 
   for (; i < len; i++) {
-    z[i] = x[i] * conjf(y[i]);
+    y[i] = conjf(x[i]);
   }
 }
 
@@ -1303,70 +1307,12 @@ void srsran_vec_abs_cf_simd(const cf_t* x, float* z, const int len)
 
 void srsran_vec_abs_square_cf_simd(const cf_t* x, float* z, const int len)
 {
-  int i = 0;
-
-#if SRSRAN_SIMD_F_SIZE
-  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(z)) {
-    for (; i < len - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
-      simd_f_t x1 = srsran_simd_f_load((float*)&x[i]);
-      simd_f_t x2 = srsran_simd_f_load((float*)&x[i + SRSRAN_SIMD_F_SIZE / 2]);
-
-      simd_f_t mul1 = srsran_simd_f_mul(x1, x1);
-      simd_f_t mul2 = srsran_simd_f_mul(x2, x2);
-
-      simd_f_t z1 = srsran_simd_f_hadd(mul1, mul2);
-
-      srsran_simd_f_store(&z[i], z1);
-    }
-  } else {
-    for (; i < len - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
-      simd_f_t x1 = srsran_simd_f_loadu((float*)&x[i]);
-      simd_f_t x2 = srsran_simd_f_loadu((float*)&x[i + SRSRAN_SIMD_F_SIZE / 2]);
-
-      simd_f_t mul1 = srsran_simd_f_mul(x1, x1);
-      simd_f_t mul2 = srsran_simd_f_mul(x2, x2);
-
-      simd_f_t z1 = srsran_simd_f_hadd(mul1, mul2);
-
-      srsran_simd_f_storeu(&z[i], z1);
-    }
-  }
-#endif
-
-  for (; i < len; i++) {
-    z[i] = __real__(x[i]) * __real__(x[i]) + __imag__(x[i]) * __imag__(x[i]);
-  }
+  SRSRAN_VEC_SIMD_DISPATCH(abs_square_cf)(x, z, len);
 }
 
 void srsran_vec_sc_prod_cfc_simd(const cf_t* x, const float h, cf_t* z, const int len)
 {
-  int i = 0;
-
-#if SRSRAN_SIMD_F_SIZE
-  const simd_f_t tap = srsran_simd_f_set1(h);
-
-  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(z)) {
-    for (; i < len - SRSRAN_SIMD_F_SIZE / 2 + 1; i += SRSRAN_SIMD_F_SIZE / 2) {
-      simd_f_t temp = srsran_simd_f_load((float*)&x[i]);
-
-      temp = srsran_simd_f_mul(tap, temp);
-
-      srsran_simd_f_store((float*)&z[i], temp);
-    }
-  } else {
-    for (; i < len - SRSRAN_SIMD_F_SIZE / 2 + 1; i += SRSRAN_SIMD_F_SIZE / 2) {
-      simd_f_t temp = srsran_simd_f_loadu((float*)&x[i]);
-
-      temp = srsran_simd_f_mul(tap, temp);
-
-      srsran_simd_f_storeu((float*)&z[i], temp);
-    }
-  }
-#endif
-
-  for (; i < len; i++) {
-    z[i] = x[i] * h;
-  }
+  SRSRAN_VEC_SIMD_DISPATCH(sc_prod_cfc)(x, h, z, len);
 }
 
 void srsran_vec_sc_prod_fcc_simd(const float* x, const cf_t h, cf_t* z, const int len)
@@ -1619,6 +1565,19 @@ void srsran_vec_interleave_simd(const cf_t* x, const cf_t* y, cf_t* z, const int
   }
 #endif /* LV_HAVE_SSE */
 
+#ifdef HAVE_NEON
+  for (; i < len - 2 + 1; i += 2) {
+    float32x4_t a = vld1q_f32((const float*)&x[i]);
+    float32x4_t b = vld1q_f32((const float*)&y[i]);
+
+    vst1q_f32((float*)&z[k], vcombine_f32(vget_low_f32(a), vget_low_f32(b)));
+    k += 2;
+
+    vst1q_f32((float*)&z[k], vcombine_f32(vget_high_f32(a), vget_high_f32(b)));
+    k += 2;
+  }
+#endif /* HAVE_NEON */
+
   for (; i < len; i++) {
     z[k++] = x[i];
     z[k++] = y[i];
@@ -1667,6 +1626,21 @@ void srsran_vec_interleave_add_simd(const cf_t* x, const cf_t* y, cf_t* z, const
   }
 #endif /* LV_HAVE_SSE */
 
+#ifdef HAVE_NEON
+  for (; i < len - 2 + 1; i += 2) {
+    float32x4_t a = vld1q_f32((const float*)&x[i]);
+    float32x4_t b = vld1q_f32((const float*)&y[i]);
+
+    float32x4_t r1 = vaddq_f32(vcombine_f32(vget_low_f32(a), vget_low_f32(b)), vld1q_f32((float*)&z[k]));
+    vst1q_f32((float*)&z[k], r1);
+    k += 2;
+
+    float32x4_t r2 = vaddq_f32(vcombine_f32(vget_high_f32(a), vget_high_f32(b)), vld1q_f32((float*)&z[k]));
+    vst1q_f32((float*)&z[k], r2);
+    k += 2;
+  }
+#endif /* HAVE_NEON */
+
   for (; i < len; i++) {
     z[k++] += x[i];
     z[k++] += y[i];
@@ -1721,20 +1695,27 @@ cf_t srsran_vec_gen_sine_simd(cf_t amplitude, float freq, cf_t* z, int len)
 }
 
 void srsran_vec_apply_cfo_simd(const cf_t* x, float cfo, cf_t* z, int len)
+{
+  srsran_vec_apply_cfo_phase_simd(x, cfo, 0.0f, z, len);
+}
+
+void srsran_vec_apply_cfo_phase_simd(const cf_t* x, float cfo, float initial_phase, cf_t* z, int len)
 {
   const float TWOPI = 2.0f * (float)M_PI;
   int         i     = 0;
   cf_t        osc   = cexpf(_Complex_I * TWOPI * cfo);
-  cf_t        phase = 1.0f;
+  cf_t        phase = cexpf(_Complex_I * initial_phase);
 
 #if SRSRAN_SIMD_CF_SIZE
   // Load initial phases and oscillator
   srsran_simd_aligned cf_t _phase[SRSRAN_SIMD_CF_SIZE];
-  _phase[0] = phase;
+  cf_t                     osc_n = osc;
+  _phase[0]                      = phase;
   for (int k = 1; k < SRSRAN_SIMD_CF_SIZE; k++) {
     _phase[k] = _phase[k - 1] * osc;
+    osc_n *= osc;
   }
-  simd_cf_t _simd_osc   = srsran_simd_cf_set1(_phase[SRSRAN_SIMD_CF_SIZE - 1] * osc);
+  simd_cf_t _simd_osc   = srsran_simd_cf_set1(osc_n);
   simd_cf_t _simd_phase = srsran_simd_cfi_load(_phase);
 
   if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(z)) {
@@ -0,0 +1,33 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/* Built with the AVX512 flags set by lib/src/phy/utils/CMakeLists.txt when ENABLE_SIMD_DISPATCH is set. */
+#ifdef SRSRAN_SIMD_DISPATCH_AVX512
+
+#include "vector_simd_kernels.h"
+
+#ifndef LV_HAVE_AVX512
+#error "LV_HAVE_AVX512 is not enabled for this file"
+#endif /* LV_HAVE_AVX512 */
+
+const srsran_vec_simd_table_t srsran_vec_simd_table_avx512 = SRSRAN_VEC_SIMD_TABLE_INIT;
+
+#endif /* SRSRAN_SIMD_DISPATCH_AVX512 */
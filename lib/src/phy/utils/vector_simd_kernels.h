@@ -0,0 +1,319 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Hot vector kernels that can be selected at runtime.
+ *
+ * The kernels are written with the simd.h primitives, so every translation unit that includes this header compiles
+ * them for the instruction set it is built with. vector_simd.c builds them for the baseline instruction set of the
+ * library. When ENABLE_SIMD_DISPATCH is set, vector_simd_avx2.c and vector_simd_avx512.c build them again for wider
+ * instruction sets, and vector_simd.c selects the widest table supported by the CPU when the library is loaded.
+ */
+
+#ifndef SRSRAN_VECTOR_SIMD_KERNELS_H
+#define SRSRAN_VECTOR_SIMD_KERNELS_H
+
+#include <complex.h>
+
+#include "srsran/config.h"
+#include "srsran/phy/utils/simd.h"
+
+typedef struct {
+  void (*add_fff)(const float* x, const float* y, float* z, const int len);
+  cf_t (*dot_prod_ccc)(const cf_t* x, const cf_t* y, const int len);
+  cf_t (*dot_prod_conj_ccc)(const cf_t* x, const cf_t* y, const int len);
+  void (*prod_ccc)(const cf_t* x, const cf_t* y, cf_t* z, const int len);
+  void (*prod_conj_ccc)(const cf_t* x, const cf_t* y, cf_t* z, const int len);
+  void (*abs_square_cf)(const cf_t* x, float* z, const int len);
+  void (*sc_prod_cfc)(const cf_t* x, const float h, cf_t* z, const int len);
+} srsran_vec_simd_table_t;
+
+#define SRSRAN_VEC_SIMD_TABLE_INIT                                                                                     \
+  {                                                                                                                    \
+    srsran_vec_add_fff_simd_kernel, srsran_vec_dot_prod_ccc_simd_kernel, srsran_vec_dot_prod_conj_ccc_simd_kernel,     \
+        srsran_vec_prod_ccc_simd_kernel, srsran_vec_prod_conj_ccc_simd_kernel, srsran_vec_abs_square_cf_simd_kernel,   \
+        srsran_vec_sc_prod_cfc_simd_kernel                                                                             \
+  }
+
+#if defined(SRSRAN_SIMD_DISPATCH_AVX2) || defined(SRSRAN_SIMD_DISPATCH_AVX512)
+#define SRSRAN_SIMD_DISPATCH
+#endif
+
+#ifdef SRSRAN_SIMD_DISPATCH_AVX2
+extern const srsran_vec_simd_table_t srsran_vec_simd_table_avx2;
+#endif /* SRSRAN_SIMD_DISPATCH_AVX2 */
+
+#ifdef SRSRAN_SIMD_DISPATCH_AVX512
+extern const srsran_vec_simd_table_t srsran_vec_simd_table_avx512;
+#endif /* SRSRAN_SIMD_DISPATCH_AVX512 */
+
+static inline void srsran_vec_add_fff_simd_kernel(const float* x, const float* y, float* z, const int len)
+{
+  int i = 0;
+
+#if SRSRAN_SIMD_F_SIZE
+  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y) && SRSRAN_IS_ALIGNED(z)) {
+    for (; i < len - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
+      simd_f_t a = srsran_simd_f_load(&x[i]);
+      simd_f_t b = srsran_simd_f_load(&y[i]);
+
+      simd_f_t r = srsran_simd_f_add(a, b);
+
+      srsran_simd_f_store(&z[i], r);
+    }
+  } else {
+    for (; i < len - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
+      simd_f_t a = srsran_simd_f_loadu(&x[i]);
+      simd_f_t b = srsran_simd_f_loadu(&y[i]);
+
+      simd_f_t r = srsran_simd_f_add(a, b);
+
+      srsran_simd_f_storeu(&z[i], r);
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    z[i] = x[i] + y[i];
+  }
+}
+
+static inline cf_t srsran_vec_dot_prod_ccc_simd_kernel(const cf_t* x, const cf_t* y, const int len)
+{
+  int  i      = 0;
+  cf_t result = 0;
+
+#if SRSRAN_SIMD_CF_SIZE
+  if (len >= SRSRAN_SIMD_CF_SIZE) {
+    simd_cf_t avx_result = srsran_simd_cf_zero();
+    if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y)) {
+      for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+        simd_cf_t xVal = srsran_simd_cfi_load(&x[i]);
+        simd_cf_t yVal = srsran_simd_cfi_load(&y[i]);
+
+        avx_result = srsran_simd_cf_add(srsran_simd_cf_prod(xVal, yVal), avx_result);
+      }
+    } else {
+      for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+        simd_cf_t xVal = srsran_simd_cfi_loadu(&x[i]);
+        simd_cf_t yVal = srsran_simd_cfi_loadu(&y[i]);
+
+        avx_result = srsran_simd_cf_add(srsran_simd_cf_prod(xVal, yVal), avx_result);
+      }
+    }
+
+    __attribute__((aligned(64))) float simd_dotProdVector[SRSRAN_SIMD_CF_SIZE];
+    simd_f_t                           acc_re = srsran_simd_cf_re(avx_result);
+    simd_f_t                           acc_im = srsran_simd_cf_im(avx_result);
+
+    simd_f_t acc = srsran_simd_f_hadd(acc_re, acc_im);
+    for (int j = 2; j < SRSRAN_SIMD_F_SIZE; j *= 2) {
+      acc = srsran_simd_f_hadd(acc, acc);
+    }
+    srsran_simd_f_store(simd_dotProdVector, acc);
+    __real__ result = simd_dotProdVector[0];
+    __imag__ result = simd_dotProdVector[1];
+  }
+#endif
+
+  for (; i < len; i++) {
+    result += (x[i] * y[i]);
+  }
+
+  return result;
+}
+
+static inline cf_t srsran_vec_dot_prod_conj_ccc_simd_kernel(const cf_t* x, const cf_t* y, const int len)
+{
+  int  i      = 0;
+  cf_t result = 0;
+
+#if SRSRAN_SIMD_CF_SIZE
+  if (len >= SRSRAN_SIMD_CF_SIZE) {
+    simd_cf_t avx_result = srsran_simd_cf_zero();
+    if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y)) {
+      for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+        simd_cf_t xVal = srsran_simd_cfi_load(&x[i]);
+        simd_cf_t yVal = srsran_simd_cfi_load(&y[i]);
+
+        avx_result = srsran_simd_cf_add(srsran_simd_cf_conjprod(xVal, yVal), avx_result);
+      }
+    } else {
+      for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+        simd_cf_t xVal = srsran_simd_cfi_loadu(&x[i]);
+        simd_cf_t yVal = srsran_simd_cfi_loadu(&y[i]);
+
+        avx_result = srsran_simd_cf_add(srsran_simd_cf_conjprod(xVal, yVal), avx_result);
+      }
+    }
+
+    __attribute__((aligned(64))) float simd_dotProdVector[SRSRAN_SIMD_CF_SIZE];
+    simd_f_t                           acc_re = srsran_simd_cf_re(avx_result);
+    simd_f_t                           acc_im = srsran_simd_cf_im(avx_result);
+
+    simd_f_t acc = srsran_simd_f_hadd(acc_re, acc_im);
+    for (int j = 2; j < SRSRAN_SIMD_F_SIZE; j *= 2) {
+      acc = srsran_simd_f_hadd(acc, acc);
+    }
+    srsran_simd_f_store(simd_dotProdVector, acc);
+    __real__ result = simd_dotProdVector[0];
+    __imag__ result = simd_dotProdVector[1];
+  }
+#endif
+
+  for (; i < len; i++) {
+    result += x[i] * conjf(y[i]);
+  }
+
+  return result;
+}
+
+static inline void srsran_vec_prod_ccc_simd_kernel(const cf_t* x, const cf_t* y, cf_t* z, const int len)
+{
+  int i = 0;
+
+#if SRSRAN_SIMD_CF_SIZE
+  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y) && SRSRAN_IS_ALIGNED(z)) {
+    for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+      simd_cf_t a = srsran_simd_cfi_load(&x[i]);
+      simd_cf_t b = srsran_simd_cfi_load(&y[i]);
+
+      simd_cf_t r = srsran_simd_cf_prod(a, b);
+
+      srsran_simd_cfi_store(&z[i], r);
+    }
+  } else {
+    for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+      simd_cf_t a = srsran_simd_cfi_loadu(&x[i]);
+      simd_cf_t b = srsran_simd_cfi_loadu(&y[i]);
+
+      simd_cf_t r = srsran_simd_cf_prod(a, b);
+
+      srsran_simd_cfi_storeu(&z[i], r);
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    z[i] = x[i] * y[i];
+  }
+}
+
+static inline void srsran_vec_prod_conj_ccc_simd_kernel(const cf_t* x, const cf_t* y, cf_t* z, const int len)
+{
+  int i = 0;
+
+#if SRSRAN_SIMD_CF_SIZE
+  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y) && SRSRAN_IS_ALIGNED(z)) {
+    for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+      simd_cf_t a = srsran_simd_cfi_load(&x[i]);
+      simd_cf_t b = srsran_simd_cfi_load(&y[i]);
+
+      simd_cf_t r = srsran_simd_cf_conjprod(a, b);
+
+      srsran_simd_cfi_store(&z[i], r);
+    }
+  } else {
+    for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
+      simd_cf_t a = srsran_simd_cfi_loadu(&x[i]);
+      simd_cf_t b = srsran_simd_cfi_loadu(&y[i]);
+
+      simd_cf_t r = srsran_simd_cf_conjprod(a, b);
+
+      srsran_simd_cfi_storeu(&z[i], r);
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    z[i] = x[i] * conjf(y[i]);
+  }
+}
+
+static inline void srsran_vec_abs_square_cf_simd_kernel(const cf_t* x, float* z, const int len)
+{
+  int i = 0;
+
+#if SRSRAN_SIMD_F_SIZE
+  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(z)) {
+    for (; i < len - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
+      simd_f_t x1 = srsran_simd_f_load((float*)&x[i]);
+      simd_f_t x2 = srsran_simd_f_load((float*)&x[i + SRSRAN_SIMD_F_SIZE / 2]);
+
+      simd_f_t mul1 = srsran_simd_f_mul(x1, x1);
+      simd_f_t mul2 = srsran_simd_f_mul(x2, x2);
+
+      simd_f_t z1 = srsran_simd_f_hadd(mul1, mul2);
+
+      srsran_simd_f_store(&z[i], z1);
+    }
+  } else {
+    for (; i < len - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
+      simd_f_t x1 = srsran_simd_f_loadu((float*)&x[i]);
+      simd_f_t x2 = srsran_simd_f_loadu((float*)&x[i + SRSRAN_SIMD_F_SIZE / 2]);
+
+      simd_f_t mul1 = srsran_simd_f_mul(x1, x1);
+      simd_f_t mul2 = srsran_simd_f_mul(x2, x2);
+
+      simd_f_t z1 = srsran_simd_f_hadd(mul1, mul2);
+
+      srsran_simd_f_storeu(&z[i], z1);
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    z[i] = __real__(x[i]) * __real__(x[i]) + __imag__(x[i]) * __imag__(x[i]);
+  }
+}
+
+static inline void srsran_vec_sc_prod_cfc_simd_kernel(const cf_t* x, const float h, cf_t* z, const int len)
+{
+  int i = 0;
+
+#if SRSRAN_SIMD_F_SIZE
+  const simd_f_t tap = srsran_simd_f_set1(h);
+
+  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(z)) {
+    for (; i < len - SRSRAN_SIMD_F_SIZE / 2 + 1; i += SRSRAN_SIMD_F_SIZE / 2) {
+      simd_f_t temp = srsran_simd_f_load((float*)&x[i]);
+
+      temp = srsran_simd_f_mul(tap, temp);
+
+      srsran_simd_f_store((float*)&z[i], temp);
+    }
+  } else {
+    for (; i < len - SRSRAN_SIMD_F_SIZE / 2 + 1; i += SRSRAN_SIMD_F_SIZE / 2) {
+      simd_f_t temp = srsran_simd_f_loadu((float*)&x[i]);
+
+      temp = srsran_simd_f_mul(tap, temp);
+
+      srsran_simd_f_storeu((float*)&z[i], temp);
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    z[i] = x[i] * h;
+  }
+}
+
+#endif // SRSRAN_VECTOR_SIMD_KERNELS_H
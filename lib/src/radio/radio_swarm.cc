@@ -0,0 +1,559 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/radio/radio_swarm.h"
+#include "srsran/common/standard_streams.h"
+#include "srsran/support/srsran_assert.h"
+#include <algorithm>
+
+namespace srsran {
+
+radio_swarm::radio_swarm() : radio_swarm(std::unique_ptr<radio>(new radio)) {}
+
+radio_swarm::~radio_swarm()
+{
+  stop();
+}
+
+int radio_swarm::init(const rf_args_t& args_)
+{
+  args = args_;
+
+  if (not std::isnormal(args.srate_hz)) {
+    srsran::console("Error: sharing the radio between several UEs requires a fixed RF sampling rate.\n");
+    return SRSRAN_ERROR;
+  }
+
+  if (rf_base->init(args, this) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  // The radio always runs at the fixed rate, each port resamples on its own
+  srate_hz     = args.srate_hz;
+  nof_channels = args.nof_carriers * args.nof_antennas;
+  block_len    = (uint32_t)round(srate_hz / 1000.0);
+  rf->set_rx_srate(srate_hz);
+  rf->set_tx_srate(srate_hz);
+
+  // Every block is either free or held by the port queues, which keep at most the last max_rx_queue_ms blocks
+  rx_block_pool.resize(max_rx_queue_ms + 2);
+  for (std::shared_ptr<rx_block_t>& block : rx_block_pool) {
+    block = std::make_shared<rx_block_t>();
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      block->samples[ch].resize(block_len);
+    }
+  }
+
+  for (uint32_t ch = 0; ch < nof_channels; ch++) {
+    mix_buffer[ch].resize(mix_buffer_ms * block_len);
+    srsran_vec_cf_zero(mix_buffer[ch].data(), mix_buffer[ch].size());
+  }
+
+  running = true;
+  start();
+
+  return SRSRAN_SUCCESS;
+}
+
+void radio_swarm::stop()
+{
+  if (not running) {
+    return;
+  }
+
+  // Release the ports blocked waiting for samples
+  running = false;
+  {
+    std::lock_guard<std::mutex> lock(ports_mutex);
+    for (port* p : ports) {
+      std::lock_guard<std::mutex> rx_lock(p->rx_mutex);
+      p->running = false;
+      p->rx_cvar.notify_all();
+    }
+  }
+  wait_thread_finish();
+
+  {
+    std::lock_guard<std::mutex> lock(tx_mutex);
+    flush_nolock(mix_end_idx);
+  }
+  rf->tx_end();
+  rf_base->stop();
+}
+
+std::unique_ptr<radio_swarm::port> radio_swarm::create_port()
+{
+  std::lock_guard<std::mutex> lock(ports_mutex);
+  return std::unique_ptr<port>(new port(*this, nof_created_ports++));
+}
+
+void radio_swarm::radio_overflow()
+{
+  std::lock_guard<std::mutex> lock(ports_mutex);
+  for (port* p : ports) {
+    if (p->phy != nullptr) {
+      p->phy->radio_overflow();
+    }
+  }
+}
+
+void radio_swarm::radio_failure()
+{
+  std::lock_guard<std::mutex> lock(ports_mutex);
+  for (port* p : ports) {
+    if (p->phy != nullptr) {
+      p->phy->radio_failure();
+    }
+  }
+}
+
+void radio_swarm::add_port(port* p)
+{
+  std::lock_guard<std::mutex> lock(ports_mutex);
+  ports.push_back(p);
+}
+
+void radio_swarm::remove_port(port* p)
+{
+  std::lock_guard<std::mutex> lock(ports_mutex);
+  ports.erase(std::remove(ports.begin(), ports.end(), p), ports.end());
+}
+
+void radio_swarm::run_thread()
+{
+  while (running) {
+    // Take a block that no port holds anymore
+    std::shared_ptr<rx_block_t> block;
+    for (std::shared_ptr<rx_block_t>& b : rx_block_pool) {
+      if (b.use_count() == 1) {
+        block = b;
+        break;
+      }
+    }
+    if (block == nullptr) {
+      logger.error("Swarm: no free receive block");
+      break;
+    }
+
+    rf_buffer_t    buffer;
+    rf_timestamp_t rx_time = {};
+    buffer.set_nof_samples(block_len);
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      buffer.set(ch, block->samples[ch].data());
+    }
+    if (not rf->rx_now(buffer, rx_time)) {
+      logger.error("Swarm: error receiving samples");
+      continue;
+    }
+    block->idx         = srsran_timestamp_uint64(&rx_time.get(0), srate_hz);
+    block->nof_samples = block_len;
+
+    // Hand the block to every port, dropping the oldest one of the ports that do not keep up
+    std::lock_guard<std::mutex> lock(ports_mutex);
+    for (port* p : ports) {
+      bool overflow = false;
+      {
+        std::lock_guard<std::mutex> rx_lock(p->rx_mutex);
+        if (p->rx_queue.size() >= max_rx_queue_ms) {
+          p->rx_queue.pop_front();
+          p->rx_read_offset = 0;
+          overflow          = true;
+        }
+        p->rx_queue.push_back(block);
+        p->rx_cvar.notify_one();
+      }
+      if (overflow) {
+        p->logger.info("Swarm: receive queue overflow, dropping the oldest block");
+        if (p->phy != nullptr) {
+          p->phy->radio_overflow();
+        }
+      }
+    }
+  }
+}
+
+bool radio_swarm::mix_nolock(port* p, cf_t* const ptr[SRSRAN_MAX_CHANNELS], uint32_t nof_samples, uint64_t idx)
+{
+  uint64_t mix_len = mix_buffer[0].size();
+  bool     ret     = true;
+
+  // Nothing is pending, restart the mixing buffer at this transmission
+  if (mix_end_idx <= mix_start_idx and idx > mix_start_idx) {
+    mix_start_idx = idx;
+    mix_end_idx   = idx;
+  }
+
+  // Discard the samples whose time has already been sent to the radio
+  if (idx + nof_samples <= mix_start_idx) {
+    p->logger.info("Swarm: discarding %d late Tx samples", nof_samples);
+    p->tx_end_idx = idx + nof_samples;
+    return true;
+  }
+
+  // Make room in the mixing buffer
+  if (idx + nof_samples > mix_start_idx + mix_len) {
+    ret = flush_nolock(idx + nof_samples - mix_len);
+  }
+  uint32_t offset = (idx < mix_start_idx) ? (uint32_t)(mix_start_idx - idx) : 0;
+
+  // Add the port samples
+  while (offset < nof_samples) {
+    uint32_t pos = (uint32_t)((idx + offset) % mix_len);
+    uint32_t n   = std::min(nof_samples - offset, (uint32_t)mix_len - pos);
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      if (ptr[ch] != nullptr) {
+        srsran_vec_sum_ccc(&mix_buffer[ch][pos], &ptr[ch][offset], &mix_buffer[ch][pos], n);
+      }
+    }
+    offset += n;
+  }
+  p->tx_end_idx = idx + nof_samples;
+  mix_end_idx   = std::max(mix_end_idx, p->tx_end_idx);
+
+  ret &= flush_active_nolock();
+
+  return ret;
+}
+
+bool radio_swarm::end_burst(port* p)
+{
+  std::lock_guard<std::mutex> lock(tx_mutex);
+
+  // Stop waiting for this port, the samples the rest of ports have already mixed can be sent
+  p->tx_end_idx = 0;
+  bool ret      = flush_active_nolock();
+
+  // End the burst of the radio once every port is idle and every mixed sample was sent
+  if (mix_start_idx >= mix_end_idx) {
+    std::lock_guard<std::mutex> ports_lock(ports_mutex);
+    if (std::all_of(ports.begin(), ports.end(), [](const port* q) { return q->tx_end_idx == 0; })) {
+      rf->tx_end();
+    }
+  }
+
+  return ret;
+}
+
+bool radio_swarm::flush_active_nolock()
+{
+  // Send everything every active port has already contributed to
+  uint64_t flush_idx = mix_end_idx;
+  {
+    std::lock_guard<std::mutex> ports_lock(ports_mutex);
+    for (port* q : ports) {
+      if (q->tx_end_idx + max_tx_lag_ms * block_len >= mix_end_idx) {
+        flush_idx = std::min(flush_idx, q->tx_end_idx);
+      }
+    }
+  }
+  if (flush_idx > mix_start_idx) {
+    return flush_nolock(flush_idx);
+  }
+  return true;
+}
+
+bool radio_swarm::flush_nolock(uint64_t end_idx)
+{
+  uint64_t mix_len = mix_buffer[0].size();
+  bool     ret     = true;
+
+  while (mix_start_idx < end_idx) {
+    uint32_t pos = (uint32_t)(mix_start_idx % mix_len);
+    uint32_t n   = (uint32_t)std::min(end_idx - mix_start_idx, mix_len - pos);
+
+    rf_buffer_t    buffer;
+    rf_timestamp_t tx_time = {};
+    buffer.set_nof_samples(n);
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      buffer.set(ch, &mix_buffer[ch][pos]);
+    }
+    for (uint32_t i = 0; i < SRSRAN_MAX_CHANNELS; i++) {
+      srsran_timestamp_init_uint64(tx_time.get_ptr(i), mix_start_idx, srate_hz);
+    }
+    ret &= rf->tx(buffer, tx_time);
+
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      srsran_vec_cf_zero(&mix_buffer[ch][pos], n);
+    }
+    mix_start_idx += n;
+  }
+
+  return ret;
+}
+
+/*******************************************************************************
+  Port
+*******************************************************************************/
+
+radio_swarm::port::port(radio_swarm& parent_, uint32_t id_) :
+  parent(parent_), logger(srslog::fetch_basic_logger("RF-UE" + std::to_string(id_), false))
+{}
+
+radio_swarm::port::~port()
+{
+  stop();
+  for (uint32_t ch = 0; ch < SRSRAN_MAX_CHANNELS; ch++) {
+    srsran_resampler_fft_free(&interpolators[ch]);
+    srsran_resampler_fft_free(&decimators[ch]);
+  }
+}
+
+int radio_swarm::port::init(const rf_args_t& args_, phy_interface_radio* phy_)
+{
+  if (not parent.running) {
+    return SRSRAN_ERROR;
+  }
+
+  phy = phy_;
+  logger.set_level(srslog::str_to_basic_level(args_.log_level));
+
+  // Each PHY keeps its own transmission mode, the swarm radio streams whenever any port transmits
+  continuous_tx = parent.rf->is_continuous_tx();
+  if (args_.continuous_tx != "auto") {
+    continuous_tx = (args_.continuous_tx == "yes");
+  }
+
+  for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+    tx_buffer[ch].resize(max_resamp_ms * parent.block_len);
+    rx_buffer[ch].resize(max_resamp_ms * parent.block_len);
+  }
+
+  running = true;
+  parent.add_port(this);
+
+  return SRSRAN_SUCCESS;
+}
+
+void radio_swarm::port::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(rx_mutex);
+    running = false;
+    rx_queue.clear();
+    rx_cvar.notify_all();
+  }
+  parent.remove_port(this);
+}
+
+bool radio_swarm::port::get_metrics(rf_metrics_t* metrics)
+{
+  return parent.rf_base->get_metrics(metrics);
+}
+
+void radio_swarm::port::tx_end()
+{
+  if (not is_start_of_burst.exchange(true)) {
+    logger.debug("Swarm: end of burst");
+  }
+  parent.end_burst(this);
+}
+
+bool radio_swarm::port::tx(rf_buffer_interface& buffer, const rf_timestamp_interface& tx_time)
+{
+  std::lock_guard<std::mutex> lock(parent.tx_mutex);
+  uint32_t                    nof_samples              = buffer.get_nof_samples();
+  cf_t*                       ptr[SRSRAN_MAX_CHANNELS] = {};
+
+  if (tx_ratio > 1) {
+    // Limit number of samples to the interpolation buffer
+    nof_samples = std::min(nof_samples, (uint32_t)tx_buffer[0].size() / tx_ratio);
+    for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+      if (buffer.get(ch) != nullptr) {
+        srsran_resampler_fft_run(&interpolators[ch], buffer.get(ch), tx_buffer[ch].data(), nof_samples);
+        ptr[ch] = tx_buffer[ch].data();
+      }
+    }
+    nof_samples *= tx_ratio;
+  } else {
+    for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+      ptr[ch] = buffer.get(ch);
+    }
+  }
+
+  uint64_t idx      = srsran_timestamp_uint64(&tx_time.get(0), parent.srate_hz);
+  is_start_of_burst = false;
+  return parent.mix_nolock(this, ptr, nof_samples, idx);
+}
+
+bool radio_swarm::port::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time)
+{
+  uint32_t ratio       = rx_ratio;
+  uint32_t nof_samples = buffer.get_nof_samples() * ratio;
+
+  // Limit number of samples to the decimation buffer
+  if (ratio > 1) {
+    nof_samples = std::min(nof_samples, (uint32_t)rx_buffer[0].size());
+  }
+
+  std::unique_lock<std::mutex> lock(rx_mutex);
+  uint32_t                     count = 0;
+  while (count < nof_samples) {
+    while (rx_queue.empty() and running) {
+      rx_cvar.wait(lock);
+    }
+    if (not running) {
+      return false;
+    }
+
+    const rx_block_t& block = *rx_queue.front();
+    if (count == 0) {
+      for (uint32_t i = 0; i < SRSRAN_MAX_CHANNELS; i++) {
+        srsran_timestamp_init_uint64(rxd_time.get_ptr(i), block.idx + rx_read_offset, parent.srate_hz);
+      }
+    }
+
+    uint32_t n = std::min(block.nof_samples - rx_read_offset, nof_samples - count);
+    for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+      cf_t* dst = (ratio > 1) ? rx_buffer[ch].data() : buffer.get(ch);
+      if (dst != nullptr) {
+        srsran_vec_cf_copy(&dst[count], &block.samples[ch][rx_read_offset], n);
+      }
+    }
+    count += n;
+    rx_read_offset += n;
+
+    if (rx_read_offset == block.nof_samples) {
+      rx_queue.pop_front();
+      rx_read_offset = 0;
+    }
+  }
+  lock.unlock();
+
+  // Perform decimation
+  if (ratio > 1) {
+    for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+      if (buffer.get(ch) != nullptr) {
+        srsran_resampler_fft_run(&decimators[ch], rx_buffer[ch].data(), buffer.get(ch), nof_samples);
+      }
+    }
+  }
+
+  return true;
+}
+
+void radio_swarm::port::set_tx_freq(const uint32_t& carrier_idx, const double& freq)
+{
+  parent.rf->set_tx_freq(carrier_idx, freq);
+}
+
+void radio_swarm::port::set_rx_freq(const uint32_t& carrier_idx, const double& freq)
+{
+  parent.rf->set_rx_freq(carrier_idx, freq);
+}
+
+void radio_swarm::port::release_freq(const uint32_t& carrier_idx)
+{
+  // The frequencies are shared with the rest of ports
+}
+
+void radio_swarm::port::set_tx_gain(const float& gain)
+{
+  parent.rf->set_tx_gain(gain);
+}
+
+void radio_swarm::port::set_rx_gain_th(const float& gain)
+{
+  parent.rf->set_rx_gain_th(gain);
+}
+
+void radio_swarm::port::set_rx_gain(const float& gain)
+{
+  parent.rf->set_rx_gain(gain);
+}
+
+void radio_swarm::port::set_tx_srate(const double& srate)
+{
+  std::lock_guard<std::mutex> lock(parent.tx_mutex);
+
+  // Assert ratio is integer
+  srsran_assert(((uint32_t)parent.srate_hz % (uint32_t)srate) == 0,
+                "The sampling rate ratio is not integer (%.2f MHz / %.2f MHz = %.3f)",
+                parent.srate_hz / 1e6,
+                srate / 1e6,
+                parent.srate_hz / srate);
+
+  tx_ratio = (uint32_t)ceil(parent.srate_hz / srate);
+  for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+    srsran_resampler_fft_init(&interpolators[ch], SRSRAN_RESAMPLER_MODE_INTERPOLATE, tx_ratio);
+  }
+}
+
+void radio_swarm::port::set_rx_srate(const double& srate)
+{
+  std::lock_guard<std::mutex> lock(rx_mutex);
+
+  // Assert ratio is integer
+  srsran_assert(((uint32_t)parent.srate_hz % (uint32_t)srate) == 0,
+                "The sampling rate ratio is not integer (%.2f MHz / %.2f MHz = %.3f)",
+                parent.srate_hz / 1e6,
+                srate / 1e6,
+                parent.srate_hz / srate);
+
+  rx_ratio = (uint32_t)ceil(parent.srate_hz / srate);
+  for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+    srsran_resampler_fft_init(&decimators[ch], SRSRAN_RESAMPLER_MODE_DECIMATE, rx_ratio);
+  }
+}
+
+void radio_swarm::port::set_channel_rx_offset(uint32_t ch, int32_t offset_samples)
+{
+  parent.rf->set_channel_rx_offset(ch, offset_samples);
+}
+
+double radio_swarm::port::get_freq_offset()
+{
+  return parent.rf->get_freq_offset();
+}
+
+float radio_swarm::port::get_rx_gain()
+{
+  return parent.rf->get_rx_gain();
+}
+
+bool radio_swarm::port::is_continuous_tx()
+{
+  return continuous_tx;
+}
+
+bool radio_swarm::port::get_is_start_of_burst()
+{
+  return is_start_of_burst;
+}
+
+bool radio_swarm::port::is_init()
+{
+  return running and parent.rf->is_init();
+}
+
+void radio_swarm::port::reset()
+{
+  // The shared radio keeps streaming for the rest of ports, drop the samples queued for this one
+  std::lock_guard<std::mutex> lock(rx_mutex);
+  rx_queue.clear();
+  rx_read_offset = 0;
+}
+
+srsran_rf_info_t* radio_swarm::port::get_info()
+{
+  return parent.rf->get_info();
+}
+
+} // namespace srsran
@@ -0,0 +1,252 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsran/radio/radio_swarm.h"
+
+static const double   srate_hz  = 1.92e6;
+static const uint32_t block_len = 1920;
+static const uint64_t t0        = 10 * block_len;
+
+/// Radio that produces the receive blocks on request and records the mixed transmit signal
+class radio_swarm_test_rf final : public srsran::radio_base, public srsran::radio_interface_phy
+{
+public:
+  std::string get_type() override { return "test"; }
+  int         init(const srsran::rf_args_t& args_, srsran::phy_interface_radio* phy_) override
+  {
+    tx_signal.resize(20 * block_len);
+    return SRSRAN_SUCCESS;
+  }
+  void stop() override
+  {
+    std::lock_guard<std::mutex> lock(rx_mutex);
+    quit = true;
+    rx_cvar.notify_all();
+  }
+  bool get_metrics(srsran::rf_metrics_t* metrics) override { return false; }
+
+  /// Lets the radio receive one more block, the samples carry the block number as value
+  void push_rx_block()
+  {
+    std::lock_guard<std::mutex> lock(rx_mutex);
+    nof_pending_rx_blocks++;
+    rx_cvar.notify_all();
+  }
+
+  bool rx_now(srsran::rf_buffer_interface& buffer, srsran::rf_timestamp_interface& rxd_time) override
+  {
+    std::unique_lock<std::mutex> lock(rx_mutex);
+    while (nof_pending_rx_blocks == 0 and not quit) {
+      rx_cvar.wait(lock);
+    }
+    if (quit) {
+      return false;
+    }
+    nof_pending_rx_blocks--;
+
+    for (uint32_t i = 0; i < buffer.get_nof_samples(); i++) {
+      buffer.get(0)[i] = (float)(rx_idx / block_len);
+    }
+    srsran_timestamp_init_uint64(rxd_time.get_ptr(0), rx_idx, srate_hz);
+    rx_idx += buffer.get_nof_samples();
+    return true;
+  }
+
+  bool tx(srsran::rf_buffer_interface& buffer, const srsran::rf_timestamp_interface& tx_time) override
+  {
+    uint64_t idx = srsran_timestamp_uint64(&tx_time.get(0), srate_hz);
+    if (idx < tx_end_idx or idx + buffer.get_nof_samples() > tx_signal.size()) {
+      return false;
+    }
+    srsran_vec_cf_copy(&tx_signal[idx], buffer.get(0), buffer.get_nof_samples());
+    tx_end_idx = idx + buffer.get_nof_samples();
+    return true;
+  }
+  void tx_end() override { nof_tx_end++; }
+
+  void              set_tx_freq(const uint32_t& carrier_idx, const double& freq) override {}
+  void              set_rx_freq(const uint32_t& carrier_idx, const double& freq) override {}
+  void              release_freq(const uint32_t& carrier_idx) override {}
+  void              set_tx_gain(const float& gain) override {}
+  void              set_rx_gain_th(const float& gain) override {}
+  void              set_rx_gain(const float& gain) override {}
+  void              set_tx_srate(const double& srate) override {}
+  void              set_rx_srate(const double& srate) override {}
+  void              set_channel_rx_offset(uint32_t ch, int32_t offset_samples) override {}
+  double            get_freq_offset() override { return 0.0; }
+  float             get_rx_gain() override { return 0.0f; }
+  bool              is_continuous_tx() override { return true; }
+  bool              get_is_start_of_burst() override { return false; }
+  bool              is_init() override { return true; }
+  void              reset() override {}
+  srsran_rf_info_t* get_info() override { return &rf_info; }
+
+  std::vector<cf_t> tx_signal;
+  uint64_t          tx_end_idx = 0; ///< Index after the latest transmitted sample
+  uint32_t          nof_tx_end = 0;
+
+private:
+  std::mutex              rx_mutex;
+  std::condition_variable rx_cvar;
+  uint32_t                nof_pending_rx_blocks = 0;
+  uint64_t                rx_idx                = 0;
+  bool                    quit                  = false;
+  srsran_rf_info_t        rf_info               = {};
+};
+
+static bool tx_block(srsran::radio_swarm::port& p, uint64_t idx, float value)
+{
+  std::vector<cf_t> samples(block_len, value);
+  srsran::rf_buffer_t    buffer(samples.data(), block_len);
+  srsran::rf_timestamp_t tx_time;
+  srsran_timestamp_init_uint64(tx_time.get_ptr(0), idx, srate_hz);
+  return p.tx(buffer, tx_time);
+}
+
+static bool tx_signal_equals(const radio_swarm_test_rf& rf, uint64_t idx, uint32_t nof_samples, float value)
+{
+  for (uint32_t i = 0; i < nof_samples; i++) {
+    if (rf.tx_signal[idx + i] != value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int test_rx(srsran::radio_swarm& swarm, radio_swarm_test_rf& rf)
+{
+  std::unique_ptr<srsran::radio_swarm::port> port_a = swarm.create_port();
+  std::unique_ptr<srsran::radio_swarm::port> port_b = swarm.create_port();
+  srsran::rf_args_t                          args   = {};
+  args.log_level                                    = "none";
+  TESTASSERT(port_a->init(args, nullptr) == SRSRAN_SUCCESS);
+  TESTASSERT(port_b->init(args, nullptr) == SRSRAN_SUCCESS);
+
+  // Every port gets the same blocks, port A reads several of them at once while port B reads them one by one
+  std::vector<cf_t>      samples_a(3 * block_len);
+  std::vector<cf_t>      samples_b(block_len);
+  srsran::rf_buffer_t    buffer_a(samples_a.data(), 3 * block_len);
+  srsran::rf_buffer_t    buffer_b(samples_b.data(), block_len);
+  srsran::rf_timestamp_t rx_time_a;
+  srsran::rf_timestamp_t rx_time_b;
+  for (uint32_t i = 0; i < 3; i++) {
+    rf.push_rx_block();
+  }
+  TESTASSERT(port_a->rx_now(buffer_a, rx_time_a));
+  TESTASSERT(srsran_timestamp_uint64(&rx_time_a.get(0), srate_hz) == 0);
+  for (uint32_t i = 0; i < 3; i++) {
+    TESTASSERT(samples_a[i * block_len] == (float)i);
+    TESTASSERT(samples_a[(i + 1) * block_len - 1] == (float)i);
+
+    TESTASSERT(port_b->rx_now(buffer_b, rx_time_b));
+    TESTASSERT(srsran_timestamp_uint64(&rx_time_b.get(0), srate_hz) == i * block_len);
+    TESTASSERT(samples_b[0] == (float)i and samples_b[block_len - 1] == (float)i);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_tx(srsran::radio_swarm& swarm, radio_swarm_test_rf& rf)
+{
+  std::unique_ptr<srsran::radio_swarm::port> port_a = swarm.create_port();
+  std::unique_ptr<srsran::radio_swarm::port> port_b = swarm.create_port();
+  srsran::rf_args_t                          args   = {};
+  args.log_level                                    = "none";
+  args.continuous_tx                                = "no";
+  TESTASSERT(port_a->init(args, nullptr) == SRSRAN_SUCCESS);
+  args.continuous_tx = "auto";
+  TESTASSERT(port_b->init(args, nullptr) == SRSRAN_SUCCESS);
+
+  // Every port keeps its own transmission mode and burst state
+  TESTASSERT(not port_a->is_continuous_tx());
+  TESTASSERT(port_b->is_continuous_tx());
+  TESTASSERT(port_a->get_is_start_of_burst() and port_b->get_is_start_of_burst());
+
+  // Port B is idle, so port A samples are sent straight away
+  TESTASSERT(tx_block(*port_a, t0, 1.0f));
+  TESTASSERT(rf.tx_end_idx == t0 + block_len);
+  TESTASSERT(tx_signal_equals(rf, t0, block_len, 1.0f));
+  TESTASSERT(not port_a->get_is_start_of_burst() and port_b->get_is_start_of_burst());
+
+  // Port B samples for the same time arrive late and are discarded, but it is now transmitting
+  TESTASSERT(tx_block(*port_b, t0, 2.0f));
+  TESTASSERT(rf.tx_end_idx == t0 + block_len);
+  TESTASSERT(tx_signal_equals(rf, t0, block_len, 1.0f));
+
+  // The next subframe is held until both ports have mixed their samples
+  TESTASSERT(tx_block(*port_a, t0 + block_len, 1.0f));
+  TESTASSERT(rf.tx_end_idx == t0 + block_len);
+  TESTASSERT(tx_block(*port_b, t0 + block_len, 2.0f));
+  TESTASSERT(rf.tx_end_idx == t0 + 2 * block_len);
+  TESTASSERT(tx_signal_equals(rf, t0 + block_len, block_len, 3.0f));
+
+  // Port A keeps transmitting and port B stops without ending its burst, the mix is held up to the maximum lag
+  TESTASSERT(tx_block(*port_a, t0 + 2 * block_len, 1.0f));
+  TESTASSERT(tx_block(*port_a, t0 + 3 * block_len, 1.0f));
+  TESTASSERT(rf.tx_end_idx == t0 + 2 * block_len);
+  TESTASSERT(tx_block(*port_a, t0 + 4 * block_len, 1.0f));
+  TESTASSERT(rf.tx_end_idx == t0 + 5 * block_len);
+  TESTASSERT(tx_signal_equals(rf, t0 + 2 * block_len, 3 * block_len, 1.0f));
+
+  // Port B transmits again after a gap, its samples are held while port A is still in its burst
+  TESTASSERT(tx_block(*port_b, t0 + 6 * block_len, 2.0f));
+  TESTASSERT(rf.tx_end_idx == t0 + 5 * block_len);
+
+  // Ending the port A burst sends the samples port B had already mixed
+  port_a->tx_end();
+  TESTASSERT(port_a->get_is_start_of_burst() and not port_b->get_is_start_of_burst());
+  TESTASSERT(rf.tx_end_idx == t0 + 7 * block_len);
+  TESTASSERT(tx_signal_equals(rf, t0 + 6 * block_len, block_len, 2.0f));
+  TESTASSERT(rf.nof_tx_end == 0);
+
+  // The radio burst ends once every port has ended its own
+  port_b->tx_end();
+  TESTASSERT(port_b->get_is_start_of_burst());
+  TESTASSERT(rf.nof_tx_end == 1);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+
+  std::unique_ptr<radio_swarm_test_rf> rf_ptr(new radio_swarm_test_rf);
+  radio_swarm_test_rf*                 rf = rf_ptr.get();
+  srsran::radio_swarm                  swarm(std::move(rf_ptr));
+
+  srsran::rf_args_t args = {};
+  args.srate_hz          = srate_hz;
+  args.nof_carriers      = 1;
+  args.nof_antennas      = 1;
+  TESTASSERT(swarm.init(args) == SRSRAN_SUCCESS);
+
+  TESTASSERT(test_rx(swarm, *rf) == SRSRAN_SUCCESS);
+  TESTASSERT(test_tx(swarm, *rf) == SRSRAN_SUCCESS);
+
+  rf->stop();
+  swarm.stop();
+
+  srslog::flush();
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
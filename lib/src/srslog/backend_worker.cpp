@@ -98,7 +98,11 @@ void backend_worker::do_work()
   /// termination variable periodically.
   constexpr std::chrono::microseconds sleep_period{100};
 
+  last_drop_report = std::chrono::steady_clock::now();
+
   while (running_flag) {
+    report_dropped_entries();
+
     auto item = queue.try_pop();
 
     // Spin while there are no new entries to process.
@@ -117,6 +121,27 @@ void backend_worker::do_work()
   process_outstanding_entries();
 }
 
+void backend_worker::report_dropped_entries()
+{
+  /// Minimum time between two consecutive reports of discarded entries.
+  constexpr std::chrono::seconds drop_report_period{1};
+
+  auto now = std::chrono::steady_clock::now();
+  if (now - last_drop_report < drop_report_period) {
+    return;
+  }
+  last_drop_report = now;
+
+  uint64_t nof_dropped = queue.get_nof_dropped();
+  if (nof_dropped == last_nof_dropped) {
+    return;
+  }
+  err_handler(fmt::format("{} log entries have been discarded because the backend queue was full ({} in total).",
+                          nof_dropped - last_nof_dropped,
+                          nof_dropped));
+  last_nof_dropped = nof_dropped;
+}
+
 /// Executes the flush command over all registered sinks.
 static void process_flush_command(const detail::flush_backend_cmd& cmd)
 {
@@ -98,15 +98,19 @@ private:
   /// Error message is only reported once to avoid spamming.
   void report_queue_on_full_once()
   {
-    if (queue.is_almost_full()) {
+    if (!queue_full_reported && queue.is_almost_full()) {
       err_handler(fmt::format("The backend queue size is about to reach its maximum "
                               "capacity of {} elements, new log entries will get "
                               "discarded.\nConsider increasing the queue capacity.",
                               queue.get_capacity()));
-      err_handler = [](const std::string&) {};
+      queue_full_reported = true;
     }
   }
 
+  /// Reports the number of log entries that have been discarded since the last report. Reports are generated at most
+  /// once per drop report period.
+  void report_dropped_entries();
+
   /// Establishes the specified thread priority for the calling thread.
   void set_thread_priority(backend_priority priority) const;
 
@@ -114,10 +118,13 @@ private:
   detail::work_queue<detail::log_entry>& queue;
   detail::dyn_arg_store_pool&            arg_pool;
   detail::shared_variable<bool>          running_flag;
-  error_handler      err_handler = [](const std::string& error) { fmt::print(stderr, "srsLog error - {}\n", error); };
-  std::once_flag     start_once_flag;
-  std::thread        worker_thread;
-  fmt::memory_buffer fmt_buffer;
+  error_handler  err_handler = [](const std::string& error) { fmt::print(stderr, "srsLog error - {}\n", error); };
+  std::once_flag start_once_flag;
+  std::thread    worker_thread;
+  fmt::memory_buffer                    fmt_buffer;
+  bool                                  queue_full_reported = false;
+  uint64_t                              last_nof_dropped    = 0;
+  std::chrono::steady_clock::time_point last_drop_report;
 };
 
 } // namespace srslog
@@ -0,0 +1,278 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "binary_formatter.h"
+#include "binary_log_format.h"
+#include "srsran/srslog/detail/log_entry_metadata.h"
+#include <cstring>
+
+using namespace srslog;
+using namespace srslog::binary_log;
+
+std::unique_ptr<log_formatter> binary_formatter::clone() const
+{
+  // Format string ids are private to each output stream, the new instance starts with an empty table.
+  return std::unique_ptr<log_formatter>(new binary_formatter);
+}
+
+/// Appends the raw bytes of a trivially copyable value into the buffer.
+template <typename T>
+static void put(fmt::memory_buffer& buffer, const T& value)
+{
+  const char* p = reinterpret_cast<const char*>(&value);
+  buffer.append(p, p + sizeof(T));
+}
+
+/// Appends a string preceded by its length into the buffer.
+static void put_string(fmt::memory_buffer& buffer, fmt::string_view str)
+{
+  put(buffer, static_cast<uint32_t>(str.size()));
+  buffer.append(str.data(), str.data() + str.size());
+}
+
+/// Appends a record header into the buffer and returns its position, so that the length can be filled once the payload
+/// has been written.
+static size_t begin_record(fmt::memory_buffer& buffer, record_type type)
+{
+  size_t pos = buffer.size();
+  put(buffer, type);
+  put(buffer, uint32_t(0));
+  return pos;
+}
+
+/// Fills the length field of the record that starts at the specified position.
+static void end_record(fmt::memory_buffer& buffer, size_t pos)
+{
+  uint32_t len = buffer.size() - pos - record_header_size;
+  std::memcpy(buffer.data() + pos + sizeof(record_type), &len, sizeof(len));
+}
+
+namespace {
+
+/// Serializes a single format argument. Returns false for argument types that can not be serialized.
+struct arg_encoder {
+  fmt::memory_buffer& buffer;
+
+  bool operator()(int v) { return encode(arg_type::int32, v); }
+  bool operator()(unsigned v) { return encode(arg_type::uint32, v); }
+  bool operator()(long long v) { return encode(arg_type::int64, static_cast<int64_t>(v)); }
+  bool operator()(unsigned long long v) { return encode(arg_type::uint64, static_cast<uint64_t>(v)); }
+  bool operator()(bool v) { return encode(arg_type::boolean, static_cast<uint8_t>(v)); }
+  bool operator()(char v) { return encode(arg_type::character, v); }
+  bool operator()(float v) { return encode(arg_type::float32, v); }
+  bool operator()(double v) { return encode(arg_type::float64, v); }
+  bool operator()(long double v) { return encode(arg_type::float64, static_cast<double>(v)); }
+  bool operator()(const char* v)
+  {
+    put(buffer, arg_type::string);
+    put_string(buffer, v ? fmt::string_view(v) : fmt::string_view());
+    return true;
+  }
+  bool operator()(fmt::string_view v)
+  {
+    put(buffer, arg_type::string);
+    put_string(buffer, v);
+    return true;
+  }
+  bool operator()(const void* v) { return encode(arg_type::pointer, reinterpret_cast<uint64_t>(v)); }
+
+  /// 128 bit integers and custom types.
+  template <typename T>
+  bool operator()(T)
+  {
+    return false;
+  }
+
+private:
+  template <typename T>
+  bool encode(arg_type type, T value)
+  {
+    put(buffer, type);
+    put(buffer, value);
+    return true;
+  }
+};
+
+} // namespace
+
+uint32_t binary_formatter::get_fmt_id(const char* fmtstring, fmt::memory_buffer& buffer)
+{
+  auto it = fmt_ids.find(fmtstring);
+  // Format strings are usually literals, but check the contents in case the address belongs to a reused buffer.
+  if (it != fmt_ids.end() && std::strcmp(fmt_strings[it->second].c_str(), fmtstring) == 0) {
+    return it->second;
+  }
+
+  uint32_t id        = fmt_strings.size();
+  fmt_ids[fmtstring] = id;
+  fmt_strings.emplace_back(fmtstring);
+
+  size_t pos = begin_record(buffer, record_type::format_string);
+  put(buffer, id);
+  buffer.append(fmtstring, fmtstring + fmt_strings.back().size());
+  end_record(buffer, pos);
+
+  return id;
+}
+
+void binary_formatter::encode_metadata(const detail::log_entry_metadata& metadata,
+                                       uint32_t                          fmt_id,
+                                       fmt::memory_buffer&               buffer)
+{
+  auto tp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(metadata.tp.time_since_epoch()).count();
+  put(buffer, static_cast<int64_t>(tp_ns));
+  put(buffer, metadata.context.value);
+  put(buffer, static_cast<uint8_t>(metadata.context.enabled));
+  put(buffer, metadata.log_tag);
+  uint8_t name_len = std::min<size_t>(metadata.log_name.size(), UINT8_MAX);
+  put(buffer, name_len);
+  buffer.append(metadata.log_name.data(), metadata.log_name.data() + name_len);
+  put(buffer, fmt_id);
+
+  if (!metadata.fmtstring || !metadata.store) {
+    put(buffer, args_mode::none);
+    return;
+  }
+
+  fmt::basic_format_args<fmt::basic_printf_context_t<char> > args(*metadata.store);
+
+  size_t mode_pos = buffer.size();
+  put(buffer, args_mode::raw);
+  put(buffer, uint8_t(0));
+  uint8_t     nof_args = 0;
+  arg_encoder encoder{buffer};
+  bool        ok = true;
+  for (int i = 0, e = args.max_size(); i != e && ok; ++i) {
+    auto arg = args.get(i);
+    if (!arg) {
+      break;
+    }
+    ok = (nof_args != UINT8_MAX) && fmt::visit_format_arg(encoder, arg);
+    ++nof_args;
+  }
+
+  if (ok) {
+    buffer.data()[mode_pos + sizeof(args_mode)] = static_cast<char>(nof_args);
+    return;
+  }
+
+  // Fall back to rendering the message for arguments without a binary representation.
+  buffer.resize(mode_pos);
+  put(buffer, args_mode::rendered);
+  fmt::memory_buffer msg;
+  try {
+    fmt::vprintf(msg, fmt::to_string_view(metadata.fmtstring), args);
+  } catch (...) {
+    fmt::format_to(msg, "{} -> srsLog error - Invalid format string", metadata.fmtstring);
+  }
+  put_string(buffer, fmt::string_view(msg.data(), msg.size()));
+}
+
+void binary_formatter::format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer)
+{
+  // Emit the format string definition (if needed) ahead of the entry that uses it.
+  uint32_t fmt_id = metadata.fmtstring ? get_fmt_id(metadata.fmtstring, buffer) : invalid_fmt_id;
+
+  size_t pos = begin_record(buffer, record_type::entry);
+  encode_metadata(metadata, fmt_id, buffer);
+  put(buffer, static_cast<uint32_t>(metadata.hex_dump.size()));
+  buffer.append(metadata.hex_dump.data(), metadata.hex_dump.data() + metadata.hex_dump.size());
+  end_record(buffer, pos);
+}
+
+void binary_formatter::format_context_begin(const detail::log_entry_metadata& md,
+                                            fmt::string_view                  ctx_name,
+                                            unsigned                          size,
+                                            fmt::memory_buffer&               buffer)
+{
+  uint32_t fmt_id = md.fmtstring ? get_fmt_id(md.fmtstring, buffer) : invalid_fmt_id;
+
+  size_t pos = begin_record(buffer, record_type::context_begin);
+  encode_metadata(md, fmt_id, buffer);
+  put_string(buffer, ctx_name);
+  put(buffer, static_cast<uint32_t>(size));
+  end_record(buffer, pos);
+}
+
+void binary_formatter::format_context_end(const detail::log_entry_metadata& md,
+                                          fmt::string_view                  ctx_name,
+                                          fmt::memory_buffer&               buffer)
+{
+  size_t pos = begin_record(buffer, record_type::context_end);
+  put_string(buffer, ctx_name);
+  end_record(buffer, pos);
+}
+
+void binary_formatter::format_metric_set_begin(fmt::string_view    set_name,
+                                               unsigned            size,
+                                               unsigned            level,
+                                               fmt::memory_buffer& buffer)
+{
+  size_t pos = begin_record(buffer, record_type::metric_set_begin);
+  put_string(buffer, set_name);
+  put(buffer, static_cast<uint32_t>(size));
+  put(buffer, static_cast<uint32_t>(level));
+  end_record(buffer, pos);
+}
+
+void binary_formatter::format_metric_set_end(fmt::string_view set_name, unsigned level, fmt::memory_buffer& buffer)
+{
+  size_t pos = begin_record(buffer, record_type::metric_set_end);
+  put_string(buffer, set_name);
+  put(buffer, static_cast<uint32_t>(level));
+  end_record(buffer, pos);
+}
+
+void binary_formatter::format_list_begin(fmt::string_view    list_name,
+                                         unsigned            size,
+                                         unsigned            level,
+                                         fmt::memory_buffer& buffer)
+{
+  size_t pos = begin_record(buffer, record_type::list_begin);
+  put_string(buffer, list_name);
+  put(buffer, static_cast<uint32_t>(size));
+  put(buffer, static_cast<uint32_t>(level));
+  end_record(buffer, pos);
+}
+
+void binary_formatter::format_list_end(fmt::string_view list_name, unsigned level, fmt::memory_buffer& buffer)
+{
+  size_t pos = begin_record(buffer, record_type::list_end);
+  put_string(buffer, list_name);
+  put(buffer, static_cast<uint32_t>(level));
+  end_record(buffer, pos);
+}
+
+void binary_formatter::format_metric(fmt::string_view    metric_name,
+                                     fmt::string_view    metric_value,
+                                     fmt::string_view    metric_units,
+                                     metric_kind         kind,
+                                     unsigned            level,
+                                     fmt::memory_buffer& buffer)
+{
+  size_t pos = begin_record(buffer, record_type::metric);
+  put_string(buffer, metric_name);
+  put_string(buffer, metric_value);
+  put_string(buffer, metric_units);
+  put(buffer, static_cast<uint8_t>(kind));
+  put(buffer, static_cast<uint32_t>(level));
+  end_record(buffer, pos);
+}
@@ -0,0 +1,89 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_BINARY_FORMATTER_H
+#define SRSLOG_BINARY_FORMATTER_H
+
+#include "srsran/srslog/formatter.h"
+#include <unordered_map>
+#include <vector>
+
+namespace srslog {
+
+/// Binary formatter class implementation.
+/// Instead of rendering log entries into text, this formatter serializes the entry metadata, a compact id of the format
+/// string, the raw value of each argument and the raw hex dump bytes (see binary_log_format.h). This removes the cost
+/// of timestamp, argument and hex dump formatting from the backend thread. Files are later rendered into text or JSON
+/// with the offline decoder.
+/// NOTE: The format string ids are only valid inside the stream generated by a formatter instance, so each sink must
+/// use its own instance.
+class binary_formatter : public log_formatter
+{
+public:
+  std::unique_ptr<log_formatter> clone() const override;
+
+  void format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) override;
+
+private:
+  void format_context_begin(const detail::log_entry_metadata& md,
+                            fmt::string_view                  ctx_name,
+                            unsigned                          size,
+                            fmt::memory_buffer&               buffer) override;
+
+  void format_context_end(const detail::log_entry_metadata& md,
+                          fmt::string_view                  ctx_name,
+                          fmt::memory_buffer&               buffer) override;
+
+  void format_metric_set_begin(fmt::string_view    set_name,
+                               unsigned            size,
+                               unsigned            level,
+                               fmt::memory_buffer& buffer) override;
+
+  void format_metric_set_end(fmt::string_view set_name, unsigned level, fmt::memory_buffer& buffer) override;
+
+  void
+  format_list_begin(fmt::string_view list_name, unsigned size, unsigned level, fmt::memory_buffer& buffer) override;
+
+  void format_list_end(fmt::string_view list_name, unsigned level, fmt::memory_buffer& buffer) override;
+
+  void format_metric(fmt::string_view    metric_name,
+                     fmt::string_view    metric_value,
+                     fmt::string_view    metric_units,
+                     metric_kind         kind,
+                     unsigned            level,
+                     fmt::memory_buffer& buffer) override;
+
+  /// Returns the id of the specified format string, emitting its definition record the first time it is seen.
+  uint32_t get_fmt_id(const char* fmtstring, fmt::memory_buffer& buffer);
+
+  /// Encodes the metadata and arguments common to entries and contexts.
+  void encode_metadata(const detail::log_entry_metadata& metadata, uint32_t fmt_id, fmt::memory_buffer& buffer);
+
+private:
+  /// Maps the address of each format string to its id.
+  std::unordered_map<const char*, uint32_t> fmt_ids;
+  /// Copy of each registered format string, indexed by id. Used to detect format strings stored in reused buffers.
+  std::vector<std::string> fmt_strings;
+};
+
+} // namespace srslog
+
+#endif // SRSLOG_BINARY_FORMATTER_H
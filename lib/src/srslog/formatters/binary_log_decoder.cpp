@@ -0,0 +1,379 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "binary_log_decoder.h"
+#include "../sinks/file_utils.h"
+#include "binary_log_format.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace srslog;
+using namespace srslog::binary_log;
+
+/// Bounds checked reader of the payload of a record.
+class binary_log_decoder::reader
+{
+public:
+  reader(const uint8_t* data, size_t len) : data(data), len(len) {}
+
+  template <typename T>
+  bool get(T& value)
+  {
+    if (len - pos < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, data + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  bool get_bytes(size_t n, std::string& str)
+  {
+    if (len - pos < n) {
+      return false;
+    }
+    str.assign(reinterpret_cast<const char*>(data + pos), n);
+    pos += n;
+    return true;
+  }
+
+  bool get_string(std::string& str)
+  {
+    uint32_t n = 0;
+    return get(n) && get_bytes(n, str);
+  }
+
+  size_t remaining() const { return len - pos; }
+
+private:
+  const uint8_t* data;
+  size_t         len;
+  size_t         pos = 0;
+};
+
+bool binary_log_decoder::decode_metadata(reader&                                             r,
+                                         detail::log_entry_metadata&                         md,
+                                         fmt::dynamic_format_arg_store<fmt::printf_context>& store,
+                                         std::string&                                        rendered)
+{
+  int64_t tp_ns   = 0;
+  uint8_t enabled = 0, name_len = 0;
+  if (!r.get(tp_ns) || !r.get(md.context.value) || !r.get(enabled) || !r.get(md.log_tag) || !r.get(name_len) ||
+      !r.get_bytes(name_len, md.log_name)) {
+    return false;
+  }
+  md.tp = std::chrono::high_resolution_clock::time_point(
+      std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::nanoseconds(tp_ns)));
+  md.context.enabled = enabled;
+
+  uint32_t  fmt_id = invalid_fmt_id;
+  args_mode mode   = args_mode::none;
+  if (!r.get(fmt_id) || !r.get(mode)) {
+    return false;
+  }
+
+  md.fmtstring = nullptr;
+  md.store     = nullptr;
+  if (fmt_id != invalid_fmt_id) {
+    if (fmt_id >= fmt_strings.size()) {
+      rendered     = fmt::format("srsLog decoder error - Unknown format string id {}", fmt_id);
+      md.fmtstring = rendered.c_str();
+    } else {
+      md.fmtstring = fmt_strings[fmt_id].c_str();
+    }
+  }
+
+  switch (mode) {
+    case args_mode::none:
+      return true;
+    case args_mode::rendered:
+      if (!r.get_string(rendered)) {
+        return false;
+      }
+      md.fmtstring = rendered.c_str();
+      return true;
+    case args_mode::raw:
+      break;
+    default:
+      return false;
+  }
+
+  uint8_t nof_args = 0;
+  if (!r.get(nof_args)) {
+    return false;
+  }
+  store.clear();
+  for (unsigned i = 0; i != nof_args; ++i) {
+    arg_type type;
+    if (!r.get(type)) {
+      return false;
+    }
+    bool ok = true;
+    switch (type) {
+      case arg_type::int32: {
+        int32_t v = 0;
+        ok        = r.get(v);
+        store.push_back(int(v));
+        break;
+      }
+      case arg_type::uint32: {
+        uint32_t v = 0;
+        ok         = r.get(v);
+        store.push_back(unsigned(v));
+        break;
+      }
+      case arg_type::int64: {
+        int64_t v = 0;
+        ok        = r.get(v);
+        store.push_back(static_cast<long long>(v));
+        break;
+      }
+      case arg_type::uint64: {
+        uint64_t v = 0;
+        ok         = r.get(v);
+        store.push_back(static_cast<unsigned long long>(v));
+        break;
+      }
+      case arg_type::boolean: {
+        uint8_t v = 0;
+        ok        = r.get(v);
+        store.push_back(bool(v));
+        break;
+      }
+      case arg_type::character: {
+        char v = 0;
+        ok     = r.get(v);
+        store.push_back(v);
+        break;
+      }
+      case arg_type::float32: {
+        float v = 0;
+        ok      = r.get(v);
+        store.push_back(v);
+        break;
+      }
+      case arg_type::float64: {
+        double v = 0;
+        ok       = r.get(v);
+        store.push_back(v);
+        break;
+      }
+      case arg_type::string: {
+        std::string v;
+        ok = r.get_string(v);
+        store.push_back(std::move(v));
+        break;
+      }
+      case arg_type::pointer: {
+        uint64_t v = 0;
+        ok         = r.get(v);
+        store.push_back(reinterpret_cast<const void*>(v));
+        break;
+      }
+      default:
+        return false;
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  md.store = &store;
+
+  return true;
+}
+
+bool binary_log_decoder::decode_record(uint8_t type, reader& r, fmt::memory_buffer& out)
+{
+  switch (static_cast<record_type>(type)) {
+    case record_type::format_string: {
+      uint32_t    id = 0;
+      std::string str;
+      if (!r.get(id) || !r.get_bytes(r.remaining(), str)) {
+        return false;
+      }
+      if (id >= fmt_strings.size()) {
+        fmt_strings.resize(id + 1);
+      }
+      fmt_strings[id] = std::move(str);
+      return true;
+    }
+    case record_type::entry: {
+      detail::log_entry_metadata md;
+      uint32_t                   hex_len = 0;
+      std::string                hex;
+      if (!decode_metadata(r, md, entry_store, entry_rendered) || !r.get(hex_len) || !r.get_bytes(hex_len, hex)) {
+        return false;
+      }
+      md.hex_dump.assign(hex.begin(), hex.end());
+      formatter.format(std::move(md), out);
+      ++nof_entries;
+      return true;
+    }
+    case record_type::context_begin: {
+      std::string name;
+      uint32_t    size = 0;
+      if (!decode_metadata(r, ctx_md, ctx_store, ctx_rendered) || !r.get_string(name) || !r.get(size)) {
+        return false;
+      }
+      formatter.format_context_begin(ctx_md, name, size, out);
+      ++nof_entries;
+      return true;
+    }
+    case record_type::context_end: {
+      std::string name;
+      if (!r.get_string(name)) {
+        return false;
+      }
+      formatter.format_context_end(ctx_md, name, out);
+      return true;
+    }
+    case record_type::metric_set_begin:
+    case record_type::list_begin: {
+      std::string name;
+      uint32_t    size = 0, level = 0;
+      if (!r.get_string(name) || !r.get(size) || !r.get(level)) {
+        return false;
+      }
+      if (static_cast<record_type>(type) == record_type::metric_set_begin) {
+        formatter.format_metric_set_begin(name, size, level, out);
+      } else {
+        formatter.format_list_begin(name, size, level, out);
+      }
+      return true;
+    }
+    case record_type::metric_set_end:
+    case record_type::list_end: {
+      std::string name;
+      uint32_t    level = 0;
+      if (!r.get_string(name) || !r.get(level)) {
+        return false;
+      }
+      if (static_cast<record_type>(type) == record_type::metric_set_end) {
+        formatter.format_metric_set_end(name, level, out);
+      } else {
+        formatter.format_list_end(name, level, out);
+      }
+      return true;
+    }
+    case record_type::metric: {
+      std::string name, value, units;
+      uint8_t     kind  = 0;
+      uint32_t    level = 0;
+      if (!r.get_string(name) || !r.get_string(value) || !r.get_string(units) || !r.get(kind) || !r.get(level)) {
+        return false;
+      }
+      formatter.format_metric(name, value, units, static_cast<metric_kind>(kind), level, out);
+      return true;
+    }
+  }
+
+  // Skip records added by newer versions of the format.
+  return true;
+}
+
+long binary_log_decoder::decode_records(const uint8_t* data, size_t len, fmt::memory_buffer& out)
+{
+  size_t pos = 0;
+  while (len - pos >= record_header_size) {
+    uint8_t  type        = data[pos];
+    uint32_t payload_len = 0;
+    // A zero type marks the end of the written data in a preallocated file.
+    if (type == 0) {
+      break;
+    }
+    std::memcpy(&payload_len, data + pos + sizeof(type), sizeof(payload_len));
+    if (len - pos - record_header_size < payload_len) {
+      return -1;
+    }
+
+    reader r(data + pos + record_header_size, payload_len);
+    if (!decode_record(type, r, out)) {
+      return -1;
+    }
+    pos += record_header_size + payload_len;
+
+    // Keep memory usage bounded when decoding large files.
+    if (stream && out.size() > flush_threshold) {
+      std::fwrite(out.data(), sizeof(char), out.size(), stream);
+      out.clear();
+    }
+  }
+
+  return pos;
+}
+
+detail::error_string binary_log_decoder::decode_file(const std::string& path, std::FILE* out)
+{
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return file_utils::format_error(fmt::format("Unable to open binary log file \"{}\"", path), errno);
+  }
+
+  struct stat st = {};
+  if (::fstat(fd, &st) < 0) {
+    auto err_str = file_utils::format_error(fmt::format("Unable to read binary log file \"{}\"", path), errno);
+    ::close(fd);
+    return err_str;
+  }
+
+  size_t len = st.st_size;
+  if (len < sizeof(file_header)) {
+    ::close(fd);
+    return fmt::format("Binary log file \"{}\" is too short", path);
+  }
+
+  void* map = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    return file_utils::format_error(fmt::format("Unable to map binary log file \"{}\"", path), errno);
+  }
+  const uint8_t* data = static_cast<const uint8_t*>(map);
+
+  file_header header   = {};
+  file_header expected = make_file_header();
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0) {
+    ::munmap(map, len);
+    return fmt::format("\"{}\" is not a binary log file", path);
+  }
+  if (header.version != version || header.endianness != endianness_marker) {
+    ::munmap(map, len);
+    return fmt::format("Unsupported binary log file \"{}\" (version {}, generated with a different byte order: {})",
+                       path,
+                       header.version,
+                       header.endianness != endianness_marker);
+  }
+
+  fmt::memory_buffer   buffer;
+  detail::error_string err_str;
+  stream = out;
+  if (decode_records(data + sizeof(header), len - sizeof(header), buffer) < 0) {
+    err_str = fmt::format("Binary log file \"{}\" is corrupted, decoding stopped after {} entries", path, nof_entries);
+  }
+  std::fwrite(buffer.data(), sizeof(char), buffer.size(), out);
+  stream = nullptr;
+
+  ::munmap(map, len);
+  return err_str;
+}
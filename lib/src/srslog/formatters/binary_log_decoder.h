@@ -0,0 +1,85 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_BINARY_LOG_DECODER_H
+#define SRSLOG_BINARY_LOG_DECODER_H
+
+#include "srsran/srslog/detail/log_entry_metadata.h"
+#include "srsran/srslog/detail/support/error_string.h"
+#include "srsran/srslog/formatter.h"
+#include <cstdio>
+#include <vector>
+
+namespace srslog {
+
+/// Renders the records of a binary log (see binary_log_format.h) using any log formatter, producing the same output as
+/// if the entries had been formatted by it at run time.
+class binary_log_decoder
+{
+public:
+  explicit binary_log_decoder(log_formatter& formatter) : formatter(formatter) {}
+
+  binary_log_decoder(const binary_log_decoder&) = delete;
+  binary_log_decoder& operator=(const binary_log_decoder&) = delete;
+
+  /// Decodes a sequence of records, appending the rendered output into the buffer. Decoding stops at the first zero
+  /// byte where a record is expected, which marks the unused space of a preallocated file. Returns the number of
+  /// consumed bytes, or a negative value when the input is malformed.
+  long decode_records(const uint8_t* data, size_t len, fmt::memory_buffer& out);
+
+  /// Decodes the binary log file in the specified path, writing the rendered output into the output stream.
+  detail::error_string decode_file(const std::string& path, std::FILE* out);
+
+  /// Returns the number of log entries that have been decoded so far.
+  uint64_t get_nof_entries() const { return nof_entries; }
+
+private:
+  class reader;
+
+  /// Decodes a single record. Returns false when the record is malformed.
+  bool decode_record(uint8_t type, reader& r, fmt::memory_buffer& out);
+
+  /// Decodes the metadata and arguments of an entry or context, using the provided storage for the arguments.
+  bool decode_metadata(reader&                                             r,
+                       detail::log_entry_metadata&                         md,
+                       fmt::dynamic_format_arg_store<fmt::printf_context>& store,
+                       std::string&                                        rendered);
+
+private:
+  /// Size of rendered output that triggers a write into the output stream.
+  static constexpr size_t flush_threshold = 1024 * 1024;
+
+  log_formatter&           formatter;
+  std::vector<std::string> fmt_strings;
+  uint64_t                 nof_entries = 0;
+  std::FILE*               stream      = nullptr;
+  // Storage of the entry being rendered.
+  fmt::dynamic_format_arg_store<fmt::printf_context> entry_store;
+  std::string                                        entry_rendered;
+  // Storage of the open context, which needs its metadata again once all its elements have been processed.
+  detail::log_entry_metadata                         ctx_md;
+  fmt::dynamic_format_arg_store<fmt::printf_context> ctx_store;
+  std::string                                        ctx_rendered;
+};
+
+} // namespace srslog
+
+#endif // SRSLOG_BINARY_LOG_DECODER_H
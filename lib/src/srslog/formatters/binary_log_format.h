@@ -0,0 +1,113 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_BINARY_LOG_FORMAT_H
+#define SRSLOG_BINARY_LOG_FORMAT_H
+
+#include <cstdint>
+
+namespace srslog {
+
+/// Definitions of the binary log file layout shared by the binary formatter, the memory mapped sink and the decoder.
+///
+/// A binary log file starts with a file_header followed by a sequence of records. Each record is made of a one byte
+/// record type, a 32 bit payload length and the payload itself. All fields are stored in the byte order of the host
+/// that generated the file, which is identified by the endianness field of the header.
+///
+/// Format strings are not repeated in every entry: the first time a format string is used, a format_string record
+/// assigns an id to it, and the following entries only carry the id and the raw value of each argument.
+namespace binary_log {
+
+/// Current version of the binary log layout.
+constexpr uint32_t version = 1;
+
+/// Value stored in the header to identify the byte order of the file.
+constexpr uint32_t endianness_marker = 0x01020304;
+
+/// Id used in entries that do not have a format string.
+constexpr uint32_t invalid_fmt_id = UINT32_MAX;
+
+struct file_header {
+  char     magic[8];
+  uint32_t version;
+  uint32_t endianness;
+};
+
+/// Builds the header of a new binary log file.
+inline file_header make_file_header()
+{
+  return {{'S', 'R', 'S', 'L', 'O', 'G', 'B', 'N'}, version, endianness_marker};
+}
+
+/// Size of the header placed at the beginning of each record.
+constexpr unsigned record_header_size = sizeof(uint8_t) + sizeof(uint32_t);
+
+enum class record_type : uint8_t {
+  /// u32 id, followed by the format string characters.
+  format_string = 1,
+  /// Entry metadata, argument list and hex dump.
+  entry,
+  /// Entry metadata, argument list, context name and number of elements.
+  context_begin,
+  /// Context name.
+  context_end,
+  /// Set name, number of elements and nesting level.
+  metric_set_begin,
+  /// Set name and nesting level.
+  metric_set_end,
+  /// List name, number of elements and nesting level.
+  list_begin,
+  /// List name and nesting level.
+  list_end,
+  /// Metric name, value, units, kind and nesting level.
+  metric
+};
+
+/// Describes how the arguments of an entry are stored.
+enum class args_mode : uint8_t {
+  /// The entry has no arguments, the format string is printed as is.
+  none = 0,
+  /// A u8 argument count followed by the raw value of each argument.
+  raw,
+  /// The message was rendered when encoding the entry, as some of its arguments can not be serialized.
+  rendered
+};
+
+/// Type tag of a serialized argument.
+enum class arg_type : uint8_t {
+  int32 = 0,
+  uint32,
+  int64,
+  uint64,
+  boolean,
+  character,
+  float32,
+  float64,
+  /// u32 length followed by the string characters.
+  string,
+  pointer
+};
+
+} // namespace binary_log
+
+} // namespace srslog
+
+#endif // SRSLOG_BINARY_LOG_FORMAT_H
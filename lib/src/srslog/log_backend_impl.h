@@ -60,6 +60,9 @@ public:
   /// Stops the backend worker thread.
   void stop() { worker.stop(); }
 
+  /// Returns the number of log entries discarded so far because the queue of the producer thread was full.
+  uint64_t get_nof_dropped() const { return queue.get_nof_dropped(); }
+
 private:
   detail::work_queue<detail::log_entry> queue;
   detail::dyn_arg_store_pool            arg_pool;
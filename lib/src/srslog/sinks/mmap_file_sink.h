@@ -0,0 +1,170 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_MMAP_FILE_SINK_H
+#define SRSLOG_MMAP_FILE_SINK_H
+
+#include "../formatters/binary_log_format.h"
+#include "file_utils.h"
+#include "srsran/srslog/sink.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace srslog {
+
+/// This sink writes binary log records into a memory mapped file. Writes are plain memory copies into the mapping and
+/// the kernel takes care of writing the dirty pages back to disk. The file is grown in big chunks as needed and is
+/// truncated to the written size when the sink gets destroyed. A binary log file header is written at the beginning
+/// of the file, so this sink is intended to be used with the binary formatter.
+class mmap_file_sink : public sink
+{
+  /// Size of the chunks used for growing the file.
+  static constexpr size_t grow_size = 64 * 1024 * 1024;
+
+public:
+  mmap_file_sink(std::string path, std::unique_ptr<log_formatter> f) : sink(std::move(f)), path(std::move(path)) {}
+
+  mmap_file_sink(const mmap_file_sink& other) = delete;
+  mmap_file_sink& operator=(const mmap_file_sink& other) = delete;
+
+  ~mmap_file_sink() override { close(); }
+
+  detail::error_string write(detail::memory_buffer buffer) override
+  {
+    // Create a new file the first time we hit this method.
+    if (is_first_write) {
+      is_first_write = false;
+      if (auto err_str = create()) {
+        return err_str;
+      }
+    }
+
+    // Do not bother doing any work when the file was closed on a previous error.
+    if (fd < 0) {
+      return {};
+    }
+
+    if (used + buffer.size() > mapped_size) {
+      if (auto err_str = grow(used + buffer.size())) {
+        return err_str;
+      }
+    }
+
+    std::memcpy(map + used, buffer.data(), buffer.size());
+    used += buffer.size();
+
+    return {};
+  }
+
+  detail::error_string flush() override
+  {
+    if (fd < 0) {
+      return {};
+    }
+
+    // Schedule the write back of the written pages without blocking the backend.
+    size_t page_size = ::sysconf(_SC_PAGESIZE);
+    size_t begin     = (synced / page_size) * page_size;
+    if (used > begin && ::msync(map + begin, used - begin, MS_ASYNC) < 0) {
+      auto err_str =
+          file_utils::format_error(fmt::format("Error encountered while flushing log file \"{}\"", path), errno);
+      close();
+      return err_str;
+    }
+    synced = used;
+
+    return {};
+  }
+
+private:
+  /// Creates the file and writes the binary log file header.
+  detail::error_string create()
+  {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      return file_utils::format_error(fmt::format("Unable to create log file \"{}\"", path), errno);
+    }
+
+    binary_log::file_header header = binary_log::make_file_header();
+    return write({reinterpret_cast<const char*>(&header), sizeof(header)});
+  }
+
+  /// Extends the file and its mapping to hold at least the specified number of bytes.
+  detail::error_string grow(size_t min_size)
+  {
+    size_t new_size = mapped_size;
+    while (new_size < min_size) {
+      new_size += grow_size;
+    }
+
+    if (map) {
+      ::munmap(map, mapped_size);
+      map = nullptr;
+    }
+    if (::ftruncate(fd, new_size) < 0) {
+      auto err_str = file_utils::format_error(fmt::format("Unable to extend log file \"{}\"", path), errno);
+      close();
+      return err_str;
+    }
+    void* p = ::mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+      auto err_str = file_utils::format_error(fmt::format("Unable to map log file \"{}\"", path), errno);
+      close();
+      return err_str;
+    }
+    map         = static_cast<char*>(p);
+    mapped_size = new_size;
+
+    return {};
+  }
+
+  /// Unmaps the file, dropping the unused preallocated space.
+  void close()
+  {
+    if (map) {
+      ::munmap(map, mapped_size);
+      map = nullptr;
+    }
+    if (fd >= 0) {
+      if (::ftruncate(fd, used) < 0) {
+        fmt::print(stderr, "srsLog error - Unable to truncate log file \"{}\"\n", path);
+      }
+      ::close(fd);
+      fd = -1;
+    }
+    mapped_size = 0;
+  }
+
+private:
+  const std::string path;
+  int               fd             = -1;
+  char*             map            = nullptr;
+  size_t            mapped_size    = 0;
+  size_t            used           = 0;
+  size_t            synced         = 0;
+  bool              is_first_write = true;
+};
+
+} // namespace srslog
+
+#endif // SRSLOG_MMAP_FILE_SINK_H
@@ -20,8 +20,10 @@
  */
 
 #include "srsran/srslog/srslog.h"
+#include "formatters/binary_formatter.h"
 #include "formatters/json_formatter.h"
 #include "sinks/file_sink.h"
+#include "sinks/mmap_file_sink.h"
 #include "sinks/syslog_sink.h"
 #include "srslog_instance.h"
 
@@ -105,6 +107,11 @@ std::unique_ptr<log_formatter> srslog::create_json_formatter()
   return std::unique_ptr<log_formatter>(new json_formatter);
 }
 
+std::unique_ptr<log_formatter> srslog::create_binary_formatter()
+{
+  return std::unique_ptr<log_formatter>(new binary_formatter);
+}
+
 ///
 /// Sink management function implementations.
 ///
@@ -178,6 +185,22 @@ sink& srslog::fetch_file_sink(const std::string&             path,
   return *s;
 }
 
+sink& srslog::fetch_binary_file_sink(const std::string& path)
+{
+  assert(!path.empty() && "Empty path string");
+
+  if (auto* s = find_sink(path)) {
+    return *s;
+  }
+
+  auto& s = srslog_instance::get().get_sink_repo().emplace(
+      std::piecewise_construct,
+      std::forward_as_tuple(path),
+      std::forward_as_tuple(new mmap_file_sink(path, create_binary_formatter())));
+
+  return *s;
+}
+
 sink& srslog::fetch_syslog_sink(const std::string&             preamble_,
                                 syslog_local_type              log_local_,
                                 std::unique_ptr<log_formatter> f)
@@ -239,6 +262,8 @@ void srslog::flush()
 
   detail::log_entry cmd;
   cmd.metadata.store = nullptr;
+  // Timestamp the command so that the backend processes it after the entries that were already generated.
+  cmd.metadata.tp = std::chrono::high_resolution_clock::now();
   cmd.flush_cmd =
       std::unique_ptr<detail::flush_backend_cmd>(new detail::flush_backend_cmd{completion_flag, std::move(sinks)});
 
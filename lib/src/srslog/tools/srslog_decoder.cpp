@@ -0,0 +1,99 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/// Offline decoder of the binary log files generated by the srslog binary file sink. Renders the log entries into text
+/// or JSON using the same formatters that srslog uses at run time.
+
+#include "../formatters/binary_log_decoder.h"
+#include "../formatters/json_formatter.h"
+#include "../formatters/text_formatter.h"
+#include <cstring>
+#include <unistd.h>
+
+using namespace srslog;
+
+static void usage(const char* prog)
+{
+  fmt::print("Usage: {} [-f text|json] [-o output_file] binary_log_file\n"
+             "\t-f Output format [Default text]\n"
+             "\t-o Output file [Default stdout]\n",
+             prog);
+}
+
+int main(int argc, char** argv)
+{
+  std::string format = "text";
+  std::string output;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "f:o:h")) != -1) {
+    switch (opt) {
+      case 'f':
+        format = optarg;
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      default:
+        usage(argv[0]);
+        return -1;
+    }
+  }
+  if (optind != argc - 1) {
+    usage(argv[0]);
+    return -1;
+  }
+
+  std::unique_ptr<log_formatter> formatter;
+  if (format == "text") {
+    formatter = std::unique_ptr<log_formatter>(new text_formatter);
+  } else if (format == "json") {
+    formatter = std::unique_ptr<log_formatter>(new json_formatter);
+  } else {
+    fmt::print(stderr, "Invalid output format \"{}\"\n", format);
+    usage(argv[0]);
+    return -1;
+  }
+
+  std::FILE* out = stdout;
+  if (!output.empty()) {
+    out = std::fopen(output.c_str(), "w");
+    if (!out) {
+      fmt::print(stderr, "Unable to create output file \"{}\": {}\n", output, std::strerror(errno));
+      return -1;
+    }
+  }
+
+  binary_log_decoder decoder(*formatter);
+  auto               err_str = decoder.decode_file(argv[optind], out);
+
+  if (out != stdout) {
+    std::fclose(out);
+  }
+
+  if (err_str) {
+    fmt::print(stderr, "{}\n", err_str.get_error());
+    return -1;
+  }
+  fmt::print(stderr, "Decoded {} log entries\n", decoder.get_nof_entries());
+
+  return 0;
+}
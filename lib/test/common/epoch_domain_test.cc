@@ -0,0 +1,175 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/epoch_domain.h"
+#include "srsran/support/srsran_test.h"
+#include <thread>
+#include <vector>
+
+using namespace srsran;
+
+struct tracked_obj {
+  explicit tracked_obj(std::atomic<int>& alive_) : alive(alive_), value(42) { alive++; }
+  ~tracked_obj()
+  {
+    value = 0;
+    alive--;
+  }
+  std::atomic<int>& alive;
+  std::atomic<int>  value;
+};
+
+void test_retire_waits_for_readers()
+{
+  std::atomic<int> alive{0};
+  epoch_domain     epochs;
+
+  std::unique_ptr<tracked_obj> obj(new tracked_obj(alive));
+
+  epochs.enter();
+  epochs.retire(std::move(obj));
+  TESTASSERT(epochs.reclaim() == 0);
+  TESTASSERT(alive == 1);
+
+  // Nested read sections keep the object alive
+  epochs.enter();
+  epochs.exit();
+  TESTASSERT(epochs.reclaim() == 0);
+
+  epochs.exit();
+  TESTASSERT(epochs.reclaim() == 1);
+  TESTASSERT(alive == 0);
+  TESTASSERT(epochs.nof_retired() == 0);
+
+  // Read sections entered after the retire do not delay the reclamation
+  obj.reset(new tracked_obj(alive));
+  epochs.retire(std::move(obj));
+  epochs.enter();
+  TESTASSERT(epochs.reclaim() == 1);
+  epochs.exit();
+  TESTASSERT(alive == 0);
+}
+
+void test_reader_in_other_thread()
+{
+  std::atomic<int>  alive{0};
+  std::atomic<bool> entered{false}, leave{false};
+  epoch_domain      epochs;
+
+  std::unique_ptr<tracked_obj> obj(new tracked_obj(alive));
+
+  std::thread reader([&]() {
+    epoch_read_guard guard(epochs);
+    entered = true;
+    while (not leave) {
+      std::this_thread::yield();
+    }
+  });
+  while (not entered) {
+    std::this_thread::yield();
+  }
+
+  epochs.retire(std::move(obj));
+  TESTASSERT(epochs.reclaim() == 0);
+  leave = true;
+  reader.join();
+  TESTASSERT(epochs.reclaim() == 1);
+  TESTASSERT(alive == 0);
+}
+
+void test_concurrent_readers_and_writer()
+{
+  const uint32_t nof_readers = 4, nof_updates = 20000;
+
+  std::atomic<int>          alive{0};
+  std::atomic<bool>         stop{false};
+  std::atomic<tracked_obj*> shared{new tracked_obj(alive)};
+  epoch_domain              epochs;
+
+  std::vector<std::thread> readers;
+  for (uint32_t i = 0; i < nof_readers; ++i) {
+    readers.emplace_back([&]() {
+      while (not stop.load(std::memory_order_relaxed)) {
+        epoch_read_guard guard(epochs);
+        tracked_obj*     obj = shared.load(std::memory_order_acquire);
+        // The object must not be destroyed while inside the read section
+        TESTASSERT(obj->value.load(std::memory_order_relaxed) == 42);
+      }
+    });
+  }
+
+  for (uint32_t i = 0; i < nof_updates; ++i) {
+    tracked_obj* old = shared.exchange(new tracked_obj(alive), std::memory_order_acq_rel);
+    epochs.retire(std::unique_ptr<tracked_obj>(old));
+    epochs.reclaim();
+  }
+  stop = true;
+  for (std::thread& t : readers) {
+    t.join();
+  }
+
+  epochs.synchronize();
+  TESTASSERT(alive == 1);
+  delete shared.load();
+}
+
+void test_more_threads_than_reader_slots()
+{
+  const uint32_t nof_threads = epoch_domain::max_readers + 8;
+
+  std::atomic<int>  alive{0};
+  std::atomic<bool> leave{false};
+  std::atomic<int>  nof_entered{0};
+  epoch_domain      epochs;
+
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < nof_threads; ++i) {
+    threads.emplace_back([&]() {
+      epoch_read_guard guard(epochs);
+      nof_entered++;
+      while (not leave) {
+        std::this_thread::yield();
+      }
+    });
+  }
+  while (nof_entered < (int)nof_threads) {
+    std::this_thread::yield();
+  }
+
+  epochs.retire(std::unique_ptr<tracked_obj>(new tracked_obj(alive)));
+  TESTASSERT(epochs.reclaim() == 0);
+  leave = true;
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  TESTASSERT(epochs.reclaim() == 1);
+  TESTASSERT(alive == 0);
+}
+
+int main()
+{
+  test_retire_waits_for_readers();
+  test_reader_in_other_thread();
+  test_concurrent_readers_and_writer();
+  test_more_threads_than_reader_slots();
+  printf("Success\n");
+  return 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/ngap_pcap.h"
+#include "srsran/common/pcap_writer.h"
+#include "srsran/common/rlc_pcap.h"
+#include "srsran/common/s1ap_pcap.h"
+#include "srsran/common/test_common.h"
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static std::vector<uint8_t> read_file(const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Parses a classic PCAP file and returns the number of records, or -1 if the file is malformed
+static int count_pcap_records(const std::vector<uint8_t>& file, uint32_t dlt, uint32_t record_len)
+{
+  pcap_hdr_t file_header;
+  if (file.size() < sizeof(file_header)) {
+    return -1;
+  }
+  memcpy(&file_header, file.data(), sizeof(file_header));
+  if (file_header.magic_number != 0xa1b2c3d4 or file_header.network != dlt) {
+    return -1;
+  }
+
+  int    nof_records = 0;
+  size_t offset      = sizeof(file_header);
+  while (offset < file.size()) {
+    pcaprec_hdr_t rec;
+    if (offset + sizeof(rec) > file.size()) {
+      return -1;
+    }
+    memcpy(&rec, file.data() + offset, sizeof(rec));
+    if (rec.incl_len != record_len or rec.orig_len != record_len) {
+      return -1;
+    }
+    offset += sizeof(rec) + rec.incl_len;
+    nof_records++;
+  }
+  return (offset == file.size()) ? nof_records : -1;
+}
+
+// Parses a pcapng file and returns the number of Enhanced Packet Blocks, or -1 if the file is malformed
+static int count_pcapng_records(const std::vector<uint8_t>& file, uint32_t dlt, uint32_t record_len)
+{
+  pcapng_shb_t shb;
+  pcapng_idb_t idb;
+  if (file.size() < sizeof(shb) + sizeof(idb)) {
+    return -1;
+  }
+  memcpy(&shb, file.data(), sizeof(shb));
+  memcpy(&idb, file.data() + sizeof(shb), sizeof(idb));
+  if (shb.block_type != PCAPNG_SHB_TYPE or shb.byte_order_magic != PCAPNG_BYTE_ORDER_MAGIC or
+      idb.block_type != PCAPNG_IDB_TYPE or idb.link_type != dlt) {
+    return -1;
+  }
+
+  int    nof_records = 0;
+  size_t offset      = sizeof(shb) + sizeof(idb);
+  while (offset < file.size()) {
+    pcapng_epb_hdr_t epb;
+    if (offset + sizeof(epb) > file.size()) {
+      return -1;
+    }
+    memcpy(&epb, file.data() + offset, sizeof(epb));
+    uint32_t trailer_len = 0;
+    memcpy(&trailer_len, file.data() + offset + epb.block_total_len - sizeof(uint32_t), sizeof(uint32_t));
+    if (epb.block_type != PCAPNG_EPB_TYPE or epb.cap_len != record_len or epb.block_total_len % 4 != 0 or
+        trailer_len != epb.block_total_len) {
+      return -1;
+    }
+    offset += epb.block_total_len;
+    nof_records++;
+  }
+  return (offset == file.size()) ? nof_records : -1;
+}
+
+static void write_thread_function(srsran::pcap_writer* writer, uint32_t nof_records)
+{
+  std::array<uint8_t, 8>   hdr = {0xde, 0xad, 0xbe, 0xef, 0x00, 0x00, 0x00, 0x00};
+  std::array<uint8_t, 101> pdu = {};
+  pdu.fill(0x5a);
+  for (uint32_t i = 0; i < nof_records; i++) {
+    while (not writer->write(hdr.data(), hdr.size(), pdu.data(), pdu.size())) {
+      // All buffers in flight, give the writer thread some time
+      usleep(100);
+    }
+  }
+}
+
+int multi_thread_test(srsran::pcap_file_format format)
+{
+  const uint32_t nof_threads         = 8;
+  const uint32_t nof_records_per_thr = 2000;
+  const uint32_t record_len          = 8 + 101;
+
+  srsran::pcap_writer_args_t args;
+  args.filename    = (format == srsran::pcap_file_format::pcapng) ? "pcap_writer_test.pcapng" : "pcap_writer_test.pcap";
+  args.dlt         = UDP_DLT;
+  args.format      = format;
+  args.buffer_size = 0; // minimum buffer size
+  args.nof_buffers = 4;
+
+  srsran::pcap_writer writer;
+  TESTASSERT(writer.open(args) == SRSRAN_SUCCESS);
+  TESTASSERT(writer.open(args) != SRSRAN_SUCCESS); // open again will fail
+
+  std::vector<std::thread> writer_threads;
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    writer_threads.emplace_back(write_thread_function, &writer, nof_records_per_thr);
+  }
+  for (std::thread& t : writer_threads) {
+    t.join();
+  }
+
+  TESTASSERT(writer.close() == SRSRAN_SUCCESS);
+  TESTASSERT(writer.close() != SRSRAN_SUCCESS); // closing twice will fail
+
+  std::vector<uint8_t> file = read_file(args.filename);
+  int                  nof_records =
+      (format == srsran::pcap_file_format::pcapng) ? count_pcapng_records(file, UDP_DLT, record_len)
+                                                                     : count_pcap_records(file, UDP_DLT, record_len);
+  TESTASSERT(nof_records == (int)(nof_threads * nof_records_per_thr));
+
+  unlink(args.filename.c_str());
+  return SRSRAN_SUCCESS;
+}
+
+int rotation_test()
+{
+  const uint32_t nof_files   = 3;
+  const uint32_t nof_records = 20000;
+
+  srsran::pcap_writer_args_t args;
+  args.filename      = "pcap_writer_rotation_test.pcap";
+  args.dlt           = NAS_LTE_DLT;
+  args.buffer_size   = 0; // minimum buffer size
+  args.max_file_size = 1;
+  args.max_nof_files = nof_files;
+
+  srsran::pcap_writer writer;
+  TESTASSERT(writer.open(args) == SRSRAN_SUCCESS);
+  write_thread_function(&writer, nof_records);
+  TESTASSERT(writer.close() == SRSRAN_SUCCESS);
+
+  // Every rotated file must be a complete capture on its own
+  const char* filenames[nof_files] = {
+      "pcap_writer_rotation_test.pcap", "pcap_writer_rotation_test.1.pcap", "pcap_writer_rotation_test.2.pcap"};
+  for (const char* filename : filenames) {
+    std::vector<uint8_t> file = read_file(filename);
+    TESTASSERT(count_pcap_records(file, NAS_LTE_DLT, 8 + 101) > 0);
+    unlink(filename);
+  }
+  TESTASSERT(access("pcap_writer_rotation_test.3.pcap", F_OK) != 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+// The protocol writers must not enable themselves when the file can not be created
+static int open_failure_test()
+{
+  const char*             filename = "/nonexistent_dir/pcap_writer_test.pcap";
+  std::array<uint8_t, 16> pdu      = {};
+  srsran::s1ap_pcap       s1ap;
+  srsran::ngap_pcap       ngap;
+  srsran::rlc_pcap        rlc;
+  TESTASSERT(s1ap.open(filename) != SRSRAN_SUCCESS);
+  TESTASSERT(ngap.open(filename) != SRSRAN_SUCCESS);
+  TESTASSERT(rlc.open(filename, srsran::rlc_config_t::default_rlc_am_config()) != SRSRAN_SUCCESS);
+
+  // Writing on a writer that failed to open is ignored
+  s1ap.write_s1ap(pdu.data(), pdu.size());
+  ngap.write_ngap(pdu.data(), pdu.size());
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+
+  TESTASSERT(multi_thread_test(srsran::pcap_file_format::pcap) == SRSRAN_SUCCESS);
+  TESTASSERT(multi_thread_test(srsran::pcap_file_format::pcapng) == SRSRAN_SUCCESS);
+  TESTASSERT(rotation_test() == SRSRAN_SUCCESS);
+  TESTASSERT(open_failure_test() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  srsran::console("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -214,6 +214,47 @@ int test_set_xor_own_set_1()
   return SRSRAN_SUCCESS;
 }
 
+int test_milenage_batch()
+{
+  // Vectors of different subscribers, enough to leave a partially filled group of AES-NI lanes
+  const uint32_t            nof_vectors = 11;
+  uint8_t                   k[nof_vectors][16];
+  uint8_t                   opc[nof_vectors][16];
+  uint8_t                   rand[nof_vectors][16];
+  uint8_t                   sqn[nof_vectors][6];
+  uint8_t                   amf[nof_vectors][2];
+  srsran::milenage_input_t  in[nof_vectors];
+  srsran::milenage_output_t out[nof_vectors];
+  uint32_t                  seed = 1234;
+  for (uint32_t v = 0; v < nof_vectors; v++) {
+    for (uint8_t* field : {k[v], opc[v], rand[v]}) {
+      for (uint32_t i = 0; i < 16; i++) {
+        seed     = seed * 1103515245 + 12345;
+        field[i] = seed >> 24U;
+      }
+    }
+    for (uint32_t i = 0; i < 6; i++) {
+      sqn[v][i] = rand[v][i] ^ k[v][i];
+    }
+    amf[v][0] = 0x80;
+    amf[v][1] = v;
+    in[v]     = {k[v], opc[v], rand[v], sqn[v], amf[v]};
+  }
+  srsran::security_milenage_f12345_batch(in, out, nof_vectors);
+
+  for (uint32_t v = 0; v < nof_vectors; v++) {
+    uint8_t mac_a[8], res[8], ck[16], ik[16], ak[6];
+    TESTASSERT(liblte_security_milenage_f1(k[v], opc[v], rand[v], sqn[v], amf[v], mac_a) == LIBLTE_SUCCESS);
+    TESTASSERT(liblte_security_milenage_f2345(k[v], opc[v], rand[v], res, ck, ik, ak) == LIBLTE_SUCCESS);
+    TESTASSERT(arrcmp(out[v].mac_a, mac_a, sizeof(mac_a)) == 0);
+    TESTASSERT(arrcmp(out[v].res, res, sizeof(res)) == 0);
+    TESTASSERT(arrcmp(out[v].ck, ck, sizeof(ck)) == 0);
+    TESTASSERT(arrcmp(out[v].ik, ik, sizeof(ik)) == 0);
+    TESTASSERT(arrcmp(out[v].ak, ak, sizeof(ak)) == 0);
+  }
+  return SRSRAN_SUCCESS;
+}
+
 int main(int argc, char* argv[])
 {
   auto& logger = srslog::fetch_basic_logger("LOG", false);
@@ -224,5 +265,6 @@ int main(int argc, char* argv[])
 
   TESTASSERT(test_set_2() == SRSRAN_SUCCESS);
   TESTASSERT(test_set_xor_own_set_1() == SRSRAN_SUCCESS);
+  TESTASSERT(test_milenage_batch() == SRSRAN_SUCCESS);
   return SRSRAN_SUCCESS;
 }
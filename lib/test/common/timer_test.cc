@@ -21,6 +21,7 @@
 
 #include "srsran/common/timers.h"
 #include "srsran/support/srsran_test.h"
+#include <chrono>
 #include <iostream>
 #include <random>
 #include <srsran/common/tti_sync_cv.h>
@@ -448,6 +449,102 @@ void timers_test7()
   TESTASSERT(timers.nof_running_timers() == 1 and timers.nof_timers() == 3);
 }
 
+/**
+ * Tests that timers whose duration exceeds the finest wheel level are cascaded down and expire in the exact tic,
+ * including timers that are restarted or stopped while being stored in the upper levels.
+ */
+void timers_test8()
+{
+  timer_handler                           timers;
+  std::mt19937                            rng(0);
+  std::uniform_int_distribution<uint32_t> dist(1, 40000);
+  const size_t                            nof_timers = 200;
+
+  std::vector<unique_timer> t_list;
+  std::vector<uint32_t>     expected_expiry(nof_timers);
+  std::vector<uint32_t>     expiry_tic(nof_timers, 0);
+  uint32_t                  cur_tic = 0;
+  for (size_t i = 0; i < nof_timers; ++i) {
+    t_list.push_back(timers.get_unique_timer());
+    t_list[i].set(dist(rng), [&expiry_tic, &cur_tic, i](uint32_t tid) { expiry_tic[i] = cur_tic; });
+    t_list[i].run();
+    expected_expiry[i] = t_list[i].duration();
+  }
+
+  // restart a third of the timers and stop another third halfway through
+  for (; cur_tic < 20000; ++cur_tic) {
+    if (cur_tic == 10000) {
+      for (size_t i = 0; i < nof_timers; i += 3) {
+        if (t_list[i].is_running()) {
+          t_list[i].run();
+          expected_expiry[i] = cur_tic + t_list[i].duration();
+        }
+      }
+      for (size_t i = 1; i < nof_timers; i += 3) {
+        if (t_list[i].is_running()) {
+          t_list[i].stop();
+          expected_expiry[i] = 0;
+        }
+      }
+    }
+    timers.step_all();
+  }
+  for (; cur_tic < 60000; ++cur_tic) {
+    timers.step_all();
+  }
+
+  for (size_t i = 0; i < nof_timers; ++i) {
+    TESTASSERT(not t_list[i].is_running());
+    if (expected_expiry[i] == 0) {
+      TESTASSERT(not t_list[i].is_expired() and expiry_tic[i] == 0);
+    } else {
+      TESTASSERT(t_list[i].is_expired());
+      TESTASSERT(expiry_tic[i] + 1 == expected_expiry[i]);
+    }
+  }
+  TESTASSERT(timers.nof_running_timers() == 0);
+}
+
+/**
+ * Benchmark of the timer_handler operations with a large number of timers. Measures the average cost of restarting
+ * (run/stop) timers and of step_all() while most timers are running with uniformly distributed durations.
+ */
+void timers_benchmark()
+{
+  timer_handler                           timers(100000);
+  std::mt19937                            rng(0);
+  std::uniform_int_distribution<uint32_t> dist(1, 10000);
+  const size_t                            nof_timers = 50000, nof_tics = 10000;
+
+  std::vector<unique_timer> t_list(nof_timers);
+  uint32_t                  nof_expiries = 0;
+  for (auto& t : t_list) {
+    t = timers.get_unique_timer();
+    t.set(dist(rng), [&nof_expiries](uint32_t tid) { nof_expiries++; });
+  }
+
+  auto tp0 = std::chrono::steady_clock::now();
+  for (auto& t : t_list) {
+    t.run();
+  }
+  for (auto& t : t_list) {
+    t.stop();
+  }
+  for (auto& t : t_list) {
+    t.run();
+  }
+  auto tp1 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < nof_tics; ++i) {
+    timers.step_all();
+  }
+  auto tp2 = std::chrono::steady_clock::now();
+
+  TESTASSERT(nof_expiries == nof_timers and timers.nof_running_timers() == 0);
+  double run_stop_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp1 - tp0).count() / (3.0 * nof_timers);
+  double step_ns     = std::chrono::duration_cast<std::chrono::nanoseconds>(tp2 - tp1).count() / (double)nof_tics;
+  printf("Timer benchmark: %zd timers, %.1f ns per run/stop, %.1f ns per step_all\n", nof_timers, run_stop_ns, step_ns);
+}
+
 int main()
 {
   timers_test1();
@@ -457,6 +554,8 @@ int main()
   timers_test5();
   timers_test6();
   timers_test7();
+  timers_test8();
+  timers_benchmark();
   printf("Success\n");
   return 0;
 }
@@ -0,0 +1,364 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <srsran/common/test_common.h>
+#include <srsran/phy/utils/random.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srsran/srsran.h"
+
+#define MAX_UE 64
+
+static srsran_cell_t cell = {
+    25,                 // nof_prb
+    1,                  // nof_ports
+    1,                  // cell_id
+    SRSRAN_CP_NORM,     // cyclic prefix
+    SRSRAN_PHICH_NORM,  // PHICH length
+    SRSRAN_PHICH_R_1_6, // PHICH resources
+    SRSRAN_FDD,
+};
+
+static uint32_t nof_ue    = 24;
+static uint32_t nof_sf    = 10;
+static uint32_t nof_reps  = 100;
+static float    snr_db    = 20.0f;
+static bool     group_hop = false;
+static bool     spread    = false;
+static bool     dtx       = false;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [cpunrSgsdv]\n", prog);
+  printf("\t-c cell id [Default %d]\n", cell.id);
+  printf("\t-p nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-u Number of UEs [Default %d]\n", nof_ue);
+  printf("\t-n Number of subframes [Default %d]\n", nof_sf);
+  printf("\t-r Number of benchmark repetitions [Default %d]\n", nof_reps);
+  printf("\t-S Signal to Noise Ratio in dB [Default %.2f]\n", snr_db);
+  printf("\t-g Enable group hopping [Default %s]\n", group_hop ? "yes" : "no");
+  printf("\t-s Spread the UEs over different PRB pairs [Default %s]\n", spread ? "yes" : "no");
+  printf("\t-d Let the UEs skip half of their transmissions, to measure false alarms [Default %s]\n",
+         dtx ? "yes" : "no");
+  printf("\t-v [set verbose to debug, default none]\n");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "cpunrSgsdv")) != -1) {
+    switch (opt) {
+      case 'c':
+        cell.id = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'p':
+        cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'u':
+        nof_ue = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        nof_sf = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'r':
+        nof_reps = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'S':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'g':
+        group_hop = true;
+        break;
+      case 's':
+        spread = true;
+        break;
+      case 'd':
+        dtx = true;
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// UEs cycle through ACK only, SR only, CQI only and ACK with SR opportunity
+typedef enum { UE_ACK = 0, UE_SR, UE_CQI, UE_ACK_SR, UE_NOF_TYPES } ue_type_t;
+
+static bool check_result(ue_type_t type, const srsran_uci_value_t* tx, const srsran_pucch_res_t* res)
+{
+  bool ack_ok = res->detected && res->uci_data.ack.valid && res->uci_data.ack.ack_value[0] == tx->ack.ack_value[0];
+  bool sr_ok  = res->uci_data.scheduling_request == tx->scheduling_request;
+  bool cqi_ok = res->detected && res->uci_data.cqi.data_crc &&
+                res->uci_data.cqi.wideband.wideband_cqi == tx->cqi.wideband.wideband_cqi;
+
+  switch (type) {
+    case UE_ACK:
+      return ack_ok;
+    case UE_SR:
+      return sr_ok;
+    case UE_CQI:
+      return cqi_ok;
+    default:
+      return ack_ok && sr_ok;
+  }
+}
+
+// Any UCI reported for a UE that did not transmit
+static bool check_false_alarm(const srsran_pucch_res_t* res)
+{
+  return (res->detected && (res->uci_data.ack.valid || res->uci_data.cqi.data_crc)) ||
+         res->uci_data.scheduling_request;
+}
+
+// Detection and false alarm counters of a receiver
+typedef struct {
+  uint32_t nof_tx;
+  uint32_t nof_errors;
+  uint32_t nof_dtx;
+  uint32_t nof_false_alarms;
+} rx_stats_t;
+
+static void
+rx_stats_add(rx_stats_t* stats, ue_type_t type, bool sent, const srsran_uci_value_t* tx, const srsran_pucch_res_t* res)
+{
+  if (sent) {
+    stats->nof_tx++;
+    stats->nof_errors += check_result(type, tx, res) ? 0 : 1;
+  } else {
+    stats->nof_dtx++;
+    stats->nof_false_alarms += check_false_alarm(res) ? 1 : 0;
+  }
+}
+
+static void rx_stats_print(const char* name, const rx_stats_t* stats)
+{
+  printf("   %s: errors %d/%d (%.2f%%); false alarms %d/%d (%.2f%%)\n",
+         name,
+         stats->nof_errors,
+         stats->nof_tx,
+         100.0f * (float)stats->nof_errors / (float)SRSRAN_MAX(stats->nof_tx, 1),
+         stats->nof_false_alarms,
+         stats->nof_dtx,
+         100.0f * (float)stats->nof_false_alarms / (float)SRSRAN_MAX(stats->nof_dtx, 1));
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  TESTASSERT(nof_ue <= MAX_UE);
+
+  srsran_pucch_cfg_t    cfg[MAX_UE]       = {};
+  srsran_pucch_cfg_t    enb_cfg[MAX_UE]   = {};
+  srsran_pucch_res_t    res[MAX_UE]       = {};
+  srsran_uci_value_t    tx[MAX_UE]        = {};
+  srsran_pucch_t        pucch_ue          = {};
+  srsran_refsignal_ul_t dmrs              = {};
+  srsran_enb_ul_t       enb_ul            = {};
+  srsran_ul_sf_cfg_t    ul_sf             = {};
+  srsran_channel_awgn_t awgn              = {};
+  cf_t                  pucch_dmrs[2 * SRSRAN_NRE * 3];
+  srsran_random_t       random            = srsran_random_init(0x1234);
+  uint64_t              t_single          = 0;
+  uint64_t              t_multi           = 0;
+  int                   ue_ret[MAX_UE]    = {};
+  bool                  sent[MAX_UE]      = {};
+  rx_stats_t            stats_single      = {};
+  rx_stats_t            stats_multi       = {};
+
+  cf_t* buffer     = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB(cell.nof_prb));
+  cf_t* sf_symbols = srsran_vec_cf_malloc(SRSRAN_NOF_RE(cell));
+  cf_t* rx_symbols = srsran_vec_cf_malloc(SRSRAN_NOF_RE(cell));
+  TESTASSERT(buffer && sf_symbols && rx_symbols);
+
+  TESTASSERT(!srsran_pucch_init_ue(&pucch_ue));
+  TESTASSERT(!srsran_pucch_set_cell(&pucch_ue, cell));
+  TESTASSERT(!srsran_refsignal_ul_set_cell(&dmrs, cell));
+
+  srsran_refsignal_dmrs_pusch_cfg_t dmrs_pusch_cfg = {}; // Use default
+  TESTASSERT(!srsran_enb_ul_init(&enb_ul, buffer, cell.nof_prb));
+  TESTASSERT(!srsran_enb_ul_set_cell(&enb_ul, cell, &dmrs_pusch_cfg, NULL));
+
+  TESTASSERT(!srsran_channel_awgn_init(&awgn, 0x1234));
+  TESTASSERT(!srsran_channel_awgn_set_n0(&awgn, -snr_db));
+
+  // Allocate the resources, the UEs with the same format share the PRB pairs unless they are spread. A PRB pair holds 18
+  // format 1 resources with delta_pucch_shift = 2, and 12 format 2 resources
+  uint32_t nof_cqi = (nof_ue + UE_NOF_TYPES - 1 - UE_CQI) / UE_NOF_TYPES;
+  uint32_t step_1  = spread ? 3 * SRSRAN_NRE / 2 : 1;
+  uint32_t step_2  = spread ? SRSRAN_NRE : 2;
+  for (uint32_t i = 0, n1 = 0, n2 = 0; i < nof_ue; i++) {
+    srsran_pucch_cfg_t* c            = &cfg[i];
+    c->delta_pucch_shift             = 2;
+    c->N_cs                          = 0;
+    c->n_rb_2                        = SRSRAN_CEIL(step_2 * nof_cqi, SRSRAN_NRE);
+    c->N_pucch_1                     = 0;
+    c->group_hopping_en              = group_hop;
+    c->rnti                          = 0x46 + i;
+    c->simul_cqi_ack                 = false;
+    c->threshold_format1             = SRSRAN_PUCCH_DEFAULT_THRESHOLD_FORMAT1;
+    c->threshold_data_valid_format1a = SRSRAN_PUCCH_DEFAULT_THRESHOLD_FORMAT1A;
+    c->threshold_data_valid_format2  = SRSRAN_PUCCH_DEFAULT_THRESHOLD_FORMAT2;
+    c->threshold_data_valid_format3  = SRSRAN_PUCCH_DEFAULT_THRESHOLD_FORMAT3;
+    c->threshold_dmrs_detection      = SRSRAN_PUCCH_DEFAULT_THRESHOLD_DMRS;
+    c->threshold_format1_bank        = SRSRAN_PUCCH_DEFAULT_THRESHOLD_FORMAT1_BANK;
+    c->threshold_dmrs_detection_bank = SRSRAN_PUCCH_DEFAULT_THRESHOLD_DMRS_BANK;
+
+    switch ((ue_type_t)(i % UE_NOF_TYPES)) {
+      case UE_ACK:
+        c->uci_cfg.ack[0].nof_acks = 1;
+        c->uci_cfg.ack[0].ncce[0]  = n1;
+        n1 += step_1;
+        break;
+      case UE_SR:
+        c->uci_cfg.is_scheduling_request_tti = true;
+        c->n_pucch_sr                        = n1;
+        n1 += step_1;
+        break;
+      case UE_CQI:
+        c->uci_cfg.cqi.data_enable = true;
+        c->uci_cfg.cqi.type        = SRSRAN_CQI_TYPE_WIDEBAND;
+        c->n_pucch_2               = n2;
+        n2 += step_2;
+        break;
+      default:
+        c->uci_cfg.ack[0].nof_acks           = 1;
+        c->uci_cfg.ack[0].ncce[0]            = n1;
+        c->uci_cfg.is_scheduling_request_tti = true;
+        c->n_pucch_sr                        = n1 + 1;
+        n1 += SRSRAN_MAX(step_1, 2);
+        break;
+    }
+    TESTASSERT(srsran_pucch_cfg_isvalid(c, cell.nof_prb));
+  }
+
+  for (uint32_t sf = 0; sf < nof_sf; sf++) {
+    ul_sf.tti = sf;
+
+    // Generate the signal of every UE over the same grid
+    srsran_vec_cf_zero(rx_symbols, SRSRAN_NOF_RE(cell));
+    for (uint32_t i = 0; i < nof_ue; i++) {
+      ue_type_t          type  = (ue_type_t)(i % UE_NOF_TYPES);
+      srsran_pucch_cfg_t ue_cfg = cfg[i];
+      uint8_t            b[SRSRAN_UCI_MAX_ACK_BITS] = {};
+
+      ZERO_OBJECT(tx[i]);
+      tx[i].ack.ack_value[0]         = (uint8_t)srsran_random_uniform_int_dist(random, 0, 1);
+      tx[i].scheduling_request       = (type == UE_SR || type == UE_ACK_SR) && srsran_random_bool(random, 0.5f);
+      tx[i].cqi.wideband.wideband_cqi = (uint8_t)srsran_random_uniform_int_dist(random, 0, 15);
+
+      // SR opportunities without SR are not transmitted, in DTX mode the UEs also skip half of their transmissions
+      sent[i] = (type != UE_SR || tx[i].scheduling_request) && !(dtx && srsran_random_bool(random, 0.5f));
+      if (!sent[i]) {
+        continue;
+      }
+
+      srsran_ue_ul_pucch_resource_selection(&cell, &ue_cfg, &ue_cfg.uci_cfg, &tx[i], b);
+
+      srsran_vec_cf_zero(sf_symbols, SRSRAN_NOF_RE(cell));
+      TESTASSERT(!srsran_pucch_encode(&pucch_ue, &ul_sf, &ue_cfg, &tx[i], sf_symbols));
+      TESTASSERT(!srsran_refsignal_dmrs_pucch_gen(&dmrs, &ul_sf, &ue_cfg, pucch_dmrs));
+      TESTASSERT(!srsran_refsignal_dmrs_pucch_put(&dmrs, &ue_cfg, pucch_dmrs, sf_symbols));
+      srsran_vec_sum_ccc(rx_symbols, sf_symbols, rx_symbols, SRSRAN_NOF_RE(cell));
+    }
+    srsran_channel_awgn_run_c(&awgn, rx_symbols, rx_symbols, SRSRAN_NOF_RE(cell));
+    srsran_vec_cf_copy(enb_ul.sf_symbols, rx_symbols, SRSRAN_NOF_RE(cell));
+
+    // Decode every UE on its own
+    struct timeval t[3];
+    for (uint32_t r = 0; r < nof_reps; r++) {
+      for (uint32_t i = 0; i < nof_ue; i++) {
+        enb_cfg[i] = cfg[i];
+      }
+      gettimeofday(&t[1], NULL);
+      for (uint32_t i = 0; i < nof_ue; i++) {
+        TESTASSERT(!srsran_enb_ul_get_pucch(&enb_ul, &ul_sf, &enb_cfg[i], &res[i]));
+      }
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      t_single += t[0].tv_usec + t[0].tv_sec * 1000000UL;
+    }
+    for (uint32_t i = 0; i < nof_ue; i++) {
+      INFO("single ue=%d; %s; corr=%.3f", i, srsran_pucch_format_text(enb_cfg[i].format), res[i].correlation);
+      rx_stats_add(&stats_single, (ue_type_t)(i % UE_NOF_TYPES), sent[i], &tx[i], &res[i]);
+    }
+
+    // Decode all the UEs at once
+    for (uint32_t r = 0; r < nof_reps; r++) {
+      for (uint32_t i = 0; i < nof_ue; i++) {
+        enb_cfg[i] = cfg[i];
+      }
+      gettimeofday(&t[1], NULL);
+      TESTASSERT(!srsran_enb_ul_get_pucch_multi(&enb_ul, &ul_sf, enb_cfg, res, ue_ret, nof_ue));
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      t_multi += t[0].tv_usec + t[0].tv_sec * 1000000UL;
+    }
+    for (uint32_t i = 0; i < nof_ue; i++) {
+      INFO("multi ue=%d; %s; corr=%.3f; snr=%+.1f dB",
+           i,
+           srsran_pucch_format_text(enb_cfg[i].format),
+           res[i].correlation,
+           res[i].snr_db);
+      TESTASSERT(ue_ret[i] == SRSRAN_SUCCESS);
+      rx_stats_add(&stats_multi, (ue_type_t)(i % UE_NOF_TYPES), sent[i], &tx[i], &res[i]);
+    }
+  }
+
+  // Number of UEs that fit in the duration of a subframe
+  double ue_sf_single = (double)nof_ue * nof_sf * nof_reps * 1000.0 / (double)SRSRAN_MAX(t_single, 1);
+  double ue_sf_multi  = (double)nof_ue * nof_sf * nof_reps * 1000.0 / (double)SRSRAN_MAX(t_multi, 1);
+  printf("-- PUCCH multi-UE. nof_prb=%d; nof_ue=%d; n_rb_2=%d\n", cell.nof_prb, nof_ue, cfg[0].n_rb_2);
+  printf("   per-UE: %.1f UEs/subframe; batched: %.1f UEs/subframe\n", ue_sf_single, ue_sf_multi);
+  rx_stats_print("per-UE", &stats_single);
+  rx_stats_print("batched", &stats_multi);
+
+  // The batched decoder must never do worse than the per-UE decoder, which does not handle UEs sharing a PRB pair. At
+  // high SNR and without DTX both must be error free when the UEs are spread, the batched one in any case. With DTX the
+  // batched false alarm rate is bounded by the per-UE one or 1%
+  TESTASSERT(stats_multi.nof_errors <= stats_single.nof_errors);
+  if (!dtx && snr_db >= 10.0f) {
+    TESTASSERT(stats_multi.nof_errors == 0);
+    TESTASSERT(!spread || stats_single.nof_errors == 0);
+  }
+  uint32_t max_false_alarms = SRSRAN_MAX(stats_single.nof_false_alarms, stats_multi.nof_dtx / 100);
+  TESTASSERT(stats_multi.nof_false_alarms <= max_false_alarms);
+
+  srsran_pucch_free(&pucch_ue);
+  srsran_enb_ul_free(&enb_ul);
+  srsran_channel_awgn_free(&awgn);
+  srsran_random_free(random);
+  free(buffer);
+  free(sf_symbols);
+  free(rx_symbols);
+
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
@@ -138,7 +138,7 @@ static void benchmark(unsigned num_threads)
 
 int main()
 {
-  for (auto n : {1, 2, 4}) {
+  for (auto n : {1, 2, 4, 8, 16}) {
     benchmark(n);
   }
 
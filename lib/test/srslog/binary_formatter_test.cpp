@@ -0,0 +1,196 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "src/srslog/formatters/binary_formatter.h"
+#include "src/srslog/formatters/binary_log_decoder.h"
+#include "src/srslog/formatters/json_formatter.h"
+#include "src/srslog/formatters/text_formatter.h"
+#include "src/srslog/sinks/mmap_file_sink.h"
+#include "srsran/srslog/detail/log_entry_metadata.h"
+#include "testing_helpers.h"
+#include <numeric>
+
+using namespace srslog;
+
+static constexpr char test_filename[] = "binary_formatter_test.bin";
+
+using arg_store = fmt::dynamic_format_arg_store<fmt::printf_context>;
+
+/// Helper to build a log entry with arguments of all the supported types.
+static detail::log_entry_metadata build_log_entry_metadata(arg_store* store, const char* fmtstring)
+{
+  // Create a time point 50000us from epoch.
+  using tp_ty = std::chrono::time_point<std::chrono::high_resolution_clock>;
+  tp_ty tp(std::chrono::microseconds(50000));
+
+  if (store) {
+    store->push_back(-88);
+    store->push_back(7U);
+    store->push_back(-1234567890123LL);
+    store->push_back(3.25);
+    store->push_back('c');
+    store->push_back("string");
+    store->push_back(std::string("std string"));
+    store->push_back(true);
+  }
+
+  return {tp, {10, true}, fmtstring, store, "ABC", 'Z'};
+}
+
+/// Formats the same entries with the binary and the reference formatter, decodes the binary output and checks that
+/// the result matches the reference output.
+static bool check_roundtrip(log_formatter& reference)
+{
+  binary_formatter   binary;
+  fmt::memory_buffer binary_buffer;
+  fmt::memory_buffer expected;
+
+  const char* fmtstrings[] = {"Text %d %u %lld %.2f %c %s %s %d", "Other %d %x %lld %f %c [%s] [%10s] %d"};
+  for (unsigned i = 0; i != 6; ++i) {
+    const char* fmtstring = fmtstrings[i % 2];
+    arg_store   store1, store2;
+    auto        entry1 = build_log_entry_metadata(&store1, fmtstring);
+    auto        entry2 = build_log_entry_metadata(&store2, fmtstring);
+    if (i == 2) {
+      entry1.hex_dump.resize(40);
+      std::iota(entry1.hex_dump.begin(), entry1.hex_dump.end(), 0);
+      entry2.hex_dump = entry1.hex_dump;
+    }
+    if (i == 3) {
+      // Entry without arguments.
+      entry1.store = entry2.store = nullptr;
+    }
+    binary.format(std::move(entry1), binary_buffer);
+    reference.format(std::move(entry2), expected);
+  }
+
+  fmt::memory_buffer result;
+  binary_log_decoder decoder(reference);
+  long               nof_bytes =
+      decoder.decode_records(reinterpret_cast<const uint8_t*>(binary_buffer.data()), binary_buffer.size(), result);
+
+  ASSERT_EQ(nof_bytes, long(binary_buffer.size()));
+  ASSERT_EQ(decoder.get_nof_entries(), 6);
+  ASSERT_EQ(fmt::to_string(result), fmt::to_string(expected));
+
+  return true;
+}
+
+static bool when_entries_are_decoded_then_text_output_matches_text_formatter()
+{
+  text_formatter reference;
+  return check_roundtrip(reference);
+}
+
+static bool when_entries_are_decoded_then_json_output_matches_json_formatter()
+{
+  json_formatter reference;
+  return check_roundtrip(reference);
+}
+
+static bool when_format_string_is_repeated_then_it_is_only_stored_once()
+{
+  binary_formatter   binary;
+  fmt::memory_buffer first, second;
+
+  arg_store store1, store2;
+  binary.format(build_log_entry_metadata(&store1, "Text %d %u %lld %.2f %c %s %s %d"), first);
+  binary.format(build_log_entry_metadata(&store2, "Text %d %u %lld %.2f %c %s %s %d"), second);
+
+  ASSERT_EQ(second.size() < first.size(), true);
+
+  return true;
+}
+
+namespace {
+DECLARE_METRIC("SNR", snr_t, float, "dB");
+DECLARE_METRIC("PWR", pwr_t, int, "dBm");
+DECLARE_METRIC_SET("RF", rf_set, snr_t, pwr_t);
+DECLARE_METRIC_LIST("Antennas", antenna_list_t, std::vector<rf_set>);
+using ctx_t = srslog::build_context_type<antenna_list_t>;
+} // namespace
+
+static bool when_context_is_decoded_then_output_matches_text_formatter()
+{
+  ctx_t ctx("Context");
+  ctx.get<antenna_list_t>().emplace_back();
+  ctx.at<antenna_list_t>(0).write<snr_t>(5.1);
+  ctx.at<antenna_list_t>(0).write<pwr_t>(-11);
+  ctx.get<antenna_list_t>().emplace_back();
+  ctx.at<antenna_list_t>(1).write<snr_t>(10.1);
+  ctx.at<antenna_list_t>(1).write<pwr_t>(-20);
+
+  binary_formatter   binary;
+  text_formatter     reference;
+  fmt::memory_buffer binary_buffer, expected, result;
+
+  // Context with a log message and context without one.
+  arg_store store1, store2;
+  binary.format_ctx(ctx, build_log_entry_metadata(&store1, "Text %d %u %lld %.2f %c %s %s %d"), binary_buffer);
+  reference.format_ctx(ctx, build_log_entry_metadata(&store2, "Text %d %u %lld %.2f %c %s %s %d"), expected);
+  binary.format_ctx(ctx, build_log_entry_metadata(nullptr, nullptr), binary_buffer);
+  reference.format_ctx(ctx, build_log_entry_metadata(nullptr, nullptr), expected);
+
+  binary_log_decoder decoder(reference);
+  decoder.decode_records(reinterpret_cast<const uint8_t*>(binary_buffer.data()), binary_buffer.size(), result);
+
+  ASSERT_EQ(fmt::to_string(result), fmt::to_string(expected));
+
+  return true;
+}
+
+static bool when_entries_are_written_to_mmap_sink_then_file_is_decoded()
+{
+  const unsigned nof_entries = 20000;
+  {
+    mmap_file_sink sink(test_filename, std::unique_ptr<log_formatter>(new binary_formatter));
+    for (unsigned i = 0; i != nof_entries; ++i) {
+      arg_store          store;
+      fmt::memory_buffer buffer;
+      sink.get_formatter().format(build_log_entry_metadata(&store, "Text %d %u %lld %.2f %c %s %s %d"), buffer);
+      ASSERT_EQ(bool(sink.write({buffer.data(), buffer.size()})), false);
+    }
+    ASSERT_EQ(bool(sink.flush()), false);
+  }
+
+  text_formatter     reference;
+  binary_log_decoder decoder(reference);
+  std::FILE*         out = std::fopen("/dev/null", "w");
+  auto               err = decoder.decode_file(test_filename, out);
+  std::fclose(out);
+  ::remove(test_filename);
+
+  ASSERT_EQ(bool(err), false);
+  ASSERT_EQ(decoder.get_nof_entries(), nof_entries);
+
+  return true;
+}
+
+int main()
+{
+  TEST_FUNCTION(when_entries_are_decoded_then_text_output_matches_text_formatter);
+  TEST_FUNCTION(when_entries_are_decoded_then_json_output_matches_json_formatter);
+  TEST_FUNCTION(when_format_string_is_repeated_then_it_is_only_stored_once);
+  TEST_FUNCTION(when_context_is_decoded_then_output_matches_text_formatter);
+  TEST_FUNCTION(when_entries_are_written_to_mmap_sink_then_file_is_decoded);
+
+  return 0;
+}
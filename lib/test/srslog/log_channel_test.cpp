@@ -22,6 +22,7 @@
 #include "srsran/srslog/log_channel.h"
 #include "test_dummies.h"
 #include "testing_helpers.h"
+#include <thread>
 
 using namespace srslog;
 
@@ -279,6 +280,141 @@ static bool when_logging_with_context_and_message_then_filled_in_log_entry_is_pu
   return true;
 }
 
+static bool when_sampling_is_configured_then_one_in_n_entries_is_pushed()
+{
+  backend_spy              backend;
+  test_dummies::sink_dummy s;
+  log_channel              log("id", s, backend);
+
+  rate_limit_config cfg;
+  cfg.sample_period = 4;
+  log.set_rate_limit(cfg);
+
+  for (unsigned i = 0; i != 100; ++i) {
+    log("test", i);
+  }
+
+  ASSERT_EQ(backend.push_invocation_count(), 25);
+
+  return true;
+}
+
+static bool when_rate_limit_is_exceeded_then_entries_beyond_burst_are_ignored()
+{
+  backend_spy              backend;
+  test_dummies::sink_dummy s;
+  log_channel              log("id", s, backend);
+
+  rate_limit_config cfg;
+  cfg.max_rate = 1;
+  cfg.burst    = 5;
+  log.set_rate_limit(cfg);
+
+  for (unsigned i = 0; i != 100; ++i) {
+    log("test", i);
+  }
+
+  ASSERT_EQ(backend.push_invocation_count(), 5);
+
+  return true;
+}
+
+static bool when_rate_limit_is_per_key_then_each_key_gets_its_own_burst()
+{
+  backend_spy              backend;
+  test_dummies::sink_dummy s;
+  log_channel              log("id", s, backend);
+
+  rate_limit_config cfg;
+  cfg.max_rate = 1;
+  cfg.burst    = 2;
+  cfg.per_key  = true;
+  log.set_rate_limit(cfg);
+
+  for (unsigned i = 0; i != 10; ++i) {
+    log(rate_key{0x46}, "test", i);
+    log(rate_key{0x47}, "test", i);
+  }
+
+  ASSERT_EQ(backend.push_invocation_count(), 4);
+
+  return true;
+}
+
+static bool when_key_table_is_full_then_idle_keys_are_evicted()
+{
+  backend_spy              backend;
+  test_dummies::sink_dummy s;
+  log_channel              log("id", s, backend);
+
+  rate_limit_config cfg;
+  cfg.max_rate = 1000;
+  cfg.burst    = 1;
+  cfg.per_key  = true;
+  log.set_rate_limit(cfg);
+
+  // Fill every probe window of the key table.
+  for (unsigned i = 0; i != 8192; ++i) {
+    log(rate_key{i}, "test", i);
+  }
+
+  // Once the previous keys have been idle for longer than the burst tolerance,
+  // new keys get a slot of their own instead of sharing the channel wide state.
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  unsigned count = backend.push_invocation_count();
+  for (unsigned i = 10000; i != 10100; ++i) {
+    log(rate_key{i}, "test", i);
+  }
+
+  ASSERT_EQ(backend.push_invocation_count(), count + 100);
+
+  return true;
+}
+
+static bool when_entries_are_suppressed_then_summary_is_pushed_after_period()
+{
+  backend_spy              backend;
+  test_dummies::sink_dummy s;
+  log_channel              log("id", s, backend);
+
+  rate_limit_config cfg;
+  cfg.max_rate          = 1;
+  cfg.summary_period_ms = 1;
+  log.set_rate_limit(cfg);
+
+  log("test");
+  log("test");
+  ASSERT_EQ(backend.push_invocation_count(), 1);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  log("test");
+
+  ASSERT_EQ(backend.push_invocation_count(), 2);
+  ASSERT_EQ(std::string(backend.last_entry().metadata.fmtstring).find("Suppressed"), 0);
+
+  return true;
+}
+
+static bool when_rate_limit_is_disabled_then_all_entries_are_pushed()
+{
+  backend_spy              backend;
+  test_dummies::sink_dummy s;
+  log_channel              log("id", s, backend);
+
+  rate_limit_config cfg;
+  cfg.sample_period = 10;
+  log.set_rate_limit(cfg);
+  log.set_rate_limit({});
+
+  for (unsigned i = 0; i != 10; ++i) {
+    log(rate_key{i}, "test", i);
+  }
+
+  ASSERT_EQ(backend.push_invocation_count(), 10);
+
+  return true;
+}
+
 int main()
 {
   TEST_FUNCTION(when_log_channel_is_created_then_id_matches_expected_value);
@@ -291,6 +427,12 @@ int main()
   TEST_FUNCTION(when_hex_array_length_is_less_than_hex_log_max_size_then_array_length_is_used);
   TEST_FUNCTION(when_logging_with_context_then_filled_in_log_entry_is_pushed_into_the_backend);
   TEST_FUNCTION(when_logging_with_context_and_message_then_filled_in_log_entry_is_pushed_into_the_backend);
+  TEST_FUNCTION(when_sampling_is_configured_then_one_in_n_entries_is_pushed);
+  TEST_FUNCTION(when_rate_limit_is_exceeded_then_entries_beyond_burst_are_ignored);
+  TEST_FUNCTION(when_rate_limit_is_per_key_then_each_key_gets_its_own_burst);
+  TEST_FUNCTION(when_key_table_is_full_then_idle_keys_are_evicted);
+  TEST_FUNCTION(when_entries_are_suppressed_then_summary_is_pushed_after_period);
+  TEST_FUNCTION(when_rate_limit_is_disabled_then_all_entries_are_pushed);
 
   return 0;
 }
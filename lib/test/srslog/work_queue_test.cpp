@@ -0,0 +1,238 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/srslog/detail/support/work_queue.h"
+#include "testing_helpers.h"
+#include <thread>
+
+using namespace srslog;
+
+namespace {
+
+/// Test element ordered by the value of its key.
+struct keyed_item {
+  uint64_t key;
+  unsigned producer;
+};
+
+} // namespace
+
+namespace srslog {
+namespace detail {
+
+template <>
+struct work_queue_traits<keyed_item> {
+  static uint64_t order_key(const keyed_item& item) { return item.key; }
+};
+
+} // namespace detail
+} // namespace srslog
+
+static bool when_queue_is_empty_then_pop_fails()
+{
+  detail::work_queue<int, 4> queue;
+
+  ASSERT_EQ(queue.try_pop().first, false);
+  ASSERT_EQ(queue.get_nof_producers(), 0);
+
+  return true;
+}
+
+static bool when_producer_queue_is_full_then_push_fails_and_drop_is_counted()
+{
+  detail::work_queue<int, 4> queue;
+
+  for (int i = 0; i != 4; ++i) {
+    ASSERT_EQ(queue.push(i), true);
+  }
+  ASSERT_EQ(queue.is_almost_full(), true);
+  ASSERT_EQ(queue.push(4), false);
+  ASSERT_EQ(queue.push(5), false);
+  ASSERT_EQ(queue.get_nof_dropped(), 2);
+
+  // Entries of a single producer keep their order.
+  for (int i = 0; i != 4; ++i) {
+    auto item = queue.try_pop();
+    ASSERT_EQ(item.first, true);
+    ASSERT_EQ(item.second, i);
+  }
+  ASSERT_EQ(queue.try_pop().first, false);
+  ASSERT_EQ(queue.push(6), true);
+
+  return true;
+}
+
+static bool when_single_producer_pushes_then_it_can_use_the_whole_capacity()
+{
+  detail::work_queue<int, 256> queue;
+
+  for (int i = 0; i != 256; ++i) {
+    ASSERT_EQ(queue.push(i), true);
+  }
+  ASSERT_EQ(queue.push(256), false);
+
+  // Drain the queue twice to check that the blocks are recycled.
+  for (int round = 0; round != 2; ++round) {
+    for (int i = 0; i != 256; ++i) {
+      auto item = queue.try_pop();
+      ASSERT_EQ(item.first, true);
+    }
+    ASSERT_EQ(queue.try_pop().first, false);
+    for (int i = 0; i != 256; ++i) {
+      ASSERT_EQ(queue.push(i), true);
+    }
+  }
+  ASSERT_EQ(queue.get_nof_dropped(), 1);
+
+  return true;
+}
+
+static bool when_producer_switches_queues_then_it_keeps_its_slots()
+{
+  detail::work_queue<int, 16> queue_a;
+  detail::work_queue<int, 16> queue_b;
+
+  std::thread t([&queue_a, &queue_b]() {
+    for (int i = 0; i != 8; ++i) {
+      queue_a.push(i);
+      queue_b.push(i);
+    }
+  });
+  t.join();
+  ASSERT_EQ(queue_a.get_nof_producers(), 1);
+  ASSERT_EQ(queue_b.get_nof_producers(), 1);
+
+  for (int i = 0; i != 8; ++i) {
+    ASSERT_EQ(queue_a.try_pop().second, i);
+    ASSERT_EQ(queue_b.try_pop().second, i);
+  }
+
+  return true;
+}
+
+static bool when_multiple_producers_push_then_entries_are_merged_in_key_order()
+{
+  detail::work_queue<keyed_item, 64> queue;
+
+  // Each producer pushes interleaved keys: producer p pushes p, p + 4, p + 8...
+  const unsigned           nof_producers = 4, nof_items = 16;
+  std::atomic<unsigned>    nof_pushed{0};
+  std::vector<std::thread> producers;
+  for (unsigned p = 0; p != nof_producers; ++p) {
+    producers.emplace_back([&queue, &nof_pushed, p]() {
+      for (unsigned i = 0; i != nof_items; ++i) {
+        queue.push(keyed_item{i * nof_producers + p, p});
+      }
+      // Keep the thread alive until all producers have pushed, so that each one gets its own queue.
+      nof_pushed.fetch_add(1);
+      while (nof_pushed.load() != nof_producers) {
+        std::this_thread::yield();
+      }
+    });
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+  ASSERT_EQ(queue.get_nof_producers(), nof_producers);
+
+  for (uint64_t expected = 0; expected != nof_producers * nof_items; ++expected) {
+    auto item = queue.try_pop();
+    ASSERT_EQ(item.first, true);
+    ASSERT_EQ(item.second.key, expected);
+  }
+  ASSERT_EQ(queue.try_pop().first, false);
+
+  return true;
+}
+
+static bool when_producer_thread_terminates_then_its_queue_is_reused()
+{
+  detail::work_queue<int, 16> queue;
+
+  for (unsigned i = 0; i != 8; ++i) {
+    std::thread t([&queue, i]() { queue.push(i); });
+    t.join();
+  }
+  ASSERT_EQ(queue.get_nof_producers(), 1);
+
+  for (int i = 0; i != 8; ++i) {
+    auto item = queue.try_pop();
+    ASSERT_EQ(item.first, true);
+    ASSERT_EQ(item.second, i);
+  }
+
+  return true;
+}
+
+static bool when_consumer_runs_concurrently_then_no_entries_are_lost()
+{
+  detail::work_queue<keyed_item, 128> queue;
+
+  const unsigned        nof_producers = 8, nof_items = 20000;
+  std::atomic<unsigned> nof_finished{0};
+  std::vector<uint64_t> last_key(nof_producers, 0);
+  unsigned              nof_popped = 0;
+
+  std::vector<std::thread> producers;
+  for (unsigned p = 0; p != nof_producers; ++p) {
+    producers.emplace_back([&queue, &nof_finished, p]() {
+      for (unsigned i = 1; i <= nof_items;) {
+        if (queue.push(keyed_item{i, p})) {
+          ++i;
+        }
+      }
+      nof_finished.fetch_add(1);
+    });
+  }
+
+  bool in_order = true;
+  while (nof_finished.load() != nof_producers or nof_popped != nof_producers * nof_items) {
+    auto item = queue.try_pop();
+    if (!item.first) {
+      continue;
+    }
+    in_order &= (item.second.key == last_key[item.second.producer] + 1);
+    last_key[item.second.producer] = item.second.key;
+    ++nof_popped;
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+
+  ASSERT_EQ(in_order, true);
+  ASSERT_EQ(nof_popped, nof_producers * nof_items);
+  ASSERT_EQ(queue.try_pop().first, false);
+
+  return true;
+}
+
+int main()
+{
+  TEST_FUNCTION(when_queue_is_empty_then_pop_fails);
+  TEST_FUNCTION(when_producer_queue_is_full_then_push_fails_and_drop_is_counted);
+  TEST_FUNCTION(when_single_producer_pushes_then_it_can_use_the_whole_capacity);
+  TEST_FUNCTION(when_producer_switches_queues_then_it_keeps_its_slots);
+  TEST_FUNCTION(when_multiple_producers_push_then_entries_are_merged_in_key_order);
+  TEST_FUNCTION(when_producer_thread_terminates_then_its_queue_is_reused);
+  TEST_FUNCTION(when_consumer_runs_concurrently_then_no_entries_are_lost);
+
+  return 0;
+}
@@ -0,0 +1,173 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSENB_RNTI_RCU_MAP_H
+#define SRSENB_RNTI_RCU_MAP_H
+
+#include "common_enb.h"
+#include "rnti_pool.h"
+#include "srsran/common/epoch_domain.h"
+#include "srsran/support/srsran_assert.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+
+namespace srsenb {
+
+/**
+ * RNTI-indexed flat table of UE objects for the hot path of the lower layers.
+ *
+ * Lookups index a fixed array of atomic pointers by rnti, as rnti_map_t does, and must be done inside a read section
+ * (see read_guard). Read sections do not write to any shared cache line, so any number of PHY workers can access the
+ * table concurrently without contending on a lock. Insertions and removals are serialized among themselves, and a
+ * removed UE is only destroyed once all the read sections that could still be using it have finished.
+ */
+template <typename UEObject, size_t N = SRSENB_MAX_UES>
+class rnti_rcu_map
+{
+  struct node {
+    node(uint16_t rnti_, unique_rnti_ptr<UEObject> obj_) : rnti(rnti_), obj(std::move(obj_)) {}
+    const uint16_t            rnti;
+    unique_rnti_ptr<UEObject> obj;
+  };
+
+public:
+  /// Scoped read section. UE pointers obtained from the map remain valid until the guard is destroyed.
+  class read_guard
+  {
+  public:
+    explicit read_guard(rnti_rcu_map& map) : guard(map.epochs) {}
+
+  private:
+    srsran::epoch_read_guard guard;
+  };
+
+  rnti_rcu_map() = default;
+  ~rnti_rcu_map() { clear(); }
+
+  rnti_rcu_map(const rnti_rcu_map&) = delete;
+  rnti_rcu_map& operator=(const rnti_rcu_map&) = delete;
+
+  /// Returns the UE with the given rnti or nullptr if it does not exist.
+  UEObject* find(uint16_t rnti) const
+  {
+    node* n = slots[rnti % N].load(std::memory_order_acquire);
+    return (n != nullptr and n->rnti == rnti) ? n->obj.get() : nullptr;
+  }
+
+  bool contains(uint16_t rnti) const { return find(rnti) != nullptr; }
+
+  UEObject* operator[](uint16_t rnti) const
+  {
+    UEObject* obj = find(rnti);
+    srsran_assert(obj != nullptr, "rnti=0x%x not found in UE table", rnti);
+    return obj;
+  }
+
+  /// Calls f(rnti, ue) for every UE in the table.
+  template <typename F>
+  void for_each(F&& f) const
+  {
+    for (const std::atomic<node*>& slot : slots) {
+      node* n = slot.load(std::memory_order_acquire);
+      if (n != nullptr) {
+        f(n->rnti, *n->obj);
+      }
+    }
+  }
+
+  size_t size() const { return count.load(std::memory_order_relaxed); }
+  bool   empty() const { return size() == 0; }
+  bool   full() const { return size() == N; }
+
+  /// Returns true if the slot of the given rnti is free.
+  bool has_space(uint16_t rnti) const { return slots[rnti % N].load(std::memory_order_acquire) == nullptr; }
+
+  /// Adds a UE to the table. Returns nullptr if the slot of the rnti is already taken.
+  UEObject* insert(uint16_t rnti, unique_rnti_ptr<UEObject> obj)
+  {
+    UEObject* ret = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(writer_mutex);
+      std::atomic<node*>&         slot = slots[rnti % N];
+      if (slot.load(std::memory_order_relaxed) == nullptr) {
+        node* n = new node(rnti, std::move(obj));
+        ret     = n->obj.get();
+        slot.store(n, std::memory_order_release);
+        count.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    epochs.reclaim();
+    return ret;
+  }
+
+  /// Unlinks a UE from the table. The object is destroyed once no read section can reference it anymore.
+  bool erase(uint16_t rnti)
+  {
+    bool ret = false;
+    {
+      std::lock_guard<std::mutex> lock(writer_mutex);
+      std::atomic<node*>&         slot = slots[rnti % N];
+      node*                       n    = slot.load(std::memory_order_relaxed);
+      if (n != nullptr and n->rnti == rnti) {
+        slot.store(nullptr, std::memory_order_release);
+        count.fetch_sub(1, std::memory_order_relaxed);
+        epochs.retire(std::unique_ptr<node>(n));
+        ret = true;
+      }
+    }
+    epochs.reclaim();
+    return ret;
+  }
+
+  /// Removes all the UEs and waits until they are destroyed.
+  /// NOTE: Must not be called from inside a read section.
+  void clear()
+  {
+    {
+      std::lock_guard<std::mutex> lock(writer_mutex);
+      for (std::atomic<node*>& slot : slots) {
+        node* n = slot.exchange(nullptr, std::memory_order_acq_rel);
+        if (n != nullptr) {
+          epochs.retire(std::unique_ptr<node>(n));
+        }
+      }
+      count.store(0, std::memory_order_relaxed);
+    }
+    epochs.synchronize();
+  }
+
+  /// Destroys the removed UEs whose grace period has elapsed.
+  void reclaim() { epochs.reclaim(); }
+
+  /// Number of removed UEs still waiting to be destroyed.
+  size_t nof_pending_removals() const { return epochs.nof_retired(); }
+
+private:
+  std::array<std::atomic<node*>, N> slots = {};
+  std::atomic<size_t>               count{0};
+  std::mutex                        writer_mutex;
+  mutable srsran::epoch_domain      epochs;
+};
+
+} // namespace srsenb
+
+#endif // SRSENB_RNTI_RCU_MAP_H
@@ -84,6 +84,7 @@ struct log_args_t {
   int         all_hex_limit;
   int         file_max_size;
   std::string filename;
+  bool        binary;
 };
 
 struct gui_args_t {
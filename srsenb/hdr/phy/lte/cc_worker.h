@@ -77,6 +77,7 @@ private:
   int  encode_pdcch_dl(stack_interface_phy_lte::dl_sched_grant_t* grants, uint32_t nof_grants);
   int  encode_pdcch_ul(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_grants);
   int  decode_pucch();
+  int  decode_srs();
 
   /* Common objects */
   srslog::basic_logger& logger;
@@ -95,6 +96,22 @@ private:
 
   srsran_softbuffer_tx_t temp_mbsfn_softbuffer = {};
 
+  // Users with PUCCH in the current subframe, reused across subframes
+  std::vector<uint16_t>           pucch_rnti;
+  std::vector<srsran_pucch_cfg_t> pucch_cfg;
+  std::vector<srsran_pucch_res_t> pucch_res;
+  std::vector<int>                pucch_ret;
+
+  // PDSCH grants of the current subframe, reused across subframes
+  std::vector<uint32_t>            pdsch_grant_idx;
+  std::vector<srsran_dl_cfg_t>     pdsch_cfg;
+  std::vector<srsran_pdsch_cfg_t*> pdsch_cfg_ptr;
+
+  // Users with SRS in the current subframe, reused across subframes
+  std::vector<uint16_t>                   srs_rnti;
+  std::vector<srsran_refsignal_srs_cfg_t> srs_cfg;
+  std::vector<srsran_chest_ul_srs_res_t>  srs_res;
+
   // Class to store user information
   class ue
   {
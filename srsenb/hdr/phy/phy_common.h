@@ -24,6 +24,7 @@
 
 #include "phy_interfaces.h"
 #include "srsenb/hdr/phy/phy_ue_db.h"
+#include "srsran/adt/circular_array.h"
 #include "srsran/common/gen_mch_tables.h"
 #include "srsran/common/interfaces_common.h"
 #include "srsran/common/standard_streams.h"
@@ -190,6 +191,15 @@ public:
     return c;
   }
 
+  srsran_chest_ul_estimator_alg_t get_cell_pusch_estimator(uint32_t cc_idx)
+  {
+    srsran_chest_ul_estimator_alg_t alg = SRSRAN_CHEST_UL_ESTIMATOR_ALG_AVERAGE;
+    if (cc_idx < cell_list_lte.size()) {
+      alg = cell_list_lte[cc_idx].pusch_estimator_alg;
+    }
+    return alg;
+  }
+
   void set_cell_measure_trigger()
   {
     // Trigger on LTE cell
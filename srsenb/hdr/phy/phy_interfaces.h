@@ -33,15 +33,16 @@
 namespace srsenb {
 
 struct phy_cell_cfg_t {
-  srsran_cell_t cell;
-  uint32_t      rf_port;
-  uint32_t      cell_id;
-  double        dl_freq_hz;
-  double        ul_freq_hz;
-  uint32_t      root_seq_idx;
-  uint32_t      num_ra_preambles;
-  float         gain_db;
-  bool          dl_measure;
+  srsran_cell_t                   cell;
+  uint32_t                        rf_port;
+  uint32_t                        cell_id;
+  double                          dl_freq_hz;
+  double                          ul_freq_hz;
+  uint32_t                        root_seq_idx;
+  uint32_t                        num_ra_preambles;
+  float                           gain_db;
+  bool                            dl_measure;
+  srsran_chest_ul_estimator_alg_t pusch_estimator_alg;
 };
 
 typedef std::vector<phy_cell_cfg_t> phy_cell_cfg_list_t;
@@ -64,6 +65,7 @@ struct phy_args_t {
   uint32_t                pusch_max_its       = 10;
   uint32_t                nr_pusch_max_its    = 10;
   bool                    pusch_8bit_decoder  = false;
+  uint32_t                pdsch_seq_cache_kb  = 0;
   float                   tx_amplitude        = 1.0f;
   uint32_t                nof_phy_threads     = 1;
   std::string             equalizer_mode      = "mmse";
@@ -25,9 +25,11 @@
 #include "phy_interfaces.h"
 #include "srsran/interfaces/enb_mac_interfaces.h"
 #include "srsran/interfaces/enb_phy_interfaces.h"
-#include <map>
+#include "srsran/common/epoch_domain.h"
+#include <atomic>
+#include <memory>
 #include <mutex>
-#include <srsran/adt/circular_array.h>
+#include <vector>
 
 namespace srsenb {
 
@@ -72,6 +74,13 @@ private:
    *       |                                         +---------------------------------+ |
    *       |       Remove SCell configuration                                            |
    *       +-----------------------------------------------------------------------------+
+   *
+   * Concurrency
+   * -----------
+   * The stack modifies the database (addmod_rnti, rem_rnti, complete_config and activate_deactivate_scell) by building
+   * a new copy of the UE configuration or of the UE table and publishing it atomically. The PHY workers read the
+   * published snapshot without taking any lock, and replaced objects are only destroyed once no worker can be using
+   * them. The per TTI HARQ-ACK, UL grant and UCI state is kept in per-UE atomics written by the PHY workers.
    */
   typedef enum {
     cell_state_none = 0,           ///< Uninitialized
@@ -81,37 +90,75 @@ private:
   } cell_state_t;
 
   /**
-   * Cell information for the UE database
+   * Cell configuration for the UE database
    */
   struct cell_info_t {
-    cell_state_t state      = cell_state_none; ///< Configuration state
-    uint32_t     enb_cc_idx = 0;               ///< Corresponding eNb cell/carrier index
-    uint8_t      last_ri    = 0;               ///< Last reported rank indicator
-    srsran::circular_array<srsran_ra_tb_t, SRSRAN_MAX_HARQ_PROC> last_tb =
-        {}; ///< Stores last PUSCH Resource allocation
-    bool                                    stash_use_tbs_index_alt = false;
-    srsran::phy_cfg_t                       phy_cfg;            ///< Configuration, it has a default constructor
-    srsran::circular_array<bool, TTIMOD_SZ> is_grant_available; ///< Indicates whether there is an available grant
+    cell_state_t      state                   = cell_state_none; ///< Configuration state
+    uint32_t          enb_cc_idx              = 0;               ///< Corresponding eNb cell/carrier index
+    bool              stash_use_tbs_index_alt = false;
+    srsran::phy_cfg_t phy_cfg; ///< Configuration, it has a default constructor
+  };
+
+  /**
+   * UE configuration snapshot. It is published by the stack and never modified afterwards, a reconfiguration builds and
+   * publishes a new copy. PHY workers read it without locking.
+   */
+  struct ue_config_t {
+    bool                                         stashed_multiple_csi_request_enabled = false;
+    std::array<cell_info_t, SRSRAN_MAX_CARRIERS> cell_info = {}; ///< Cell information, indexed by ue_cc_idx
   };
 
   /**
-   * UE object stored in the PHY common database
+   * Pending PDSCH acknowledgements of a UE for a given TTI. Every field is packed in a single word so that the PHY
+   * workers can set and read them without locking.
+   */
+  struct pending_ack_t {
+    std::atomic<uint32_t>                                  common = {}; ///< TM, number of active carriers, PUCCH mode
+    std::array<std::atomic<uint32_t>, SRSRAN_MAX_CARRIERS> cc     = {}; ///< Scheduled PDSCH, indexed by ue_cc_idx
+  };
+
+  /**
+   * Last PUSCH resource allocation of a UE carrier and HARQ process, protected by a sequence counter
+   */
+  struct last_tb_t {
+    std::atomic<uint32_t> seq = {};
+    std::atomic<uint64_t> tbs = {}; ///< TBS and number of bits
+    std::atomic<uint64_t> aux = {}; ///< Modulation, RV, codeword index, enabled and MCS
+  };
+
+  /**
+   * UE object stored in the PHY common database. The configuration is swapped by the stack, the rest of the fields is
+   * HARQ-ACK and UCI bookkeeping updated by the PHY workers.
    */
   struct common_ue {
-    bool                                                  stashed_multiple_csi_request_enabled = false;
-    srsran::circular_array<srsran_pdsch_ack_t, TTIMOD_SZ> pdsch_ack = {}; ///< Pending acknowledgements for this Cell
-    std::array<cell_info_t, SRSRAN_MAX_CARRIERS>          cell_info = {}; ///< Cell information, indexed by ue_cell_idx
+    explicit common_ue(uint16_t rnti_) : rnti(rnti_) {}
+    ~common_ue() { delete config.load(std::memory_order_relaxed); }
+
+    const uint16_t                                         rnti;
+    std::atomic<const ue_config_t*>                        config = {nullptr}; ///< Current configuration snapshot
+    std::array<pending_ack_t, TTIMOD_SZ>                   pdsch_ack;          ///< Pending acknowledgements
+    std::array<std::atomic<uint32_t>, TTIMOD_SZ>           ul_grant_mask = {}; ///< UE carriers with an UL grant
+    std::array<std::atomic<uint8_t>, SRSRAN_MAX_CARRIERS> last_ri       = {}; ///< Last reported rank indicator
+    std::array<std::array<last_tb_t, SRSRAN_MAX_HARQ_PROC>, SRSRAN_MAX_CARRIERS> last_tb; ///< Last PUSCH allocation
+  };
+
+  /**
+   * UE database, sorted by RNTI. The table is immutable and it is replaced as a whole when a UE is added or removed
+   */
+  struct ue_table_t {
+    std::vector<common_ue*> ues;
   };
+  std::atomic<const ue_table_t*> table;
 
   /**
-   * UE database indexed by RNTI
+   * Defers the destruction of replaced tables, configurations and removed UEs until no PHY worker uses them
    */
-  std::map<uint16_t, common_ue> ue_db;
+  mutable srsran::epoch_domain epochs;
 
   /**
-   * Concurrency protection mutex, allowed modifications from const methods.
+   * Serializes the stack calls that modify the database, it is never taken by the PHY workers
    */
-  mutable std::mutex mutex;
+  std::mutex writer_mutex;
 
   /**
    * Stack interface
@@ -129,20 +176,51 @@ private:
   const phy_cell_cfg_list_t* cell_cfg_list = nullptr;
 
   /**
-   * Internal RNTI addition, it is not thread safe protected
+   * Configuration used for non-user RNTIs
+   */
+  srsran::phy_cfg_t default_cfg = {};
+
+  /**
+   * Finds a UE in the current table, it must be called inside a read section
    *
    * @param rnti identifier of the UE
-   * @return SRSRAN_SUCCESS if the RNTI is not duplicated and is added successfully, SRSRAN_ERROR code if it exists
+   * @return the UE object or nullptr if the RNTI does not exist
    */
-  inline int _add_rnti(uint16_t rnti);
+  inline common_ue* _find_ue(uint16_t rnti) const;
 
   /**
-   * Internal pending ACK clear for a given RNTI and TTI, it is not thread safe protected
+   * Builds and publishes a new table from the current one, adding and/or removing a UE. Requires the writer mutex.
    *
-   * @param tti is the given TTI (requires assertion prior to call)
-   * @param rnti identifier of the UE (requires assertion prior to call)
+   * @param add UE to insert, or nullptr
+   * @param rem UE to remove, or nullptr. It is destroyed once no PHY worker can reference it
    */
-  inline void _clear_tti_pending_rnti(uint32_t tti, uint16_t rnti);
+  void _publish_table(common_ue* add, common_ue* rem);
+
+  /**
+   * Publishes a new configuration for a UE and retires the previous one. Requires the writer mutex.
+   *
+   * @param ue the UE object
+   * @param cfg the new configuration
+   */
+  void _publish_config(common_ue& ue, std::unique_ptr<ue_config_t> cfg);
+
+  /**
+   * Internal pending ACK clear for a given UE and TTI
+   *
+   * @param ue the UE object
+   * @param cfg current configuration of the UE
+   * @param tti is the given TTI
+   */
+  static void _clear_tti_pending(common_ue& ue, const ue_config_t& cfg, uint32_t tti);
+
+  /**
+   * Unpacks the pending ACK of a given UE and TTI
+   *
+   * @param ue the UE object
+   * @param tti is the given TTI
+   * @param[out] pdsch_ack the pending acknowledgements
+   */
+  static void _get_tti_pending(const common_ue& ue, uint32_t tti, srsran_pdsch_ack_t& pdsch_ack);
 
   /**
    * Helper method to set the constant attributes of a given RNTI after the configuration is set, it does not modify
@@ -154,14 +232,14 @@ private:
   inline void _set_common_config_rnti(uint16_t rnti, srsran::phy_cfg_t& phy_cfg) const;
 
   /**
-   * Gets the SCell index for a given RNTI and a eNb cell/carrier. It returns the SCell index (0 if PCell) if the cc_idx
-   * is found among the configured cells/carriers. Otherwise, it returns SRSRAN_MAX_CARRIERS.
+   * Gets the SCell index for a given UE configuration and a eNb cell/carrier. It returns the SCell index (0 if PCell)
+   * if the cc_idx is found among the active cells/carriers. Otherwise, it returns SRSRAN_MAX_CARRIERS.
    *
-   * @param rnti identifier of the UE (requires assertion prior to call)
+   * @param cfg the UE configuration
    * @param enb_cc_idx the eNb cell/carrier index to look for in the RNTI.
    * @return the SCell index as described above.
    */
-  inline uint32_t _get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) const;
+  static inline uint32_t _get_ue_cc_idx(const ue_config_t& cfg, uint32_t enb_cc_idx);
 
   /**
    * Gets the eNb Cell/Carrier index in which the UCI shall be carried. This corresponds to the serving cell with lowest
@@ -170,49 +248,19 @@ private:
    * If no grant is available in the indicated TTI, it returns the number of the eNb Cells/Carriers.
    *
    * @param tti The UL processing TTI
-   * @param rnti Temporal UE ID
+   * @param ue the UE object
+   * @param cfg current configuration of the UE
    * @return the eNb Cell/Carrier with lowest serving cell index that has an UL grant
    */
-  uint32_t _get_uci_enb_cc_idx(uint32_t tti, uint16_t rnti) const;
-
-  /**
-   * Checks if a given RNTI exists in the database
-   * @param rnti provides UE identifier
-   * @return SRSRAN_SUCCESS if the indicated RNTI exists, otherwise it returns SRSRAN_ERROR
-   */
-  inline int _assert_rnti(uint16_t rnti) const;
+  uint32_t _get_uci_enb_cc_idx(uint32_t tti, const common_ue& ue, const ue_config_t& cfg) const;
 
   /**
-   * Checks if an RNTI is configured to use an specified eNb cell/carrier as PCell or SCell
-   * @param rnti provides UE identifier
-   * @param enb_cc_idx provides eNb cell/carrier
-   * @return SRSRAN_SUCCESS if the indicated RNTI exists, otherwise it returns SRSRAN_ERROR
-   */
-  inline int _assert_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const;
-
-  /**
-   * Checks if an RNTI uses a given eNb cell/carrier as PCell
-   * @param rnti provides UE identifier
-   * @param enb_cc_idx provides eNb cell/carrier index
-   * @return SRSRAN_SUCCESS if the indicated eNb cell/carrier of the RNTI is a PCell, otherwise it returns SRSRAN_ERROR
-   */
-  inline int _assert_enb_pcell(uint16_t rnti, uint32_t enb_cc_idx) const;
-
-  /**
-   * Checks if an RNTI is configured to use an specified UE cell/carrier as PCell or SCell
-   * @param rnti provides UE identifier
+   * Checks if a UE cell/carrier index is configured as PCell or SCell
+   * @param cfg the UE configuration
    * @param ue_cc_idx UE cell/carrier index that is asserted
    * @return SRSRAN_SUCCESS if the indicated cell/carrier index is valid, otherwise it returns SRSRAN_ERROR
    */
-  inline int _assert_ue_cc(uint16_t rnti, uint32_t ue_cc_idx) const;
-
-  /**
-   * Checks if an RNTI is configured to use an specified eNb cell/carrier as PCell or SCell and it is active
-   * @param rnti provides UE identifier
-   * @param enb_cc_idx UE cell/carrier index that is asserted
-   * @return SRSRAN_SUCCESS if the indicated eNb cell/carrier is active, otherwise it returns SRSRAN_ERROR
-   */
-  inline int _assert_active_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const;
+  static inline int _assert_ue_cc(const ue_config_t& cfg, uint32_t ue_cc_idx);
 
   /**
    * Internal eNb stack assertion
@@ -227,24 +275,45 @@ private:
   inline int _assert_cell_list_cfg() const;
 
   /**
-   * Internal eNb general configuration getter, returns default configuration if the UE does not exist in the given cell
+   * Internal eNb configuration getter for an active cell of a user RNTI, it must be called inside a read section
    *
    * @param rnti provides UE identifier
    * @param enb_cc_idx eNb cell index
-   * @param[out] phy_cfg The PHY configuration of the indicated UE for the indicated eNb carrier/call index.
-   * @return SRSRAN_SUCCESS if provided context is correct, SRSRAN_ERROR code otherwise
+   * @param[out] ue the UE object
+   * @param[out] ue_cc_idx the UE cell/carrier index
+   * @return The UE configuration, or nullptr if the RNTI does not exist or the cell is not active
    */
-  inline int _get_rnti_config(uint16_t rnti, uint32_t enb_cc_idx, srsran::phy_cfg_t& phy_cfg) const;
+  inline const ue_config_t*
+  _get_rnti_config(uint16_t rnti, uint32_t enb_cc_idx, common_ue*& ue, uint32_t& ue_cc_idx) const;
 
   /**
    * Count number of configured secondary serving cells
    *
-   * @param rnti provides UE identifier
+   * @param cfg the UE configuration
    * @return The number of configured secondary cells
    */
-  inline uint32_t _count_nof_configured_scell(uint16_t rnti);
+  static inline uint32_t _count_nof_configured_scell(const ue_config_t& cfg);
 
 public:
+  /**
+   * Scoped read section of the database. The methods below open their own section, holding an outer one for the whole
+   * TTI makes the nested sections almost free.
+   */
+  class read_guard
+  {
+  public:
+    explicit read_guard(const phy_ue_db& db) : guard(db.epochs) {}
+
+  private:
+    srsran::epoch_read_guard guard;
+  };
+
+  phy_ue_db();
+  ~phy_ue_db();
+
+  phy_ue_db(const phy_ue_db&) = delete;
+  phy_ue_db& operator=(const phy_ue_db&) = delete;
+
   /**
    * Initialises the UE database with the stack and cell list
    * @param stack_ptr points to the stack (read/write)
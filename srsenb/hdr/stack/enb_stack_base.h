@@ -35,6 +35,12 @@ typedef struct {
   std::string filename;
 } pcap_args_t;
 
+typedef struct {
+  std::string format;        // pcap or pcapng
+  uint32_t    max_file_size; // in MB, 0 disables file rotation
+  uint32_t    max_files;     // number of rotated files kept, 0 keeps all of them
+} pcap_file_args_t;
+
 typedef struct {
   bool        enable;
   std::string client_ip;
@@ -66,6 +72,9 @@ typedef struct {
   int gtpu_hex_limit;
   int s1ap_hex_limit;
   int stack_hex_limit;
+
+  uint32_t max_rate;      // Max info/debug entries per second and source (e.g. RNTI). 0 disables it
+  uint32_t sample_period; // Only one out of sample_period info/debug entries is logged. 0 disables it
 } stack_log_args_t;
 
 typedef struct {
@@ -76,6 +85,7 @@ typedef struct {
   pcap_args_t      mac_pcap;
   pcap_net_args_t  mac_pcap_net;
   pcap_args_t      s1ap_pcap;
+  pcap_file_args_t pcap_file;
   stack_log_args_t log;
   embms_args_t     embms;
 } stack_args_t;
@@ -86,6 +86,16 @@ public:
   {
     return mac.snr_info(tti_rx, rnti, cc_idx, snr_db, ch);
   }
+  int sb_snr_info(uint32_t     tti_rx,
+                  uint16_t     rnti,
+                  uint32_t     cc_idx,
+                  uint32_t     prb_start,
+                  uint32_t     sb_nof_prb,
+                  const float* sb_snr_db,
+                  uint32_t     nof_sb) final
+  {
+    return mac.sb_snr_info(tti_rx, rnti, cc_idx, prb_start, sb_nof_prb, sb_snr_db, nof_sb);
+  }
   int ta_info(uint32_t tti, uint16_t rnti, float ta_us) override { return mac.ta_info(tti, rnti, ta_us); }
   int ack_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack) final
   {
@@ -25,6 +25,7 @@
 #include "sched.h"
 #include "sched_interface.h"
 #include "srsenb/hdr/common/rnti_pool.h"
+#include "srsenb/hdr/common/rnti_rcu_map.h"
 #include "srsenb/hdr/stack/mac/schedulers/sched_time_rr.h"
 #include "srsran/adt/circular_map.h"
 #include "srsran/adt/pool/batch_mem_pool.h"
@@ -39,6 +40,7 @@
 #include "srsran/srslog/srslog.h"
 #include "ta.h"
 #include "ue.h"
+#include <mutex>
 #include <vector>
 
 namespace srsenb {
@@ -67,6 +69,13 @@ public:
   int cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t cqi_value) override;
   int sb_cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t sb_idx, uint32_t cqi_value) override;
   int snr_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, float snr, ul_channel_t ch) override;
+  int sb_snr_info(uint32_t     tti,
+                  uint16_t     rnti,
+                  uint32_t     enb_cc_idx,
+                  uint32_t     prb_start,
+                  uint32_t     sb_nof_prb,
+                  const float* sb_snr_db,
+                  uint32_t     nof_sb) override;
   int ta_info(uint32_t tti, uint16_t rnti, float ta_us) override;
   int ack_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack) override;
   int crc_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t nof_bytes, bool crc_res) override;
@@ -131,10 +140,6 @@ private:
 
   srslog::basic_logger& logger;
 
-  // We use a rwlock in MAC to allow multiple workers to access MAC simultaneously. No conflicts will happen since
-  // access for different TTIs
-  pthread_rwlock_t rwlock = {};
-
   // Interaction with PHY
   phy_interface_stack_lte*      phy_h = nullptr;
   rlc_interface_mac*            rlc_h = nullptr;
@@ -154,11 +159,15 @@ private:
   std::vector<sched_interface::cell_cfg_t> cell_config;
 
   sched_interface::dl_pdu_mch_t mch = {};
+  std::mutex                    mch_mutex;
+
+  /* Map of active UEs. Multiple workers access it simultaneously from read sections, which take no locks. Removed
+   * UEs are only destroyed once all workers have left the read sections that could still reference them */
+  using ue_db_t = rnti_rcu_map<ue>;
 
-  /* Map of active UEs */
-  static const uint16_t            FIRST_RNTI = 0x46;
-  rnti_map_t<unique_rnti_ptr<ue> > ue_db;
-  std::atomic<uint16_t>            ue_counter{0};
+  static const uint16_t FIRST_RNTI = 0x46;
+  ue_db_t               ue_db;
+  std::atomic<uint16_t> ue_counter{0};
 
   uint8_t* assemble_rar(sched_interface::dl_sched_rar_grant_t* grants,
                         uint32_t                               enb_cc_idx,
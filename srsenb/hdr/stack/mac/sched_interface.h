@@ -317,6 +317,13 @@ public:
   virtual int ul_bsr(uint16_t rnti, uint32_t lcg_id, uint32_t bsr)                                          = 0;
   virtual int ul_phr(uint16_t rnti, int phr, uint32_t ul_nof_prb)                                           = 0;
   virtual int ul_snr_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, float snr, uint32_t ul_ch_code) = 0;
+  virtual int ul_sb_snr_info(uint32_t     tti,
+                             uint16_t     rnti,
+                             uint32_t     enb_cc_idx,
+                             uint32_t     prb_start,
+                             uint32_t     sb_nof_prb,
+                             const float* sb_snr_db,
+                             uint32_t     nof_sb)                                                           = 0;
 
   /* Run Scheduler for this tti */
   virtual int dl_sched(uint32_t tti, uint32_t enb_cc_idx, dl_sched_res_t& sched_result) = 0;
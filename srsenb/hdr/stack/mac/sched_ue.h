@@ -66,6 +66,11 @@ public:
   void mac_buffer_state(uint32_t ce_code, uint32_t nof_cmds);
 
   void set_ul_snr(tti_point tti_rx, uint32_t enb_cc_idx, float snr, uint32_t ul_ch_code);
+  void set_ul_sb_snr(tti_point                 tti_rx,
+                     uint32_t                  enb_cc_idx,
+                     uint32_t                  prb_start,
+                     uint32_t                  sb_nof_prb,
+                     srsran::const_span<float> sb_snr_db);
   void set_dl_ri(tti_point tti_rx, uint32_t enb_cc_idx, uint32_t ri);
   void set_dl_pmi(tti_point tti_rx, uint32_t enb_cc_idx, uint32_t ri);
   void set_dl_cqi(tti_point tti_rx, uint32_t enb_cc_idx, uint32_t cqi);
@@ -25,6 +25,7 @@
 #include "../sched_lte_common.h"
 #include "sched_dl_cqi.h"
 #include "sched_harq.h"
+#include "sched_ul_snr.h"
 #include "srsenb/hdr/stack/mac/sched_phy_ch/sched_dci.h"
 #include "tpc.h"
 
@@ -64,6 +65,7 @@ struct sched_ue_cell {
   int set_ack_info(tti_point tti_rx, uint32_t tb_idx, bool ack);
   int set_ul_crc(tti_point tti_rx, bool crc_res);
   int set_ul_snr(tti_point tti_rx, float ul_snr, uint32_t ul_ch_code);
+  int set_ul_sb_snr(tti_point tti_rx, uint32_t prb_start, uint32_t sb_nof_prb, srsran::const_span<float> sb_snr_db);
 
   const uint16_t rnti;
 
@@ -86,6 +88,7 @@ struct sched_ue_cell {
   uint32_t            dl_pmi = 0;
   tti_point           dl_pmi_tti_rx{};
   tti_point           ul_cqi_tti_rx{};
+  const sched_ul_snr& ul_snr() const { return ul_snr_ctxt; }
 
   uint32_t max_mcs_dl = 28, max_mcs_ul = 28;
   uint32_t max_aggr_level = 3;
@@ -111,6 +114,7 @@ private:
   float max_cqi_coeff = -5, max_snr_coeff = 5;
 
   sched_dl_cqi dl_cqi_ctxt;
+  sched_ul_snr ul_snr_ctxt;
 };
 
 /*************************************************************
@@ -0,0 +1,72 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_SCHED_UL_SNR_H
+#define SRSRAN_SCHED_UL_SNR_H
+
+#include "srsenb/hdr/stack/mac/sched_phy_ch/sched_phy_resource.h"
+#include "srsran/adt/span.h"
+#include "srsran/common/tti_point.h"
+#include <vector>
+
+namespace srsenb {
+
+/**
+ * Class that handles the UL frequency selective SINR of a given {rnti,sector}
+ * - The SINR is measured by the PHY from the SRS, in subbands of a few PRBs
+ * - With SRS frequency hopping, every SRS only sounds a part of the bandwidth, each PRB keeps its last measurement
+ * - Measurements older than max_snr_age_ms are not used. Without measurements, the UL grants take the first fitting PRBs
+ */
+class sched_ul_snr
+{
+public:
+  explicit sched_ul_snr(uint32_t cell_nof_prb_) :
+    cell_nof_prb(cell_nof_prb_), prb_snr(cell_nof_prb_, 0.0f), prb_tti(cell_nof_prb_)
+  {}
+
+  /// Update SINR of the subbands sounded from PRB "prb_start"
+  void sb_snr_info(tti_point tti, uint32_t prb_start, uint32_t sb_nof_prb, srsran::const_span<float> sb_snr_db);
+
+  /// Discards all measurements
+  void reset();
+
+  /// Checks whether any PRB has a measurement recent enough at "tti"
+  bool is_snr_info_valid(tti_point tti) const;
+
+  /// Get SINR-optimal interval of at most "L" contiguous empty PRBs, the length is the one of find_contiguous_ul_prbs()
+  prb_interval get_optim_prb_interval(tti_point tti, uint32_t L, const prbmask_t& ul_mask) const;
+
+private:
+  static const uint32_t max_snr_age_ms = 160;
+
+  bool is_prb_valid(tti_point tti, uint32_t prb) const
+  {
+    return prb_tti[prb].is_valid() and tti - prb_tti[prb] < (int)max_snr_age_ms;
+  }
+
+  uint32_t               cell_nof_prb;
+  std::vector<float>     prb_snr;
+  std::vector<tti_point> prb_tti;
+};
+
+} // namespace srsenb
+
+#endif // SRSRAN_SCHED_UL_SNR_H
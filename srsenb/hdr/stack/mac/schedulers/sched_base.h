@@ -55,6 +55,9 @@ alloc_result
              try_dl_newtx_alloc_greedy(sf_sched& tti_sched, sched_ue& ue, const dl_harq_proc& h, rbgmask_t* result_mask = nullptr);
 alloc_result try_ul_retx_alloc(sf_sched& tti_sched, sched_ue& ue, const ul_harq_proc& h);
 
+/// Find the empty contiguous PRB interval of length L with the best UL SNR measured in the UE SRS
+prb_interval find_optim_ul_prbs(sf_sched& tti_sched, sched_ue& ue, uint32_t L);
+
 } // namespace srsenb
 
 #endif // SRSRAN_SCHED_BASE_H
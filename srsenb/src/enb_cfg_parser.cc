@@ -1469,6 +1469,19 @@ static int parse_scell_list(cell_cfg_t& cell_cfg, Setting& cellroot)
   return SRSRAN_SUCCESS;
 }
 
+static int parse_pusch_estimator(std::string& estimator, Setting& root)
+{
+  srsran_chest_ul_estimator_alg_t alg;
+  estimator = root.c_str();
+  if (srsran_chest_ul_str2estimator_alg(estimator.c_str(), &alg) < SRSRAN_SUCCESS) {
+    fprintf(stderr,
+            "PARSER ERROR: Invalid pusch_estimator \"%s\". Valid options: \"average\", \"wiener\"\n",
+            estimator.c_str());
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
 static int parse_cell_list(all_args_t* args, rrc_cfg_t* rrc_cfg, Setting& root)
 {
   for (uint32_t n = 0; n < (uint32_t)root.getLength(); ++n) {
@@ -1500,6 +1513,8 @@ static int parse_cell_list(all_args_t* args, rrc_cfg_t* rrc_cfg, Setting& root)
     HANDLEPARSERCODE(parse_default_field(cell_cfg.target_pucch_sinr_db, cellroot, "target_pucch_sinr", -1));
     HANDLEPARSERCODE(parse_default_field(cell_cfg.enable_phr_handling, cellroot, "enable_phr_handling", false));
     HANDLEPARSERCODE(parse_default_field(cell_cfg.min_phr_thres, cellroot, "min_phr_thres", 0));
+    HANDLEPARSERCODE(parse_default_field(
+        cell_cfg.pusch_estimator, cellroot, "pusch_estimator", std::string("average"), parse_pusch_estimator));
     parse_default_field(cell_cfg.meas_cfg.allowed_meas_bw, cellroot, "allowed_meas_bw", 6u);
     srsran_assert(srsran::is_lte_cell_nof_prb(cell_cfg.meas_cfg.allowed_meas_bw), "Invalid measurement Bandwidth");
     HANDLEPARSERCODE(asn1_parsers::default_number_to_enum(
@@ -1912,6 +1927,10 @@ int set_derived_args(all_args_t* args_, rrc_cfg_t* rrc_cfg_, phy_cfg_t* phy_cfg_
     phy_cell_cfg.gain_db        = cfg.tx_gain;
     phy_cell_cfg.num_ra_preambles =
         rrc_cfg_->sibs[1].sib2().rr_cfg_common.rach_cfg_common.preamb_info.nof_ra_preambs.to_number();
+    if (srsran_chest_ul_str2estimator_alg(cfg.pusch_estimator.c_str(), &phy_cell_cfg.pusch_estimator_alg) <
+        SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
 
     if (cfg.dl_freq_hz > 0) {
       phy_cell_cfg.dl_freq_hz = cfg.dl_freq_hz;
@@ -140,6 +140,9 @@ void parse_args(all_args_t* args, int argc, char* argv[])
 
     ("log.filename",      bpo::value<string>(&args->log.filename)->default_value("/tmp/ue.log"),"Log filename")
     ("log.file_max_size", bpo::value<int>(&args->log.file_max_size)->default_value(-1), "Maximum file size (in kilobytes). When passed, multiple files are created. Default -1 (single file)")
+    ("log.max_rate",      bpo::value<uint32_t>(&args->stack.log.max_rate)->default_value(0), "Maximum number of info/debug log entries per second and source (e.g. RNTI) for the stack layers. 0 disables the limit")
+    ("log.sample_period", bpo::value<uint32_t>(&args->stack.log.sample_period)->default_value(0), "Log only one out of sample_period info/debug entries for the stack layers. 0 disables sampling")
+    ("log.binary",        bpo::value<bool>(&args->log.binary)->default_value(false), "Write log entries unformatted into a binary file, to be rendered offline with srslog_decoder")
 
     /* PCAP */
     ("pcap.enable",    bpo::value<bool>(&args->stack.mac_pcap.enable)->default_value(false),         "Enable MAC packet captures for wireshark")
@@ -154,6 +157,9 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("pcap.bind_port", bpo::value<uint16_t>(&args->stack.mac_pcap_net.bind_port)->default_value(5687),        "Bind port for MAC network trace")
     ("pcap.client_ip", bpo::value<string>(&args->stack.mac_pcap_net.client_ip)->default_value("127.0.0.1"),     "Client IP address for MAC network trace")
     ("pcap.client_port", bpo::value<uint16_t>(&args->stack.mac_pcap_net.client_port)->default_value(5847),    "Enable MAC network captures")
+    ("pcap.format", bpo::value<string>(&args->stack.pcap_file.format)->default_value("pcap"), "Capture file format (pcap or pcapng)")
+    ("pcap.max_file_size", bpo::value<uint32_t>(&args->stack.pcap_file.max_file_size)->default_value(0), "Start a new capture file after this many MB (0 disables rotation)")
+    ("pcap.max_files", bpo::value<uint32_t>(&args->stack.pcap_file.max_files)->default_value(0), "Number of rotated capture files kept before overwriting the oldest (0 keeps all)")
 
     /* Scheduling section */
     ("scheduler.policy", bpo::value<string>(&args->stack.mac.sched.sched_policy)->default_value("time_pf"), "DL and UL data scheduling policy (E.g. time_rr, time_pf)")
@@ -185,6 +191,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
 
     /* Downlink Channel emulator section */
     ("channel.dl.enable",            bpo::value<bool>(&args->phy.dl_channel_args.enable)->default_value(false),               "Enable/Disable internal Downlink channel emulator")
+    ("channel.dl.nof_threads",       bpo::value<uint32_t>(&args->phy.dl_channel_args.nof_threads)->default_value(1),          "Number of threads processing the downlink channels in parallel")
     ("channel.dl.awgn.enable",       bpo::value<bool>(&args->phy.dl_channel_args.awgn_enable)->default_value(false),          "Enable/Disable AWGN simulator")
     ("channel.dl.awgn.snr",          bpo::value<float>(&args->phy.dl_channel_args.awgn_snr_dB)->default_value(30.0f),         "Target SNR in dB")
     ("channel.dl.fading.enable",     bpo::value<bool>(&args->phy.dl_channel_args.fading_enable)->default_value(false),        "Enable/Disable Fading model")
@@ -204,6 +211,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
 
     /* Uplink Channel emulator section */
     ("channel.ul.enable",            bpo::value<bool>(&args->phy.ul_channel_args.enable)->default_value(false),                  "Enable/Disable internal Downlink channel emulator")
+    ("channel.ul.nof_threads",       bpo::value<uint32_t>(&args->phy.ul_channel_args.nof_threads)->default_value(1),             "Number of threads processing the uplink channels in parallel")
     ("channel.ul.awgn.enable",       bpo::value<bool>(&args->phy.ul_channel_args.awgn_enable)->default_value(false),             "Enable/Disable AWGN simulator")
     ("channel.ul.awgn.signal_power", bpo::value<float>(&args->phy.ul_channel_args.awgn_signal_power_dBfs)->default_value(30.0f), "Received signal power in decibels full scale (dBfs)")
     ("channel.ul.awgn.snr",          bpo::value<float>(&args->phy.ul_channel_args.awgn_snr_dB)->default_value(30.0f),            "Noise level in decibels full scale (dBfs)")
@@ -236,6 +244,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.metrics_csv_filename", bpo::value<string>(&args->general.metrics_csv_filename)->default_value("/tmp/enb_metrics.csv"), "Metrics CSV filename.")
     ("expert.pusch_max_its", bpo::value<uint32_t>(&args->phy.pusch_max_its)->default_value(8), "Maximum number of turbo decoder iterations for LTE.")
     ("expert.pusch_8bit_decoder", bpo::value<bool>(&args->phy.pusch_8bit_decoder)->default_value(false), "Use 8-bit for LLR representation and turbo decoder trellis computation (Experimental).")
+    ("expert.pdsch_seq_cache_kb", bpo::value<uint32_t>(&args->phy.pdsch_seq_cache_kb)->default_value(0), "Memory budget in kB of the PDSCH scrambling sequence cache of each PHY worker and codeword, 0 disables it.")
     ("expert.pusch_meas_evm", bpo::value<bool>(&args->phy.pusch_meas_evm)->default_value(false), "Enable/Disable PUSCH EVM measure.")
     ("expert.tx_amplitude", bpo::value<float>(&args->phy.tx_amplitude)->default_value(0.6), "Transmit amplitude factor.")
     ("expert.nof_phy_threads", bpo::value<uint32_t>(&args->phy.nof_phy_threads)->default_value(3), "Number of PHY threads.")
@@ -464,6 +473,10 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     }
   }
 
+  // The PHY workers share the log rate limits of the stack
+  args->phy.log.max_rate      = args->stack.log.max_rate;
+  args->phy.log.sample_period = args->stack.log.sample_period;
+
   // Check remaining eNB config files
   if (!config_exists(args->enb_files.sib_config, "sib.conf")) {
     cout << "Failed to read SIB configuration file " << args->enb_files.sib_config << " - exiting" << endl;
@@ -617,7 +630,9 @@ int main(int argc, char* argv[])
   srslog::set_default_sink(
       (args.log.filename == "stdout")
           ? srslog::fetch_stdout_sink()
-          : srslog::fetch_file_sink(args.log.filename, fixup_log_file_maxsize(args.log.file_max_size)));
+          : (args.log.binary
+                 ? srslog::fetch_binary_file_sink(args.log.filename)
+                 : srslog::fetch_file_sink(args.log.filename, fixup_log_file_maxsize(args.log.file_max_size))));
 
   // Alarms log channel creation.
   srslog::sink&        alarm_sink     = srslog::fetch_file_sink(args.general.alarms_filename, 0, true);
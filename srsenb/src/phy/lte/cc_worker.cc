@@ -122,11 +122,21 @@ void cc_worker::init(phy_common* phy_, uint32_t cc_idx_)
     ERROR("Error setting the CFR");
     return;
   }
+  if (phy->params.pdsch_seq_cache_kb > 0 &&
+      srsran_pdsch_set_sequence_cache(&enb_dl.pdsch, phy->params.pdsch_seq_cache_kb * 1024) < SRSRAN_SUCCESS) {
+    ERROR("Error setting the PDSCH scrambling sequence cache (cc=%d)", cc_idx);
+    return;
+  }
   if (srsran_enb_ul_init(&enb_ul, signal_buffer_rx[0], nof_prb)) {
     ERROR("Error initiating ENB UL");
     return;
   }
 
+  if (srsran_chest_ul_set_estimator_alg(&enb_ul.chest, phy->get_cell_pusch_estimator(cc_idx))) {
+    ERROR("Error setting PUSCH channel estimator");
+    return;
+  }
+
   if (srsran_enb_ul_set_cell(&enb_ul, cell, &phy->dmrs_pusch_cfg, nullptr)) {
     ERROR("Error initiating ENB UL");
     return;
@@ -226,6 +236,9 @@ void cc_worker::work_ul(const srsran_ul_sf_cfg_t& ul_sf_cfg, stack_interface_phy
 
   // Decode remaining PUCCH ACKs not associated with PUSCH transmission and SR signals
   decode_pucch();
+
+  // Measure the sounding reference signals for the UL frequency selective scheduling
+  decode_srs();
 }
 
 void cc_worker::work_dl(const srsran_dl_sf_cfg_t&            dl_sf_cfg,
@@ -407,7 +420,7 @@ void cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants,
       if (logger.info.enabled()) {
         char str[512];
         srsran_pusch_rx_info(&ul_cfg.pusch, &pusch_res, &enb_ul.chest_res, str, sizeof(str));
-        logger.info("PUSCH: cc=%d, %s", cc_idx, str);
+        logger.info(srslog::rate_key{rnti}, "PUSCH: cc=%d, %s", cc_idx, str);
       }
     }
   }
@@ -415,7 +428,8 @@ void cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants,
 
 int cc_worker::decode_pucch()
 {
-  srsran_pucch_res_t pucch_res = {};
+  pucch_rnti.clear();
+  pucch_cfg.clear();
 
   for (auto& iter : ue_db) {
     uint16_t rnti = iter.first;
@@ -438,39 +452,116 @@ int cc_worker::decode_pucch()
 
       // If ret is more than success, UCI is present
       if (ret > SRSRAN_SUCCESS) {
-        // Decode PUCCH
-        if (srsran_enb_ul_get_pucch(&enb_ul, &ul_sf, &ul_cfg.pucch, &pucch_res)) {
-          Error("Error getting PUCCH");
-          continue;
-        }
+        pucch_rnti.push_back(rnti);
+        pucch_cfg.push_back(ul_cfg.pucch);
+      }
+    }
+  }
 
-        // Send UCI data to MAC
-        if (phy->ue_db.send_uci_data(tti_rx, rnti, cc_idx, ul_cfg.pucch.uci_cfg, pucch_res.uci_data) < SRSRAN_SUCCESS) {
-          Error("Error sending UCI data for RNTI %x, CC %d", rnti, cc_idx);
-          continue;
-        }
+  if (pucch_rnti.empty()) {
+    return 0;
+  }
 
-        if (pucch_res.detected and pucch_res.ta_valid) {
-          phy->stack->ta_info(tti_rx, rnti, pucch_res.ta_us);
-          phy->stack->snr_info(tti_rx, rnti, cc_idx, pucch_res.snr_db, mac_interface_phy_lte::PUCCH);
-        }
+  // Decode the PUCCH of all the users at once, the ones sharing a PRB pair are demodulated together
+  pucch_res.assign(pucch_rnti.size(), {});
+  pucch_ret.assign(pucch_rnti.size(), SRSRAN_SUCCESS);
+  srsran_enb_ul_get_pucch_multi(
+      &enb_ul, &ul_sf, pucch_cfg.data(), pucch_res.data(), pucch_ret.data(), pucch_cfg.size());
 
-        // Logging
-        if (logger.info.enabled()) {
-          char str[512];
-          srsran_pucch_rx_info(&ul_cfg.pucch, &pucch_res, str, sizeof(str));
-          logger.info("PUCCH: cc=%d; %s", cc_idx, str);
-        }
+  for (uint32_t i = 0; i < pucch_rnti.size(); i++) {
+    uint16_t            rnti = pucch_rnti[i];
+    srsran_pucch_cfg_t& cfg  = pucch_cfg[i];
+    srsran_pucch_res_t& res  = pucch_res[i];
 
-        // Save metrics
-        if (pucch_res.detected) {
-          ue_db[rnti]->metrics_ul_pucch(pucch_res.rssi_dbFs - phy->params.rx_gain_offset,
-                                        pucch_res.ni_dbFs - -phy->params.rx_gain_offset,
-                                        pucch_res.snr_db);
-        }
+    // Do not report a NACK, SR or CQI the PUCCH did not carry
+    if (pucch_ret[i] < SRSRAN_SUCCESS) {
+      Error("Error getting PUCCH for RNTI %x, CC %d", rnti, cc_idx);
+      continue;
+    }
+
+    // Send UCI data to MAC
+    if (phy->ue_db.send_uci_data(tti_rx, rnti, cc_idx, cfg.uci_cfg, res.uci_data) < SRSRAN_SUCCESS) {
+      Error("Error sending UCI data for RNTI %x, CC %d", rnti, cc_idx);
+      continue;
+    }
+
+    if (res.detected and res.ta_valid) {
+      phy->stack->ta_info(tti_rx, rnti, res.ta_us);
+      phy->stack->snr_info(tti_rx, rnti, cc_idx, res.snr_db, mac_interface_phy_lte::PUCCH);
+    }
+
+    // Logging
+    if (logger.info.enabled()) {
+      char str[512];
+      srsran_pucch_rx_info(&cfg, &res, str, sizeof(str));
+      logger.info(srslog::rate_key{rnti}, "PUCCH: cc=%d; %s", cc_idx, str);
+    }
+
+    // Save metrics
+    if (res.detected) {
+      ue_db[rnti]->metrics_ul_pucch(
+          res.rssi_dbFs - phy->params.rx_gain_offset, res.ni_dbFs - -phy->params.rx_gain_offset, res.snr_db);
+    }
+  }
+  return 0;
+}
+
+int cc_worker::decode_srs()
+{
+  srs_rnti.clear();
+  srs_cfg.clear();
+
+  for (auto& iter : ue_db) {
+    uint16_t rnti = iter.first;
+
+    if (SRSRAN_RNTI_ISUSER(rnti) and phy->ue_db.ue_has_cell(rnti, cc_idx)) {
+      srsran_ul_cfg_t ul_cfg = {};
+
+      if (phy->ue_db.get_ul_config(rnti, cc_idx, ul_cfg) < SRSRAN_SUCCESS) {
+        Error("Error retrieving last UL configuration for RNTI %x, CC %d", rnti, cc_idx);
+        continue;
+      }
+
+      // Check if the user transmits SRS in this subframe
+      if (ul_cfg.srs.configured and srsran_refsignal_srs_send_cs(ul_cfg.srs.subframe_config, tti_rx % 10) == 1 and
+          srsran_refsignal_srs_send_ue(ul_cfg.srs.I_srs, tti_rx) == 1) {
+        srs_rnti.push_back(rnti);
+        srs_cfg.push_back(ul_cfg.srs);
       }
     }
   }
+
+  if (srs_rnti.empty()) {
+    return 0;
+  }
+
+  // Measure the SRS of all the users at once, the ones sharing comb and bandwidth are transformed together
+  srs_res.assign(srs_rnti.size(), {});
+  if (srsran_enb_ul_get_srs_multi(
+          &enb_ul, &ul_sf, &phy->dmrs_pusch_cfg, srs_cfg.data(), srs_res.data(), srs_cfg.size())) {
+    Error("Error getting SRS");
+  }
+
+  for (uint32_t i = 0; i < srs_rnti.size(); i++) {
+    uint16_t                   rnti = srs_rnti[i];
+    srsran_chest_ul_srs_res_t& res  = srs_res[i];
+
+    // Users that failed the estimation have no sub-bands
+    if (res.nof_sb == 0) {
+      continue;
+    }
+
+    phy->stack->snr_info(tti_rx, rnti, cc_idx, res.snr_db, mac_interface_phy_lte::SRS);
+    phy->stack->sb_snr_info(tti_rx, rnti, cc_idx, res.prb_start, SRSRAN_CHEST_UL_SRS_SB_PRB, res.sb_snr_db, res.nof_sb);
+
+    logger.info(srslog::rate_key{rnti},
+                "SRS: rnti=0x%x; cc=%d; prb_start=%d; nof_sb=%d; snr=%.1f dB",
+                rnti,
+                cc_idx,
+                res.prb_start,
+                res.nof_sb,
+                res.snr_db);
+  }
   return 0;
 }
 
@@ -519,7 +610,12 @@ int cc_worker::encode_pdcch_ul(stack_interface_phy_lte::ul_sched_grant_t* grants
       if (logger.info.enabled()) {
         char str[512];
         srsran_dci_ul_info(&grants[i].dci, str, 512);
-        logger.info("PDCCH: cc=%d, rnti=0x%x, %s, tti_tx_dl=%d", cc_idx, grants[i].dci.rnti, str, tti_tx_dl);
+        logger.info(srslog::rate_key{grants[i].dci.rnti},
+                    "PDCCH: cc=%d, rnti=0x%x, %s, tti_tx_dl=%d",
+                    cc_idx,
+                    grants[i].dci.rnti,
+                    str,
+                    tti_tx_dl);
       }
     }
   }
@@ -556,7 +652,12 @@ int cc_worker::encode_pdcch_dl(stack_interface_phy_lte::dl_sched_grant_t* grants
         // Logging
         char str[512];
         srsran_dci_dl_info(&grants[i].dci, str, 512);
-        logger.info("PDCCH: cc=%d, rnti=0x%x, %s, tti_tx_dl=%d", cc_idx, grants[i].dci.rnti, str, tti_tx_dl);
+        logger.info(srslog::rate_key{grants[i].dci.rnti},
+                    "PDCCH: cc=%d, rnti=0x%x, %s, tti_tx_dl=%d",
+                    cc_idx,
+                    grants[i].dci.rnti,
+                    str,
+                    tti_tx_dl);
       }
     }
   }
@@ -595,13 +696,16 @@ int cc_worker::encode_pmch(stack_interface_phy_lte::dl_sched_grant_t* grant, srs
 
 int cc_worker::encode_pdsch(stack_interface_phy_lte::dl_sched_grant_t* grants, uint32_t nof_grants)
 {
-  /* Scales the Resources Elements affected by the power allocation (p_b) */
-  // srsran_enb_dl_prepare_power_allocation(&enb_dl);
+  // Compute the configuration of every grant first, so that their scrambling sequences are generated together
+  pdsch_grant_idx.clear();
+  pdsch_cfg.resize(nof_grants);
+  pdsch_cfg_ptr.clear();
   for (uint32_t i = 0; i < nof_grants; i++) {
     uint16_t rnti = grants[i].dci.rnti;
 
     if (rnti && ue_db.count(rnti)) {
-      srsran_dl_cfg_t dl_cfg = {};
+      srsran_dl_cfg_t& dl_cfg = pdsch_cfg[i];
+      dl_cfg                  = {};
 
       if (phy->ue_db.get_dl_config(rnti, cc_idx, dl_cfg) < SRSRAN_SUCCESS) {
         Error("Error retrieving DCI DL configuration for RNTI %x, CC %d", grants[i].dci.rnti, cc_idx);
@@ -620,30 +724,43 @@ int cc_worker::encode_pdsch(stack_interface_phy_lte::dl_sched_grant_t* grants, u
         dl_cfg.pdsch.softbuffers.tx[j] = grants[i].softbuffer_tx[j];
       }
 
-      // Encode PDSCH
-      if (srsran_enb_dl_put_pdsch(&enb_dl, &dl_cfg.pdsch, grants[i].data)) {
-        Error("Error putting PDSCH %d", i);
-        return SRSRAN_ERROR;
-      }
+      pdsch_grant_idx.push_back(i);
+      pdsch_cfg_ptr.push_back(&dl_cfg.pdsch);
+    } else {
+      Error("User rnti=0x%x not found in cc_worker=%d", rnti, cc_idx);
+    }
+  }
 
-      // Save pending ACK
-      if (SRSRAN_RNTI_ISUSER(rnti)) {
-        // Push whole DCI
-        phy->ue_db.set_ack_pending(tti_tx_ul, cc_idx, grants[i].dci);
-      }
+  // Generate the scrambling sequences of the scheduled RNTIs that are not cached yet
+  srsran_pdsch_prefetch_sequences(&enb_dl.pdsch, &dl_sf, pdsch_cfg_ptr.data(), pdsch_cfg_ptr.size());
 
-      if (LOG_THIS(rnti) and logger.info.enabled()) {
-        // Logging
-        char str[512];
-        srsran_pdsch_tx_info(&dl_cfg.pdsch, str, 512);
-        logger.info("PDSCH: cc=%d, %s, tti_tx_dl=%d", cc_idx, str, tti_tx_dl);
-      }
+  /* Scales the Resources Elements affected by the power allocation (p_b) */
+  // srsran_enb_dl_prepare_power_allocation(&enb_dl);
+  for (uint32_t i : pdsch_grant_idx) {
+    uint16_t         rnti   = grants[i].dci.rnti;
+    srsran_dl_cfg_t& dl_cfg = pdsch_cfg[i];
+
+    // Encode PDSCH
+    if (srsran_enb_dl_put_pdsch(&enb_dl, &dl_cfg.pdsch, grants[i].data)) {
+      Error("Error putting PDSCH %d", i);
+      return SRSRAN_ERROR;
+    }
 
-      // Save metrics stats
-      ue_db[rnti]->metrics_dl(grants[i].dci.tb[0].mcs_idx);
-    } else {
-      Error("User rnti=0x%x not found in cc_worker=%d", rnti, cc_idx);
+    // Save pending ACK
+    if (SRSRAN_RNTI_ISUSER(rnti)) {
+      // Push whole DCI
+      phy->ue_db.set_ack_pending(tti_tx_ul, cc_idx, grants[i].dci);
     }
+
+    if (LOG_THIS(rnti) and logger.info.enabled()) {
+      // Logging
+      char str[512];
+      srsran_pdsch_tx_info(&dl_cfg.pdsch, str, 512);
+      logger.info(srslog::rate_key{rnti}, "PDSCH: cc=%d, %s, tti_tx_dl=%d", cc_idx, str, tti_tx_dl);
+    }
+
+    // Save metrics stats
+    ue_db[rnti]->metrics_dl(grants[i].dci.tb[0].mcs_idx);
   }
 
   // srsran_enb_dl_apply_power_allocation(&enb_dl);
@@ -163,6 +163,9 @@ void sf_worker::work_imp()
     return;
   }
 
+  // Stay in a UE database read section for the whole TTI, the accesses of the carrier workers are nested in it
+  phy_ue_db::read_guard ue_db_guard(phy->ue_db);
+
   srsran_mbsfn_cfg_t mbsfn_cfg;
   srsran_sf_t        sf_type = phy->is_mbsfn_sf(&mbsfn_cfg, tti_tx_dl) ? SRSRAN_SF_MBSFN : SRSRAN_SF_NORM;
 
@@ -29,10 +29,19 @@ bool worker_pool::init(const phy_args_t& args, phy_common* common, srslog::sink&
 {
   // Add workers to workers pool and start threads.
   srslog::basic_levels log_level = srslog::str_to_basic_level(args.log.phy_level);
+
+  srslog::rate_limit_config log_rate_cfg;
+  log_rate_cfg.max_rate      = args.log.max_rate;
+  log_rate_cfg.burst         = std::max(args.log.max_rate / 10, 1U);
+  log_rate_cfg.sample_period = args.log.sample_period;
+  log_rate_cfg.per_key       = true;
+
   for (uint32_t i = 0; i < args.nof_phy_threads; i++) {
     auto& log = srslog::fetch_basic_logger(fmt::format("PHY{}", i), log_sink);
     log.set_level(log_level);
     log.set_hex_dump_max_size(args.log.phy_hex_limit);
+    log.info.set_rate_limit(log_rate_cfg);
+    log.debug.set_rate_limit(log_rate_cfg);
 
     auto w = std::unique_ptr<lte::sf_worker>(new sf_worker(log));
     w->init(common);
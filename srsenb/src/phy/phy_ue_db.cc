@@ -19,10 +19,77 @@
  *
  */
 
+
 #include "srsenb/hdr/phy/phy_ue_db.h"
+#include <algorithm>
 
 using namespace srsenb;
 
+namespace {
+
+/// Packing of the pending_ack_t::common word
+const uint32_t ack_common_tm_shift     = 0;
+const uint32_t ack_common_nof_cc_shift = 8;
+const uint32_t ack_common_mode_shift   = 16;
+const uint32_t ack_common_simul_bit    = 1U << 24U;
+
+/// Packing of the pending_ack_t::cc words. Zero means no PDSCH transmission
+const uint32_t ack_cc_present_bit  = 1U << 0U;
+const uint32_t ack_cc_value_shift  = 1; // 2 bits per TB
+const uint32_t ack_cc_tpc_shift    = 8;
+const uint32_t ack_cc_n_cce_shift  = 16;
+const uint32_t ack_cc_field_mask   = 0xffU;
+const uint32_t ack_cc_n_cce_mask   = 0xffffU;
+const uint32_t ack_cc_value_mask   = 0x3U;
+
+uint32_t pack_ack_cc(const srsran_pdsch_ack_m_t& ack_m)
+{
+  uint32_t word = ack_cc_present_bit;
+  for (uint32_t tb = 0; tb < SRSRAN_MAX_CODEWORDS; tb++) {
+    word |= ((uint32_t)ack_m.value[tb] & ack_cc_value_mask) << (ack_cc_value_shift + 2 * tb);
+  }
+  word |= (ack_m.resource.tpc_for_pucch & ack_cc_field_mask) << ack_cc_tpc_shift;
+  word |= (ack_m.resource.n_cce & ack_cc_n_cce_mask) << ack_cc_n_cce_shift;
+  return word;
+}
+
+void unpack_ack_cc(uint32_t word, uint32_t ue_cc_idx, srsran_pdsch_ack_cc_t& ack_cc)
+{
+  if ((word & ack_cc_present_bit) == 0) {
+    return;
+  }
+
+  ack_cc.M                           = 1; ///< Hardcoded for FDD
+  srsran_pdsch_ack_m_t& ack_m        = ack_cc.m[0];
+  ack_m.present                      = true;
+  ack_m.resource.grant_cc_idx        = ue_cc_idx; ///< Assumes no cross-carrier scheduling
+  ack_m.resource.v_dai_dl            = 0;         ///< Ignore for FDD
+  ack_m.resource.n_cce               = (word >> ack_cc_n_cce_shift) & ack_cc_n_cce_mask;
+  ack_m.resource.tpc_for_pucch       = (word >> ack_cc_tpc_shift) & ack_cc_field_mask;
+  for (uint32_t tb = 0; tb < SRSRAN_MAX_CODEWORDS; tb++) {
+    ack_m.value[tb] = (word >> (ack_cc_value_shift + 2 * tb)) & ack_cc_value_mask;
+    if (ack_m.value[tb] == 1) {
+      ack_m.k++;
+    }
+  }
+}
+
+} // namespace
+
+phy_ue_db::phy_ue_db() : table(new ue_table_t) {}
+
+phy_ue_db::~phy_ue_db()
+{
+  // Wait for the retired objects, no PHY worker shall be running at this point
+  epochs.synchronize();
+
+  const ue_table_t* current = table.load(std::memory_order_relaxed);
+  for (common_ue* ue : current->ues) {
+    delete ue;
+  }
+  delete current;
+}
+
 void phy_ue_db::init(stack_interface_phy_lte*   stack_ptr,
                      const phy_args_t&          phy_args_,
                      const phy_cell_cfg_list_t& cell_cfg_list_)
@@ -30,64 +97,100 @@ void phy_ue_db::init(stack_interface_phy_lte*   stack_ptr,
   stack         = stack_ptr;
   phy_args      = &phy_args_;
   cell_cfg_list = &cell_cfg_list_;
+
+  default_cfg.set_defaults();
 }
 
-inline int phy_ue_db::_add_rnti(uint16_t rnti)
+inline phy_ue_db::common_ue* phy_ue_db::_find_ue(uint16_t rnti) const
 {
-  // Private function not mutexed
+  const ue_table_t* current = table.load(std::memory_order_acquire);
 
-  // Assert RNTI does NOT exist
-  if (ue_db.count(rnti)) {
-    return SRSRAN_ERROR;
+  auto it = std::lower_bound(current->ues.begin(), current->ues.end(), rnti, [](const common_ue* ue, uint16_t r) {
+    return ue->rnti < r;
+  });
+  if (it == current->ues.end() or (*it)->rnti != rnti) {
+    return nullptr;
   }
 
-  // Create new UE by accesing it
-  ue_db[rnti].cell_info[0] = {};
-
-  // Get UE
-  common_ue& ue = ue_db[rnti];
-
-  // Load default values to PCell
-  ue.cell_info[0].phy_cfg.set_defaults();
-
-  // Set constant configuration fields
-  _set_common_config_rnti(rnti, ue.cell_info[0].phy_cfg);
+  return *it;
+}
 
-  // Configure as PCell
-  ue.cell_info[0].state = cell_state_primary;
+void phy_ue_db::_publish_table(common_ue* add, common_ue* rem)
+{
+  // Private function, requires the writer mutex
+  const ue_table_t*           current   = table.load(std::memory_order_relaxed);
+  std::unique_ptr<ue_table_t> new_table = std::unique_ptr<ue_table_t>(new ue_table_t);
 
-  // Iterate all pending ACK
-  for (uint32_t tti = 0; tti < TTIMOD_SZ; tti++) {
-    _clear_tti_pending_rnti(tti, rnti);
+  new_table->ues.reserve(current->ues.size() + 1);
+  for (common_ue* ue : current->ues) {
+    if (ue != rem) {
+      new_table->ues.push_back(ue);
+    }
+  }
+  if (add != nullptr) {
+    auto it = std::lower_bound(new_table->ues.begin(),
+                               new_table->ues.end(),
+                               add->rnti,
+                               [](const common_ue* ue, uint16_t r) { return ue->rnti < r; });
+    new_table->ues.insert(it, add);
   }
 
-  return SRSRAN_SUCCESS;
+  table.store(new_table.release(), std::memory_order_release);
+
+  // Workers that loaded the former table may still be using it or the removed UE
+  epochs.retire(std::unique_ptr<const ue_table_t>(current));
+  epochs.retire(std::unique_ptr<common_ue>(rem));
+  epochs.reclaim();
 }
 
-inline void phy_ue_db::_clear_tti_pending_rnti(uint32_t tti, uint16_t rnti)
+void phy_ue_db::_publish_config(common_ue& ue, std::unique_ptr<ue_config_t> cfg)
 {
-  // Private function not mutexed, no need to assert RNTI or TTI
-
-  // Get UE
-  common_ue& ue = ue_db[rnti];
-
-  srsran_pdsch_ack_t& pdsch_ack = ue.pdsch_ack[tti];
+  // Private function, requires the writer mutex
+  const ue_config_t* old_cfg = ue.config.exchange(cfg.release(), std::memory_order_acq_rel);
+  epochs.retire(std::unique_ptr<const ue_config_t>(old_cfg));
+  epochs.reclaim();
+}
 
-  // Reset ACK information
-  pdsch_ack = {};
+void phy_ue_db::_clear_tti_pending(common_ue& ue, const ue_config_t& cfg, uint32_t tti)
+{
+  pending_ack_t& pdsch_ack = ue.pdsch_ack[TTIMOD(tti)];
 
   uint32_t nof_active_cc = 0;
-  for (auto& cell_info : ue.cell_info) {
+  for (const cell_info_t& cell_info : cfg.cell_info) {
     if (cell_info.state == cell_state_primary or cell_info.state == cell_state_secondary_active) {
       nof_active_cc++;
     }
   }
 
+  // Reset ACK information
+  for (std::atomic<uint32_t>& cc : pdsch_ack.cc) {
+    cc.store(0, std::memory_order_relaxed);
+  }
+
   // Copy essentials. It is assumed the PUCCH parameters are the same for all carriers
-  pdsch_ack.transmission_mode      = ue.cell_info[0].phy_cfg.dl_cfg.tm;
-  pdsch_ack.nof_cc                 = nof_active_cc;
-  pdsch_ack.ack_nack_feedback_mode = ue.cell_info[0].phy_cfg.ul_cfg.pucch.ack_nack_feedback_mode;
-  pdsch_ack.simul_cqi_ack          = ue.cell_info[0].phy_cfg.ul_cfg.pucch.simul_cqi_ack;
+  const srsran::phy_cfg_t& pcell_cfg = cfg.cell_info[0].phy_cfg;
+  uint32_t                 common    = ((uint32_t)pcell_cfg.dl_cfg.tm << ack_common_tm_shift) |
+                    (nof_active_cc << ack_common_nof_cc_shift) |
+                    ((uint32_t)pcell_cfg.ul_cfg.pucch.ack_nack_feedback_mode << ack_common_mode_shift) |
+                    (pcell_cfg.ul_cfg.pucch.simul_cqi_ack ? ack_common_simul_bit : 0);
+  pdsch_ack.common.store(common, std::memory_order_release);
+}
+
+void phy_ue_db::_get_tti_pending(const common_ue& ue, uint32_t tti, srsran_pdsch_ack_t& pdsch_ack)
+{
+  const pending_ack_t& pending = ue.pdsch_ack[TTIMOD(tti)];
+
+  pdsch_ack = {};
+
+  uint32_t common                  = pending.common.load(std::memory_order_acquire);
+  pdsch_ack.transmission_mode      = (srsran_tm_t)((common >> ack_common_tm_shift) & ack_cc_field_mask);
+  pdsch_ack.nof_cc                 = (common >> ack_common_nof_cc_shift) & ack_cc_field_mask;
+  pdsch_ack.ack_nack_feedback_mode = (srsran_ack_nack_feedback_mode_t)((common >> ack_common_mode_shift) & ack_cc_field_mask);
+  pdsch_ack.simul_cqi_ack          = (common & ack_common_simul_bit) != 0;
+
+  for (uint32_t ue_cc_idx = 0; ue_cc_idx < SRSRAN_MAX_CARRIERS; ue_cc_idx++) {
+    unpack_ack_cc(pending.cc[ue_cc_idx].load(std::memory_order_acquire), ue_cc_idx, pdsch_ack.cc[ue_cc_idx]);
+  }
 }
 
 inline void phy_ue_db::_set_common_config_rnti(uint16_t rnti, srsran::phy_cfg_t& phy_cfg) const
@@ -106,16 +209,17 @@ inline void phy_ue_db::_set_common_config_rnti(uint16_t rnti, srsran::phy_cfg_t&
   phy_cfg.ul_cfg.pucch.threshold_data_valid_format2  = SRSRAN_PUCCH_DEFAULT_THRESHOLD_FORMAT2;
   phy_cfg.ul_cfg.pucch.threshold_data_valid_format3  = SRSRAN_PUCCH_DEFAULT_THRESHOLD_FORMAT3;
   phy_cfg.ul_cfg.pucch.threshold_dmrs_detection      = SRSRAN_PUCCH_DEFAULT_THRESHOLD_DMRS;
+  phy_cfg.ul_cfg.pucch.threshold_format1_bank        = SRSRAN_PUCCH_DEFAULT_THRESHOLD_FORMAT1_BANK;
+  phy_cfg.ul_cfg.pucch.threshold_dmrs_detection_bank = SRSRAN_PUCCH_DEFAULT_THRESHOLD_DMRS_BANK;
   phy_cfg.ul_cfg.pucch.meas_ta_en                    = phy_args->pucch_meas_ta;
 }
 
-inline uint32_t phy_ue_db::_get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) const
+inline uint32_t phy_ue_db::_get_ue_cc_idx(const ue_config_t& cfg, uint32_t enb_cc_idx)
 {
-  uint32_t         ue_cc_idx = 0;
-  const common_ue& ue        = ue_db.at(rnti);
+  uint32_t ue_cc_idx = 0;
 
   for (; ue_cc_idx < SRSRAN_MAX_CARRIERS; ue_cc_idx++) {
-    const cell_info_t& scell_info = ue.cell_info[ue_cc_idx];
+    const cell_info_t& scell_info = cfg.cell_info[ue_cc_idx];
     if (scell_info.enb_cc_idx == enb_cc_idx and
         (scell_info.state == cell_state_primary or scell_info.state == cell_state_secondary_active)) {
       return ue_cc_idx;
@@ -125,90 +229,35 @@ inline uint32_t phy_ue_db::_get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) co
   return ue_cc_idx;
 }
 
-uint32_t phy_ue_db::_get_uci_enb_cc_idx(uint32_t tti, uint16_t rnti) const
+uint32_t phy_ue_db::_get_uci_enb_cc_idx(uint32_t tti, const common_ue& ue, const ue_config_t& cfg) const
 {
   // Find the lowest index available PUSCH grant
-  for (const cell_info_t& cell_info : ue_db.at(rnti).cell_info) {
-    if (cell_info.is_grant_available[tti]) {
-      return cell_info.enb_cc_idx;
+  uint32_t mask = ue.ul_grant_mask[TTIMOD(tti)].load(std::memory_order_relaxed);
+  for (uint32_t ue_cc_idx = 0; ue_cc_idx < SRSRAN_MAX_CARRIERS; ue_cc_idx++) {
+    if (mask & (1U << ue_cc_idx)) {
+      return cfg.cell_info[ue_cc_idx].enb_cc_idx;
     }
   }
 
   return (uint32_t)cell_cfg_list->size();
 }
 
-inline int phy_ue_db::_assert_rnti(uint16_t rnti) const
-{
-  if (not ue_db.count(rnti)) {
-    return SRSRAN_ERROR;
-  }
-
-  return SRSRAN_SUCCESS;
-}
-
-inline int phy_ue_db::_assert_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const
-{
-  // Assert RNTI exist
-  if (_assert_rnti(rnti) != SRSRAN_SUCCESS) {
-    return SRSRAN_ERROR;
-  }
-
-  // Check Component Carrier is part of UE SCell map
-  if (_get_ue_cc_idx(rnti, enb_cc_idx) == SRSRAN_MAX_CARRIERS) {
-    return SRSRAN_ERROR;
-  }
-
-  return SRSRAN_SUCCESS;
-}
-
 bool phy_ue_db::ue_has_cell(uint16_t rnti, uint32_t enb_cc_idx) const
 {
-  return _assert_enb_cc(rnti, enb_cc_idx) == SRSRAN_SUCCESS;
-}
-
-inline int phy_ue_db::_assert_enb_pcell(uint16_t rnti, uint32_t enb_cc_idx) const
-{
-  if (_assert_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
-    return SRSRAN_ERROR;
-  }
-
-  // Check cell is PCell
-  const cell_info_t& cell_info = ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)];
-  if (cell_info.state != cell_state_primary) {
-    return SRSRAN_ERROR;
-  }
-
-  return SRSRAN_SUCCESS;
+  read_guard lock(*this);
+  common_ue* ue        = nullptr;
+  uint32_t   ue_cc_idx = 0;
+  return _get_rnti_config(rnti, enb_cc_idx, ue, ue_cc_idx) != nullptr;
 }
 
-inline int phy_ue_db::_assert_ue_cc(uint16_t rnti, uint32_t ue_cc_idx) const
+inline int phy_ue_db::_assert_ue_cc(const ue_config_t& cfg, uint32_t ue_cc_idx)
 {
-  if (_assert_rnti(rnti) != SRSRAN_SUCCESS) {
-    return SRSRAN_ERROR;
-  }
-
   // Check the cell index is in range
   if (ue_cc_idx >= SRSRAN_MAX_CARRIERS) {
     return SRSRAN_ERROR;
   }
 
-  const cell_info_t& cell_info = ue_db.at(rnti).cell_info.at(ue_cc_idx);
-  if (cell_info.state == cell_state_none) {
-    return SRSRAN_ERROR;
-  }
-
-  return SRSRAN_SUCCESS;
-}
-
-inline int phy_ue_db::_assert_active_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const
-{
-  if (_assert_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
-    return SRSRAN_ERROR;
-  }
-
-  // Check SCell is active, ignore PCell state
-  const cell_info_t& cell_info = ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)];
-  if (cell_info.state != cell_state_primary and cell_info.state != cell_state_secondary_active) {
+  if (cfg.cell_info[ue_cc_idx].state == cell_state_none) {
     return SRSRAN_ERROR;
   }
 
@@ -233,53 +282,51 @@ inline int phy_ue_db::_assert_cell_list_cfg() const
   return SRSRAN_SUCCESS;
 }
 
-inline int phy_ue_db::_get_rnti_config(uint16_t rnti, uint32_t enb_cc_idx, srsran::phy_cfg_t& phy_cfg) const
+inline const phy_ue_db::ue_config_t*
+phy_ue_db::_get_rnti_config(uint16_t rnti, uint32_t enb_cc_idx, common_ue*& ue, uint32_t& ue_cc_idx) const
 {
-  srsran::phy_cfg_t default_cfg = {};
-  default_cfg.set_defaults();
-  default_cfg.dl_cfg.pdsch.rnti = rnti;
-  default_cfg.ul_cfg.pucch.rnti = rnti;
-  default_cfg.ul_cfg.pusch.rnti = rnti;
-
-  // Use default configuration for non-user C-RNTI
-  if (not SRSRAN_RNTI_ISUSER(rnti)) {
-    phy_cfg = default_cfg;
-    return SRSRAN_SUCCESS;
+  // Make sure the C-RNTI exists
+  ue = _find_ue(rnti);
+  if (ue == nullptr) {
+    return nullptr;
   }
 
-  // Make sure the C-RNTI exists and the cell/carrier is configured
-  if (_assert_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
-    return SRSRAN_ERROR;
+  // Make sure the cell/carrier is configured and active
+  const ue_config_t* cfg = ue->config.load(std::memory_order_acquire);
+  ue_cc_idx              = _get_ue_cc_idx(*cfg, enb_cc_idx);
+  if (ue_cc_idx == SRSRAN_MAX_CARRIERS) {
+    return nullptr;
   }
 
-  // Write the current configuration
-  uint32_t ue_cc_idx = _get_ue_cc_idx(rnti, enb_cc_idx);
-  phy_cfg            = ue_db.at(rnti).cell_info.at(ue_cc_idx).phy_cfg;
-  return SRSRAN_SUCCESS;
+  return cfg;
 }
 
 void phy_ue_db::clear_tti_pending_ack(uint32_t tti)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  read_guard lock(*this);
 
   // Iterate all UEs
-  for (auto& iter : ue_db) {
-    _clear_tti_pending_rnti(TTIMOD(tti), iter.first);
+  for (common_ue* ue : table.load(std::memory_order_acquire)->ues) {
+    _clear_tti_pending(*ue, *ue->config.load(std::memory_order_acquire), tti);
   }
 }
 
 void phy_ue_db::addmod_rnti(uint16_t rnti, const phy_interface_rrc_lte::phy_rrc_cfg_list_t& phy_cfg_list)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  std::lock_guard<std::mutex> lock(writer_mutex);
 
-  // Create new user if did not exist
-  if (ue_db.count(rnti) == 0) {
-    _add_rnti(rnti);
+  // Start from the current configuration, or from the default one if the user did not exist
+  common_ue*                   ue = _find_ue(rnti);
+  std::unique_ptr<ue_config_t> cfg(new ue_config_t);
+  if (ue != nullptr) {
+    *cfg = *ue->config.load(std::memory_order_relaxed);
+  } else {
+    // Load default values to PCell, configured as PCell
+    cfg->cell_info[0].phy_cfg = default_cfg;
+    _set_common_config_rnti(rnti, cfg->cell_info[0].phy_cfg);
+    cfg->cell_info[0].state = cell_state_primary;
   }
 
-  // Get UE by reference
-  common_ue& ue = ue_db[rnti];
-
   // During a reconfiguration, all parameters in phy_cfg_t shall be applied immediately except:
   // - Multiple CSI request field in DCI (phy_cfg_t.dl_cfg.dci.multiple_csi_request_enabled)
   // - Extended TBS tables (for 256QAM) (phy_cfg_t.dl_cfg.pdsch.use_tbs_index_alt)
@@ -289,9 +336,9 @@ void phy_ue_db::addmod_rnti(uint16_t rnti, const phy_interface_rrc_lte::phy_rrc_
   // and the reception of the reconfigurationComplete, the values before the reconfiguration shall be used
 
   // Store the current values for CSI and extended TBS in temporary variables
-  ue.stashed_multiple_csi_request_enabled = (_count_nof_configured_scell(rnti) > 0);
+  cfg->stashed_multiple_csi_request_enabled = (_count_nof_configured_scell(*cfg) > 0);
   for (uint32_t i = 0; i < SRSRAN_MAX_CARRIERS; i++) {
-    ue.cell_info[i].stash_use_tbs_index_alt = ue.cell_info[i].phy_cfg.dl_cfg.pdsch.use_tbs_index_alt;
+    cfg->cell_info[i].stash_use_tbs_index_alt = cfg->cell_info[i].phy_cfg.dl_cfg.pdsch.use_tbs_index_alt;
   }
 
   // Iterate PHY RRC configuration for each UE cell/carrier
@@ -300,13 +347,13 @@ void phy_ue_db::addmod_rnti(uint16_t rnti, const phy_interface_rrc_lte::phy_rrc_
     const phy_interface_rrc_lte::phy_rrc_cfg_t& phy_rrc_dedicated = phy_cfg_list[ue_cc_idx];
 
     // Configured, add/modify entry in the cell_info map
-    cell_info_t& cell_info = ue.cell_info[ue_cc_idx];
+    cell_info_t& cell_info = cfg->cell_info[ue_cc_idx];
 
     // Configure PHY
     if (cell_info.state == cell_state_primary) {
       // If primary serving cell's eNb cell/carrier index changed, it applies default current config
       if (cell_info.enb_cc_idx != phy_rrc_dedicated.enb_cc_idx) {
-        cell_info.phy_cfg.set_defaults();
+        cell_info.phy_cfg = default_cfg;
         _set_common_config_rnti(rnti, cell_info.phy_cfg);
       }
 
@@ -335,34 +382,49 @@ void phy_ue_db::addmod_rnti(uint16_t rnti, const phy_interface_rrc_lte::phy_rrc_
 
   // Disable the rest of potential serving cells
   for (uint32_t i = nof_cc; i < SRSRAN_MAX_CARRIERS; i++) {
-    ue.cell_info[i].state = cell_state_none;
+    cfg->cell_info[i].state = cell_state_none;
   }
 
   // Enable/Disable extended CSI field in DCI according to 3GPP 36.212 R10 5.3.3.1.1 Format 0
+  bool multiple_csi_request_enabled = (_count_nof_configured_scell(*cfg) > 0);
   for (uint32_t ue_cc_idx = 0; ue_cc_idx < nof_cc; ue_cc_idx++) {
-    ue.cell_info[ue_cc_idx].phy_cfg.dl_cfg.dci.multiple_csi_request_enabled = (_count_nof_configured_scell(rnti) > 0);
+    cfg->cell_info[ue_cc_idx].phy_cfg.dl_cfg.dci.multiple_csi_request_enabled = multiple_csi_request_enabled;
+  }
+
+  if (ue != nullptr) {
+    _publish_config(*ue, std::move(cfg));
+    return;
+  }
+
+  // Create new UE, its pending ACKs are cleared before it becomes visible to the workers
+  std::unique_ptr<common_ue> new_ue(new common_ue(rnti));
+  for (uint32_t tti = 0; tti < TTIMOD_SZ; tti++) {
+    _clear_tti_pending(*new_ue, *cfg, tti);
   }
+  new_ue->config.store(cfg.release(), std::memory_order_relaxed);
+  _publish_table(new_ue.release(), nullptr);
 }
 
 int phy_ue_db::rem_rnti(uint16_t rnti)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  std::lock_guard<std::mutex> lock(writer_mutex);
 
-  if (ue_db.count(rnti) == 0) {
+  common_ue* ue = _find_ue(rnti);
+  if (ue == nullptr) {
     return SRSRAN_ERROR;
   }
 
-  ue_db.erase(rnti);
+  _publish_table(nullptr, ue);
 
   return SRSRAN_SUCCESS;
 }
 
-uint32_t phy_ue_db::_count_nof_configured_scell(uint16_t rnti)
+uint32_t phy_ue_db::_count_nof_configured_scell(const ue_config_t& cfg)
 {
   uint32_t nof_configured_scell = 0;
-  for (uint32_t ue_cc_idx = 0; ue_cc_idx < SRSRAN_MAX_CARRIERS; ue_cc_idx++) {
-    if (ue_db[rnti].cell_info[ue_cc_idx].state == cell_state_t::cell_state_secondary_inactive ||
-        ue_db[rnti].cell_info[ue_cc_idx].state == cell_state_t::cell_state_secondary_active) {
+  for (const cell_info_t& cell_info : cfg.cell_info) {
+    if (cell_info.state == cell_state_t::cell_state_secondary_inactive ||
+        cell_info.state == cell_state_t::cell_state_secondary_active) {
       nof_configured_scell++;
     }
   }
@@ -371,36 +433,41 @@ uint32_t phy_ue_db::_count_nof_configured_scell(uint16_t rnti)
 
 int phy_ue_db::complete_config(uint16_t rnti)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  std::lock_guard<std::mutex> lock(writer_mutex);
 
   // Makes sure the RNTI exists
-  if (_assert_rnti(rnti) != SRSRAN_SUCCESS) {
+  common_ue* ue = _find_ue(rnti);
+  if (ue == nullptr) {
     return SRSRAN_ERROR;
   }
 
   // Once the reconfiguration is complete, the temporary parameters become the new ones
+  std::unique_ptr<ue_config_t> cfg(new ue_config_t(*ue->config.load(std::memory_order_relaxed)));
 
   // Update temporary multiple CSI DCI field with the new value
-  ue_db[rnti].stashed_multiple_csi_request_enabled = (_count_nof_configured_scell(rnti) > 0);
+  cfg->stashed_multiple_csi_request_enabled = (_count_nof_configured_scell(*cfg) > 0);
   // Update temporary alternate TBS value with the new one
-  for (uint32_t ue_cc_idx = 0; ue_cc_idx < SRSRAN_MAX_CARRIERS; ue_cc_idx++) {
-    ue_db[rnti].cell_info[ue_cc_idx].stash_use_tbs_index_alt =
-        ue_db[rnti].cell_info[ue_cc_idx].phy_cfg.dl_cfg.pdsch.use_tbs_index_alt;
+  for (cell_info_t& cell_info : cfg->cell_info) {
+    cell_info.stash_use_tbs_index_alt = cell_info.phy_cfg.dl_cfg.pdsch.use_tbs_index_alt;
   }
 
+  _publish_config(*ue, std::move(cfg));
+
   return SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::activate_deactivate_scell(uint16_t rnti, uint32_t ue_cc_idx, bool activate)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  std::lock_guard<std::mutex> lock(writer_mutex);
 
   // Assert RNTI and SCell are valid
-  if (_assert_ue_cc(rnti, ue_cc_idx) != SRSRAN_SUCCESS) {
+  common_ue* ue = _find_ue(rnti);
+  if (ue == nullptr or _assert_ue_cc(*ue->config.load(std::memory_order_relaxed), ue_cc_idx) != SRSRAN_SUCCESS) {
     return SRSRAN_SUCCESS;
   }
 
-  cell_info_t& cell_info = ue_db[rnti].cell_info[ue_cc_idx];
+  std::unique_ptr<ue_config_t> cfg(new ue_config_t(*ue->config.load(std::memory_order_relaxed)));
+  cell_info_t&                 cell_info = cfg->cell_info[ue_cc_idx];
 
   // If scell is default only complain
   if (activate and cell_info.state == cell_state_none) {
@@ -410,103 +477,131 @@ int phy_ue_db::activate_deactivate_scell(uint16_t rnti, uint32_t ue_cc_idx, bool
   // Set scell state
   cell_info.state = (activate) ? cell_state_secondary_active : cell_state_secondary_inactive;
 
+  _publish_config(*ue, std::move(cfg));
+
   return SRSRAN_SUCCESS;
 }
 
 bool phy_ue_db::is_pcell(uint16_t rnti, uint32_t enb_cc_idx) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
-  return _assert_enb_pcell(rnti, enb_cc_idx) == SRSRAN_SUCCESS;
+  read_guard lock(*this);
+  common_ue* ue        = nullptr;
+  uint32_t   ue_cc_idx = 0;
+
+  const ue_config_t* cfg = _get_rnti_config(rnti, enb_cc_idx, ue, ue_cc_idx);
+  return cfg != nullptr and cfg->cell_info[ue_cc_idx].state == cell_state_primary;
 }
 
 int phy_ue_db::get_dl_config(uint16_t rnti, uint32_t enb_cc_idx, srsran_dl_cfg_t& dl_cfg) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
-  srsran::phy_cfg_t           phy_cfg = {};
+  // Use default configuration for non-user C-RNTI
+  if (not SRSRAN_RNTI_ISUSER(rnti)) {
+    dl_cfg            = default_cfg.dl_cfg;
+    dl_cfg.pdsch.rnti = rnti;
+    return SRSRAN_SUCCESS;
+  }
+
+  read_guard lock(*this);
+  common_ue* ue        = nullptr;
+  uint32_t   ue_cc_idx = 0;
 
-  if (_get_rnti_config(rnti, enb_cc_idx, phy_cfg) < SRSRAN_SUCCESS) {
+  const ue_config_t* cfg = _get_rnti_config(rnti, enb_cc_idx, ue, ue_cc_idx);
+  if (cfg == nullptr) {
     return SRSRAN_ERROR;
   }
-  dl_cfg = phy_cfg.dl_cfg;
+  dl_cfg = cfg->cell_info[ue_cc_idx].phy_cfg.dl_cfg;
 
   // The DL configuration must overwrite the use_tbs_index_alt value (for 256QAM) with the temporary value
   // in case we are in the middle of a reconfiguration
-  if (ue_db.count(rnti) && SRSRAN_RNTI_ISUSER(rnti)) {
-    uint32_t ue_cc_idx = _get_ue_cc_idx(rnti, enb_cc_idx);
-    if (ue_cc_idx == 0) {
-      dl_cfg.pdsch.use_tbs_index_alt = ue_db.at(rnti).cell_info[ue_cc_idx].stash_use_tbs_index_alt;
-    }
+  if (ue_cc_idx == 0) {
+    dl_cfg.pdsch.use_tbs_index_alt = cfg->cell_info[ue_cc_idx].stash_use_tbs_index_alt;
   }
   return SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::get_dci_dl_config(uint16_t rnti, uint32_t enb_cc_idx, srsran_dci_cfg_t& dci_cfg) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
-  srsran::phy_cfg_t           phy_cfg = {};
+  // Use default configuration for non-user C-RNTI
+  if (not SRSRAN_RNTI_ISUSER(rnti)) {
+    dci_cfg = default_cfg.dl_cfg.dci;
+    return SRSRAN_SUCCESS;
+  }
+
+  read_guard lock(*this);
+  common_ue* ue        = nullptr;
+  uint32_t   ue_cc_idx = 0;
 
-  if (_get_rnti_config(rnti, enb_cc_idx, phy_cfg) < SRSRAN_SUCCESS) {
+  const ue_config_t* cfg = _get_rnti_config(rnti, enb_cc_idx, ue, ue_cc_idx);
+  if (cfg == nullptr) {
     return SRSRAN_ERROR;
   }
-  dci_cfg = phy_cfg.dl_cfg.dci;
+  dci_cfg = cfg->cell_info[ue_cc_idx].phy_cfg.dl_cfg.dci;
 
   // The DCI configuration used for DL grants must overwrite the multiple_csi_request_enabled value with the
   // temporary value in case we are in the middle of a reconfiguration
-  if (ue_db.count(rnti) && SRSRAN_RNTI_ISUSER(rnti)) {
-    uint32_t ue_cc_idx = _get_ue_cc_idx(rnti, enb_cc_idx);
-    if (ue_cc_idx == 0) {
-      dci_cfg.multiple_csi_request_enabled = ue_db.at(rnti).stashed_multiple_csi_request_enabled;
-    }
+  if (ue_cc_idx == 0) {
+    dci_cfg.multiple_csi_request_enabled = cfg->stashed_multiple_csi_request_enabled;
   }
   return SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::get_ul_config(uint16_t rnti, uint32_t enb_cc_idx, srsran_ul_cfg_t& ul_cfg) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
-  srsran::phy_cfg_t           phy_cfg = {};
+  // Use default configuration for non-user C-RNTI
+  if (not SRSRAN_RNTI_ISUSER(rnti)) {
+    ul_cfg            = default_cfg.ul_cfg;
+    ul_cfg.pucch.rnti = rnti;
+    ul_cfg.pusch.rnti = rnti;
+    return SRSRAN_SUCCESS;
+  }
 
-  if (_get_rnti_config(rnti, enb_cc_idx, phy_cfg) < SRSRAN_SUCCESS) {
+  read_guard lock(*this);
+  common_ue* ue        = nullptr;
+  uint32_t   ue_cc_idx = 0;
+
+  const ue_config_t* cfg = _get_rnti_config(rnti, enb_cc_idx, ue, ue_cc_idx);
+  if (cfg == nullptr) {
     return SRSRAN_ERROR;
   }
-  ul_cfg = phy_cfg.ul_cfg;
+  ul_cfg = cfg->cell_info[ue_cc_idx].phy_cfg.ul_cfg;
 
   return SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::get_dci_ul_config(uint16_t rnti, uint32_t enb_cc_idx, srsran_dci_cfg_t& dci_cfg) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
-  srsran::phy_cfg_t           phy_cfg = {};
+  // Use default configuration for non-user C-RNTI
+  if (not SRSRAN_RNTI_ISUSER(rnti)) {
+    dci_cfg = default_cfg.dl_cfg.dci;
+    return SRSRAN_SUCCESS;
+  }
+
+  read_guard lock(*this);
+  common_ue* ue        = nullptr;
+  uint32_t   ue_cc_idx = 0;
 
-  if (_get_rnti_config(rnti, enb_cc_idx, phy_cfg) < SRSRAN_SUCCESS) {
+  const ue_config_t* cfg = _get_rnti_config(rnti, enb_cc_idx, ue, ue_cc_idx);
+  if (cfg == nullptr) {
     return SRSRAN_ERROR;
   }
-  dci_cfg = phy_cfg.dl_cfg.dci;
+  dci_cfg = cfg->cell_info[ue_cc_idx].phy_cfg.dl_cfg.dci;
 
   return SRSRAN_SUCCESS;
 }
 
 bool phy_ue_db::set_ack_pending(uint32_t tti, uint32_t enb_cc_idx, const srsran_dci_dl_t& dci)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  read_guard lock(*this);
+  common_ue* ue        = nullptr;
+  uint32_t   ue_cc_idx = 0;
 
   // Assert rnti and cell exits and it is active
-  if (_assert_active_enb_cc(dci.rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+  if (_get_rnti_config(dci.rnti, enb_cc_idx, ue, ue_cc_idx) == nullptr) {
     return false;
   }
 
-  common_ue& ue        = ue_db.at(dci.rnti);
-  uint32_t   ue_cc_idx = _get_ue_cc_idx(dci.rnti, enb_cc_idx);
-
-  srsran_pdsch_ack_cc_t& pdsch_ack_cc = ue.pdsch_ack[tti].cc[ue_cc_idx];
-  pdsch_ack_cc.M                      = 1; ///< Hardcoded for FDD
-
-  // Fill PDSCH ACK information
-  srsran_pdsch_ack_m_t& pdsch_ack_m  = pdsch_ack_cc.m[0]; ///< Assume FDD only
-  pdsch_ack_m.present                = true;
-  pdsch_ack_m.resource.grant_cc_idx  = ue_cc_idx; ///< Assumes no cross-carrier scheduling
-  pdsch_ack_m.resource.v_dai_dl      = 0;         ///< Ignore for FDD
+  // Fill PDSCH ACK information, assume FDD only
+  srsran_pdsch_ack_m_t pdsch_ack_m   = {};
   pdsch_ack_m.resource.n_cce         = dci.location.ncce;
   pdsch_ack_m.resource.tpc_for_pucch = dci.tpc_pucch;
 
@@ -515,11 +610,13 @@ bool phy_ue_db::set_ack_pending(uint32_t tti, uint32_t enb_cc_idx, const srsran_
     // Count only if the TB is enabled and the TB index is valid for the DCI format
     if (SRSRAN_DCI_IS_TB_EN(dci.tb[tb_idx]) and tb_idx < srsran_dci_format_max_tb(dci.format)) {
       pdsch_ack_m.value[tb_idx] = 1;
-      pdsch_ack_m.k++;
     } else {
       pdsch_ack_m.value[tb_idx] = 2;
     }
   }
+
+  // Each carrier is only scheduled by its own worker, a single store publishes the whole entry
+  ue->pdsch_ack[TTIMOD(tti)].cc[ue_cc_idx].store(pack_ack_cc(pdsch_ack_m), std::memory_order_release);
   return true;
 }
 
@@ -530,7 +627,7 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
                             bool              is_pusch_available,
                             srsran_uci_cfg_t& uci_cfg)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  read_guard lock(*this);
 
   // Reset UCI CFG, avoid returning carrying cached information
   uci_cfg = {};
@@ -541,12 +638,15 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
   }
 
   // Assert eNb Cell/Carrier for the given RNTI
-  if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+  common_ue*         ue        = nullptr;
+  uint32_t           ue_cc_idx = 0;
+  const ue_config_t* cfg       = _get_rnti_config(rnti, enb_cc_idx, ue, ue_cc_idx);
+  if (cfg == nullptr) {
     return SRSRAN_ERROR;
   }
 
   // Get the eNb cell/carrier index with lowest serving cell index (ue_cc_idx) that has an available grant.
-  uint32_t uci_enb_cc_id         = _get_uci_enb_cc_idx(tti, rnti);
+  uint32_t uci_enb_cc_id         = _get_uci_enb_cc_idx(tti, *ue, *cfg);
   bool     pusch_grant_available = (uci_enb_cc_id < (uint32_t)cell_cfg_list->size());
 
   // There is a PUSCH grant available for the provided RNTI in at least one serving cell and this call is for PUCCH
@@ -560,15 +660,14 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
   }
 
   // No PUSCH grant for this TTI and cell and no enb_cc_idx is not the PCell
-  if (not pusch_grant_available and _get_ue_cc_idx(rnti, enb_cc_idx) != 0) {
+  if (not pusch_grant_available and ue_cc_idx != 0) {
     return SRSRAN_SUCCESS;
   }
 
-  common_ue&               ue           = ue_db.at(rnti);
-  const srsran::phy_cfg_t& pcell_cfg    = ue.cell_info[0].phy_cfg;
+  const srsran::phy_cfg_t& pcell_cfg    = cfg->cell_info[0].phy_cfg;
   bool                     uci_required = false;
 
-  const cell_info_t&   pcell_info = ue.cell_info[0];
+  const cell_info_t&   pcell_info = cfg->cell_info[0];
   const srsran_cell_t& pcell      = cell_cfg_list->at(pcell_info.enb_cc_idx).cell;
 
   // Check if SR opportunity (will only be used in PUCCH)
@@ -578,7 +677,7 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
   // Get pending CQI reports for this TTI, stops at first CC reporting
   bool periodic_cqi_required = false;
   for (uint32_t cell_idx = 0; cell_idx < SRSRAN_MAX_CARRIERS and not periodic_cqi_required; cell_idx++) {
-    const cell_info_t&     cell_info = ue.cell_info[cell_idx];
+    const cell_info_t&     cell_info = cfg->cell_info[cell_idx];
     const srsran_dl_cfg_t& dl_cfg    = cell_info.phy_cfg.dl_cfg;
 
     // According 3GPP 36.213 R10 section 7.2 UE procedure for reporting Channel State Information (CSI)
@@ -587,7 +686,8 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
       const srsran_cell_t& cell = cell_cfg_list->at(cell_info.enb_cc_idx).cell;
 
       // Check if CQI report is required
-      periodic_cqi_required = srsran_enb_dl_gen_cqi_periodic(&cell, &dl_cfg, tti, cell_info.last_ri, &uci_cfg.cqi);
+      uint32_t last_ri      = ue->last_ri[cell_idx].load(std::memory_order_relaxed);
+      periodic_cqi_required = srsran_enb_dl_gen_cqi_periodic(&cell, &dl_cfg, tti, last_ri, &uci_cfg.cqi);
 
       // Save SCell index for using it after
       uci_cfg.cqi.scell_index = cell_idx;
@@ -598,16 +698,18 @@ int phy_ue_db::fill_uci_cfg(uint32_t          tti,
   // If no periodic CQI report required, check aperiodic reporting
   if ((not periodic_cqi_required) and aperiodic_cqi_request) {
     // Aperiodic only supported for PCell
-    const srsran_dl_cfg_t& dl_cfg = pcell_info.phy_cfg.dl_cfg;
+    const srsran_dl_cfg_t& dl_cfg  = pcell_info.phy_cfg.dl_cfg;
+    uint32_t               last_ri = ue->last_ri[0].load(std::memory_order_relaxed);
 
-    uci_required = srsran_enb_dl_gen_cqi_aperiodic(&pcell, &dl_cfg, pcell_info.last_ri, &uci_cfg.cqi);
+    uci_required = srsran_enb_dl_gen_cqi_aperiodic(&pcell, &dl_cfg, last_ri, &uci_cfg.cqi);
   }
 
   // Get pending ACKs from PDSCH
-  srsran_dl_sf_cfg_t dl_sf_cfg  = {};
-  dl_sf_cfg.tti                 = tti;
-  srsran_pdsch_ack_t& pdsch_ack = ue.pdsch_ack[tti];
-  pdsch_ack.is_pusch_available  = is_pusch_available;
+  srsran_dl_sf_cfg_t dl_sf_cfg = {};
+  dl_sf_cfg.tti                = tti;
+  srsran_pdsch_ack_t pdsch_ack = {};
+  _get_tti_pending(*ue, tti, pdsch_ack);
+  pdsch_ack.is_pusch_available = is_pusch_available;
   srsran_enb_dl_gen_ack(&pcell, &dl_sf_cfg, &pdsch_ack, &uci_cfg);
   uci_required |= (srsran_uci_cfg_total_ack(&uci_cfg) > 0);
 
@@ -660,10 +762,13 @@ int phy_ue_db::send_uci_data(uint32_t                  tti,
                              const srsran_uci_cfg_t&   uci_cfg,
                              const srsran_uci_value_t& uci_value)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  read_guard lock(*this);
 
   // Assert UE RNTI database entry and eNb cell/carrier must be active
-  if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+  common_ue*         ue        = nullptr;
+  uint32_t           ue_cc_idx = 0;
+  const ue_config_t* cfg       = _get_rnti_config(rnti, enb_cc_idx, ue, ue_cc_idx);
+  if (cfg == nullptr) {
     return SRSRAN_ERROR;
   }
 
@@ -677,22 +782,21 @@ int phy_ue_db::send_uci_data(uint32_t                  tti,
     stack->sr_detected(tti, rnti);
   }
 
-  // Get UE
-  common_ue& ue = ue_db.at(rnti);
-
-  // Get ACK info
-  srsran_pdsch_ack_t& pdsch_ack = ue.pdsch_ack[tti];
-  const srsran_cell_t& cell      = cell_cfg_list->at(ue.cell_info[0].enb_cc_idx).cell;
+  // Get ACK info. The UCI is carried on PUSCH if, and only if, this carrier has an UL grant
+  srsran_pdsch_ack_t pdsch_ack = {};
+  _get_tti_pending(*ue, tti, pdsch_ack);
+  pdsch_ack.is_pusch_available = (ue->ul_grant_mask[TTIMOD(tti)].load(std::memory_order_relaxed) & (1U << ue_cc_idx));
+  const srsran_cell_t& cell    = cell_cfg_list->at(cfg->cell_info[0].enb_cc_idx).cell;
   srsran_enb_dl_get_ack(&cell, &uci_cfg, &uci_value, &pdsch_ack);
 
   // Iterate over the ACK information
-  for (uint32_t ue_cc_idx = 0; ue_cc_idx < SRSRAN_MAX_CARRIERS; ue_cc_idx++) {
-    const srsran_pdsch_ack_cc_t& pdsch_ack_cc = pdsch_ack.cc[ue_cc_idx];
+  for (uint32_t cc_idx = 0; cc_idx < SRSRAN_MAX_CARRIERS; cc_idx++) {
+    const srsran_pdsch_ack_cc_t& pdsch_ack_cc = pdsch_ack.cc[cc_idx];
     for (uint32_t m = 0; m < pdsch_ack_cc.M; m++) {
       if (pdsch_ack_cc.m[m].present) {
         for (uint32_t tb = 0; tb < SRSRAN_MAX_CODEWORDS; tb++) {
           if (pdsch_ack_cc.m[m].value[tb] != 2) {
-            stack->ack_info(tti, rnti, ue.cell_info[ue_cc_idx].enb_cc_idx, tb, pdsch_ack_cc.m[m].value[tb] == 1);
+            stack->ack_info(tti, rnti, cfg->cell_info[cc_idx].enb_cc_idx, tb, pdsch_ack_cc.m[m].value[tb] == 1);
           }
         }
       }
@@ -700,19 +804,20 @@ int phy_ue_db::send_uci_data(uint32_t                  tti,
   }
 
   // Assert the SCell exists and it is active
-  if (_assert_ue_cc(rnti, uci_cfg.cqi.scell_index) != SRSRAN_SUCCESS) {
+  if (_assert_ue_cc(*cfg, uci_cfg.cqi.scell_index) != SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
 
   // Get CQI carrier index
-  cell_info_t& cqi_scell_info = ue_db.at(rnti).cell_info[uci_cfg.cqi.scell_index];
-  uint32_t     cqi_cc_idx     = cqi_scell_info.enb_cc_idx;
+  const cell_info_t& cqi_scell_info = cfg->cell_info[uci_cfg.cqi.scell_index];
+  uint32_t           cqi_cc_idx     = cqi_scell_info.enb_cc_idx;
 
   // Notify CQI only if CRC is valid
   if (uci_value.cqi.data_crc) {
     // Channel quality indicator itself
     if (uci_cfg.cqi.data_enable) {
-      send_cqi_data(tti, rnti, cqi_cc_idx, uci_cfg.cqi, uci_value.cqi, ue.cell_info[0].phy_cfg.dl_cfg.cqi_report, cell, stack);
+      send_cqi_data(
+          tti, rnti, cqi_cc_idx, uci_cfg.cqi, uci_value.cqi, cfg->cell_info[0].phy_cfg.dl_cfg.cqi_report, cell, stack);
     }
 
     // Precoding Matrix indicator (TM4)
@@ -736,7 +841,7 @@ int phy_ue_db::send_uci_data(uint32_t                  tti,
   // Rank indicator (TM3 and TM4)
   if (uci_cfg.cqi.ri_len) {
     stack->ri_info(tti, rnti, cqi_cc_idx, uci_value.ri);
-    cqi_scell_info.last_ri = uci_value.ri;
+    ue->last_ri[uci_cfg.cqi.scell_index].store(uci_value.ri, std::memory_order_relaxed);
   }
 
   return SRSRAN_SUCCESS;
@@ -744,44 +849,73 @@ int phy_ue_db::send_uci_data(uint32_t                  tti,
 
 int phy_ue_db::set_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid, srsran_ra_tb_t tb)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  read_guard lock(*this);
 
   // Assert UE DB entry
-  if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+  common_ue* ue        = nullptr;
+  uint32_t   ue_cc_idx = 0;
+  if (_get_rnti_config(rnti, enb_cc_idx, ue, ue_cc_idx) == nullptr or pid >= SRSRAN_MAX_HARQ_PROC) {
     return SRSRAN_ERROR;
   }
 
-  // Save resource allocation
-  ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].last_tb[pid] = tb;
+  // Save resource allocation. Only the worker of the carrier writes it, the sequence counter lets readers detect a
+  // concurrent update
+  last_tb_t& last_tb = ue->last_tb[ue_cc_idx][pid];
+  uint32_t   seq     = last_tb.seq.load(std::memory_order_relaxed);
+  last_tb.seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  last_tb.tbs.store(((uint64_t)(uint32_t)tb.tbs << 32U) | tb.nof_bits, std::memory_order_relaxed);
+  last_tb.aux.store(((uint64_t)tb.mcs_idx << 32U) | ((uint64_t)(tb.mod & 0xff) << 24U) | ((tb.rv & 0xff) << 16U) |
+                        ((tb.cw_idx & 0xff) << 8U) | (tb.enabled ? 1U : 0U),
+                    std::memory_order_relaxed);
+  last_tb.seq.store(seq + 2, std::memory_order_release);
 
   return SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::get_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid, srsran_ra_tb_t& ra_tb) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  read_guard lock(*this);
 
   // Assert UE DB entry
-  if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+  common_ue* ue        = nullptr;
+  uint32_t   ue_cc_idx = 0;
+  if (_get_rnti_config(rnti, enb_cc_idx, ue, ue_cc_idx) == nullptr or pid >= SRSRAN_MAX_HARQ_PROC) {
     return SRSRAN_ERROR;
   }
 
-  // writes the latest stored UL transmission grant
-  ra_tb = ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].last_tb[pid];
+  // Reads the latest stored UL transmission grant, retrying if it was being written
+  const last_tb_t& last_tb = ue->last_tb[ue_cc_idx][pid];
+  uint32_t         seq     = 0;
+  uint64_t         tbs     = 0;
+  uint64_t         aux     = 0;
+  do {
+    seq = last_tb.seq.load(std::memory_order_acquire);
+    tbs = last_tb.tbs.load(std::memory_order_relaxed);
+    aux = last_tb.aux.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((seq & 1U) != 0 or seq != last_tb.seq.load(std::memory_order_relaxed));
+
+  ra_tb          = {};
+  ra_tb.tbs      = (int)(uint32_t)(tbs >> 32U);
+  ra_tb.nof_bits = (uint32_t)tbs;
+  ra_tb.mcs_idx  = (uint32_t)(aux >> 32U);
+  ra_tb.mod      = (srsran_mod_t)((aux >> 24U) & 0xff);
+  ra_tb.rv       = (int)((aux >> 16U) & 0xff);
+  ra_tb.cw_idx   = (uint32_t)((aux >> 8U) & 0xff);
+  ra_tb.enabled  = (aux & 1U) != 0;
 
   return SRSRAN_SUCCESS;
 }
 
 int phy_ue_db::set_ul_grant_available(uint32_t tti, const stack_interface_phy_lte::ul_sched_list_t& ul_sched_list)
 {
-  int                         ret = SRSRAN_SUCCESS;
-  std::lock_guard<std::mutex> lock(mutex);
+  int        ret = SRSRAN_SUCCESS;
+  read_guard lock(*this);
 
   // Reset all available grants flags for the given TTI
-  for (auto& ue : ue_db) {
-    for (cell_info_t& cell_info : ue.second.cell_info) {
-      cell_info.is_grant_available[tti] = false;
-    }
+  for (common_ue* ue : table.load(std::memory_order_acquire)->ues) {
+    ue->ul_grant_mask[TTIMOD(tti)].store(0, std::memory_order_relaxed);
   }
 
   // For each eNb Cell/Carrier grant set a flag to the corresponding RNTI
@@ -790,14 +924,16 @@ int phy_ue_db::set_ul_grant_available(uint32_t tti, const stack_interface_phy_lt
     for (uint32_t i = 0; i < ul_sched.nof_grants; i++) {
       const stack_interface_phy_lte::ul_sched_grant_t& ul_sched_grant = ul_sched.pusch[i];
       uint16_t                                         rnti           = ul_sched_grant.dci.rnti;
+      common_ue*                                       ue             = nullptr;
+      uint32_t                                         ue_cc_idx      = 0;
       // Check that eNb Cell/Carrier is active for the given RNTI
-      if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
+      if (_get_rnti_config(rnti, enb_cc_idx, ue, ue_cc_idx) == nullptr) {
         ret = SRSRAN_ERROR;
         srslog::fetch_basic_logger("PHY").info("Error setting grant for rnti=0x%x, cc=%d", rnti, enb_cc_idx);
         continue;
       }
       // Rise Grant available flag
-      ue_db[rnti].cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].is_grant_available[tti] = true;
+      ue->ul_grant_mask[TTIMOD(tti)].fetch_or(1U << ue_cc_idx, std::memory_order_relaxed);
     }
   }
 
@@ -32,6 +32,16 @@ using namespace srsran;
 
 namespace srsenb {
 
+static pcap_writer_args_t make_pcap_writer_args(const pcap_file_args_t& file_args, const std::string& filename)
+{
+  pcap_writer_args_t writer_args;
+  writer_args.filename      = filename;
+  writer_args.format        = (file_args.format == "pcapng") ? pcap_file_format::pcapng : pcap_file_format::pcap;
+  writer_args.max_file_size = (uint64_t)file_args.max_file_size * 1024 * 1024;
+  writer_args.max_nof_files = file_args.max_files;
+  return writer_args;
+}
+
 enb_stack_lte::enb_stack_lte(srslog::sink& log_sink) :
   thread("STACK"),
   mac_logger(srslog::fetch_basic_logger("MAC", log_sink)),
@@ -98,9 +108,21 @@ int enb_stack_lte::init(const stack_args_t&      args_,
   s1ap_logger.set_hex_dump_max_size(args.log.s1ap_hex_limit);
   stack_logger.set_hex_dump_max_size(args.log.stack_hex_limit);
 
+  // Rate limit the verbose levels, warnings and errors are always logged
+  srslog::rate_limit_config log_rate_cfg;
+  log_rate_cfg.max_rate      = args.log.max_rate;
+  log_rate_cfg.burst         = std::max(args.log.max_rate / 10, 1U);
+  log_rate_cfg.sample_period = args.log.sample_period;
+  log_rate_cfg.per_key       = true;
+  for (srslog::basic_logger* logger :
+       {&mac_logger, &rlc_logger, &pdcp_logger, &rrc_logger, &gtpu_logger, &s1ap_logger, &stack_logger}) {
+    logger->info.set_rate_limit(log_rate_cfg);
+    logger->debug.set_rate_limit(log_rate_cfg);
+  }
+
   // Set up pcap and trace
   if (args.mac_pcap.enable) {
-    mac_pcap.open(args.mac_pcap.filename);
+    mac_pcap.open(make_pcap_writer_args(args.pcap_file, args.mac_pcap.filename));
     mac.start_pcap(&mac_pcap);
   }
 
@@ -113,8 +135,11 @@ int enb_stack_lte::init(const stack_args_t&      args_,
   }
 
   if (args.s1ap_pcap.enable) {
-    s1ap_pcap.open(args.s1ap_pcap.filename.c_str());
-    s1ap.start_pcap(&s1ap_pcap);
+    if (s1ap_pcap.open(make_pcap_writer_args(args.pcap_file, args.s1ap_pcap.filename)) == SRSRAN_SUCCESS) {
+      s1ap.start_pcap(&s1ap_pcap);
+    } else {
+      stack_logger.error("Couldn't open %s to write S1AP PCAP", args.s1ap_pcap.filename.c_str());
+    }
   }
 
   // add sync queue
@@ -24,7 +24,6 @@
 
 #include "srsenb/hdr/stack/mac/mac.h"
 #include "srsran/adt/pool/obj_pool.h"
-#include "srsran/common/rwlock_guard.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/time_prof.h"
 #include "srsran/interfaces/enb_phy_interfaces.h"
@@ -40,14 +39,12 @@ namespace srsenb {
 mac::mac(srsran::ext_task_sched_handle task_sched_, srslog::basic_logger& logger) :
   logger(logger), rar_payload(), common_buffers(SRSRAN_MAX_CARRIERS), task_sched(task_sched_)
 {
-  pthread_rwlock_init(&rwlock, nullptr);
   stack_task_queue = task_sched.make_task_queue();
 }
 
 mac::~mac()
 {
   stop();
-  pthread_rwlock_destroy(&rwlock);
 }
 
 bool mac::init(const mac_args_t&        args_,
@@ -96,10 +93,10 @@ bool mac::init(const mac_args_t&        args_,
 
 void mac::stop()
 {
-  srsran::rwlock_write_guard lock(rwlock);
   if (started) {
     started = false;
 
+    // Waits for all the PHY workers to leave the UE table before releasing the common buffers
     ue_db.clear();
     for (auto& cc : common_buffers) {
       for (int i = 0; i < NOF_BCCH_DLSCH_MSG; i++) {
@@ -113,22 +110,18 @@ void mac::stop()
 
 void mac::start_pcap(srsran::mac_pcap* pcap_)
 {
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
   pcap = pcap_;
   // Set pcap in all UEs for UL messages
-  for (auto& u : ue_db) {
-    u.second->start_pcap(pcap);
-  }
+  ue_db.for_each([this](uint16_t rnti, ue& u) { u.start_pcap(pcap); });
 }
 
 void mac::start_pcap_net(srsran::mac_pcap_net* pcap_net_)
 {
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
   pcap_net = pcap_net_;
   // Set pcap in all UEs for UL messages
-  for (auto& u : ue_db) {
-    u.second->start_pcap_net(pcap_net);
-  }
+  ue_db.for_each([this](uint16_t rnti, ue& u) { u.start_pcap_net(pcap_net); });
 }
 
 /********************************************************
@@ -139,8 +132,8 @@ void mac::start_pcap_net(srsran::mac_pcap_net* pcap_net_)
 
 int mac::rlc_buffer_state(uint16_t rnti, uint32_t lc_id, uint32_t tx_queue, uint32_t retx_queue)
 {
-  srsran::rwlock_read_guard lock(rwlock);
-  int                       ret = -1;
+  ue_db_t::read_guard lock(ue_db);
+  int                 ret = -1;
   if (check_ue_active(rnti)) {
     if (rnti != SRSRAN_MRNTI) {
       ret = scheduler.dl_rlc_buffer_state(rnti, lc_id, tx_queue, retx_queue);
@@ -158,13 +151,13 @@ int mac::rlc_buffer_state(uint16_t rnti, uint32_t lc_id, uint32_t tx_queue, uint
 
 int mac::bearer_ue_cfg(uint16_t rnti, uint32_t lc_id, mac_lc_ch_cfg_t* cfg)
 {
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
   return check_ue_active(rnti) ? scheduler.bearer_ue_cfg(rnti, lc_id, *cfg) : -1;
 }
 
 int mac::bearer_ue_rem(uint16_t rnti, uint32_t lc_id)
 {
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
   return check_ue_active(rnti) ? scheduler.bearer_ue_rem(rnti, lc_id) : -1;
 }
 
@@ -176,11 +169,11 @@ void mac::phy_config_enabled(uint16_t rnti, bool enabled)
 // Update UE configuration
 int mac::ue_cfg(uint16_t rnti, const sched_interface::ue_cfg_t* cfg)
 {
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
   if (not check_ue_active(rnti)) {
     return SRSRAN_ERROR;
   }
-  ue* ue_ptr = ue_db[rnti].get();
+  ue* ue_ptr = ue_db[rnti];
 
   // Start TA FSM in UE entity
   ue_ptr->start_ta();
@@ -202,7 +195,7 @@ int mac::ue_rem(uint16_t rnti)
 {
   // Remove UE from the perspective of L2/L3
   {
-    srsran::rwlock_read_guard lock(rwlock);
+    ue_db_t::read_guard lock(ue_db);
     if (check_ue_active(rnti)) {
       ue_db[rnti]->set_active(false);
     } else {
@@ -216,7 +209,6 @@ int mac::ue_rem(uint16_t rnti)
   // Note: Let any pending retx ACK to arrive, so that PHY recognizes rnti
   task_sched.defer_callback(FDD_HARQ_DELAY_DL_MS + FDD_HARQ_DELAY_UL_MS, [this, rnti]() {
     phy_h->rem_rnti(rnti);
-    srsran::rwlock_write_guard lock(rwlock);
     ue_db.erase(rnti);
     logger.info("User rnti=0x%x removed from MAC/PHY", rnti);
   });
@@ -226,7 +218,7 @@ int mac::ue_rem(uint16_t rnti)
 // Called after Msg3
 int mac::ue_set_crnti(uint16_t temp_crnti, uint16_t crnti, const sched_interface::ue_cfg_t& cfg)
 {
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
   if (temp_crnti == crnti) {
     // Schedule ConRes Msg4
     scheduler.dl_mac_buffer_state(crnti, (uint32_t)srsran::dl_sch_lcid::CON_RES_ID);
@@ -234,28 +226,31 @@ int mac::ue_set_crnti(uint16_t temp_crnti, uint16_t crnti, const sched_interface
   return ue_cfg(crnti, &cfg);
 }
 
+// Note: Called once during the eNB initialization, before the PHY workers start
 int mac::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg_)
 {
-  srsran::rwlock_write_guard lock(rwlock);
   cell_config = cell_cfg_;
   return scheduler.cell_cfg(cell_config);
 }
 
 void mac::get_metrics(mac_metrics_t& metrics)
 {
-  srsran::rwlock_read_guard lock(rwlock);
+  // Release the UEs removed since the last period, in case no other UE was added or removed since then
+  ue_db.reclaim();
+
+  ue_db_t::read_guard lock(ue_db);
   metrics.ues.reserve(ue_db.size());
-  for (auto& u : ue_db) {
-    if (not scheduler.ue_exists(u.first)) {
-      continue;
+  ue_db.for_each([this, &metrics](uint16_t rnti, ue& u) {
+    if (not scheduler.ue_exists(rnti)) {
+      return;
     }
     metrics.ues.emplace_back();
     auto& ue_metrics = metrics.ues.back();
 
-    u.second->metrics_read(&ue_metrics);
-    scheduler.metrics_read(u.first, ue_metrics);
+    u.metrics_read(&ue_metrics);
+    scheduler.metrics_read(rnti, ue_metrics);
     ue_metrics.pci = (ue_metrics.cc_idx < cell_config.size()) ? cell_config[ue_metrics.cc_idx].cell.id : 0;
-  }
+  });
   metrics.cc_info.resize(detected_rachs.size());
   for (unsigned cc = 0, e = detected_rachs.size(); cc != e; ++cc) {
     metrics.cc_info[cc].cc_rach_counter = detected_rachs[cc];
@@ -270,13 +265,11 @@ void mac::toggle_padding()
 
 void mac::add_padding()
 {
-  srsran::rwlock_read_guard lock(rwlock);
-  for (auto it = ue_db.begin(); it != ue_db.end(); ++it) {
-    uint16_t cur_rnti = it->first;
-    auto     ue       = it;
-    scheduler.dl_rlc_buffer_state(ue->first, args.lcid_padding, 20e6, 0);
-    ue->second->trigger_padding(args.lcid_padding);
-  }
+  ue_db_t::read_guard lock(ue_db);
+  ue_db.for_each([this](uint16_t rnti, ue& u) {
+    scheduler.dl_rlc_buffer_state(rnti, args.lcid_padding, 20e6, 0);
+    u.trigger_padding(args.lcid_padding);
+  });
 }
 
 /********************************************************
@@ -288,7 +281,7 @@ void mac::add_padding()
 int mac::ack_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack)
 {
   logger.set_context(tti_rx);
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
 
   if (not check_ue_active(rnti)) {
     return SRSRAN_ERROR;
@@ -305,7 +298,7 @@ int mac::ack_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t
 int mac::crc_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t nof_bytes, bool crc)
 {
   logger.set_context(tti_rx);
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
 
   if (not check_ue_active(rnti)) {
     return SRSRAN_ERROR;
@@ -327,7 +320,7 @@ int mac::push_pdu(uint32_t tti_rx,
                   bool     crc,
                   uint32_t ul_nof_prbs)
 {
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
 
   if (not check_ue_active(rnti)) {
     return SRSRAN_ERROR;
@@ -349,7 +342,7 @@ int mac::push_pdu(uint32_t tti_rx,
                   nof_bytes,
                   (int)pdu->size());
     auto process_pdu_task = [this, rnti, enb_cc_idx, ul_nof_prbs](srsran::unique_byte_buffer_t& pdu) {
-      srsran::rwlock_read_guard lock(rwlock);
+      ue_db_t::read_guard lock(ue_db);
       if (check_ue_active(rnti)) {
         ue_db[rnti]->process_pdu(std::move(pdu), enb_cc_idx, ul_nof_prbs);
       } else {
@@ -366,7 +359,7 @@ int mac::push_pdu(uint32_t tti_rx,
 int mac::ri_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t ri_value)
 {
   logger.set_context(tti);
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
 
   if (not check_ue_active(rnti)) {
     return SRSRAN_ERROR;
@@ -381,7 +374,7 @@ int mac::ri_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t ri_v
 int mac::pmi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t pmi_value)
 {
   logger.set_context(tti);
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
 
   if (not check_ue_active(rnti)) {
     return SRSRAN_ERROR;
@@ -396,7 +389,7 @@ int mac::pmi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t pmi
 int mac::cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t cqi_value)
 {
   logger.set_context(tti);
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
 
   if (not check_ue_active(rnti)) {
     return SRSRAN_ERROR;
@@ -411,7 +404,7 @@ int mac::cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t cqi
 int mac::sb_cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t sb_idx, uint32_t cqi_value)
 {
   logger.set_context(tti);
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
 
   if (not check_ue_active(rnti)) {
     return SRSRAN_ERROR;
@@ -424,7 +417,7 @@ int mac::sb_cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t
 int mac::snr_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, float snr, ul_channel_t ch)
 {
   logger.set_context(tti_rx);
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
 
   if (not check_ue_active(rnti)) {
     return SRSRAN_ERROR;
@@ -435,9 +428,27 @@ int mac::snr_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, float snr
   return scheduler.ul_snr_info(tti_rx, rnti, enb_cc_idx, snr, (uint32_t)ch);
 }
 
+int mac::sb_snr_info(uint32_t     tti_rx,
+                     uint16_t     rnti,
+                     uint32_t     enb_cc_idx,
+                     uint32_t     prb_start,
+                     uint32_t     sb_nof_prb,
+                     const float* sb_snr_db,
+                     uint32_t     nof_sb)
+{
+  logger.set_context(tti_rx);
+  ue_db_t::read_guard lock(ue_db);
+
+  if (not check_ue_active(rnti)) {
+    return SRSRAN_ERROR;
+  }
+
+  return scheduler.ul_sb_snr_info(tti_rx, rnti, enb_cc_idx, prb_start, sb_nof_prb, sb_snr_db, nof_sb);
+}
+
 int mac::ta_info(uint32_t tti, uint16_t rnti, float ta_us)
 {
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
 
   if (not check_ue_active(rnti)) {
     return SRSRAN_ERROR;
@@ -453,7 +464,7 @@ int mac::ta_info(uint32_t tti, uint16_t rnti, float ta_us)
 int mac::sr_detected(uint32_t tti, uint16_t rnti)
 {
   logger.set_context(tti);
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
 
   if (not check_ue_active(rnti)) {
     return SRSRAN_ERROR;
@@ -485,30 +496,21 @@ uint16_t mac::allocate_ue(uint32_t enb_cc_idx)
     rnti = FIRST_RNTI + (ue_counter.fetch_add(1, std::memory_order_relaxed) % 60000);
 
     // Pre-check if rnti is valid
-    {
-      srsran::rwlock_read_guard read_lock(rwlock);
-      if (ue_db.full()) {
-        logger.warning("Maximum number of connected UEs %zd connected to the eNB. Ignoring PRACH", SRSENB_MAX_UES);
-        return SRSRAN_INVALID_RNTI;
-      }
-      if (not is_valid_rnti_unprotected(rnti)) {
-        continue;
-      }
+    if (ue_db.full()) {
+      logger.warning("Maximum number of connected UEs %zd connected to the eNB. Ignoring PRACH", SRSENB_MAX_UES);
+      return SRSRAN_INVALID_RNTI;
+    }
+    if (not is_valid_rnti_unprotected(rnti)) {
+      continue;
     }
 
     // Allocate and initialize UE object
     unique_rnti_ptr<ue> ue_ptr = make_rnti_obj<ue>(
         rnti, rnti, enb_cc_idx, &scheduler, rrc_h, rlc_h, phy_h, logger, cells.size(), softbuffer_pool.get());
 
-    // Add UE to rnti map
-    srsran::rwlock_write_guard rw_lock(rwlock);
-    if (not is_valid_rnti_unprotected(rnti)) {
-      continue;
-    }
-    auto ret = ue_db.insert(rnti, std::move(ue_ptr));
-    if (ret.has_value()) {
-      inserted_ue = ret.value()->second.get();
-    } else {
+    // Add UE to rnti map. Fails if the rnti slot got taken in the meantime
+    inserted_ue = ue_db.insert(rnti, std::move(ue_ptr));
+    if (inserted_ue == nullptr) {
       logger.info("Failed to allocate rnti=0x%x. Attempting a different rnti.", rnti);
     }
   } while (inserted_ue == nullptr);
@@ -607,7 +609,7 @@ void mac::rach_detected(uint32_t tti, uint32_t enb_cc_idx, uint32_t preamble_idx
     scheduler.dl_rach_info(enb_cc_idx, rar_info);
 
     auto get_pci = [this, enb_cc_idx]() {
-      srsran::rwlock_read_guard lock(rwlock);
+      ue_db_t::read_guard lock(ue_db);
       return (enb_cc_idx < cell_config.size()) ? cell_config[enb_cc_idx].cell.id : 0;
     };
     uint32_t pci = get_pci();
@@ -642,7 +644,7 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
     add_padding();
   }
 
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
 
   for (uint32_t enb_cc_idx = 0; enb_cc_idx < cell_config.size(); enb_cc_idx++) {
     // Run scheduler with current info
@@ -808,9 +810,7 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
   }
 
   // Count number of TTIs for all active users
-  for (auto& u : ue_db) {
-    u.second->metrics_cnt();
-  }
+  ue_db.for_each([](uint16_t rnti, ue& u) { u.metrics_cnt(); });
 
   return SRSRAN_SUCCESS;
 }
@@ -850,8 +850,9 @@ void mac::build_mch_sched(uint32_t tbs)
 
 int mac::get_mch_sched(uint32_t tti, bool is_mcch, dl_sched_list_t& dl_sched_res_list)
 {
-  srsran::rwlock_read_guard lock(rwlock);
-  dl_sched_t*               dl_sched_res = &dl_sched_res_list[0];
+  ue_db_t::read_guard         lock(ue_db);
+  std::lock_guard<std::mutex> mch_lock(mch_mutex);
+  dl_sched_t*                 dl_sched_res = &dl_sched_res_list[0];
   logger.set_context(tti);
   srsran_ra_tb_t mcs      = {};
   srsran_ra_tb_t mcs_data = {};
@@ -915,9 +916,7 @@ int mac::get_mch_sched(uint32_t tti, bool is_mcch, dl_sched_list_t& dl_sched_res
   }
 
   // Count number of TTIs for all active users
-  for (auto& u : ue_db) {
-    u.second->metrics_cnt();
-  }
+  ue_db.for_each([](uint16_t rnti, ue& u) { u.metrics_cnt(); });
   return SRSRAN_SUCCESS;
 }
 
@@ -966,12 +965,10 @@ int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
 
   logger.set_context(TTI_SUB(tti_tx_ul, FDD_HARQ_DELAY_UL_MS + FDD_HARQ_DELAY_DL_MS));
 
-  srsran::rwlock_read_guard lock(rwlock);
+  ue_db_t::read_guard lock(ue_db);
 
   // Execute UE FSMs (e.g. TA)
-  for (auto& ue : ue_db) {
-    ue.second->tic();
-  }
+  ue_db.for_each([](uint16_t rnti, ue& u) { u.tic(); });
 
   for (uint32_t enb_cc_idx = 0; enb_cc_idx < cell_config.size(); enb_cc_idx++) {
     ul_sched_t* phy_ul_sched_res = &ul_sched_res_list[enb_cc_idx];
@@ -1032,9 +1029,7 @@ int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
     phy_ul_sched_res->nof_phich = sched_result.phich.size();
   }
   // clear old buffers from all users
-  for (auto& u : ue_db) {
-    u.second->clear_old_buffers(tti_tx_ul);
-  }
+  ue_db.for_each([tti_tx_ul](uint16_t rnti, ue& u) { u.clear_old_buffers(tti_tx_ul); });
   return SRSRAN_SUCCESS;
 }
 
@@ -1044,7 +1039,7 @@ void mac::write_mcch(const srsran::sib2_mbms_t* sib2_,
                      const uint8_t*             mcch_payload,
                      const uint8_t              mcch_payload_length)
 {
-  srsran::rwlock_write_guard lock(rwlock);
+  std::unique_lock<std::mutex> lock(mch_mutex);
   mcch               = *mcch_;
   mch.num_mtch_sched = this->mcch.pmch_info_list[0].nof_mbms_session_info;
   for (uint32_t i = 0; i < mch.num_mtch_sched; ++i) {
@@ -1058,14 +1053,15 @@ void mac::write_mcch(const srsran::sib2_mbms_t* sib2_,
   unique_rnti_ptr<ue> ue_ptr = make_rnti_obj<ue>(
       SRSRAN_MRNTI, SRSRAN_MRNTI, 0, &scheduler, rrc_h, rlc_h, phy_h, logger, cells.size(), softbuffer_pool.get());
 
-  auto ret = ue_db.insert(SRSRAN_MRNTI, std::move(ue_ptr));
-  if (!ret) {
+  lock.unlock();
+
+  if (ue_db.insert(SRSRAN_MRNTI, std::move(ue_ptr)) == nullptr) {
     logger.info("Failed to allocate rnti=0x%x.for eMBMS", SRSRAN_MRNTI);
   }
   rrc_h->add_user(SRSRAN_MRNTI, {});
 }
 
-// Internal helper function, caller must hold UE DB rwlock
+// Internal helper function, caller must be inside a UE DB read section
 bool mac::check_ue_active(uint16_t rnti)
 {
   if (not ue_db.contains(rnti)) {
@@ -304,6 +304,15 @@ void sched_ue::set_ul_snr(tti_point tti_rx, uint32_t enb_cc_idx, float snr, uint
   cells[enb_cc_idx].set_ul_snr(tti_rx, snr, ul_ch_code);
 }
 
+void sched_ue::set_ul_sb_snr(tti_point                 tti_rx,
+                             uint32_t                  enb_cc_idx,
+                             uint32_t                  prb_start,
+                             uint32_t                  sb_nof_prb,
+                             srsran::const_span<float> sb_snr_db)
+{
+  cells[enb_cc_idx].set_ul_sb_snr(tti_rx, prb_start, sb_nof_prb, sb_snr_db);
+}
+
 /*******************************************************
  *
  * Functions used to generate DCI grants
@@ -347,7 +356,11 @@ tbs_info sched_ue::allocate_new_dl_mac_pdu(sched::dl_sched_data_t* data,
                      h->get_id(),
                      pending_bytes);
     } else {
-      logger.info("SCHED: DL TB tb_idx=%d, tbs=%d, pid=%d did not get allocated.", tb, rem_tbs, h->get_id());
+      logger.info(srslog::rate_key{rnti},
+                  "SCHED: DL TB tb_idx=%d, tbs=%d, pid=%d did not get allocated.",
+                  tb,
+                  rem_tbs,
+                  h->get_id());
     }
     tb_info.tbs_bytes = 0;
     tb_info.mcs       = 0;
@@ -437,7 +450,7 @@ int sched_ue::generate_format1_common(uint32_t                          pid,
     tbinfo = allocate_new_dl_mac_pdu(data, h, user_mask, tti_tx_dl, enb_cc_idx, cfi, 0);
   } else {
     h->new_retx(user_mask, 0, tti_tx_dl, &tbinfo.mcs, &tbinfo.tbs_bytes, dci->location.ncce);
-    logger.debug("SCHED: Alloc format1 previous mcs=%d, tbs=%d", tbinfo.mcs, tbinfo.tbs_bytes);
+    logger.debug(srslog::rate_key{rnti}, "SCHED: Alloc format1 previous mcs=%d, tbs=%d", tbinfo.mcs, tbinfo.tbs_bytes);
   }
 
   if (tbinfo.tbs_bytes > 0) {
@@ -724,7 +737,8 @@ bool sched_ue::needs_cqi(uint32_t tti, uint32_t enb_cc_idx, bool will_send)
         if (will_send) {
           cqi_request_tti = tti;
         }
-        logger.debug("SCHED: Needs_cqi, last_sent=%d, will_be_sent=%d", cqi_request_tti, will_send);
+        logger.debug(
+            srslog::rate_key{rnti}, "SCHED: Needs_cqi, last_sent=%d, will_be_sent=%d", cqi_request_tti, will_send);
         ret = true;
       }
     }
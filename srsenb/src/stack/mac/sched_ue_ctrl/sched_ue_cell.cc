@@ -57,7 +57,8 @@ sched_ue_cell::sched_ue_cell(uint16_t rnti_, const sched_cell_params_t& cell_cfg
   fixed_mcs_ul(cell_cfg_.sched_cfg->pusch_mcs),
   current_tti(current_tti_),
   max_aggr_level(cell_cfg_.sched_cfg->max_aggr_level >= 0 ? cell_cfg_.sched_cfg->max_aggr_level : 3),
-  dl_cqi_ctxt(cell_cfg_.nof_prb(), 0, cell_cfg_.sched_cfg->init_dl_cqi)
+  dl_cqi_ctxt(cell_cfg_.nof_prb(), 0, cell_cfg_.sched_cfg->init_dl_cqi),
+  ul_snr_ctxt(cell_cfg_.nof_prb())
 {
   float target_bler = cell_cfg->sched_cfg->target_bler;
   dl_delta_inc      = cell_cfg->sched_cfg->adaptive_dl_mcs_step_size; // delta_{down} of OLLA
@@ -173,6 +174,7 @@ void sched_ue_cell::clear_feedback()
   dl_pmi_tti_rx = tti_point{};
   dl_cqi_ctxt.reset_cqi(ue_cc_idx == 0 ? cell_cfg->sched_cfg->init_dl_cqi : 1);
   ul_cqi_tti_rx = tti_point{};
+  ul_snr_ctxt.reset();
 }
 
 void sched_ue_cell::finish_tti(tti_point tti_rx)
@@ -282,6 +284,20 @@ int sched_ue_cell::set_ul_snr(tti_point tti_rx, float ul_snr, uint32_t ul_ch_cod
   return SRSRAN_SUCCESS;
 }
 
+int sched_ue_cell::set_ul_sb_snr(tti_point                 tti_rx,
+                                 uint32_t                  prb_start,
+                                 uint32_t                  sb_nof_prb,
+                                 srsran::const_span<float> sb_snr_db)
+{
+  CHECK_VALID_CC("UL subband SNR estimate");
+  ul_snr_ctxt.sb_snr_info(tti_rx, prb_start, sb_nof_prb, sb_snr_db);
+  logger.debug("SCHED: UL subband SNR cc=%d, prb_start=%d, nof_sb=%zd",
+               cell_cfg->enb_cc_idx,
+               prb_start,
+               sb_snr_db.size());
+  return SRSRAN_SUCCESS;
+}
+
 int sched_ue_cell::get_ul_cqi() const
 {
   if (not ul_cqi_tti_rx.is_valid()) {
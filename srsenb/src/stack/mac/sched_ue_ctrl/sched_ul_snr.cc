@@ -0,0 +1,98 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/sched_ue_ctrl/sched_ul_snr.h"
+
+namespace srsenb {
+
+void sched_ul_snr::sb_snr_info(tti_point tti, uint32_t prb_start, uint32_t sb_nof_prb, srsran::const_span<float> sb_snr_db)
+{
+  for (uint32_t sb = 0; sb < sb_snr_db.size(); ++sb) {
+    for (uint32_t prb = prb_start + sb * sb_nof_prb; prb < prb_start + (sb + 1) * sb_nof_prb and prb < cell_nof_prb;
+         ++prb) {
+      prb_snr[prb] = sb_snr_db[sb];
+      prb_tti[prb] = tti;
+    }
+  }
+}
+
+void sched_ul_snr::reset()
+{
+  std::fill(prb_tti.begin(), prb_tti.end(), tti_point{});
+}
+
+bool sched_ul_snr::is_snr_info_valid(tti_point tti) const
+{
+  for (uint32_t prb = 0; prb < cell_nof_prb; ++prb) {
+    if (is_prb_valid(tti, prb)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+prb_interval sched_ul_snr::get_optim_prb_interval(tti_point tti, uint32_t L, const prbmask_t& ul_mask) const
+{
+  prb_interval first = find_contiguous_ul_prbs(L, ul_mask);
+  if (first.empty() or not is_snr_info_valid(tti)) {
+    return first;
+  }
+
+  // PRBs without a recent measurement take the average of the measured ones
+  std::vector<float> snr(cell_nof_prb);
+  float              avg_snr = 0;
+  uint32_t           count   = 0;
+  for (uint32_t prb = 0; prb < cell_nof_prb; ++prb) {
+    if (is_prb_valid(tti, prb)) {
+      avg_snr += prb_snr[prb];
+      count++;
+    }
+  }
+  avg_snr /= count;
+  for (uint32_t prb = 0; prb < cell_nof_prb; ++prb) {
+    snr[prb] = is_prb_valid(tti, prb) ? prb_snr[prb] : avg_snr;
+  }
+
+  // Slide the interval over the empty PRBs, keeping the first one in case of tie
+  uint32_t     len      = first.length();
+  prb_interval best     = first;
+  float        best_snr = 0;
+  for (uint32_t prb = first.start(); prb < first.stop(); ++prb) {
+    best_snr += snr[prb];
+  }
+  for (uint32_t start = first.start() + 1; start + len <= cell_nof_prb; ++start) {
+    if (ul_mask.any(start, start + len)) {
+      continue;
+    }
+    float sum = 0;
+    for (uint32_t prb = start; prb < start + len; ++prb) {
+      sum += snr[prb];
+    }
+    if (sum > best_snr) {
+      best_snr = sum;
+      best     = prb_interval{start, start + len};
+    }
+  }
+
+  return best;
+}
+
+} // namespace srsenb
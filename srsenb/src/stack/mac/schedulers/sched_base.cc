@@ -172,11 +172,20 @@ alloc_result try_ul_retx_alloc(sf_sched& tti_sched, sched_ue& ue, const ul_harq_
     return alloc_result::no_rnti_opportunity;
   }
   uint32_t nof_prbs = alloc.length();
-  alloc             = find_contiguous_ul_prbs(nof_prbs, tti_sched.get_ul_mask());
+  alloc             = find_optim_ul_prbs(tti_sched, ue, nof_prbs);
   if (alloc.length() != nof_prbs) {
     return alloc_result::no_sch_space;
   }
   return tti_sched.alloc_ul_user(&ue, alloc);
 }
 
+prb_interval find_optim_ul_prbs(sf_sched& tti_sched, sched_ue& ue, uint32_t L)
+{
+  const sched_ue_cell* cell = ue.find_ue_carrier(tti_sched.get_enb_cc_idx());
+  if (cell == nullptr) {
+    return find_contiguous_ul_prbs(L, tti_sched.get_ul_mask());
+  }
+  return cell->ul_snr().get_optim_prb_interval(tti_sched.get_tti_tx_ul(), L, tti_sched.get_ul_mask());
+}
+
 } // namespace srsenb
@@ -903,7 +903,7 @@ void gtpu::log_message(const gtpu_tunnel& tun, bool is_rx, srsran::span<uint8_t>
       logger.error("IP Len and PDU N_bytes mismatch");
     }
   }
-  logger.info(pdu.data(), pdu.size(), "%s", srsran::to_c_str(strbuf));
+  logger.info(srslog::rate_key{tun.rnti}, pdu.data(), pdu.size(), "%s", srsran::to_c_str(strbuf));
 }
 
 /****************************************************************************
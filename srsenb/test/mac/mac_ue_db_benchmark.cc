@@ -0,0 +1,216 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Measures the cost of the UE lookups done by the MAC on every PHY callback (ack_info, crc_info, cqi_info, ...) when
+ * several workers run concurrently while the stack adds and removes UEs. It compares the former rwlock protected
+ * rnti_map_t against the lock-free rnti_rcu_map.
+ */
+
+#include "srsenb/hdr/common/rnti_rcu_map.h"
+#include "srsran/common/rwlock_guard.h"
+#include "srsran/support/srsran_test.h"
+#include <chrono>
+#include <getopt.h>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace srsenb {
+
+struct bench_params {
+  uint32_t nof_workers   = 4;
+  uint32_t nof_ues       = 32;
+  uint32_t nof_callbacks = 200000;
+  uint32_t churn_period  = 100; // microseconds between UE removal/addition
+};
+
+/// Minimal stand-in for the MAC UE object.
+struct dummy_ue {
+  explicit dummy_ue(uint16_t rnti_) : rnti(rnti_) {}
+  ~dummy_ue() { rnti = 0; }
+  bool is_active() const { return rnti != 0; }
+
+  uint16_t rnti;
+};
+
+/// Baseline: rnti_map_t guarded by a pthread rwlock, as previously done in the MAC.
+class rwlock_ue_db
+{
+public:
+  rwlock_ue_db() { pthread_rwlock_init(&rwlock, nullptr); }
+  ~rwlock_ue_db() { pthread_rwlock_destroy(&rwlock); }
+
+  bool callback(uint16_t rnti)
+  {
+    srsran::rwlock_read_guard lock(rwlock);
+    return ue_db.contains(rnti) and ue_db[rnti]->is_active();
+  }
+  bool add(uint16_t rnti)
+  {
+    srsran::rwlock_write_guard lock(rwlock);
+    return ue_db.insert(rnti, make_rnti_obj<dummy_ue>(rnti, rnti)).has_value();
+  }
+  void rem(uint16_t rnti)
+  {
+    srsran::rwlock_write_guard lock(rwlock);
+    ue_db.erase(rnti);
+  }
+
+private:
+  pthread_rwlock_t                       rwlock = {};
+  rnti_map_t<unique_rnti_ptr<dummy_ue> > ue_db;
+};
+
+class rcu_ue_db
+{
+public:
+  bool callback(uint16_t rnti)
+  {
+    rnti_rcu_map<dummy_ue>::read_guard lock(ue_db);
+    dummy_ue*                          u = ue_db.find(rnti);
+    return u != nullptr and u->is_active();
+  }
+  bool add(uint16_t rnti) { return ue_db.insert(rnti, make_rnti_obj<dummy_ue>(rnti, rnti)) != nullptr; }
+  void rem(uint16_t rnti) { ue_db.erase(rnti); }
+
+private:
+  rnti_rcu_map<dummy_ue> ue_db;
+};
+
+/// Returns the average time per callback in nanoseconds.
+template <typename UEDb>
+double run_benchmark(const bench_params& params)
+{
+  UEDb                  ue_db;
+  std::vector<uint16_t> rntis;
+  for (uint16_t rnti = 0x46; rntis.size() < params.nof_ues; ++rnti) {
+    TESTASSERT(ue_db.add(rnti));
+    rntis.push_back(rnti);
+  }
+
+  std::atomic<bool>     stop{false};
+  std::atomic<uint32_t> nof_started{0};
+
+  // Stack thread: keeps removing the oldest UE and adding a new one
+  std::thread stack_thread([&]() {
+    uint16_t next_rnti = rntis.back() + 1;
+    size_t   oldest    = 0;
+    while (not stop.load(std::memory_order_relaxed)) {
+      ue_db.rem(rntis[oldest]);
+      while (not ue_db.add(next_rnti)) {
+        next_rnti++;
+      }
+      rntis[oldest] = next_rnti++;
+      oldest        = (oldest + 1) % rntis.size();
+      std::this_thread::sleep_for(std::chrono::microseconds(params.churn_period));
+    }
+  });
+
+  // PHY workers: look up UEs, including some that have just been removed
+  std::vector<std::thread> workers;
+  std::atomic<uint64_t>    total_ns{0};
+  for (uint32_t w = 0; w < params.nof_workers; ++w) {
+    workers.emplace_back([&, w]() {
+      std::mt19937                            rgen(w);
+      std::uniform_int_distribution<uint16_t> dist(0x46, 0x46 + params.nof_ues * 4);
+      std::vector<uint16_t>                   lookups(1024);
+      for (uint16_t& r : lookups) {
+        r = dist(rgen);
+      }
+
+      nof_started++;
+      while (nof_started < params.nof_workers) {
+        std::this_thread::yield();
+      }
+
+      uint32_t nof_hits = 0;
+      auto     tp       = std::chrono::steady_clock::now();
+      for (uint32_t i = 0; i < params.nof_callbacks; ++i) {
+        nof_hits += ue_db.callback(lookups[i % lookups.size()]) ? 1 : 0;
+      }
+      auto elapsed = std::chrono::steady_clock::now() - tp;
+      total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+      TESTASSERT(nof_hits <= params.nof_callbacks);
+    });
+  }
+  for (std::thread& t : workers) {
+    t.join();
+  }
+  stop = true;
+  stack_thread.join();
+
+  return total_ns / (double)(params.nof_workers * params.nof_callbacks);
+}
+
+} // namespace srsenb
+
+void usage(char* prog)
+{
+  printf("Usage: %s [wunc]\n", prog);
+  printf("\t-w Number of concurrent PHY workers [Default %d]\n", srsenb::bench_params{}.nof_workers);
+  printf("\t-u Number of UEs [Default %d]\n", srsenb::bench_params{}.nof_ues);
+  printf("\t-n Number of callbacks per worker [Default %d]\n", srsenb::bench_params{}.nof_callbacks);
+  printf("\t-c Microseconds between UE removals [Default %d]\n", srsenb::bench_params{}.churn_period);
+}
+
+int main(int argc, char** argv)
+{
+  srsenb::bench_params params;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "wunch")) != -1) {
+    switch (opt) {
+      case 'w':
+        params.nof_workers = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'u':
+        params.nof_ues = std::min((uint32_t)strtol(argv[optind], nullptr, 10), (uint32_t)SRSENB_MAX_UES / 2);
+        break;
+      case 'n':
+        params.nof_callbacks = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'c':
+        params.churn_period = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+
+  srslog::init();
+
+  for (uint32_t nof_workers = 1; nof_workers <= params.nof_workers; nof_workers *= 2) {
+    srsenb::bench_params p = params;
+    p.nof_workers          = nof_workers;
+    double rwlock_ns       = srsenb::run_benchmark<srsenb::rwlock_ue_db>(p);
+    double rcu_ns          = srsenb::run_benchmark<srsenb::rcu_ue_db>(p);
+    printf("workers=%d, ues=%d: rwlock %.1f ns/callback, rcu %.1f ns/callback\n",
+           nof_workers,
+           p.nof_ues,
+           rwlock_ns,
+           rcu_ns);
+  }
+
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
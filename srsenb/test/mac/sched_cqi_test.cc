@@ -20,6 +20,7 @@
  */
 
 #include "srsenb/hdr/stack/mac/sched_ue_ctrl/sched_dl_cqi.h"
+#include "srsenb/hdr/stack/mac/sched_ue_ctrl/sched_ul_snr.h"
 #include "srsran/common/test_common.h"
 
 namespace srsenb {
@@ -89,6 +90,37 @@ void test_sched_cqi_wideband_cqi()
   }
 }
 
+void test_sched_ul_sb_snr()
+{
+  uint32_t     nof_prb = 50;
+  sched_ul_snr ue_snr(nof_prb);
+  prbmask_t    ul_mask(nof_prb);
+  ul_mask.fill(0, 2);
+
+  // TEST: Without SRS measurements, the first empty interval is selected
+  TESTASSERT(not ue_snr.is_snr_info_valid(tti_point(0)));
+  TESTASSERT(ue_snr.get_optim_prb_interval(tti_point(0), 4, ul_mask) == prb_interval(2, 6));
+
+  // SRS from PRB 4, the best sub-band is the fourth one
+  std::array<float, 8> sb_snr = {5, 5, 5, 20, 5, 5, 5, 5};
+  ue_snr.sb_snr_info(tti_point(0), 4, 4, sb_snr);
+  TESTASSERT(ue_snr.is_snr_info_valid(tti_point(1)));
+  TESTASSERT(ue_snr.get_optim_prb_interval(tti_point(1), 4, ul_mask) == prb_interval(16, 20));
+
+  // TEST: Allocated PRBs are skipped
+  ul_mask.fill(16, 17);
+  TESTASSERT(ue_snr.get_optim_prb_interval(tti_point(1), 4, ul_mask) == prb_interval(17, 21));
+
+  // TEST: Old measurements are discarded
+  TESTASSERT(not ue_snr.is_snr_info_valid(tti_point(1000)));
+  TESTASSERT(ue_snr.get_optim_prb_interval(tti_point(1000), 4, ul_mask) == prb_interval(2, 6));
+
+  // TEST: Reset discards the measurements
+  ue_snr.sb_snr_info(tti_point(1000), 4, 4, sb_snr);
+  ue_snr.reset();
+  TESTASSERT(not ue_snr.is_snr_info_valid(tti_point(1000)));
+}
+
 } // namespace srsenb
 
 int main(int argc, char** argv)
@@ -97,6 +129,7 @@ int main(int argc, char** argv)
 
   srsenb::test_sched_cqi_one_subband_cqi();
   srsenb::test_sched_cqi_wideband_cqi();
+  srsenb::test_sched_ul_sb_snr();
 
   return SRSRAN_SUCCESS;
 }
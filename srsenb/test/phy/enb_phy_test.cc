@@ -294,6 +294,7 @@ private:
   CALLBACK(cqi_info);
   CALLBACK(sb_cqi_info);
   CALLBACK(snr_info);
+  CALLBACK(sb_snr_info);
   CALLBACK(ta_info);
   CALLBACK(ack_info);
   CALLBACK(crc_info);
@@ -483,6 +484,17 @@ public:
     notify_snr_info();
     return 0;
   }
+  int sb_snr_info(uint32_t     tti,
+                  uint16_t     rnti,
+                  uint32_t     cc_idx,
+                  uint32_t     prb_start,
+                  uint32_t     sb_nof_prb,
+                  const float* sb_snr_db,
+                  uint32_t     nof_sb) override
+  {
+    notify_sb_snr_info();
+    return 0;
+  }
   int ta_info(uint32_t tti, uint16_t rnti, float ta_us) override
   {
     logger.info("Received TA INFO tti=%d; rnti=0x%x; ta=%.1f us", tti, rnti, ta_us);
@@ -28,13 +28,19 @@
 #ifndef SRSEPC_HSS_H
 #define SRSEPC_HSS_H
 
+#include "srsepc/hdr/hss/hss_subscriber_store.h"
 #include "srsran/common/buffer_pool.h"
 #include "srsran/common/standard_streams.h"
+#include "srsran/common/thread_pool.h"
 #include "srsran/interfaces/epc_interfaces.h"
 #include "srsran/srslog/srslog.h"
 #include <cstddef>
 
+#include <deque>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #define LTE_FDD_ENB_IND_HE_N_BITS 5
 #define LTE_FDD_ENB_IND_HE_MASK 0x1FUL
@@ -45,31 +51,28 @@ namespace srsepc {
 
 struct hss_args_t {
   std::string db_file;
+  std::string db_store;
+  bool        db_sync;
+  uint32_t    av_cache_size;
   uint16_t    mcc;
   uint16_t    mnc;
 };
 
-enum hss_auth_algo { HSS_ALGO_XOR, HSS_ALGO_MILENAGE };
-
-struct hss_ue_ctx_t {
-  // Members
-  std::string        name;
-  uint64_t           imsi;
-  enum hss_auth_algo algo;
-  uint8_t            key[16];
-  bool               op_configured;
-  uint8_t            op[16];
-  uint8_t            opc[16];
-  uint8_t            amf[2];
-  uint8_t            sqn[6];
-  uint16_t           qci;
-  uint8_t            last_rand[16];
-  std::string        static_ip_addr;
-
-  // Helper getters/setters
-  void set_sqn(const uint8_t* sqn_);
-  void set_last_rand(const uint8_t* rand_);
-  void get_last_rand(uint8_t* rand_);
+/// Milenage authentication vector computed ahead of the authentication request that consumes it.
+struct hss_auth_vector_t {
+  uint8_t sqn[6];
+  uint8_t rand[16];
+  uint8_t xres[8];
+  uint8_t autn[16];
+  uint8_t k_asme[32];
+};
+
+/// Precomputed authentication vectors of a subscriber. The vectors have consecutive SQNs, the first one being the
+/// current SQN of the subscriber.
+struct hss_av_cache_t {
+  std::deque<hss_auth_vector_t> vectors;
+  uint32_t                      generation     = 0; ///< Incremented every time the vectors are discarded
+  bool                          refill_pending = false;
 };
 
 class hss : public hss_interface_nas
@@ -92,7 +95,15 @@ private:
   virtual ~hss();
   static hss* m_instance;
 
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> > m_imsi_to_ue_ctx;
+  // Serializes the NAS requests, which may come from several MME NAS workers
+  std::mutex           m_nas_mutex;
+  hss_subscriber_store m_store;
+
+  // Authentication vectors of the active subscribers, refilled by the AV worker. Protected by m_nas_mutex.
+  uint32_t                                     m_av_cache_size = 0;
+  std::unordered_map<uint64_t, hss_av_cache_t> m_av_cache;
+  std::vector<uint64_t>                        m_av_refill_queue;
+  std::unique_ptr<srsran::task_worker>         m_av_worker;
 
   void gen_rand(uint8_t rand_[16]);
 
@@ -100,6 +111,11 @@ private:
        gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
   void gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
 
+  bool pop_cached_auth_vector(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
+  void discard_cached_auth_vectors(uint64_t imsi);
+  void schedule_auth_vector_refill(uint64_t imsi);
+  void refill_auth_vectors();
+
   void resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* auts);
   void resync_sqn_xor(hss_ue_ctx_t* ue_ctx, uint8_t* auts);
 
@@ -110,8 +126,9 @@ private:
   void increment_sqn(uint8_t* sqn, uint8_t* next_sqn);
 
   bool          set_auth_algo(std::string auth_algo);
-  bool          read_db_file(std::string db_file);
+  bool          read_db_file(std::string db_file, std::vector<hss_ue_ctx_t>* subscribers);
   bool          write_db_file(std::string db_file);
+  bool          load_store(hss_args_t* hss_args);
   hss_ue_ctx_t* get_ue_ctx(uint64_t imsi);
 
   std::string hex_string(uint8_t* hex, int size);
@@ -127,19 +144,5 @@ private:
   std::map<std::string, uint64_t> m_ip_to_imsi;
 };
 
-inline void hss_ue_ctx_t::set_sqn(const uint8_t* sqn_)
-{
-  memcpy(sqn, sqn_, 6);
-}
-
-inline void hss_ue_ctx_t::set_last_rand(const uint8_t* last_rand_)
-{
-  memcpy(last_rand, last_rand_, 16);
-}
-
-inline void hss_ue_ctx_t::get_last_rand(uint8_t* last_rand_)
-{
-  memcpy(last_rand_, last_rand, 16);
-}
 } // namespace srsepc
 #endif // SRSEPC_HSS_H
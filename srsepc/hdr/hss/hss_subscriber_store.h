@@ -0,0 +1,183 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        hss_subscriber_store.h
+ * Description: Memory mapped subscriber store of the HSS. Keeps fixed size
+ *              subscriber records with an IMSI hash index in a binary file
+ *              and persists SQN updates through an append-only journal.
+ *****************************************************************************/
+
+#ifndef SRSEPC_HSS_SUBSCRIBER_STORE_H
+#define SRSEPC_HSS_SUBSCRIBER_STORE_H
+
+#include "srsran/srslog/srslog.h"
+#include <cstring>
+#include <string>
+#include <sys/types.h>
+#include <type_traits>
+#include <vector>
+
+#define HSS_UE_NAME_MAX_LEN 32
+
+namespace srsepc {
+
+enum hss_auth_algo { HSS_ALGO_XOR, HSS_ALGO_MILENAGE };
+
+/// Subscriber record. It is stored as is in the memory mapped store, so it must remain trivially copyable.
+struct hss_ue_ctx_t {
+  // Members
+  char               name[HSS_UE_NAME_MAX_LEN];
+  uint64_t           imsi;
+  enum hss_auth_algo algo;
+  uint8_t            key[16];
+  bool               op_configured;
+  uint8_t            op[16];
+  uint8_t            opc[16];
+  uint8_t            amf[2];
+  uint8_t            sqn[6];
+  uint16_t           qci;
+  uint8_t            last_rand[16];
+  uint32_t           static_ip_addr; // IPv4 address in network byte order, 0 for dynamic allocation
+
+  // Helper getters/setters
+  void set_sqn(const uint8_t* sqn_);
+  void set_last_rand(const uint8_t* rand_);
+  void get_last_rand(uint8_t* rand_);
+  void set_name(const std::string& name_);
+};
+static_assert(std::is_trivially_copyable<hss_ue_ctx_t>::value, "HSS subscriber records must be trivially copyable");
+
+/// Modification time and size of the CSV the store was built from. A store is only reused when the CSV is unchanged.
+struct hss_csv_stamp_t {
+  int64_t  mtime_ns;
+  uint64_t size;
+
+  bool operator==(const hss_csv_stamp_t& other) const { return mtime_ns == other.mtime_ns and size == other.size; }
+};
+
+/**
+ * The subscriber records and an open addressing IMSI hash index live in a memory mapped file, so opening a store with
+ * millions of subscribers costs a few syscalls and the pages are loaded on demand. SQN and last RAND updates are
+ * written in place in the mapping and appended to a small journal. On open, the journal is replayed over the records,
+ * so no SQN update is lost if the EPC is killed before the records are synced. Periodically, and on close, the records
+ * are synced to disk and the journal is truncated.
+ *
+ * An empty store path keeps the records in anonymous memory, without persistence.
+ */
+class hss_subscriber_store
+{
+public:
+  /// Number of journal entries after which the records are synced and the journal is truncated.
+  static const uint32_t JOURNAL_CHECKPOINT_ENTRIES = 65536;
+
+  hss_subscriber_store() = default;
+  ~hss_subscriber_store();
+  hss_subscriber_store(const hss_subscriber_store&) = delete;
+  hss_subscriber_store& operator=(const hss_subscriber_store&) = delete;
+
+  /// Opens an existing store built from a CSV with the given stamp and replays its journal.
+  /// Returns false if the store does not exist, is corrupted or was built from a different CSV.
+  bool open(const std::string& path, const hss_csv_stamp_t& csv_stamp, bool sync_journal);
+
+  /// Creates a new store with the given subscribers, replacing any previous store at the same path. The SQNs of the
+  /// subscribers also present in this store, if open, are carried over when they are ahead of the ones provided.
+  bool create(const std::string&               path,
+              const hss_csv_stamp_t&           csv_stamp,
+              const std::vector<hss_ue_ctx_t>& subscribers,
+              bool                             sync_journal);
+
+  /// Syncs the records to disk, truncates the journal and unmaps the store.
+  void close();
+
+  bool is_open() const { return map != nullptr; }
+
+  hss_ue_ctx_t* find(uint64_t imsi);
+  hss_ue_ctx_t* at(uint32_t idx) { return &records[idx]; }
+  uint32_t      size() const { return nof_records; }
+
+  /// Indexes of the records with a static IP address.
+  const std::vector<uint32_t>& get_static_ip_records() const { return static_ip_records; }
+
+  /// Persists the SQN and last RAND of a record after they have been modified.
+  void write_back(const hss_ue_ctx_t* ue_ctx);
+
+  /// Records the stamp of the CSV the store is now in sync with, e.g. after the HSS exports the records to it.
+  void set_csv_stamp(const hss_csv_stamp_t& csv_stamp);
+
+  /// Syncs the records to disk and truncates the journal.
+  void checkpoint();
+
+private:
+  struct store_header;
+  struct journal_entry;
+
+  bool     load(const std::string& path, const hss_csv_stamp_t* csv_stamp, bool sync_journal);
+  bool     map_file(const std::string& path, int flags, size_t file_size);
+  void     set_layout();
+  bool     check_layout() const;
+  bool     open_journal(const std::string& path, bool truncate);
+  uint32_t replay_journal();
+  uint32_t bucket_mask() const { return nof_buckets - 1; }
+
+  static uint32_t hash_imsi(uint64_t imsi);
+  static size_t   compute_file_size(uint32_t nof_records_, uint32_t nof_buckets_, uint32_t nof_static_ips_);
+
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("HSS");
+
+  std::string           store_path;
+  int                   store_fd        = -1;
+  int                   journal_fd      = -1;
+  bool                  sync            = false;
+  uint8_t*              map             = nullptr;
+  size_t                map_size        = 0;
+  store_header*         header          = nullptr;
+  hss_ue_ctx_t*         records         = nullptr;
+  uint32_t*             buckets         = nullptr;
+  uint32_t              nof_records     = 0;
+  uint32_t              nof_buckets     = 0;
+  uint32_t              journal_entries = 0;
+  std::vector<uint32_t> static_ip_records;
+};
+
+inline void hss_ue_ctx_t::set_sqn(const uint8_t* sqn_)
+{
+  memcpy(sqn, sqn_, 6);
+}
+
+inline void hss_ue_ctx_t::set_last_rand(const uint8_t* last_rand_)
+{
+  memcpy(last_rand, last_rand_, 16);
+}
+
+inline void hss_ue_ctx_t::get_last_rand(uint8_t* last_rand_)
+{
+  memcpy(last_rand_, last_rand, 16);
+}
+
+inline void hss_ue_ctx_t::set_name(const std::string& name_)
+{
+  memset(name, 0, sizeof(name));
+  strncpy(name, name_.c_str(), sizeof(name) - 1);
+}
+
+} // namespace srsepc
+#endif // SRSEPC_HSS_SUBSCRIBER_STORE_H
@@ -33,9 +33,13 @@
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/threads.h"
 #include <cstddef>
+#include <mutex>
 
 namespace srsepc {
 
+// Maximum number of events returned by each epoll_wait() call of the MME thread
+const int MME_MAX_EPOLL_EVENTS = 64;
+
 typedef struct {
   s1ap_args_t s1ap_args;
   // diameter_args_t diameter_args;
@@ -71,10 +75,11 @@ private:
   s1ap*       m_s1ap;
   mme_gtpc*   m_mme_gtpc;
 
-  bool   m_running;
-  fd_set m_set;
+  bool m_running;
+  int  m_epoll_fd = -1;
 
-  // Timer map
+  // Timer map. NAS workers add and remove timers while the MME thread waits for them to expire.
+  std::mutex               m_timers_mutex;
   std::vector<mme_timer_t> timers;
 
   // Timer Methods
@@ -24,8 +24,11 @@
 #include "nas.h"
 #include "srsran/asn1/gtpc.h"
 #include "srsran/common/buffer_pool.h"
+#include <memory>
+#include <mutex>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <unordered_map>
 
 namespace srsepc {
 
@@ -66,15 +69,18 @@ private:
   srslog::basic_logger& m_logger = srslog::fetch_basic_logger("MME GTPC");
   s1ap*                 m_s1ap;
 
-  uint32_t                            m_next_ctrl_teid;
-  std::map<uint32_t, uint64_t>        m_mme_ctr_teid_to_imsi;
-  std::map<uint64_t, struct gtpc_ctx> m_imsi_to_gtpc_ctx;
+  // GTP-C contexts, accessed by all the NAS workers and protected by m_ctx_mutex
+  std::mutex                                    m_ctx_mutex;
+  uint32_t                                      m_next_ctrl_teid;
+  std::unordered_map<uint32_t, uint64_t>        m_mme_ctr_teid_to_imsi;
+  std::unordered_map<uint64_t, struct gtpc_ctx> m_imsi_to_gtpc_ctx;
 
   int                m_s11;
   struct sockaddr_un m_mme_addr, m_spgw_addr;
 
   bool     init_s11();
   uint32_t get_new_ctrl_teid();
+  void     handle_s11_pdu(srsran::gtpc_pdu* pdu);
 };
 
 inline uint32_t mme_gtpc::get_new_ctrl_teid()
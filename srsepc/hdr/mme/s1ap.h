@@ -35,21 +35,29 @@
 #include "srsran/common/common.h"
 #include "srsran/common/s1ap_pcap.h"
 #include "srsran/common/standard_streams.h"
+#include "srsran/common/thread_pool.h"
 #include "srsran/interfaces/epc_interfaces.h"
 #include "srsran/srslog/srslog.h"
 #include <arpa/inet.h>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <netinet/sctp.h>
-#include <set>
 #include <strings.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace srsepc {
 
 const uint16_t S1MME_PORT = 36412;
 
+// Maximum number of pending tasks per NAS worker
+const uint32_t NAS_WORKER_QUEUE_SIZE = 16384;
+
 using s1ap_pdu_t = asn1::s1ap::s1ap_pdu_c;
 
 class s1ap : public s1ap_interface_nas, public s1ap_interface_gtpc, public s1ap_interface_mme
@@ -82,6 +90,8 @@ public:
   void       add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinfo* enb_sri);
   void       get_enb_ctx(uint16_t sctp_stream);
 
+  std::vector<std::pair<uint32_t, struct sctp_sndrcvinfo> > get_active_enbs_sri();
+
   bool add_nas_ctx_to_imsi_map(nas* nas_ctx);
   bool add_nas_ctx_to_mme_ue_s1ap_id_map(nas* nas_ctx);
   bool add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id);
@@ -96,6 +106,18 @@ public:
   uint32_t         allocate_m_tmsi(uint64_t imsi);
   virtual uint64_t find_imsi_from_m_tmsi(uint32_t m_tmsi);
 
+  /*
+   * NAS workers
+   * All the procedures of a UE run in the NAS worker that owns its context, so that NAS and ECM state is only
+   * touched by one thread. New contexts are assigned to a worker by hashing the IMSI (or the M-TMSI when the IMSI
+   * is not known yet). Without NAS workers, everything runs in the calling thread.
+   */
+  uint32_t get_nas_worker_from_imsi(uint64_t imsi);
+  uint32_t get_nas_worker_from_m_tmsi(uint32_t m_tmsi);
+  uint32_t get_nas_worker_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id);
+  template <typename Task>
+  void run_in_nas_worker(uint32_t worker_idx, Task&& task);
+
   s1ap_args_t           m_s1ap_args;
   srslog::basic_logger& m_logger = srslog::fetch_basic_logger("S1AP");
 
@@ -105,9 +127,6 @@ public:
   s1ap_erab_mngmt_proc* m_s1ap_erab_mngmt_proc;
   s1ap_paging*          m_s1ap_paging;
 
-  std::map<uint32_t, uint64_t>   m_tmsi_to_imsi;
-  std::map<uint16_t, enb_ctx_t*> m_active_enbs;
-
   // Interfaces
   virtual bool send_initial_context_setup_request(uint64_t imsi, uint16_t erab_to_setup);
   virtual bool send_ue_context_release_command(uint32_t mme_ue_s1ap_id);
@@ -129,29 +148,52 @@ public:
   virtual bool expire_nas_timer(enum nas_timer_type type, uint64_t imsi);
 
 private:
+  /// Decoded S1AP PDU handed over to a NAS worker, together with the SCTP info of the eNB that sent it.
+  struct s1ap_rx_pdu_t {
+    s1ap_pdu_t             pdu;
+    struct sctp_sndrcvinfo sri;
+  };
+
   s1ap();
   virtual ~s1ap();
 
   static s1ap* m_instance;
 
+  void     handle_s1ap_pdu(const s1ap_pdu_t& rx_pdu, struct sctp_sndrcvinfo* enb_sri);
+  bool     get_nas_worker_from_pdu(const s1ap_pdu_t& rx_pdu, uint32_t& worker_idx);
+  uint32_t get_nas_worker_from_init_ue_msg(const asn1::s1ap::init_ue_msg_s& init_ue);
+  uint32_t get_nas_worker_from_imsi_unlocked(uint64_t imsi);
+  void     release_ue_ecm_ctx_in_enb(uint32_t mme_ue_s1ap_id);
+  void     write_pcap(uint8_t* msg, uint32_t len);
+
   uint32_t m_plmn;
 
-  hss_interface_nas*                     m_hss;
-  int                                    m_s1mme;
-  std::map<int32_t, uint16_t>            m_sctp_to_enb_id;
-  std::map<int32_t, std::set<uint32_t> > m_enb_assoc_to_ue_ids;
+  hss_interface_nas* m_hss;
+  int                m_s1mme;
+
+  // eNB tables, protected by m_enb_mutex
+  std::mutex                                                 m_enb_mutex;
+  std::unordered_map<uint16_t, enb_ctx_t*>                   m_active_enbs;
+  std::unordered_map<int32_t, uint16_t>                      m_sctp_to_enb_id;
+  std::unordered_map<int32_t, std::unordered_set<uint32_t> > m_enb_assoc_to_ue_ids;
 
-  std::map<uint64_t, nas*> m_imsi_to_nas_ctx;
-  std::map<uint32_t, nas*> m_mme_ue_s1ap_id_to_nas_ctx;
+  // UE context tables, protected by m_ue_ctx_mutex. The NAS contexts themselves are only accessed by their NAS worker.
+  std::mutex                             m_ue_ctx_mutex;
+  std::unordered_map<uint64_t, nas*>     m_imsi_to_nas_ctx;
+  std::unordered_map<uint32_t, nas*>     m_mme_ue_s1ap_id_to_nas_ctx;
+  std::unordered_map<uint32_t, uint64_t> m_tmsi_to_imsi;
+  std::atomic<uint32_t>                  m_next_mme_ue_s1ap_id;
+  uint32_t                               m_next_m_tmsi;
 
-  uint32_t m_next_mme_ue_s1ap_id;
-  uint32_t m_next_m_tmsi;
+  // NAS workers
+  std::vector<std::unique_ptr<srsran::task_worker> > m_nas_workers;
 
   // GTP-C Interface
   mme_gtpc* m_mme_gtpc;
 
   // PCAP
   bool              m_pcap_enable;
+  std::mutex        m_pcap_mutex;
   srsran::s1ap_pcap m_pcap;
 };
 
@@ -165,5 +207,15 @@ inline uint16_t s1ap::get_tac()
   return m_s1ap_args.tac;
 }
 
+template <typename Task>
+void s1ap::run_in_nas_worker(uint32_t worker_idx, Task&& task)
+{
+  if (m_nas_workers.empty()) {
+    task();
+    return;
+  }
+  m_nas_workers[worker_idx % m_nas_workers.size()]->push_task(std::forward<Task>(task));
+}
+
 } // namespace srsepc
 #endif // SRSEPC_S1AP_H
@@ -26,14 +26,20 @@
 #include <iomanip>
 #include <sstream>
 #include <stdlib.h> /* srand, rand */
+#include <string.h>
 #include <string>
+#include <sys/stat.h>
 #include <time.h>
+#include <unordered_set>
 
 namespace srsepc {
 
 hss*            hss::m_instance    = NULL;
 pthread_mutex_t hss_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+// A single refill task is queued at a time, see schedule_auth_vector_refill()
+static const uint32_t AV_WORKER_QUEUE_SIZE = 16;
+
 hss::hss()
 {
   return;
@@ -44,6 +50,16 @@ hss::~hss()
   return;
 }
 
+/// Returns the modification time and size of the user database, used to detect whether the store is stale.
+static hss_csv_stamp_t get_csv_stamp(const std::string& db_filename)
+{
+  struct stat st = {};
+  if (stat(db_filename.c_str(), &st) < 0) {
+    return {};
+  }
+  return {(int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec, (uint64_t)st.st_size};
+}
+
 hss* hss::get_instance()
 {
   pthread_mutex_lock(&hss_instance_mutex);
@@ -69,7 +85,7 @@ int hss::init(hss_args_t* hss_args)
   srand(time(NULL));
 
   /*Read user information from DB*/
-  if (read_db_file(hss_args->db_file) == false) {
+  if (not load_store(hss_args)) {
     srsran::console("Error reading user database file %s\n", hss_args->db_file.c_str());
     return -1;
   }
@@ -79,6 +95,11 @@ int hss::init(hss_args_t* hss_args)
 
   db_file = hss_args->db_file;
 
+  m_av_cache_size = hss_args->av_cache_size;
+  if (m_av_cache_size > 0) {
+    m_av_worker.reset(new srsran::task_worker("HSS_AV", AV_WORKER_QUEUE_SIZE));
+  }
+
   m_logger.info("HSS Initialized. DB file %s, MCC: %d, MNC: %d", hss_args->db_file.c_str(), mcc, mnc);
   srsran::console("HSS Initialized.\n");
   return 0;
@@ -86,11 +107,52 @@ int hss::init(hss_args_t* hss_args)
 
 void hss::stop()
 {
-  write_db_file(db_file);
+  // The AV worker accesses the store, stop it first
+  if (m_av_worker != nullptr) {
+    m_av_worker->stop();
+    m_av_worker.reset();
+  }
+
+  // Export the SQNs to the user database, the store stays valid since it is in sync with the new file
+  if (write_db_file(db_file)) {
+    m_store.set_csv_stamp(get_csv_stamp(db_file));
+  }
+  m_store.close();
   return;
 }
 
-bool hss::read_db_file(std::string db_filename)
+bool hss::load_store(hss_args_t* hss_args)
+{
+  std::string     store_file = hss_args->db_store.empty() ? hss_args->db_file + ".store" : hss_args->db_store;
+  hss_csv_stamp_t csv_stamp  = get_csv_stamp(hss_args->db_file);
+
+  if (m_store.open(store_file, csv_stamp, hss_args->db_sync)) {
+    m_logger.info("Loaded %d users from HSS store %s", m_store.size(), store_file.c_str());
+  } else {
+    // The store is missing or the user database changed, build the store again from the .csv
+    std::vector<hss_ue_ctx_t> subscribers;
+    if (not read_db_file(hss_args->db_file, &subscribers)) {
+      return false;
+    }
+    if (not m_store.create(store_file, csv_stamp, subscribers, hss_args->db_sync)) {
+      srsran::console("Could not create HSS store %s. SQNs will only be saved on exit\n", store_file.c_str());
+      if (not m_store.create("", csv_stamp, subscribers, false)) {
+        return false;
+      }
+    }
+  }
+
+  m_ip_to_imsi.clear();
+  for (uint32_t idx : m_store.get_static_ip_records()) {
+    const hss_ue_ctx_t* ue_ctx = m_store.at(idx);
+    char                ip_str[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &ue_ctx->static_ip_addr, ip_str, sizeof(ip_str));
+    m_ip_to_imsi.insert(std::make_pair(std::string(ip_str), ue_ctx->imsi));
+  }
+  return true;
+}
+
+bool hss::read_db_file(std::string db_filename, std::vector<hss_ue_ctx_t>* subscribers)
 {
   std::ifstream m_db_file;
 
@@ -100,7 +162,9 @@ bool hss::read_db_file(std::string db_filename)
   }
   m_logger.info("Opened DB file: %s", db_filename.c_str());
 
-  std::string line;
+  std::unordered_set<uint64_t> imsis;
+  std::unordered_set<uint32_t> static_ips;
+  std::string                  line;
   while (std::getline(m_db_file, line)) {
     if (line[0] != '#' && line.length() > 0) {
       uint                     column_size = 10;
@@ -114,51 +178,51 @@ bool hss::read_db_file(std::string db_filename)
         srsran::console("See 'srsepc/user_db.csv.example' for an example.\n\n");
         return false;
       }
-      std::unique_ptr<hss_ue_ctx_t> ue_ctx = std::unique_ptr<hss_ue_ctx_t>(new hss_ue_ctx_t);
-      ue_ctx->name                         = split[0];
+      hss_ue_ctx_t ue_ctx = {};
+      ue_ctx.set_name(split[0]);
       if (split[1] == std::string("xor")) {
-        ue_ctx->algo = HSS_ALGO_XOR;
+        ue_ctx.algo = HSS_ALGO_XOR;
       } else if (split[1] == std::string("mil")) {
-        ue_ctx->algo = HSS_ALGO_MILENAGE;
+        ue_ctx.algo = HSS_ALGO_MILENAGE;
       } else {
         m_logger.error("Neither XOR nor MILENAGE configured.");
         return false;
       }
-      ue_ctx->imsi = strtoull(split[2].c_str(), nullptr, 10);
-      srsran::get_uint_vec_from_hex_str(split[3], ue_ctx->key, 16);
+      ue_ctx.imsi = strtoull(split[2].c_str(), nullptr, 10);
+      srsran::get_uint_vec_from_hex_str(split[3], ue_ctx.key, 16);
       if (split[4] == std::string("op")) {
-        ue_ctx->op_configured = true;
-        srsran::get_uint_vec_from_hex_str(split[5], ue_ctx->op, 16);
-        srsran::compute_opc(ue_ctx->key, ue_ctx->op, ue_ctx->opc);
+        ue_ctx.op_configured = true;
+        srsran::get_uint_vec_from_hex_str(split[5], ue_ctx.op, 16);
+        srsran::compute_opc(ue_ctx.key, ue_ctx.op, ue_ctx.opc);
       } else if (split[4] == std::string("opc")) {
-        ue_ctx->op_configured = false;
-        srsran::get_uint_vec_from_hex_str(split[5], ue_ctx->opc, 16);
+        ue_ctx.op_configured = false;
+        srsran::get_uint_vec_from_hex_str(split[5], ue_ctx.opc, 16);
       } else {
         m_logger.error("Neither OP nor OPc configured.");
         return false;
       }
-      srsran::get_uint_vec_from_hex_str(split[6], ue_ctx->amf, 2);
-      srsran::get_uint_vec_from_hex_str(split[7], ue_ctx->sqn, 6);
+      srsran::get_uint_vec_from_hex_str(split[6], ue_ctx.amf, 2);
+      srsran::get_uint_vec_from_hex_str(split[7], ue_ctx.sqn, 6);
 
-      m_logger.debug("Added user from DB, IMSI: %015" PRIu64 "", ue_ctx->imsi);
-      m_logger.debug(ue_ctx->key, 16, "User Key : ");
-      if (ue_ctx->op_configured) {
-        m_logger.debug(ue_ctx->op, 16, "User OP : ");
+      m_logger.debug("Added user from DB, IMSI: %015" PRIu64 "", ue_ctx.imsi);
+      m_logger.debug(ue_ctx.key, 16, "User Key : ");
+      if (ue_ctx.op_configured) {
+        m_logger.debug(ue_ctx.op, 16, "User OP : ");
       }
-      m_logger.debug(ue_ctx->opc, 16, "User OPc : ");
-      m_logger.debug(ue_ctx->amf, 2, "AMF : ");
-      m_logger.debug(ue_ctx->sqn, 6, "SQN : ");
-      ue_ctx->qci = (uint16_t)strtol(split[8].c_str(), nullptr, 10);
-      m_logger.debug("Default Bearer QCI: %d", ue_ctx->qci);
+      m_logger.debug(ue_ctx.opc, 16, "User OPc : ");
+      m_logger.debug(ue_ctx.amf, 2, "AMF : ");
+      m_logger.debug(ue_ctx.sqn, 6, "SQN : ");
+      ue_ctx.qci = (uint16_t)strtol(split[8].c_str(), nullptr, 10);
+      m_logger.debug("Default Bearer QCI: %d", ue_ctx.qci);
 
       if (split[9] == std::string("dynamic")) {
-        ue_ctx->static_ip_addr = "0.0.0.0";
+        ue_ctx.static_ip_addr = 0;
       } else {
-        char buf[128] = {0};
-        if (inet_pton(AF_INET, split[9].c_str(), buf)) {
-          if (m_ip_to_imsi.insert(std::make_pair(split[9], ue_ctx->imsi)).second) {
-            ue_ctx->static_ip_addr = split[9];
-            m_logger.info("static ip addr %s", ue_ctx->static_ip_addr.c_str());
+        struct in_addr addr = {};
+        if (inet_pton(AF_INET, split[9].c_str(), &addr)) {
+          if (static_ips.insert(addr.s_addr).second) {
+            ue_ctx.static_ip_addr = addr.s_addr;
+            m_logger.info("static ip addr %s", split[9].c_str());
           } else {
             m_logger.info("duplicate static ip addr %s", split[9].c_str());
             return false;
@@ -168,7 +232,11 @@ bool hss::read_db_file(std::string db_filename)
           return false;
         }
       }
-      m_imsi_to_ue_ctx.insert(std::make_pair(ue_ctx->imsi, std::move(ue_ctx)));
+      if (imsis.insert(ue_ctx.imsi).second) {
+        subscribers->push_back(ue_ctx);
+      } else {
+        m_logger.warning("Ignoring duplicate user in DB, IMSI: %015" PRIu64 "", ue_ctx.imsi);
+      }
     }
   }
 
@@ -216,37 +284,38 @@ bool hss::write_db_file(std::string db_filename)
             << "#                                                                                           \n"
             << "# Note: Lines starting by '#' are ignored and will be overwritten                           \n";
 
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator it = m_imsi_to_ue_ctx.begin();
-  while (it != m_imsi_to_ue_ctx.end()) {
-    m_db_file << it->second->name;
+  for (uint32_t i = 0; i < m_store.size(); ++i) {
+    hss_ue_ctx_t* ue_ctx = m_store.at(i);
+    m_db_file << ue_ctx->name;
     m_db_file << ",";
-    m_db_file << (it->second->algo == HSS_ALGO_XOR ? "xor" : "mil");
+    m_db_file << (ue_ctx->algo == HSS_ALGO_XOR ? "xor" : "mil");
     m_db_file << ",";
-    m_db_file << std::setfill('0') << std::setw(15) << it->second->imsi;
+    m_db_file << std::setfill('0') << std::setw(15) << ue_ctx->imsi;
     m_db_file << ",";
-    m_db_file << srsran::hex_string(it->second->key, 16);
+    m_db_file << srsran::hex_string(ue_ctx->key, 16);
     m_db_file << ",";
-    if (it->second->op_configured) {
+    if (ue_ctx->op_configured) {
       m_db_file << "op,";
-      m_db_file << srsran::hex_string(it->second->op, 16);
+      m_db_file << srsran::hex_string(ue_ctx->op, 16);
     } else {
       m_db_file << "opc,";
-      m_db_file << srsran::hex_string(it->second->opc, 16);
+      m_db_file << srsran::hex_string(ue_ctx->opc, 16);
     }
     m_db_file << ",";
-    m_db_file << srsran::hex_string(it->second->amf, 2);
+    m_db_file << srsran::hex_string(ue_ctx->amf, 2);
     m_db_file << ",";
-    m_db_file << srsran::hex_string(it->second->sqn, 6);
+    m_db_file << srsran::hex_string(ue_ctx->sqn, 6);
     m_db_file << ",";
-    m_db_file << it->second->qci;
-    if (it->second->static_ip_addr != "0.0.0.0") {
+    m_db_file << ue_ctx->qci;
+    if (ue_ctx->static_ip_addr != 0) {
+      char ip_str[INET_ADDRSTRLEN];
+      inet_ntop(AF_INET, &ue_ctx->static_ip_addr, ip_str, sizeof(ip_str));
       m_db_file << ",";
-      m_db_file << it->second->static_ip_addr;
+      m_db_file << ip_str;
     } else {
       m_db_file << ",dynamic";
     }
     m_db_file << std::endl;
-    it++;
   }
   if (m_db_file.is_open()) {
     m_db_file.close();
@@ -256,6 +325,7 @@ bool hss::write_db_file(std::string db_filename)
 
 bool hss::gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres)
 {
+  std::lock_guard<std::mutex> lock(m_nas_mutex);
 
   m_logger.debug("Generating AUTH info answer");
   hss_ue_ctx_t* ue_ctx = get_ue_ctx(imsi);
@@ -270,10 +340,15 @@ bool hss::gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, ui
       gen_auth_info_answer_xor(ue_ctx, k_asme, autn, rand, xres);
       break;
     case HSS_ALGO_MILENAGE:
-      gen_auth_info_answer_milenage(ue_ctx, k_asme, autn, rand, xres);
+      if (not pop_cached_auth_vector(ue_ctx, k_asme, autn, rand, xres)) {
+        gen_auth_info_answer_milenage(ue_ctx, k_asme, autn, rand, xres);
+      }
       break;
   }
   increment_ue_sqn(ue_ctx);
+  if (ue_ctx->algo == HSS_ALGO_MILENAGE) {
+    schedule_auth_vector_refill(imsi);
+  }
   return true;
 }
 
@@ -339,6 +414,175 @@ void hss::gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx,
   return;
 }
 
+bool hss::pop_cached_auth_vector(hss_ue_ctx_t* ue_ctx,
+                                 uint8_t*      k_asme,
+                                 uint8_t*      autn,
+                                 uint8_t*      rand,
+                                 uint8_t*      xres)
+{
+  auto it = m_av_cache.find(ue_ctx->imsi);
+  if (it == m_av_cache.end() or it->second.vectors.empty()) {
+    return false;
+  }
+  hss_av_cache_t& cache = it->second;
+
+  // The vectors are only valid if the SQN did not move since they were computed
+  const hss_auth_vector_t& av = cache.vectors.front();
+  if (memcmp(av.sqn, ue_ctx->sqn, sizeof(av.sqn)) != 0) {
+    m_logger.info("Discarding %zd stale authentication vectors. IMSI: %015" PRIu64 "",
+                  cache.vectors.size(),
+                  ue_ctx->imsi);
+    discard_cached_auth_vectors(ue_ctx->imsi);
+    return false;
+  }
+
+  memcpy(k_asme, av.k_asme, sizeof(av.k_asme));
+  memcpy(autn, av.autn, sizeof(av.autn));
+  memcpy(rand, av.rand, sizeof(av.rand));
+  memcpy(xres, av.xres, sizeof(av.xres));
+  ue_ctx->set_last_rand(rand);
+  cache.vectors.pop_front();
+
+  m_logger.debug("Using precomputed authentication vector. IMSI: %015" PRIu64 "", ue_ctx->imsi);
+  m_logger.debug(autn, 16, "User AUTN: ");
+  return true;
+}
+
+void hss::discard_cached_auth_vectors(uint64_t imsi)
+{
+  auto it = m_av_cache.find(imsi);
+  if (it != m_av_cache.end()) {
+    // Bumping the generation drops the vectors the AV worker may be computing
+    it->second.vectors.clear();
+    it->second.generation++;
+  }
+}
+
+void hss::schedule_auth_vector_refill(uint64_t imsi)
+{
+  if (m_av_worker == nullptr) {
+    return;
+  }
+  hss_av_cache_t& cache = m_av_cache[imsi];
+  if (cache.refill_pending or cache.vectors.size() >= m_av_cache_size) {
+    return;
+  }
+  cache.refill_pending = true;
+
+  // Subscribers are batched in the refill queue, a task is only pushed when the queue goes from empty to non-empty
+  m_av_refill_queue.push_back(imsi);
+  if (m_av_refill_queue.size() == 1) {
+    m_av_worker->push_task([this]() { refill_auth_vectors(); });
+  }
+}
+
+void hss::refill_auth_vectors()
+{
+  struct refill_job_t {
+    uint64_t imsi;
+    uint32_t generation;
+    uint32_t first_av;
+    uint32_t nof_avs;
+  };
+  std::vector<refill_job_t>             jobs;
+  std::vector<hss_ue_ctx_t>             ue_ctxs;
+  std::vector<hss_auth_vector_t>        avs;
+  std::vector<srsran::milenage_input_t> inputs;
+
+  // Take a snapshot of the subscribers to refill, the vectors are computed without holding the lock
+  {
+    std::lock_guard<std::mutex> lock(m_nas_mutex);
+    for (uint64_t imsi : m_av_refill_queue) {
+      auto it = m_av_cache.find(imsi);
+      if (it == m_av_cache.end()) {
+        continue;
+      }
+      hss_av_cache_t& cache = it->second;
+      cache.refill_pending  = false;
+
+      hss_ue_ctx_t* ue_ctx = m_store.find(imsi);
+      if (ue_ctx == nullptr or ue_ctx->algo != HSS_ALGO_MILENAGE or cache.vectors.size() >= m_av_cache_size) {
+        continue;
+      }
+
+      refill_job_t job = {};
+      job.imsi         = imsi;
+      job.generation   = cache.generation;
+      job.first_av     = avs.size();
+      job.nof_avs      = m_av_cache_size - cache.vectors.size();
+
+      uint8_t sqn[6];
+      if (cache.vectors.empty()) {
+        memcpy(sqn, ue_ctx->sqn, sizeof(sqn));
+      } else {
+        increment_sqn(cache.vectors.back().sqn, sqn);
+      }
+      for (uint32_t i = 0; i < job.nof_avs; i++) {
+        hss_auth_vector_t av = {};
+        memcpy(av.sqn, sqn, sizeof(sqn));
+        gen_rand(av.rand);
+        avs.push_back(av);
+        increment_sqn(sqn, sqn);
+      }
+      jobs.push_back(job);
+      ue_ctxs.push_back(*ue_ctx);
+    }
+    m_av_refill_queue.clear();
+  }
+
+  // Compute f1 to f5 of all the vectors at once
+  for (uint32_t j = 0; j < jobs.size(); j++) {
+    const hss_ue_ctx_t& ue_ctx = ue_ctxs[j];
+    for (uint32_t i = 0; i < jobs[j].nof_avs; i++) {
+      const hss_auth_vector_t& av = avs[jobs[j].first_av + i];
+      inputs.push_back({ue_ctx.key, ue_ctx.opc, av.rand, av.sqn, ue_ctx.amf});
+    }
+  }
+  std::vector<srsran::milenage_output_t> outputs(inputs.size());
+  srsran::security_milenage_f12345_batch(inputs.data(), outputs.data(), inputs.size());
+
+  for (uint32_t i = 0; i < avs.size(); i++) {
+    hss_auth_vector_t&               av  = avs[i];
+    const srsran::milenage_output_t& out = outputs[i];
+
+    // AUTN = SQN ^ AK |+| AMF |+| MAC
+    for (int k = 0; k < 6; k++) {
+      av.autn[k] = av.sqn[k] ^ out.ak[k];
+    }
+    memcpy(&av.autn[6], inputs[i].amf, 2);
+    memcpy(&av.autn[8], out.mac_a, 8);
+    memcpy(av.xres, out.res, 8);
+    // The first 6 bytes of AUTN are SQN ^ AK
+    srsran::security_generate_k_asme(out.ck, out.ik, av.autn, mcc, mnc, av.k_asme);
+  }
+
+  std::lock_guard<std::mutex> lock(m_nas_mutex);
+  for (const refill_job_t& job : jobs) {
+    auto          it     = m_av_cache.find(job.imsi);
+    hss_ue_ctx_t* ue_ctx = m_store.find(job.imsi);
+    if (it == m_av_cache.end() or ue_ctx == nullptr or it->second.generation != job.generation) {
+      continue;
+    }
+    hss_av_cache_t& cache = it->second;
+
+    // Only append the vectors if they follow the ones in the cache, the SQN may have moved in the meantime
+    uint8_t next_sqn[6];
+    if (cache.vectors.empty()) {
+      memcpy(next_sqn, ue_ctx->sqn, sizeof(next_sqn));
+    } else {
+      increment_sqn(cache.vectors.back().sqn, next_sqn);
+    }
+    if (memcmp(next_sqn, avs[job.first_av].sqn, sizeof(next_sqn)) != 0) {
+      m_logger.debug("Dropping out of order authentication vectors. IMSI: %015" PRIu64 "", job.imsi);
+      continue;
+    }
+    for (uint32_t i = 0; i < job.nof_avs and cache.vectors.size() < m_av_cache_size; i++) {
+      cache.vectors.push_back(avs[job.first_av + i]);
+    }
+  }
+  m_logger.debug("Computed %zd authentication vectors for %zd subscribers", avs.size(), jobs.size());
+}
+
 void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres)
 {
   // Get K, AMF, OPC and SQN
@@ -440,13 +684,13 @@ void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_
 
 bool hss::gen_update_loc_answer(uint64_t imsi, uint8_t* qci)
 {
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
+  std::lock_guard<std::mutex> lock(m_nas_mutex);
+  const hss_ue_ctx_t*         ue_ctx = m_store.find(imsi);
+  if (ue_ctx == nullptr) {
     m_logger.info("User not found. IMSI: %015" PRIu64 "", imsi);
     srsran::console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
     return false;
   }
-  const std::unique_ptr<hss_ue_ctx_t>& ue_ctx = ue_ctx_it->second;
   m_logger.info("Found User %015" PRIu64 "", imsi);
   *qci = ue_ctx->qci;
   return true;
@@ -454,6 +698,7 @@ bool hss::gen_update_loc_answer(uint64_t imsi, uint8_t* qci)
 
 bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
 {
+  std::lock_guard<std::mutex> lock(m_nas_mutex);
   m_logger.debug("Re-syncing SQN");
   hss_ue_ctx_t* ue_ctx = get_ue_ctx(imsi);
   if (ue_ctx == nullptr) {
@@ -472,6 +717,13 @@ bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
   }
 
   increment_seq_after_resync(ue_ctx);
+  m_store.write_back(ue_ctx);
+
+  // The precomputed vectors use SQNs the UE rejected
+  discard_cached_auth_vectors(imsi);
+  if (ue_ctx->algo == HSS_ALGO_MILENAGE) {
+    schedule_auth_vector_refill(imsi);
+  }
   return true;
 }
 
@@ -538,6 +790,7 @@ void hss::resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* auts)
 void hss::increment_ue_sqn(hss_ue_ctx_t* ue_ctx)
 {
   increment_sqn(ue_ctx->sqn, ue_ctx->sqn);
+  m_store.write_back(ue_ctx);
   m_logger.debug("Incremented SQN  -- IMSI: %015" PRIu64 "", ue_ctx->imsi);
   m_logger.debug(ue_ctx->sqn, 6, "SQN: ");
 }
@@ -612,13 +865,11 @@ void hss::gen_rand(uint8_t rand_[16])
 
 hss_ue_ctx_t* hss::get_ue_ctx(uint64_t imsi)
 {
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
+  hss_ue_ctx_t* ue_ctx = m_store.find(imsi);
+  if (ue_ctx == nullptr) {
     m_logger.info("User not found. IMSI: %015" PRIu64 "", imsi);
-    return nullptr;
   }
-
-  return ue_ctx_it->second.get();
+  return ue_ctx;
 }
 
 std::map<std::string, uint64_t> hss::get_ip_to_imsi(void) const
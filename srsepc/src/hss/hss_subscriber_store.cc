@@ -0,0 +1,447 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#include "srsepc/hdr/hss/hss_subscriber_store.h"
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace srsepc {
+
+namespace {
+
+const uint32_t STORE_MAGIC   = 0x44535348; // "HSSD"
+const uint32_t STORE_VERSION = 1;
+const size_t   STORE_ALIGN   = 64;
+
+size_t align_size(size_t size)
+{
+  return (size + STORE_ALIGN - 1) & ~(STORE_ALIGN - 1);
+}
+
+} // namespace
+
+/// Layout of the store file: header | records | IMSI hash buckets | static IP record indexes.
+struct hss_subscriber_store::store_header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t nof_records;
+  uint32_t nof_buckets;
+  uint32_t nof_static_ips;
+  int64_t  csv_mtime_ns;
+  uint64_t csv_size;
+  uint8_t  reserved[24];
+};
+
+/// SQN update appended to the journal. The checksum is used to discard a torn entry at the end of the journal.
+struct hss_subscriber_store::journal_entry {
+  uint64_t imsi;
+  uint32_t record_idx;
+  uint32_t checksum;
+  uint8_t  sqn[6];
+  uint8_t  reserved[2];
+  uint8_t  last_rand[16];
+
+  uint32_t compute_checksum() const
+  {
+    // FNV-1a over the entry with the checksum field set to zero
+    journal_entry tmp = *this;
+    tmp.checksum      = 0;
+    const uint8_t* p  = reinterpret_cast<const uint8_t*>(&tmp);
+    uint32_t       h  = 0x811c9dc5;
+    for (size_t i = 0; i < sizeof(tmp); ++i) {
+      h = (h ^ p[i]) * 0x01000193;
+    }
+    return h;
+  }
+};
+
+hss_subscriber_store::~hss_subscriber_store()
+{
+  close();
+}
+
+uint32_t hss_subscriber_store::hash_imsi(uint64_t imsi)
+{
+  return (uint32_t)((imsi * 0x9e3779b97f4a7c15ULL) >> 32U);
+}
+
+size_t hss_subscriber_store::compute_file_size(uint32_t nof_records_, uint32_t nof_buckets_, uint32_t nof_static_ips_)
+{
+  static_assert(sizeof(store_header) == STORE_ALIGN, "Invalid HSS store header size");
+  return sizeof(store_header) + align_size(nof_records_ * sizeof(hss_ue_ctx_t)) +
+         align_size(nof_buckets_ * sizeof(uint32_t)) + nof_static_ips_ * sizeof(uint32_t);
+}
+
+bool hss_subscriber_store::map_file(const std::string& path, int flags, size_t file_size)
+{
+  if (path.empty()) {
+    map = (uint8_t*)mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  } else {
+    store_fd = ::open(path.c_str(), flags, 0644);
+    if (store_fd < 0) {
+      logger.info("Could not open HSS store %s: %s", path.c_str(), strerror(errno));
+      return false;
+    }
+    if (file_size == 0) {
+      struct stat st = {};
+      if (fstat(store_fd, &st) < 0 or (size_t)st.st_size < sizeof(store_header)) {
+        ::close(store_fd);
+        store_fd = -1;
+        return false;
+      }
+      file_size = st.st_size;
+    } else if (ftruncate(store_fd, file_size) < 0) {
+      logger.error("Could not resize HSS store %s: %s", path.c_str(), strerror(errno));
+      ::close(store_fd);
+      store_fd = -1;
+      return false;
+    }
+    map = (uint8_t*)mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, store_fd, 0);
+  }
+
+  if (map == MAP_FAILED) {
+    logger.error("Could not map HSS store: %s", strerror(errno));
+    map = nullptr;
+    if (store_fd >= 0) {
+      ::close(store_fd);
+      store_fd = -1;
+    }
+    return false;
+  }
+  map_size = file_size;
+  header   = reinterpret_cast<store_header*>(map);
+  return true;
+}
+
+void hss_subscriber_store::set_layout()
+{
+  nof_records = header->nof_records;
+  nof_buckets = header->nof_buckets;
+  records     = reinterpret_cast<hss_ue_ctx_t*>(map + sizeof(store_header));
+  buckets = reinterpret_cast<uint32_t*>(map + sizeof(store_header) + align_size(nof_records * sizeof(hss_ue_ctx_t)));
+  const uint32_t* static_ips = buckets + align_size(nof_buckets * sizeof(uint32_t)) / sizeof(uint32_t);
+  static_ip_records.assign(static_ips, static_ips + header->nof_static_ips);
+}
+
+bool hss_subscriber_store::check_layout() const
+{
+  // find() relies on every record being in a bucket and on the remaining buckets being empty
+  uint32_t nof_used_buckets = 0;
+  for (uint32_t i = 0; i < nof_buckets; ++i) {
+    if (buckets[i] > nof_records) {
+      return false;
+    }
+    nof_used_buckets += buckets[i] != 0 ? 1 : 0;
+  }
+  if (nof_used_buckets != nof_records) {
+    return false;
+  }
+  for (uint32_t idx : static_ip_records) {
+    if (idx >= nof_records) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool hss_subscriber_store::open_journal(const std::string& path, bool truncate)
+{
+  journal_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0), 0644);
+  if (journal_fd < 0) {
+    logger.error("Could not open HSS SQN journal %s: %s", path.c_str(), strerror(errno));
+    return false;
+  }
+  journal_entries = 0;
+  return true;
+}
+
+uint32_t hss_subscriber_store::replay_journal()
+{
+  uint32_t      nof_replayed = 0;
+  journal_entry entries[256];
+  if (lseek(journal_fd, 0, SEEK_SET) < 0) {
+    return 0;
+  }
+  while (true) {
+    ssize_t n = read(journal_fd, entries, sizeof(entries));
+    if (n <= 0) {
+      break;
+    }
+    size_t nof_entries = n / sizeof(journal_entry);
+    for (size_t i = 0; i < nof_entries; ++i) {
+      const journal_entry& e = entries[i];
+      if (e.checksum != e.compute_checksum() or e.record_idx >= nof_records or
+          records[e.record_idx].imsi != e.imsi) {
+        logger.warning("Discarding corrupted HSS SQN journal tail after %d entries", nof_replayed);
+        return nof_replayed;
+      }
+      records[e.record_idx].set_sqn(e.sqn);
+      records[e.record_idx].set_last_rand(e.last_rand);
+      nof_replayed++;
+    }
+    if ((size_t)n != sizeof(entries)) {
+      break;
+    }
+  }
+  return nof_replayed;
+}
+
+bool hss_subscriber_store::load(const std::string& path, const hss_csv_stamp_t* csv_stamp, bool sync_journal)
+{
+  close();
+  if (path.empty() or not map_file(path, O_RDWR, 0)) {
+    return false;
+  }
+
+  bool valid = header->magic == STORE_MAGIC and header->version == STORE_VERSION and
+               header->record_size == sizeof(hss_ue_ctx_t) and header->nof_buckets > 0 and
+               (header->nof_buckets & (header->nof_buckets - 1)) == 0 and
+               header->nof_buckets / 2 >= header->nof_records and
+               map_size == compute_file_size(header->nof_records, header->nof_buckets, header->nof_static_ips);
+  if (not valid) {
+    logger.warning("Ignoring invalid HSS store %s", path.c_str());
+    close();
+    return false;
+  }
+  if (csv_stamp != nullptr and not(*csv_stamp == hss_csv_stamp_t{header->csv_mtime_ns, header->csv_size})) {
+    logger.info("HSS store %s is out of date with the user database", path.c_str());
+    close();
+    return false;
+  }
+
+  set_layout();
+  if (not check_layout()) {
+    logger.warning("Ignoring corrupted HSS store %s", path.c_str());
+    close();
+    return false;
+  }
+  store_path = path;
+  sync       = sync_journal;
+  if (not open_journal(path + ".journal", false)) {
+    close();
+    return false;
+  }
+
+  uint32_t nof_replayed = replay_journal();
+  if (nof_replayed > 0) {
+    logger.info("Replayed %d SQN updates from the HSS journal", nof_replayed);
+  }
+  checkpoint();
+  return true;
+}
+
+bool hss_subscriber_store::open(const std::string& path, const hss_csv_stamp_t& csv_stamp, bool sync_journal)
+{
+  return load(path, &csv_stamp, sync_journal);
+}
+
+bool hss_subscriber_store::create(const std::string&               path,
+                                  const hss_csv_stamp_t&           csv_stamp,
+                                  const std::vector<hss_ue_ctx_t>& subscribers,
+                                  bool                             sync_journal)
+{
+  close();
+
+  // The previous store, if any, may hold SQNs more recent than the ones in the user database
+  hss_subscriber_store previous;
+  previous.load(path, nullptr, false);
+
+  uint32_t new_nof_records = subscribers.size();
+  uint32_t new_nof_buckets = 16;
+  while (new_nof_buckets < 2 * new_nof_records) {
+    new_nof_buckets *= 2;
+  }
+  uint32_t nof_static_ips = 0;
+  for (const hss_ue_ctx_t& ue : subscribers) {
+    nof_static_ips += ue.static_ip_addr != 0 ? 1 : 0;
+  }
+
+  std::string tmp_path = path.empty() ? path : path + ".tmp";
+  if (not map_file(tmp_path,
+                   O_RDWR | O_CREAT | O_TRUNC,
+                   compute_file_size(new_nof_records, new_nof_buckets, nof_static_ips))) {
+    return false;
+  }
+  header->magic          = STORE_MAGIC;
+  header->version        = STORE_VERSION;
+  header->record_size    = sizeof(hss_ue_ctx_t);
+  header->nof_records    = new_nof_records;
+  header->nof_buckets    = new_nof_buckets;
+  header->nof_static_ips = nof_static_ips;
+  header->csv_mtime_ns   = csv_stamp.mtime_ns;
+  header->csv_size       = csv_stamp.size;
+  set_layout();
+
+  static_ip_records.clear();
+  for (uint32_t i = 0; i < new_nof_records; ++i) {
+    hss_ue_ctx_t& ue = records[i];
+    ue               = subscribers[i];
+
+    uint32_t h = hash_imsi(ue.imsi) & bucket_mask();
+    while (buckets[h] != 0) {
+      if (records[buckets[h] - 1].imsi == ue.imsi) {
+        logger.error("Duplicate IMSI %015" PRIu64 " in the HSS store", ue.imsi);
+        close();
+        unlink(tmp_path.c_str());
+        return false;
+      }
+      h = (h + 1) & bucket_mask();
+    }
+    buckets[h] = i + 1;
+
+    const hss_ue_ctx_t* prev = previous.find(ue.imsi);
+    if (prev != nullptr and memcmp(prev->sqn, ue.sqn, 6) > 0) {
+      // SQNs are big endian, so the byte comparison is also the numeric one
+      ue.set_sqn(prev->sqn);
+      memcpy(ue.last_rand, prev->last_rand, 16);
+    }
+    if (ue.static_ip_addr != 0) {
+      static_ip_records.push_back(i);
+    }
+  }
+  memcpy(buckets + align_size(new_nof_buckets * sizeof(uint32_t)) / sizeof(uint32_t),
+         static_ip_records.data(),
+         static_ip_records.size() * sizeof(uint32_t));
+  previous.close();
+
+  sync = sync_journal;
+  if (path.empty()) {
+    return true;
+  }
+  if (msync(map, map_size, MS_SYNC) < 0 or rename(tmp_path.c_str(), path.c_str()) < 0) {
+    logger.error("Could not write HSS store %s: %s", path.c_str(), strerror(errno));
+    close();
+    unlink(tmp_path.c_str());
+    return false;
+  }
+  store_path = path;
+  if (not open_journal(path + ".journal", true)) {
+    close();
+    return false;
+  }
+  logger.info("Created HSS store %s with %d subscribers", path.c_str(), nof_records);
+  return true;
+}
+
+void hss_subscriber_store::close()
+{
+  if (map == nullptr) {
+    return;
+  }
+  checkpoint();
+  munmap(map, map_size);
+  if (store_fd >= 0) {
+    ::close(store_fd);
+  }
+  if (journal_fd >= 0) {
+    ::close(journal_fd);
+  }
+  store_fd        = -1;
+  journal_fd      = -1;
+  map             = nullptr;
+  map_size        = 0;
+  header          = nullptr;
+  records         = nullptr;
+  buckets         = nullptr;
+  nof_records     = 0;
+  nof_buckets     = 0;
+  journal_entries = 0;
+  store_path.clear();
+  static_ip_records.clear();
+}
+
+hss_ue_ctx_t* hss_subscriber_store::find(uint64_t imsi)
+{
+  if (nof_buckets == 0) {
+    return nullptr;
+  }
+  // The load factor is at most 0.5, so there is always an empty bucket that ends the probing
+  for (uint32_t h = hash_imsi(imsi) & bucket_mask();; h = (h + 1) & bucket_mask()) {
+    uint32_t b = buckets[h];
+    if (b == 0) {
+      return nullptr;
+    }
+    if (records[b - 1].imsi == imsi) {
+      return &records[b - 1];
+    }
+  }
+}
+
+void hss_subscriber_store::write_back(const hss_ue_ctx_t* ue_ctx)
+{
+  if (journal_fd < 0) {
+    return;
+  }
+
+  journal_entry e = {};
+  e.imsi          = ue_ctx->imsi;
+  e.record_idx    = ue_ctx - records;
+  memcpy(e.sqn, ue_ctx->sqn, 6);
+  memcpy(e.last_rand, ue_ctx->last_rand, 16);
+  e.checksum = e.compute_checksum();
+
+  if (write(journal_fd, &e, sizeof(e)) != sizeof(e)) {
+    logger.error("Could not write SQN update of IMSI %015" PRIu64 " to the HSS journal", ue_ctx->imsi);
+    return;
+  }
+  if (sync) {
+    fdatasync(journal_fd);
+  }
+  if (++journal_entries >= JOURNAL_CHECKPOINT_ENTRIES) {
+    checkpoint();
+  }
+}
+
+void hss_subscriber_store::set_csv_stamp(const hss_csv_stamp_t& csv_stamp)
+{
+  if (header == nullptr) {
+    return;
+  }
+  header->csv_mtime_ns = csv_stamp.mtime_ns;
+  header->csv_size     = csv_stamp.size;
+}
+
+void hss_subscriber_store::checkpoint()
+{
+  if (store_fd < 0) {
+    return;
+  }
+  // The journal can only be dropped once the records it describes are on disk
+  if (msync(map, map_size, MS_SYNC) < 0) {
+    logger.error("Could not sync HSS store %s: %s", store_path.c_str(), strerror(errno));
+    return;
+  }
+  if (journal_fd >= 0) {
+    if (ftruncate(journal_fd, 0) < 0) {
+      logger.error("Could not truncate HSS SQN journal: %s", strerror(errno));
+    }
+    if (sync) {
+      fsync(journal_fd);
+    }
+  }
+  journal_entries = 0;
+}
+
+} // namespace srsepc
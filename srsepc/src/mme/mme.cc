@@ -23,6 +23,7 @@
 #include <arpa/inet.h>
 #include <inttypes.h> // for printing uint64_t
 #include <netinet/sctp.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
@@ -63,6 +64,13 @@ void mme::cleanup(void)
 
 int mme::init(mme_args_t* args)
 {
+  /*Init event loop*/
+  m_epoll_fd = epoll_create1(0);
+  if (m_epoll_fd == -1) {
+    srsran::console("Error creating MME epoll instance: %s\n", strerror(errno));
+    exit(-1);
+  }
+
   /*Init S1AP*/
   m_s1ap = s1ap::get_instance();
   if (m_s1ap->init(args->s1ap_args)) {
@@ -86,11 +94,15 @@ int mme::init(mme_args_t* args)
 void mme::stop()
 {
   if (m_running) {
-    m_s1ap->stop();
-    m_s1ap->cleanup();
     m_running = false;
     thread_cancel();
     wait_thread_finish();
+    m_s1ap->stop();
+    m_s1ap->cleanup();
+  }
+  if (m_epoll_fd != -1) {
+    close(m_epoll_fd);
+    m_epoll_fd = -1;
   }
   return;
 }
@@ -118,28 +130,31 @@ void mme::run_thread()
   int s1mme = m_s1ap->get_s1_mme();
   int s11   = m_mme_gtpc->get_s11();
 
-  while (m_running) {
-    pdu->clear();
-    int max_fd = std::max(s1mme, s11);
-
-    FD_ZERO(&m_set);
-    FD_SET(s1mme, &m_set);
-    FD_SET(s11, &m_set);
-
-    // Add timers to select
-    for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end(); ++it) {
-      FD_SET(it->fd, &m_set);
-      max_fd = std::max(max_fd, it->fd);
-      m_s1ap_logger.debug("Adding Timer fd %d to fd_set", it->fd);
+  struct epoll_event ev = {};
+  ev.events             = EPOLLIN;
+  for (int fd : {s1mme, s11}) {
+    ev.data.fd = fd;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+      m_s1ap_logger.error("Error adding fd %d to MME epoll: %s", fd, strerror(errno));
+      return;
     }
+  }
 
+  struct epoll_event events[MME_MAX_EPOLL_EVENTS];
+  while (m_running) {
     m_s1ap_logger.debug("Waiting for S1-MME or S11 Message");
-    int n = select(max_fd + 1, &m_set, NULL, NULL, NULL);
+    int n = epoll_wait(m_epoll_fd, events, MME_MAX_EPOLL_EVENTS, -1);
     if (n == -1) {
-      m_s1ap_logger.error("Error from select");
-    } else if (n) {
-      // Handle S1-MME
-      if (FD_ISSET(s1mme, &m_set)) {
+      if (errno != EINTR) {
+        m_s1ap_logger.error("Error from epoll_wait: %s", strerror(errno));
+      }
+      continue;
+    }
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      pdu->clear();
+      if (fd == s1mme) {
+        // Handle S1-MME
         rd_sz = sctp_recvmsg(s1mme, pdu->msg, sz, (struct sockaddr*)&enb_addr, &fromlen, &sri, &msg_flags);
         if (rd_sz == -1 && errno != EAGAIN) {
           m_s1ap_logger.error("Error reading from SCTP socket: %s", strerror(errno));
@@ -162,27 +177,14 @@ void mme::run_thread()
             m_s1ap->handle_s1ap_rx_pdu(pdu.get(), &sri);
           }
         }
-      }
-      // Handle S11
-      if (FD_ISSET(s11, &m_set)) {
+      } else if (fd == s11) {
+        // Handle S11
         pdu->N_bytes = recvfrom(s11, pdu->msg, sz, 0, NULL, NULL);
         m_mme_gtpc->handle_s11_pdu(pdu.get());
+      } else {
+        // Handle NAS Timers
+        handle_timer_expire(fd);
       }
-      // Handle NAS Timers
-      for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end();) {
-        if (FD_ISSET(it->fd, &m_set)) {
-          m_s1ap_logger.info("Timer expired");
-          uint64_t exp;
-          rd_sz = read(it->fd, &exp, sizeof(uint64_t));
-          m_s1ap->expire_nas_timer(it->type, it->imsi);
-          close(it->fd);
-          timers.erase(it);
-        } else {
-          ++it;
-        }
-      }
-    } else {
-      m_s1ap_logger.debug("No data from select.");
     }
   }
   return;
@@ -200,12 +202,22 @@ bool mme::add_nas_timer(int timer_fd, nas_timer_type type, uint64_t imsi)
   timer.type = type;
   timer.imsi = imsi;
 
+  struct epoll_event ev = {};
+  ev.events             = EPOLLIN;
+  ev.data.fd            = timer_fd;
+
+  std::lock_guard<std::mutex> lock(m_timers_mutex);
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev) == -1) {
+    m_s1ap_logger.error("Error adding NAS timer to MME epoll: %s", strerror(errno));
+    return false;
+  }
   timers.push_back(timer);
   return true;
 }
 
 bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
 {
+  std::lock_guard<std::mutex>        lock(m_timers_mutex);
   std::vector<mme_timer_t>::iterator it;
   for (it = timers.begin(); it != timers.end(); ++it) {
     if (it->type == type && it->imsi == imsi) {
@@ -217,6 +229,7 @@ bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
 
 bool mme::remove_nas_timer(nas_timer_type type, uint64_t imsi)
 {
+  std::lock_guard<std::mutex>        lock(m_timers_mutex);
   std::vector<mme_timer_t>::iterator it;
   for (it = timers.begin(); it != timers.end(); ++it) {
     if (it->type == type && it->imsi == imsi) {
@@ -230,10 +243,38 @@ bool mme::remove_nas_timer(nas_timer_type type, uint64_t imsi)
 
   // removing timer
   m_s1ap_logger.debug("Removing NAS timer from MME. IMSI %" PRIu64 ", Type %d, Fd: %d", imsi, type, it->fd);
-  FD_CLR(it->fd, &m_set);
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, it->fd, NULL);
   close(it->fd);
   timers.erase(it);
   return true;
 }
 
+void mme::handle_timer_expire(int timer_fd)
+{
+  mme_timer_t timer;
+  {
+    std::lock_guard<std::mutex>        lock(m_timers_mutex);
+    std::vector<mme_timer_t>::iterator it = timers.begin();
+    while (it != timers.end() && it->fd != timer_fd) {
+      ++it;
+    }
+    if (it == timers.end()) {
+      // Timer removed after the event was reported
+      return;
+    }
+    // Timer fds are non-blocking, a failed read means that the fd was reused by a timer that has not expired yet
+    uint64_t exp;
+    if (read(timer_fd, &exp, sizeof(uint64_t)) != sizeof(uint64_t)) {
+      return;
+    }
+    timer = *it;
+    epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, timer_fd, NULL);
+    close(timer_fd);
+    timers.erase(it);
+  }
+
+  m_s1ap_logger.info("Timer expired");
+  m_s1ap->expire_nas_timer(timer.type, timer.imsi);
+}
+
 } // namespace srsepc
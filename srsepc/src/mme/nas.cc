@@ -2050,7 +2050,7 @@ bool nas::start_t3413()
     return false;
   }
 
-  int fdt = timerfd_create(CLOCK_MONOTONIC, 0);
+  int fdt = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
   if (fdt < 0) {
     m_logger.error("Error creating timer. %s", strerror(errno));
     return false;
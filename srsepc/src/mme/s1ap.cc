@@ -22,6 +22,7 @@
 #include "srsepc/hdr/mme/s1ap.h"
 #include "srsran/asn1/gtpc.h"
 #include "srsran/common/bcd_helpers.h"
+#include "srsran/common/int_helpers.h"
 #include "srsran/common/liblte_security.h"
 #include "srsran/common/network_utils.h"
 #include <cmath>
@@ -33,6 +34,20 @@ namespace srsepc {
 s1ap*           s1ap::m_instance    = NULL;
 pthread_mutex_t s1ap_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+namespace {
+
+/// Index of the NAS worker running in the calling thread, if any.
+thread_local bool     is_nas_worker          = false;
+thread_local uint32_t current_nas_worker_idx = 0;
+
+/// Spreads consecutive IMSIs (as usually provisioned in the HSS) evenly across the NAS workers.
+uint32_t hash_imsi(uint64_t imsi)
+{
+  return (uint32_t)((imsi * 0x9e3779b97f4a7c15ULL) >> 32U);
+}
+
+} // namespace
+
 s1ap::s1ap() : m_s1mme(-1), m_next_mme_ue_s1ap_id(1), m_mme_gtpc(NULL) {}
 
 s1ap::~s1ap()
@@ -94,21 +109,39 @@ int s1ap::init(const s1ap_args_t& s1ap_args)
     return SRSRAN_ERROR;
   }
 
+  // Init NAS workers
+  for (uint32_t i = 0; i < s1ap_args.nas_workers; ++i) {
+    m_nas_workers.emplace_back(new srsran::task_worker("MME_NAS" + std::to_string(i), NAS_WORKER_QUEUE_SIZE));
+    m_nas_workers.back()->push_task([i]() {
+      is_nas_worker          = true;
+      current_nas_worker_idx = i;
+    });
+  }
+
   // Init PCAP
   m_pcap_enable = s1ap_args.pcap_enable;
   if (m_pcap_enable) {
-    m_pcap.open(s1ap_args.pcap_filename.c_str());
+    if (m_pcap.open(s1ap_args.pcap_filename.c_str()) != SRSRAN_SUCCESS) {
+      m_logger.error("Couldn't open %s to write S1AP PCAP", s1ap_args.pcap_filename.c_str());
+      m_pcap_enable = false;
+    }
   }
-  m_logger.info("S1AP Initialized");
+  m_logger.info("S1AP Initialized. NAS workers: %d", s1ap_args.nas_workers);
   return SRSRAN_SUCCESS;
 }
 
 void s1ap::stop()
 {
+  // Let the NAS workers finish before deleting the contexts they operate on
+  for (std::unique_ptr<srsran::task_worker>& worker : m_nas_workers) {
+    worker->stop();
+  }
+  m_nas_workers.clear();
+
   if (m_s1mme != -1) {
     close(m_s1mme);
   }
-  std::map<uint16_t, enb_ctx_t*>::iterator enb_it = m_active_enbs.begin();
+  std::unordered_map<uint16_t, enb_ctx_t*>::iterator enb_it = m_active_enbs.begin();
   while (enb_it != m_active_enbs.end()) {
     m_logger.info("Deleting eNB context. eNB Id: 0x%x", enb_it->second->enb_id);
     srsran::console("Deleting eNB context. eNB Id: 0x%x\n", enb_it->second->enb_id);
@@ -116,7 +149,7 @@ void s1ap::stop()
     m_active_enbs.erase(enb_it++);
   }
 
-  std::map<uint64_t, nas*>::iterator ue_it = m_imsi_to_nas_ctx.begin();
+  std::unordered_map<uint64_t, nas*>::iterator ue_it = m_imsi_to_nas_ctx.begin();
   while (ue_it != m_imsi_to_nas_ctx.end()) {
     m_logger.info("Deleting UE EMM context. IMSI: %015" PRIu64 "", ue_it->first);
     srsran::console("Deleting UE EMM context. IMSI: %015" PRIu64 "\n", ue_it->first);
@@ -143,7 +176,7 @@ int s1ap::get_s1_mme()
 
 uint32_t s1ap::get_next_mme_ue_s1ap_id()
 {
-  return m_next_mme_ue_s1ap_id++;
+  return m_next_mme_ue_s1ap_id.fetch_add(1, std::memory_order_relaxed);
 }
 
 int s1ap::enb_listen()
@@ -222,28 +255,43 @@ bool s1ap::s1ap_tx_pdu(const asn1::s1ap::s1ap_pdu_c& pdu, struct sctp_sndrcvinfo
     return false;
   }
 
+  write_pcap(buf->msg, buf->N_bytes);
+  return true;
+}
+
+void s1ap::write_pcap(uint8_t* msg, uint32_t len)
+{
   if (m_pcap_enable) {
-    m_pcap.write_s1ap(buf->msg, buf->N_bytes);
+    std::lock_guard<std::mutex> lock(m_pcap_mutex);
+    m_pcap.write_s1ap(msg, len);
   }
-
-  return true;
 }
 
 void s1ap::handle_s1ap_rx_pdu(srsran::byte_buffer_t* pdu, struct sctp_sndrcvinfo* enb_sri)
 {
   // Save PCAP
-  if (m_pcap_enable) {
-    m_pcap.write_s1ap(pdu->msg, pdu->N_bytes);
-  }
+  write_pcap(pdu->msg, pdu->N_bytes);
 
   // Get PDU type
-  s1ap_pdu_t     rx_pdu;
-  asn1::cbit_ref bref(pdu->msg, pdu->N_bytes);
-  if (rx_pdu.unpack(bref) != asn1::SRSASN_SUCCESS) {
+  std::unique_ptr<s1ap_rx_pdu_t> rx(new s1ap_rx_pdu_t);
+  asn1::cbit_ref                 bref(pdu->msg, pdu->N_bytes);
+  if (rx->pdu.unpack(bref) != asn1::SRSASN_SUCCESS) {
     m_logger.error("Failed to unpack received PDU");
     return;
   }
+  rx->sri = *enb_sri;
+
+  // UE associated procedures run in the NAS worker that owns the UE context, the rest in the calling thread
+  uint32_t worker_idx = 0;
+  if (not get_nas_worker_from_pdu(rx->pdu, worker_idx)) {
+    handle_s1ap_pdu(rx->pdu, &rx->sri);
+    return;
+  }
+  run_in_nas_worker(worker_idx, [this, rx = std::move(rx)]() { handle_s1ap_pdu(rx->pdu, &rx->sri); });
+}
 
+void s1ap::handle_s1ap_pdu(const s1ap_pdu_t& rx_pdu, struct sctp_sndrcvinfo* enb_sri)
+{
   switch (rx_pdu.type().value) {
     case s1ap_pdu_t::types_opts::init_msg:
       m_logger.info("Received Initiating PDU");
@@ -310,21 +358,148 @@ void s1ap::handle_successful_outcome(const asn1::s1ap::successful_outcome_s& msg
   }
 }
 
+// NAS workers
+bool s1ap::get_nas_worker_from_pdu(const s1ap_pdu_t& rx_pdu, uint32_t& worker_idx)
+{
+  using init_msg_type_opts_t           = asn1::s1ap::s1ap_elem_procs_o::init_msg_c::types_opts;
+  using successful_outcome_type_opts_t = asn1::s1ap::s1ap_elem_procs_o::successful_outcome_c::types_opts;
+
+  if (m_nas_workers.empty()) {
+    return false;
+  }
+
+  if (rx_pdu.type().value == s1ap_pdu_t::types_opts::init_msg) {
+    const asn1::s1ap::init_msg_s& msg = rx_pdu.init_msg();
+    switch (msg.value.type().value) {
+      case init_msg_type_opts_t::init_ue_msg:
+        worker_idx = get_nas_worker_from_init_ue_msg(msg.value.init_ue_msg());
+        return true;
+      case init_msg_type_opts_t::ul_nas_transport:
+        worker_idx = get_nas_worker_from_mme_ue_s1ap_id(msg.value.ul_nas_transport()->mme_ue_s1ap_id.value.value);
+        return true;
+      case init_msg_type_opts_t::ue_context_release_request:
+        worker_idx =
+            get_nas_worker_from_mme_ue_s1ap_id(msg.value.ue_context_release_request()->mme_ue_s1ap_id.value.value);
+        return true;
+      default:
+        return false;
+    }
+  }
+  if (rx_pdu.type().value == s1ap_pdu_t::types_opts::successful_outcome) {
+    const asn1::s1ap::successful_outcome_s& msg = rx_pdu.successful_outcome();
+    switch (msg.value.type().value) {
+      case successful_outcome_type_opts_t::init_context_setup_resp:
+        worker_idx =
+            get_nas_worker_from_mme_ue_s1ap_id(msg.value.init_context_setup_resp()->mme_ue_s1ap_id.value.value);
+        return true;
+      case successful_outcome_type_opts_t::ue_context_release_complete:
+        worker_idx =
+            get_nas_worker_from_mme_ue_s1ap_id(msg.value.ue_context_release_complete()->mme_ue_s1ap_id.value.value);
+        return true;
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+uint32_t s1ap::get_nas_worker_from_init_ue_msg(const asn1::s1ap::init_ue_msg_s& init_ue)
+{
+  // Service, detach and TAU requests identify the UE by its S-TMSI
+  if (init_ue->s_tmsi_present) {
+    uint32_t m_tmsi = 0;
+    srsran::uint8_to_uint32(init_ue->s_tmsi.value.m_tmsi.data(), &m_tmsi);
+    return get_nas_worker_from_m_tmsi(m_tmsi);
+  }
+
+  // Attach requests carry either the IMSI or the GUTI of the UE
+  srsran::unique_byte_buffer_t nas_msg = srsran::make_byte_buffer();
+  if (nas_msg == nullptr or init_ue->nas_pdu.value.size() > nas_msg->get_tailroom()) {
+    return 0;
+  }
+  memcpy(nas_msg->msg, init_ue->nas_pdu.value.data(), init_ue->nas_pdu.value.size());
+  nas_msg->N_bytes = init_ue->nas_pdu.value.size();
+
+  uint8_t pd, msg_type;
+  liblte_mme_parse_msg_header((LIBLTE_BYTE_MSG_STRUCT*)nas_msg.get(), &pd, &msg_type);
+  if (msg_type != LIBLTE_MME_MSG_TYPE_ATTACH_REQUEST) {
+    return 0;
+  }
+  LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT attach_req = {};
+  if (liblte_mme_unpack_attach_request_msg((LIBLTE_BYTE_MSG_STRUCT*)nas_msg.get(), &attach_req) != LIBLTE_SUCCESS) {
+    return 0;
+  }
+  if (attach_req.eps_mobile_id.type_of_id == LIBLTE_MME_EPS_MOBILE_ID_TYPE_GUTI) {
+    return get_nas_worker_from_m_tmsi(attach_req.eps_mobile_id.guti.m_tmsi);
+  }
+  uint64_t imsi = 0;
+  for (int i = 0; i <= 14; i++) {
+    imsi = imsi * 10 + attach_req.eps_mobile_id.imsi[i];
+  }
+  return get_nas_worker_from_imsi(imsi);
+}
+
+uint32_t s1ap::get_nas_worker_from_imsi_unlocked(uint64_t imsi)
+{
+  std::unordered_map<uint64_t, nas*>::iterator it = m_imsi_to_nas_ctx.find(imsi);
+  if (it != m_imsi_to_nas_ctx.end()) {
+    return it->second->m_nas_worker_idx;
+  }
+  return hash_imsi(imsi) % m_nas_workers.size();
+}
+
+uint32_t s1ap::get_nas_worker_from_imsi(uint64_t imsi)
+{
+  if (m_nas_workers.size() <= 1) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(m_ue_ctx_mutex);
+  return get_nas_worker_from_imsi_unlocked(imsi);
+}
+
+uint32_t s1ap::get_nas_worker_from_m_tmsi(uint32_t m_tmsi)
+{
+  if (m_nas_workers.size() <= 1) {
+    return 0;
+  }
+  std::lock_guard<std::mutex>                      lock(m_ue_ctx_mutex);
+  std::unordered_map<uint32_t, uint64_t>::iterator it = m_tmsi_to_imsi.find(m_tmsi);
+  if (it != m_tmsi_to_imsi.end()) {
+    return get_nas_worker_from_imsi_unlocked(it->second);
+  }
+  return m_tmsi % m_nas_workers.size();
+}
+
+uint32_t s1ap::get_nas_worker_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
+{
+  if (m_nas_workers.size() <= 1) {
+    return 0;
+  }
+  std::lock_guard<std::mutex>                  lock(m_ue_ctx_mutex);
+  std::unordered_map<uint32_t, nas*>::iterator it = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
+  if (it != m_mme_ue_s1ap_id_to_nas_ctx.end()) {
+    return it->second->m_nas_worker_idx;
+  }
+  return mme_ue_s1ap_id % m_nas_workers.size();
+}
+
 // eNB Context Managment
 void s1ap::add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinfo* enb_sri)
 {
   m_logger.info("Adding new eNB context. eNB ID %d", enb_ctx.enb_id);
-  std::set<uint32_t> ue_set;
-  enb_ctx_t*         enb_ptr = new enb_ctx_t;
-  *enb_ptr                   = enb_ctx;
+  enb_ctx_t* enb_ptr = new enb_ctx_t;
+  *enb_ptr           = enb_ctx;
+
+  std::lock_guard<std::mutex> lock(m_enb_mutex);
   m_active_enbs.insert(std::pair<uint16_t, enb_ctx_t*>(enb_ptr->enb_id, enb_ptr));
   m_sctp_to_enb_id.insert(std::pair<int32_t, uint16_t>(enb_sri->sinfo_assoc_id, enb_ptr->enb_id));
-  m_enb_assoc_to_ue_ids.insert(std::pair<int32_t, std::set<uint32_t> >(enb_sri->sinfo_assoc_id, ue_set));
+  m_enb_assoc_to_ue_ids.insert(std::make_pair(enb_sri->sinfo_assoc_id, std::unordered_set<uint32_t>()));
 }
 
 enb_ctx_t* s1ap::find_enb_ctx(uint16_t enb_id)
 {
-  std::map<uint16_t, enb_ctx_t*>::iterator it = m_active_enbs.find(enb_id);
+  std::lock_guard<std::mutex>                        lock(m_enb_mutex);
+  std::unordered_map<uint16_t, enb_ctx_t*>::iterator it = m_active_enbs.find(enb_id);
   if (it == m_active_enbs.end()) {
     return nullptr;
   } else {
@@ -332,15 +507,28 @@ enb_ctx_t* s1ap::find_enb_ctx(uint16_t enb_id)
   }
 }
 
-void s1ap::delete_enb_ctx(int32_t assoc_id)
+std::vector<std::pair<uint32_t, struct sctp_sndrcvinfo> > s1ap::get_active_enbs_sri()
 {
-  std::map<int32_t, uint16_t>::iterator it_assoc = m_sctp_to_enb_id.find(assoc_id);
-  uint16_t                              enb_id   = it_assoc->second;
+  std::vector<std::pair<uint32_t, struct sctp_sndrcvinfo> > enbs;
+  std::lock_guard<std::mutex>                               lock(m_enb_mutex);
+  enbs.reserve(m_active_enbs.size());
+  for (const std::pair<const uint16_t, enb_ctx_t*>& enb : m_active_enbs) {
+    enbs.emplace_back(enb.second->enb_id, enb.second->sri);
+  }
+  return enbs;
+}
 
-  std::map<uint16_t, enb_ctx_t*>::iterator it_ctx = m_active_enbs.find(enb_id);
-  if (it_ctx == m_active_enbs.end() || it_assoc == m_sctp_to_enb_id.end()) {
-    m_logger.error("Could not find eNB to delete. Association: %d", assoc_id);
-    return;
+void s1ap::delete_enb_ctx(int32_t assoc_id)
+{
+  uint16_t enb_id;
+  {
+    std::lock_guard<std::mutex>                     lock(m_enb_mutex);
+    std::unordered_map<int32_t, uint16_t>::iterator it_assoc = m_sctp_to_enb_id.find(assoc_id);
+    if (it_assoc == m_sctp_to_enb_id.end() or m_active_enbs.count(it_assoc->second) == 0) {
+      m_logger.error("Could not find eNB to delete. Association: %d", assoc_id);
+      return;
+    }
+    enb_id = it_assoc->second;
   }
 
   m_logger.info("Deleting eNB context. eNB Id: 0x%x", enb_id);
@@ -350,27 +538,34 @@ void s1ap::delete_enb_ctx(int32_t assoc_id)
   release_ues_ecm_ctx_in_enb(assoc_id);
 
   // Delete eNB
-  delete it_ctx->second;
-  m_active_enbs.erase(it_ctx);
-  m_sctp_to_enb_id.erase(it_assoc);
+  std::lock_guard<std::mutex>                        lock(m_enb_mutex);
+  std::unordered_map<uint16_t, enb_ctx_t*>::iterator it_ctx = m_active_enbs.find(enb_id);
+  if (it_ctx != m_active_enbs.end()) {
+    delete it_ctx->second;
+    m_active_enbs.erase(it_ctx);
+  }
+  m_sctp_to_enb_id.erase(assoc_id);
   return;
 }
 
 // UE Context Management
 bool s1ap::add_nas_ctx_to_imsi_map(nas* nas_ctx)
 {
-  std::map<uint64_t, nas*>::iterator ctx_it = m_imsi_to_nas_ctx.find(nas_ctx->m_emm_ctx.imsi);
+  std::lock_guard<std::mutex>                  lock(m_ue_ctx_mutex);
+  std::unordered_map<uint64_t, nas*>::iterator ctx_it = m_imsi_to_nas_ctx.find(nas_ctx->m_emm_ctx.imsi);
   if (ctx_it != m_imsi_to_nas_ctx.end()) {
     m_logger.error("UE Context already exists. IMSI %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
     return false;
   }
   if (nas_ctx->m_ecm_ctx.mme_ue_s1ap_id != 0) {
-    std::map<uint32_t, nas*>::iterator ctx_it2 = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
+    std::unordered_map<uint32_t, nas*>::iterator ctx_it2 =
+        m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
     if (ctx_it2 != m_mme_ue_s1ap_id_to_nas_ctx.end() && ctx_it2->second != nas_ctx) {
       m_logger.error("Context identified with IMSI does not match context identified by MME UE S1AP Id.");
       return false;
     }
   }
+  nas_ctx->m_nas_worker_idx = current_nas_worker_idx;
   m_imsi_to_nas_ctx.insert(std::pair<uint64_t, nas*>(nas_ctx->m_emm_ctx.imsi, nas_ctx));
   m_logger.debug("Saved UE context corresponding to IMSI %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
   return true;
@@ -382,18 +577,22 @@ bool s1ap::add_nas_ctx_to_mme_ue_s1ap_id_map(nas* nas_ctx)
     m_logger.error("Could not add UE context to MME UE S1AP map. MME UE S1AP ID 0 is not valid.");
     return false;
   }
-  std::map<uint32_t, nas*>::iterator ctx_it = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
+  std::lock_guard<std::mutex>                  lock(m_ue_ctx_mutex);
+  std::unordered_map<uint32_t, nas*>::iterator ctx_it =
+      m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
   if (ctx_it != m_mme_ue_s1ap_id_to_nas_ctx.end()) {
     m_logger.error("UE Context already exists. MME UE S1AP Id %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
     return false;
   }
   if (nas_ctx->m_emm_ctx.imsi != 0) {
-    std::map<uint32_t, nas*>::iterator ctx_it2 = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
+    std::unordered_map<uint32_t, nas*>::iterator ctx_it2 =
+        m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
     if (ctx_it2 != m_mme_ue_s1ap_id_to_nas_ctx.end() && ctx_it2->second != nas_ctx) {
       m_logger.error("Context identified with MME UE S1AP Id does not match context identified by IMSI.");
       return false;
     }
   }
+  nas_ctx->m_nas_worker_idx = current_nas_worker_idx;
   m_mme_ue_s1ap_id_to_nas_ctx.insert(std::pair<uint32_t, nas*>(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id, nas_ctx));
   m_logger.debug("Saved UE context corresponding to MME UE S1AP Id %d", nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
   return true;
@@ -401,24 +600,24 @@ bool s1ap::add_nas_ctx_to_mme_ue_s1ap_id_map(nas* nas_ctx)
 
 bool s1ap::add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id)
 {
-  std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
+  std::lock_guard<std::mutex>                                                   lock(m_enb_mutex);
+  std::unordered_map<int32_t, std::unordered_set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
   if (ues_in_enb == m_enb_assoc_to_ue_ids.end()) {
     m_logger.error("Could not find eNB from eNB SCTP association %d", enb_assoc);
     return false;
   }
-  std::set<uint32_t>::iterator ue_id = ues_in_enb->second.find(mme_ue_s1ap_id);
-  if (ue_id != ues_in_enb->second.end()) {
+  if (not ues_in_enb->second.insert(mme_ue_s1ap_id).second) {
     m_logger.error("UE with MME UE S1AP Id already exists %d", mme_ue_s1ap_id);
     return false;
   }
-  ues_in_enb->second.insert(mme_ue_s1ap_id);
   m_logger.debug("Added UE with MME-UE S1AP Id %d to eNB with association %d", mme_ue_s1ap_id, enb_assoc);
   return true;
 }
 
 nas* s1ap::find_nas_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
 {
-  std::map<uint32_t, nas*>::iterator it = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
+  std::lock_guard<std::mutex>                  lock(m_ue_ctx_mutex);
+  std::unordered_map<uint32_t, nas*>::iterator it = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
   if (it == m_mme_ue_s1ap_id_to_nas_ctx.end()) {
     return NULL;
   } else {
@@ -428,7 +627,8 @@ nas* s1ap::find_nas_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
 
 nas* s1ap::find_nas_ctx_from_imsi(uint64_t imsi)
 {
-  std::map<uint64_t, nas*>::iterator it = m_imsi_to_nas_ctx.find(imsi);
+  std::lock_guard<std::mutex>                  lock(m_ue_ctx_mutex);
+  std::unordered_map<uint64_t, nas*>::iterator it = m_imsi_to_nas_ctx.find(imsi);
   if (it == m_imsi_to_nas_ctx.end()) {
     return NULL;
   } else {
@@ -439,29 +639,47 @@ nas* s1ap::find_nas_ctx_from_imsi(uint64_t imsi)
 void s1ap::release_ues_ecm_ctx_in_enb(int32_t enb_assoc)
 {
   srsran::console("Releasing UEs context\n");
-  std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
-  std::set<uint32_t>::iterator                     ue_id      = ues_in_enb->second.begin();
-  if (ue_id == ues_in_enb->second.end()) {
-    srsran::console("No UEs to be released\n");
-  } else {
-    while (ue_id != ues_in_enb->second.end()) {
-      std::map<uint32_t, nas*>::iterator nas_ctx = m_mme_ue_s1ap_id_to_nas_ctx.find(*ue_id);
-      emm_ctx_t*                         emm_ctx = &nas_ctx->second->m_emm_ctx;
-      ecm_ctx_t*                         ecm_ctx = &nas_ctx->second->m_ecm_ctx;
-
-      m_logger.info(
-          "Releasing UE context. IMSI: %015" PRIu64 ", UE-MME S1AP Id: %d", emm_ctx->imsi, ecm_ctx->mme_ue_s1ap_id);
-      if (emm_ctx->state == EMM_STATE_REGISTERED) {
-        m_mme_gtpc->send_delete_session_request(emm_ctx->imsi);
-        emm_ctx->state = EMM_STATE_DEREGISTERED;
-      }
-      srsran::console("Releasing UE ECM context. UE-MME S1AP Id: %d\n", ecm_ctx->mme_ue_s1ap_id);
-      ecm_ctx->state          = ECM_STATE_IDLE;
-      ecm_ctx->mme_ue_s1ap_id = 0;
-      ecm_ctx->enb_ue_s1ap_id = 0;
-      ues_in_enb->second.erase(ue_id++);
+  std::unordered_set<uint32_t> ue_ids;
+  {
+    std::lock_guard<std::mutex>                                          lock(m_enb_mutex);
+    std::unordered_map<int32_t, std::unordered_set<uint32_t> >::iterator ues_in_enb =
+        m_enb_assoc_to_ue_ids.find(enb_assoc);
+    if (ues_in_enb != m_enb_assoc_to_ue_ids.end()) {
+      ue_ids.swap(ues_in_enb->second);
     }
   }
+  if (ue_ids.empty()) {
+    srsran::console("No UEs to be released\n");
+    return;
+  }
+
+  // Each UE is released by the NAS worker that owns its context
+  for (uint32_t mme_ue_s1ap_id : ue_ids) {
+    run_in_nas_worker(get_nas_worker_from_mme_ue_s1ap_id(mme_ue_s1ap_id),
+                      [this, mme_ue_s1ap_id]() { release_ue_ecm_ctx_in_enb(mme_ue_s1ap_id); });
+  }
+}
+
+void s1ap::release_ue_ecm_ctx_in_enb(uint32_t mme_ue_s1ap_id)
+{
+  nas* nas_ctx = find_nas_ctx_from_mme_ue_s1ap_id(mme_ue_s1ap_id);
+  if (nas_ctx == NULL) {
+    m_logger.warning("UE context already released. UE-MME S1AP Id: %d", mme_ue_s1ap_id);
+    return;
+  }
+  emm_ctx_t* emm_ctx = &nas_ctx->m_emm_ctx;
+  ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
+
+  m_logger.info(
+      "Releasing UE context. IMSI: %015" PRIu64 ", UE-MME S1AP Id: %d", emm_ctx->imsi, ecm_ctx->mme_ue_s1ap_id);
+  if (emm_ctx->state == EMM_STATE_REGISTERED) {
+    m_mme_gtpc->send_delete_session_request(emm_ctx->imsi);
+    emm_ctx->state = EMM_STATE_DEREGISTERED;
+  }
+  srsran::console("Releasing UE ECM context. UE-MME S1AP Id: %d\n", ecm_ctx->mme_ue_s1ap_id);
+  ecm_ctx->state          = ECM_STATE_IDLE;
+  ecm_ctx->mme_ue_s1ap_id = 0;
+  ecm_ctx->enb_ue_s1ap_id = 0;
 }
 
 bool s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
@@ -474,21 +692,26 @@ bool s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
   ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
 
   // Delete UE within eNB UE set
-  std::map<int32_t, uint16_t>::iterator it = m_sctp_to_enb_id.find(ecm_ctx->enb_sri.sinfo_assoc_id);
-  if (it == m_sctp_to_enb_id.end()) {
-    m_logger.error("Could not find eNB for UE release request.");
-    return false;
-  }
-  uint16_t                                         enb_id = it->second;
-  std::map<int32_t, std::set<uint32_t> >::iterator ue_set = m_enb_assoc_to_ue_ids.find(ecm_ctx->enb_sri.sinfo_assoc_id);
-  if (ue_set == m_enb_assoc_to_ue_ids.end()) {
-    m_logger.error("Could not find the eNB's UEs.");
-    return false;
+  {
+    std::lock_guard<std::mutex> lock(m_enb_mutex);
+    if (m_sctp_to_enb_id.count(ecm_ctx->enb_sri.sinfo_assoc_id) == 0) {
+      m_logger.error("Could not find eNB for UE release request.");
+      return false;
+    }
+    std::unordered_map<int32_t, std::unordered_set<uint32_t> >::iterator ue_set =
+        m_enb_assoc_to_ue_ids.find(ecm_ctx->enb_sri.sinfo_assoc_id);
+    if (ue_set == m_enb_assoc_to_ue_ids.end()) {
+      m_logger.error("Could not find the eNB's UEs.");
+      return false;
+    }
+    ue_set->second.erase(mme_ue_s1ap_id);
   }
-  ue_set->second.erase(mme_ue_s1ap_id);
 
   // Release UE ECM context
-  m_mme_ue_s1ap_id_to_nas_ctx.erase(mme_ue_s1ap_id);
+  {
+    std::lock_guard<std::mutex> lock(m_ue_ctx_mutex);
+    m_mme_ue_s1ap_id_to_nas_ctx.erase(mme_ue_s1ap_id);
+  }
   ecm_ctx->state          = ECM_STATE_IDLE;
   ecm_ctx->mme_ue_s1ap_id = 0;
   ecm_ctx->enb_ue_s1ap_id = 0;
@@ -499,42 +722,55 @@ bool s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
 
 bool s1ap::delete_ue_ctx(uint64_t imsi)
 {
-  nas* nas_ctx = find_nas_ctx_from_imsi(imsi);
-  if (nas_ctx == NULL) {
-    m_logger.info("Cannot delete UE context, UE not found. IMSI: %" PRIu64 "", imsi);
-    return false;
+  nas* nas_ctx = nullptr;
+  {
+    std::lock_guard<std::mutex>                  lock(m_ue_ctx_mutex);
+    std::unordered_map<uint64_t, nas*>::iterator it = m_imsi_to_nas_ctx.find(imsi);
+    if (it == m_imsi_to_nas_ctx.end()) {
+      m_logger.info("Cannot delete UE context, UE not found. IMSI: %" PRIu64 "", imsi);
+      return false;
+    }
+    nas_ctx = it->second;
+    m_imsi_to_nas_ctx.erase(it);
   }
 
-  // Make sure to release ECM ctx
-  if (nas_ctx->m_ecm_ctx.mme_ue_s1ap_id != 0) {
-    release_ue_ecm_ctx(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
-  }
+  auto release_and_delete = [this, nas_ctx]() {
+    // Make sure to release ECM ctx
+    if (nas_ctx->m_ecm_ctx.mme_ue_s1ap_id != 0) {
+      release_ue_ecm_ctx(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
+    }
 
-  // Delete UE context
-  m_imsi_to_nas_ctx.erase(imsi);
-  delete nas_ctx;
-  m_logger.info("Deleted UE Context.");
+    // Delete UE context
+    delete nas_ctx;
+    m_logger.info("Deleted UE Context.");
+  };
+
+  // The context may be owned by another NAS worker, e.g. when a UE re-attaches with an unknown GUTI
+  if (not is_nas_worker or nas_ctx->m_nas_worker_idx == current_nas_worker_idx) {
+    release_and_delete();
+  } else {
+    run_in_nas_worker(nas_ctx->m_nas_worker_idx, std::move(release_and_delete));
+  }
   return true;
 }
 
 // UE Bearer Managment
 void s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 {
-  std::map<uint64_t, nas*>::iterator ue_ctx_it = m_imsi_to_nas_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_nas_ctx.end()) {
+  nas* nas_ctx = find_nas_ctx_from_imsi(imsi);
+  if (nas_ctx == NULL) {
     m_logger.error("Could not activate EPS bearer: Could not find UE context");
     return;
   }
   // Make sure NAS is active
-  uint32_t                           mme_ue_s1ap_id = ue_ctx_it->second->m_ecm_ctx.mme_ue_s1ap_id;
-  std::map<uint32_t, nas*>::iterator it             = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
-  if (it == m_mme_ue_s1ap_id_to_nas_ctx.end()) {
+  uint32_t mme_ue_s1ap_id = nas_ctx->m_ecm_ctx.mme_ue_s1ap_id;
+  if (find_nas_ctx_from_mme_ue_s1ap_id(mme_ue_s1ap_id) == NULL) {
     m_logger.error("Could not activate EPS bearer: ECM context seems to be missing");
     return;
   }
 
-  ecm_ctx_t* ecm_ctx = &ue_ctx_it->second->m_ecm_ctx;
-  esm_ctx_t* esm_ctx = &ue_ctx_it->second->m_esm_ctx[ebi];
+  ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
+  esm_ctx_t* esm_ctx = &nas_ctx->m_esm_ctx[ebi];
   if (esm_ctx->state != ERAB_CTX_SETUP) {
     m_logger.error(
         "Could not be activate EPS Bearer, bearer in wrong state: MME S1AP Id %d, EPS Bearer id %d, state %d",
@@ -557,8 +793,9 @@ void s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 
 uint32_t s1ap::allocate_m_tmsi(uint64_t imsi)
 {
-  uint32_t m_tmsi = m_next_m_tmsi;
-  m_next_m_tmsi   = (m_next_m_tmsi + 1) % UINT32_MAX;
+  std::lock_guard<std::mutex> lock(m_ue_ctx_mutex);
+  uint32_t                    m_tmsi = m_next_m_tmsi;
+  m_next_m_tmsi                      = (m_next_m_tmsi + 1) % UINT32_MAX;
 
   m_tmsi_to_imsi.insert(std::pair<uint32_t, uint64_t>(m_tmsi, imsi));
   m_logger.debug("Allocated M-TMSI 0x%x to IMSI %015" PRIu64 ",", m_tmsi, imsi);
@@ -567,7 +804,8 @@ uint32_t s1ap::allocate_m_tmsi(uint64_t imsi)
 
 uint64_t s1ap::find_imsi_from_m_tmsi(uint32_t m_tmsi)
 {
-  std::map<uint32_t, uint64_t>::iterator it = m_tmsi_to_imsi.find(m_tmsi);
+  std::lock_guard<std::mutex>                      lock(m_ue_ctx_mutex);
+  std::unordered_map<uint32_t, uint64_t>::iterator it = m_tmsi_to_imsi.find(m_tmsi);
   if (it != m_tmsi_to_imsi.end()) {
     m_logger.debug("Found IMSI %015" PRIu64 " from M-TMSI 0x%x", it->second, m_tmsi);
     return it->second;
@@ -666,13 +904,19 @@ bool s1ap::send_downlink_nas_transport(uint32_t               enb_ue_s1ap_id,
 
 bool s1ap::expire_nas_timer(enum nas_timer_type type, uint64_t imsi)
 {
-  nas* nas_ctx = find_nas_ctx_from_imsi(imsi);
-  if (nas_ctx == NULL) {
+  if (find_nas_ctx_from_imsi(imsi) == NULL) {
     m_logger.error("Error finding NAS context to handle timer");
     return false;
   }
-  bool err = nas_ctx->expire_timer(type);
-  return err;
+  run_in_nas_worker(get_nas_worker_from_imsi(imsi), [this, type, imsi]() {
+    nas* nas_ctx = find_nas_ctx_from_imsi(imsi);
+    if (nas_ctx == NULL) {
+      m_logger.error("Error finding NAS context to handle timer");
+      return;
+    }
+    nas_ctx->expire_timer(type);
+  });
+  return true;
 }
 
 } // namespace srsepc
@@ -85,11 +85,9 @@ bool s1ap_paging::send_paging(uint64_t imsi, uint16_t erab_to_setup)
     return false;
   }
 
-  for (std::map<uint16_t, enb_ctx_t*>::iterator it = m_s1ap->m_active_enbs.begin(); it != m_s1ap->m_active_enbs.end();
-       it++) {
-    enb_ctx_t* enb_ctx = it->second;
-    if (!m_s1ap->s1ap_tx_pdu(tx_pdu, &enb_ctx->sri)) {
-      m_logger.error("Error paging to eNB. eNB Id: 0x%x.", enb_ctx->enb_id);
+  for (std::pair<uint32_t, struct sctp_sndrcvinfo>& enb : m_s1ap->get_active_enbs_sri()) {
+    if (!m_s1ap->s1ap_tx_pdu(tx_pdu, &enb.second)) {
+      m_logger.error("Error paging to eNB. eNB Id: 0x%x.", enb.first);
       return false;
     }
   }
@@ -0,0 +1,766 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Attach storm load generator for srsEPC. It emulates one eNB that connects to the MME over S1-MME and attaches a
+ * large number of UEs, keeping a window of attach procedures in flight. Each emulated UE sends an InitialUEMessage with
+ * an IMSI attach request and answers the authentication, security mode and initial context setup procedures. The
+ * attach is considered complete when the MME replies to the Attach Complete with the EMM Information message.
+ *
+ * The subscribers must be provisioned in the HSS. The "-u" option writes a matching user_db.csv with static IPs, so
+ * that the number of UEs is not limited by the SPGW dynamic IP pool:
+ *
+ *   attach_storm -u user_db.csv -n 5000
+ *   srsepc --hss.db_file user_db.csv --mme.nas_workers 4
+ *   attach_storm -n 5000 -w 256
+ */
+
+#include "srsran/asn1/liblte_mme.h"
+#include "srsran/asn1/s1ap.h"
+#include "srsran/common/bcd_helpers.h"
+#include "srsran/common/buffer_pool.h"
+#include "srsran/common/network_utils.h"
+#include "srsran/common/security.h"
+#include "srsran/common/standard_streams.h"
+#include "srsran/common/string_helpers.h"
+#include "srsran/config.h"
+#include "srsran/srslog/srslog.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <getopt.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <vector>
+
+using namespace asn1::s1ap;
+using srsran::byte_buffer_t;
+
+namespace {
+
+const uint32_t S1AP_PPID      = 18;
+const uint16_t NONUE_STREAM   = 0;
+const uint16_t UE_STREAM      = 1;
+const uint8_t  PROC_TRANS_ID  = 1;
+const uint32_t RES_LEN        = 8;
+const uint32_t ENB_GTPU_TEID0 = 0x100;
+
+struct storm_args {
+  std::string mme_addr    = "127.0.1.100";
+  std::string enb_addr    = "127.0.1.1";
+  std::string mcc         = "001";
+  std::string mnc         = "01";
+  uint16_t    tac         = 7;
+  uint32_t    enb_id      = 0x19b;
+  uint64_t    first_imsi  = 1010000000001ULL;
+  uint32_t    nof_ues     = 1000;
+  uint32_t    window      = 64;
+  uint32_t    timeout_ms  = 10000;
+  bool        use_xor     = false;
+  std::string key         = "00112233445566778899aabbccddeeff";
+  std::string opc         = "63bfa50ee6523365ff14c1f45f88737d";
+  std::string user_db_out = "";
+};
+
+enum class ue_state { idle, wait_auth, wait_smc, wait_ics, wait_emm_info, attached, failed };
+
+/// NAS and S1AP state of one emulated UE.
+struct emulated_ue {
+  uint64_t                              imsi           = 0;
+  uint32_t                              enb_ue_s1ap_id = 0;
+  uint32_t                              mme_ue_s1ap_id = 0;
+  ue_state                              state          = ue_state::idle;
+  std::chrono::steady_clock::time_point start;
+  uint8_t                               k_asme[32]    = {};
+  uint8_t                               k_nas_enc[32] = {};
+  uint8_t                               k_nas_int[32] = {};
+  srsran::CIPHERING_ALGORITHM_ID_ENUM   cipher_algo   = srsran::CIPHERING_ALGORITHM_ID_EEA0;
+  srsran::INTEGRITY_ALGORITHM_ID_ENUM   integ_algo    = srsran::INTEGRITY_ALGORITHM_ID_EIA0;
+};
+
+class attach_storm
+{
+public:
+  explicit attach_storm(const storm_args& args_) : args(args_) {}
+
+  int  run();
+  void print_report();
+
+private:
+  bool connect_to_mme();
+  bool s1_setup();
+  bool send_s1ap(const s1ap_pdu_c& pdu, uint16_t stream);
+  bool recv_s1ap(s1ap_pdu_c& pdu, int timeout_ms);
+
+  void start_attach(emulated_ue& ue);
+  void handle_rx_pdu(const s1ap_pdu_c& pdu);
+  void handle_dl_nas(emulated_ue& ue, byte_buffer_t* nas);
+  void handle_auth_request(emulated_ue& ue, byte_buffer_t* nas);
+  void handle_security_mode_command(emulated_ue& ue, byte_buffer_t* nas);
+  void handle_init_ctxt_setup_request(emulated_ue& ue, const init_context_setup_request_s& req);
+  void handle_ue_ctxt_release_command(const ue_context_release_cmd_s& cmd);
+  void send_ul_nas(emulated_ue& ue, byte_buffer_t* nas, bool initial);
+  void protect_nas(emulated_ue& ue, uint32_t count, byte_buffer_t* nas);
+  void finish(emulated_ue& ue, bool success);
+
+  emulated_ue* find_ue(uint32_t enb_ue_s1ap_id);
+
+  storm_args            args;
+  srsran::unique_socket sock;
+  uint16_t              mcc  = 0;
+  uint16_t              mnc  = 0;
+  uint32_t              plmn = 0;
+  uint8_t               key[16];
+  uint8_t               opc[16];
+
+  std::vector<emulated_ue> ues;
+  std::vector<uint32_t>    in_flight;
+  std::vector<double>      latencies_ms;
+  uint32_t                 nof_failed = 0;
+  double                   elapsed_s  = 0;
+};
+
+emulated_ue* attach_storm::find_ue(uint32_t enb_ue_s1ap_id)
+{
+  if (enb_ue_s1ap_id == 0 or enb_ue_s1ap_id > ues.size()) {
+    return nullptr;
+  }
+  return &ues[enb_ue_s1ap_id - 1];
+}
+
+bool attach_storm::connect_to_mme()
+{
+  if (not sock.open_socket(srsran::net_utils::addr_family::ipv4,
+                           srsran::net_utils::socket_type::seqpacket,
+                           srsran::net_utils::protocol_type::SCTP)) {
+    return false;
+  }
+  if (not sock.bind_addr(args.enb_addr.c_str(), 0)) {
+    srsran::console("Error binding SCTP socket to %s\n", args.enb_addr.c_str());
+    return false;
+  }
+  if (not sock.connect_to(args.mme_addr.c_str(), 36412)) {
+    srsran::console("Error connecting to MME at %s\n", args.mme_addr.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool attach_storm::send_s1ap(const s1ap_pdu_c& pdu, uint16_t stream)
+{
+  srsran::unique_byte_buffer_t buf = srsran::make_byte_buffer();
+  if (buf == nullptr) {
+    return false;
+  }
+  asn1::bit_ref bref(buf->msg, buf->get_tailroom());
+  if (pdu.pack(bref) != asn1::SRSASN_SUCCESS) {
+    srsran::console("Failed to pack S1AP PDU\n");
+    return false;
+  }
+  buf->N_bytes = bref.distance_bytes();
+
+  ssize_t n = sctp_sendmsg(sock.fd(), buf->msg, buf->N_bytes, nullptr, 0, htonl(S1AP_PPID), 0, stream, 0, 0);
+  if (n == -1) {
+    srsran::console("Failed to send S1AP PDU: %s\n", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool attach_storm::recv_s1ap(s1ap_pdu_c& pdu, int timeout_ms)
+{
+  struct pollfd pfd = {};
+  pfd.fd            = sock.fd();
+  pfd.events        = POLLIN;
+  if (poll(&pfd, 1, timeout_ms) <= 0) {
+    return false;
+  }
+
+  srsran::unique_byte_buffer_t buf = srsran::make_byte_buffer();
+  if (buf == nullptr) {
+    return false;
+  }
+  struct sctp_sndrcvinfo sri   = {};
+  int                    flags = 0;
+  int rd_sz = sctp_recvmsg(sock.fd(), buf->msg, buf->get_tailroom(), nullptr, nullptr, &sri, &flags);
+  if (rd_sz <= 0 or (flags & MSG_NOTIFICATION)) {
+    return false;
+  }
+  buf->N_bytes = rd_sz;
+
+  asn1::cbit_ref bref(buf->msg, buf->N_bytes);
+  return pdu.unpack(bref) == asn1::SRSASN_SUCCESS;
+}
+
+bool attach_storm::s1_setup()
+{
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_S1_SETUP);
+  s1_setup_request_s& container = pdu.init_msg().value.s1_setup_request();
+  container->global_enb_id.value.plm_nid.from_number(plmn);
+  container->global_enb_id.value.enb_id.set_macro_enb_id().from_number(args.enb_id);
+  container->enbname_present = true;
+  container->enbname.value.from_string("attach_storm");
+  container->supported_tas.value.resize(1);
+  container->supported_tas.value[0].tac.from_number(args.tac);
+  container->supported_tas.value[0].broadcast_plmns.resize(1);
+  container->supported_tas.value[0].broadcast_plmns[0].from_number(plmn);
+  container->default_paging_drx.value.value = paging_drx_opts::v128;
+  if (not send_s1ap(pdu, NONUE_STREAM)) {
+    return false;
+  }
+
+  s1ap_pdu_c rx_pdu;
+  if (not recv_s1ap(rx_pdu, 5000)) {
+    srsran::console("No S1 Setup Response received\n");
+    return false;
+  }
+  if (rx_pdu.type().value != s1ap_pdu_c::types_opts::successful_outcome or
+      rx_pdu.successful_outcome().value.type().value !=
+          s1ap_elem_procs_o::successful_outcome_c::types_opts::s1_setup_resp) {
+    srsran::console("S1 Setup rejected by the MME\n");
+    return false;
+  }
+  return true;
+}
+
+void attach_storm::start_attach(emulated_ue& ue)
+{
+  LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT attach_req = {};
+  attach_req.eps_attach_type                      = LIBLTE_MME_EPS_ATTACH_TYPE_EPS_ATTACH;
+  for (uint32_t i = 0; i < 4; i++) {
+    attach_req.ue_network_cap.eea[i] = true;
+    attach_req.ue_network_cap.eia[i] = true;
+  }
+  attach_req.eps_mobile_id.type_of_id = LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI;
+  attach_req.nas_ksi.tsc_flag         = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+  attach_req.nas_ksi.nas_ksi          = LIBLTE_MME_NAS_KEY_SET_IDENTIFIER_NO_KEY_AVAILABLE;
+  uint64_t imsi                       = ue.imsi;
+  for (int i = 14; i >= 0; i--) {
+    attach_req.eps_mobile_id.imsi[i] = imsi % 10;
+    imsi /= 10;
+  }
+
+  LIBLTE_MME_PDN_CONNECTIVITY_REQUEST_MSG_STRUCT pdn_con_req = {};
+  pdn_con_req.eps_bearer_id                                  = 0;
+  pdn_con_req.proc_transaction_id                            = PROC_TRANS_ID;
+  pdn_con_req.request_type                                   = LIBLTE_MME_REQUEST_TYPE_INITIAL_REQUEST;
+  pdn_con_req.pdn_type                                       = LIBLTE_MME_PDN_TYPE_IPV4;
+  liblte_mme_pack_pdn_connectivity_request_msg(&pdn_con_req, &attach_req.esm_msg);
+
+  srsran::unique_byte_buffer_t nas = srsran::make_byte_buffer();
+  if (nas == nullptr) {
+    finish(ue, false);
+    return;
+  }
+  liblte_mme_pack_attach_request_msg(&attach_req, (LIBLTE_BYTE_MSG_STRUCT*)nas.get());
+
+  ue.start = std::chrono::steady_clock::now();
+  ue.state = ue_state::wait_auth;
+  send_ul_nas(ue, nas.get(), true);
+}
+
+void attach_storm::send_ul_nas(emulated_ue& ue, byte_buffer_t* nas, bool initial)
+{
+  s1ap_pdu_c pdu;
+  if (initial) {
+    pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_INIT_UE_MSG);
+    init_ue_msg_s& container        = pdu.init_msg().value.init_ue_msg();
+    container->enb_ue_s1ap_id.value = ue.enb_ue_s1ap_id;
+    container->nas_pdu.value.resize(nas->N_bytes);
+    memcpy(container->nas_pdu.value.data(), nas->msg, nas->N_bytes);
+    container->tai.value.plm_nid.from_number(plmn);
+    container->tai.value.tac.from_number(args.tac);
+    container->eutran_cgi.value.plm_nid.from_number(plmn);
+    container->eutran_cgi.value.cell_id.from_number(args.enb_id << 8U);
+    container->rrc_establishment_cause.value.value = rrc_establishment_cause_opts::mo_sig;
+  } else {
+    pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_UL_NAS_TRANSPORT);
+    ul_nas_transport_s& container   = pdu.init_msg().value.ul_nas_transport();
+    container->mme_ue_s1ap_id.value = ue.mme_ue_s1ap_id;
+    container->enb_ue_s1ap_id.value = ue.enb_ue_s1ap_id;
+    container->nas_pdu.value.resize(nas->N_bytes);
+    memcpy(container->nas_pdu.value.data(), nas->msg, nas->N_bytes);
+    container->eutran_cgi.value.plm_nid.from_number(plmn);
+    container->eutran_cgi.value.cell_id.from_number(args.enb_id << 8U);
+    container->tai.value.plm_nid.from_number(plmn);
+    container->tai.value.tac.from_number(args.tac);
+  }
+  if (not send_s1ap(pdu, UE_STREAM)) {
+    finish(ue, false);
+  }
+}
+
+void attach_storm::protect_nas(emulated_ue& ue, uint32_t count, byte_buffer_t* nas)
+{
+  // Cipher the plain NAS message after the security header, then protect the sequence number and the message
+  byte_buffer_t tmp;
+  switch (ue.cipher_algo) {
+    case srsran::CIPHERING_ALGORITHM_ID_128_EEA1:
+      srsran::security_128_eea1(&ue.k_nas_enc[16],
+                                count,
+                                0,
+                                srsran::SECURITY_DIRECTION_UPLINK,
+                                &nas->msg[6],
+                                nas->N_bytes - 6,
+                                &tmp.msg[6]);
+      memcpy(&nas->msg[6], &tmp.msg[6], nas->N_bytes - 6);
+      break;
+    case srsran::CIPHERING_ALGORITHM_ID_128_EEA2:
+      srsran::security_128_eea2(&ue.k_nas_enc[16],
+                                count,
+                                0,
+                                srsran::SECURITY_DIRECTION_UPLINK,
+                                &nas->msg[6],
+                                nas->N_bytes - 6,
+                                &tmp.msg[6]);
+      memcpy(&nas->msg[6], &tmp.msg[6], nas->N_bytes - 6);
+      break;
+    case srsran::CIPHERING_ALGORITHM_ID_128_EEA3:
+      srsran::security_128_eea3(&ue.k_nas_enc[16],
+                                count,
+                                0,
+                                srsran::SECURITY_DIRECTION_UPLINK,
+                                &nas->msg[6],
+                                nas->N_bytes - 6,
+                                &tmp.msg[6]);
+      memcpy(&nas->msg[6], &tmp.msg[6], nas->N_bytes - 6);
+      break;
+    default:
+      break;
+  }
+
+  uint8_t* mac = &nas->msg[1];
+  switch (ue.integ_algo) {
+    case srsran::INTEGRITY_ALGORITHM_ID_128_EIA1:
+      srsran::security_128_eia1(
+          &ue.k_nas_int[16], count, 0, srsran::SECURITY_DIRECTION_UPLINK, &nas->msg[5], nas->N_bytes - 5, mac);
+      break;
+    case srsran::INTEGRITY_ALGORITHM_ID_128_EIA2:
+      srsran::security_128_eia2(
+          &ue.k_nas_int[16], count, 0, srsran::SECURITY_DIRECTION_UPLINK, &nas->msg[5], nas->N_bytes - 5, mac);
+      break;
+    case srsran::INTEGRITY_ALGORITHM_ID_128_EIA3:
+      srsran::security_128_eia3(
+          &ue.k_nas_int[16], count, 0, srsran::SECURITY_DIRECTION_UPLINK, &nas->msg[5], nas->N_bytes - 5, mac);
+      break;
+    default:
+      break;
+  }
+}
+
+void attach_storm::handle_auth_request(emulated_ue& ue, byte_buffer_t* nas)
+{
+  LIBLTE_MME_AUTHENTICATION_REQUEST_MSG_STRUCT auth_req = {};
+  if (liblte_mme_unpack_authentication_request_msg((LIBLTE_BYTE_MSG_STRUCT*)nas, &auth_req) != LIBLTE_SUCCESS) {
+    finish(ue, false);
+    return;
+  }
+
+  // The network is trusted, the AUTN is not verified
+  uint8_t res[16], ck[16], ik[16], ak[6], sqn_xor_ak[6];
+  if (args.use_xor) {
+    srsran::security_xor_f2345(key, auth_req.rand, res, ck, ik, ak);
+  } else {
+    srsran::security_milenage_f2345(key, opc, auth_req.rand, res, ck, ik, ak);
+  }
+  memcpy(sqn_xor_ak, auth_req.autn, 6);
+  srsran::security_generate_k_asme(ck, ik, sqn_xor_ak, mcc, mnc, ue.k_asme);
+
+  LIBLTE_MME_AUTHENTICATION_RESPONSE_MSG_STRUCT auth_resp = {};
+  memcpy(auth_resp.res, res, RES_LEN);
+  auth_resp.res_len = RES_LEN;
+  nas->clear();
+  liblte_mme_pack_authentication_response_msg(
+      &auth_resp, LIBLTE_MME_SECURITY_HDR_TYPE_PLAIN_NAS, 0, (LIBLTE_BYTE_MSG_STRUCT*)nas);
+
+  ue.state = ue_state::wait_smc;
+  send_ul_nas(ue, nas, false);
+}
+
+void attach_storm::handle_security_mode_command(emulated_ue& ue, byte_buffer_t* nas)
+{
+  LIBLTE_MME_SECURITY_MODE_COMMAND_MSG_STRUCT sec_mode_cmd = {};
+  if (liblte_mme_unpack_security_mode_command_msg((LIBLTE_BYTE_MSG_STRUCT*)nas, &sec_mode_cmd) != LIBLTE_SUCCESS) {
+    finish(ue, false);
+    return;
+  }
+  ue.cipher_algo = (srsran::CIPHERING_ALGORITHM_ID_ENUM)sec_mode_cmd.selected_nas_sec_algs.type_of_eea;
+  ue.integ_algo  = (srsran::INTEGRITY_ALGORITHM_ID_ENUM)sec_mode_cmd.selected_nas_sec_algs.type_of_eia;
+  srsran::security_generate_k_nas(ue.k_asme, ue.cipher_algo, ue.integ_algo, ue.k_nas_enc, ue.k_nas_int);
+
+  LIBLTE_MME_SECURITY_MODE_COMPLETE_MSG_STRUCT sec_mode_comp = {};
+  if (sec_mode_cmd.imeisv_req_present and sec_mode_cmd.imeisv_req == LIBLTE_MME_IMEISV_REQUESTED) {
+    sec_mode_comp.imeisv_present    = true;
+    sec_mode_comp.imeisv.type_of_id = LIBLTE_MME_MOBILE_ID_TYPE_IMEISV;
+    uint64_t imeisv                 = 3534900000000000ULL + ue.enb_ue_s1ap_id;
+    for (int i = 15; i >= 0; i--) {
+      sec_mode_comp.imeisv.imeisv[i] = imeisv % 10;
+      imeisv /= 10;
+    }
+  }
+
+  // Security Mode Complete is the first message with the new context, NAS count 0
+  nas->clear();
+  liblte_mme_pack_security_mode_complete_msg(&sec_mode_comp,
+                                             LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT,
+                                             0,
+                                             (LIBLTE_BYTE_MSG_STRUCT*)nas);
+  protect_nas(ue, 0, nas);
+
+  ue.state = ue_state::wait_ics;
+  send_ul_nas(ue, nas, false);
+}
+
+void attach_storm::handle_dl_nas(emulated_ue& ue, byte_buffer_t* nas)
+{
+  if (ue.state == ue_state::wait_emm_info) {
+    // Any downlink NAS message after the Attach Complete is the EMM Information
+    finish(ue, true);
+    return;
+  }
+
+  uint8_t pd, msg_type;
+  liblte_mme_parse_msg_header((LIBLTE_BYTE_MSG_STRUCT*)nas, &pd, &msg_type);
+  switch (msg_type) {
+    case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REQUEST:
+      handle_auth_request(ue, nas);
+      break;
+    case LIBLTE_MME_MSG_TYPE_SECURITY_MODE_COMMAND:
+      handle_security_mode_command(ue, nas);
+      break;
+    default:
+      srsran::console("IMSI %015" PRIu64 ": unexpected NAS message 0x%x\n", ue.imsi, msg_type);
+      finish(ue, false);
+      break;
+  }
+}
+
+void attach_storm::handle_init_ctxt_setup_request(emulated_ue& ue, const init_context_setup_request_s& req)
+{
+  if (req->erab_to_be_setup_list_ctxt_su_req.value.size() == 0) {
+    finish(ue, false);
+    return;
+  }
+  uint8_t erab_id = req->erab_to_be_setup_list_ctxt_su_req.value[0]->erab_to_be_setup_item_ctxt_su_req().erab_id;
+
+  // Initial Context Setup Response
+  s1ap_pdu_c pdu;
+  pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_INIT_CONTEXT_SETUP);
+  init_context_setup_resp_s& container = pdu.successful_outcome().value.init_context_setup_resp();
+  container->mme_ue_s1ap_id.value      = ue.mme_ue_s1ap_id;
+  container->enb_ue_s1ap_id.value      = ue.enb_ue_s1ap_id;
+  container->erab_setup_list_ctxt_su_res.value.resize(1);
+  container->erab_setup_list_ctxt_su_res.value[0].load_info_obj(ASN1_S1AP_ID_ERAB_SETUP_ITEM_CTXT_SU_RES);
+  erab_setup_item_ctxt_su_res_s& item = container->erab_setup_list_ctxt_su_res.value[0]->erab_setup_item_ctxt_su_res();
+  item.erab_id                        = erab_id;
+  item.transport_layer_address.resize(32);
+  uint8_t addr[4] = {};
+  inet_pton(AF_INET, args.enb_addr.c_str(), addr);
+  for (uint32_t j = 0; j < 4; ++j) {
+    item.transport_layer_address.data()[j] = addr[3 - j];
+  }
+  item.gtp_teid.from_number(ENB_GTPU_TEID0 + ue.enb_ue_s1ap_id);
+  if (not send_s1ap(pdu, UE_STREAM)) {
+    finish(ue, false);
+    return;
+  }
+
+  // Attach Complete with the Activate Default EPS Bearer Context Accept, NAS count 1
+  LIBLTE_MME_ATTACH_COMPLETE_MSG_STRUCT                            attach_comp = {};
+  LIBLTE_MME_ACTIVATE_DEFAULT_EPS_BEARER_CONTEXT_ACCEPT_MSG_STRUCT act_accept  = {};
+  act_accept.eps_bearer_id                                                     = erab_id;
+  act_accept.proc_transaction_id                                               = PROC_TRANS_ID;
+  liblte_mme_pack_activate_default_eps_bearer_context_accept_msg(&act_accept, &attach_comp.esm_msg);
+
+  srsran::unique_byte_buffer_t nas = srsran::make_byte_buffer();
+  if (nas == nullptr) {
+    finish(ue, false);
+    return;
+  }
+  liblte_mme_pack_attach_complete_msg(
+      &attach_comp, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED, 1, (LIBLTE_BYTE_MSG_STRUCT*)nas.get());
+  protect_nas(ue, 1, nas.get());
+
+  ue.state = ue_state::wait_emm_info;
+  send_ul_nas(ue, nas.get(), false);
+}
+
+void attach_storm::handle_ue_ctxt_release_command(const ue_context_release_cmd_s& cmd)
+{
+  const ue_s1ap_ids_c& ids = cmd->ue_s1ap_ids.value;
+  if (ids.type().value != ue_s1ap_ids_c::types_opts::ue_s1ap_id_pair) {
+    return;
+  }
+  emulated_ue* ue = find_ue(ids.ue_s1ap_id_pair().enb_ue_s1ap_id);
+  if (ue == nullptr) {
+    return;
+  }
+
+  s1ap_pdu_c pdu;
+  pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_UE_CONTEXT_RELEASE);
+  ue_context_release_complete_s& container = pdu.successful_outcome().value.ue_context_release_complete();
+  container->mme_ue_s1ap_id.value          = ids.ue_s1ap_id_pair().mme_ue_s1ap_id;
+  container->enb_ue_s1ap_id.value          = ids.ue_s1ap_id_pair().enb_ue_s1ap_id;
+  send_s1ap(pdu, UE_STREAM);
+
+  if (ue->state != ue_state::attached and ue->state != ue_state::failed) {
+    finish(*ue, false);
+  }
+}
+
+void attach_storm::handle_rx_pdu(const s1ap_pdu_c& pdu)
+{
+  using init_msg_types = s1ap_elem_procs_o::init_msg_c::types_opts;
+
+  if (pdu.type().value != s1ap_pdu_c::types_opts::init_msg) {
+    return;
+  }
+  const init_msg_s& msg = pdu.init_msg();
+  switch (msg.value.type().value) {
+    case init_msg_types::dl_nas_transport: {
+      const dl_nas_transport_s& dl_nas = msg.value.dl_nas_transport();
+      emulated_ue*              ue     = find_ue(dl_nas->enb_ue_s1ap_id.value.value);
+      if (ue == nullptr or ue->state == ue_state::attached or ue->state == ue_state::failed) {
+        return;
+      }
+      srsran::unique_byte_buffer_t nas = srsran::make_byte_buffer();
+      if (nas == nullptr or dl_nas->nas_pdu.value.size() > nas->get_tailroom()) {
+        finish(*ue, false);
+        return;
+      }
+      ue->mme_ue_s1ap_id = dl_nas->mme_ue_s1ap_id.value.value;
+      memcpy(nas->msg, dl_nas->nas_pdu.value.data(), dl_nas->nas_pdu.value.size());
+      nas->N_bytes = dl_nas->nas_pdu.value.size();
+      handle_dl_nas(*ue, nas.get());
+      break;
+    }
+    case init_msg_types::init_context_setup_request: {
+      const init_context_setup_request_s& req = msg.value.init_context_setup_request();
+      emulated_ue*                        ue  = find_ue(req->enb_ue_s1ap_id.value.value);
+      if (ue != nullptr and ue->state == ue_state::wait_ics) {
+        handle_init_ctxt_setup_request(*ue, req);
+      }
+      break;
+    }
+    case init_msg_types::ue_context_release_cmd:
+      handle_ue_ctxt_release_command(msg.value.ue_context_release_cmd());
+      break;
+    default:
+      break;
+  }
+}
+
+void attach_storm::finish(emulated_ue& ue, bool success)
+{
+  if (success) {
+    std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - ue.start;
+    latencies_ms.push_back(latency.count());
+    ue.state = ue_state::attached;
+  } else {
+    nof_failed++;
+    ue.state = ue_state::failed;
+  }
+}
+
+int attach_storm::run()
+{
+  if (not srsran::string_to_mcc(args.mcc, &mcc) or not srsran::string_to_mnc(args.mnc, &mnc)) {
+    srsran::console("Invalid MCC/MNC\n");
+    return SRSRAN_ERROR;
+  }
+  srsran::s1ap_mccmnc_to_plmn(mcc, mnc, &plmn);
+  srsran::get_uint_vec_from_hex_str(args.key, key, 16);
+  srsran::get_uint_vec_from_hex_str(args.opc, opc, 16);
+
+  if (not connect_to_mme() or not s1_setup()) {
+    return SRSRAN_ERROR;
+  }
+  srsran::console("S1 Setup complete. Attaching %d UEs, %d in flight\n", args.nof_ues, args.window);
+
+  ues.resize(args.nof_ues);
+  for (uint32_t i = 0; i < args.nof_ues; ++i) {
+    ues[i].imsi           = args.first_imsi + i;
+    ues[i].enb_ue_s1ap_id = i + 1;
+  }
+
+  auto     tp      = std::chrono::steady_clock::now();
+  uint32_t next_ue = 0;
+  while (latencies_ms.size() + nof_failed < args.nof_ues) {
+    // Keep the window of attach procedures full
+    in_flight.erase(std::remove_if(in_flight.begin(),
+                                   in_flight.end(),
+                                   [this](uint32_t idx) {
+                                     return ues[idx].state == ue_state::attached or
+                                            ues[idx].state == ue_state::failed;
+                                   }),
+                    in_flight.end());
+    while (in_flight.size() < args.window and next_ue < args.nof_ues) {
+      in_flight.push_back(next_ue);
+      start_attach(ues[next_ue++]);
+    }
+
+    s1ap_pdu_c pdu;
+    if (recv_s1ap(pdu, 100)) {
+      handle_rx_pdu(pdu);
+    }
+
+    // Expire stuck procedures
+    auto now = std::chrono::steady_clock::now();
+    for (uint32_t idx : in_flight) {
+      emulated_ue& ue = ues[idx];
+      if (ue.state != ue_state::attached and ue.state != ue_state::failed and
+          now - ue.start > std::chrono::milliseconds(args.timeout_ms)) {
+        srsran::console("IMSI %015" PRIu64 ": attach timed out\n", ue.imsi);
+        finish(ue, false);
+      }
+    }
+  }
+  elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - tp).count();
+  return nof_failed == 0 ? SRSRAN_SUCCESS : SRSRAN_ERROR;
+}
+
+void attach_storm::print_report()
+{
+  std::sort(latencies_ms.begin(), latencies_ms.end());
+  double p50 = latencies_ms.empty() ? 0 : latencies_ms[latencies_ms.size() / 2];
+  double p99 = latencies_ms.empty() ? 0 : latencies_ms[(latencies_ms.size() * 99) / 100];
+  printf("Attached %zd/%d UEs in %.2f s: %.1f attaches/s, %d failed, latency p50 %.1f ms, p99 %.1f ms\n",
+         latencies_ms.size(),
+         args.nof_ues,
+         elapsed_s,
+         elapsed_s > 0 ? latencies_ms.size() / elapsed_s : 0,
+         nof_failed,
+         p50,
+         p99);
+}
+
+/// Writes an HSS user database with the emulated subscribers. Static IPs are used since the SPGW pool is small.
+int write_user_db(const storm_args& args)
+{
+  std::ofstream db(args.user_db_out);
+  if (not db.is_open()) {
+    srsran::console("Could not open %s\n", args.user_db_out.c_str());
+    return SRSRAN_ERROR;
+  }
+  db << "# Generated by attach_storm\n";
+  for (uint32_t i = 0; i < args.nof_ues; ++i) {
+    char line[256];
+    snprintf(line,
+             sizeof(line),
+             "storm%d,%s,%015" PRIu64 ",%s,opc,%s,8000,000000001234,7,172.17.%d.%d\n",
+             i,
+             args.use_xor ? "xor" : "mil",
+             args.first_imsi + i,
+             args.key.c_str(),
+             args.opc.c_str(),
+             (i / 250) % 256,
+             i % 250 + 2);
+    db << line;
+  }
+  printf("Wrote %d subscribers to %s\n", args.nof_ues, args.user_db_out.c_str());
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace
+
+void usage(char* prog)
+{
+  storm_args def;
+  printf("Usage: %s [amblnwtikoxcgu]\n", prog);
+  printf("\t-a MME S1-MME address [Default %s]\n", def.mme_addr.c_str());
+  printf("\t-b eNB S1-MME and GTP-U address [Default %s]\n", def.enb_addr.c_str());
+  printf("\t-m MCC [Default %s]\n", def.mcc.c_str());
+  printf("\t-l MNC [Default %s]\n", def.mnc.c_str());
+  printf("\t-g TAC [Default %d]\n", def.tac);
+  printf("\t-n Number of UEs [Default %d]\n", def.nof_ues);
+  printf("\t-w Number of attach procedures in flight [Default %d]\n", def.window);
+  printf("\t-t Attach timeout in ms [Default %d]\n", def.timeout_ms);
+  printf("\t-i First IMSI [Default %015" PRIu64 "]\n", def.first_imsi);
+  printf("\t-k Subscriber key [Default %s]\n", def.key.c_str());
+  printf("\t-o Subscriber OPc [Default %s]\n", def.opc.c_str());
+  printf("\t-x Use XOR authentication instead of Milenage\n");
+  printf("\t-u Write the HSS user database for the emulated UEs to the given file and exit\n");
+}
+
+int main(int argc, char** argv)
+{
+  storm_args args;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "abmlgnwtikoxuh")) != -1) {
+    switch (opt) {
+      case 'a':
+        args.mme_addr = argv[optind];
+        break;
+      case 'b':
+        args.enb_addr = argv[optind];
+        break;
+      case 'm':
+        args.mcc = argv[optind];
+        break;
+      case 'l':
+        args.mnc = argv[optind];
+        break;
+      case 'g':
+        args.tac = (uint16_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'n':
+        args.nof_ues = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'w':
+        args.window = std::max((uint32_t)strtol(argv[optind], nullptr, 10), 1U);
+        break;
+      case 't':
+        args.timeout_ms = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'i':
+        args.first_imsi = strtoull(argv[optind], nullptr, 10);
+        break;
+      case 'k':
+        args.key = argv[optind];
+        break;
+      case 'o':
+        args.opc = argv[optind];
+        break;
+      case 'x':
+        args.use_xor = true;
+        break;
+      case 'u':
+        args.user_db_out = argv[optind];
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+
+  if (not args.user_db_out.empty()) {
+    return write_user_db(args);
+  }
+
+  srslog::init();
+
+  attach_storm storm(args);
+  int          ret = storm.run();
+  storm.print_report();
+  return ret;
+}
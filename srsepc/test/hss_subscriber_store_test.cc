@@ -0,0 +1,235 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/hss/hss_subscriber_store.h"
+#include "srsran/config.h"
+#include "srsran/support/srsran_test.h"
+#include <arpa/inet.h>
+#include <cstddef>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace srsepc;
+
+static const uint64_t        first_imsi = 1010000000001ULL;
+static const hss_csv_stamp_t csv_stamp  = {1234, 5678};
+
+static std::vector<hss_ue_ctx_t> make_subscribers(uint32_t nof_ues)
+{
+  std::vector<hss_ue_ctx_t> subscribers(nof_ues);
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    hss_ue_ctx_t& ue = subscribers[i];
+    ue               = {};
+    ue.set_name("ue" + std::to_string(i));
+    ue.imsi   = first_imsi + i;
+    ue.algo   = HSS_ALGO_MILENAGE;
+    ue.qci    = 7;
+    ue.sqn[5] = 0x20;
+    if (i % 100 == 0) {
+      ue.static_ip_addr = htonl(0xac100002 + i);
+    }
+  }
+  return subscribers;
+}
+
+static std::string store_path()
+{
+  static char dir[] = "/tmp/hss_store_testXXXXXX";
+  static bool init  = false;
+  if (not init) {
+    TESTASSERT(mkdtemp(dir) != nullptr);
+    init = true;
+  }
+  return std::string(dir) + "/user_db.csv.store";
+}
+
+int test_create_and_find()
+{
+  uint32_t                  nof_ues     = 10000;
+  std::vector<hss_ue_ctx_t> subscribers = make_subscribers(nof_ues);
+
+  hss_subscriber_store store;
+  TESTASSERT(store.create(store_path(), csv_stamp, subscribers, false));
+  TESTASSERT(store.size() == nof_ues);
+  TESTASSERT(store.get_static_ip_records().size() == nof_ues / 100);
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    hss_ue_ctx_t* ue = store.find(first_imsi + i);
+    TESTASSERT(ue != nullptr);
+    TESTASSERT(ue->imsi == first_imsi + i);
+    TESTASSERT(std::string(ue->name) == "ue" + std::to_string(i));
+  }
+  TESTASSERT(store.find(first_imsi - 1) == nullptr);
+  TESTASSERT(store.find(first_imsi + nof_ues) == nullptr);
+  store.close();
+
+  // The store is reused only if the user database did not change
+  TESTASSERT(not store.open(store_path(), {1234, 0}, false));
+  TESTASSERT(store.open(store_path(), csv_stamp, false));
+  TESTASSERT(store.size() == nof_ues);
+  TESTASSERT(store.get_static_ip_records().size() == nof_ues / 100);
+  TESTASSERT(store.find(first_imsi + nof_ues / 2) != nullptr);
+
+  // Duplicated IMSIs are rejected
+  subscribers.push_back(subscribers[3]);
+  TESTASSERT(not store.create(store_path() + ".dup", csv_stamp, subscribers, false));
+
+  // Records can be kept in memory only
+  TESTASSERT(store.create("", csv_stamp, make_subscribers(10), false));
+  TESTASSERT(store.find(first_imsi + 9) != nullptr);
+  store.write_back(store.find(first_imsi + 9));
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_invalid_store()
+{
+  // 8 records hashed into 16 buckets. The store header is 64 bytes long: nof_records is its 4th field and the sections
+  // that follow it are aligned to 64 bytes.
+  uint32_t nof_ues = 8, nof_buckets = 16;
+  {
+    hss_subscriber_store store;
+    TESTASSERT(store.create(store_path(), csv_stamp, make_subscribers(nof_ues), false));
+  }
+  off_t bucket_offset = 64 + ((nof_ues * sizeof(hss_ue_ctx_t) + 63) & ~63UL);
+
+  // A bucket table with more used buckets than records leaves no empty bucket to end the probing
+  int fd = open(store_path().c_str(), O_RDWR);
+  TESTASSERT(fd >= 0);
+  for (uint32_t i = 0; i < nof_buckets; ++i) {
+    uint32_t idx = 1;
+    TESTASSERT(pwrite(fd, &idx, sizeof(idx), bucket_offset + i * sizeof(idx)) == sizeof(idx));
+  }
+  close(fd);
+  hss_subscriber_store store;
+  TESTASSERT(not store.open(store_path(), csv_stamp, false));
+
+  // A header whose load factor exceeds 0.5 is rejected, even if the file size and the bucket table match it
+  {
+    hss_subscriber_store rebuilt;
+    TESTASSERT(rebuilt.create(store_path(), csv_stamp, make_subscribers(nof_ues), false));
+  }
+  uint32_t bad_nof_records = nof_buckets / 2 + 1;
+  size_t   bad_size        = 64 + ((bad_nof_records * sizeof(hss_ue_ctx_t) + 63) & ~63UL) +
+                    ((nof_buckets * sizeof(uint32_t) + 63) & ~63UL) + sizeof(uint32_t);
+  fd = open(store_path().c_str(), O_RDWR);
+  TESTASSERT(fd >= 0);
+  TESTASSERT(pwrite(fd, &bad_nof_records, sizeof(bad_nof_records), 3 * sizeof(uint32_t)) == sizeof(uint32_t));
+  TESTASSERT(ftruncate(fd, bad_size) == 0);
+  bucket_offset = 64 + ((bad_nof_records * sizeof(hss_ue_ctx_t) + 63) & ~63UL);
+  for (uint32_t i = 0; i < nof_buckets; ++i) {
+    uint32_t idx = i < bad_nof_records ? i + 1 : 0;
+    TESTASSERT(pwrite(fd, &idx, sizeof(idx), bucket_offset + i * sizeof(idx)) == sizeof(idx));
+  }
+  close(fd);
+  TESTASSERT(not store.open(store_path(), csv_stamp, false));
+
+  // The store is rebuilt from the user database
+  TESTASSERT(store.create(store_path(), csv_stamp, make_subscribers(nof_ues), false));
+  TESTASSERT(store.find(first_imsi + nof_ues - 1) != nullptr);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_journal_replay()
+{
+  uint32_t nof_ues = 1000;
+  {
+    hss_subscriber_store store;
+    TESTASSERT(store.create(store_path(), csv_stamp, make_subscribers(nof_ues), false));
+  }
+
+  // A child process updates some SQNs and dies without syncing the store
+  pid_t pid = fork();
+  if (pid == 0) {
+    hss_subscriber_store* store = new hss_subscriber_store;
+    if (not store->open(store_path(), csv_stamp, false)) {
+      _exit(1);
+    }
+    for (uint32_t i = 0; i < nof_ues; i += 10) {
+      hss_ue_ctx_t* ue = store->find(first_imsi + i);
+      ue->sqn[5]       = 0x40;
+      ue->last_rand[0] = i & 0xff;
+      store->write_back(ue);
+    }
+    _exit(0);
+  }
+  int status = 0;
+  TESTASSERT(waitpid(pid, &status, 0) == pid);
+  TESTASSERT(WIFEXITED(status) and WEXITSTATUS(status) == 0);
+
+  // Revert the updated SQNs in the records, as if their pages had not reached the disk. The records follow the 64 byte
+  // store header.
+  int fd = open(store_path().c_str(), O_WRONLY);
+  TESTASSERT(fd >= 0);
+  for (uint32_t i = 0; i < nof_ues; i += 10) {
+    uint8_t old_sqn = 0x20;
+    off_t   offset  = 64 + i * sizeof(hss_ue_ctx_t) + offsetof(hss_ue_ctx_t, sqn) + 5;
+    TESTASSERT(pwrite(fd, &old_sqn, 1, offset) == 1);
+  }
+  close(fd);
+
+  // Leave a torn entry at the end of the journal
+  fd = open((store_path() + ".journal").c_str(), O_WRONLY | O_APPEND);
+  TESTASSERT(fd >= 0);
+  uint8_t garbage[17] = {0xff};
+  TESTASSERT(write(fd, garbage, sizeof(garbage)) == sizeof(garbage));
+  close(fd);
+
+  hss_subscriber_store store;
+  TESTASSERT(store.open(store_path(), csv_stamp, false));
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    hss_ue_ctx_t* ue = store.find(first_imsi + i);
+    TESTASSERT(ue != nullptr);
+    TESTASSERT(ue->sqn[5] == (i % 10 == 0 ? 0x40 : 0x20));
+    if (i % 10 == 0) {
+      TESTASSERT(ue->last_rand[0] == (i & 0xff));
+    }
+  }
+
+  // Rebuilding the store from a new user database keeps the most recent SQNs
+  std::vector<hss_ue_ctx_t> subscribers = make_subscribers(nof_ues + 1);
+  subscribers[20].sqn[5]                = 0x60;
+  TESTASSERT(store.create(store_path(), {4321, 8765}, subscribers, false));
+  TESTASSERT(store.find(first_imsi)->sqn[5] == 0x40);
+  TESTASSERT(store.find(first_imsi + 1)->sqn[5] == 0x20);
+  TESTASSERT(store.find(first_imsi + 20)->sqn[5] == 0x60);
+  TESTASSERT(store.find(first_imsi + nof_ues)->sqn[5] == 0x20);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  srslog::init();
+
+  TESTASSERT(test_create_and_find() == SRSRAN_SUCCESS);
+  TESTASSERT(test_invalid_store() == SRSRAN_SUCCESS);
+  TESTASSERT(test_journal_replay() == SRSRAN_SUCCESS);
+
+  std::string dir = store_path().substr(0, store_path().rfind('/'));
+  unlink(store_path().c_str());
+  unlink((store_path() + ".journal").c_str());
+  rmdir(dir.c_str());
+
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -113,8 +113,11 @@ int gnb_stack_nr::init(const gnb_stack_args_t& args_,
     pdcp.init(&rlc, &rrc, gtpu_adapter.get());
 
     if (args.ngap_pcap.enable) {
-      ngap_pcap.open(args.ngap_pcap.filename.c_str());
-      ngap->start_pcap(&ngap_pcap);
+      if (ngap_pcap.open(args.ngap_pcap.filename.c_str()) == SRSRAN_SUCCESS) {
+        ngap->start_pcap(&ngap_pcap);
+      } else {
+        stack_logger.error("Couldn't open %s to write NGAP PCAP", args.ngap_pcap.filename.c_str());
+      }
     }
 
     ngap->init(args.ngap, &rrc, gtpu.get());
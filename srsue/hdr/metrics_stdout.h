@@ -44,6 +44,7 @@ public:
   void toggle_print(bool b);
   void set_metrics(const ue_metrics_t& m, const uint32_t period_usec);
   void set_ue_handle(ue_metrics_interface* ue_);
+  void set_label(const std::string& label_);
   void stop(){};
 
 private:
@@ -58,11 +59,13 @@ private:
   std::string       float_to_string(float f, int digits);
   std::string       float_to_eng_string(float f, int digits);
   void              print_table(const bool display_neighbours, const bool is_nr);
+  void              print_label(bool blank);
 
   std::atomic<bool>     do_print             = {false};
   bool                  table_has_neighbours = false; ///< state of last table head
   uint8_t               n_reports            = 10;
   ue_metrics_interface* ue                   = nullptr;
+  std::string           label; ///< Printed at the beginning of every line, it tells apart the UEs of a swarm
   std::mutex            mutex;
 };
 
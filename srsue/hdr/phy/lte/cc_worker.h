@@ -42,6 +42,7 @@ public:
 
   void  set_tti(uint32_t tti);
   void  set_cfo_nolock(float cfo);
+  void  set_rx_cfo_nolock(float cfo, float phase, float time_offset);
   float get_ref_cfo() const;
 
   // Functions to set configuration.
@@ -54,6 +54,7 @@ public:
   void     set_context(const srsran::phy_common_interface::worker_context_t& w_ctx);
   void     set_prach(cf_t* prach_ptr, float prach_power);
   void     set_cfo_nolock(const uint32_t& cc_idx, float cfo);
+  void     set_rx_cfo_nolock(const uint32_t& cc_idx, float cfo, float phase, float time_offset);
 
   void set_tdd_config_nolock(srsran_tdd_config_t config);
   void set_config_nolock(uint32_t cc_idx, const srsran::phy_cfg_t& phy_cfg);
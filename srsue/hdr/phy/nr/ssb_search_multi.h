@@ -0,0 +1,85 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSUE_SSB_SEARCH_MULTI_H
+#define SRSUE_SSB_SEARCH_MULTI_H
+
+#include "srsran/common/thread_pool.h"
+#include "srsran/srslog/srslog.h"
+#include "srsran/srsran.h"
+#include <memory>
+#include <vector>
+
+namespace srsue {
+namespace nr {
+
+/// Searches NR SSB in several sync raster frequencies of a single wideband capture. Every SSB frequency is handed to
+/// a pool of workers, each of them owning an SSB object that correlates the three PSS at once and reports all the
+/// cells and beams found, not only the strongest one.
+class ssb_search_multi
+{
+public:
+  struct args_t {
+    uint32_t                    nof_workers = 1;
+    double                      max_srate_hz = SRSRAN_SSB_DEFAULT_MAX_SRATE_HZ;
+    srsran_subcarrier_spacing_t ssb_min_scs = srsran_subcarrier_spacing_15kHz;
+  };
+
+  /// Describes the capture, common to all the SSB frequencies
+  struct cfg_t {
+    double                      srate_hz;
+    double                      center_freq_hz;
+    srsran_subcarrier_spacing_t ssb_scs;
+    srsran_ssb_pattern_t        ssb_pattern;
+    srsran_duplex_mode_t        duplex_mode;
+  };
+
+  /// SSB decoded in one of the searched frequencies
+  struct result_t {
+    double                  ssb_freq_hz;
+    srsran_ssb_search_res_t ssb_res;
+  };
+
+  ssb_search_multi(srslog::basic_logger& logger, const args_t& args);
+  ~ssb_search_multi();
+
+  /// Searches every SSB frequency in nof_samples of baseband. Returns all the decoded SSB, strongest RSRP first
+  std::vector<result_t> run(const cfg_t&               cfg,
+                            const std::vector<double>& ssb_freqs_hz,
+                            const cf_t*                samples,
+                            uint32_t                   nof_samples);
+
+  /// Returns the sync raster frequencies of the band whose SSB falls entirely within the captured bandwidth
+  static std::vector<double> get_ssb_freqs(uint16_t band, const cfg_t& cfg);
+
+private:
+  class worker;
+
+  srslog::basic_logger&                logger;
+  args_t                               args;
+  srsran::task_thread_pool             pool;
+  std::vector<std::unique_ptr<worker>> workers;
+};
+
+} // namespace nr
+} // namespace srsue
+
+#endif // SRSUE_SSB_SEARCH_MULTI_H
@@ -75,14 +75,15 @@ private:
 struct ch_metrics_t {
   typedef std::array<ch_metrics_t, SRSRAN_MAX_CARRIERS> array_t;
 
-  float n        = 0.0;
-  float sinr     = 0.0;
-  float rsrp     = 0.0;
-  float rsrq     = 0.0;
-  float rssi     = 0.0;
-  float ri       = 0.0;
-  float pathloss = 0.0;
-  float sync_err = 0.0;
+  float n           = 0.0;
+  float sinr        = 0.0;
+  float rsrp        = 0.0;
+  float rsrq        = 0.0;
+  float rssi        = 0.0;
+  float ri          = 0.0;
+  float pathloss    = 0.0;
+  float sync_err    = 0.0;
+  float chest_reuse = 0.0;
 
   void set(const ch_metrics_t& other)
   {
@@ -98,19 +99,21 @@ struct ch_metrics_t {
     PHY_METRICS_SET(ri);
     PHY_METRICS_SET(pathloss);
     PHY_METRICS_SET(sync_err);
+    PHY_METRICS_SET(chest_reuse);
   }
 
   void reset()
   {
-    count    = 0;
-    n        = 0.0;
-    sinr     = 0.0;
-    rsrp     = 0.0;
-    rsrq     = 0.0;
-    rssi     = 0.0;
-    ri       = 0.0;
-    pathloss = 0.0;
-    sync_err = 0.0;
+    count       = 0;
+    n           = 0.0;
+    sinr        = 0.0;
+    rsrp        = 0.0;
+    rsrq        = 0.0;
+    rssi        = 0.0;
+    ri          = 0.0;
+    pathloss    = 0.0;
+    sync_err    = 0.0;
+    chest_reuse = 0.0;
   }
 
 private:
@@ -23,6 +23,7 @@
 
 #include "intra_measure_base.h"
 #include "scell_recv.h"
+#include <map>
 #include <srsran/srsran.h>
 
 namespace srsue {
@@ -65,6 +66,12 @@ public:
    */
   uint32_t get_earfcn() const override { return current_earfcn; };
 
+  /**
+   * @brief Get the average measurement cycle time for each number of measured cells
+   * @return Map of average cycle time in microseconds, indexed by the number of cells measured in the cycle
+   */
+  std::map<uint32_t, uint32_t> get_cycle_time_us();
+
 private:
   /**
    * @brief Provides with the RAT to the base class
@@ -86,6 +93,9 @@ private:
   std::atomic<uint32_t> current_earfcn = {0}; ///< Current EARFCN
   std::mutex            mutex;
 
+  /// Performance, accumulated cycle time and number of cycles for each number of measured cells
+  std::map<uint32_t, std::pair<uint64_t, uint32_t>> cycle_time_us;
+
   /// LTE-based measuring objects
   scell_recv                 scell_rx;               ///< Secondary cell searcher
   srsran_refsignal_dl_sync_t refsignal_dl_sync = {}; ///< Reference signal based measurement
@@ -23,6 +23,7 @@
 #define SRSUE_SCELL_RECV_H
 
 #include "srsue/hdr/phy/phy_common.h"
+#include <array>
 #include <set>
 #include <srsran/srsran.h>
 
@@ -52,11 +53,10 @@ public:
                   std::set<uint32_t>&  found_cell_ids);
 
 private:
-  cf_t*                 sf_buffer[SRSRAN_MAX_PORTS] = {};
-  srslog::basic_logger& logger;
-  srsran_sync_t         sync_find = {};
+  srslog::basic_logger&  logger;
+  srsran_pss_sss_batch_t pss_sss_find = {};
 
-  uint32_t current_fft_sz;
+  uint32_t current_fft_sz = 0;
 };
 
 } // namespace scell
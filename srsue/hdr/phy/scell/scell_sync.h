@@ -73,13 +73,15 @@ private:
    * @param tti
    * @param buffer
    */
-  void run_state_search_pss(uint32_t tti, cf_t* buffer)
+  void run_state_search_pss(uint32_t tti, cf_t* buffer, float cfo, float cfo_phase)
   {
     uint32_t peak_pos = 0;
 
-    // Append new base-band
+    // Append new base-band, correcting the CFO left by the primary serving cell synchronization if any
     if (buffer == nullptr) {
       srsran_vec_cf_zero(&temp[sf_len], sf_len);
+    } else if (std::isnormal(cfo)) {
+      srsran_vec_apply_cfo_phase(buffer, cfo, cfo_phase, &temp[sf_len], sf_len);
     } else {
       srsran_vec_cf_copy(&temp[sf_len], buffer, sf_len);
     }
@@ -113,7 +115,7 @@ private:
 
     // If the state has not changed, copy new data into the temp buffer
     if (state == STATE_SEARCH_PSS) {
-      srsran_vec_cf_copy(&temp[0], buffer, sf_len);
+      srsran_vec_cf_copy(&temp[0], &temp[sf_len], sf_len);
     }
   }
 
@@ -219,8 +221,10 @@ public:
    * basis (1 ms).
    * @param tti Current primary serving cell time
    * @param buffer Base-band buffer of the given secondary serving cell
+   * @param cfo Frequency offset left uncorrected in the buffer, normalised by the sampling rate
+   * @param cfo_phase Phase of the frequency offset correction for the first sample
    */
-  void run(uint32_t tti, cf_t* buffer)
+  void run(uint32_t tti, cf_t* buffer, float cfo = 0.0f, float cfo_phase = 0.0f)
   {
     // Try to get lock. The lock is unsuccessful if the DSP objects are getting configured. In this case, ignore
     // the subframe.
@@ -233,7 +237,7 @@ public:
         // Do nothing
         break;
       case STATE_SEARCH_PSS:
-        run_state_search_pss(tti, buffer);
+        run_state_search_pss(tti, buffer, cfo, cfo_phase);
         break;
       case STATE_IN_SYNCH:
         // Do nothing
@@ -0,0 +1,91 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSUE_SEARCH_MULTI_H
+#define SRSUE_SEARCH_MULTI_H
+
+#include "srsran/common/thread_pool.h"
+#include "srsran/srslog/srslog.h"
+#include "srsran/srsran.h"
+#include <memory>
+#include <vector>
+
+namespace srsue {
+
+/// Baseband samples of one EARFCN sampled at SRSRAN_CS_SAMP_FREQ, as read from a file/ZMQ source or extracted from a
+/// wideband capture with search_multi::channelise()
+struct search_multi_source_t {
+  uint32_t    earfcn;
+  const cf_t* samples;
+  uint32_t    nof_samples;
+};
+
+/// Cell found by search_multi, with its MIB decoded
+struct search_multi_cell_t {
+  uint32_t      earfcn;
+  srsran_cell_t cell;
+  float         rsrp_dB; ///< RSRP relative to full scale, measured in the subframe where the MIB was decoded
+  float         psr;
+  float         cfo_hz;
+};
+
+struct search_multi_args_t {
+  uint32_t nof_workers      = 1;
+  uint32_t max_frames_pss   = 8;   ///< Maximum number of 5 ms frames scanned per PSS
+  uint32_t nof_valid_frames = 4;   ///< Number of frames the PSS must be detected in
+  uint32_t max_frames_mib   = 40;  ///< Maximum number of subframes 0 tried for decoding the MIB
+  float    min_psr          = 2.0; ///< PSS peak to side-lobe ratio below which a detection is ignored
+};
+
+/// Searches LTE cells in several EARFCNs at once. Unlike srsue::search, which retunes the radio and runs one frequency
+/// after the other, the samples of every EARFCN are already available and the EARFCNs are processed concurrently by a
+/// pool of workers. Each worker keeps its own cell search and MIB decoder objects, so the PSS/SSS sequences and their
+/// correlation FFT plans are built once per worker and shared by all the EARFCNs it processes.
+class search_multi
+{
+public:
+  search_multi(srslog::basic_logger& logger, const search_multi_args_t& args);
+  ~search_multi();
+
+  /// Returns all the cells found in the given sources, strongest RSRP first
+  std::vector<search_multi_cell_t> run(const std::vector<search_multi_source_t>& sources);
+
+  /// Extracts the central 1.4 MHz of an EARFCN from a capture of nof_samples at srate_hz centered at center_freq_hz.
+  /// The capture sampling rate must be a multiple of SRSRAN_CS_SAMP_FREQ.
+  static int channelise(const cf_t*        samples,
+                        uint32_t           nof_samples,
+                        double             srate_hz,
+                        double             center_freq_hz,
+                        uint32_t           earfcn,
+                        std::vector<cf_t>& output);
+
+private:
+  class worker;
+
+  srslog::basic_logger&                logger;
+  search_multi_args_t                  args;
+  srsran::task_thread_pool             pool;
+  std::vector<std::unique_ptr<worker>> workers;
+};
+
+} // namespace srsue
+
+#endif // SRSUE_SEARCH_MULTI_H
@@ -35,6 +35,7 @@
 #include "phy/ue_phy_base.h"
 #include "srsran/common/buffer_pool.h"
 #include "srsran/radio/radio.h"
+#include "srsran/radio/radio_swarm.h"
 #include "srsran/srslog/srslog.h"
 #include "srsran/system/sys_metrics_processor.h"
 #include "stack/ue_stack_base.h"
@@ -66,6 +67,7 @@ typedef struct {
 
 typedef struct {
   float       metrics_period_secs;
+  uint32_t    swarm_nof_ues;
   bool        metrics_csv_enable;
   bool        metrics_csv_append;
   int         metrics_csv_flush_period_sec;
@@ -100,7 +102,7 @@ public:
   ue();
   ~ue();
 
-  int  init(const all_args_t& args_);
+  int  init(const all_args_t& args_, srsran::radio_swarm* swarm = nullptr);
   void stop();
   bool switch_on();
   bool switch_off();
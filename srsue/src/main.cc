@@ -56,10 +56,10 @@ namespace bpo = boost::program_options;
  *  Local static variables
  ***********************************************************************/
 
-static bool              do_metrics     = false;
-static metrics_stdout*   metrics_screen = nullptr;
-static srslog::sink*     log_sink       = nullptr;
-static std::atomic<bool> running        = {true};
+static bool                         do_metrics      = false;
+static std::vector<metrics_stdout*> metrics_screens = {};
+static srslog::sink*                log_sink        = nullptr;
+static std::atomic<bool>            running         = {true};
 
 /**********************************************************************
  *  Program arguments processing
@@ -211,6 +211,7 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
 
     /* Downlink Channel emulator section */
     ("channel.dl.enable",            bpo::value<bool>(&args->phy.dl_channel_args.enable)->default_value(false),                 "Enable/Disable internal Downlink channel emulator")
+    ("channel.dl.nof_threads",       bpo::value<uint32_t>(&args->phy.dl_channel_args.nof_threads)->default_value(1),            "Number of threads processing the downlink channels in parallel")
     ("channel.dl.awgn.enable",       bpo::value<bool>(&args->phy.dl_channel_args.awgn_enable)->default_value(false),            "Enable/Disable AWGN simulator")
     ("channel.dl.awgn.snr",          bpo::value<float>(&args->phy.dl_channel_args.awgn_snr_dB)->default_value(30.0f),           "SNR in dB")
     ("channel.dl.awgn.signal_power", bpo::value<float>(&args->phy.dl_channel_args.awgn_signal_power_dBfs)->default_value(0.0f), "Received signal power in decibels full scale (dBfs)")
@@ -231,6 +232,7 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
 
     /* Uplink Channel emulator section */
     ("channel.ul.enable",            bpo::value<bool>(&args->phy.ul_channel_args.enable)->default_value(false),                  "Enable/Disable internal Downlink channel emulator")
+    ("channel.ul.nof_threads",       bpo::value<uint32_t>(&args->phy.ul_channel_args.nof_threads)->default_value(1),             "Number of threads processing the uplink channels in parallel")
     ("channel.ul.awgn.enable",       bpo::value<bool>(&args->phy.ul_channel_args.awgn_enable)->default_value(false),             "Enable/Disable AWGN simulator")
     ("channel.ul.awgn.snr",          bpo::value<float>(&args->phy.ul_channel_args.awgn_snr_dB)->default_value(30.0f),            "Noise level in decibels full scale (dBfs)")
     ("channel.ul.awgn.signal_power", bpo::value<float>(&args->phy.ul_channel_args.awgn_signal_power_dBfs)->default_value(30.0f), "Transmitted signal power in decibels full scale (dBfs)")
@@ -336,6 +338,11 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
      bpo::value<bool>(&args->phy.cfo_integer_enabled)->default_value(false),
      "Enables integer CFO estimation and correction.")
 
+    ("phy.cfo_correct_deferred",
+     bpo::value<bool>(&args->phy.cfo_correct_deferred)->default_value(false),
+     "Corrects the CFO and the SFO timing drift of the subframes not used for tracking in the OFDM demodulator, "
+     "instead of a separate pass over the received samples.")
+
     ("phy.cfo_correct_tol_hz",
      bpo::value<float>(&args->phy.cfo_correct_tol_hz)->default_value(1.0),
      "Tolerance (in Hz) for digital CFO compensation (needs to be low if interpolate_subframe_enabled=true.")
@@ -385,6 +392,18 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
      bpo::value<uint32_t>(&args->phy.estimator_fil_order)->default_value(4),
      "Sets the channel estimator smooth gaussian filter order (even values perform better).")
 
+    ("phy.estimator_incremental",
+     bpo::value<bool>(&args->phy.estimator_incremental)->default_value(false),
+     "Reuses the channel estimator state of previous subframes for stationary channels.")
+
+    ("phy.estimator_incr_alpha",
+     bpo::value<float>(&args->phy.estimator_incr_alpha)->default_value(0.5f),
+     "Weight of the newest subframe in the incremental estimator pilot time filter (1.0 disables the filter).")
+
+    ("phy.estimator_incr_period",
+     bpo::value<uint32_t>(&args->phy.estimator_incr_period)->default_value(5),
+     "Subframes between noise and RSSI measurements in the incremental estimator.")
+
     ("phy.snr_to_cqi_offset",
      bpo::value<float>(&args->phy.snr_to_cqi_offset)->default_value(0),
      "Sets an offset in the SNR to CQI table. This is used to adjust the reported CQI.")
@@ -492,6 +511,10 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
            bpo::value<std::size_t>(&args->general.tracing_buffcapacity)->default_value(1000000),
            "Tracing buffer capcity")
 
+    ("general.swarm_nof_ues",
+           bpo::value<uint32_t>(&args->general.swarm_nof_ues)->default_value(1),
+           "Number of UE instances sharing the radio in this process")
+
     ("stack.have_tti_time_stats",
         bpo::value<bool>(&args->stack.have_tti_time_stats)->default_value(true),
         "Calculate TTI execution statistics")
@@ -678,7 +701,7 @@ static void* input_loop(void*)
         } else {
           cout << "Enter t to restart trace." << endl;
         }
-        if (metrics_screen) {
+        for (metrics_stdout* metrics_screen : metrics_screens) {
           metrics_screen->toggle_print(do_metrics);
         }
       } else if (key == "rlf") {
@@ -696,6 +719,98 @@ static void* input_loop(void*)
   return nullptr;
 }
 
+/// Adds inc to a string of decimal digits, keeping its length.
+static string increment_digits(const string& value, uint32_t inc)
+{
+  if (value.empty()) {
+    return value;
+  }
+  string result = std::to_string(std::stoull(value) + inc);
+  if (result.size() < value.size()) {
+    result.insert(0, value.size() - result.size(), '0');
+  }
+  return result;
+}
+
+/// Inserts the UE index before the file extension.
+static string add_filename_index(const string& filename, uint32_t idx)
+{
+  size_t dot   = filename.find_last_of('.');
+  size_t slash = filename.find_last_of('/');
+  if (dot == string::npos or (slash != string::npos and dot < slash)) {
+    return filename + "_" + std::to_string(idx);
+  }
+  return filename.substr(0, dot) + "_" + std::to_string(idx) + filename.substr(dot);
+}
+
+/// Derives the arguments of the UE with the given index in a swarm. The first UE keeps the configured ones, the rest
+/// take consecutive IMSI/IMEI and their own TUN device, network namespace and packet captures.
+static all_args_t get_swarm_ue_args(const all_args_t& args, uint32_t idx)
+{
+  all_args_t ue_args = args;
+  if (idx == 0) {
+    return ue_args;
+  }
+
+  ue_args.stack.usim.imsi  = increment_digits(args.stack.usim.imsi, idx);
+  ue_args.stack.usim.imei  = increment_digits(args.stack.usim.imei, idx);
+  ue_args.gw.tun_dev_name += "_" + std::to_string(idx);
+  if (not args.gw.netns.empty()) {
+    ue_args.gw.netns += "_" + std::to_string(idx);
+  }
+  ue_args.stack.pkt_trace.mac_pcap.filename    = add_filename_index(args.stack.pkt_trace.mac_pcap.filename, idx);
+  ue_args.stack.pkt_trace.mac_nr_pcap.filename = add_filename_index(args.stack.pkt_trace.mac_nr_pcap.filename, idx);
+  ue_args.stack.pkt_trace.nas_pcap.filename    = add_filename_index(args.stack.pkt_trace.nas_pcap.filename, idx);
+  ue_args.general.metrics_csv_filename         = add_filename_index(args.general.metrics_csv_filename, idx);
+  ue_args.general.metrics_json_filename        = add_filename_index(args.general.metrics_json_filename, idx);
+  return ue_args;
+}
+
+/// Metrics hub and listeners of one of the additional UEs of a swarm
+struct swarm_ue_metrics_t {
+  srsran::metrics_hub<ue_metrics_t> hub;
+  metrics_stdout                    screen;
+  std::unique_ptr<metrics_csv>      csv;
+  std::unique_ptr<metrics_json>     json;
+};
+
+/// Reports the metrics of an additional UE of a swarm through its own hub. The screen lines are labelled with the UE
+/// index, and the CSV and JSON files take the index in their names.
+static std::unique_ptr<swarm_ue_metrics_t> init_swarm_ue_metrics(srsue::ue& ue, const all_args_t& args, uint32_t idx)
+{
+  std::unique_ptr<swarm_ue_metrics_t> m(new swarm_ue_metrics_t);
+  all_args_t                          ue_args = get_swarm_ue_args(args, idx);
+
+  m->hub.init(&ue, args.general.metrics_period_secs);
+  m->hub.add_listener(&m->screen);
+  m->screen.set_ue_handle(&ue);
+  m->screen.set_label("ue" + std::to_string(idx));
+  metrics_screens.push_back(&m->screen);
+
+  if (args.general.metrics_csv_enable) {
+    m->csv = std::unique_ptr<metrics_csv>(
+        new metrics_csv(ue_args.general.metrics_csv_filename, args.general.metrics_csv_append));
+    m->hub.add_listener(m->csv.get());
+    m->csv->set_ue_handle(&ue);
+    if (args.general.metrics_csv_flush_period_sec > 0) {
+      m->csv->set_flush_period((uint32_t)args.general.metrics_csv_flush_period_sec);
+    }
+  }
+
+  if (args.general.metrics_json_enable) {
+    srslog::sink& json_sink =
+        srslog::fetch_file_sink(ue_args.general.metrics_json_filename, 0, false, srslog::create_json_formatter());
+    srslog::log_channel& json_channel =
+        srslog::fetch_log_channel("JSON_channel_" + std::to_string(idx), json_sink, {});
+    json_channel.set_enabled(true);
+    m->json = std::unique_ptr<metrics_json>(new metrics_json(json_channel));
+    m->hub.add_listener(m->json.get());
+    m->json->set_ue_handle(&ue);
+  }
+
+  return m;
+}
+
 /// Adjusts the input value in args from kbytes to bytes.
 static size_t fixup_log_file_maxsize(int x)
 {
@@ -761,20 +876,48 @@ int main(int argc, char* argv[])
     fprintf(stderr, "Failed to `mlockall`: %d", errno);
   }
 
+  // In swarm mode, several UE instances share the same radio
+  std::unique_ptr<srsran::radio_swarm> swarm;
+  if (args.general.swarm_nof_ues > 1) {
+    srsran::rf_args_t rf_args = args.rf;
+    rf_args.nof_carriers      = args.phy.nof_lte_carriers + args.phy.nof_nr_carriers;
+    swarm                     = std::unique_ptr<srsran::radio_swarm>(new srsran::radio_swarm);
+    if (swarm->init(rf_args)) {
+      return SRSRAN_ERROR;
+    }
+    cout << "Swarm mode: " << args.general.swarm_nof_ues << " UEs share the radio, metrics are reported per UE"
+         << endl;
+  }
+
   // Create UE instance.
   srsue::ue ue;
-  if (ue.init(args)) {
+  if (ue.init(args, swarm.get())) {
     ue.stop();
     return SRSRAN_SUCCESS;
   }
 
+  std::vector<std::unique_ptr<srsue::ue>> swarm_ues;
+  for (uint32_t i = 1; i < args.general.swarm_nof_ues; i++) {
+    swarm_ues.emplace_back(new srsue::ue);
+    if (swarm_ues.back()->init(get_swarm_ue_args(args, i), swarm.get())) {
+      for (std::unique_ptr<srsue::ue>& swarm_ue : swarm_ues) {
+        swarm_ue->stop();
+      }
+      ue.stop();
+      return SRSRAN_SUCCESS;
+    }
+  }
+
   srsran::metrics_hub<ue_metrics_t> metricshub;
   metrics_stdout                    _metrics_screen;
 
-  metrics_screen = &_metrics_screen;
+  metrics_screens.push_back(&_metrics_screen);
   metricshub.init(&ue, args.general.metrics_period_secs);
-  metricshub.add_listener(metrics_screen);
-  metrics_screen->set_ue_handle(&ue);
+  metricshub.add_listener(&_metrics_screen);
+  _metrics_screen.set_ue_handle(&ue);
+  if (swarm) {
+    _metrics_screen.set_label("ue0");
+  }
 
   metrics_csv metrics_file(args.general.metrics_csv_filename, args.general.metrics_csv_append);
   if (args.general.metrics_csv_enable) {
@@ -797,11 +940,20 @@ int main(int argc, char* argv[])
     json_metrics.set_ue_handle(&ue);
   }
 
+  // Each additional UE of a swarm reports its own metrics
+  std::vector<std::unique_ptr<swarm_ue_metrics_t>> swarm_metrics;
+  for (uint32_t i = 0; i < swarm_ues.size(); i++) {
+    swarm_metrics.push_back(init_swarm_ue_metrics(*swarm_ues[i], args, i + 1));
+  }
+
   pthread_t input;
   pthread_create(&input, nullptr, &input_loop, &args);
 
   cout << "Attaching UE..." << endl;
   ue.switch_on();
+  for (std::unique_ptr<srsue::ue>& swarm_ue : swarm_ues) {
+    swarm_ue->switch_on();
+  }
 
   if (args.gui.enable) {
     ue.start_plot();
@@ -812,11 +964,23 @@ int main(int argc, char* argv[])
   }
 
   ue.switch_off();
+  for (std::unique_ptr<srsue::ue>& swarm_ue : swarm_ues) {
+    swarm_ue->switch_off();
+  }
   pthread_cancel(input);
   pthread_join(input, nullptr);
   metricshub.stop();
   metrics_file.stop();
+  for (std::unique_ptr<swarm_ue_metrics_t>& m : swarm_metrics) {
+    m->hub.stop();
+  }
   ue.stop();
+  for (std::unique_ptr<srsue::ue>& swarm_ue : swarm_ues) {
+    swarm_ue->stop();
+  }
+  if (swarm) {
+    swarm->stop();
+  }
   cout << "---  exiting  ---" << endl;
 
   return SRSRAN_SUCCESS;
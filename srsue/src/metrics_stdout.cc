@@ -72,26 +72,47 @@ void metrics_stdout::toggle_print(bool b)
   do_print = b;
 }
 
+void metrics_stdout::set_label(const std::string& label_)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  label = label_;
+}
+
+void metrics_stdout::print_label(bool blank)
+{
+  if (not label.empty()) {
+    fmt::print("{:<{}} ", blank ? "" : label, label.size());
+  }
+}
+
 void metrics_stdout::print_table(const bool display_neighbours, const bool is_nr)
 {
   if (is_nr) {
     if (display_neighbours) {
+      print_label(true);
       fmt::print(
           "---------Signal-----------|-Neighbour-|-----------------DL-----------------|-----------UL-----------\n");
+      print_label(true);
       fmt::print(
           "rat  pci  rsrp   pl   cfo | pci  rsrp | mcs  snr  iter  brate  bler  ta_us | mcs   buff  brate  bler\n");
     } else {
+      print_label(true);
       fmt::print("---------Signal-----------|-----------------DL-----------------|-----------UL-----------\n");
+      print_label(true);
       fmt::print("rat  pci  rsrp   pl   cfo | mcs  snr  iter  brate  bler  ta_us | mcs   buff  brate  bler\n");
     }
   } else {
     if (display_neighbours) {
+      print_label(true);
       fmt::print(
           "---------Signal-----------|-Neighbour-|-----------------DL-----------------|-----------UL-----------\n");
+      print_label(true);
       fmt::print(
           " cc  pci  rsrp   pl   cfo | pci  rsrp | mcs  snr  iter  brate  bler  ta_us | mcs   buff  brate  bler\n");
     } else {
+      print_label(true);
       fmt::print("---------Signal-----------|-----------------DL-----------------|-----------UL-----------\n");
+      print_label(true);
       fmt::print(" cc  pci  rsrp   pl   cfo | mcs  snr  iter  brate  bler  ta_us | mcs   buff  brate  bler\n");
     }
   }
@@ -107,6 +128,7 @@ void metrics_stdout::set_metrics_helper(const phy_metrics_t& phy,
                                         bool                 is_carrier_nr,
                                         bool                 print_carrier_num)
 {
+  print_label(false);
   if (print_carrier_num) {
     fmt::print("{:>3}", r);
   } else {
@@ -183,6 +205,7 @@ void metrics_stdout::set_metrics(const ue_metrics_t& metrics, const uint32_t per
 
   // always print RF error
   if (metrics.rf.rf_error) {
+    print_label(false);
     fmt::print("RF status: O={}, U={}, L={}\n", metrics.rf.rf_o, metrics.rf.rf_u, metrics.rf.rf_l);
   }
 
@@ -191,6 +214,7 @@ void metrics_stdout::set_metrics(const ue_metrics_t& metrics, const uint32_t per
   }
 
   if (metrics.stack.rrc.state != RRC_STATE_CONNECTED && metrics.stack.rrc_nr.state != RRC_NR_STATE_CONNECTED) {
+    print_label(false);
     fmt::print("--- disconnected ---\n");
     return;
   }
@@ -229,6 +253,7 @@ void metrics_stdout::set_metrics(const ue_metrics_t& metrics, const uint32_t per
   }
 
   if (metrics.rf.rf_error) {
+    print_label(false);
     fmt::print("RF status: O={}, U={}, L={}\n", metrics.rf.rf_o, metrics.rf.rf_u, metrics.rf.rf_l);
   }
 }
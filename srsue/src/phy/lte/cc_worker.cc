@@ -194,6 +194,12 @@ void cc_worker::set_cfo_nolock(float cfo)
   ue_ul_cfg.cfo_value = cfo;
 }
 
+void cc_worker::set_rx_cfo_nolock(float cfo, float phase, float time_offset)
+{
+  srsran_ue_dl_set_cfo(&ue_dl, cfo, phase);
+  srsran_ue_dl_set_time_offset(&ue_dl, time_offset);
+}
+
 float cc_worker::get_ref_cfo() const
 {
   return ue_dl.chest_res.cfo;
@@ -134,6 +134,11 @@ void sf_worker::set_cfo_nolock(const uint32_t& cc_idx, float cfo)
   cc_workers[cc_idx]->set_cfo_nolock(cfo);
 }
 
+void sf_worker::set_rx_cfo_nolock(const uint32_t& cc_idx, float cfo, float phase, float time_offset)
+{
+  cc_workers[cc_idx]->set_rx_cfo_nolock(cfo, phase, time_offset);
+}
+
 void sf_worker::set_tdd_config_nolock(srsran_tdd_config_t config)
 {
   for (auto& cc_worker : cc_workers) {
@@ -0,0 +1,141 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsue/hdr/phy/nr/ssb_search_multi.h"
+#include "srsran/common/band_helper.h"
+#include <algorithm>
+
+namespace srsue {
+namespace nr {
+
+class ssb_search_multi::worker
+{
+public:
+  worker(srslog::basic_logger& logger_, const args_t& args) : logger(logger_)
+  {
+    srsran_ssb_args_t ssb_args = {};
+    ssb_args.max_srate_hz      = args.max_srate_hz;
+    ssb_args.min_scs           = args.ssb_min_scs;
+    ssb_args.enable_search     = true;
+    ssb_args.enable_decode     = true;
+
+    if (srsran_ssb_init(&ssb, &ssb_args) < SRSRAN_SUCCESS) {
+      logger.error("SSB search: Error initiating SSB");
+    }
+  }
+
+  ~worker() { srsran_ssb_free(&ssb); }
+
+  void search(const cfg_t&           cfg,
+              double                 ssb_freq_hz,
+              const cf_t*            samples,
+              uint32_t               nof_samples,
+              std::vector<result_t>& results)
+  {
+    srsran_ssb_cfg_t ssb_cfg = {};
+    ssb_cfg.srate_hz         = cfg.srate_hz;
+    ssb_cfg.center_freq_hz   = cfg.center_freq_hz;
+    ssb_cfg.ssb_freq_hz      = ssb_freq_hz;
+    ssb_cfg.scs              = cfg.ssb_scs;
+    ssb_cfg.pattern          = cfg.ssb_pattern;
+    ssb_cfg.duplex_mode      = cfg.duplex_mode;
+    if (srsran_ssb_set_cfg(&ssb, &ssb_cfg) < SRSRAN_SUCCESS) {
+      logger.error("SSB search: Error setting SSB configuration for %.2f MHz", ssb_freq_hz / 1e6);
+      return;
+    }
+
+    srsran_ssb_search_res_t res[SRSRAN_SSB_SEARCH_MAX_CANDIDATES] = {};
+    int nof_res = srsran_ssb_search_all(&ssb, samples, nof_samples, res, SRSRAN_SSB_SEARCH_MAX_CANDIDATES);
+    if (nof_res < SRSRAN_SUCCESS) {
+      logger.error("SSB search: Error searching SSB in %.2f MHz", ssb_freq_hz / 1e6);
+      return;
+    }
+
+    for (int i = 0; i < nof_res; i++) {
+      logger.info("SSB search: %.2f MHz: PCI=%d; ssb_idx=%d; RSRP=%+.1f dB; SNR=%+.1f dB; CFO=%+.1f Hz",
+                  ssb_freq_hz / 1e6,
+                  res[i].N_id,
+                  res[i].pbch_msg.ssb_idx,
+                  res[i].measurements.rsrp_dB,
+                  res[i].measurements.snr_dB,
+                  res[i].measurements.cfo_hz);
+      results.push_back({ssb_freq_hz, res[i]});
+    }
+  }
+
+private:
+  srslog::basic_logger& logger;
+  srsran_ssb_t          ssb = {};
+};
+
+ssb_search_multi::ssb_search_multi(srslog::basic_logger& logger_, const args_t& args_) :
+  logger(logger_), args(args_), pool(std::max(args_.nof_workers, 1U))
+{
+  for (uint32_t i = 0; i < std::max(args.nof_workers, 1U); i++) {
+    workers.emplace_back(new worker(logger, args));
+  }
+}
+
+ssb_search_multi::~ssb_search_multi()
+{
+  pool.stop();
+}
+
+std::vector<ssb_search_multi::result_t> ssb_search_multi::run(const cfg_t&               cfg,
+                                                              const std::vector<double>& ssb_freqs_hz,
+                                                              const cf_t*                samples,
+                                                              uint32_t                   nof_samples)
+{
+  // Each worker takes the next pending SSB frequency until all of them have been searched
+  std::vector<std::vector<result_t>> results_per_freq(ssb_freqs_hz.size());
+  srsran::parallel_for_each(pool, workers.size(), ssb_freqs_hz.size(), [&](uint32_t worker_idx, uint32_t idx) {
+    workers[worker_idx]->search(cfg, ssb_freqs_hz[idx], samples, nof_samples, results_per_freq[idx]);
+  });
+
+  std::vector<result_t> results;
+  for (const std::vector<result_t>& r : results_per_freq) {
+    results.insert(results.end(), r.begin(), r.end());
+  }
+  std::stable_sort(results.begin(), results.end(), [](const result_t& a, const result_t& b) {
+    return a.ssb_res.measurements.rsrp_dB > b.ssb_res.measurements.rsrp_dB;
+  });
+  return results;
+}
+
+std::vector<double> ssb_search_multi::get_ssb_freqs(uint16_t band, const cfg_t& cfg)
+{
+  // The SSB spans SRSRAN_SSB_BW_SUBC subcarriers around its center frequency
+  double ssb_half_bw_hz = SRSRAN_SSB_BW_SUBC * SRSRAN_SUBC_SPACING_NR(cfg.ssb_scs) / 2.0;
+
+  srsran::srsran_band_helper                band_helper;
+  srsran::srsran_band_helper::sync_raster_t sync_raster = band_helper.get_sync_raster(band, cfg.ssb_scs);
+  std::vector<double>                       ssb_freqs_hz;
+  for (; not sync_raster.end(); sync_raster.next()) {
+    double ssb_freq_hz = sync_raster.get_frequency();
+    if (std::abs(ssb_freq_hz - cfg.center_freq_hz) + ssb_half_bw_hz <= cfg.srate_hz / 2.0) {
+      ssb_freqs_hz.push_back(ssb_freq_hz);
+    }
+  }
+  return ssb_freqs_hz;
+}
+
+} // namespace nr
+} // namespace srsue
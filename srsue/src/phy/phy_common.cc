@@ -106,6 +106,9 @@ void phy_common::set_ue_dl_cfg(srsran_ue_dl_cfg_t* ue_dl_cfg)
       args->interpolate_subframe_enabled ? SRSRAN_ESTIMATOR_ALG_INTERPOLATE : SRSRAN_ESTIMATOR_ALG_AVERAGE;
   chest_cfg->cfo_estimate_enable  = args->cfo_ref_mask != 0;
   chest_cfg->cfo_estimate_sf_mask = args->cfo_ref_mask;
+  chest_cfg->incremental_enable   = args->estimator_incremental;
+  chest_cfg->incremental_alpha    = args->estimator_incr_alpha;
+  chest_cfg->incremental_period   = args->estimator_incr_period;
 }
 
 void phy_common::set_pdsch_cfg(srsran_pdsch_cfg_t* pdsch_cfg)
@@ -779,6 +782,7 @@ void phy_common::update_measurements(uint32_t                     cc_idx,
     ch.pathloss     = pathloss[cc_idx];
     ch.sinr         = avg_sinr_db[cc_idx];
     ch.sync_err     = chest_res.sync_error;
+    ch.chest_reuse  = chest_res.reuse_ratio;
 
     set_ch_metrics(cc_idx, ch);
 
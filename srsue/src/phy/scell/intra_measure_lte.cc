@@ -19,6 +19,8 @@
  *
  */
 #include "srsue/hdr/phy/scell/intra_measure_lte.h"
+#include <chrono>
+#include <cinttypes>
 
 namespace srsue {
 namespace scell {
@@ -59,8 +61,20 @@ void intra_measure_lte::set_primary_cell(uint32_t earfcn, srsran_cell_t cell)
   set_current_sf_len((uint32_t)SRSRAN_SF_LEN_PRB(cell.nof_prb));
 }
 
+std::map<uint32_t, uint32_t> intra_measure_lte::get_cycle_time_us()
+{
+  std::lock_guard<std::mutex>  lock(mutex);
+  std::map<uint32_t, uint32_t> avg;
+  for (const auto& e : cycle_time_us) {
+    avg[e.first] = (uint32_t)(e.second.first / e.second.second);
+  }
+  return avg;
+}
+
 bool intra_measure_lte::measure_rat(const measure_context_t& context, std::vector<cf_t>& buffer, float rx_gain_offset)
 {
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
   std::set<uint32_t> cells_to_measure = context.active_pci;
 
   srsran_cell_t serving_cell_copy{};
@@ -118,6 +132,17 @@ bool intra_measure_lte::measure_rat(const measure_context_t& context, std::vecto
     }
   }
 
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  uint64_t                              elapsed_us =
+      (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto&                       perf = cycle_time_us[(uint32_t)cells_to_measure.size()];
+    perf.first += elapsed_us;
+    perf.second++;
+  }
+  Log(debug, "Measured %zd cells in %" PRIu64 " us", cells_to_measure.size(), elapsed_us);
+
   // Send measurements to RRC if any cell found
   if (not neighbour_cells.empty()) {
     context.new_cell_itf.new_cell_meas(context.cc_idx, neighbour_cells);
@@ -30,46 +30,25 @@ namespace scell {
 
 void scell_recv::init(uint32_t max_sf_window)
 {
-  // and a separate ue_sync instance
-
   uint32_t max_fft_sz  = (uint32_t)srsran_symbol_sz(100);
   uint32_t max_sf_size = SRSRAN_SF_LEN(max_fft_sz);
 
-  sf_buffer[0] = srsran_vec_cf_malloc(max_sf_size);
-  if (!sf_buffer[0]) {
-    logger.error("Error allocating %d samples for scell", max_sf_size);
-    return;
-  }
-
-  // do this different we don't need all this search window.
-  if (srsran_sync_init(&sync_find, max_sf_window * max_sf_size, 5 * max_sf_size, max_fft_sz)) {
-    logger.error("Error initiating sync_find");
+  // All the PSS roots are correlated at once in 5 ms windows
+  if (srsran_pss_sss_batch_init(&pss_sss_find, 5 * max_sf_size, max_fft_sz)) {
+    logger.error("Error initiating PSS/SSS batch detector");
     return;
   }
-  srsran_sync_set_sss_algorithm(&sync_find, SSS_FULL);
-  srsran_sync_set_cfo_cp_enable(&sync_find, false, 0);
-  srsran_sync_cp_en(&sync_find, false);
-  srsran_sync_set_cfo_pss_enable(&sync_find, false);
-  srsran_sync_set_threshold(&sync_find, 2.0f); // The highest the best for avoiding ghost cells
-  srsran_sync_set_em_alpha(&sync_find, 0.3f);
-  srsran_sss_set_threshold(&sync_find.sss, 300.0); // A higher value will avoid false alarms but reduce detection
-
-  // Configure FIND object behaviour (this configuration is always the same)
-  srsran_sync_set_cfo_ema_alpha(&sync_find, 1.0);
-  srsran_sync_set_cfo_i_enable(&sync_find, false);
-  srsran_sync_set_pss_filt_enable(&sync_find, true);
-  srsran_sync_set_sss_eq_enable(&sync_find, true);
-
-  sync_find.pss.chest_on_filter  = true;
-  sync_find.sss_channel_equalize = false;
+  srsran_pss_sss_batch_set_threshold(&pss_sss_find, 2.0f); // The highest the best for avoiding ghost cells
+  srsran_pss_sss_batch_set_ema_alpha(&pss_sss_find, 0.3f);
+  // A higher value will avoid false alarms but reduce detection
+  srsran_pss_sss_batch_set_sss_threshold(&pss_sss_find, 300.0);
 
   reset();
 }
 
 void scell_recv::deinit()
 {
-  srsran_sync_free(&sync_find);
-  free(sf_buffer[0]);
+  srsran_pss_sss_batch_free(&pss_sss_find);
 }
 
 void scell_recv::reset()
@@ -86,73 +65,65 @@ void scell_recv::find_cells(const cf_t*          input_buffer,
   uint32_t sf_len = SRSRAN_SF_LEN(fft_sz);
 
   if (fft_sz != current_fft_sz) {
-    if (srsran_sync_resize(&sync_find, nof_sf * sf_len, 5 * sf_len, fft_sz)) {
-      logger.error("Error resizing sync nof_sf=%d, sf_len=%d, fft_sz=%d", nof_sf, sf_len, fft_sz);
+    if (srsran_pss_sss_batch_resize(&pss_sss_find, 5 * sf_len, fft_sz)) {
+      logger.error("Error resizing PSS/SSS batch detector sf_len=%d, fft_sz=%d", sf_len, fft_sz);
       return;
     }
     current_fft_sz = fft_sz;
   }
 
-  uint32_t peak_idx = 0;
-  int      cell_id  = 0;
-
-  for (uint32_t n_id_2 = 0; n_id_2 < 3; n_id_2++) {
-    if (n_id_2 != (serving_cell.id % 3)) {
-      srsran_sync_set_N_id_2(&sync_find, n_id_2);
-
-      srsran_sync_find_ret_t sync_res;
-
-      srsran_sync_reset(&sync_find);
-      srsran_sync_cfo_reset(&sync_find, 0.0f);
-
-      sync_res          = SRSRAN_SYNC_NOFOUND;
-      bool sss_detected = false;
-      cell_id           = 0;
-      float max_peak    = -1;
+  srsran_pss_sss_batch_reset(&pss_sss_find);
 
-      float sss_correlation_peak_max = 0.0f;
+  // Uses the cell ID from the highest SSS correlation peak of every N_id_2
+  std::array<int, SRSRAN_NOF_NID_2>   cell_id                  = {};
+  std::array<float, SRSRAN_NOF_NID_2> sss_correlation_peak_max = {};
+  std::array<bool, SRSRAN_NOF_NID_2>  sss_detected             = {};
+  std::array<bool, SRSRAN_NOF_NID_2>  pss_found                = {};
 
-      for (uint32_t sf5_cnt = 0; sf5_cnt < nof_sf / 5; sf5_cnt++) {
-        sync_res = srsran_sync_find(&sync_find, input_buffer, sf5_cnt * 5 * sf_len, &peak_idx);
-        if (sync_res == SRSRAN_SYNC_ERROR) {
-          logger.error("INTRA: Error calling sync_find()");
-          return;
-        }
+  for (uint32_t sf5_cnt = 0; sf5_cnt < nof_sf / 5; sf5_cnt++) {
+    std::array<srsran_pss_sss_batch_res_t, SRSRAN_NOF_NID_2> res = {};
+    if (srsran_pss_sss_batch_run(&pss_sss_find, input_buffer, sf5_cnt * 5 * sf_len, res.data()) < SRSRAN_SUCCESS) {
+      logger.error("INTRA: Error running PSS/SSS batch detector");
+      return;
+    }
 
-        if (sync_find.peak_value > max_peak && sync_res == SRSRAN_SYNC_FOUND && srsran_sync_sss_detected(&sync_find)) {
-          // Uses the cell ID from the highest SSS correlation peak
-          if (sss_correlation_peak_max < srsran_sync_sss_correlation_peak(&sync_find)) {
-            // Set the cell ID
-            cell_id = srsran_sync_get_cell_id(&sync_find);
+    for (uint32_t n_id_2 = 0; n_id_2 < SRSRAN_NOF_NID_2; n_id_2++) {
+      if (n_id_2 == (serving_cell.id % SRSRAN_NOF_NID_2)) {
+        continue;
+      }
+      const srsran_pss_sss_batch_res_t& r = res[n_id_2];
 
-            // Update the maximum value
-            sss_correlation_peak_max = srsran_sync_sss_correlation_peak(&sync_find);
-          }
-          sss_detected = true;
+      if (r.pss_found && r.sss_detected) {
+        if (sss_correlation_peak_max[n_id_2] < r.sss_corr) {
+          cell_id[n_id_2]                  = (int)(r.N_id_1 * SRSRAN_NOF_NID_2 + n_id_2);
+          sss_correlation_peak_max[n_id_2] = r.sss_corr;
         }
-
-        logger.debug("INTRA: n_id_2=%d, cnt=%d/%d, sync_res=%d, cell_id=%d, sf_idx=%d, peak_idx=%d, peak_value=%f, "
-                     "sss_detected=%d",
-                     n_id_2,
-                     sf5_cnt,
-                     nof_sf / 5,
-                     sync_res,
-                     cell_id,
-                     srsran_sync_get_sf_idx(&sync_find),
-                     peak_idx,
-                     sync_find.peak_value,
-                     srsran_sync_sss_detected(&sync_find));
+        sss_detected[n_id_2] = true;
       }
+      pss_found[n_id_2] = r.pss_found;
+
+      logger.debug("INTRA: n_id_2=%d, cnt=%d/%d, pss_found=%d, cell_id=%d, sf_idx=%d, peak_idx=%d, peak_value=%f, "
+                   "sss_detected=%d",
+                   n_id_2,
+                   sf5_cnt,
+                   nof_sf / 5,
+                   r.pss_found,
+                   cell_id[n_id_2],
+                   r.sf_idx,
+                   r.peak_pos,
+                   r.peak_value,
+                   r.sss_detected);
+    }
+  }
 
-      // If the SSS was not detected, the serving_cell id is not reliable. So, consider no sync found
-      if (sync_res == SRSRAN_SYNC_FOUND && sss_detected && cell_id >= 0) {
-        // We have found a new cell, add to the list
-        found_cell_ids.insert((uint32_t)cell_id);
-        logger.debug("INTRA: Detected new cell_id=%d using PSS/SSS", cell_id);
-      }
+  for (uint32_t n_id_2 = 0; n_id_2 < SRSRAN_NOF_NID_2; n_id_2++) {
+    // If the SSS was not detected, the serving_cell id is not reliable. So, consider no sync found
+    if (pss_found[n_id_2] && sss_detected[n_id_2]) {
+      // We have found a new cell, add to the list
+      found_cell_ids.insert((uint32_t)cell_id[n_id_2]);
+      logger.debug("INTRA: Detected new cell_id=%d using PSS/SSS", cell_id[n_id_2]);
     }
   }
-  return;
 }
 
 } // namespace scell
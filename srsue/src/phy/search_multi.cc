@@ -0,0 +1,216 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsue/hdr/phy/search_multi.h"
+#include "srsran/phy/resampling/resampler.h"
+#include <algorithm>
+
+namespace srsue {
+
+/// Searches the sources handed to it one at a time. The cell search and MIB decoder read the current source through
+/// the receive callback, which pads with zeros once the capture is exhausted.
+class search_multi::worker
+{
+public:
+  worker(srslog::basic_logger& logger_, const search_multi_args_t& args_) : logger(logger_), args(args_)
+  {
+    if (srsran_ue_cellsearch_init_multi(&cs, args.max_frames_pss, recv_callback, 1, this)) {
+      logger.error("Error initiating UE cell search");
+    }
+    srsran_ue_cellsearch_set_nof_valid_frames(&cs, std::min(args.nof_valid_frames, args.max_frames_pss));
+
+    if (srsran_ue_mib_sync_init_multi(&ue_mib_sync, recv_callback, 1, this)) {
+      logger.error("Error initiating UE MIB synchronization");
+    }
+  }
+
+  ~worker()
+  {
+    srsran_ue_mib_sync_free(&ue_mib_sync);
+    srsran_ue_cellsearch_free(&cs);
+  }
+
+  void search(const search_multi_source_t& source_, std::vector<search_multi_cell_t>& cells)
+  {
+    source = &source_;
+
+    for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2; N_id_2++) {
+      srsran_ue_cellsearch_result_t found = {};
+
+      offset  = 0;
+      int ret = srsran_ue_cellsearch_scan_N_id_2(&cs, N_id_2, &found);
+      if (ret < 0) {
+        logger.error("Error searching PSS in EARFCN %d", source->earfcn);
+        return;
+      }
+      if (ret == 0 or found.psr < args.min_psr) {
+        continue;
+      }
+
+      srsran_cell_t cell = {};
+      cell.id            = found.cell_id;
+      cell.cp            = found.cp;
+      cell.frame_type    = found.frame_type;
+      logger.info("EARFCN %d: PSS/SSS detected: PCI=%d, PSR=%.1f, CFO=%.1f KHz",
+                  source->earfcn,
+                  cell.id,
+                  found.psr,
+                  found.cfo / 1000);
+
+      // Go back to the start of the capture and decode the MIB, starting from the CFO estimated by the PSS
+      offset = 0;
+      if (srsran_ue_mib_sync_set_cell(&ue_mib_sync, cell)) {
+        logger.error("Error setting UE MIB cell");
+        return;
+      }
+      srsran_ue_sync_reset(&ue_mib_sync.ue_sync);
+      srsran_ue_sync_cfo_reset(&ue_mib_sync.ue_sync, found.cfo);
+
+      uint8_t bch_payload[SRSRAN_BCH_PAYLOAD_LEN] = {};
+      int     sfn_offset                          = 0;
+      ret = srsran_ue_mib_sync_decode(&ue_mib_sync, args.max_frames_mib, bch_payload, &cell.nof_ports, &sfn_offset);
+      if (ret != SRSRAN_UE_MIB_FOUND) {
+        logger.info("EARFCN %d: Found PSS but could not decode PBCH of PCI=%d", source->earfcn, cell.id);
+        continue;
+      }
+      srsran_pbch_mib_unpack(bch_payload, &cell, nullptr);
+      if (not srsran_cell_isvalid(&cell)) {
+        logger.warning("EARFCN %d: Detected invalid cell PCI=%d", source->earfcn, cell.id);
+        continue;
+      }
+
+      search_multi_cell_t result = {};
+      result.earfcn              = source->earfcn;
+      result.cell                = cell;
+      result.rsrp_dB             = srsran_convert_power_to_dB(ue_mib_sync.ue_mib.chest_res.rsrp);
+      result.psr                 = found.psr;
+      result.cfo_hz              = found.cfo;
+      cells.push_back(result);
+
+      logger.info("EARFCN %d: MIB decoded: PCI=%d, PRB=%d, Ports=%d, RSRP=%.1f dBfs",
+                  source->earfcn,
+                  cell.id,
+                  cell.nof_prb,
+                  cell.nof_ports,
+                  result.rsrp_dB);
+    }
+  }
+
+private:
+  static int recv_callback(void* obj, cf_t* data[SRSRAN_MAX_CHANNELS], uint32_t nsamples, srsran_timestamp_t* rx_time)
+  {
+    worker*  w      = static_cast<worker*>(obj);
+    uint32_t nof_rd = 0;
+    if (w->offset < w->source->nof_samples) {
+      nof_rd = std::min(nsamples, w->source->nof_samples - w->offset);
+      srsran_vec_cf_copy(data[0], &w->source->samples[w->offset], nof_rd);
+    }
+    srsran_vec_cf_zero(&data[0][nof_rd], nsamples - nof_rd);
+    w->offset += nsamples;
+
+    if (rx_time != nullptr) {
+      srsran_timestamp_init(rx_time, 0, 0);
+    }
+    return nsamples;
+  }
+
+  srslog::basic_logger&        logger;
+  search_multi_args_t          args;
+  srsran_ue_cellsearch_t       cs          = {};
+  srsran_ue_mib_sync_t         ue_mib_sync = {};
+  const search_multi_source_t* source      = nullptr;
+  uint32_t                     offset      = 0;
+};
+
+search_multi::search_multi(srslog::basic_logger& logger_, const search_multi_args_t& args_) :
+  logger(logger_), args(args_), pool(std::max(args_.nof_workers, 1U))
+{
+  for (uint32_t i = 0; i < std::max(args.nof_workers, 1U); i++) {
+    workers.emplace_back(new worker(logger, args));
+  }
+}
+
+search_multi::~search_multi()
+{
+  pool.stop();
+}
+
+std::vector<search_multi_cell_t> search_multi::run(const std::vector<search_multi_source_t>& sources)
+{
+  // Each worker takes the next pending source until all of them have been searched
+  std::vector<std::vector<search_multi_cell_t>> cells_per_source(sources.size());
+  srsran::parallel_for_each(pool, workers.size(), sources.size(), [&](uint32_t worker_idx, uint32_t idx) {
+    workers[worker_idx]->search(sources[idx], cells_per_source[idx]);
+  });
+
+  std::vector<search_multi_cell_t> cells;
+  for (const std::vector<search_multi_cell_t>& c : cells_per_source) {
+    cells.insert(cells.end(), c.begin(), c.end());
+  }
+  std::stable_sort(cells.begin(), cells.end(), [](const search_multi_cell_t& a, const search_multi_cell_t& b) {
+    return a.rsrp_dB > b.rsrp_dB;
+  });
+  return cells;
+}
+
+int search_multi::channelise(const cf_t*        samples,
+                             uint32_t           nof_samples,
+                             double             srate_hz,
+                             double             center_freq_hz,
+                             uint32_t           earfcn,
+                             std::vector<cf_t>& output)
+{
+  uint32_t ratio = (uint32_t)round(srate_hz / SRSRAN_CS_SAMP_FREQ);
+  if (ratio == 0 or fabs(ratio * SRSRAN_CS_SAMP_FREQ - srate_hz) > 1.0) {
+    ERROR("Sampling rate %.2f MHz is not a multiple of %.2f MHz", srate_hz / 1e6, SRSRAN_CS_SAMP_FREQ / 1e6);
+    return SRSRAN_ERROR;
+  }
+
+  double freq_offset_hz = srsran_band_fd(earfcn) * 1e6 - center_freq_hz;
+  if (fabs(freq_offset_hz) + SRSRAN_CS_SAMP_FREQ / 2 > srate_hz / 2) {
+    ERROR("EARFCN %d is not within the captured bandwidth", earfcn);
+    return SRSRAN_ERROR;
+  }
+
+  // Bring the EARFCN to baseband
+  nof_samples -= nof_samples % ratio;
+  std::vector<cf_t> shifted(nof_samples);
+  srsran_vec_apply_cfo(samples, (float)(-freq_offset_hz / srate_hz), shifted.data(), nof_samples);
+
+  if (ratio == 1) {
+    output = std::move(shifted);
+    return SRSRAN_SUCCESS;
+  }
+
+  // Filter and decimate down to the cell search sampling rate
+  srsran_resampler_fft_t resampler = {};
+  if (srsran_resampler_fft_init(&resampler, SRSRAN_RESAMPLER_MODE_DECIMATE, ratio) < SRSRAN_SUCCESS) {
+    ERROR("Error initiating decimator");
+    return SRSRAN_ERROR;
+  }
+  output.resize(nof_samples / ratio);
+  srsran_resampler_fft_run(&resampler, shifted.data(), output.data(), nof_samples);
+  srsran_resampler_fft_free(&resampler);
+
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsue
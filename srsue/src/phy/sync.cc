@@ -472,9 +472,19 @@ void sync::run_camping_in_sync_state(lte::sf_worker*      lte_worker,
     force_camping_sfn_sync = true;
   }
 
-  // Run secondary serving cell synchronization
+  // Get the CFO and timing corrections that ue_sync left to the OFDM demodulators, if deferred
+  float sf_cfo         = 0.0f;
+  float sf_cfo_phase   = 0.0f;
+  float sf_time_offset = 0.0f;
+  srsran_ue_sync_get_sf_cfo(&ue_sync, &sf_cfo, &sf_cfo_phase);
+  if (worker_com->args->cfo_correct_deferred) {
+    sf_time_offset = srsran_ue_sync_get_sf_time_offset(&ue_sync);
+  }
+  float sf_cfo_norm = -sf_cfo / (float)ue_sync.fft_size;
+
+  // Run secondary serving cell synchronization, it corrects the pending CFO in its own copy of the base-band
   for (auto& e : scell_sync) {
-    e.second->run(tti, sync_buffer.get(e.first, 0, worker_com->args->nof_rx_ant));
+    e.second->run(tti, sync_buffer.get(e.first, 0, worker_com->args->nof_rx_ant), sf_cfo_norm, sf_cfo_phase);
   }
 
   if (is_overflow) {
@@ -538,6 +548,7 @@ void sync::run_camping_in_sync_state(lte::sf_worker*      lte_worker,
   // Set CFO for all Carriers
   for (uint32_t cc = 0; cc < worker_com->args->nof_lte_carriers; cc++) {
     lte_worker->set_cfo_nolock(cc, get_tx_cfo());
+    lte_worker->set_rx_cfo_nolock(cc, sf_cfo, sf_cfo_phase, sf_time_offset);
     worker_com->update_cfo_measurement(cc, cfo);
   }
 
@@ -563,6 +574,18 @@ void sync::run_camping_in_sync_state(lte::sf_worker*      lte_worker,
 
     nr_worker->set_context(context);
 
+    // The NR demodulators do not take the deferred CFO correction, correct the NR carriers in place
+    if (std::isnormal(sf_cfo)) {
+      for (uint32_t cc = 0; cc < worker_com->args->nof_nr_carriers; cc++) {
+        for (uint32_t i = 0; i < worker_com->args->nof_rx_ant; i++) {
+          cf_t* ptr = sync_buffer.get(worker_com->args->nof_lte_carriers + cc, i, worker_com->args->nof_rx_ant);
+          if (ptr != nullptr) {
+            srsran_vec_apply_cfo_phase(ptr, sf_cfo_norm, sf_cfo_phase, ptr, ue_sync.frame_len);
+          }
+        }
+      }
+    }
+
     // As UE sync compensates CFO externally based on LTE signal and the NR carrier may estimate the CFO from the LTE
     // signal. It is necessary setting an NR external CFO offset to compensate it.
     nr_worker_pool->set_ul_ext_cfo(srsran_ue_sync_get_cfo(&ue_sync));
@@ -626,8 +649,11 @@ void sync::run_camping_state()
     ref_cfo = 0.0; // reset until value changes again
   }
 
-  // Primary Cell (PCell) Synchronization
+  // Primary Cell (PCell) Synchronization. While camping, the CFO correction of the subframes that are not used for
+  // tracking can be left to the OFDM demodulators
+  srsran_ue_sync_set_cfo_correct_deferred(&ue_sync, worker_com->args->cfo_correct_deferred);
   int sync_result = srsran_ue_sync_zerocopy(&ue_sync, sync_buffer.to_cf_t(), lte_worker->get_buffer_len());
+  srsran_ue_sync_set_cfo_correct_deferred(&ue_sync, false);
   cfo             = srsran_ue_sync_get_cfo(&ue_sync);
   sfo             = srsran_ue_sync_get_sfo(&ue_sync);
 
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsue/hdr/phy/nr/ssb_search_multi.h"
+
+// Band n78 capture of 23.04 MHz centered on a sync raster frequency
+#define BAND 78
+#define SRATE_HZ 23.04e6
+#define CENTER_FREQ_HZ (3000e6 + 347 * 1.44e6)
+
+// Adds an SSB of the given cell and beam at ssb_freq_hz to the half frame in buffer
+static int add_ssb(srsran_ssb_t* ssb, double ssb_freq_hz, uint32_t pci, uint32_t ssb_idx, std::vector<cf_t>& buffer)
+{
+  srsran_ssb_cfg_t ssb_cfg = {};
+  ssb_cfg.srate_hz         = SRATE_HZ;
+  ssb_cfg.center_freq_hz   = CENTER_FREQ_HZ;
+  ssb_cfg.ssb_freq_hz      = ssb_freq_hz;
+  ssb_cfg.scs              = srsran_subcarrier_spacing_30kHz;
+  ssb_cfg.pattern          = SRSRAN_SSB_PATTERN_C;
+  ssb_cfg.duplex_mode      = SRSRAN_DUPLEX_MODE_TDD;
+  TESTASSERT(srsran_ssb_set_cfg(ssb, &ssb_cfg) == SRSRAN_SUCCESS);
+
+  srsran_pbch_msg_nr_t pbch_msg = {};
+  pbch_msg.ssb_idx              = ssb_idx;
+  pbch_msg.payload[0]           = 1;
+  TESTASSERT(srsran_ssb_add(ssb, pci, &pbch_msg, buffer.data(), buffer.data()) == SRSRAN_SUCCESS);
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+
+  srsue::nr::ssb_search_multi::cfg_t cfg = {};
+  cfg.srate_hz                           = SRATE_HZ;
+  cfg.center_freq_hz                     = CENTER_FREQ_HZ;
+  cfg.ssb_scs                            = srsran_subcarrier_spacing_30kHz;
+  cfg.ssb_pattern                        = SRSRAN_SSB_PATTERN_C;
+  cfg.duplex_mode                        = SRSRAN_DUPLEX_MODE_TDD;
+
+  // Every raster frequency within +/-7.92 MHz of the center fits in the capture
+  std::vector<double> ssb_freqs_hz = srsue::nr::ssb_search_multi::get_ssb_freqs(BAND, cfg);
+  TESTASSERT(ssb_freqs_hz.size() == 11);
+
+  // Two cells in different raster frequencies, the first one with two beams
+  srsran_ssb_args_t ssb_args = {};
+  ssb_args.max_srate_hz      = SRATE_HZ;
+  ssb_args.min_scs           = srsran_subcarrier_spacing_30kHz;
+  ssb_args.enable_encode     = true;
+  srsran_ssb_t ssb           = {};
+  TESTASSERT(srsran_ssb_init(&ssb, &ssb_args) == SRSRAN_SUCCESS);
+
+  std::vector<cf_t> buffer((uint32_t)(SRATE_HZ * 5e-3));
+  TESTASSERT(add_ssb(&ssb, ssb_freqs_hz[1], 10, 0, buffer) == SRSRAN_SUCCESS);
+  TESTASSERT(add_ssb(&ssb, ssb_freqs_hz[1], 10, 3, buffer) == SRSRAN_SUCCESS);
+  TESTASSERT(add_ssb(&ssb, ssb_freqs_hz[8], 301, 1, buffer) == SRSRAN_SUCCESS);
+  srsran_ssb_free(&ssb);
+  srsran_ch_awgn_c(buffer.data(), buffer.data(), srsran_convert_dB_to_power(-30.0f), buffer.size());
+
+  srsue::nr::ssb_search_multi::args_t args = {};
+  args.nof_workers                         = 4;
+  args.max_srate_hz                        = SRATE_HZ;
+  args.ssb_min_scs                         = srsran_subcarrier_spacing_30kHz;
+  srsue::nr::ssb_search_multi searcher(srslog::fetch_basic_logger("PHY"), args);
+
+  std::vector<srsue::nr::ssb_search_multi::result_t> results =
+      searcher.run(cfg, ssb_freqs_hz, buffer.data(), (uint32_t)buffer.size());
+
+  // Every SSB is found in its raster frequency only
+  TESTASSERT(results.size() == 3);
+  uint32_t nof_beams_pci_10 = 0;
+  for (const srsue::nr::ssb_search_multi::result_t& r : results) {
+    if (r.ssb_res.N_id == 10) {
+      TESTASSERT(r.ssb_freq_hz == ssb_freqs_hz[1]);
+      TESTASSERT(r.ssb_res.pbch_msg.ssb_idx == 0 or r.ssb_res.pbch_msg.ssb_idx == 3);
+      nof_beams_pci_10++;
+    } else {
+      TESTASSERT(r.ssb_res.N_id == 301);
+      TESTASSERT(r.ssb_freq_hz == ssb_freqs_hz[8]);
+      TESTASSERT(r.ssb_res.pbch_msg.ssb_idx == 1);
+    }
+  }
+  TESTASSERT(nof_beams_pci_10 == 2);
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
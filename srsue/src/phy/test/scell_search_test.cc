@@ -714,6 +714,10 @@ int main(int argc, char** argv)
 
   ret = rrc.print_stats() ? SRSRAN_SUCCESS : SRSRAN_ERROR;
 
+  for (const auto& e : intra_measure.get_cycle_time_us()) {
+    printf("  Measurement cycle with %2d cells: %6d us\n", e.first, e.second);
+  }
+
   if (radio) {
     radio->stop();
   }
@@ -0,0 +1,144 @@
+/**
+ * Copyright 2013-2022 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsran/phy/resampling/resampler.h"
+#include "srsue/hdr/phy/search_multi.h"
+
+#define NOF_SUBFRAMES 500
+#define SF_LEN (SRSRAN_SF_LEN_PRB(6))
+
+// Generates NOF_SUBFRAMES of a 6 PRB cell sampled at SRSRAN_CS_SAMP_FREQ, attenuated by atten_dB, plus noise
+static int gen_cell(uint32_t pci, float atten_dB, std::vector<cf_t>& output)
+{
+  srsran_cell_t cell   = {};
+  cell.nof_prb         = 6;
+  cell.nof_ports       = 1;
+  cell.id              = pci;
+  cell.cp              = SRSRAN_CP_NORM;
+  cell.phich_length    = SRSRAN_PHICH_NORM;
+  cell.phich_resources = SRSRAN_PHICH_R_1_6;
+  cell.frame_type      = SRSRAN_FDD;
+
+  cf_t* buffer[SRSRAN_MAX_PORTS] = {};
+  buffer[0]                      = srsran_vec_cf_malloc(SF_LEN);
+  TESTASSERT(buffer[0] != nullptr);
+
+  srsran_enb_dl_t enb_dl = {};
+  TESTASSERT(srsran_enb_dl_init(&enb_dl, buffer, cell.nof_prb) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_enb_dl_set_cell(&enb_dl, cell) == SRSRAN_SUCCESS);
+
+  // Undo srsran_enb_dl_gen_signal scaling and apply the attenuation
+  float scale = sqrtf(cell.nof_prb) / 0.05f / enb_dl.ifft->cfg.symbol_sz * srsran_convert_dB_to_amplitude(-atten_dB);
+
+  output.resize(NOF_SUBFRAMES * SF_LEN);
+  for (uint32_t tti = 0; tti < NOF_SUBFRAMES; tti++) {
+    srsran_dl_sf_cfg_t dl_sf = {};
+    dl_sf.tti                = tti;
+    dl_sf.cfi                = 1;
+    srsran_enb_dl_put_base(&enb_dl, &dl_sf);
+    srsran_enb_dl_gen_signal(&enb_dl);
+    srsran_vec_sc_prod_cfc(buffer[0], scale, &output[tti * SF_LEN], SF_LEN);
+  }
+  srsran_ch_awgn_c(output.data(), output.data(), srsran_convert_dB_to_power(-30.0f), output.size());
+
+  srsran_enb_dl_free(&enb_dl);
+  free(buffer[0]);
+  return SRSRAN_SUCCESS;
+}
+
+// Two EARFCNs with a cell each and one empty EARFCN are searched by two workers
+int test_multi_earfcn()
+{
+  srsue::search_multi_args_t args = {};
+  args.nof_workers                = 2;
+  srsue::search_multi searcher(srslog::fetch_basic_logger("PHY"), args);
+
+  std::vector<cf_t> earfcn_a, earfcn_b, earfcn_c(NOF_SUBFRAMES * SF_LEN);
+  TESTASSERT(gen_cell(12, 6.0f, earfcn_a) == SRSRAN_SUCCESS);
+  TESTASSERT(gen_cell(301, 0.0f, earfcn_b) == SRSRAN_SUCCESS);
+  srsran_ch_awgn_c(earfcn_c.data(), earfcn_c.data(), srsran_convert_dB_to_power(-30.0f), earfcn_c.size());
+
+  std::vector<srsue::search_multi_source_t> sources = {{3350, earfcn_a.data(), (uint32_t)earfcn_a.size()},
+                                                       {3400, earfcn_b.data(), (uint32_t)earfcn_b.size()},
+                                                       {3450, earfcn_c.data(), (uint32_t)earfcn_c.size()}};
+
+  std::vector<srsue::search_multi_cell_t> cells = searcher.run(sources);
+
+  // The strongest cell comes first
+  TESTASSERT(cells.size() == 2);
+  TESTASSERT(cells[0].earfcn == 3400);
+  TESTASSERT(cells[0].cell.id == 301);
+  TESTASSERT(cells[0].cell.nof_prb == 6);
+  TESTASSERT(cells[1].earfcn == 3350);
+  TESTASSERT(cells[1].cell.id == 12);
+  TESTASSERT(cells[0].rsrp_dB > cells[1].rsrp_dB);
+
+  return SRSRAN_SUCCESS;
+}
+
+// A cell 500 kHz away from the center of a capture at twice the cell search rate is found after channelising it
+int test_channelise()
+{
+  std::vector<cf_t> cell_signal;
+  TESTASSERT(gen_cell(77, 0.0f, cell_signal) == SRSRAN_SUCCESS);
+
+  // Interpolate to 3.84 MHz and move the cell off center
+  uint32_t               earfcn    = 6300;
+  double                 srate_hz  = 2 * SRSRAN_CS_SAMP_FREQ;
+  double                 center_hz = srsran_band_fd(earfcn) * 1e6 - 500e3;
+  srsran_resampler_fft_t resampler = {};
+  TESTASSERT(srsran_resampler_fft_init(&resampler, SRSRAN_RESAMPLER_MODE_INTERPOLATE, 2) == SRSRAN_SUCCESS);
+  std::vector<cf_t> capture(2 * cell_signal.size());
+  srsran_resampler_fft_run(&resampler, cell_signal.data(), capture.data(), cell_signal.size());
+  srsran_resampler_fft_free(&resampler);
+  srsran_vec_apply_cfo(capture.data(), (float)(500e3 / srate_hz), capture.data(), capture.size());
+
+  // The EARFCN must be inside the captured bandwidth
+  std::vector<cf_t> channel;
+  TESTASSERT(srsue::search_multi::channelise(
+                 capture.data(), capture.size(), srate_hz, center_hz, earfcn + 20, channel) == SRSRAN_ERROR);
+  TESTASSERT(srsue::search_multi::channelise(capture.data(), capture.size(), srate_hz, center_hz, earfcn, channel) ==
+             SRSRAN_SUCCESS);
+  TESTASSERT(channel.size() == cell_signal.size());
+
+  srsue::search_multi_args_t args = {};
+  srsue::search_multi        searcher(srslog::fetch_basic_logger("PHY"), args);
+
+  std::vector<srsue::search_multi_cell_t> cells = searcher.run({{earfcn, channel.data(), (uint32_t)channel.size()}});
+  TESTASSERT(cells.size() == 1);
+  TESTASSERT(cells[0].earfcn == earfcn);
+  TESTASSERT(cells[0].cell.id == 77);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  srslog::init();
+
+  TESTASSERT(test_multi_earfcn() == SRSRAN_SUCCESS);
+  TESTASSERT(test_channelise() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
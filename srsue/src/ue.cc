@@ -50,7 +50,7 @@ ue::~ue()
   stack.reset();
 }
 
-int ue::init(const all_args_t& args_)
+int ue::init(const all_args_t& args_, srsran::radio_swarm* swarm)
 {
   int ret = SRSRAN_SUCCESS;
 
@@ -77,7 +77,18 @@ int ue::init(const all_args_t& args_)
     return SRSRAN_ERROR;
   }
 
-  std::unique_ptr<srsran::radio> lte_radio = std::unique_ptr<srsran::radio>(new srsran::radio);
+  // In swarm mode, the radio is shared with the rest of UEs of the process
+  std::unique_ptr<srsran::radio_base> lte_radio;
+  srsran::radio_interface_phy*        radio_phy = nullptr;
+  if (swarm != nullptr) {
+    std::unique_ptr<srsran::radio_swarm::port> swarm_port = swarm->create_port();
+    radio_phy                                             = swarm_port.get();
+    lte_radio                                             = std::move(swarm_port);
+  } else {
+    std::unique_ptr<srsran::radio> rf = std::unique_ptr<srsran::radio>(new srsran::radio);
+    radio_phy                         = rf.get();
+    lte_radio                         = std::move(rf);
+  }
   if (!lte_radio) {
     srsran::console("Error creating radio multi instance.\n");
     return SRSRAN_ERROR;
@@ -107,7 +118,7 @@ int ue::init(const all_args_t& args_)
       srsran::console("Error initializing radio.\n");
       return SRSRAN_ERROR;
     }
-    if (nr_phy->init(phy_args_nr, lte_stack.get(), lte_radio.get())) {
+    if (nr_phy->init(phy_args_nr, lte_stack.get(), radio_phy)) {
       srsran::console("Error initializing PHY NR SA.\n");
       ret = SRSRAN_ERROR;
     }
@@ -139,12 +150,12 @@ int ue::init(const all_args_t& args_)
       return SRSRAN_ERROR;
     }
     // from here onwards do not exit immediately if something goes wrong as sub-layers may already use interfaces
-    if (lte_phy->init(args.phy, lte_stack.get(), lte_radio.get())) {
+    if (lte_phy->init(args.phy, lte_stack.get(), radio_phy)) {
       srsran::console("Error initializing PHY.\n");
       ret = SRSRAN_ERROR;
     }
     if (args.phy.nof_nr_carriers > 0) {
-      if (lte_phy->init(phy_args_nr, lte_stack.get(), lte_radio.get())) {
+      if (lte_phy->init(phy_args_nr, lte_stack.get(), radio_phy)) {
         srsran::console("Error initializing NR PHY.\n");
         ret = SRSRAN_ERROR;
       }